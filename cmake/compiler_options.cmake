@@ -129,7 +129,13 @@ endif()
 if(CMAKE_CXX_COMPILER_ID MATCHES "GNU")
 	anakin_add_compile_option(-fabi-version=6)
     anakin_add_compile_option(-fabi-compat-version=2) #add compat
-    anakin_add_compile_option(-march=${BUILD_X86_ARCH})
+    if(NOT BUILD_X86_FAT_BIN)
+        anakin_add_compile_option(-march=${BUILD_X86_ARCH})
+    endif()
+endif()
+if(BUILD_X86_FAT_BIN)
+    anakin_add_compile_option(-march=nehalem)
+    anakin_add_compile_option(-mtune=haswell)
 endif()
 if(USE_OPENMP)
     anakin_add_compile_option(-fopenmp)
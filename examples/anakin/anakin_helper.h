@@ -36,7 +36,11 @@ public:
             //FIXME:choose real path
             std::string so_path;
             if(_ak_so_path=="") {
-                so_path = _ak_so_dir + "/" + this_cpu_arch + "/libanakin.so";
+                // a fat so built with BUILD_X86_TARGET=fat serves every arch
+                so_path = _ak_so_dir + "/fat/libanakin.so";
+                if (access(so_path.c_str(), F_OK) != 0) {
+                    so_path = _ak_so_dir + "/" + this_cpu_arch + "/libanakin.so";
+                }
                 printf("auto choose so %s \n", so_path.c_str());
             } else {
                 so_path = _ak_so_path;
@@ -55,7 +59,7 @@ public:
                                                   "get_ak_cpu_arch_string");
             std::string so_cpu_arch(get_cpu_arch_string());
 
-            if (this_cpu_arch != so_cpu_arch && _ak_so_path=="") {
+            if (this_cpu_arch != so_cpu_arch && so_cpu_arch != "fat" && _ak_so_path=="") {
                 fprintf(stderr, "Error: load so not equal %s != %s .\n", this_cpu_arch.c_str(),
                         so_cpu_arch.c_str());
                 exit(-1);
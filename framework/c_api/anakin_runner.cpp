@@ -5,6 +5,11 @@
 #include "saber/saber_types.h"
 #include "framework/graph/graph.h"
 #include "framework/core/net/net.h"
+#include <mutex>
+#ifdef USE_X86_PLACE
+#include "anakin_thread.h"
+#include "mkl_service.h"
+#endif
 
 using namespace anakin;
 using namespace anakin::graph;
@@ -147,72 +152,284 @@ template <typename TarType>
 class AnakinRuner : public AnakinRunerInterface {};
 
 #ifdef USE_X86_PLACE
-template <>
-class AnakinRuner<X86> : public AnakinRunerInterface {
+/**
+ * \brief execution context of a X86 model, it owns a net initialized from the shared optimized graph
+ */
+class AnakinRunerContextX86 : public AnakinRunerContextInterface {
 public:
-    bool load_model(std::string model_path, int max_batch_size) {
-        delete _net;
-        delete _graph;
-
-        _graph = new Graph<X86, Precision::FP32>();
-        _graph->load(model_path);
+    AnakinRunerContextX86(std::shared_ptr<Graph<X86, Precision::FP32>> graph, int thread_num):
+        _graph(graph), _thread_num(thread_num) {
+        _net = new Net<X86, Precision::FP32>(*_graph, true);
         _vin_name = _graph->get_ins();
-        LOG(INFO) << "input size: " << _vin_name.size();
-        LOG(INFO) << "set batchsize to " << max_batch_size;
-        _vin_ak_tensor_ptr.resize(_vin_name.size());
-
-        for (int j = 0; j < _vin_name.size(); ++j) {
-            LOG(INFO) << "input name: " << _vin_name[j];
-            _graph->ResetBatchSize(_vin_name[j], max_batch_size);
-            _vin_ak_tensor_ptr[j] = new AnakinRunerTensorX86();
-        }
-
         _vout_name = _graph->get_outs();
-        LOG(INFO) << "output size: " << _vout_name.size();
-        _vout_ak_tensor_ptr.resize(_vout_name.size());
 
-        for (int j = 0; j < _vout_name.size(); ++j) {
-        LOG(INFO) << "output name: " << _vout_name[j];
-            _vout_ak_tensor_ptr[j] = new AnakinRunerTensorX86();
+        for (auto& name : _vin_name) {
+            // a buffer reused by other tensors of the net can not be replaced by user memory
+            _in_zero_copy.push_back(!_net->get_in(name)->is_buffer_shared());
+            _in_origin.push_back(nullptr);
+            _in_data.push_back(nullptr);
+            _vin_ak_tensor_ptr.push_back(new AnakinRunerTensorX86());
         }
 
-        _graph->Optimize();
-        _net = new Net<X86, Precision::FP32>(*_graph, true);
-        return true;
+        for (auto& name : _vout_name) {
+            _out_zero_copy.push_back(!_net->get_out(name)->is_buffer_shared());
+            _out_origin.push_back(nullptr);
+            _out_data.push_back(nullptr);
+            _out_capacity.push_back(0);
+            _out_copy.push_back(true);
+            _vout_ak_tensor_ptr.push_back(new AnakinRunerTensorX86());
+        }
     }
 
-    AnakinRunerTensorInterface* get_input_tensor(int index) {
+    AnakinRunerTensorInterface* get_input_tensor(int index) override {
         _vin_ak_tensor_ptr[index]->reset(_net->get_in(_vin_name[index]));
         return _vin_ak_tensor_ptr[index];
     }
 
-    AnakinRunerTensorInterface* get_output_tensor(int index) {
+    AnakinRunerTensorInterface* get_output_tensor(int index) override {
         _vout_ak_tensor_ptr[index]->reset(_net->get_out(_vout_name[index]));
         return _vout_ak_tensor_ptr[index];
     }
 
-    int get_input_number() {
+    int get_input_number() override {
         return _vin_name.size();
     }
-    int get_output_number() {
+    int get_output_number() override {
         return _vout_name.size();
     }
-    void prediction() {
+
+    void set_thread_num(int thread_num) override {
+        _thread_num = thread_num;
+    }
+
+    bool bind_input(int index, void* data, std::vector<int>& shape) override {
+        if (index < 0 || index >= _vin_name.size()) {
+            LOG(ERROR) << "input index " << index << " out of range";
+            return false;
+        }
+
+        Tensor<X86>* input = _net->get_in(_vin_name[index]);
+        restore(input, _in_origin[index]);
+        _in_data[index] = nullptr;
+
+        if (data == nullptr) {
+            return true;
+        }
+
+        Shape in_shape(shape, input->valid_shape().get_layout());
+
+        // other tensors overwrite the shared buffer, the memory is copied before each prediction
+        if (!_in_zero_copy[index]) {
+            input->reshape(in_shape);
+            _in_data[index] = data;
+            return true;
+        }
+
+        if (_in_origin[index] == nullptr) {
+            _in_origin[index] = std::make_shared<Tensor<X86>>(*input);
+        }
+
+        std::vector<std::vector<int>> seq_offset = input->get_seq_offset();
+        Tensor<X86> user_tensor(data, X86(), 0, in_shape, input->get_dtype());
+        input->set_shape(in_shape, in_shape);
+        input->share_from(user_tensor);
+        input->set_seq_offset(seq_offset);
+        return true;
+    }
+
+    bool bind_output(int index, void* data, size_t capacity) override {
+        if (index < 0 || index >= _vout_name.size()) {
+            LOG(ERROR) << "output index " << index << " out of range";
+            return false;
+        }
+
+        Tensor<X86>* output = _net->get_out(_vout_name[index]);
+        restore(output, _out_origin[index]);
+        _out_data[index] = data;
+        _out_capacity[index] = capacity;
+        _out_copy[index] = true;
+        int type_len = output->get_dtype_size();
+
+        // the output is written in place only when it can not outgrow the memory
+        if (data == nullptr || !_out_zero_copy[index]
+                || capacity < output->shape().count() * type_len) {
+            return true;
+        }
+
+        if (_out_origin[index] == nullptr) {
+            _out_origin[index] = std::make_shared<Tensor<X86>>(*output);
+        }
+
+        Tensor<X86> user_tensor(data, X86(), 0, Shape({int(capacity / type_len), 1, 1, 1}),
+                                output->get_dtype());
+        output->share_from(user_tensor);
+        _out_copy[index] = false;
+        return true;
+    }
+
+    void prediction() override {
+        for (int i = 0; i < _vin_name.size(); ++i) {
+            if (_in_data[i] != nullptr) {
+                Tensor<X86>* input = _net->get_in(_vin_name[i]);
+                memcpy(input->mutable_data(), _in_data[i], input->valid_size() * input->get_dtype_size());
+            }
+        }
+
+        int omp_thread_num = anakin_get_max_threads();
+        int mkl_thread_num = 0;
+
+        if (_thread_num > 0) {
+            anakin_set_num_threads(_thread_num);
+            mkl_thread_num = mkl_set_num_threads_local(_thread_num);
+        }
+
         _net->prediction();
+
+        if (_thread_num > 0) {
+            mkl_set_num_threads_local(mkl_thread_num);
+            anakin_set_num_threads(omp_thread_num);
+        }
+
+        for (int i = 0; i < _vout_name.size(); ++i) {
+            if (_out_data[i] == nullptr || !_out_copy[i]) {
+                continue;
+            }
+
+            Tensor<X86>* output = _net->get_out(_vout_name[i]);
+            size_t size = output->valid_size() * output->get_dtype_size();
+
+            if (size > _out_capacity[i]) {
+                LOG(ERROR) << "output " << _vout_name[i] << " needs " << size << " bytes, but "
+                           << _out_capacity[i] << " bytes are bound";
+                continue;
+            }
+
+            memcpy(_out_data[i], output->data(), size);
+        }
     }
 
-    ~AnakinRuner() {
+    ~AnakinRunerContextX86() {
         delete _net;
-        delete _graph;
+
+        for (auto tensor : _vin_ak_tensor_ptr) {
+            delete tensor;
+        }
+
+        for (auto tensor : _vout_ak_tensor_ptr) {
+            delete tensor;
+        }
     }
 
 private:
-    Graph <X86, Precision::FP32>* _graph;
+    /**
+     * \brief give a tensor bound to user memory its own buffer back
+     */
+    void restore(Tensor<X86>* tensor, std::shared_ptr<Tensor<X86>>& origin) {
+        if (origin != nullptr) {
+            tensor->set_shape(origin->valid_shape(), origin->shape());
+            tensor->share_from(*origin);
+        }
+    }
+
+    std::shared_ptr<Graph<X86, Precision::FP32>> _graph;
     Net<X86, Precision::FP32>* _net;
-    std::vector<std::string>_vin_name;
+    int _thread_num;
+    std::vector<std::string> _vin_name;
     std::vector<std::string> _vout_name;
     std::vector<AnakinRunerTensorX86*> _vin_ak_tensor_ptr;
     std::vector<AnakinRunerTensorX86*> _vout_ak_tensor_ptr;
+    std::vector<bool> _in_zero_copy;
+    std::vector<bool> _out_zero_copy;
+    std::vector<std::shared_ptr<Tensor<X86>>> _in_origin;
+    std::vector<std::shared_ptr<Tensor<X86>>> _out_origin;
+    std::vector<void*> _in_data;
+    std::vector<void*> _out_data;
+    std::vector<size_t> _out_capacity;
+    std::vector<bool> _out_copy;
+};
+
+/**
+ * \brief X86 model, the graph is loaded and optimized once and its weights are shared by the contexts
+ */
+class AnakinRunerModelX86 : public AnakinRunerModelInterface {
+public:
+    bool load_model(std::string model_path, int max_batch_size) override {
+        auto graph = std::make_shared<Graph<X86, Precision::FP32>>();
+
+        if (!graph->load(model_path)) {
+            LOG(ERROR) << "load model " << model_path << " failed";
+            return false;
+        }
+
+        LOG(INFO) << "set batchsize to " << max_batch_size;
+
+        for (auto& name : graph->get_ins()) {
+            graph->ResetBatchSize(name, max_batch_size);
+        }
+
+        graph->Optimize();
+        std::lock_guard<std::mutex> lock(_mut);
+        _graph = graph;
+        return true;
+    }
+
+    AnakinRunerContextInterface* create_context(int thread_num) override {
+        // nets initialized from one graph must not be initialized concurrently
+        std::lock_guard<std::mutex> lock(_mut);
+
+        if (_graph == nullptr) {
+            LOG(ERROR) << "load the model before creating contexts";
+            return nullptr;
+        }
+
+        return new AnakinRunerContextX86(_graph, thread_num);
+    }
+
+private:
+    std::mutex _mut;
+    std::shared_ptr<Graph<X86, Precision::FP32>> _graph;
+};
+
+template <>
+class AnakinRuner<X86> : public AnakinRunerInterface {
+public:
+    bool load_model(std::string model_path, int max_batch_size) {
+        delete _context;
+        _context = nullptr;
+
+        if (!_model.load_model(model_path, max_batch_size)) {
+            return false;
+        }
+
+        _context = _model.create_context(0);
+        return true;
+    }
+
+    AnakinRunerTensorInterface* get_input_tensor(int index) {
+        return _context->get_input_tensor(index);
+    }
+
+    AnakinRunerTensorInterface* get_output_tensor(int index) {
+        return _context->get_output_tensor(index);
+    }
+
+    int get_input_number() {
+        return _context->get_input_number();
+    }
+    int get_output_number() {
+        return _context->get_output_number();
+    }
+    void prediction() {
+        _context->prediction();
+    }
+
+    ~AnakinRuner() {
+        delete _context;
+    }
+
+private:
+    AnakinRunerModelX86 _model;
+    AnakinRunerContextInterface* _context{nullptr};
 };
 
 #endif
@@ -323,6 +540,22 @@ AnakinRunerInterface* get_anakinrun_instance(const char* device_type, int device
     return nullptr;
 }
 
+AnakinRunerModelInterface* get_anakinrun_model(const char* device_type, int device_number) {
+    std::string device_type_string(device_type);
+
+    if (device_type_string == "X86") {
+#if defined(USE_X86_PLACE)
+        return new AnakinRunerModelX86();
+#else
+        LOG(FATAL) << "the so not support type " << device_type;
+#endif
+    } else {
+        LOG(FATAL) << "the so not support shared models of type :" << device_type_string;
+    }
+
+    return nullptr;
+}
+
 char* get_ak_cpu_arch_string() {
 #ifdef USE_X86_PLACE
     return BUILD_X86_ARCH;
@@ -332,9 +565,6 @@ char* get_ak_cpu_arch_string() {
 }
 
 #ifdef USE_X86_PLACE
-
-#include "anakin_thread.h"
-#include "mkl_service.h"
 void set_ak_cpu_parallel() {
     anakin_set_dynamic(0);
     anakin_set_num_threads(1);
@@ -48,10 +48,57 @@ public:
 
     virtual void prediction() {};
 
+    virtual ~AnakinRunerInterface() {};
+
+};
+
+/**
+ * \brief execution context created from an AnakinRunerModelInterface,
+ * it shares the weights of the model and is used by one thread at a time.
+ * load_model of a context does nothing, the model is loaded by its AnakinRunerModelInterface.
+ */
+class AnakinRunerContextInterface : public AnakinRunerInterface {
+public:
+    /**
+     * \brief intra-op threads of prediction, set for the calling thread only, <= 0 keeps the current setting
+     */
+    virtual void set_thread_num(int thread_num) {};
+
+    /**
+     * \brief bind user memory holding the input of the given shape, the net reads it without a copy
+     * when no other tensor shares the input buffer, otherwise it is copied at each prediction.
+     * the memory must stay valid until it is unbound by binding nullptr.
+     */
+    virtual bool bind_input(int index, void* data, std::vector<int>& shape) { return false;};
+
+    /**
+     * \brief bind user memory of capacity bytes receiving the output, the net writes into it directly
+     * when no other tensor shares the output buffer and capacity covers the output at the max batch size,
+     * otherwise the output is copied into it after prediction. nullptr unbinds.
+     */
+    virtual bool bind_output(int index, void* data, size_t capacity) { return false;};
+
+};
+
+/**
+ * \brief model loaded and optimized once, cheap contexts share its weights
+ */
+class AnakinRunerModelInterface {
+public:
+    virtual bool load_model(std::string model_path, int max_batch_size) { return false;};
+
+    /**
+     * \brief create an execution context, thread safe, release it with delete
+     */
+    virtual AnakinRunerContextInterface* create_context(int thread_num) { return nullptr;};
+
+    virtual ~AnakinRunerModelInterface() {};
+
 };
 
 
 AnakinRunerInterface* get_anakinrun_instance(const char* device_type, int device_number);
+AnakinRunerModelInterface* get_anakinrun_model(const char* device_type, int device_number);
 char* get_ak_cpu_arch_string();
 void set_ak_cpu_parallel();
 
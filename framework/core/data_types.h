@@ -34,6 +34,7 @@ struct DataTypeWarpper {
     }
 
 SABER_TO_BASE_TYPE(AK_HALF, unsigned short); /// need to be aligned
+SABER_TO_BASE_TYPE(AK_BFLOAT16, unsigned short);
 SABER_TO_BASE_TYPE(AK_FLOAT, float);
 SABER_TO_BASE_TYPE(AK_DOUBLE, double);
 SABER_TO_BASE_TYPE(AK_INT8, int8_t);
@@ -18,6 +18,7 @@
 
 #include "framework/core/parameter.h"
 #include "framework/core/singleton.h"
+#include "saber/core/host_allocator.h"
 
 namespace anakin {
 
@@ -35,9 +36,26 @@ public:
 		return mem_used;
 	}
 
+	/// get mem kept by the allocator caches in MB
+	double get_cached_mem_in_mb() {
+		return mem_cached;
+	}
+
+	/// get peak of used mem in MB
+	double get_peak_mem_in_mb() {
+		return mem_peak;
+	}
+
+	/// get counters of the host allocator
+	saber::HostAllocatorStats get_host_allocator_stats() {
+		return saber::HostAllocator::global()->stats();
+	}
+
 private:
 	double mem_used{0.f}; ///< mem in mb
 	double mem_total{0.f}; //< mem in mb
+	double mem_cached{0.f}; ///< mem in mb
+	double mem_peak{0.f}; ///< mem in mb
 };
 
 #ifdef USE_CUDA
@@ -55,6 +73,26 @@ double MemInfo<NV>::get_used_mem_in_mb() {
 };
 #endif
 
+#ifdef USE_X86_PLACE
+template<>
+inline double MemInfo<X86>::get_used_mem_in_mb() {
+	this->mem_used = (double)saber::HostAllocator::global()->stats().bytes_in_use/1e6;
+	return this->mem_used;
+}
+
+template<>
+inline double MemInfo<X86>::get_cached_mem_in_mb() {
+	this->mem_cached = (double)saber::HostAllocator::global()->stats().bytes_cached/1e6;
+	return this->mem_cached;
+}
+
+template<>
+inline double MemInfo<X86>::get_peak_mem_in_mb() {
+	this->mem_peak = (double)saber::HostAllocator::global()->stats().peak_bytes_in_use/1e6;
+	return this->mem_peak;
+}
+#endif
+
 template<typename Ttype>
 using MemoryInfo= Singleton<MemInfo<Ttype>>;
 
@@ -0,0 +1,117 @@
+
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+   
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License. 
+*/
+
+#ifndef ANAKIN_AUTO_CALIBRATOR_H
+#define ANAKIN_AUTO_CALIBRATOR_H
+
+#include "anakin_config.h"
+
+#ifndef USE_SGX
+
+#include "framework/core/net/entropy_calibrator.h"
+#include <algorithm>
+#include <cmath>
+
+namespace anakin {
+
+/** 
+ *  \brief calibrator that computes the entropy, percentile, mse and max clip values of
+ *  each tensor, and keeps the one whose int8 round trip has the highest cosine similarity
+ *  with the tensor. none of the candidates optimizes the cosine, so any of them may win.
+ */
+template<typename Ttype>
+class AutoCalibrator: public EntropyCalibrator<Ttype> {
+public:
+    AutoCalibrator(BatchStream<Ttype>* stream,
+              int batch_size,
+              std::string calibrator_file, 
+              Net<Ttype, Precision::FP32, OpRunType::SYNC>* net,
+              int bin_num,
+              float percentile = 99.99f):
+         EntropyCalibrator<Ttype>(stream, batch_size, calibrator_file, net, bin_num),
+         _percentile(percentile) {}
+
+    virtual CalibrationAlgoType get_algorithm() {return AUTO;}
+
+    virtual void generate_calibrator_table() {
+        auto tensor_name_list = this->get_tensor_name_list();
+        _algo_vec.assign(tensor_name_list.size(), ENTROPY);
+        EntropyCalibrator<Ttype>::generate_calibrator_table();
+        for (int i = 0; i < tensor_name_list.size(); i++) {
+            LOG(INFO) << "calibrate " << tensor_name_list[i] << " with algorithm " << _algo_vec[i];
+        }
+    }
+
+protected:
+    virtual float get_clip_value(int tensor_id) {
+        /*ties keep the earlier candidate*/
+        const CalibrationAlgoType algos[] = {ENTROPY, PERCENTILE, MSE, MAXABS};
+        const float clips[] = {EntropyCalibrator<Ttype>::get_clip_value(tensor_id),
+                               this->get_percentile_clip(tensor_id, _percentile),
+                               this->get_mse_clip(tensor_id),
+                               this->_max_vec[tensor_id]};
+        int best = 0;
+        double max_cosine = get_cosine_similarity(tensor_id, clips[0]);
+        for (int i = 1; i < 4; i++) {
+            double cosine = get_cosine_similarity(tensor_id, clips[i]);
+            if (cosine > max_cosine) {
+                max_cosine = cosine;
+                best = i;
+            }
+        }
+        _algo_vec[tensor_id] = algos[best];
+        return clips[best];
+    }
+
+    /**
+     *  \brief cosine similarity of |x| and its int8 round trip with scale clip / 127,
+     *  the bin centers are rounded to the nearest level and saturate at 127.
+     */
+    double get_cosine_similarity(int tensor_id, float clip) {
+        std::vector<int64_t>& hist = this->hist_vecs()[tensor_id];
+        const double bin_width = this->bin_edge(tensor_id, 1);
+        if (clip <= 0.f || bin_width <= 0.0) {
+            return 1.0;
+        }
+        const double step = clip / 127.0;
+        double dot = 0.0;
+        double norm_x = 0.0;
+        double norm_q = 0.0;
+        for (int i = 0; i < hist.size(); i++) {
+            if (hist[i] == 0) {
+                continue;
+            }
+            double x = bin_width * (i + 0.5);
+            double q = std::min(std::round(x / step), 127.0) * step;
+            dot += x * q * hist[i];
+            norm_x += x * x * hist[i];
+            norm_q += q * q * hist[i];
+        }
+        if (norm_q <= 0.0) {
+            return 0.0;
+        }
+        return dot / std::sqrt(norm_x * norm_q);
+    }
+
+    float _percentile;
+
+    std::vector<CalibrationAlgoType> _algo_vec;
+};
+}
+
+#endif // USE_SGX
+
+#endif
@@ -15,39 +15,50 @@
 
 #include "framework/core/net/auto_layout_config.h"
 #include <unordered_set>
+#include <functional>
 #include "framework/graph/node.h"
 namespace anakin {
 
 template<typename Ttype, Precision Ptype>
 void AutoLayoutConfigHelper<Ttype, Ptype>::init() {
     _node_layout_hint["Input"]["nchw"] = {"nchw"};
-    _node_layout_hint["Convolution"]["nchw"] = {"nchw_c8r", "nchw"};
-    _node_layout_hint["Convolution"]["nchw_c8r"] = {"nchw_c8r", "nchw"};
-    _node_layout_hint["ConvRelu"]["nchw"] = {"nchw_c8r", "nchw"};
-    _node_layout_hint["ConvRelu"]["nchw_c8r"] = {"nchw_c8r", "nchw"};
-    _node_layout_hint["ConvBatchnormScaleRelu"]["nchw"] = {"nchw_c8r", "nchw"};
-    _node_layout_hint["ConvBatchnormScaleRelu"]["nchw_c8r"] = {"nchw_c8r", "nchw"};
-    _node_layout_hint["ConvBatchnormScale"]["nchw"] = {"nchw_c8r", "nchw"};
-    _node_layout_hint["ConvBatchnormScale"]["nchw_c8r"] = {"nchw_c8r", "nchw"};
+    _conv_op_set = {"Convolution", "ConvRelu", "ConvBatchnormScaleRelu", "ConvBatchnormScale",
+                    "ConvEltwise"
+                   };
+
+    for (auto conv_op : {"Convolution", "ConvRelu", "ConvBatchnormScaleRelu", "ConvBatchnormScale"}) {
+        _node_layout_hint[conv_op]["nchw"] = {"nchw_c8r", "nchw_c16r", "nchw"};
+        _node_layout_hint[conv_op]["nchw_c8r"] = {"nchw_c8r", "nchw"};
+        _node_layout_hint[conv_op]["nchw_c16r"] = {"nchw_c16r"};
+    }
+
     _node_layout_hint["Pooling"]["nchw"] = {"nchw"};
     _node_layout_hint["Pooling"]["nchw_c8r"] = {"nchw_c8r", "nchw"};
+    _node_layout_hint["Pooling"]["nchw_c16r"] = {"nchw_c16r"};
     _node_layout_hint["Dense"]["nchw_c8r"] = {"nchw"};
     _node_layout_hint["Dense"]["nchw"] = {"nchw"};
     _node_layout_hint["ReLU"]["nchw_c8r"] = {"nchw_c8r"};
+    _node_layout_hint["ReLU"]["nchw_c16r"] = {"nchw_c16r"};
     _node_layout_hint["ReLU"]["nchw"] = {"nchw"};
     _node_layout_hint["Activation"]["nchw_c8r"] = {"nchw_c8r"};
+    _node_layout_hint["Activation"]["nchw_c16r"] = {"nchw_c16r"};
     _node_layout_hint["Activation"]["nchw"] = {"nchw"};
     _node_layout_hint["Softmax"]["nchw"] = {"nchw"};
     _node_layout_hint["Split"]["nchw_c8r"] = {"nchw_c8r"};
+    _node_layout_hint["Split"]["nchw_c16r"] = {"nchw_c16r"};
     _node_layout_hint["Split"]["nchw"] = {"nchw"};
     _node_layout_hint["Gather"]["nchw_c8r"] = {"nchw_c8r"};
     _node_layout_hint["Gather"]["nchw"] = {"nchw"};
     _node_layout_hint["ConvEltwise"]["nchw_c8r"] = {"nchw_c8r"};
     _node_layout_hint["ConvEltwise"]["nchw"] = {"nchw"};
     _node_layout_hint["Eltwise"]["nchw_c8r"] = {"nchw_c8r"};
+    _node_layout_hint["Eltwise"]["nchw_c16r"] = {"nchw_c16r"};
     _node_layout_hint["Eltwise"]["nchw"] = {"nchw"};
     _node_layout_hint["Concat"]["nchw_c8r"] = {"nchw_c8r"};
     _node_layout_hint["Concat"]["nchw"] = {"nchw"};
+    _node_layout_hint["Scale"]["nchw_c8r"] = {"nchw_c8r"};
+    _node_layout_hint["Scale"]["nchw_c16r"] = {"nchw_c16r"};
+    _node_layout_hint["Scale"]["nchw"] = {"nchw"};
 
     _node_layout_hint["Reshape"]["nchw"] = {"nchw"};
     _node_layout_hint["PriorBox"]["nchw"] = {"nchw"};
@@ -149,111 +160,371 @@ std::vector<std::string> AutoLayoutConfigHelper<Ttype, Ptype>::get_node_out_layo
 }
 
 template<typename Ttype, Precision Ptype>
-std::vector<graph::Edge<Ttype>> AutoLayoutConfigHelper<Ttype, Ptype>::get_node_output_arcs(
-graph::Graph<Ttype, Ptype>& graph, graph::NodePtr& node) {
-    std::vector<graph::Edge<Ttype>> result;
+bool AutoLayoutConfigHelper<Ttype, Ptype>::accept_layout(graph::NodePtr& node,
+        const std::string& in_layout,
+        const std::string& out_layout,
+        const std::vector<int>& in_channels) {
+    const std::string op_name = node->get_op_name();
+    auto out_layouts = get_node_out_layout(op_name, in_layout);
+
+    if (std::count(out_layouts.begin(), out_layouts.end(), out_layout) == 0) {
+        return false;
+    }
 
-    for (auto out_edge : graph.get_out_arc_its(node->name())) {
-        result.push_back(*out_edge);
+    if (in_layout == "nchw" && out_layout == "nchw") {
+        return true;
     }
 
-    return result;
+    const bool c16 = in_layout == "nchw_c16r" || out_layout == "nchw_c16r";
+    const int block = c16 ? 16 : 8;
+
+    if (_conv_op_set.count(op_name) > 0) {
+        // keep in step with the kernel selection of SaberConv<X86, AK_FLOAT>
+        auto weights = node->template get_attr<PBlock<Ttype>>("weight_1");
+        auto padding = node->template get_attr<PTuple<int>>("padding");
+        int group = node->template get_attr<int>("group");
+        int out_channel = weights.shape().num();
+        int in_channel = weights.shape().channel() * group;
+        bool depthwise = group > 1 && group == in_channel && group == out_channel;
+        bool aligned = in_channel % block == 0 && out_channel % block == 0;
+
+        if (c16) {
+            if (in_layout == out_layout) {
+                return aligned && (group == 1 || depthwise);
+            }
+
+            return group == 1 && (in_channel == 1 || in_channel == 3);
+        }
+
+        if (group == 1) {
+            return padding[1] <= 3;
+        }
+
+        if (depthwise) {
+            return aligned && out_layout == "nchw_c8r";
+        }
+
+        return aligned && in_layout == "nchw_c8r" && out_layout == "nchw_c8r" && padding[1] <= 3;
+    }
+
+    if (op_name == "Activation") {
+        // prelu slopes are stored per channel in nchw order
+        return node->template get_attr<std::string>("type") != "PReLU";
+    }
+
+    if (op_name == "Scale") {
+        return in_channels.size() == 1 && node->template get_attr<int>("axis") == 1
+               && node->template get_attr<int>("num_axes", 1) == 1;
+    }
+
+    if (op_name == "Concat") {
+        if (node->template get_attr<int>("axis") != 1) {
+            return false;
+        }
+
+        for (auto in_channel : in_channels) {
+            if (in_channel <= 0 || in_channel % block != 0) {
+                return false;
+            }
+        }
+    }
+
+    return true;
 }
 
 template<typename Ttype, Precision Ptype>
-std::vector<graph::NodePtr> AutoLayoutConfigHelper<Ttype, Ptype>::get_node_output_nodes(
-    graph::Graph<Ttype, Ptype>& graph, graph::NodePtr& node) {
-    std::vector<graph::NodePtr> result;
+int AutoLayoutConfigHelper<Ttype, Ptype>::infer_out_channel(graph::NodePtr& node,
+        const std::vector<int>& in_channels) {
+    static const std::unordered_set<std::string> keep_channel_op = {"ReLU", "Activation", "Eltwise",
+                                                                    "Pooling", "Scale", "Split"
+                                                                   };
+    const std::string op_name = node->get_op_name();
+
+    if (op_name == "Input") {
+        auto input_shape = node->template get_attr<PTuple<int>>("input_shape");
+        return input_shape.size() == 4 ? input_shape[1] : -1;
+    }
 
-    for (auto out_edge : graph.get_out_arc_its(node->name())) {
-        result.push_back(graph[out_edge->top()]);
+    if (_conv_op_set.count(op_name) > 0) {
+        return node->template get_attr<PBlock<Ttype>>("weight_1").shape().num();
     }
 
-    return result;
+    if (op_name == "Concat") {
+        if (node->template get_attr<int>("axis") != 1) {
+            return -1;
+        }
+
+        int channel = 0;
+
+        for (auto in_channel : in_channels) {
+            if (in_channel < 0) {
+                return -1;
+            }
+
+            channel += in_channel;
+        }
+
+        return channel;
+    }
+
+    if (keep_channel_op.count(op_name) > 0 && !in_channels.empty()) {
+        return in_channels[0];
+    }
+
+    return -1;
 }
+
 template<typename Ttype, Precision Ptype>
-void AutoLayoutConfigHelper<Ttype, Ptype>::scane_dfs_from_input(graph::Graph<Ttype, Ptype>& graph) {
-    for (auto out_name : graph.get_outs()) {
-        for (auto next_arc : graph.get_in_arc_its(out_name)) {
-            _layout_map_bynode[next_arc->name()] = "nchw";
-            _edge_done_map[out_name] = "nchw";
+void AutoLayoutConfigHelper<Ttype, Ptype>::scane_region_layout(graph::Graph<Ttype, Ptype>& graph,
+        bool support_c16) {
+    const std::string nchw = "nchw";
+    const std::string c8r = "nchw_c8r";
+    const std::string c16r = "nchw_c16r";
+    auto& exec_order = graph.get_nodes_in_order();
+    _layout_map_bynode.clear();
+    _trans_edges.clear();
+
+    // channels of every edge, the blocked kernels of concat need them
+    std::unordered_map<std::string, int> edge_channel;
+    std::unordered_map<std::string, std::vector<int>> node_in_channels;
+
+    for (auto& name : exec_order) {
+        auto node = graph[name];
+        std::vector<int> in_channels;
+
+        for (auto& arc : graph.get_in_arc_its(name)) {
+            auto it = edge_channel.find(arc->name());
+            in_channels.push_back(it == edge_channel.end() ? -1 : it->second);
+        }
+
+        int out_channel = infer_out_channel(node, in_channels);
+
+        for (auto& arc : graph.get_out_arc_its(name)) {
+            edge_channel[arc->name()] = out_channel;
         }
 
+        node_in_channels[name] = in_channels;
     }
 
-    for (auto in_name : graph.get_ins()) {
-        for (auto next_arc : graph.get_out_arc_its(in_name)) {
-            scane_dfs(graph, *next_arc, "nchw", true);
+    auto accepted_out_layouts = [&, this](const std::string & name, const std::string & in_layout) {
+        auto node = graph[name];
+        std::vector<std::string> result;
+
+        for (auto& out_layout : get_node_out_layout(node->get_op_name(), in_layout)) {
+            if (out_layout != c16r && accept_layout(node, in_layout, out_layout, node_in_channels[name])) {
+                result.push_back(out_layout);
+            }
         }
+
+        return result;
+    };
+
+    // backward: a node wants blocked input when it can read it and it is a conv
+    // or feeds a node which wants it
+    std::unordered_map<std::string, bool> want_block;
+
+    for (auto it = exec_order.rbegin(); it != exec_order.rend(); ++it) {
+        bool want = false;
+
+        if (!accepted_out_layouts(*it, c8r).empty()) {
+            auto start_layouts = get_node_out_layout(graph[*it]->get_op_name(), nchw);
+            want = std::count(start_layouts.begin(), start_layouts.end(), c8r) > 0;
+
+            for (auto& arc : graph.get_out_arc_its(*it)) {
+                want = want || want_block[arc->top()];
+            }
+        }
+
+        want_block[*it] = want;
     }
-}
 
-template<typename Ttype, Precision Ptype>
-bool AutoLayoutConfigHelper<Ttype, Ptype>::scane_dfs(graph::Graph<Ttype, Ptype>& graph,
-        graph::Edge<Ttype>& edge,
-        std::string suggest_layout, bool frozen_layout,
-        std::unordered_map<std::string, std::string>* return_layout_map) {
-    if (_layout_map_bynode.count(edge.name()) > 0) {
-        return _layout_map_bynode[edge.name()] == suggest_layout;
+    // forward: every node reads the layout most of its inputs are in and writes the
+    // blocked layout only when a consumer wants it
+    std::unordered_map<std::string, std::string> edge_layout;
+    std::unordered_map<std::string, std::string> node_in_layout;
+    std::unordered_map<std::string, std::string> node_out_layout;
+
+    for (auto& name : exec_order) {
+        auto& in_arcs = graph.get_in_arc_its(name);
+        std::string in_layout = nchw;
+        int best_cost = -1;
+        std::vector<std::string> candidates = want_block[name] ?
+                                              std::vector<std::string> {c8r, nchw} :
+                                              std::vector<std::string> {nchw, c8r};
+
+        for (auto& candidate : candidates) {
+            if (in_arcs.empty() || accepted_out_layouts(name, candidate).empty()) {
+                continue;
+            }
+
+            int cost = 0;
+
+            for (auto& arc : in_arcs) {
+                cost += edge_layout[arc->name()] != candidate;
+            }
+
+            if (best_cost < 0 || cost < best_cost) {
+                best_cost = cost;
+                in_layout = candidate;
+            }
+        }
+
+        bool consumer_want = false;
+
+        for (auto& arc : graph.get_out_arc_its(name)) {
+            consumer_want = consumer_want || want_block[arc->top()];
+        }
+
+        auto out_layouts = accepted_out_layouts(name, in_layout);
+        std::string out_layout = out_layouts.empty() ? nchw : out_layouts[0];
+
+        if (consumer_want && std::count(out_layouts.begin(), out_layouts.end(), c8r) > 0) {
+            out_layout = c8r;
+        } else if (std::count(out_layouts.begin(), out_layouts.end(), nchw) > 0) {
+            out_layout = nchw;
+        }
+
+        node_in_layout[name] = in_layout;
+        node_out_layout[name] = out_layout;
+
+        for (auto& arc : graph.get_out_arc_its(name)) {
+            edge_layout[arc->name()] = out_layout;
+        }
     }
 
-    auto node = graph[edge.top()];
+    // the blocked edges connected through nodes form regions, a region becomes
+    // nchw_c16r when every node touching it runs with nchw_c16r
+    std::unordered_map<std::string, std::string> parent;
+    std::function<std::string(const std::string&)> find_root = [&](const std::string & port) {
+        auto it = parent.find(port);
 
-    auto layout_prefer_vec = get_node_out_layout(node->get_op_name(), suggest_layout);
+        if (it == parent.end()) {
+            parent[port] = port;
+            return port;
+        }
 
-    if (layout_prefer_vec.size() > 0) {
-        std::unordered_map<std::string, std::string> retire_layout_map;
+        if (it->second == port) {
+            return port;
+        }
 
-        for (auto layout_prefer : layout_prefer_vec) {
-            bool accept = true;
-            bool multi_output = get_node_output_arcs(graph, node).size() > 1;
+        std::string root = find_root(it->second);
+        parent[port] = root;
+        return root;
+    };
+    auto join = [&](const std::string & a, const std::string & b) {
+        parent[find_root(a)] = find_root(b);
+    };
+    std::unordered_map<std::string, bool> region_c16;
 
-            for (auto next_arc : get_node_output_arcs(graph, node)) {
-                std::string next_node_name = graph[next_arc.top()]->name();
+    if (support_c16) {
+        std::vector<std::string> block_nodes;
 
-                bool ck = false;
+        for (auto& name : exec_order) {
+            std::vector<std::string> ports;
 
-                if (multi_output) {
-                    if (return_layout_map == nullptr) {
-                        ck = scane_dfs(graph, next_arc, layout_prefer, false, &retire_layout_map);
-                    } else {
-                        ck = scane_dfs(graph, next_arc, layout_prefer, false, return_layout_map);
-                    }
-                } else {
-                    ck = scane_dfs(graph, next_arc, layout_prefer, true);
+            for (auto& arc : graph.get_in_arc_its(name)) {
+                if (edge_layout[arc->name()] == node_in_layout[name]) {
+                    join(arc->name() + "@out", arc->name() + "@in");
                 }
 
-                accept = accept && ck;
+                if (node_in_layout[name] == c8r) {
+                    ports.push_back(arc->name() + "@in");
+                }
+            }
 
-                if (!accept) {
-                    break;
+            for (auto& arc : graph.get_out_arc_its(name)) {
+                if (node_out_layout[name] == c8r) {
+                    ports.push_back(arc->name() + "@out");
                 }
             }
 
-            if (accept) {
-                if (frozen_layout) {
-                    _layout_map_bynode[edge.name()] = suggest_layout;
+            for (auto& port : ports) {
+                join(port, ports[0]);
+            }
 
-                    if (multi_output) {
-                        if (return_layout_map == nullptr) {
-                            for (auto next_arc : retire_layout_map) {
-                                _layout_map_bynode[next_arc.first] = next_arc.second;
-                            }
-                        }
-                    }
-                } else {
-                    (*return_layout_map)[edge.name()] = suggest_layout;
-                }
+            if (!ports.empty()) {
+                parent[name] = ports[0];
+                block_nodes.push_back(name);
+            }
+        }
+
+        for (auto& name : block_nodes) {
+            auto node = graph[name];
+            std::string in_layout = node_in_layout[name] == c8r ? c16r : node_in_layout[name];
+            std::string out_layout = node_out_layout[name] == c8r ? c16r : node_out_layout[name];
+            std::string root = find_root(name);
+            bool accept = accept_layout(node, in_layout, out_layout, node_in_channels[name]);
+            region_c16[root] = (region_c16.count(root) == 0 || region_c16[root]) && accept;
+        }
+    }
+
+    auto resolve = [&](const std::string & layout, const std::string & port) {
+        if (layout != c8r || parent.count(port) == 0) {
+            return layout;
+        }
 
-                return true;
+        auto it = region_c16.find(find_root(port));
+        return (it != region_c16.end() && it->second) ? c16r : c8r;
+    };
+
+    for (auto& name : exec_order) {
+        for (auto& arc : graph.get_out_arc_its(name)) {
+            _layout_map_bynode[arc->name()] = resolve(edge_layout[arc->name()], arc->name() + "@out");
+        }
+
+        for (auto& arc : graph.get_in_arc_its(name)) {
+            if (edge_layout[arc->name()] != node_in_layout[name]) {
+                _trans_edges.push_back({arc->bottom(), arc->top(),
+                                        resolve(node_in_layout[name], arc->name() + "@in")});
             }
         }
+    }
+}
+
+template<typename Ttype, Precision Ptype>
+Status AutoLayoutConfigHelper<Ttype, Ptype>::insert_layout_trans(graph::Graph<Ttype, Ptype>& graph) {
+    // check every edge before the graph is changed, a later failure would leave it half converted
+    std::unordered_set<std::string> trans_names;
+
+    for (auto& edge : _trans_edges) {
+        std::string trans_name = edge.bottom + "_" + edge.top + "_layout_trans";
+
+        if (graph.has_vertex(trans_name) || !trans_names.insert(trans_name).second) {
+            return Status::ANAKINFAIL("[EEROR]: layout trans node name exists");
+        }
+
+        if (!graph.has_vertex(edge.bottom) || !graph.has_vertex(edge.top)) {
+            return Status::ANAKINFAIL("[EEROR]: layout trans on an unknown arc");
+        }
 
+        bool has_arc = false;
+
+        for (auto& arc : graph.get_in_arc_its(edge.top)) {
+            has_arc = has_arc || arc->bottom() == edge.bottom;
+        }
+
+        if (!has_arc) {
+            return Status::ANAKINFAIL("[EEROR]: layout trans on an unknown arc");
+        }
     }
 
-    return false;
+    for (auto& edge : _trans_edges) {
+        std::string edge_name = edge.bottom + "_" + edge.top;
+        std::string trans_name = edge_name + "_layout_trans";
+        auto status = graph.InsertOp(trans_name, "LayoutTrans", edge.bottom, edge.top);
+        CHECK(status) << "insert " << trans_name << " failed after the check";
+
+        _layout_map_bynode[edge.bottom + "_" + trans_name] = _layout_map_bynode[edge_name];
+        _layout_map_bynode[trans_name + "_" + edge.top] = edge.layout;
+        _layout_map_bynode.erase(edge_name);
+        LOG(INFO) << "insert " << trans_name << " : " << _layout_map_bynode[edge.bottom + "_" + trans_name]
+                  << " -> " << edge.layout;
+    }
 
+    _trans_edges.clear();
+    return Status::OK();
 }
+
 template<typename Ttype, Precision Ptype>
 bool AutoLayoutConfigHelper<Ttype, Ptype>::check_merge(graph::Graph<Ttype, Ptype>& graph) {
     bool result = true;
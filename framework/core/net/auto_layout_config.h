@@ -19,6 +19,7 @@
 #include "framework/graph/graph.h"
 #include "framework/core/net/operator_func.h"
 #include "framework/core/net/calibrator_factory.h"
+#include <unordered_set>
 namespace anakin {
 template<typename Ttype, Precision Ptype>
 class AutoLayoutConfigHelper {
@@ -28,7 +29,24 @@ public:
     }
     bool check_merge(graph::Graph<Ttype, Ptype>& graph);
     void print_layout();
-    void scane_dfs_from_input(graph::Graph<Ttype, Ptype>& graph);
+
+    /**
+     * \brief assign layouts to whole regions of the graph instead of edge by edge.
+     * conv ops start blocked regions, the ops which run on blocked data (relu, eltwise, concat,
+     * pooling, scale, split ...) keep them, the others read nchw. where a consumer can not read
+     * the layout of its producer, the edge is recorded for an explicit LayoutTrans node.
+     * regions are nchw_c16r when every op of the region supports it on avx512, else nchw_c8r.
+     * \param support_c16 true when the avx512 kernels are usable
+     */
+    void scane_region_layout(graph::Graph<Ttype, Ptype>& graph, bool support_c16);
+
+    /**
+     * \brief insert a LayoutTrans node on every edge recorded by scane_region_layout,
+     * the layouts of the split edges are updated in the config layout.
+     * all the edges are checked first, the graph is left unchanged when one can't be split
+     */
+    Status insert_layout_trans(graph::Graph<Ttype, Ptype>& graph);
+
     std::unordered_map<std::string, std::string> get_config_layout(){
         return _layout_map_bynode;
     };
@@ -38,13 +56,10 @@ public:
 private:
     void init();
     std::vector<std::string> get_node_out_layout(std::string node_type, std::string in_layout);
-    std::vector<graph::NodePtr> get_node_output_nodes(graph::Graph<Ttype, Ptype>& graph, graph::NodePtr& node);
-    std::vector<graph::Edge<Ttype>> get_node_output_arcs(graph::Graph<Ttype, Ptype>& graph,
-                                 graph::NodePtr& node);
-
-    bool scane_dfs(graph::Graph<Ttype, Ptype>& graph, graph::Edge<Ttype>& edge,
-                   std::string suggest_layout, bool frozen_layout,
-                   std::unordered_map<std::string, std::string>* return_layout_map = nullptr);
+    bool accept_layout(graph::NodePtr& node, const std::string& in_layout,
+                       const std::string& out_layout,
+                       const std::vector<int>& in_channels);
+    int infer_out_channel(graph::NodePtr& node, const std::vector<int>& in_channels);
 
     void scane_dfs_int8_node(graph::Graph<Ttype, Ptype>& graph, graph::NodePtr& node, std::string last_node_dtype);
 
@@ -55,7 +70,15 @@ private:
     _node_layout_hint;
     std::unordered_map<std::string, std::unordered_map<std::string, std::vector<std::string>>>
     _node_layout_hint_reverse;
-    std::unordered_map<std::string, std::string> _edge_done_map;
+    std::unordered_set<std::string> _conv_op_set;
+    ///< TransEdge: an edge whose consumer reads another layout than its producer writes
+    struct TransEdge {
+        std::string bottom;
+        std::string top;
+        std::string layout;
+    };
+    ///< _trans_edges: filled by scane_region_layout, consumed by insert_layout_trans
+    std::vector<TransEdge> _trans_edges;
     std::unordered_map<std::string, std::string> _layout_map_bynode;
 };
 }
@@ -61,11 +61,20 @@ public:
     virtual CalibrationAlgoType get_algorithm() = 0;
 
     std::vector<Tensor4dPtr<Ttype>> get_in_vec() {
-        return _net->get_in_list();
+        return get_in_vec(_net);
     }
 
     std::vector<OperatorFunc<Ttype, Precision::FP32>> get_exec_funcs() {
-        return _net->_exec_funcs;
+        return get_exec_funcs(_net);
+    }
+
+    std::vector<Tensor4dPtr<Ttype>> get_in_vec(Net<Ttype, Precision::FP32, OpRunType::SYNC>* net) {
+        return net->get_in_list();
+    }
+
+    std::vector<OperatorFunc<Ttype, Precision::FP32>> get_exec_funcs(
+            Net<Ttype, Precision::FP32, OpRunType::SYNC>* net) {
+        return net->_exec_funcs;
     }
 
     std::vector<std::string> get_tensor_name_list() {
@@ -1,4 +1,10 @@
 #include "framework/core/net/calibrator_factory.h"
+#ifndef USE_SGX
+#include "framework/core/net/entropy_calibrator.h"
+#include "framework/core/net/percentile_calibrator.h"
+#include "framework/core/net/mse_calibrator.h"
+#include "framework/core/net/auto_calibrator.h"
+#endif
 
 namespace anakin{
 
@@ -61,4 +67,41 @@ OperatorBase* create_op_with_pt(std::string op_name, std::string precision, std:
     return nullptr;
 }
 
+#ifndef USE_SGX
+template <typename Ttype>
+Calibrator<Ttype>* create_calibrator(CalibrationAlgoType algo,
+                                     BatchStream<Ttype>* stream,
+                                     int batch_size,
+                                     std::string calibrator_file,
+                                     Net<Ttype, Precision::FP32, OpRunType::SYNC>* net,
+                                     int bin_num,
+                                     float percentile) {
+    switch (algo) {
+    case ENTROPY:
+        return new EntropyCalibrator<Ttype>(stream, batch_size, calibrator_file, net, bin_num);
+    case MAXABS:
+        return new PercentileCalibrator<Ttype>(stream, batch_size, calibrator_file, net, bin_num, 100.f);
+    case PERCENTILE:
+        return new PercentileCalibrator<Ttype>(stream, batch_size, calibrator_file, net, bin_num,
+                                               percentile);
+    case MSE:
+        return new MseCalibrator<Ttype>(stream, batch_size, calibrator_file, net, bin_num);
+    case AUTO:
+        return new AutoCalibrator<Ttype>(stream, batch_size, calibrator_file, net, bin_num, percentile);
+    default:
+        LOG(FATAL) << "unsupport calibration algorithm " << algo;
+    }
+    return nullptr;
+}
+
+#ifdef USE_CUDA
+template Calibrator<NV>* create_calibrator<NV>(CalibrationAlgoType, BatchStream<NV>*, int,
+        std::string, Net<NV, Precision::FP32, OpRunType::SYNC>*, int, float);
+#endif
+#ifdef USE_X86_PLACE
+template Calibrator<X86>* create_calibrator<X86>(CalibrationAlgoType, BatchStream<X86>*, int,
+        std::string, Net<X86, Precision::FP32, OpRunType::SYNC>*, int, float);
+#endif
+#endif // USE_SGX
+
 }
@@ -26,6 +26,28 @@ namespace anakin{
 
 OperatorBase* create_op_with_pt(std::string op_name, std::string precision, std::string target);
 
+#ifndef USE_SGX
+template<typename Ttype>
+class Calibrator;
+template<typename Ttype>
+class BatchStream;
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+class Net;
+
+/**
+ * \brief create the calibrator of algo, the caller owns it.
+ * percentile is used by PERCENTILE and AUTO, MAXABS clips at the max of each tensor.
+ */
+template <typename Ttype>
+Calibrator<Ttype>* create_calibrator(CalibrationAlgoType algo,
+                                     BatchStream<Ttype>* stream,
+                                     int batch_size,
+                                     std::string calibrator_file,
+                                     Net<Ttype, Precision::FP32, OpRunType::SYNC>* net,
+                                     int bin_num,
+                                     float percentile = 99.99f);
+#endif
+
 template <typename Target>
 OperatorBase* create_precision_op(std::string op_name, std::string precision){
     LOG(INFO) << "creating op:" << op_name << "( precision:" << precision << ")";
@@ -24,6 +24,9 @@ std::string layout2str(saber::LayoutType type) {
     case Layout_NCHW_C8R:
         return "nchw_c8r";
 
+    case Layout_NCHW_C16R:
+        return "nchw_c16r";
+
     case Layout_NCHW_C4:
         return "nchw_c4";
 
@@ -42,6 +45,8 @@ saber::LayoutType  str2layout(const std::string& str) {
         return Layout_NHWC;
     } else if (str == "nchw_c8r") {
         return Layout_NCHW_C8R;
+    } else if (str == "nchw_c16r") {
+        return Layout_NCHW_C16R;
     } else {
         return Layout_NCHW;
     }
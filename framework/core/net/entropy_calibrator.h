@@ -21,23 +21,22 @@
 
 #ifndef USE_SGX
 
-#include "framework/core/net/calibrator.h"
+#include "framework/core/net/histogram_calibrator.h"
 
 namespace anakin {
 
 /** 
- *  \brief Net class used for execution of graph and it is thread safety.
+ *  \brief calibrator that clips each tensor where the kl divergence to the int8 distribution is least.
  */
 template<typename Ttype>
-class EntropyCalibrator: public Calibrator<Ttype> {
+class EntropyCalibrator: public HistogramCalibrator<Ttype> {
 public:
     EntropyCalibrator(BatchStream<Ttype>* stream,
               int batch_size,
               std::string calibrator_file, 
               Net<Ttype, Precision::FP32, OpRunType::SYNC>* net,
               int bin_num):
-         Calibrator<Ttype>(stream, batch_size, calibrator_file, net), 
-         _bin_num(bin_num) {}
+         HistogramCalibrator<Ttype>(stream, batch_size, calibrator_file, net, bin_num) {}
 
     ~EntropyCalibrator() { 
         for (auto tensor : _in_vec) {
@@ -46,57 +45,23 @@ public:
         }
     }
 
-    virtual void init_statistics(int tensor_num);
-
-    virtual int get_batch_data(std::vector<Tensor4dPtr<Ttype>> inputs);
-
-    virtual void reset_data_stream();
-
-    //virtual int get_batch_size() {return _batch_size;}
-
-    virtual void read_calibrator();
-
-    virtual void write_calibrator();
-
-    virtual void generate_calibrator_table();
-
     virtual CalibrationAlgoType get_algorithm() {return ENTROPY;}
 
-private:
-    void get_ref_q(std::vector<int>& ref_p, std::vector<float>& ref_q);
-
-    void expand_to_q(std::vector<int>& ref_p, std::vector<float>& ref_q, std::vector<float>& q);
-
-    float get_kl_divergence(std::vector<int>&ref_p, std::vector<float>& q);
-
-    void get_histgrams(std::vector<Tensor4dPtr<Ttype>> in_vec,
-            std::vector<OperatorFunc<Ttype, Precision::FP32 >> exec_funcs);
-
-    void get_max_values(std::vector<Tensor4dPtr<Ttype>> in_vec,
-            std::vector<OperatorFunc<Ttype, Precision::FP32 >> exec_funcs);
-
-    void get_kl_threshold(std::vector<std::string>& tensor_name_list);
+protected:
+    virtual float get_clip_value(int tensor_id);
 
-    float max_data(Tensor4dPtr<Ttype> tensor, int tensor_id);
+    /*histogram bin the minimum kl divergence threshold ends at, 0 if the histogram is too short*/
+    int get_kl_threshold(int tensor_id);
 
-    void histgram(Tensor4dPtr<Ttype> tensor, int tensor_id);
+private:
+    void get_ref_q(std::vector<int64_t>& ref_p, std::vector<float>& ref_q);
 
-    int get_bin_num() {return _bin_num;}
+    void expand_to_q(std::vector<int64_t>& ref_p, std::vector<float>& ref_q, std::vector<float>& q);
 
-    std::vector<float>& max_vec() {return _max_vec;}
+    float get_kl_divergence(std::vector<int64_t>&ref_p, std::vector<float>& q);
 
-    std::vector<std::vector<int>>& hist_vecs() {return _hist_vecs;}
-    
 protected:
     std::vector<Tensor4dPtr<X86>> _in_vec;
-
-    std::map<std::string, float> _scale_map;
-
-    std::vector<float> _max_vec;
-
-    std::vector<std::vector<int>> _hist_vecs;
-
-    int _bin_num;
 };
 }
 #endif // USE_SGX
@@ -0,0 +1,444 @@
+
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+   
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License. 
+*/
+
+#include "framework/core/net/histogram_calibrator.h"
+
+#ifndef USE_SGX
+
+#include "framework/utils/data_common.h"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+namespace anakin {
+
+namespace {
+/*tensors below this size are scanned by the calling thread only*/
+const int64_t STAT_PARALLEL_MIN = 1 << 16;
+/*elements one thread scans in one piece of work*/
+const int64_t STAT_CHUNK = 1 << 14;
+/*at most this many partial histograms are reduced per tensor*/
+const int STAT_MAX_PARTS = 32;
+
+float abs_max_serial(const float* data, int64_t size) {
+    int64_t i = 0;
+    float max_value = 0.f;
+#if defined(__AVX512F__)
+    __m512 vmax = _mm512_setzero_ps();
+    for (; i + 16 <= size; i += 16) {
+        /*nan in data leaves the max untouched*/
+        vmax = _mm512_max_ps(_mm512_abs_ps(_mm512_loadu_ps(data + i)), vmax);
+    }
+    max_value = _mm512_reduce_max_ps(vmax);
+#elif defined(__AVX2__)
+    const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    __m256 vmax = _mm256_setzero_ps();
+    for (; i + 8 <= size; i += 8) {
+        vmax = _mm256_max_ps(_mm256_and_ps(_mm256_loadu_ps(data + i), abs_mask), vmax);
+    }
+    float buf[8];
+    _mm256_storeu_ps(buf, vmax);
+    for (int j = 0; j < 8; j++) {
+        max_value = buf[j] > max_value ? buf[j] : max_value;
+    }
+#endif
+    for (; i < size; i++) {
+        auto x = fabs(data[i]);
+        max_value = x > max_value ? x : max_value;
+    }
+    return max_value;
+}
+
+/*|x| * inv_step is truncated to the bin id, values at or past the last bin and nan go to the last bin*/
+void histogram_serial(const float* data, int64_t size, float inv_step, int bin_num, int64_t* hist) {
+    int64_t i = 0;
+    const float last_bin = float(bin_num - 1);
+#if defined(__AVX512F__)
+    const __m512 vstep = _mm512_set1_ps(inv_step);
+    const __m512 vlast = _mm512_set1_ps(last_bin);
+    int ids[16];
+    for (; i + 16 <= size; i += 16) {
+        __m512 v = _mm512_mul_ps(_mm512_abs_ps(_mm512_loadu_ps(data + i)), vstep);
+        _mm512_storeu_si512(ids, _mm512_cvttps_epi32(_mm512_min_ps(v, vlast)));
+        for (int j = 0; j < 16; j++) {
+            hist[ids[j]]++;
+        }
+    }
+#elif defined(__AVX2__)
+    const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    const __m256 vstep = _mm256_set1_ps(inv_step);
+    const __m256 vlast = _mm256_set1_ps(last_bin);
+    int ids[8];
+    for (; i + 8 <= size; i += 8) {
+        __m256 v = _mm256_mul_ps(_mm256_and_ps(_mm256_loadu_ps(data + i), abs_mask), vstep);
+        _mm256_storeu_si256((__m256i*)ids, _mm256_cvttps_epi32(_mm256_min_ps(v, vlast)));
+        for (int j = 0; j < 8; j++) {
+            hist[ids[j]]++;
+        }
+    }
+#endif
+    for (; i < size; i++) {
+        float v = fabs(data[i]) * inv_step;
+        int id = v < last_bin ? int(v) : bin_num - 1;
+        hist[id]++;
+    }
+}
+
+float abs_max(const float* data, int64_t size, bool parallel) {
+    const int64_t chunk_num = (size + STAT_CHUNK - 1) / STAT_CHUNK;
+    float max_value = 0.f;
+#pragma omp parallel for schedule(static) reduction(max:max_value) if (parallel && size >= STAT_PARALLEL_MIN)
+    for (int64_t c = 0; c < chunk_num; c++) {
+        int64_t begin = c * STAT_CHUNK;
+        float chunk_max = abs_max_serial(data + begin, std::min(STAT_CHUNK, size - begin));
+        max_value = chunk_max > max_value ? chunk_max : max_value;
+    }
+    return max_value;
+}
+
+/*each part bins its own slice into a private histogram, the parts are summed into hist*/
+void histogram(const float* data, int64_t size, float range, int bin_num, bool parallel,
+        std::vector<int64_t>& hist) {
+    hist.assign(bin_num, 0);
+    if (range <= 0.f) {
+        hist[0] = size;
+        return;
+    }
+    const float inv_step = bin_num / range;
+    int part_num = 1;
+    if (parallel && size >= STAT_PARALLEL_MIN) {
+        part_num = int(std::min<int64_t>(STAT_MAX_PARTS, size / STAT_CHUNK));
+    }
+    if (part_num == 1) {
+        histogram_serial(data, size, inv_step, bin_num, hist.data());
+        return;
+    }
+    const int64_t part_size = (size + part_num - 1) / part_num;
+    std::vector<int64_t> parts(int64_t(part_num) * bin_num, 0);
+#pragma omp parallel for schedule(static)
+    for (int p = 0; p < part_num; p++) {
+        int64_t begin = p * part_size;
+        int64_t len = std::min(part_size, size - begin);
+        if (len > 0) {
+            histogram_serial(data + begin, len, inv_step, bin_num, parts.data() + int64_t(p) * bin_num);
+        }
+    }
+    for (int p = 0; p < part_num; p++) {
+        const int64_t* part = parts.data() + int64_t(p) * bin_num;
+        for (int j = 0; j < bin_num; j++) {
+            hist[j] += part[j];
+        }
+    }
+}
+
+/*widen the histogram range by an integer factor, factor neighbouring bins merge into one*/
+void rebin(std::vector<int64_t>& hist, int factor) {
+    if (factor <= 1) {
+        return;
+    }
+    for (int j = 1; j < hist.size(); j++) {
+        int64_t count = hist[j];
+        hist[j] = 0;
+        hist[j / factor] += count;
+    }
+}
+
+/*host view of a tensor, x86 tensors are read in place*/
+template<typename Ttype>
+const float* host_data(Tensor4dPtr<Ttype> tensor, Tensor4d<X86>& h_tensor) {
+    h_tensor.reshape(tensor->valid_shape());
+    h_tensor.copy_from(*tensor);
+#ifdef USE_CUDA
+    cudaDeviceSynchronize();
+#endif
+    return (const float*)h_tensor.data();
+}
+
+#ifdef USE_X86_PLACE
+template<>
+const float* host_data<X86>(Tensor4dPtr<X86> tensor, Tensor4d<X86>& h_tensor) {
+    if (!tensor->is_continue_mem()) {
+        h_tensor.reshape(tensor->valid_shape());
+        h_tensor.copy_from(*tensor);
+        return (const float*)h_tensor.data();
+    }
+    return (const float*)tensor->data() + tensor->data_offset();
+}
+#endif
+} //namespace
+
+template<typename Ttype>
+void HistogramCalibrator<Ttype>::init_statistics(int tensor_num) {
+    _max_vec.assign(tensor_num, 0.f);
+    _hist_range_vec.assign(tensor_num, 0.f);
+    _hist_vecs.assign(tensor_num, std::vector<int64_t>(_bin_num, 0));
+}
+/** 
+ *  \brief Net class used for execution of graph and it is thread safety.
+ */
+template<typename Ttype>
+int  HistogramCalibrator<Ttype>::get_batch_data(std::vector<Tensor4dPtr<Ttype>> inputs) {
+    //if (_in_vec.size() == 0) {
+    //    _in_vec.resize(inputs.size());
+    //    int i = 0;
+    //    for (auto input : inputs) {
+    //        _in_vec[i++] = new Tensor<X86>(input->valid_shape());
+    //    }
+    //}
+    int num = this->_batch_stream->get_batch_data(inputs);
+    //if (num > 0) {
+    //    int i = 0;
+    //    for (auto input : inputs) {
+    //        input->reshape(_in_vec[i]->valid_shape());
+    //        input->copy_from((*_in_vec[i]));
+    //        i++;
+    //    }
+    //}
+    return num;
+}
+
+
+template<typename Ttype>
+void HistogramCalibrator<Ttype>::read_calibrator() {
+    std::ifstream ifs(this->_calibrator_file);
+    CHECK(ifs.is_open()) << this->_calibrator_file << "cannot be opened";
+    char buf[200];
+    while (ifs.getline(buf, 200)) {
+        std::string str = buf;
+        std::vector<std::string> delimiter = {" "};
+        std::vector<std::string> str_vec = string_split(str, delimiter);
+        if (str_vec.size() < 2) {
+            continue;
+        }
+        _scale_map.insert(std::pair<std::string, float>(str_vec[0], float(atof(str_vec[1].c_str()))));
+    }
+}
+
+template<typename Ttype>
+void HistogramCalibrator<Ttype>::write_calibrator() {
+    std::ofstream ofs(this->_calibrator_file);
+    CHECK(ofs.is_open()) << this->_calibrator_file << "cannot be opened";
+    char buf[200];
+    typename std::map<std::string, float>::iterator it;
+    for (it = _scale_map.begin(); it != _scale_map.end(); ++it) {
+        int n = snprintf(buf, sizeof(buf), "%s %f\n", it->first.c_str(), float(it->second));
+        ofs.write(buf, n);
+    }
+    ofs.close();
+}
+
+template<typename Ttype>
+void HistogramCalibrator<Ttype>::reset_data_stream() {
+
+    return this->_batch_stream->reset();
+}
+
+template<typename Ttype>
+void HistogramCalibrator<Ttype>::statistic(Tensor4dPtr<Ttype> tensor, int tensor_id, bool inner_parallel) {
+    Tensor4d<X86> h_tensor;
+    const float* data = host_data<Ttype>(tensor, h_tensor);
+    const int64_t size = tensor->valid_size();
+    const float max_value = abs_max(data, size, inner_parallel);
+
+    /*grow the shared range first, so the batch is binned at the final resolution of this moment*/
+    float range = 0.f;
+    {
+        std::lock_guard<std::mutex> lock(_stat_mutexes[tensor_id % STAT_LOCK_NUM]);
+        float& hist_range = _hist_range_vec[tensor_id];
+        _max_vec[tensor_id] = _max_vec[tensor_id] > max_value ? _max_vec[tensor_id] : max_value;
+        if (hist_range <= 0.f) {
+            hist_range = max_value;
+        } else if (max_value > hist_range) {
+            int factor = int(ceil(max_value / hist_range));
+            rebin(_hist_vecs[tensor_id], factor);
+            hist_range *= factor;
+        }
+        range = hist_range;
+    }
+
+    std::vector<int64_t> batch_hist;
+    histogram(data, size, range, _bin_num, inner_parallel, batch_hist);
+
+    /*other threads may have widened the range meanwhile, always by an integer factor of ours*/
+    std::lock_guard<std::mutex> lock(_stat_mutexes[tensor_id % STAT_LOCK_NUM]);
+    int factor = range > 0.f ? int(_hist_range_vec[tensor_id] / range + 0.5f) : 1;
+    rebin(batch_hist, factor);
+    std::vector<int64_t>& hist_vec = _hist_vecs[tensor_id];
+    for (int i = 0; i < _bin_num; i++) {
+        hist_vec[i] += batch_hist[i];
+    }
+}
+
+template<typename Ttype>
+void HistogramCalibrator<Ttype>::get_statistics(Net<Ttype, Precision::FP32, OpRunType::SYNC>* net,
+            bool inner_parallel) {
+    auto in_vec = this->get_in_vec(net);
+    auto exec_funcs = this->get_exec_funcs(net);
+    while (true) {
+        int num = 0;
+        {
+            std::lock_guard<std::mutex> lock(_stream_mutex);
+            num = get_batch_data(in_vec);
+        }
+        if (num == 0) {
+            break;
+        }
+        int tensor_id = 0;
+        for (auto& executer : exec_funcs) {
+            for (int i = 0; i < executer.ins.size(); i++) {
+                executer.ins[i]->sync();
+            }
+
+            if (executer.op_name != "Input" || executer.op_name != "Output") { 
+                executer.infer_shape(); 
+                executer.launch(); 
+            } 
+
+            for (int i = 0; i < executer.outs.size(); i++) { 
+                executer.outs[i]->record_event(executer.ctx_p->get_compute_stream()); 
+            }
+#ifdef  USE_CUDA
+            CUDA_CHECK(cudaDeviceSynchronize());
+            CUDA_CHECK(cudaPeekAtLastError());
+#endif
+            /*outputs may share memory with later tensors, so they are consumed right after the op*/
+            for (auto out : executer.outs) {
+                statistic(out, tensor_id, inner_parallel);
+                tensor_id++;
+            }
+        } // for
+    }
+}
+
+template<typename Ttype>
+float HistogramCalibrator<Ttype>::get_percentile_clip(int tensor_id, float percentile) {
+    std::vector<int64_t>& hist = _hist_vecs[tensor_id];
+    float max_value = _max_vec[tensor_id];
+    int64_t total_num = 0;
+    for (auto a : hist) {
+        total_num += a;
+    }
+    double target = double(total_num) * percentile / 100;
+    int64_t count = 0;
+    for (int i = 0; i < _bin_num; i++) {
+        count += hist[i];
+        if (count >= target) {
+            float clip = bin_edge(tensor_id, i + 1);
+            return clip < max_value ? clip : max_value;
+        }
+    }
+    return max_value;
+}
+
+template<typename Ttype>
+double HistogramCalibrator<Ttype>::get_quant_error(int tensor_id, float clip) {
+    std::vector<int64_t>& hist = _hist_vecs[tensor_id];
+    const float bin_width = bin_edge(tensor_id, 1);
+    if (clip <= 0.f || bin_width <= 0.f) {
+        return 0.0;
+    }
+    const double step = clip / 127.0;
+    const double round_error = step * step / 12;
+    double error = 0.0;
+    for (int i = 0; i < _bin_num; i++) {
+        if (hist[i] == 0) {
+            continue;
+        }
+        double center = bin_width * (i + 0.5);
+        double bin_error = round_error;
+        if (center > clip) {
+            bin_error = (center - clip) * (center - clip);
+        } else if (center < step / 2) {
+            bin_error = center * center;
+        }
+        error += bin_error * hist[i];
+    }
+    return error;
+}
+
+template<typename Ttype>
+float HistogramCalibrator<Ttype>::get_mse_clip(int tensor_id) {
+    float max_value = _max_vec[tensor_id];
+    float best_clip = max_value;
+    double min_error = get_quant_error(tensor_id, max_value);
+    for (int i = 1; i <= _bin_num; i++) {
+        float clip = bin_edge(tensor_id, i);
+        if (clip >= max_value) {
+            break;
+        }
+        double error = get_quant_error(tensor_id, clip);
+        if (error < min_error) {
+            min_error = error;
+            best_clip = clip;
+        }
+    }
+    return best_clip;
+}
+
+template<typename Ttype>
+void HistogramCalibrator<Ttype>::get_scales(std::vector<std::string>& tensor_name_list) {
+    int tensor_num = _hist_vecs.size();
+    std::vector<float> scales(tensor_num);
+    /*every tensor searches its clip value independently*/
+#pragma omp parallel for schedule(dynamic)
+    for (int tensor_id = 0; tensor_id < tensor_num; tensor_id++) {
+        scales[tensor_id] = get_clip_value(tensor_id) / 127;
+    }
+    for (int tensor_id = 0; tensor_id < tensor_num; tensor_id++) {
+        _scale_map.insert(std::pair<std::string, float>(tensor_name_list[tensor_id], scales[tensor_id]));
+    }
+}
+
+template<typename Ttype>
+void HistogramCalibrator<Ttype>::generate_calibrator_table() {
+    auto tensor_name_list = this->get_tensor_name_list();
+    int tensor_num = tensor_name_list.size();
+    init_statistics(tensor_num);
+    if (_worker_nets.empty()) {
+        get_statistics(this->_net, true);
+    } else {
+        /*the nets pull batches from the shared stream until it is drained*/
+        std::vector<std::thread> workers;
+        for (auto net : _worker_nets) {
+            workers.emplace_back([this, net]() {
+                get_statistics(net, false);
+            });
+        }
+        get_statistics(this->_net, false);
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+    for (auto i :_max_vec){
+        LOG(INFO)<<"max vec "<<i;
+    }
+    get_scales(tensor_name_list);
+    write_calibrator();
+}
+
+
+#ifdef USE_CUDA
+template class HistogramCalibrator<NV>;
+#endif
+#ifdef USE_X86_PLACE
+template class HistogramCalibrator<X86>;
+#endif
+    
+}
+    
+#endif // USE_SGX
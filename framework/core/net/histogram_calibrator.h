@@ -0,0 +1,125 @@
+
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+   
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License. 
+*/
+
+#ifndef ANAKIN_HISTOGRAM_CALIBRATOR_H
+#define ANAKIN_HISTOGRAM_CALIBRATOR_H
+
+#include "anakin_config.h"
+
+#ifndef USE_SGX
+
+#include "framework/core/net/calibrator.h"
+#include <mutex>
+
+namespace anakin {
+
+/** 
+ *  \brief base of the calibrators that pick a clip value per tensor from an |x| histogram.
+ *  max and histogram of every tensor are gathered in one pass over the batches,
+ *  the derived class only decides the clip value, the scale written is clip / 127.
+ */
+template<typename Ttype>
+class HistogramCalibrator: public Calibrator<Ttype> {
+public:
+    HistogramCalibrator(BatchStream<Ttype>* stream,
+              int batch_size,
+              std::string calibrator_file, 
+              Net<Ttype, Precision::FP32, OpRunType::SYNC>* net,
+              int bin_num):
+         Calibrator<Ttype>(stream, batch_size, calibrator_file, net), 
+         _bin_num(bin_num) {}
+
+    virtual ~HistogramCalibrator() {}
+
+    virtual int get_batch_data(std::vector<Tensor4dPtr<Ttype>> inputs);
+
+    virtual void reset_data_stream();
+
+    virtual void read_calibrator();
+
+    virtual void write_calibrator();
+
+    virtual void generate_calibrator_table();
+
+    /**
+     *  \brief extra nets built from the same graph as the calibrated net,
+     *  each one runs calibration batches on its own host thread.
+     */
+    void set_worker_nets(std::vector<Net<Ttype, Precision::FP32, OpRunType::SYNC>*> nets) {
+        _worker_nets = nets;
+    }
+
+protected:
+    /*clip value of one tensor, called for all tensors in parallel once the statistics are done*/
+    virtual float get_clip_value(int tensor_id) = 0;
+
+    void init_statistics(int tensor_num);
+
+    /*run the batches of one net, max and histogram of every tensor are gathered in the same pass*/
+    void get_statistics(Net<Ttype, Precision::FP32, OpRunType::SYNC>* net, bool inner_parallel);
+
+    void statistic(Tensor4dPtr<Ttype> tensor, int tensor_id, bool inner_parallel);
+
+    void get_scales(std::vector<std::string>& tensor_name_list);
+
+    /*upper edge of the first bin_id bins*/
+    float bin_edge(int tensor_id, int bin_id) {
+        return _hist_range_vec[tensor_id] / _bin_num * bin_id;
+    }
+
+    /*smallest clip that keeps percentile percent of the values unclipped*/
+    float get_percentile_clip(int tensor_id, float percentile);
+
+    /*clip on the bin edges with the least int8 reconstruction error*/
+    float get_mse_clip(int tensor_id);
+
+    /**
+     *  \brief mean square error of int8 quantization with scale clip / 127, from the histogram.
+     *  values past clip contribute their clipping error, values under half a step round to 0,
+     *  the rest the uniform rounding noise step^2 / 12.
+     */
+    double get_quant_error(int tensor_id, float clip);
+
+    int get_bin_num() {return _bin_num;}
+
+    std::vector<float>& max_vec() {return _max_vec;}
+
+    std::vector<std::vector<int64_t>>& hist_vecs() {return _hist_vecs;}
+    
+    std::map<std::string, float> _scale_map;
+
+    std::vector<float> _max_vec;
+
+    /*upper edge of each histogram, it only grows by integer factors so bins merge exactly*/
+    std::vector<float> _hist_range_vec;
+
+    std::vector<std::vector<int64_t>> _hist_vecs;
+
+    /*guard the max, range and histogram of the tensors with id % STAT_LOCK_NUM == i*/
+    static const int STAT_LOCK_NUM = 64;
+    std::mutex _stat_mutexes[STAT_LOCK_NUM];
+
+    /*serializes reading from the batch stream*/
+    std::mutex _stream_mutex;
+
+    std::vector<Net<Ttype, Precision::FP32, OpRunType::SYNC>*> _worker_nets;
+
+    int _bin_num;
+};
+}
+#endif // USE_SGX
+
+#endif
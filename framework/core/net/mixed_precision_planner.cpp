@@ -0,0 +1,262 @@
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+   
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License. 
+*/
+
+#include "framework/core/net/mixed_precision_planner.h"
+
+#ifndef USE_SGX
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+namespace anakin {
+
+template<typename Ttype>
+void MixedPrecisionPlanner<Ttype>::write_config(const std::set<std::string>& int8_nodes,
+        std::string config_file) {
+    std::ofstream ofs(config_file);
+    CHECK(ofs.is_open()) << config_file << " cannot be opened";
+    std::string target = std::is_same<Ttype, X86>::value ? "X86" : "NV";
+    for (int i = 0; i < _node_names.size(); i++) {
+        std::string precision = int8_nodes.count(_node_names[i]) > 0 ? "int8" : "fp32";
+        ofs << _node_names[i] << "(" << _op_names[i] << ")    " << precision << "    " << target << " \n";
+    }
+    ofs.close();
+}
+
+template<typename Ttype>
+std::shared_ptr<typename MixedPrecisionPlanner<Ttype>::graph_type>
+MixedPrecisionPlanner<Ttype>::build_graph(const std::set<std::string>& int8_nodes,
+        std::string config_file) {
+    std::shared_ptr<graph_type> graph(new graph_type());
+    auto status = graph->load(_model_path);
+    CHECK(status) << " [ERROR] " << status.info();
+    if (_node_names.empty()) {
+        auto get_node = [&, this](graph::NodePtr& node_p) {
+            _node_names.push_back(node_p->name());
+            _op_names.push_back(node_p->get_op_name());
+        };
+        graph->Scanner->BFS(get_node);
+    }
+    for (auto& in : graph->get_ins()) {
+        graph->ResetBatchSize(in, _batch_size);
+    }
+    write_config(int8_nodes, config_file);
+    graph->load_calibrator_config(config_file, _calibrator_file);
+    graph->Optimize();
+    return graph;
+}
+
+template<typename Ttype>
+void MixedPrecisionPlanner<Ttype>::load_batches(net_type& net) {
+    auto in_vec = net.get_in_list();
+    while (true) {
+        int num = _batch_stream->get_batch_data(in_vec);
+        if (num == 0) {
+            break;
+        }
+        std::vector<std::shared_ptr<Tensor<X86>>> batch;
+        for (auto in : in_vec) {
+            std::shared_ptr<Tensor<X86>> h_tensor(new Tensor<X86>(in->valid_shape()));
+            h_tensor->copy_from(*in);
+            batch.push_back(h_tensor);
+        }
+        _batches.push_back(batch);
+    }
+    CHECK_GT(_batches.size(), 0) << "the validation stream is empty";
+}
+
+template<typename Ttype>
+void MixedPrecisionPlanner<Ttype>::run(net_type& net,
+        std::unordered_map<std::string, float>* op_time,
+        std::vector<std::vector<float>>& outputs) {
+    auto in_vec = net.get_in_list();
+    auto out_vec = net.get_out_list();
+    outputs.clear();
+    if (op_time != nullptr) {
+        op_time->clear();
+    }
+    for (int batch_id = 0; batch_id < _batches.size(); batch_id++) {
+        for (int i = 0; i < in_vec.size(); i++) {
+            in_vec[i]->reshape(_batches[batch_id][i]->valid_shape());
+            in_vec[i]->copy_from(*_batches[batch_id][i]);
+        }
+        for (auto& executer : net._exec_funcs) {
+            for (int i = 0; i < executer.ins.size(); i++) {
+                executer.ins[i]->sync();
+            }
+            auto start = std::chrono::steady_clock::now();
+            if (executer.op_name != "Input" || executer.op_name != "Output") {
+                executer.infer_shape();
+                executer.launch();
+            }
+            for (int i = 0; i < executer.outs.size(); i++) {
+                executer.outs[i]->record_event(executer.ctx_p->get_compute_stream());
+            }
+#ifdef  USE_CUDA
+            CUDA_CHECK(cudaDeviceSynchronize());
+#endif
+            auto end = std::chrono::steady_clock::now();
+            /*the first batch warms up, it is only timed when it is the only one*/
+            if (op_time != nullptr && (batch_id > 0 || _batches.size() == 1)) {
+                (*op_time)[executer.name] += std::chrono::duration<float, std::milli>(end - start).count();
+            }
+        }
+        std::vector<float> batch_out;
+        for (auto out : out_vec) {
+            CHECK_EQ(out->get_dtype(), AK_FLOAT) << "net outputs should be fp32 to be compared";
+            Tensor<X86> h_tensor(out->valid_shape());
+            h_tensor.copy_from(*out);
+            const float* data = (const float*)h_tensor.data();
+            batch_out.insert(batch_out.end(), data, data + h_tensor.valid_size());
+        }
+        outputs.push_back(batch_out);
+    }
+    if (op_time != nullptr) {
+        int timed_num = _batches.size() > 1 ? _batches.size() - 1 : 1;
+        for (auto& it : *op_time) {
+            it.second /= timed_num;
+        }
+    }
+}
+
+template<typename Ttype>
+void MixedPrecisionPlanner<Ttype>::write_layout(net_type& net, std::string layout_file) {
+    std::vector<std::string> names;
+    std::vector<saber::LayoutType> layouts;
+    auto get_layout = [&](graph::Edge<Ttype>& edge) {
+        names.push_back(edge.name());
+        layouts.push_back(edge.weight()->get_layout());
+    };
+    net._graph_p->Scanner->BFS_Edge(get_layout);
+    /*auto_config_layout keeps an existing file*/
+    std::remove(layout_file.c_str());
+    CalibratorParser::auto_config_layout(names, layouts, layout_file);
+}
+
+template<typename Ttype>
+float MixedPrecisionPlanner<Ttype>::evaluate(const std::set<std::string>& int8_nodes,
+        std::string config_file, std::unordered_map<std::string, float>* op_time,
+        std::string layout_file) {
+    auto graph = build_graph(int8_nodes, config_file);
+    net_type net;
+    net.init(*graph, std::is_same<Ttype, X86>::value);
+    if (_batches.empty()) {
+        load_batches(net);
+    }
+    std::vector<std::vector<float>> outputs;
+    run(net, op_time, outputs);
+    if (!layout_file.empty()) {
+        write_layout(net, layout_file);
+    }
+    if (_fp32_outputs.empty()) {
+        _fp32_outputs = outputs;
+        return 0.f;
+    }
+    double diff = 0.0;
+    double ref = 0.0;
+    for (int b = 0; b < outputs.size(); b++) {
+        CHECK_EQ(outputs[b].size(), _fp32_outputs[b].size()) << "net outputs changed size";
+        for (int i = 0; i < outputs[b].size(); i++) {
+            double d = outputs[b][i] - _fp32_outputs[b][i];
+            diff += d * d;
+            ref += double(_fp32_outputs[b][i]) * _fp32_outputs[b][i];
+        }
+    }
+    return ref > 0.0 ? float(sqrt(diff / ref)) : float(sqrt(diff));
+}
+
+template<typename Ttype>
+Status MixedPrecisionPlanner<Ttype>::plan(float error_budget, std::string config_file,
+        std::string layout_file) {
+    _sensitivity.clear();
+    _speedup.clear();
+    _int8_nodes.clear();
+    _fp32_outputs.clear();
+    std::unordered_map<std::string, float> fp32_time;
+    evaluate(_int8_nodes, config_file, &fp32_time);
+
+    /*the ops that run by their own name after the graph fusions and have an int8 kernel*/
+    auto& int8_ops = OpFactory<Ttype, Precision::INT8>::Global().get_list_name();
+    std::set<std::string> candidates;
+    for (int i = 0; i < _node_names.size(); i++) {
+        if (fp32_time.count(_node_names[i]) > 0 && _op_names[i] != "Input" && _op_names[i] != "Output"
+                && std::find(int8_ops.begin(), int8_ops.end(), _op_names[i]) != int8_ops.end()) {
+            candidates.insert(_node_names[i]);
+        }
+    }
+    if (candidates.empty()) {
+        write_config(_int8_nodes, config_file);
+        return Status::OK("[WARNING]: no node of the model has an int8 kernel");
+    }
+
+    std::unordered_map<std::string, float> int8_time;
+    evaluate(candidates, config_file, &int8_time);
+    std::vector<std::pair<float, std::string>> order;
+    for (auto& name : candidates) {
+        if (int8_time.count(name) == 0 || int8_time[name] >= fp32_time[name]) {
+            continue;
+        }
+        _speedup[name] = fp32_time[name] - int8_time[name];
+        _sensitivity[name] = evaluate({name}, config_file, nullptr);
+        LOG(INFO) << "node " << name << " saves " << _speedup[name] << " ms, error " << _sensitivity[name];
+        order.push_back({_speedup[name] / (_sensitivity[name] * _sensitivity[name] + 1e-12f), name});
+    }
+    std::sort(order.begin(), order.end(), std::greater<std::pair<float, std::string>>());
+
+    /*errors of independent layers add up in their squares*/
+    std::vector<std::string> chosen;
+    float error_square = 0.f;
+    for (auto& it : order) {
+        float error = _sensitivity[it.second];
+        if (sqrt(error_square + error * error) > error_budget) {
+            continue;
+        }
+        error_square += error * error;
+        chosen.push_back(it.second);
+    }
+
+    /*check the plan as a whole, drop the least efficient nodes until it fits*/
+    float error = 0.f;
+    while (true) {
+        _int8_nodes = std::set<std::string>(chosen.begin(), chosen.end());
+        error = evaluate(_int8_nodes, config_file, nullptr, layout_file);
+        if (error <= error_budget || chosen.empty()) {
+            break;
+        }
+        LOG(INFO) << "plan error " << error << " exceeds budget, drop " << chosen.back();
+        chosen.pop_back();
+    }
+    float saved = 0.f;
+    for (auto& name : _int8_nodes) {
+        saved += _speedup[name];
+    }
+    LOG(INFO) << "plan " << _int8_nodes.size() << " int8 nodes of " << candidates.size()
+              << ", error " << error << ", saves " << saved << " ms per batch";
+    write_config(_int8_nodes, config_file);
+    return Status::OK();
+}
+
+#ifdef USE_CUDA
+template class MixedPrecisionPlanner<NV>;
+#endif
+#ifdef USE_X86_PLACE
+template class MixedPrecisionPlanner<X86>;
+#endif
+
+}
+
+#endif // USE_SGX
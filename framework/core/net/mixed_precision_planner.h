@@ -0,0 +1,121 @@
+
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+   
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License. 
+*/
+
+#ifndef ANAKIN_MIXED_PRECISION_PLANNER_H
+#define ANAKIN_MIXED_PRECISION_PLANNER_H
+
+#include "anakin_config.h"
+
+#ifndef USE_SGX
+
+#include "framework/core/net/net.h"
+#include "framework/core/net/batch_stream.h"
+#include <memory>
+#include <set>
+
+namespace anakin {
+
+/** 
+ *  \brief tool that decides which nodes of a model run in int8.
+ *  it measures on a validation set the time of every op in fp32 and in int8, and the
+ *  output error when that op alone is int8, then greedily takes the ops with the most
+ *  time saved per error until the error budget is spent. the result is written as the
+ *  precision config read by Graph::load_calibrator_config and the layout config read
+ *  by Net::load_x86_layout_config.
+ */
+template<typename Ttype>
+class MixedPrecisionPlanner {
+public:
+    typedef Net<Ttype, Precision::FP32, OpRunType::SYNC> net_type;
+    typedef graph::Graph<Ttype, Precision::FP32> graph_type;
+
+    /**
+     *  \brief calibrator_file holds the tensor scales, e.g. from a calibrator of calibrator_factory.
+     *  the stream is read once and its batches are replayed for every candidate net.
+     */
+    MixedPrecisionPlanner(std::string model_path,
+                          std::string calibrator_file,
+                          BatchStream<Ttype>* stream,
+                          int batch_size):
+        _model_path(model_path),
+        _calibrator_file(calibrator_file),
+        _batch_stream(stream),
+        _batch_size(batch_size) {}
+
+    /**
+     *  \brief plan the precision of every node.
+     *  error_budget is the relative l2 error of all net outputs against fp32 over the validation set.
+     */
+    Status plan(float error_budget, std::string config_file, std::string layout_file);
+
+    /*relative output error with only that node in int8*/
+    const std::unordered_map<std::string, float>& sensitivity() {
+        return _sensitivity;
+    }
+
+    /*ms saved per batch by running that node in int8*/
+    const std::unordered_map<std::string, float>& speedup() {
+        return _speedup;
+    }
+
+    const std::set<std::string>& int8_nodes() {
+        return _int8_nodes;
+    }
+
+private:
+    void write_config(const std::set<std::string>& int8_nodes, std::string config_file);
+
+    /*load the model with int8_nodes in int8 and build its net, config_file is written as scratch*/
+    std::shared_ptr<graph_type> build_graph(const std::set<std::string>& int8_nodes,
+                                            std::string config_file);
+
+    /*run the cached batches, op_time is the mean ms per batch of each exec func, may be null*/
+    void run(net_type& net, std::unordered_map<std::string, float>* op_time,
+             std::vector<std::vector<float>>& outputs);
+
+    /*read the validation set once through the inputs of net*/
+    void load_batches(net_type& net);
+
+    /**
+     *  \brief measure the net of int8_nodes, returns its error against the fp32 outputs.
+     *  the layouts of its edges are written to layout_file if it is not empty.
+     */
+    float evaluate(const std::set<std::string>& int8_nodes, std::string config_file,
+                   std::unordered_map<std::string, float>* op_time, std::string layout_file = "");
+
+    void write_layout(net_type& net, std::string layout_file);
+
+    std::string _model_path;
+    std::string _calibrator_file;
+    BatchStream<Ttype>* _batch_stream;
+    int _batch_size;
+
+    /*nodes of the loaded model and their op types, in execution order*/
+    std::vector<std::string> _node_names;
+    std::vector<std::string> _op_names;
+
+    /*host copies of the validation batches, one tensor per net input*/
+    std::vector<std::vector<std::shared_ptr<Tensor<X86>>>> _batches;
+    std::vector<std::vector<float>> _fp32_outputs;
+
+    std::unordered_map<std::string, float> _sensitivity;
+    std::unordered_map<std::string, float> _speedup;
+    std::set<std::string> _int8_nodes;
+};
+}
+#endif // USE_SGX
+
+#endif
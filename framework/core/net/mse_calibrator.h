@@ -0,0 +1,52 @@
+
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+   
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License. 
+*/
+
+#ifndef ANAKIN_MSE_CALIBRATOR_H
+#define ANAKIN_MSE_CALIBRATOR_H
+
+#include "anakin_config.h"
+
+#ifndef USE_SGX
+
+#include "framework/core/net/histogram_calibrator.h"
+
+namespace anakin {
+
+/** 
+ *  \brief calibrator that clips each tensor where the int8 reconstruction error is least.
+ */
+template<typename Ttype>
+class MseCalibrator: public HistogramCalibrator<Ttype> {
+public:
+    MseCalibrator(BatchStream<Ttype>* stream,
+              int batch_size,
+              std::string calibrator_file, 
+              Net<Ttype, Precision::FP32, OpRunType::SYNC>* net,
+              int bin_num):
+         HistogramCalibrator<Ttype>(stream, batch_size, calibrator_file, net, bin_num) {}
+
+    virtual CalibrationAlgoType get_algorithm() {return MSE;}
+
+protected:
+    virtual float get_clip_value(int tensor_id) {
+        return this->get_mse_clip(tensor_id);
+    }
+};
+}
+
+#endif // USE_SGX
+
+#endif
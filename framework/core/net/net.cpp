@@ -2,6 +2,11 @@
 #include "saber/funcs/debug.h"
 #include "framework/core/mem_info.h"
 #include "framework/core/net/auto_layout_config.h"
+#include <functional>
+#include <unordered_set>
+#ifdef USE_X86_PLACE
+#include "saber/funcs/impl/x86/kernel/jit_generator.h"
+#endif
 #ifdef ENABLE_OP_TIMER
 #include "saber/funcs/timer.h"
 #endif
@@ -96,7 +101,17 @@ load_calibrator_config(graph::Graph<Ttype, Ptype>& graph, bool load_layout_from_
         } else if (is_all_nchw) {
                     LOG(INFO) << "ready to config layout";
             AutoLayoutConfigHelper<Ttype, Ptype> helper;
-            helper.scane_dfs_from_input(graph);
+            bool support_c16 = false;
+#ifdef USE_X86_PLACE
+            support_c16 = saber::jit::mayiuse(saber::jit::avx512_common);
+#endif
+            helper.scane_region_layout(graph, support_c16);
+
+            if (!helper.insert_layout_trans(graph)) {
+                LOG(ERROR) << "insert layout trans failed, auto layout config cancel";
+                return;
+            }
+
             helper.print_layout();
 
             if (helper.check_merge(graph)) {
@@ -125,11 +140,12 @@ void Net<Ttype, Ptype, RunType>::init(graph::Graph<Ttype, Ptype>& graph, \
     init_env(graph);
     // shallow copy
     _graph_p->CopyFrom(graph);
-    auto node_names_in_exec_order = graph.get_nodes_in_order();
 
 #ifndef USE_SGX
-    load_calibrator_config(graph,!_has_loaded_layout_from_file,auto_config_layout);
+    load_calibrator_config(*_graph_p,!_has_loaded_layout_from_file,auto_config_layout);
 #endif
+    // the layout config may insert nodes into _graph_p
+    auto node_names_in_exec_order = _graph_p->get_nodes_in_order();
 
     // infer basic shape and parsing parameter from graph
     for (auto& node_name : node_names_in_exec_order) {
@@ -145,7 +161,7 @@ void Net<Ttype, Ptype, RunType>::init(graph::Graph<Ttype, Ptype>& graph, \
         node_ptr->set_op(op_pointer);
         op_pointer = nullptr;
 
-        static_cast<Operator<Ttype, Ptype>*>(node_ptr->Op())->_helper->BindParam(node_ptr);
+        static_cast<Operator<Ttype, Ptype>*>(node_ptr->Op())->_helper->BindParam(node_ptr, _graph_p);
         // parsing parameter
         static_cast<Operator<Ttype, Ptype>*>(node_ptr->Op())->_helper->InitParam();
     }
@@ -216,11 +232,11 @@ void Net<Ttype, Ptype, RunType>::init(graph::Graph<Ttype, Ptype>& graph,bool aut
 
     double curr_mem_in_mb_start = MemoryInfo<Ttype>::Global().get_used_mem_in_mb();
 
-    auto node_names_in_exec_order = graph.get_nodes_in_order();
-
 #ifndef USE_SGX
-    load_calibrator_config(graph,!_has_loaded_layout_from_file,auto_config_layout);
+    load_calibrator_config(*_graph_p,!_has_loaded_layout_from_file,auto_config_layout);
 #endif
+    // the layout config may insert nodes into _graph_p
+    auto node_names_in_exec_order = _graph_p->get_nodes_in_order();
 
     // infer basic shape and parsing parameter from graph
     for (auto& node_name : node_names_in_exec_order) {
@@ -278,7 +294,7 @@ void Net<Ttype, Ptype, RunType>::init(graph::Graph<Ttype, Ptype>& graph,bool aut
         }
         node_ptr->set_op(op_pointer);
         // bind parameter structure
-        static_cast<Operator<Ttype, Ptype>*>(node_ptr->Op())->_helper->BindParam(node_ptr);
+        static_cast<Operator<Ttype, Ptype>*>(node_ptr->Op())->_helper->BindParam(node_ptr, _graph_p);
         // parsing parameter
         static_cast<Operator<Ttype, Ptype>*>(node_ptr->Op())->_helper->InitParam();
     }
@@ -418,6 +434,8 @@ void Net<Ttype, Ptype, RunType>::prediction() {
 #ifdef ENABLE_DEBUG
     int op_cnt = 0;
 #endif
+    update_inplace_views();
+
     for (auto& executer : _exec_funcs) {
         if (RunType == OpRunType::SYNC || executer.need_sync || executer.op_name == "Output") {
             for (int i = 0; i < executer.ins.size(); i++) {
@@ -446,7 +464,10 @@ void Net<Ttype, Ptype, RunType>::prediction() {
 
         if (executer.op_name != "Input" && executer.op_name != "Output") {
             executer.infer_shape();
-            executer.launch();
+
+            if (executer.need_launch()) {
+                executer.launch();
+            }
         }
 
         for (int i = 0; i < executer.outs.size(); i++) {
@@ -518,10 +539,10 @@ void Net<Ttype, Ptype, RunType>::init() {
 
     double curr_mem_in_mb_start = MemoryInfo<Ttype>::Global().get_used_mem_in_mb();
 
-    auto node_names_in_exec_order = _graph_p->get_nodes_in_order();
-
     load_calibrator_config(*_graph_p,!_has_loaded_layout_from_file);
 
+    auto node_names_in_exec_order = _graph_p->get_nodes_in_order();
+
     // infer basic shape and parsing parameter from graph
     for (auto& node_name : node_names_in_exec_order) {
         auto node_ptr = (*_graph_p)[node_name];
@@ -535,7 +556,7 @@ void Net<Ttype, Ptype, RunType>::init() {
         }
         node_ptr->set_op(op_pointer);
         // bind parameter structure
-        static_cast<Operator<Ttype, Ptype>*>(node_ptr->Op())->_helper->BindParam(node_ptr);
+        static_cast<Operator<Ttype, Ptype>*>(node_ptr->Op())->_helper->BindParam(node_ptr, _graph_p);
         // parsing parameter
         static_cast<Operator<Ttype, Ptype>*>(node_ptr->Op())->_helper->InitParam();
     }
@@ -642,6 +663,8 @@ void Net<Ttype, Ptype, RunType>::execute_stop_at_node(std::string node_name) {
         }
     }
 
+    update_inplace_views();
+
     for (int i = 0; i < _suspended_point; i++) {
         auto& executer = _exec_funcs[i];
 
@@ -671,7 +694,10 @@ void Net<Ttype, Ptype, RunType>::execute_stop_at_node(std::string node_name) {
 
         if (executer.op_name != "Input") {
             executer.infer_shape();
-            executer.launch();
+
+            if (executer.need_launch()) {
+                executer.launch();
+            }
         }
 
         for (int i = 0; i < executer.outs.size(); i++) {
@@ -719,7 +745,10 @@ void Net<Ttype, Ptype, RunType>::execute_start_from_node(std::string node_name)
 
         if (executer.op_name != "Input") {
             executer.infer_shape();
-            executer.launch();
+
+            if (executer.need_launch()) {
+                executer.launch();
+            }
         }
 
         for (int i = 0; i < executer.outs.size(); i++) {
@@ -852,6 +881,13 @@ Status Net<Ttype, Ptype, RunType>::init_memory() {
     };
     _graph_p->Scanner->BFS_Edge(share_memory);
 
+    if (_inplace_concat) {
+        init_inplace_views();
+    }
+
+    // the folded outputs are computed in the buffers allocated above
+    init_const_folding();
+
     if (_need_summary) {
         size_t temp_mem_in_mbytes = 0;
         size_t ori_temp_mem_in_mbytes = 0;
@@ -880,6 +916,339 @@ Status Net<Ttype, Ptype, RunType>::init_memory() {
     return Status::OK();
 }
 
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+Status Net<Ttype, Ptype, RunType>::init_inplace_views() {
+    if (!std::is_same<Ttype, X86>::value) {
+        return Status::OK();
+    }
+
+    typedef typename graph::Graph<Ttype, Ptype>::Edge_it_t Edge_it;
+
+    // where a view starts in the buffer it lives in and the axis it is cut along
+    struct View {
+        char* data;
+        int axis;
+    };
+    std::unordered_map<Tensor4dPtr<Ttype>, View> views;
+
+    auto op_name = [this](const std::string & node_name) {
+        return (*_graph_p)[node_name]->get_op_name();
+    };
+    // ops whose outputs share the memory of their input
+    auto is_self_shared = [](const std::string & op) {
+        return op == "Split" || op == "Reshape" || op == "Gather" || op == "Flatten";
+    };
+    auto is_plain = [](Tensor4dPtr<Ttype> tensor) {
+        return tensor->dims() == 4 && tensor->get_layout() == Layout_NCHW
+               && tensor->get_dtype() == AK_FLOAT && tensor->shape() == tensor->valid_shape();
+    };
+    // a slice along axis is one contiguous block when all the outer dims are 1
+    auto is_contiguous = [](Tensor4dPtr<Ttype> tensor, int axis) {
+        return tensor->count_valid(0, axis) == 1;
+    };
+
+    // the tensor of the arc and the outputs of the Split ops reading it, they all hold the same data
+    std::function<bool(Edge_it&, std::vector<Tensor4dPtr<Ttype>>&)> collect_split_tree =
+    [&](Edge_it & arc, std::vector<Tensor4dPtr<Ttype>>& tensors) {
+        if (views.count(arc->weight().get()) > 0 || !is_plain(arc->weight().get())) {
+            return false;
+        }
+
+        tensors.push_back(arc->weight().get());
+        auto top_op = op_name(arc->top());
+
+        if (top_op == "Split") {
+            for (auto& out_arc : _graph_p->get_out_arc_its(arc->top())) {
+                if (!collect_split_tree(out_arc, tensors)) {
+                    return false;
+                }
+            }
+        } else if (is_self_shared(top_op)) {
+            return false;
+        }
+
+        return true;
+    };
+    // the tensors to turn into a view when the data of arc moves, up through Split ops
+    auto collect_source = [&](Edge_it arc, std::vector<Tensor4dPtr<Ttype>>& tensors) {
+        while (op_name(arc->bottom()) == "Split") {
+            auto& split_in_arcs = _graph_p->get_in_arc_its(arc->bottom());
+
+            if (split_in_arcs.size() != 1) {
+                return false;
+            }
+
+            arc = split_in_arcs[0];
+        }
+
+        auto bottom_op = op_name(arc->bottom());
+
+        // the folded outputs keep the buffers they are computed in
+        if (bottom_op == "Input" || is_self_shared(bottom_op) || (*_graph_p)[arc->bottom()]->is_const()) {
+            return false;
+        }
+
+        return collect_split_tree(arc, tensors);
+    };
+    // the ops sharing the memory of the arc follow its tensor to the new buffer
+    std::function<void(Edge_it&)> reshare_followers = [&](Edge_it & arc) {
+        if (!is_self_shared(op_name(arc->top()))) {
+            return;
+        }
+
+        for (auto& out_arc : _graph_p->get_out_arc_its(arc->top())) {
+            auto follower = out_arc->weight().get();
+            follower->set_shape(follower->valid_shape(), follower->valid_shape());
+            follower->share_from(*arc->weight().get());
+            reshare_followers(out_arc);
+        }
+    };
+    // give the tensor of arc a buffer of its own, the one from the memory scheduler may be
+    // reused by other tensors while the views are alive
+    auto detach = [&](Edge_it & arc) {
+        auto tensor = arc->weight().get();
+        Tensor4d<Ttype> buffer;
+        buffer.re_alloc(tensor->valid_shape(), tensor->get_dtype());
+        // the shape may have shrunk since the tensor got its last buffer
+        tensor->set_shape(tensor->valid_shape(), tensor->valid_shape());
+        tensor->share_from(buffer);
+        _inplace_tensors.insert(tensor);
+        reshare_followers(arc);
+    };
+    // the kernels read the tensors from the start of their buffers, so a view gets a
+    // buffer wrapping its part of the outer one
+    auto make_views = [&](std::vector<Tensor4dPtr<Ttype>>& tensors, const View & target, int offset) {
+        if (tensors.empty()) {
+            return;
+        }
+
+        auto first = tensors[0];
+        View view = target;
+        view.data += (size_t)offset * first->count_valid(target.axis + 1, first->dims())
+                     * first->get_dtype_size();
+        Tensor4d<Ttype> window((typename DataTraitBase<Ttype>::PtrDtype)view.data, Ttype(),
+                               first->device_id(), first->valid_shape(),
+                               first->get_dtype());
+
+        for (auto tensor : tensors) {
+            tensor->share_from(window);
+            views[tensor] = view;
+            _inplace_tensors.insert(tensor);
+        }
+    };
+
+    int view_count = 0;
+    auto& exec_order = _graph_p->get_nodes_in_order();
+
+    // the views cut for other shapes get buffers of their own before they are cut again,
+    // the Split trees follow their roots, the buffers are sized again at every shape change
+    if (!_inplace_tensors.empty()) {
+        std::unordered_set<Tensor4dPtr<Ttype>> old_tensors;
+        old_tensors.swap(_inplace_tensors);
+
+        for (auto& node_name : exec_order) {
+            if (is_self_shared(op_name(node_name))) {
+                continue;
+            }
+
+            for (auto& arc : _graph_p->get_out_arc_its(node_name)) {
+                if (old_tensors.count(arc->weight().get()) > 0) {
+                    detach(arc);
+                }
+            }
+        }
+    }
+
+    // consumers first, so a concat feeding another concat cuts its inputs out of the outer buffer
+    for (auto it = exec_order.rbegin(); it != exec_order.rend(); ++it) {
+        auto node = (*_graph_p)[*it];
+        auto& in_arcs = _graph_p->get_in_arc_its(*it);
+        auto& out_arcs = _graph_p->get_out_arc_its(*it);
+
+        if (node->get_op_name() == "Concat" && in_arcs.size() > 1 && out_arcs.size() == 1
+                && !node->is_const()) {
+            int axis = node->template get_attr<int>("axis");
+            auto output = out_arcs[0]->weight().get();
+
+            if (!is_plain(output) || !is_contiguous(output, axis)) {
+                continue;
+            }
+
+            View target{nullptr, axis};
+
+            if (views.count(output) > 0) {
+                target = views[output];
+
+                if (target.axis != axis) {
+                    continue;
+                }
+            }
+
+            std::vector<std::vector<Tensor4dPtr<Ttype>>> sources(in_arcs.size());
+            std::unordered_set<Tensor4dPtr<Ttype>> claimed;
+            bool has_source = false;
+
+            for (int i = 0; i < in_arcs.size(); ++i) {
+                if (!collect_source(in_arcs[i], sources[i])) {
+                    sources[i].clear();
+                }
+
+                for (auto tensor : sources[i]) {
+                    if (claimed.count(tensor) > 0) {
+                        // the same data is concatenated twice
+                        sources[i].clear();
+                        break;
+                    }
+                }
+
+                claimed.insert(sources[i].begin(), sources[i].end());
+
+                has_source = has_source || !sources[i].empty();
+            }
+
+            if (!has_source) {
+                continue;
+            }
+
+            if (views.count(output) == 0) {
+                detach(out_arcs[0]);
+                target.data = (char*)output->mutable_data();
+            }
+
+            int offset = 0;
+
+            for (int i = 0; i < in_arcs.size(); ++i) {
+                make_views(sources[i], target, offset);
+                view_count += sources[i].size();
+                offset += in_arcs[i]->weight().get()->valid_shape()[axis];
+            }
+        } else if (node->get_op_name() == "Slice" && in_arcs.size() == 1 && out_arcs.size() > 1
+                   && !node->is_const()) {
+            int axis = node->template get_attr<int>("axis");
+            auto input = in_arcs[0]->weight().get();
+            auto bottom_op = op_name(in_arcs[0]->bottom());
+
+            if (!is_plain(input) || !is_contiguous(input, axis) || views.count(input) > 0
+                    || bottom_op == "Input" || is_self_shared(bottom_op)) {
+                continue;
+            }
+
+            std::vector<std::vector<Tensor4dPtr<Ttype>>> slices(out_arcs.size());
+            bool has_slice = false;
+
+            for (int i = 0; i < out_arcs.size(); ++i) {
+                if (!collect_split_tree(out_arcs[i], slices[i])) {
+                    slices[i].clear();
+                }
+
+                has_slice = has_slice || !slices[i].empty();
+            }
+
+            if (!has_slice) {
+                continue;
+            }
+
+            detach(in_arcs[0]);
+            View target{(char*)input->mutable_data(), axis};
+            int offset = 0;
+
+            for (int i = 0; i < out_arcs.size(); ++i) {
+                make_views(slices[i], target, offset);
+                view_count += slices[i].size();
+                offset += out_arcs[i]->weight().get()->valid_shape()[axis];
+            }
+        }
+    }
+
+    _inplace_in_shapes.clear();
+
+    for (auto in : get_in_list()) {
+        _inplace_in_shapes.push_back(in->valid_shape());
+    }
+
+    LOG(INFO) << "inplace concat: " << view_count << " tensors are views of concat outputs or slice inputs";
+    return Status::OK();
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+void Net<Ttype, Ptype, RunType>::update_inplace_views() {
+    if (!_inplace_concat || !std::is_same<Ttype, X86>::value) {
+        return;
+    }
+
+    auto ins = get_in_list();
+    bool same_shape = ins.size() == _inplace_in_shapes.size();
+
+    for (int i = 0; same_shape && i < ins.size(); i++) {
+        same_shape = ins[i]->valid_shape() == _inplace_in_shapes[i];
+    }
+
+    if (same_shape) {
+        return;
+    }
+
+    // the views are cut for the shapes of the coming prediction
+    for (auto& executer : _exec_funcs) {
+        if (executer.op_name != "Input" && executer.op_name != "Output") {
+            executer.infer_shape();
+        }
+    }
+
+    init_inplace_views();
+}
+
+template<typename Ttype, Precision Ptype, OpRunType RunType>
+Status Net<Ttype, Ptype, RunType>::init_const_folding() {
+    int folded_count = 0;
+    // the folded ops reading each tensor, they run again after its folded producer
+    std::unordered_map<Tensor4dPtr<Ttype>, std::vector<OperatorFunc<Ttype, Ptype>*>> readers;
+
+    for (auto& executer : _exec_funcs) {
+        if ((*_graph_p)[executer.name]->is_const()) {
+            for (auto in : executer.ins) {
+                readers[in].push_back(&executer);
+            }
+        }
+    }
+
+    for (auto& executer : _exec_funcs) {
+        if (!(*_graph_p)[executer.name]->is_const()) {
+            continue;
+        }
+
+        executer.folded = true;
+        executer.folded_consumers.clear();
+
+        for (auto out : executer.outs) {
+            auto it = readers.find(out);
+
+            if (it != readers.end()) {
+                executer.folded_consumers.insert(executer.folded_consumers.end(),
+                                                 it->second.begin(), it->second.end());
+            }
+        }
+
+        executer.infer_shape();
+
+        if (executer.need_launch()) {
+            executer.launch();
+        }
+
+        for (auto out : executer.outs) {
+            out->record_event(executer.ctx_p->get_compute_stream());
+            out->sync();
+        }
+
+        folded_count++;
+    }
+
+    if (folded_count > 0) {
+        LOG(INFO) << "const folding: " << folded_count << " ops are computed once at init";
+    }
+
+    return Status::OK();
+}
+
 template<typename Ttype, Precision Ptype, OpRunType RunType>
 Status Net<Ttype, Ptype, RunType>::init_env(graph::Graph<Ttype, Ptype>& graph) {
     LOG(WARNING) << "Detect and initial " << graph.get_ins().size() << " lanes.";
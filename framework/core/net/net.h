@@ -21,12 +21,15 @@
 #include "framework/core/net/calibrator_factory.h"
 #include "framework/utils/csv.h"
 #include "saber/core/tensor_op.h"
+#include <unordered_set>
 
 namespace anakin {
 
 #ifndef USE_SGX
 template<typename Ttype>
 class Calibrator;
+template<typename Ttype>
+class MixedPrecisionPlanner;
 #endif
 
 /**
@@ -71,6 +74,18 @@ public:
      */
     void init();
 
+    /**
+     * \brief let the producers of Concat inputs write straight into the concat output and
+     *  let Slice outputs alias their input, where the slices are contiguous (X86 only).
+     *  the concat and slice kernels skip the copies of the inputs already in place.
+     *  the views are cut again when the input shapes change, a concat or slice which is
+     *  no longer contiguous (e.g. num > 1) copies its data.
+     *  note: call it before init, the views take extra unshared buffers for the
+     *  concat outputs and slice inputs.
+     */
+    void set_inplace_concat(bool inplace) {
+        _inplace_concat = inplace;
+    }
 
     /**
      * \brief do inference.
@@ -257,6 +272,7 @@ public:
     }
 
     friend class Calibrator<Ttype>;
+    friend class MixedPrecisionPlanner<Ttype>;
 #endif
 
 public:
@@ -275,6 +291,22 @@ private:
      */
     Status init_memory();
 
+    /**
+     *  \brief Turn the inputs of Concat and the outputs of Slice into views, see set_inplace_concat.
+     */
+    Status init_inplace_views();
+
+    /**
+     *  \brief Cut the views again when the input shapes differ from the ones they are cut for.
+     */
+    void update_inplace_views();
+
+    /**
+     *  \brief Compute the constant ops marked by the graph optimizer, they are skipped
+     *         in prediction until the shapes of their inputs change.
+     */
+    Status init_const_folding();
+
     /**
      *  \brief Initial context environments.
      */
@@ -303,6 +335,12 @@ private:
     std::vector<std::string > _tensor_name_list;
 
     bool _need_summary{false};
+    ///< _inplace_concat: concat inputs and slice outputs are views of one buffer
+    bool _inplace_concat{false};
+    ///< _inplace_tensors: the views and the tensors given a buffer of their own for them
+    std::unordered_set<Tensor4dPtr<Ttype> > _inplace_tensors;
+    ///< _inplace_in_shapes: shapes of the net inputs the views are cut for
+    std::vector<saber::Shape> _inplace_in_shapes;
 
 #ifdef ENABLE_OP_TIMER
     std::vector<float> _op_time;
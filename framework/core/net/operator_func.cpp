@@ -12,6 +12,37 @@ void OperatorFunc<Ttype, Ptype>::infer_shape() {
     op->_helper->InferShape(ins, outs);
 }
 
+template<typename Ttype, Precision Ptype>
+bool OperatorFunc<Ttype, Ptype>::need_launch() {
+    if (!folded) {
+        return true;
+    }
+
+    bool same_shape = folded_shapes.size() == ins.size();
+
+    for (int i = 0; same_shape && i < ins.size(); i++) {
+        same_shape = ins[i]->valid_shape() == folded_shapes[i];
+    }
+
+    if (same_shape && !folded_dirty) {
+        return false;
+    }
+
+    folded_dirty = false;
+    folded_shapes.clear();
+
+    for (auto in : ins) {
+        folded_shapes.push_back(in->valid_shape());
+    }
+
+    // e.g. a PriorBox whose image changed size refreshes the concat of the priors
+    for (auto consumer : folded_consumers) {
+        consumer->folded_dirty = true;
+    }
+
+    return true;
+}
+
 #ifdef USE_CUDA
 template class OperatorFunc<NV, Precision::FP32>;
 template class OperatorFunc<NV, Precision::FP16>;
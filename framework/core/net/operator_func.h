@@ -37,6 +37,13 @@ struct OperatorFunc {
      *  \brief Infer shape.
      */
     void infer_shape();
+
+    /** 
+     *  \brief Whether the operator needs to run, a folded operator only runs
+     *         again when the shapes of its inputs changed since its last run
+     *         or a folded producer of its inputs runs again.
+     */
+    bool need_launch();
     
     ///< op running context.
     OpContextPtr<Ttype> ctx_p;
@@ -60,6 +67,18 @@ struct OperatorFunc {
 
     bool need_sync{false};
 
+    ///< the outputs are constant, see Net::init_const_folding
+    bool folded{false};
+
+    ///< the input shapes of the last run of a folded operator
+    std::vector<saber::Shape> folded_shapes;
+
+    ///< the folded operators reading the outputs of a folded operator, they run after it
+    std::vector<OperatorFunc<Ttype, Ptype>*> folded_consumers;
+
+    ///< a folded producer ran again, the outputs are stale whatever the input shapes
+    bool folded_dirty{false};
+
     Operator<Ttype, Ptype>* op;
 
     ///< node name
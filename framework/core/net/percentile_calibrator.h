@@ -0,0 +1,65 @@
+
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+   
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License. 
+*/
+
+#ifndef ANAKIN_PERCENTILE_CALIBRATOR_H
+#define ANAKIN_PERCENTILE_CALIBRATOR_H
+
+#include "anakin_config.h"
+
+#ifndef USE_SGX
+
+#include "framework/core/net/histogram_calibrator.h"
+
+namespace anakin {
+
+/** 
+ *  \brief calibrator that clips each tensor at a percentile of |x|, e.g. 99.99.
+ *  a percentile of 100 clips at the max, which is the MAXABS algorithm.
+ */
+template<typename Ttype>
+class PercentileCalibrator: public HistogramCalibrator<Ttype> {
+public:
+    PercentileCalibrator(BatchStream<Ttype>* stream,
+              int batch_size,
+              std::string calibrator_file, 
+              Net<Ttype, Precision::FP32, OpRunType::SYNC>* net,
+              int bin_num,
+              float percentile = 99.99f):
+         HistogramCalibrator<Ttype>(stream, batch_size, calibrator_file, net, bin_num),
+         _percentile(percentile) {
+        CHECK(percentile > 0.f && percentile <= 100.f) << "percentile should be in (0, 100], but is "
+                << percentile;
+    }
+
+    virtual CalibrationAlgoType get_algorithm() {
+        return _percentile >= 100.f ? MAXABS : PERCENTILE;
+    }
+
+protected:
+    virtual float get_clip_value(int tensor_id) {
+        if (_percentile >= 100.f) {
+            return this->_max_vec[tensor_id];
+        }
+        return this->get_percentile_clip(tensor_id, _percentile);
+    }
+
+    float _percentile;
+};
+}
+
+#endif // USE_SGX
+
+#endif
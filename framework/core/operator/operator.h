@@ -102,13 +102,15 @@ public:
 
     /** 
      *  \brief Bind parameter pack from graph.
+     *  \param weights_owner the graph which releases the weights blocks the op creates in InitParam.
      */
-    void BindParam(graph::NodePtr& node_p) { 
+    void BindParam(graph::NodePtr& node_p, const void* weights_owner = nullptr) { 
         // Shareptr shallow copy
         // Note: We can also use deep copy by using node operator=, 
         //       but if change the node attrs through net class, 
         //       the base graph can't detect it.
         _node_p = node_p.get();
+        _weights_owner = weights_owner;
 	}
 
     /** 
@@ -143,6 +145,15 @@ public:
 		return _node_p->inspect_attr(attr_name);
 	}
 
+    /**
+     *  \brief Judge if target attr holds a value of type T
+     */
+    template<typename T>
+    inline bool check_attr_type(const std::string& attr_name) {
+        return _node_p->inspect_attr(attr_name)
+               && _node_p->attr().get(attr_name).type() == type_id<T>().type_info();
+    }
+
     /**
      * \brief remove attr if it exists
      */
@@ -150,6 +161,10 @@ public:
         _node_p->remove_attr(attr_name);
     }
 
+protected:
+    ///< Owner of the weights blocks created by the op, the graph of the net.
+    const void* _weights_owner{nullptr};
+
 private:
     ///< Pointer to graph node.
     graph::Node* _node_p;
@@ -184,6 +199,12 @@ private:
 #define CHECK_PARAMETER(name) \
     this->check_attr(#name)
 
+/**
+ *  \brief Call check_attr_type from derived class.
+ */
+#define CHECK_PARAMETER_TYPE(type, name) \
+    this->template check_attr_type<type>(#name)
+
 /**
  *  \brief Call remove_attr from derived class.
  */
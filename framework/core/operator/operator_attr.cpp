@@ -68,6 +68,13 @@ OpAttrWarpper& OpAttrWarpper::num_in(size_t num) {
     return *this;
 }
 
+OpAttrWarpper& OpAttrWarpper::num_in(size_t min_num, size_t max_num) {
+    CHECK_LE(min_num, max_num) << " the least num input is above the num input of " << opAttr_.name;
+    opAttr_.num_in = max_num;
+    opAttr_.min_num_in = min_num;
+    return *this;
+}
+
 OpAttrWarpper& OpAttrWarpper::num_out(size_t num) {
     opAttr_.num_out = num;
     return *this;
@@ -40,6 +40,7 @@ public:
     std::string name; ///< operator name. 
     std::string doc;  ///< operator doc.
     size_t num_in;    ///< io number of operator.
+    size_t min_num_in{0}; ///< inputs an op can't run without, 0 if all the num_in are needed.
     size_t num_out;
 
     bool is_commutative{true}; ///< true default.
@@ -68,6 +69,8 @@ public:
     OpAttrWarpper& Doc(const std::string&);
     /// set and get number input and output.
     OpAttrWarpper& num_in(size_t);
+    /// set the range of inputs for an op with optional inputs.
+    OpAttrWarpper& num_in(size_t min_num, size_t max_num);
     OpAttrWarpper& num_out(size_t);
     /// set commutative.
     OpAttrWarpper& commutative(bool);
@@ -119,6 +122,8 @@ public:
     
     /// Get num input.
     size_t num_in() { return opAttr_.num_in; }
+    /// Get the least num input.
+    size_t min_num_in() { return opAttr_.min_num_in ? opAttr_.min_num_in : opAttr_.num_in; }
     /** 
      *  \brief Get num output.
      */
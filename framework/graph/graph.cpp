@@ -4,6 +4,7 @@
 #include "framework/graph/llvm/optimizer/conv_elewise_fusion_scheduler.h"
 #include "framework/graph/llvm/optimizer/parall_scheduler.h"
 #include "framework/graph/llvm/optimizer/memory_scheduler.h"
+#include "framework/graph/llvm/optimizer/const_fold_scheduler.h"
 #include "framework/graph/llvm/fusion/graph_pattern.h"
 #include "framework/core/operator/operator.h"
 
@@ -114,6 +115,18 @@ Status Graph<Ttype, Ptype>::SetOpPrec(const std::string& name, DataType dtype) {
     return Status::ANAKINFAIL("[EEROR]: SetOpPrec is called on an unknown op name");
 }
 
+template<typename Ttype, Precision Ptype>
+Status Graph<Ttype, Ptype>::SetWeightsDtype(DataType dtype) {
+    if (dtype != AK_FLOAT && dtype != AK_HALF && dtype != AK_BFLOAT16) {
+        return Status::ANAKINFAIL("[EEROR]: SetWeightsDtype only takes AK_FLOAT, AK_HALF or AK_BFLOAT16");
+    }
+    if (dtype != AK_FLOAT && !std::is_same<Ttype, X86>::value) {
+        return Status::ANAKINFAIL("[EEROR]: half weights storage is only supported on X86");
+    }
+    _weights_dtype = dtype;
+    return Status::OK();
+}
+
 template<typename Ttype, Precision Ptype>
 Status Graph<Ttype, Ptype>::SetWeightsScale(const std::string& name, const std::vector<float>& scales, bool is_bias) {
     if(this->has_vertex(name)) {
@@ -206,6 +219,61 @@ Status Graph<Ttype, Ptype>::RegistVar(const std::string& var) {
     return Status::OK();
 }
 
+template<typename Ttype, Precision Ptype>
+Status Graph<Ttype, Ptype>::InsertOp(const std::string& name, const std::string& type,
+                                     const std::string& node_bottom_name,
+                                     const std::string& node_top_name) {
+    if (this->has_vertex(name)) {
+        return Status::ANAKINFAIL("[EEROR]: InsertOp is called with an existing op name");
+    }
+    if (!this->has_vertex(node_bottom_name) || !this->has_vertex(node_top_name)) {
+        return Status::ANAKINFAIL("[EEROR]: InsertOp is called on an unknown arc");
+    }
+    auto& top_in_arcs = this->get_in_arc_its(node_top_name);
+    int index_of_in_arc = -1;
+    for (int i = 0; i < top_in_arcs.size(); i++) {
+        if (top_in_arcs[i]->bottom() == node_bottom_name) {
+            index_of_in_arc = i;
+            break;
+        }
+    }
+    if (index_of_in_arc < 0) {
+        return Status::ANAKINFAIL("[EEROR]: InsertOp is called on an unknown arc");
+    }
+    auto arc_it = top_in_arcs[index_of_in_arc];
+    auto old_arc_name = arc_it->name();
+
+    NodePtr node_p = std::make_shared<Node>();
+    node_p->set_name(name);
+    node_p->get_op_name() = type;
+    node_p->lane() = (*this)[node_top_name]->lane();
+    this->add_vertex(name, node_p);
+
+    // the arc object is referenced by the out arcs of bottom, retarget it to the new node
+    arc_it->top() = name;
+    this->get_in_arc_its(name).push_back(arc_it);
+
+    Edge<Ttype> edge(name, node_top_name);
+    edge.weight() = std::make_shared<Tensor4d<Ttype> >();
+    edge.lane() = arc_it->lane();
+    this->add_out_arc(edge);
+    // the new arc takes the old one's index, multi input ops rely on the order of in arcs
+    this->get_in_arc_its(node_top_name)[index_of_in_arc] = this->get_out_arc_its(name).back();
+
+    // memory share info is keyed by arc name
+    auto new_arc_name = arc_it->name();
+    auto rename_share_from = [&](Edge<Ttype>& arc) {
+        if (arc.shared() && arc.share_from() == old_arc_name) {
+            arc.share_from() = new_arc_name;
+        }
+    };
+    this->Scanner->BFS_Edge(rename_share_from);
+
+    auto it = std::find(_nodes_exec_order.begin(), _nodes_exec_order.end(), node_top_name);
+    _nodes_exec_order.insert(it, name);
+    return Status::OK();
+}
+
 template<typename Ttype, Precision Ptype>
 Status Graph<Ttype, Ptype>::Freeze() {
     std::unordered_map<std::string, std::vector<std::string> > in_to_op_map;
@@ -390,6 +458,15 @@ Status Graph<Ttype, Ptype>::Optimize(bool with_fusion) EXCLUSIVE_LOCKS_REQUIRED(
                         (fusion_name == "ConvReluPool" || fusion_name == "ConvBatchnormScaleReluPool")) {
                         continue;
                     }
+                    // the dense, matmul and scale chain fusion ops only exist on x86 fp32
+                    if (!(std::is_same<Ttype, X86>::value && Precision::FP32 == Ptype) &&
+                        (fusion_name == "DenseBatchnormScale" || fusion_name == "DenseBatchnorm"
+                         || fusion_name == "DenseScale" || fusion_name == "DenseAffineChannel"
+                         || fusion_name == "DenseRelu" || fusion_name == "DenseActivation"
+                         || fusion_name == "MatMulScale" || fusion_name == "MatMulPower"
+                         || fusion_name == "ScaleScale" || fusion_name == "PowerScale")) {
+                        continue;
+                    }
                     DLOG(INFO) << " processing in-ordered fusion : " << fusion_name;
                     _vgraph->Match(FusionOpRegister::Global()[fusion_name]);
 
@@ -427,6 +504,12 @@ Status Graph<Ttype, Ptype>::Optimize(bool with_fusion) EXCLUSIVE_LOCKS_REQUIRED(
             ParallScheduler para_scheduler;
             para_scheduler.RegIOResource(_vgraph);
             para_scheduler.Run();
+            // constant outputs are computed once by the net, so they must keep their memory
+            if (std::is_same<Ttype, X86>::value) {
+                ConstFoldScheduler const_fold_scheduler;
+                const_fold_scheduler.RegIOResource(_vgraph);
+                const_fold_scheduler.Run();
+            }
             MemoryScheduler mem_scheduler;
             mem_scheduler.RegIOResource(_vgraph);
             mem_scheduler.Run();
@@ -652,6 +735,8 @@ Status Graph<Ttype, Ptype>::restore_from_vgraph(VGraph* vgraph) {
 
             auto& need_wait = node_p->need_wait();
             need_wait = target_node.need_wait;
+            auto& is_const = node_p->is_const();
+            is_const = target_node.is_const;
             auto& lane = node_p->lane();
             lane = target_node.lane;
             auto& op_name = node_p->get_op_name();
@@ -816,8 +901,8 @@ Status Graph<Ttype, Ptype>::Clean() {
     // delete _vgraph pointer
     delete _vgraph;
     _vgraph = nullptr;
-    // clenn all weights
-    graph::GraphGlobalMem<Ttype>::Global().clean_all();
+    // release the weights of this graph, weights shared with other graphs stay until they release them
+    graph::GraphGlobalMem<Ttype>::Global().release(this);
 
     return Status::OK();
 }
@@ -54,6 +54,8 @@ public:
             delete _vgraph;
             _vgraph = nullptr;
         }
+        // drop the weights blocks loaded for this graph
+        GraphGlobalMem<Ttype>::Global().release(this);
     }
 
     /// get graph name
@@ -113,6 +115,15 @@ public:
      */
     Status SetOpPrec(const std::string& name, DataType dtype);
     
+    /**
+     * \brief store the weights of Dense, Lstm, Gru and Embedding ops as AK_HALF or AK_BFLOAT16,
+     *  they are converted while the model is parsed and expanded to fp32 inside the gemms.
+     *
+     *  note: X86 only, call it before load
+     */
+    Status SetWeightsDtype(DataType dtype);
+    DataType weights_dtype() { return _weights_dtype; }
+
     /**
      * \brief set operation's weights scale factor manually
      */
@@ -137,6 +148,16 @@ public:
      */
     Status RegistVar(const std::string& var);
 
+    /**
+     * \brief insert an operation without parameters on the arc node_bottom_name --> node_top_name
+     *
+     * note: the new node takes the arc's place in the in arcs of node_top_name and runs right
+     *       before it, the arc from node_bottom_name keeps its tensor and memory share info.
+     *       this api is used on optimized graph, e.g. by the auto layout pass
+     */
+    Status InsertOp(const std::string& name, const std::string& type,
+                    const std::string& node_bottom_name, const std::string& node_top_name);
+
 public:
     /**
      * \brief register out
@@ -205,6 +226,9 @@ private:
     ///< _pattern_name_merges map: target node map to all its fusion pattern node
     std::unordered_map<std::string, std::vector<std::string> > _pattern_name_merges;
 
+    ///< _weights_dtype: storage type of the op weights converted at load
+    DataType _weights_dtype{AK_FLOAT};
+
     ///< _registed_outs:outs that needs to be exported
     std::vector<std::pair<std::string, std::string>> _registed_outs;
 
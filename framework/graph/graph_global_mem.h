@@ -17,7 +17,12 @@
 #define ANAKIN_GRAPH_GLOBAL_MEM_H
 
 #include <vector>
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
 #include "framework/core/singleton.h"
+#include "framework/core/data_types.h"
 #include "framework/core/parameter.h"
 #include "utils/logger/logger.h"
 #include <mutex>
@@ -75,6 +80,34 @@ struct GlobalResRestrain : public LevelStage<levels> ... {
     }
 };
 
+/**
+* \brief hash of the host data and the layout of a weights block, used to find equal blocks
+*/
+template<typename Ttype>
+size_t weights_block_hash(PBlock<Ttype>& block) {
+    auto& tensor = block.h_tensor();
+    size_t hash = std::hash<int>()(tensor.get_dtype());
+    auto combine = [&hash](uint64_t val) {
+        hash ^= val + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+    };
+    for (int i = 0; i < tensor.shape().size(); i++) {
+        combine(tensor.shape()[i]);
+        combine(tensor.valid_shape()[i]);
+    }
+    size_t bytes = tensor.shape().count() * type_length(tensor.get_dtype());
+    const char* data = static_cast<const char*>(tensor.data());
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= bytes; i += sizeof(uint64_t)) {
+        uint64_t val;
+        memcpy(&val, data + i, sizeof(uint64_t));
+        combine(val);
+    }
+    for (; i < bytes; i++) {
+        combine(static_cast<unsigned char>(data[i]));
+    }
+    return hash;
+}
+
 /**
 * \brief GraphGlobalMemBase class
 */
@@ -94,17 +127,81 @@ public:
 
     ~GraphGlobalMemBase() {}
 
-    /// create Block memory
+    /// create Block memory, owner (the graph loading it) releases the block with release()
     template<DataType Dtype>
-    PBlock<Ttype> *new_block(saber::Shape &shape) EXCLUSIVE_LOCKS_REQUIRED(_mut) {
+    PBlock<Ttype> *new_block(saber::Shape &shape, const void* owner = nullptr) EXCLUSIVE_LOCKS_REQUIRED(_mut) {
         std::unique_lock<std::mutex> lock(this->_mut);
         PBlock<Ttype> *block_p = new PBlock<Ttype>(shape, Dtype);
         // register new block_p for resource guard
         _res_guard[block_p->d_tensor().data()].reset(new LevelList());
         _push_mem_pool(block_p, DataTypeWarpper<Dtype>());
+        if (owner != nullptr) {
+            _block_owners[block_p] = owner;
+        }
         return block_p;
     }
 
+    /// enable or disable dedup_block, enabled by default
+    void set_dedup(bool dedup) EXCLUSIVE_LOCKS_REQUIRED(_mut) {
+        std::unique_lock<std::mutex> lock(this->_mut);
+        _dedup = dedup;
+    }
+
+    /// let block_p share the buffers of an earlier block with the same dtype, shapes and host data.
+    /// the buffer is referenced by owner until release(owner), apply() gives a block a private
+    /// copy of a shared buffer before changing it.
+    /// return true if block_p now shares the buffers of an earlier block
+    bool dedup_block(PBlock<Ttype> *block_p, const void* owner) EXCLUSIVE_LOCKS_REQUIRED(_mut) {
+        std::unique_lock<std::mutex> lock(this->_mut);
+        if (!_dedup || block_p->h_tensor().data() == nullptr) {
+            return false;
+        }
+        size_t hash = weights_block_hash(*block_p);
+        auto range = _dedup_index.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (!_same_block(it->second.h_tensor, block_p->h_tensor())) {
+                continue;
+            }
+            void *old_key = block_p->d_tensor().data();
+            block_p->h_tensor() = it->second.h_tensor;
+            if (!block_p->host_only()) {
+                block_p->d_tensor() = it->second.d_tensor;
+            }
+            _res_guard.erase(old_key);
+            _dedup_refs[it->second.d_tensor.data()].owners.push_back(owner);
+            if (!block_p->host_only()) {
+                _dedup_refs[it->second.h_tensor.data()].owners.push_back(owner);
+            }
+            return true;
+        }
+        _dedup_index.emplace(hash, DedupEntry{block_p->h_tensor(), block_p->d_tensor()});
+        _dedup_refs[block_p->d_tensor().data()] = DedupRef{hash, true, {owner}};
+        if (!block_p->host_only()) {
+            // host copy of a device block, it is detached together with the device buffer
+            _dedup_refs[block_p->h_tensor().data()] = DedupRef{hash, false, {owner}};
+        }
+        return false;
+    }
+
+    /// release the blocks created and the buffers shared for owner,
+    /// a shared buffer leaves the dedup index when its last owner releases it
+    void release(const void* owner) EXCLUSIVE_LOCKS_REQUIRED(_mut) {
+        std::unique_lock<std::mutex> lock(this->_mut);
+        for (auto it = _dedup_refs.begin(); it != _dedup_refs.end();) {
+            auto& owners = it->second.owners;
+            owners.erase(std::remove(owners.begin(), owners.end(), owner), owners.end());
+            if (owners.empty()) {
+                _unindex(it->first, it->second);
+                it = _dedup_refs.erase(it);
+            } else {
+                ++it;
+            }
+        }
+        _release_pool(_int8_mem_pool, owner);
+        _release_pool(_fp16_mem_pool, owner);
+        _release_pool(_fp32_mem_pool, owner);
+    }
+
     /// register external block
     void register_block(PBlock<Ttype> * block_p) EXCLUSIVE_LOCKS_REQUIRED(_mut) {
         std::unique_lock<std::mutex> lock(this->_mut);
@@ -119,6 +216,8 @@ public:
     template<Level L, typename functor, typename ...ParamTypes>
     void apply(functor func, PBlock<Ttype> tensor_1, PBlock<Ttype> tensor_2, ParamTypes &&...args) {
         std::unique_lock<std::mutex> lock(this->_mut);
+        _detach(tensor_1);
+        _detach(tensor_2);
         void *key_1 = tensor_1.d_tensor().data();
         void *key_2 = tensor_2.d_tensor().data();
         if (_res_guard[key_1]->template check_access<L>() && _res_guard[key_2]->template check_access<L>()) {
@@ -152,12 +251,13 @@ public:
     template<Level L, typename functor, typename ...ParamTypes>
     void apply(functor func, PBlock<Ttype> tensor, ParamTypes &&...args) {
         std::unique_lock<std::mutex> lock(this->_mut);
+        _detach(tensor);
         void *key = tensor.d_tensor().data();
         if (_res_guard[key]->template check_access<L>()) {
             std::unique_lock<std::mutex> lock(_res_guard[key]->template get_mut<L>());
             _res_guard[key]->template use<L>();
             func(tensor, std::forward<ParamTypes>(args)...);
-            void *new_key = tensor.data();
+            void *new_key = tensor.d_tensor().data();
             if (new_key != key) {
                 _res_guard.emplace(new_key, make_lock()).first->second.swap(_res_guard[key]);
                 if (key && _res_guard.erase(key) != 1) { // delete old key-vale
@@ -173,6 +273,7 @@ public:
     template<Level L, typename functor, typename ...ParamTypes>
     void apply(functor func, Tensor4d<Ttype> &tensor, ParamTypes &&...args) {
         std::unique_lock<std::mutex> lock(this->_mut);
+        _detach(tensor);
         void *key = tensor.data();
         if (_res_guard[key]->template check_access<L>()) {
             std::unique_lock<std::mutex> lock(_res_guard[key]->template get_mut<L>());
@@ -194,6 +295,8 @@ public:
     template<Level L, typename functor, typename ...ParamTypes>
     void apply(functor func, Tensor4d<Ttype> &tensor1, Tensor4d<Ttype> &tensor2, ParamTypes &&...args) {
         std::unique_lock<std::mutex> lock(this->_mut);
+        _detach(tensor1);
+        _detach(tensor2);
         void *key1 = tensor1.data();
         void *key2 = tensor2.data();
         if(_res_guard.count(key1) > 0 && _res_guard.count(key2) > 0) {
@@ -226,18 +329,25 @@ public:
         }
     }
 
-    /// get sum size in m-btyes
+    /// get sum size in m-btyes, buffers shared by dedup_block are counted once
     size_t get_sum_mbyte() EXCLUSIVE_LOCKS_REQUIRED(_mut) {
         std::unique_lock<std::mutex> lock(this->_mut);
+        std::unordered_set<const void*> counted;
         size_t sum = 0;
         for (auto block_p : _int8_mem_pool) {
-            sum += block_p->count();
+            if (counted.insert(block_p->h_tensor().data()).second) {
+                sum += block_p->count();
+            }
         }
         for (auto block_p : _fp16_mem_pool) {
-            sum += block_p->count() * 2;
+            if (counted.insert(block_p->h_tensor().data()).second) {
+                sum += block_p->count() * 2;
+            }
         }
         for (auto block_p : _fp32_mem_pool) {
-            sum += block_p->count() * 4;
+            if (counted.insert(block_p->h_tensor().data()).second) {
+                sum += block_p->count() * 4;
+            }
         }
         return sum / 1e6;
     }
@@ -257,6 +367,9 @@ public:
             delete block_p;
         }
         _fp32_mem_pool.clear();
+        _block_owners.clear();
+        _dedup_index.clear();
+        _dedup_refs.clear();
     }
 
     /// get pool size
@@ -264,6 +377,94 @@ public:
     size_t get_pool_size() { return _get_pool_size(DataTypeWarpper<Dtype>()); }
 
 private:
+    /// owners of a buffer shared by dedup_block, one entry for each block sharing it
+    struct DedupRef {
+        size_t hash;
+        bool indexed;       ///< the buffer still holds the loaded data and can be shared
+        std::vector<const void*> owners;
+    };
+
+    /// buffers of an indexed block, held by tensors of their own: the tensors of the
+    /// loading block are replaced when it is detached, these keep the loaded data
+    struct DedupEntry {
+        Tensor4d<Ttype> h_tensor;
+        Tensor4d<Ttype> d_tensor;
+    };
+
+    bool _same_block(Tensor4d<Ttype>& lt, Tensor4d<Ttype>& rt) {
+        if (lt.get_dtype() != rt.get_dtype() || !(lt.shape() == rt.shape())
+                || !(lt.valid_shape() == rt.valid_shape()) || lt.get_scale() != rt.get_scale()
+                || lt.data() == rt.data()) {
+            return false;
+        }
+        size_t bytes = lt.shape().count() * type_length(lt.get_dtype());
+        return memcmp(lt.data(), rt.data(), bytes) == 0;
+    }
+
+    /// remove the buffer at key from the index, blocks loaded later won't share it
+    void _unindex(void* key, DedupRef& ref) {
+        if (!ref.indexed) {
+            return;
+        }
+        auto range = _dedup_index.equal_range(ref.hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second.d_tensor.data() == key) {
+                _dedup_index.erase(it);
+                break;
+            }
+        }
+        ref.indexed = false;
+    }
+
+    /// copy on write: tensor is about to be changed in place,
+    /// a buffer shared by dedup_block is replaced by a private copy
+    void _detach(Tensor4d<Ttype> &tensor) {
+        void *key = tensor.data();
+        auto it = _dedup_refs.find(key);
+        if (key == nullptr || it == _dedup_refs.end()) {
+            return;
+        }
+        if (it->second.owners.size() <= 1) {
+            // the last block using it, blocks loaded later can't share it any more
+            _unindex(key, it->second);
+        }
+        if (!tensor.is_buffer_shared()) {
+            // changed in place
+            return;
+        }
+        Shape valid_shape = tensor.valid_shape();
+        Shape real_shape = tensor.shape();
+        Tensor4d<Ttype> private_tensor;
+        private_tensor.re_alloc(real_shape, tensor.get_dtype());
+        private_tensor.set_scale(tensor.get_scale());
+        tensor.set_shape(real_shape);
+        private_tensor.copy_from(tensor);
+        tensor = private_tensor;
+        tensor.set_shape(valid_shape);
+        _res_guard[tensor.data()].reset(new LevelList());
+    }
+
+    void _detach(PBlock<Ttype> &block) {
+        _detach(block.d_tensor());
+        if (!block.host_only()) {
+            _detach(block.h_tensor());
+        }
+    }
+
+    /// delete the pool blocks created for owner
+    void _release_pool(std::vector<PBlock<Ttype> *> &pool, const void* owner) {
+        auto owned = [&](PBlock<Ttype>* block_p) {
+            auto it = _block_owners.find(block_p);
+            if (it == _block_owners.end() || it->second != owner) {
+                return false;
+            }
+            _block_owners.erase(it);
+            delete block_p;
+            return true;
+        };
+        pool.erase(std::remove_if(pool.begin(), pool.end(), owned), pool.end());
+    }
+
     /// push int8_mem operaiton
     void _push_mem_pool(PBlock<Ttype> *block_p, DataTypeWarpper<AK_INT8>) {
         _int8_mem_pool.push_back(block_p);
@@ -274,6 +475,11 @@ private:
         _fp16_mem_pool.push_back(block_p);
     }
 
+    /// push bf16_mem operaiton, bf16 blocks share the 16 bit pool
+    void _push_mem_pool(PBlock<Ttype> *block_p, DataTypeWarpper<AK_BFLOAT16>) {
+        _fp16_mem_pool.push_back(block_p);
+    }
+
     /// push fp32_mem operaiton
     void _push_mem_pool(PBlock<Ttype> *block_p, DataTypeWarpper<AK_FLOAT>) {
         _fp32_mem_pool.push_back(block_p);
@@ -298,10 +504,18 @@ private:
     std::unordered_map<void *, std::unique_ptr<LevelList>> _res_guard;
     ///< _int8_mem_pool stand for int8 type memory
     std::vector<PBlock<Ttype> *> _int8_mem_pool GUARDED_BY(_mut);
-    ///< _fp16_mem_pool stand for fp16 type memory
+    ///< _fp16_mem_pool stand for fp16 and bf16 type memory
     std::vector<PBlock<Ttype> *> _fp16_mem_pool GUARDED_BY(_mut);
     ///< _fp32_mem_pool stand for fp32 type memory
     std::vector<PBlock<Ttype> *> _fp32_mem_pool GUARDED_BY(_mut);
+    ///< _block_owners stand for the graph each pool block is created for
+    std::unordered_map<PBlock<Ttype> *, const void*> _block_owners GUARDED_BY(_mut);
+    ///< _dedup_index stand for the blocks which can be shared, keyed by weights_block_hash
+    std::unordered_multimap<size_t, DedupEntry> _dedup_index GUARDED_BY(_mut);
+    ///< _dedup_refs stand for the owners of the buffers registered by dedup_block
+    std::unordered_map<void *, DedupRef> _dedup_refs GUARDED_BY(_mut);
+    ///< _dedup
+    bool _dedup{true};
     ///< _mut
     std::mutex _mut;
 };
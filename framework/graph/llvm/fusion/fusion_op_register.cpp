@@ -154,6 +154,78 @@ REGISTER_GRAPH_FUSION_PATTERN(ConvAffineChannelRelu)
 .AddConnect("affine_channel_0", "relu_0")
 .CreatePattern([](VGraph* graph) {});
 
+REGISTER_GRAPH_FUSION_PATTERN(DenseBatchnormScale)
+.Type(IN_ORDER)
+.AddOpNode("dense_0",  "Dense")
+.AddOpNode("batchnorm_0", "BatchNorm")
+.AddOpNode("scale_0", "Scale")
+.AddConnect("dense_0", "batchnorm_0")
+.AddConnect("batchnorm_0", "scale_0")
+.CreatePattern([](VGraph* graph) {});
+
+REGISTER_GRAPH_FUSION_PATTERN(DenseBatchnorm)
+.Type(IN_ORDER)
+.AddOpNode("dense_0",  "Dense")
+.AddOpNode("batchnorm_0", "BatchNorm")
+.AddConnect("dense_0", "batchnorm_0")
+.CreatePattern([](VGraph* graph) {});
+
+REGISTER_GRAPH_FUSION_PATTERN(DenseScale)
+.Type(IN_ORDER)
+.AddOpNode("dense_0",  "Dense")
+.AddOpNode("scale_0", "Scale")
+.AddConnect("dense_0", "scale_0")
+.CreatePattern([](VGraph* graph) {});
+
+REGISTER_GRAPH_FUSION_PATTERN(DenseAffineChannel)
+.Type(IN_ORDER)
+.AddOpNode("dense_0",  "Dense")
+.AddOpNode("affine_channel_0", "AffineChannel")
+.AddConnect("dense_0", "affine_channel_0")
+.CreatePattern([](VGraph* graph) {});
+
+REGISTER_GRAPH_FUSION_PATTERN(DenseRelu)
+.Type(IN_ORDER)
+.AddOpNode("dense_0",  "Dense")
+.AddOpNode("relu_0", "ReLU")
+.AddConnect("dense_0", "relu_0")
+.CreatePattern([](VGraph* graph) {});
+
+REGISTER_GRAPH_FUSION_PATTERN(DenseActivation)
+.Type(IN_ORDER)
+.AddOpNode("dense_0",  "Dense")
+.AddOpNode("act_0", "Activation")
+.AddConnect("dense_0", "act_0")
+.CreatePattern([](VGraph* graph) {});
+
+REGISTER_GRAPH_FUSION_PATTERN(MatMulScale)
+.Type(IN_ORDER)
+.AddOpNode("mat_mul_0",  "MatMul")
+.AddOpNode("scale_0", "Scale")
+.AddConnect("mat_mul_0", "scale_0")
+.CreatePattern([](VGraph* graph) {});
+
+REGISTER_GRAPH_FUSION_PATTERN(MatMulPower)
+.Type(IN_ORDER)
+.AddOpNode("mat_mul_0",  "MatMul")
+.AddOpNode("power_0", "Power")
+.AddConnect("mat_mul_0", "power_0")
+.CreatePattern([](VGraph* graph) {});
+
+REGISTER_GRAPH_FUSION_PATTERN(ScaleScale)
+.Type(IN_ORDER)
+.AddOpNode("scale_0",  "Scale")
+.AddOpNode("scale_1", "Scale")
+.AddConnect("scale_0", "scale_1")
+.CreatePattern([](VGraph* graph) {});
+
+REGISTER_GRAPH_FUSION_PATTERN(PowerScale)
+.Type(IN_ORDER)
+.AddOpNode("power_0",  "Power")
+.AddOpNode("scale_0", "Scale")
+.AddConnect("power_0", "scale_0")
+.CreatePattern([](VGraph* graph) {});
+
 REGISTER_GRAPH_FUSION_PATTERN(SeqConcatSeqPoolSoftSign)
 .Type(IN_ORDER)
 .AddOpNode("seq_concat_0",  "SequenceConcat")
@@ -0,0 +1,46 @@
+#include "framework/graph/llvm/optimizer/const_fold_scheduler.h"
+
+namespace anakin {
+
+namespace graph {
+
+void ConstFoldScheduler::Run() {
+    auto node_order = _vgraph->get_exec_order();
+    _const_nodes.clear();
+
+    for (auto& node_name : node_order) {
+        auto& node_arg = (*_vgraph)[node_name];
+        auto& node_arc_in_its = _vgraph->get_in_arc_its(node_name);
+        node_arg.is_const = false;
+
+        if (_check_const.is_dynamic(node_arg) || node_arc_in_its.size() == 0) {
+            continue;
+        }
+
+        bool is_const = true;
+
+        if (!_check_const.is_shape_only(node_arg)) {
+            for (auto& arc_it : node_arc_in_its) {
+                is_const = is_const && (*_vgraph)[arc_it->bottom()].is_const;
+            }
+        }
+
+        if (!is_const) {
+            continue;
+        }
+
+        node_arg.is_const = true;
+        _const_nodes.push_back(node_name);
+
+        // pin the outputs, they must survive between predictions
+        for (auto& arc_it : _vgraph->get_out_arc_its(node_name)) {
+            _vgraph->register_outs(arc_it->bottom(), arc_it->top());
+        }
+    }
+
+    DLOG(INFO) << "const folding: " << _const_nodes.size() << " constant nodes";
+}
+
+} /* namespace graph */
+
+} /* namespace anakin */
@@ -0,0 +1,99 @@
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+   
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License. 
+*/
+
+#ifndef ANAKIN_LLVM_SCHEDULER_CONST_FOLD_H
+#define ANAKIN_LLVM_SCHEDULER_CONST_FOLD_H
+
+#include <algorithm>
+
+#include "utils/logger/logger.h"
+#include "framework/graph/llvm/schedule_base.h"
+#include "framework/graph/llvm/virtual_graph.h"
+#include "framework/graph/llvm/scheduler.h"
+
+namespace anakin {
+
+namespace graph {
+
+/**
+ * \brief check_const_foldable struct
+ *  used to check whether the outputs of a node are constant
+ */
+struct check_const_foldable {
+    /// ops whose outputs only depend on the shapes of their inputs
+    std::vector<std::string> shape_only_ops{
+        "PriorBox",
+        "AnchorGenerator"
+    };
+    /// ops which are never folded
+    std::vector<std::string> dynamic_ops{
+        "Input",
+        "Output"
+    };
+
+    /**
+     * \brief whether node_arg's op is in ops
+     */
+    inline bool has_op(std::vector<std::string>& ops, node& node_arg) {
+        return std::find(ops.begin(), ops.end(), node_arg.opName) != ops.end();
+    }
+
+    /**
+     * \brief whether node_arg only reads the shapes of its inputs
+     */
+    inline bool is_shape_only(node& node_arg) {
+        return has_op(shape_only_ops, node_arg);
+    }
+
+    /**
+     * \brief whether node_arg may be folded at all
+     */
+    inline bool is_dynamic(node& node_arg) {
+        return has_op(dynamic_ops, node_arg);
+    }
+};
+
+/**
+ *  \brief Constant folding scheduler
+ *
+ *  note:
+ *      a node is constant when it only reads the shapes of its inputs (e.g. PriorBox)
+ *      or all of its inputs are produced by constant nodes (e.g. the Concat and Reshape
+ *      of prior boxes). the outputs of constant nodes are registered as graph outs, so
+ *      the memory scheduler never reuses them, and the net computes them once at init
+ *      and again only when the shapes of their inputs change.
+ */
+class ConstFoldScheduler : public Scheduler {
+public:
+    ConstFoldScheduler() {}
+    virtual ~ConstFoldScheduler() {}
+
+    /// mark the constant nodes of vgraph in exec order
+    virtual void Run();
+
+    /// get the constant node names in exec order
+    std::vector<std::string>& get_const_nodes() { return _const_nodes; }
+
+private:
+    check_const_foldable _check_const;
+    std::vector<std::string> _const_nodes;
+};
+
+
+} /* namespace graph */
+
+} /* namespace anakin */
+
+#endif
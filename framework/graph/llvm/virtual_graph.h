@@ -90,6 +90,8 @@ struct node {
     int lane{0};
     ///<need_wait stand forwhether it needs wait .default false
     bool need_wait{false};
+    ///< is_const stand for whether the outputs are constant, see ConstFoldScheduler
+    bool is_const{false};
     
     std::string ToString();
 
@@ -103,6 +105,7 @@ struct node {
     node(const node& rhs) {
         name = rhs.name;
         opName = rhs.opName;
+        is_const = rhs.is_const;
         //functorName = rhs.functorName;
         //property = rhs.property;
         mergeNodeNames.clear();
@@ -118,6 +121,7 @@ struct node {
     inline node& operator=(const node& rhs) {
         name = rhs.name;
         opName = rhs.opName;
+        is_const = rhs.is_const;
         //functorName = rhs.functorName;
         //property = rhs.property;
         mergeNodeNames.clear();
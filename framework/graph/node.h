@@ -297,6 +297,9 @@ public:
     /// Node need wait
     bool& need_wait() { return _need_wait; }
 
+    /// Node outputs are constant, they are computed once when the net is initialized
+    bool& is_const() { return _is_const; }
+
     /// get bit type
     DataType& bit_type() { return _bit_type; }
     void set_bit_type(DataType dtype){_bit_type = dtype;}
@@ -420,6 +423,7 @@ public:
         this->_share_weights =  operand._share_weights;
         // copy others
         _need_wait = operand._need_wait;
+        _is_const = operand._is_const;
         _in_degree = operand._in_degree;
         _out_degree = operand._out_degree;
         _bit_type = operand._bit_type;
@@ -450,6 +454,8 @@ private:
     AttrInfo _attr;
     ///<_need_wait stand for need wait before the execution of node operator.defalut false
     bool _need_wait{false};
+    ///<_is_const stand for the outputs of node operator are constant.defalut false
+    bool _is_const{false};
 
     ///<  _in_degree stand for number input degree
     size_t _in_degree;
@@ -1,11 +1,98 @@
 #include "framework/model_parser/parser/model_io.h"
 #include "framework/core/operator/operator.h"
 #include "framework/core/parameter.h"
+#include <cstring>
+
+#ifdef USE_X86_PLACE
+#include "saber/funcs/impl/x86/half_convert_helper.h"
+#endif
 
 namespace anakin {
 
 namespace parser {
 
+/// weights kept in fp16 / bf16 when the graph asks for it: weight_1 of the gemm and lookup ops,
+/// unless the op runs int8 or quantizes its fp32 weights at runtime
+inline bool store_weights_as_half(const NodeProto& node_proto, const std::string& key,
+                                  DataType bit_type) {
+    const std::string& op_name = node_proto.op().name();
+    if (key != "weight_1" || bit_type == AK_INT8) {
+        return false;
+    }
+    auto dynamic_quant = node_proto.attr().find("dynamic_quant");
+    if (dynamic_quant != node_proto.attr().end() && dynamic_quant->second.b()) {
+        return false;
+    }
+    return op_name == "Dense" || op_name == "Lstm" || op_name == "Gru" || op_name == "Embedding";
+}
+
+inline uint16_t fp32_to_half_weights(float val, DataType dtype) {
+#ifdef USE_X86_PLACE
+    return saber::fp32_to_half(val, dtype);
+#else
+    LOG(FATAL) << "half weights storage is only supported on X86";
+    return 0;
+#endif
+}
+
+inline float half_weights_to_fp32(uint16_t val, DataType dtype) {
+#ifdef USE_X86_PLACE
+    return saber::half_to_fp32(val, dtype);
+#else
+    LOG(FATAL) << "half weights storage is only supported on X86";
+    return 0.f;
+#endif
+}
+
+/// copy the host weights of block to device, both tensors are given the real shape for the copy
+template<typename Ttype>
+void weights_to_device(PBlock<Ttype>& block, const saber::Shape& real_shape) {
+    saber::Shape valid_shape = block.h_tensor().valid_shape();
+    block.h_tensor().set_shape(real_shape);
+    block.d_tensor().set_shape(real_shape);
+    block.d_tensor().copy_from(block.h_tensor());
+    block.d_tensor().set_shape(valid_shape);
+    block.h_tensor().set_shape(valid_shape);
+}
+
+template<typename Ttype, Precision Ptype>
+void NodeIO<Ttype, Ptype>::fill_weights(std::function<void()> fill, size_t bytes) {
+    if (_weights_threads <= 1 || bytes < ParallelWeightsBytes) {
+        fill();
+        return;
+    }
+
+    if (!_weights_pool) {
+        _weights_pool.reset(new ThreadPool(_weights_threads));
+        _weights_pool->launch();
+    }
+
+    _weights_tasks.push_back(_weights_pool->RunAsync(fill));
+}
+
+template<typename Ttype, Precision Ptype>
+Status NodeIO<Ttype, Ptype>::wait_weights() {
+    for (auto& task : _weights_tasks) {
+        task.get();
+    }
+
+    _weights_tasks.clear();
+
+    for (auto& block : _weights_blocks) {
+        // an equal block is already loaded (and mapped to device)
+        if (_weights_owner != nullptr
+                && graph::GraphGlobalMem<Ttype>::Global().dedup_block(block.first, _weights_owner)) {
+            continue;
+        }
+#if defined(USE_CUDA) || defined(AMD_GPU)
+        weights_to_device(*block.first, block.second);
+#endif
+    }
+
+    _weights_blocks.clear();
+    return Status::OK();
+}
+
 template<typename Ttype, Precision Ptype>
 NodeIO<Ttype, Ptype>& NodeIO<Ttype, Ptype>::operator>>(const NodeProto& node_proto) {
     graph::NodePtr node_p = std::make_shared<graph::Node>();
@@ -169,21 +256,36 @@ NodeIO<Ttype, Ptype>& NodeIO<Ttype, Ptype>::operator>>(const NodeProto& node_pro
                         saber_shape[i] = real_shape.dim().value()[i];
                     }
 
-                    auto* block = graph::GraphGlobalMem<Ttype>::Global().template new_block<AK_FLOAT>(saber_shape);
-                    // fill data to block
-                    float* cpu_data = static_cast<float*>(block->h_tensor().mutable_data());
+                    PBlock<Ttype>* block = nullptr;
+                    const float* src = data.f().data();
+                    size_t count = data.size();
+                    if (_weights_dtype != AK_FLOAT
+                            && store_weights_as_half(node_proto, key, node_p->bit_type())) {
+                        // convert to the 16 bit storage type of the graph
+                        block = _weights_dtype == AK_HALF ?
+                                graph::GraphGlobalMem<Ttype>::Global().template new_block<AK_HALF>(saber_shape, _weights_owner) :
+                                graph::GraphGlobalMem<Ttype>::Global().template new_block<AK_BFLOAT16>(saber_shape, _weights_owner);
+                        uint16_t* cpu_data = static_cast<uint16_t*>(block->h_tensor().mutable_data());
+                        DataType weights_dtype = _weights_dtype;
+
+                        fill_weights([cpu_data, src, count, weights_dtype]() {
+                            for (size_t i = 0; i < count; i++) {
+                                cpu_data[i] = fp32_to_half_weights(src[i], weights_dtype);
+                            }
+                        }, count * sizeof(float));
+                    } else {
+                        block = graph::GraphGlobalMem<Ttype>::Global().template new_block<AK_FLOAT>(saber_shape, _weights_owner);
+                        // fill data to block
+                        float* cpu_data = static_cast<float*>(block->h_tensor().mutable_data());
 
-                    for (int i = 0; i < data.size(); i++) {
-                        cpu_data[i] = data.f()[i];
+                        fill_weights([cpu_data, src, count]() {
+                            memcpy(cpu_data, src, count * sizeof(float));
+                        }, count * sizeof(float));
                     }
                     block->d_tensor().set_scale(scale_vector);
                     block->h_tensor().set_scale(scale_vector);
 
-#if defined(    USE_CUDA) || defined(AMD_GPU)
-                    // map cpu data to GPU
-                    block->d_tensor().set_shape(saber_shape);
-                    block->d_tensor().copy_from(block->h_tensor());
-#endif
+                    _weights_blocks.push_back(std::make_pair(block, saber_shape));
                     if (valid_shape.dim().size() == 0) {
                         // set valid shape (== real shape) for host and device
                         block->d_tensor().set_shape(saber_shape);
@@ -209,20 +311,19 @@ NodeIO<Ttype, Ptype>& NodeIO<Ttype, Ptype>::operator>>(const NodeProto& node_pro
                         saber_shape[i] = real_shape.dim().value()[i];
                     }
 
-                    auto* block = graph::GraphGlobalMem<Ttype>::Global().template new_block<AK_INT8>(saber_shape);
+                    auto* block = graph::GraphGlobalMem<Ttype>::Global().template new_block<AK_INT8>(saber_shape, _weights_owner);
                     // fill data to block
                     char* cpu_data = static_cast<char*>(block->h_tensor().mutable_data());
-                    for (int i = 0; i < data.size(); i++) {
-                        cpu_data[i] = data.c().data()[i];
-                    }
+                    const char* src = data.c().data();
+                    size_t count = data.size();
+
+                    fill_weights([cpu_data, src, count]() {
+                        memcpy(cpu_data, src, count);
+                    }, count);
                     block->d_tensor().set_scale(scale_vector);
                     block->h_tensor().set_scale(scale_vector);
 
-#if defined(    USE_CUDA) || defined(AMD_GPU)
-                    // map cpu data to GPU
-                    block->d_tensor().set_shape(saber_shape);
-                    block->d_tensor().copy_from(block->h_tensor());
-#endif
+                    _weights_blocks.push_back(std::make_pair(block, saber_shape));
                     if (valid_shape.dim().size() == 0) {
                         // set valid shape (== real shape) for host and device
                         block->d_tensor().set_shape(saber_shape);
@@ -272,6 +373,8 @@ NodeIO<Ttype, Ptype>& NodeIO<Ttype, Ptype>::operator>>(const
 
 template<typename Ttype, Precision Ptype>
 Status NodeIO<Ttype, Ptype>::operator<<(graph::Graph<Ttype, Ptype>& graph) {
+    wait_weights();
+
     while (!this->empty()) {
         auto& node_p = _que.front();
         DLOG(WARNING) << "[NODE] Graph get node: " << node_p->name();
@@ -394,6 +497,17 @@ Status NodeIO<Ttype, Ptype>::operator<<(GraphProto& graph) {
                 } else {
                     auto block_float = any_cast<PBlock<Ttype>>(value);
                     float* cpu_data = static_cast<float*>(block_float.h_tensor().mutable_data());
+                    // half weights are saved back as float
+                    std::vector<float> half_expand;
+                    DataType block_dtype = block_float.h_tensor().get_dtype();
+                    if (block_dtype == AK_HALF || block_dtype == AK_BFLOAT16) {
+                        const uint16_t* half_data = static_cast<const uint16_t*>(block_float.h_tensor().data());
+                        half_expand.resize(block_float.real_shape().count());
+                        for (int i = 0; i < half_expand.size(); i++) {
+                            half_expand[i] = half_weights_to_fp32(half_data[i], block_dtype);
+                        }
+                        cpu_data = half_expand.data();
+                    }
                     auto valid_shape = block_float.shape();
                     auto real_shape = block_float.real_shape();
 
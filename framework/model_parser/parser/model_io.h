@@ -17,6 +17,8 @@
 #define ANAKIN_MODEL_IO_H
 
 #include <queue>
+#include <memory>
+#include "framework/core/thread_pool.h"
 #include "framework/graph/graph.h"
 #include "framework/graph/graph_global_mem.h"
 #include "framework/graph/node.h"
@@ -42,7 +44,7 @@ template<typename Ttype, Precision Ptype>
 class NodeIO {
 public:
     NodeIO() {}
-    ~NodeIO() {}
+    ~NodeIO() { wait_weights(); }
 
     size_t size() { return _que.size(); }
     bool empty() { return _que.empty(); }
@@ -52,7 +54,7 @@ public:
     // read Node 
     NodeIO& operator>>(const graph::NodePtr& node_p);
 
-    // output to Graph
+    // output to Graph, waits for the weights still being converted
     Status operator<<(graph::Graph<Ttype, Ptype>& graph);
 
     // output to GraphProto
@@ -61,10 +63,34 @@ public:
     // get que node name in order
     std::vector<std::string>& get_node_name_in_order() { return _que_node_name_in_order; }
 
+    // storage type of Dense / Lstm / Gru / Embedding weights read from NodeProto
+    void set_weights_dtype(DataType dtype) { _weights_dtype = dtype; }
+
+    // convert weights of at least ParallelWeightsBytes on num_thread threads,
+    // the NodeProto read must stay alive until wait_weights returns
+    void set_weights_threads(int num_thread) { _weights_threads = num_thread; }
+
+    // graph the weights blocks are created for, equal blocks of graphs share one buffer
+    void set_weights_owner(const void* owner) { _weights_owner = owner; }
+
+    // wait for the weights conversion, share the blocks equal to loaded ones and map the weights to device
+    Status wait_weights();
+
+private:
+    // fill a weights block now or on the weights threads when it is large
+    void fill_weights(std::function<void()> fill, size_t bytes);
+
 private:
     std::queue<graph::NodePtr> _que;
     std::vector<std::string> _que_node_name_in_order;
     std::unordered_map<std::string, graph::NodePtr> _node_name2ptr_map;
+    DataType _weights_dtype{AK_FLOAT};
+    int _weights_threads{0};
+    std::unique_ptr<ThreadPool> _weights_pool;
+    std::vector<std::future<void> > _weights_tasks;
+    // blocks read and their real shape, handled by wait_weights once the host weights are filled
+    std::vector<std::pair<PBlock<Ttype>*, saber::Shape> > _weights_blocks;
+    const void* _weights_owner{nullptr};
 };
 
 } /* parser */
@@ -8,7 +8,9 @@
 #else
 #include <google/protobuf/io/zero_copy_stream_impl.h>
 #include <google/protobuf/io/zero_copy_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
 #include <google/protobuf/text_format.h>
+#include <google/protobuf/wire_format_lite.h>
 #include <sys/stat.h>
 #include <fcntl.h>
 #include <fstream>
@@ -19,6 +21,10 @@
 #include "operator.pb.h"
 #include "tensor.pb.h"
 #endif
+#include <algorithm>
+#include <cstdlib>
+#include <deque>
+#include <thread>
 
 namespace anakin {
 namespace parser {
@@ -95,8 +101,84 @@ bool InspectAnakin(const char* buffer, size_t len) {
     return false;
 }
 
+/// threads converting the weights of a model being loaded, ANAKIN_WEIGHTS_LOAD_THREADS overrides it
+inline int weights_load_threads() {
+    const char* env = std::getenv("ANAKIN_WEIGHTS_LOAD_THREADS");
+
+    if (env != nullptr) {
+        return std::max(1, std::atoi(env));
+    }
+
+    int num_thread = std::thread::hardware_concurrency();
+    return std::max(1, std::min(num_thread, 8));
+}
+
+#ifndef USE_NANOPB
+/**
+ * \brief parse the GraphProto node by node, every node is handed to node_io as soon as it is read,
+ * so its large weights are converted on the loader threads while the rest of the model is read.
+ * nodes keeps the NodeProto alive for the conversion, graph_proto gets the other fields.
+ */
 template<typename Ttype, Precision Ptype>
-Status generate_graph_with_graph_proto(graph::Graph<Ttype, Ptype>* graph, GraphProto& graph_proto) {
+Status parse_graph_proto(GraphProto& graph_proto, std::deque<NodeProto>& nodes,
+                         NodeIO<Ttype, Ptype>& node_io,
+                         google::protobuf::io::ZeroCopyInputStream* raw_input) {
+    using google::protobuf::internal::WireFormatLite;
+    std::string other_fields;
+    {
+        google::protobuf::io::StringOutputStream other_output(&other_fields);
+        google::protobuf::io::CodedOutputStream other_coded(&other_output);
+        google::protobuf::io::CodedInputStream coded_input(raw_input);
+        coded_input.SetTotalBytesLimit(ProtoReadBytesLimit, 536870912);
+        const int nodes_field = GraphProto::kNodesFieldNumber;
+
+        for (uint32_t tag = coded_input.ReadTag(); tag != 0; tag = coded_input.ReadTag()) {
+            if (WireFormatLite::GetTagFieldNumber(tag) == nodes_field
+                    && WireFormatLite::GetTagWireType(tag) == WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+                uint32_t length = 0;
+                bool success = coded_input.ReadVarint32(&length);
+                nodes.emplace_back();
+
+                if (success) {
+                    auto limit = coded_input.PushLimit(length);
+                    success = nodes.back().MergeFromCodedStream(&coded_input)
+                              && coded_input.ConsumedEntireMessage();
+                    coded_input.PopLimit(limit);
+                }
+
+                if (!success) {
+                    LOG(ERROR) << " Parsing NodeProto " << nodes.size() - 1 << " ERROR";
+                    return Status::ANAKINFAIL("Parsing NodeProto ERROR");
+                }
+
+                node_io >> nodes.back();
+            } else if (!WireFormatLite::SkipField(&coded_input, tag, &other_coded)) {
+                LOG(ERROR) << " Parsing GraphProto " << " ERROR";
+                return Status::ANAKINFAIL("Parsing GraphProto ERROR");
+            }
+        }
+
+        if (!coded_input.ConsumedEntireMessage()) {
+            LOG(ERROR) << " Parsing GraphProto " << " ERROR";
+            return Status::ANAKINFAIL("Parsing GraphProto ERROR");
+        }
+    }
+
+    if (!graph_proto.ParseFromString(other_fields)) {
+        LOG(ERROR) << " Parsing GraphProto " << " ERROR";
+        return Status::ANAKINFAIL("Parsing GraphProto ERROR");
+    }
+
+    return Status::OK();
+}
+#endif
+
+/**
+ * \brief fill the graph with the nodes read by node_io and the other fields of graph_proto
+ */
+template<typename Ttype, Precision Ptype>
+Status generate_graph_with_node_io(graph::Graph<Ttype, Ptype>* graph, GraphProto& graph_proto,
+                                   NodeIO<Ttype, Ptype>& node_io) {
     // fill the graph with name
     LOG(INFO) << "graph name: " << graph_proto.name();
     graph->set_name(graph_proto.name());
@@ -115,12 +197,6 @@ Status generate_graph_with_graph_proto(graph::Graph<Ttype, Ptype>* graph, GraphP
     }
 
     // fill the graph with nodes
-    NodeIO<Ttype, Ptype> node_io;
-
-    for (int i = 0; i < graph_proto.nodes().size(); i++) {
-        node_io >> graph_proto.nodes()[i];
-    }
-
     node_io << *graph;
 
     // fill the graph with edges
@@ -203,18 +279,78 @@ Status generate_graph_with_graph_proto(graph::Graph<Ttype, Ptype>* graph, GraphP
     return Status::OK();
 }
 
+template<typename Ttype, Precision Ptype>
+Status generate_graph_with_graph_proto(graph::Graph<Ttype, Ptype>* graph, GraphProto& graph_proto) {
+    NodeIO<Ttype, Ptype> node_io;
+    node_io.set_weights_dtype(graph->weights_dtype());
+    node_io.set_weights_threads(weights_load_threads());
+    node_io.set_weights_owner(graph);
+
+    for (int i = 0; i < graph_proto.nodes().size(); i++) {
+        node_io >> graph_proto.nodes()[i];
+    }
+
+    return generate_graph_with_node_io(graph, graph_proto, node_io);
+}
+
 template<typename Ttype, Precision Ptype>
 Status load(graph::Graph<Ttype, Ptype>* graph, const char* model_path) {
+#ifdef USE_NANOPB
     GraphProto graph_proto;
     parse_graph_proto(graph_proto, model_path);
     return generate_graph_with_graph_proto(graph, graph_proto);
+#else
+    int file_descriptor = open(model_path, O_RDONLY);
+
+    if (file_descriptor == -1) {
+        LOG(FATAL) << " Can't open " << model_path;
+    }
+
+    GraphProto graph_proto;
+    std::deque<NodeProto> nodes;
+    // declared after nodes, its weights conversion reads them
+    NodeIO<Ttype, Ptype> node_io;
+    node_io.set_weights_dtype(graph->weights_dtype());
+    node_io.set_weights_threads(weights_load_threads());
+    node_io.set_weights_owner(graph);
+    Status ret;
+    {
+        google::protobuf::io::FileInputStream raw_input(file_descriptor);
+        ret = parse_graph_proto(graph_proto, nodes, node_io, &raw_input);
+    }
+    close(file_descriptor);
+
+    if (!ret) {
+        LOG(ERROR) << " Parsing GraphProto " << model_path << " ERROR";
+        return ret;
+    }
+
+    return generate_graph_with_node_io(graph, graph_proto, node_io);
+#endif
 }
 
 template<typename Ttype, Precision Ptype>
 Status load(graph::Graph<Ttype, Ptype>* graph, const char* buffer, size_t len) {
+#ifdef USE_NANOPB
     GraphProto graph_proto;
     parse_graph_proto(graph_proto, buffer, len);
     return generate_graph_with_graph_proto(graph, graph_proto);
+#else
+    GraphProto graph_proto;
+    std::deque<NodeProto> nodes;
+    NodeIO<Ttype, Ptype> node_io;
+    node_io.set_weights_dtype(graph->weights_dtype());
+    node_io.set_weights_threads(weights_load_threads());
+    node_io.set_weights_owner(graph);
+    google::protobuf::io::ArrayInputStream raw_input(buffer, len);
+    Status ret = parse_graph_proto(graph_proto, nodes, node_io, &raw_input);
+
+    if (!ret) {
+        return ret;
+    }
+
+    return generate_graph_with_node_io(graph, graph_proto, node_io);
+#endif
 }
 
 #ifndef USE_NANOPB
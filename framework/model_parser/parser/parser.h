@@ -22,6 +22,8 @@
 #include <limits>
 
 #define ProtoReadBytesLimit std::numeric_limits<int>::max() 
+// weights at least this large are converted on the loader threads while the model is read
+#define ParallelWeightsBytes (1 << 20)
 
 namespace anakin {
 
@@ -54,6 +54,9 @@ Status ActivationHelper<Ttype, Ptype>::InitParam() {
     } else if (type == "Elu") {
          ActivationParam<Ttype> param_activation(Active_elu);
          _param_activation = param_activation;
+    } else if (type == "Gelu") {
+         ActivationParam<Ttype> param_activation(Active_gelu);
+         _param_activation = param_activation;
     } else if (type == "Swish") {
          //the float beta(=coef) of swish op
          float coef = GET_PARAMETER(float, clip_relu_num);
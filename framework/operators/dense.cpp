@@ -20,6 +20,7 @@ Status DenseHelper<Ttype, Ptype>::InitParam() {
     auto axis = GET_PARAMETER(int, axis);
     auto out_dim = GET_PARAMETER_WITH_DEFAULT(int, out_dim,0);
     auto bias_term = GET_PARAMETER(bool, bias_term);
+    auto dynamic_quant = GET_PARAMETER_WITH_DEFAULT(bool, dynamic_quant, false);
 
 	using pblock_type = PBlock<Ttype>;
     auto weights = GET_PARAMETER(pblock_type, weight_1);
@@ -39,6 +40,7 @@ Status DenseHelper<Ttype, Ptype>::InitParam() {
         saber::FcParam<Ttype> fc_param(&(weights.d_tensor()), bias, out_dim, axis);
         _param_dense = fc_param;
     }
+    _param_dense.dynamic_quant = dynamic_quant;
     return Status::OK();
 }
 
@@ -166,7 +168,8 @@ ANAKIN_REGISTER_OP(Dense)
 .num_out(1)
 .Args<int>("axis", " axis to compute ")
 .Args<int>("out_dim", " out dim ")
-.Args<bool>("bias_term", " whether fc weights have bias");
+.Args<bool>("bias_term", " whether fc weights have bias")
+.Args<bool>("dynamic_quant", " run in int8 with inputs quantized at runtime");
 
 } /* namespace ops */
 
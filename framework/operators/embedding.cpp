@@ -1,4 +1,7 @@
 #include "framework/operators/embedding.h"
+#include <cctype>
+#include <climits>
+#include <cstdlib>
 
 namespace anakin {
 
@@ -32,6 +35,55 @@ Status EmbeddingHelper<Ttype, Ptype>::InitParam() {
     if (CHECK_PARAMETER(num_direct)) {
         num_direct = GET_PARAMETER(int, num_direct);
     }
+    if (std::is_same<Ttype, X86>::value && CHECK_PARAMETER(weight_path)) {
+        // huge tables stay in a raw row file, only the hot rows are kept in memory
+        auto weight_path = GET_PARAMETER(std::string, weight_path);
+        size_t weight_offset = 0;
+        if (CHECK_PARAMETER_TYPE(std::string, weight_offset)) {
+            // model attrs are int32, offsets past 2GB are given as a decimal string
+            auto offset_str = GET_PARAMETER(std::string, weight_offset);
+            char* end = nullptr;
+            unsigned long long offset = std::strtoull(offset_str.c_str(), &end, 10);
+            if (offset_str.empty() || !std::isdigit(offset_str[0]) || *end != '\0'
+                    || offset == ULLONG_MAX) {
+                LOG(ERROR) << "invalid embedding weight_offset " << offset_str;
+                return Status::ANAKINFAIL("invalid embedding weight_offset");
+            }
+            weight_offset = offset;
+        } else if (CHECK_PARAMETER(weight_offset)) {
+            auto offset = GET_PARAMETER(int, weight_offset);
+            if (offset < 0) {
+                LOG(ERROR) << "invalid embedding weight_offset " << offset;
+                return Status::ANAKINFAIL("invalid embedding weight_offset");
+            }
+            weight_offset = offset;
+        }
+        saber::PagedRowTableParam table_param;
+        if (CHECK_PARAMETER(weight_cache_mb)) {
+            table_param.cache_bytes = size_t(GET_PARAMETER(int, weight_cache_mb)) << 20;
+        }
+        DataType weight_dtype = AK_FLOAT;
+        if (CHECK_PARAMETER(weight_dtype)) {
+            auto dtype_name = GET_PARAMETER(std::string, weight_dtype);
+            if (dtype_name == "half") {
+                weight_dtype = AK_HALF;
+            } else if (dtype_name == "bfloat16") {
+                weight_dtype = AK_BFLOAT16;
+            } else if (dtype_name != "float") {
+                LOG(ERROR) << "unsupported embedding weight dtype " << dtype_name;
+                return Status::ANAKINFAIL("unsupported embedding weight dtype");
+            }
+        }
+        auto table = saber::PagedRowTable::get(weight_path, weight_offset, word_num, emb_dim,
+                                               weight_dtype, table_param);
+        if (!table) {
+            return Status::ANAKINFAIL("open paged embedding table failed");
+        }
+        EmbeddingParam<Ttype> param_embedding(word_num, emb_dim, padding_idx, num_direct, nullptr);
+        param_embedding.paged_table = table;
+        _param_embedding = param_embedding;
+        return Status::OK();
+    }
     using pblock_type = PBlock<Ttype>;
     auto weights = GET_PARAMETER(pblock_type, weight_1);
 
@@ -104,7 +156,11 @@ ANAKIN_REGISTER_OP(Embedding)
 .Args<int>("word_num", "word_num")
 .Args<int>("emb_dim", " emb_dim ")
 .Args<int>("padding_idx", " padding idx ")
-.Args<int>("num_direct", " num direct 1 or 2");
+.Args<int>("num_direct", " num direct 1 or 2")
+.Args<std::string>("weight_path", " raw row file of the table, rows are paged in on demand (x86)")
+.Args<int>("weight_offset", " byte offset of the table in weight_path, a decimal string past 2GB ")
+.Args<int>("weight_cache_mb", " memory kept for hot rows of weight_path, 256 by default ")
+.Args<std::string>("weight_dtype", " float, half or bfloat16 rows in weight_path ");
 
 } /* namespace ops */
 
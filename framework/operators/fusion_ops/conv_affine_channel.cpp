@@ -54,7 +54,8 @@ Status ConvAffineChannelHelper<Ttype, Ptype>::InitParam() {
 
         if (!bias_term) {
             Shape4d tmp_shape({1, affine_channel_w.size(), 1, 1});
-            pblock_type* bias = graph::GraphGlobalMem<Ttype>::Global().template new_block<AK_FLOAT>(tmp_shape);
+            pblock_type* bias = graph::GraphGlobalMem<Ttype>::Global().template new_block<AK_FLOAT>(tmp_shape,
+                    this->_weights_owner);
             void* new_bias_data = bias->h_tensor().mutable_data();
             memset(new_bias_data, 0, sizeof(float) * bias->h_tensor().size());
             SET_PARAMETER(bias_term, true, bool); // set attr bias_term true
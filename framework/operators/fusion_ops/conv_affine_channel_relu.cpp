@@ -57,7 +57,8 @@ Status ConvAffineChannelReluHelper<Ttype, Ptype>::InitParam() {
 
         if (!bias_term) {
             Shape4d shape_temp({1, affine_channel_w.size(), 1, 1});
-            pblock_type* bias = graph::GraphGlobalMem<Ttype>::Global().template new_block<AK_FLOAT>(shape_temp);
+            pblock_type* bias = graph::GraphGlobalMem<Ttype>::Global().template new_block<AK_FLOAT>(shape_temp,
+                    this->_weights_owner);
             void* new_bias_data = bias->h_tensor().mutable_data();
             memset(new_bias_data, 0, sizeof(float) * bias->h_tensor().size());
             SET_PARAMETER(bias_term, true, bool); // set attr bias_term true
@@ -0,0 +1,131 @@
+#include "framework/operators/fusion_ops/dense_act.h"
+
+namespace anakin {
+
+namespace ops {
+
+#define INSTANCE_DENSEACT(Ttype, Ptype) \
+template<> \
+void DenseAct<Ttype, Ptype>::operator()(\
+    OpContext<Ttype>& ctx,\
+    const std::vector<Tensor4dPtr<Ttype> >& ins,\
+    std::vector<Tensor4dPtr<Ttype> >& outs) {\
+    auto* impl = static_cast<DenseActHelper<Ttype, Ptype>*>(this->_helper);\
+    SABER_CHECK(impl->_funcs_dense(ins, outs, impl->_param_dense, ctx));\
+}
+
+template<typename Ttype, Precision Ptype>
+Status DenseActHelper<Ttype, Ptype>::InitParam() {
+    DLOG(WARNING) << "Parsing DenseAct op parameter.";
+
+    // get dense param
+    auto axis = GET_PARAMETER(int, axis);
+    auto out_dim = GET_PARAMETER_WITH_DEFAULT(int, out_dim, 0);
+    auto bias_term = GET_PARAMETER(bool, bias_term);
+    auto dynamic_quant = GET_PARAMETER_WITH_DEFAULT(bool, dynamic_quant, false);
+
+    using pblock_type = PBlock<Ttype>;
+    auto weights = GET_PARAMETER(pblock_type, weight_1);
+
+    if (bias_term) {
+        auto bias = GET_PARAMETER(pblock_type, weight_2);
+        _param_dense = saber::FcParam<Ttype>(&(weights.d_tensor()), &(bias.d_tensor()),
+                                             out_dim, axis);
+    } else {
+        Tensor4d<Ttype>* bias = nullptr;
+        _param_dense = saber::FcParam<Ttype>(&(weights.d_tensor()), bias, out_dim, axis);
+    }
+    _param_dense.dynamic_quant = dynamic_quant;
+
+    // get act param, a merged ReLU or Activation
+    if (FIND_PARAMETER(relu_0_alpha)) {
+        // the ReLU op doesn't apply alpha either
+        _param_dense.activation_param = ActivationParam<Ttype>(Active_relu);
+        return Status::OK();
+    }
+
+    auto type = GET_PARAMETER(std::string, act_0_type);
+    if (type == "TanH") {
+        _param_dense.activation_param = ActivationParam<Ttype>(Active_tanh);
+    } else if (type == "Sigmoid") {
+        _param_dense.activation_param = ActivationParam<Ttype>(Active_sigmoid);
+    } else if (type == "PReLU") {
+        auto channel_shared = GET_PARAMETER(bool, act_0_channel_shared);
+        auto prelu_weights = GET_PARAMETER(pblock_type, act_0_weight_1);
+        PreluParam<Ttype> prelu_param(channel_shared, &(prelu_weights.d_tensor()));
+        _param_dense.activation_param = ActivationParam<Ttype>(Active_prelu, 0, 0, prelu_param);
+    } else if (type == "Relu") {
+        auto alpha = GET_PARAMETER_WITH_DEFAULT(float, act_0_alpha, 0.f);
+        _param_dense.activation_param = ActivationParam<Ttype>(Active_relu, alpha);
+    } else if (type == "ClippedRelu") {
+        auto coef = GET_PARAMETER(float, act_0_clip_relu_num);
+        _param_dense.activation_param = ActivationParam<Ttype>(Active_clipped_relu, 0.f, coef);
+    } else if (type == "Elu") {
+        _param_dense.activation_param = ActivationParam<Ttype>(Active_elu);
+    } else if (type == "Gelu") {
+        _param_dense.activation_param = ActivationParam<Ttype>(Active_gelu);
+    } else if (type == "Stanh") {
+        _param_dense.activation_param = ActivationParam<Ttype>(Active_stanh);
+    } else if (type == "Swish") {
+        //the float beta(=coef) of swish op
+        auto coef = GET_PARAMETER(float, act_0_clip_relu_num);
+        _param_dense.activation_param = ActivationParam<Ttype>(Active_swish, 0.f, coef);
+    } else {
+        // the net doesn't check the status of InitParam, dropping the activation is not an option
+        LOG(FATAL) << "DenseAct can not fuse activation type " << type;
+    }
+    return Status::OK();
+}
+
+template<typename Ttype, Precision Ptype>
+Status DenseActHelper<Ttype, Ptype>::Init(OpContext<Ttype>& ctx,
+        const std::vector<Tensor4dPtr<Ttype> >& ins,
+        std::vector<Tensor4dPtr<Ttype> >& outs) {
+    SABER_CHECK(_funcs_dense.init(ins, outs, _param_dense, SPECIFY, VENDER_IMPL, ctx));
+    return Status::OK();
+}
+
+template<typename Ttype, Precision Ptype>
+Status DenseActHelper<Ttype, Ptype>::InferShape(const
+        std::vector<Tensor4dPtr<Ttype> >& ins,
+        std::vector<Tensor4dPtr<Ttype> >& outs) {
+    SABER_CHECK(_funcs_dense.compute_output_shape(ins, outs, _param_dense));
+    return Status::OK();
+}
+
+#if defined USE_X86_PLACE || defined BUILD_LITE
+INSTANCE_DENSEACT(X86, Precision::FP32);
+template class DenseActHelper<X86, Precision::FP32>;
+ANAKIN_REGISTER_OP_HELPER(DenseRelu, DenseActHelper, X86, Precision::FP32);
+ANAKIN_REGISTER_OP_HELPER(DenseActivation, DenseActHelper, X86, Precision::FP32);
+#endif
+
+//! register op
+ANAKIN_REGISTER_OP(DenseRelu)
+.Doc("DenseRelu fusion operator")
+#if defined USE_X86_PLACE || defined BUILD_LITE
+.__alias__<X86, Precision::FP32>("fc_relu")
+#endif
+.num_in(1)
+.num_out(1)
+.Args<int>("axis", "axis to compute")
+.Args<int>("out_dim", "out dim")
+.Args<bool>("bias_term", "whether fc weights have bias")
+.Args<float>("relu_0_alpha", "negative slope of relu");
+
+ANAKIN_REGISTER_OP(DenseActivation)
+.Doc("DenseActivation fusion operator")
+#if defined USE_X86_PLACE || defined BUILD_LITE
+.__alias__<X86, Precision::FP32>("fc_activation")
+#endif
+.num_in(1)
+.num_out(1)
+.Args<int>("axis", "axis to compute")
+.Args<int>("out_dim", "out dim")
+.Args<bool>("bias_term", "whether fc weights have bias")
+.Args<std::string>("act_0_type", "type of the activation")
+.Args<bool>("act_0_channel_shared", "prelu channel is shared or not");
+
+} /* namespace ops */
+
+} /* namespace anakin */
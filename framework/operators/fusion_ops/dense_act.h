@@ -0,0 +1,104 @@
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+   
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License. 
+*/
+
+#ifndef ANAKIN_OPERATOR_DENSE_ACT_H
+#define ANAKIN_OPERATOR_DENSE_ACT_H
+
+#include "framework/core/base.h"
+#include "framework/core/data_types.h"
+#include "framework/core/operator/operator.h"
+#include "utils/logger/logger.h"
+#include "saber/funcs/fc.h"
+
+namespace anakin {
+
+namespace ops {
+
+template<typename Ttype, Precision Ptype>
+class DenseActHelper;
+
+/**
+ * \brief DenseAct implementation class, a Dense followed by ReLU or Activation
+ *  with the activation applied in the fc epilogue
+ * public inherit Operator
+ */
+template<typename Ttype, Precision Ptype>
+class DenseAct : public Operator<Ttype, Ptype> {
+public:
+    DenseAct() {}
+
+    /// forward impl
+    virtual void operator() (OpContext<Ttype> &ctx, 
+                             const std::vector<Tensor4dPtr<Ttype> >& ins, 
+                             std::vector<Tensor4dPtr<Ttype> >& outs) {
+		LOG(ERROR) << "Not Impl Yet Operator DenseAct< Ttype("
+				   << target_name<Ttype>::value << "), Precision("<< Ptype <<") >";	
+    }
+
+    friend class DenseActHelper<Ttype, Ptype>;
+};
+
+/// the fusion patterns run by DenseAct
+template<typename Ttype, Precision Ptype>
+using DenseRelu = DenseAct<Ttype, Ptype>;
+template<typename Ttype, Precision Ptype>
+using DenseActivation = DenseAct<Ttype, Ptype>;
+
+/**
+ * \brief DenseAct helper class to implement it
+ * public inherit OperatorHelper
+ * including init resource and shape size in DenseActHelper context
+ */
+template<typename Ttype, Precision Ptype>
+class DenseActHelper : public OperatorHelper<Ttype, Ptype> {
+public:
+    DenseActHelper()=default;
+
+    ~DenseActHelper() {}
+
+    Status InitParam() override;
+
+    /**
+    * \brief initial all the resource needed by DenseAct
+    * \param ctx stand for DenseAct operation context
+    * \param ins stand for input tensor vector
+    * \param outs stand for output tensor vector
+    * \return status
+    */
+    Status Init(OpContext<Ttype> &ctx,
+                const std::vector<Tensor4dPtr<Ttype> >& ins, 
+                std::vector<Tensor4dPtr<Ttype> >& outs) override;
+
+    /**
+    * \brief infer the shape of output and input.
+    * \param ins stand for input tensor vector
+    * \param outs stand for output tensor vector
+    * \return status
+    */
+    Status InferShape(const std::vector<Tensor4dPtr<Ttype> >& ins,
+                      std::vector<Tensor4dPtr<Ttype> >& outs) override;
+
+public:
+    ///< _param_dense stand for Dense parameter with the activation of the epilogue
+    saber::FcParam<Ttype> _param_dense;
+    ///< _funcs_dense stand for Dense function
+    saber::Fc<Ttype, PrecisionWrapper<Ptype>::saber_type> _funcs_dense;
+};
+
+} /* namespace ops */
+
+} /* namespace anakin */
+
+#endif
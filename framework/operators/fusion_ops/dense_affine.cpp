@@ -0,0 +1,201 @@
+#include "framework/operators/fusion_ops/dense_affine.h"
+
+namespace anakin {
+
+namespace ops {
+
+#define INSTANCE_DENSEAFFINE(Ttype, Ptype) \
+template<> \
+void DenseAffine<Ttype, Ptype>::operator()(\
+    OpContext<Ttype>& ctx,\
+    const std::vector<Tensor4dPtr<Ttype> >& ins,\
+    std::vector<Tensor4dPtr<Ttype> >& outs) {\
+    auto* impl = static_cast<DenseAffineHelper<Ttype, Ptype>*>(this->_helper);\
+    SABER_CHECK(impl->_funcs_dense(ins, outs, impl->_param_dense, ctx));\
+    if (impl->_has_tail_scale) {\
+        SABER_CHECK(impl->_funcs_tail_scale(outs, outs, impl->_param_tail_scale, ctx));\
+    }\
+}
+
+template<typename Ttype, Precision Ptype>
+Status DenseAffineHelper<Ttype, Ptype>::InitParam() {
+    DLOG(WARNING) << "Parsing DenseAffine op parameter.";
+
+    // get dense param
+    auto axis = GET_PARAMETER(int, axis);
+    auto out_dim = GET_PARAMETER_WITH_DEFAULT(int, out_dim, 0);
+    auto bias_term = GET_PARAMETER(bool, bias_term);
+    auto dynamic_quant = GET_PARAMETER_WITH_DEFAULT(bool, dynamic_quant, false);
+
+    using pblock_type = PBlock<Ttype>;
+    auto weights = GET_PARAMETER(pblock_type, weight_1);
+
+    // the per output channel y = alpha * x + beta of the merged ops
+    std::vector<float> alpha{1.f};
+    std::vector<float> beta{0.f};
+
+    if (FIND_PARAMETER(batchnorm_0_epsilon)) {
+        auto epsilon = GET_PARAMETER(float, batchnorm_0_epsilon);
+        auto batch_norm_weight_1 = GET_PARAMETER(pblock_type, batchnorm_0_weight_1);
+        auto batch_norm_weight_2 = GET_PARAMETER(pblock_type, batchnorm_0_weight_2);
+        auto batch_norm_weight_3 = GET_PARAMETER(pblock_type, batchnorm_0_weight_3);
+        std::vector<float> batchnorm_alpha;
+        std::vector<float> batchnorm_beta;
+        batchnorm_to_affine(batch_norm_weight_3.vector()[0], epsilon,
+                            batch_norm_weight_1.vector(), batch_norm_weight_2.vector(),
+                            batchnorm_alpha, batchnorm_beta);
+        append_affine(alpha, beta, batchnorm_alpha, batchnorm_beta);
+    }
+
+    if (FIND_PARAMETER(scale_0_weight_1)) {
+        auto scale_axis = GET_PARAMETER(int, scale_0_axis);
+        auto scale_num_axes = GET_PARAMETER(int, scale_0_num_axes);
+        auto scale_bias_term = GET_PARAMETER(bool, scale_0_bias_term);
+        auto scale_w = GET_PARAMETER(pblock_type, scale_0_weight_1).vector();
+        std::vector<float> scale_b;
+        if (scale_bias_term) {
+            scale_b = GET_PARAMETER(pblock_type, scale_0_weight_2).vector();
+        }
+        // the fc output is {m, n, 1, 1}, only a scale over the channel axis
+        // or a scalar scale can be folded
+        if (scale_num_axes == 0 || (scale_axis == 1 && scale_num_axes == 1)) {
+            append_affine(alpha, beta, scale_w, scale_b);
+        } else {
+            _has_tail_scale = true;
+            _param_tail_scale = saber::ScaleParam<Ttype>(scale_w, scale_b, scale_bias_term,
+                                                         scale_axis, scale_num_axes);
+        }
+    }
+
+    if (FIND_PARAMETER(affine_channel_0_weight_1)) {
+        auto affine_channel_w = GET_PARAMETER(pblock_type, affine_channel_0_weight_1);
+        auto affine_channel_b = GET_PARAMETER(pblock_type, affine_channel_0_weight_2);
+        append_affine(alpha, beta, affine_channel_w.vector(), affine_channel_b.vector());
+    }
+
+    // check if the affine has been folded into the weights
+    auto is_param_updated = CHECK_PARAMETER(is_param_updated);
+    if (!is_param_updated) {
+        SET_PARAMETER(is_param_updated, true, bool);
+        int n = out_dim;
+        if (n <= 0 && bias_term) {
+            n = GET_PARAMETER(pblock_type, weight_2).count();
+        }
+        if (n <= 0) {
+            n = static_cast<int>(std::max(alpha.size(), beta.size()));
+        }
+        int k = weights.count() / n;
+        CHECK_EQ(k * n, weights.count()) << "DenseAffine can not get the output dim of "
+                                         << weights.count() << " weights";
+        CHECK(alpha.size() == 1 || static_cast<int>(alpha.size()) == n) << "DenseAffine channel " << alpha.size()
+                                                      << " mismatch output dim " << n;
+
+        if (bias_term) {
+            auto bias = GET_PARAMETER(pblock_type, weight_2);
+            graph::GraphGlobalMem<Ttype>::Global().template apply<Level_0>(
+                    WeightsFusion<float, Ttype>::update_fc_weights, weights, bias,
+                    k, n, true, alpha, beta);
+            _param_dense = saber::FcParam<Ttype>(&(weights.d_tensor()), &(bias.d_tensor()),
+                                                 out_dim, axis);
+        } else {
+            pblock_type* bias = new pblock_type();
+            SET_PARAMETER(bias_term, true, bool); // set attr bias_term true
+            SET_PARAMETER(weight_2, *bias, pblock_type); // gen new bias
+            graph::GraphGlobalMem<Ttype>::Global().template apply<Level_0>(
+                    WeightsFusion<float, Ttype>::update_fc_weights, weights, *bias,
+                    k, n, false, alpha, beta);
+            _param_dense = saber::FcParam<Ttype>(&(weights.d_tensor()), &(bias->d_tensor()),
+                                                 out_dim, axis);
+        }
+    } else {
+        auto bias = GET_PARAMETER(pblock_type, weight_2);
+        _param_dense = saber::FcParam<Ttype>(&(weights.d_tensor()), &(bias.d_tensor()),
+                                             out_dim, axis);
+    }
+    _param_dense.dynamic_quant = dynamic_quant;
+    return Status::OK();
+}
+
+template<typename Ttype, Precision Ptype>
+Status DenseAffineHelper<Ttype, Ptype>::Init(OpContext<Ttype>& ctx,
+        const std::vector<Tensor4dPtr<Ttype> >& ins,
+        std::vector<Tensor4dPtr<Ttype> >& outs) {
+    SABER_CHECK(_funcs_dense.init(ins, outs, _param_dense, SPECIFY, VENDER_IMPL, ctx));
+    if (_has_tail_scale) {
+        SABER_CHECK(_funcs_tail_scale.init(outs, outs, _param_tail_scale, SPECIFY, SABER_IMPL, ctx));
+    }
+    return Status::OK();
+}
+
+template<typename Ttype, Precision Ptype>
+Status DenseAffineHelper<Ttype, Ptype>::InferShape(const
+        std::vector<Tensor4dPtr<Ttype> >& ins,
+        std::vector<Tensor4dPtr<Ttype> >& outs) {
+    SABER_CHECK(_funcs_dense.compute_output_shape(ins, outs, _param_dense));
+    return Status::OK();
+}
+
+#if defined USE_X86_PLACE || defined BUILD_LITE
+INSTANCE_DENSEAFFINE(X86, Precision::FP32);
+template class DenseAffineHelper<X86, Precision::FP32>;
+ANAKIN_REGISTER_OP_HELPER(DenseBatchnormScale, DenseAffineHelper, X86, Precision::FP32);
+ANAKIN_REGISTER_OP_HELPER(DenseBatchnorm, DenseAffineHelper, X86, Precision::FP32);
+ANAKIN_REGISTER_OP_HELPER(DenseScale, DenseAffineHelper, X86, Precision::FP32);
+ANAKIN_REGISTER_OP_HELPER(DenseAffineChannel, DenseAffineHelper, X86, Precision::FP32);
+#endif
+
+//! register op
+ANAKIN_REGISTER_OP(DenseBatchnormScale)
+.Doc("DenseBatchnormScale fusion operator")
+#if defined USE_X86_PLACE || defined BUILD_LITE
+.__alias__<X86, Precision::FP32>("fc_batchnorm_scale")
+#endif
+.num_in(1)
+.num_out(1)
+.Args<int>("axis", "axis to compute")
+.Args<int>("out_dim", "out dim")
+.Args<bool>("bias_term", "whether fc weights have bias")
+.Args<float>("batchnorm_0_epsilon", "epsilon for batchnorm")
+.Args<int>("scale_0_axis", "axis for scale")
+.Args<bool>("scale_0_bias_term", "whether scale has bias");
+
+ANAKIN_REGISTER_OP(DenseBatchnorm)
+.Doc("DenseBatchnorm fusion operator")
+#if defined USE_X86_PLACE || defined BUILD_LITE
+.__alias__<X86, Precision::FP32>("fc_batchnorm")
+#endif
+.num_in(1)
+.num_out(1)
+.Args<int>("axis", "axis to compute")
+.Args<int>("out_dim", "out dim")
+.Args<bool>("bias_term", "whether fc weights have bias")
+.Args<float>("batchnorm_0_epsilon", "epsilon for batchnorm");
+
+ANAKIN_REGISTER_OP(DenseScale)
+.Doc("DenseScale fusion operator")
+#if defined USE_X86_PLACE || defined BUILD_LITE
+.__alias__<X86, Precision::FP32>("fc_scale")
+#endif
+.num_in(1)
+.num_out(1)
+.Args<int>("axis", "axis to compute")
+.Args<int>("out_dim", "out dim")
+.Args<bool>("bias_term", "whether fc weights have bias")
+.Args<int>("scale_0_axis", "axis for scale")
+.Args<bool>("scale_0_bias_term", "whether scale has bias");
+
+ANAKIN_REGISTER_OP(DenseAffineChannel)
+.Doc("DenseAffineChannel fusion operator")
+#if defined USE_X86_PLACE || defined BUILD_LITE
+.__alias__<X86, Precision::FP32>("fc_affine_channel")
+#endif
+.num_in(1)
+.num_out(1)
+.Args<int>("axis", "axis to compute")
+.Args<int>("out_dim", "out dim")
+.Args<bool>("bias_term", "whether fc weights have bias");
+
+} /* namespace ops */
+
+} /* namespace anakin */
+
@@ -0,0 +1,114 @@
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+   
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License. 
+*/
+
+#ifndef ANAKIN_OPERATOR_DENSE_AFFINE_H
+#define ANAKIN_OPERATOR_DENSE_AFFINE_H
+
+#include "framework/core/base.h"
+#include "framework/core/data_types.h"
+#include "framework/core/operator/operator.h"
+#include "utils/logger/logger.h"
+#include "saber/funcs/fc.h"
+#include "saber/funcs/scale.h"
+
+namespace anakin {
+
+namespace ops {
+
+template<typename Ttype, Precision Ptype>
+class DenseAffineHelper;
+
+/**
+ * \brief DenseAffine implementation class, a Dense followed by BatchNorm,
+ *  Scale or AffineChannel with the per output channel affine folded into
+ *  the fc weights and bias
+ * public inherit Operator
+ */
+template<typename Ttype, Precision Ptype>
+class DenseAffine : public Operator<Ttype, Ptype> {
+public:
+    DenseAffine() {}
+
+    /// forward impl
+    virtual void operator() (OpContext<Ttype> &ctx, 
+                             const std::vector<Tensor4dPtr<Ttype> >& ins, 
+                             std::vector<Tensor4dPtr<Ttype> >& outs) {
+		LOG(ERROR) << "Not Impl Yet Operator DenseAffine< Ttype("
+				   << target_name<Ttype>::value << "), Precision("<< Ptype <<") >";	
+    }
+
+    friend class DenseAffineHelper<Ttype, Ptype>;
+};
+
+/// the fusion patterns folded by DenseAffine
+template<typename Ttype, Precision Ptype>
+using DenseBatchnormScale = DenseAffine<Ttype, Ptype>;
+template<typename Ttype, Precision Ptype>
+using DenseBatchnorm = DenseAffine<Ttype, Ptype>;
+template<typename Ttype, Precision Ptype>
+using DenseScale = DenseAffine<Ttype, Ptype>;
+template<typename Ttype, Precision Ptype>
+using DenseAffineChannel = DenseAffine<Ttype, Ptype>;
+
+/**
+ * \brief DenseAffine helper class to implement it
+ * public inherit OperatorHelper
+ * including init resource and shape size in DenseAffineHelper context
+ */
+template<typename Ttype, Precision Ptype>
+class DenseAffineHelper : public OperatorHelper<Ttype, Ptype> {
+public:
+    DenseAffineHelper()=default;
+
+    ~DenseAffineHelper() {}
+
+    Status InitParam() override;
+
+    /**
+    * \brief initial all the resource needed by DenseAffine
+    * \param ctx stand for DenseAffine operation context
+    * \param ins stand for input tensor vector
+    * \param outs stand for output tensor vector
+    * \return status
+    */
+    Status Init(OpContext<Ttype> &ctx,
+                const std::vector<Tensor4dPtr<Ttype> >& ins, 
+                std::vector<Tensor4dPtr<Ttype> >& outs) override;
+
+    /**
+    * \brief infer the shape of output and input.
+    * \param ins stand for input tensor vector
+    * \param outs stand for output tensor vector
+    * \return status
+    */
+    Status InferShape(const std::vector<Tensor4dPtr<Ttype> >& ins,
+                      std::vector<Tensor4dPtr<Ttype> >& outs) override;
+
+public:
+    ///< _param_dense stand for Dense parameter with the folded weights
+    saber::FcParam<Ttype> _param_dense;
+    ///< _funcs_dense stand for Dense function
+    saber::Fc<Ttype, PrecisionWrapper<Ptype>::saber_type> _funcs_dense;
+    ///< a merged Scale which is not per output channel runs in place after the fc
+    bool _has_tail_scale{false};
+    saber::ScaleParam<Ttype> _param_tail_scale;
+    saber::Scale<Ttype, PrecisionWrapper<Ptype>::saber_type> _funcs_tail_scale;
+};
+
+} /* namespace ops */
+
+} /* namespace anakin */
+
+#endif
@@ -0,0 +1,145 @@
+#include "framework/operators/fusion_ops/mat_mul_affine.h"
+
+namespace anakin {
+
+namespace ops {
+
+#define INSTANCE_MATMULAFFINE(Ttype, Ptype) \
+template<> \
+void MatMulAffine<Ttype, Ptype>::operator()(\
+    OpContext<Ttype>& ctx,\
+    const std::vector<Tensor4dPtr<Ttype> >& ins,\
+    std::vector<Tensor4dPtr<Ttype> >& outs) {\
+    auto* impl = static_cast<MatMulAffineHelper<Ttype, Ptype>*>(this->_helper);\
+    SABER_CHECK(impl->_funcs_mat_mul(ins, outs, impl->_param_mat_mul, ctx));\
+    if (impl->_has_tail_scale) {\
+        SABER_CHECK(impl->_funcs_tail_scale(outs, outs, impl->_param_tail_scale, ctx));\
+    }\
+    if (impl->_has_tail_power) {\
+        SABER_CHECK(impl->_funcs_tail_power(outs, outs, impl->_param_tail_power, ctx));\
+    }\
+}
+
+template<typename Ttype, Precision Ptype>
+Status MatMulAffineHelper<Ttype, Ptype>::InitParam() {
+    DLOG(WARNING) << "Parsing MatMulAffine op parameter.";
+    using pblock_type = PBlock<Ttype>;
+
+    // get matmul param
+    auto transpose_x = GET_PARAMETER(bool, transpose_x);
+    auto transpose_y = GET_PARAMETER(bool, transpose_y);
+    auto coeff = GET_PARAMETER(float, coeff);
+    auto dynamic_quant = GET_PARAMETER_WITH_DEFAULT(bool, dynamic_quant, false);
+    auto const_y = GET_PARAMETER_WITH_DEFAULT(bool, const_y, false);
+
+    // the matmul has no weights, only a scalar factor folds into coeff and
+    // the rest of the merged op runs in place on the output
+    if (FIND_PARAMETER(scale_0_weight_1)) {
+        auto scale_axis = GET_PARAMETER(int, scale_0_axis);
+        auto scale_num_axes = GET_PARAMETER(int, scale_0_num_axes);
+        auto scale_bias_term = GET_PARAMETER(bool, scale_0_bias_term);
+        auto scale_w = GET_PARAMETER(pblock_type, scale_0_weight_1).vector();
+        std::vector<float> scale_b;
+        if (scale_bias_term) {
+            scale_b = GET_PARAMETER(pblock_type, scale_0_weight_2).vector();
+        }
+        if (scale_w.size() == 1 && scale_b.size() <= 1) {
+            coeff *= scale_w[0];
+            if (!scale_b.empty() && scale_b[0] != 0.f) {
+                _has_tail_power = true;
+                _param_tail_power = saber::PowerParam<Ttype>(1.f, 1.f, scale_b[0]);
+            }
+        } else {
+            _has_tail_scale = true;
+            _param_tail_scale = saber::ScaleParam<Ttype>(scale_w, scale_b, scale_bias_term,
+                                                         scale_axis, scale_num_axes);
+        }
+    }
+
+    if (FIND_PARAMETER(power_0_power)) {
+        auto power = GET_PARAMETER(float, power_0_power);
+        auto scale = GET_PARAMETER(float, power_0_scale);
+        auto shift = GET_PARAMETER(float, power_0_shift);
+        // (shift + scale * coeff * x * y)^power
+        coeff *= scale;
+        if (power != 1.f || shift != 0.f) {
+            _has_tail_power = true;
+            _param_tail_power = saber::PowerParam<Ttype>(power, 1.f, shift);
+        }
+    }
+
+    saber::MatMulParam<Ttype> param_mat_mul(transpose_x, transpose_y, coeff);
+    param_mat_mul._dynamic_quant = dynamic_quant;
+    param_mat_mul._const_y = const_y;
+    if (FIND_PARAMETER(x_axes)) {
+        param_mat_mul._x_axes = GET_PARAMETER(PTuple<int>, x_axes).vector();
+    }
+    if (FIND_PARAMETER(y_axes)) {
+        param_mat_mul._y_axes = GET_PARAMETER(PTuple<int>, y_axes).vector();
+    }
+    CHECK(param_mat_mul.valid_axes()) << "mat mul x_axes and y_axes must be a permutation of 0, 1, 2, 3";
+    _param_mat_mul = param_mat_mul;
+    return Status::OK();
+}
+
+template<typename Ttype, Precision Ptype>
+Status MatMulAffineHelper<Ttype, Ptype>::Init(OpContext<Ttype>& ctx,
+        const std::vector<Tensor4dPtr<Ttype> >& ins,
+        std::vector<Tensor4dPtr<Ttype> >& outs) {
+    SABER_CHECK(_funcs_mat_mul.init(ins, outs, _param_mat_mul, SPECIFY, SABER_IMPL, ctx));
+    if (_has_tail_scale) {
+        SABER_CHECK(_funcs_tail_scale.init(outs, outs, _param_tail_scale, SPECIFY, SABER_IMPL, ctx));
+    }
+    if (_has_tail_power) {
+        SABER_CHECK(_funcs_tail_power.init(outs, outs, _param_tail_power, SPECIFY, SABER_IMPL, ctx));
+    }
+    return Status::OK();
+}
+
+template<typename Ttype, Precision Ptype>
+Status MatMulAffineHelper<Ttype, Ptype>::InferShape(const
+        std::vector<Tensor4dPtr<Ttype> >& ins,
+        std::vector<Tensor4dPtr<Ttype> >& outs) {
+    SABER_CHECK(_funcs_mat_mul.compute_output_shape(ins, outs, _param_mat_mul));
+    return Status::OK();
+}
+
+#if defined USE_X86_PLACE || defined BUILD_LITE
+INSTANCE_MATMULAFFINE(X86, Precision::FP32);
+template class MatMulAffineHelper<X86, Precision::FP32>;
+ANAKIN_REGISTER_OP_HELPER(MatMulScale, MatMulAffineHelper, X86, Precision::FP32);
+ANAKIN_REGISTER_OP_HELPER(MatMulPower, MatMulAffineHelper, X86, Precision::FP32);
+#endif
+
+//! register op
+ANAKIN_REGISTER_OP(MatMulScale)
+.Doc("MatMulScale fusion operator")
+#if defined USE_X86_PLACE || defined BUILD_LITE
+.__alias__<X86, Precision::FP32>("mat_mul_scale")
+#endif
+.num_in(2)
+.num_out(1)
+.Args<bool>("transpose_x", "Is X transpose or not")
+.Args<bool>("transpose_y", "Is Y transpose or not")
+.Args<float>("coeff", "coeff of the matmul")
+.Args<int>("scale_0_axis", "axis for scale")
+.Args<bool>("scale_0_bias_term", "whether scale has bias");
+
+ANAKIN_REGISTER_OP(MatMulPower)
+.Doc("MatMulPower fusion operator")
+#if defined USE_X86_PLACE || defined BUILD_LITE
+.__alias__<X86, Precision::FP32>("mat_mul_power")
+#endif
+.num_in(2)
+.num_out(1)
+.Args<bool>("transpose_x", "Is X transpose or not")
+.Args<bool>("transpose_y", "Is Y transpose or not")
+.Args<float>("coeff", "coeff of the matmul")
+.Args<float>("power_0_scale", "scale of power")
+.Args<float>("power_0_shift", "shift of power")
+.Args<float>("power_0_power", "power of power");
+
+} /* namespace ops */
+
+} /* namespace anakin */
+
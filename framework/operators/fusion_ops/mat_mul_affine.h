@@ -0,0 +1,114 @@
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+   
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License. 
+*/
+
+#ifndef ANAKIN_OPERATOR_MAT_MUL_AFFINE_H
+#define ANAKIN_OPERATOR_MAT_MUL_AFFINE_H
+
+#include "framework/core/base.h"
+#include "framework/core/data_types.h"
+#include "framework/core/operator/operator.h"
+#include "utils/logger/logger.h"
+#include "saber/funcs/mat_mul.h"
+#include "saber/funcs/scale.h"
+#include "saber/funcs/power.h"
+
+namespace anakin {
+
+namespace ops {
+
+template<typename Ttype, Precision Ptype>
+class MatMulAffineHelper;
+
+/**
+ * \brief MatMulAffine implementation class, a MatMul followed by Scale or
+ *  Power, the scalar factor of the merged op is folded into the matmul coeff
+ * public inherit Operator
+ */
+template<typename Ttype, Precision Ptype>
+class MatMulAffine : public Operator<Ttype, Ptype> {
+public:
+    MatMulAffine() {}
+
+    /// forward impl
+    virtual void operator() (OpContext<Ttype> &ctx, 
+                             const std::vector<Tensor4dPtr<Ttype> >& ins, 
+                             std::vector<Tensor4dPtr<Ttype> >& outs) {
+		LOG(ERROR) << "Not Impl Yet Operator MatMulAffine< Ttype("
+				   << target_name<Ttype>::value << "), Precision("<< Ptype <<") >";	
+    }
+
+    friend class MatMulAffineHelper<Ttype, Ptype>;
+};
+
+/// the fusion patterns folded by MatMulAffine
+template<typename Ttype, Precision Ptype>
+using MatMulScale = MatMulAffine<Ttype, Ptype>;
+template<typename Ttype, Precision Ptype>
+using MatMulPower = MatMulAffine<Ttype, Ptype>;
+
+/**
+ * \brief MatMulAffine helper class to implement it
+ * public inherit OperatorHelper
+ * including init resource and shape size in MatMulAffineHelper context
+ */
+template<typename Ttype, Precision Ptype>
+class MatMulAffineHelper : public OperatorHelper<Ttype, Ptype> {
+public:
+    MatMulAffineHelper()=default;
+
+    ~MatMulAffineHelper() {}
+
+    Status InitParam() override;
+
+    /**
+    * \brief initial all the resource needed by MatMulAffine
+    * \param ctx stand for MatMulAffine operation context
+    * \param ins stand for input tensor vector
+    * \param outs stand for output tensor vector
+    * \return status
+    */
+    Status Init(OpContext<Ttype> &ctx,
+                const std::vector<Tensor4dPtr<Ttype> >& ins, 
+                std::vector<Tensor4dPtr<Ttype> >& outs) override;
+
+    /**
+    * \brief infer the shape of output and input.
+    * \param ins stand for input tensor vector
+    * \param outs stand for output tensor vector
+    * \return status
+    */
+    Status InferShape(const std::vector<Tensor4dPtr<Ttype> >& ins,
+                      std::vector<Tensor4dPtr<Ttype> >& outs) override;
+
+public:
+    ///< _param_mat_mul stand for MatMul parameter with the folded coeff
+    saber::MatMulParam<Ttype> _param_mat_mul;
+    ///< _funcs_mat_mul stand for MatMul function
+    saber::MatMul<Ttype, PrecisionWrapper<Ptype>::saber_type> _funcs_mat_mul;
+    ///< a per channel Scale can not be folded and runs in place after the matmul
+    bool _has_tail_scale{false};
+    saber::ScaleParam<Ttype> _param_tail_scale;
+    saber::Scale<Ttype, PrecisionWrapper<Ptype>::saber_type> _funcs_tail_scale;
+    ///< the shift and power left after folding the scale runs in place after the matmul
+    bool _has_tail_power{false};
+    saber::PowerParam<Ttype> _param_tail_power;
+    saber::Power<Ttype, PrecisionWrapper<Ptype>::saber_type> _funcs_tail_power;
+};
+
+} /* namespace ops */
+
+} /* namespace anakin */
+
+#endif
@@ -0,0 +1,171 @@
+#include "framework/operators/fusion_ops/scale_chain.h"
+
+namespace anakin {
+
+namespace ops {
+
+#define INSTANCE_SCALECHAIN(Ttype, Ptype) \
+template<> \
+void ScaleChain<Ttype, Ptype>::operator()(\
+    OpContext<Ttype>& ctx,\
+    const std::vector<Tensor4dPtr<Ttype> >& ins,\
+    std::vector<Tensor4dPtr<Ttype> >& outs) {\
+    auto* impl = static_cast<ScaleChainHelper<Ttype, Ptype>*>(this->_helper);\
+    if (impl->_head_is_power) {\
+        SABER_CHECK(impl->_funcs_power(ins, outs, impl->_param_power, ctx));\
+    } else {\
+        SABER_CHECK(impl->_funcs_scale(ins, outs, impl->_param_scale, ctx));\
+    }\
+    if (impl->_has_tail_scale) {\
+        SABER_CHECK(impl->_funcs_tail_scale(outs, outs, impl->_param_tail_scale, ctx));\
+    }\
+}
+
+template<typename Ttype, Precision Ptype>
+Status ScaleChainHelper<Ttype, Ptype>::InitParam() {
+    DLOG(WARNING) << "Parsing ScaleChain op parameter.";
+    using pblock_type = PBlock<Ttype>;
+
+    // the first op, a Power with power 1 is a scalar affine
+    std::vector<float> head_w;
+    std::vector<float> head_b;
+    int head_axis = 1;
+    int head_num_axes = 1;
+    bool head_affine = true;
+    if (FIND_PARAMETER(power)) {
+        auto power = GET_PARAMETER(float, power);
+        auto scale = GET_PARAMETER(float, scale);
+        auto shift = GET_PARAMETER(float, shift);
+        _param_power = saber::PowerParam<Ttype>(power, scale, shift);
+        head_w = {scale};
+        head_b = {shift};
+        head_affine = power == 1.f;
+    } else {
+        head_axis = GET_PARAMETER(int, axis);
+        head_num_axes = GET_PARAMETER(int, num_axes);
+        head_w = GET_PARAMETER(pblock_type, weight_1).vector();
+        if (GET_PARAMETER(bool, bias_term)) {
+            head_b = GET_PARAMETER(pblock_type, weight_2).vector();
+        }
+    }
+
+    // the second Scale, named scale_1 after a Scale and scale_0 after a Power
+    std::vector<float> tail_w;
+    std::vector<float> tail_b;
+    int tail_axis = 1;
+    int tail_num_axes = 1;
+    bool tail_bias_term = false;
+    if (FIND_PARAMETER(scale_1_weight_1)) {
+        tail_axis = GET_PARAMETER(int, scale_1_axis);
+        tail_num_axes = GET_PARAMETER(int, scale_1_num_axes);
+        tail_bias_term = GET_PARAMETER(bool, scale_1_bias_term);
+        tail_w = GET_PARAMETER(pblock_type, scale_1_weight_1).vector();
+        if (tail_bias_term) {
+            tail_b = GET_PARAMETER(pblock_type, scale_1_weight_2).vector();
+        }
+    } else {
+        tail_axis = GET_PARAMETER(int, scale_0_axis);
+        tail_num_axes = GET_PARAMETER(int, scale_0_num_axes);
+        tail_bias_term = GET_PARAMETER(bool, scale_0_bias_term);
+        tail_w = GET_PARAMETER(pblock_type, scale_0_weight_1).vector();
+        if (tail_bias_term) {
+            tail_b = GET_PARAMETER(pblock_type, scale_0_weight_2).vector();
+        }
+    }
+
+    // the two affines compose when one is a scalar or both cover the same axes
+    bool head_scalar = head_w.size() == 1 && head_b.size() <= 1;
+    bool tail_scalar = tail_w.size() == 1 && tail_b.size() <= 1;
+    bool same_axes = head_axis == tail_axis && head_num_axes == tail_num_axes
+                     && head_w.size() == tail_w.size()
+                     && (head_b.empty() || head_b.size() == head_w.size())
+                     && (tail_b.empty() || tail_b.size() == tail_w.size());
+    bool composable = head_affine && (head_scalar || tail_scalar || same_axes);
+
+    if (composable) {
+        // a Power has no axes, a scalar Scale takes the axes of the other one
+        bool tail_axes = FIND_PARAMETER(power) || (head_scalar && !tail_scalar);
+        int axis = tail_axes ? tail_axis : head_axis;
+        int num_axes = tail_axes ? tail_num_axes : head_num_axes;
+        std::vector<float> alpha = head_w;
+        std::vector<float> beta = head_b;
+        append_affine(alpha, beta, tail_w, tail_b);
+        _param_scale = saber::ScaleParam<Ttype>(alpha, beta, true, axis, num_axes);
+    } else {
+        _head_is_power = FIND_PARAMETER(power);
+        if (!_head_is_power) {
+            _param_scale = saber::ScaleParam<Ttype>(head_w, head_b, !head_b.empty(),
+                                                    head_axis, head_num_axes);
+        }
+        _has_tail_scale = true;
+        _param_tail_scale = saber::ScaleParam<Ttype>(tail_w, tail_b, tail_bias_term,
+                                                     tail_axis, tail_num_axes);
+    }
+    return Status::OK();
+}
+
+template<typename Ttype, Precision Ptype>
+Status ScaleChainHelper<Ttype, Ptype>::Init(OpContext<Ttype>& ctx,
+        const std::vector<Tensor4dPtr<Ttype> >& ins,
+        std::vector<Tensor4dPtr<Ttype> >& outs) {
+    if (_head_is_power) {
+        SABER_CHECK(_funcs_power.init(ins, outs, _param_power, SPECIFY, SABER_IMPL, ctx));
+    } else {
+        SABER_CHECK(_funcs_scale.init(ins, outs, _param_scale, SPECIFY, SABER_IMPL, ctx));
+    }
+    if (_has_tail_scale) {
+        SABER_CHECK(_funcs_tail_scale.init(outs, outs, _param_tail_scale, SPECIFY, SABER_IMPL, ctx));
+    }
+    return Status::OK();
+}
+
+template<typename Ttype, Precision Ptype>
+Status ScaleChainHelper<Ttype, Ptype>::InferShape(const
+        std::vector<Tensor4dPtr<Ttype> >& ins,
+        std::vector<Tensor4dPtr<Ttype> >& outs) {
+    if (_head_is_power) {
+        SABER_CHECK(_funcs_power.compute_output_shape(ins, outs, _param_power));
+    } else {
+        SABER_CHECK(_funcs_scale.compute_output_shape(ins, outs, _param_scale));
+    }
+    return Status::OK();
+}
+
+#if defined USE_X86_PLACE || defined BUILD_LITE
+INSTANCE_SCALECHAIN(X86, Precision::FP32);
+template class ScaleChainHelper<X86, Precision::FP32>;
+ANAKIN_REGISTER_OP_HELPER(ScaleScale, ScaleChainHelper, X86, Precision::FP32);
+ANAKIN_REGISTER_OP_HELPER(PowerScale, ScaleChainHelper, X86, Precision::FP32);
+#endif
+
+//! register op
+ANAKIN_REGISTER_OP(ScaleScale)
+.Doc("ScaleScale fusion operator")
+#if defined USE_X86_PLACE || defined BUILD_LITE
+.__alias__<X86, Precision::FP32>("scale_scale")
+#endif
+.num_in(1)
+.num_out(1)
+.Args<int>("axis", "axis of the first scale")
+.Args<int>("num_axes", "num axes of the first scale")
+.Args<bool>("bias_term", "whether the first scale has bias")
+.Args<int>("scale_1_axis", "axis of the second scale")
+.Args<bool>("scale_1_bias_term", "whether the second scale has bias");
+
+ANAKIN_REGISTER_OP(PowerScale)
+.Doc("PowerScale fusion operator")
+#if defined USE_X86_PLACE || defined BUILD_LITE
+.__alias__<X86, Precision::FP32>("power_scale")
+#endif
+.num_in(1)
+.num_out(1)
+.Args<float>("scale", "scale of power")
+.Args<float>("shift", "shift of power")
+.Args<float>("power", "power of power")
+.Args<int>("scale_0_axis", "axis of the scale")
+.Args<bool>("scale_0_bias_term", "whether the scale has bias");
+
+} /* namespace ops */
+
+} /* namespace anakin */
+
@@ -0,0 +1,112 @@
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+   
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License. 
+*/
+
+#ifndef ANAKIN_OPERATOR_SCALE_CHAIN_H
+#define ANAKIN_OPERATOR_SCALE_CHAIN_H
+
+#include "framework/core/base.h"
+#include "framework/core/data_types.h"
+#include "framework/core/operator/operator.h"
+#include "utils/logger/logger.h"
+#include "saber/funcs/scale.h"
+#include "saber/funcs/power.h"
+
+namespace anakin {
+
+namespace ops {
+
+template<typename Ttype, Precision Ptype>
+class ScaleChainHelper;
+
+/**
+ * \brief ScaleChain implementation class, a Scale or Power followed by a
+ *  Scale, the two affines are composed into one Scale when they line up
+ * public inherit Operator
+ */
+template<typename Ttype, Precision Ptype>
+class ScaleChain : public Operator<Ttype, Ptype> {
+public:
+    ScaleChain() {}
+
+    /// forward impl
+    virtual void operator() (OpContext<Ttype> &ctx, 
+                             const std::vector<Tensor4dPtr<Ttype> >& ins, 
+                             std::vector<Tensor4dPtr<Ttype> >& outs) {
+		LOG(ERROR) << "Not Impl Yet Operator ScaleChain< Ttype("
+				   << target_name<Ttype>::value << "), Precision("<< Ptype <<") >";	
+    }
+
+    friend class ScaleChainHelper<Ttype, Ptype>;
+};
+
+/// the fusion patterns folded by ScaleChain
+template<typename Ttype, Precision Ptype>
+using ScaleScale = ScaleChain<Ttype, Ptype>;
+template<typename Ttype, Precision Ptype>
+using PowerScale = ScaleChain<Ttype, Ptype>;
+
+/**
+ * \brief ScaleChain helper class to implement it
+ * public inherit OperatorHelper
+ * including init resource and shape size in ScaleChainHelper context
+ */
+template<typename Ttype, Precision Ptype>
+class ScaleChainHelper : public OperatorHelper<Ttype, Ptype> {
+public:
+    ScaleChainHelper()=default;
+
+    ~ScaleChainHelper() {}
+
+    Status InitParam() override;
+
+    /**
+    * \brief initial all the resource needed by ScaleChain
+    * \param ctx stand for ScaleChain operation context
+    * \param ins stand for input tensor vector
+    * \param outs stand for output tensor vector
+    * \return status
+    */
+    Status Init(OpContext<Ttype> &ctx,
+                const std::vector<Tensor4dPtr<Ttype> >& ins, 
+                std::vector<Tensor4dPtr<Ttype> >& outs) override;
+
+    /**
+    * \brief infer the shape of output and input.
+    * \param ins stand for input tensor vector
+    * \param outs stand for output tensor vector
+    * \return status
+    */
+    Status InferShape(const std::vector<Tensor4dPtr<Ttype> >& ins,
+                      std::vector<Tensor4dPtr<Ttype> >& outs) override;
+
+public:
+    ///< the first op is a Power which could not be composed
+    bool _head_is_power{false};
+    ///< _param_scale stand for the composed Scale or the first Scale
+    saber::ScaleParam<Ttype> _param_scale;
+    saber::Scale<Ttype, PrecisionWrapper<Ptype>::saber_type> _funcs_scale;
+    saber::PowerParam<Ttype> _param_power;
+    saber::Power<Ttype, PrecisionWrapper<Ptype>::saber_type> _funcs_power;
+    ///< the second Scale runs in place when it could not be composed
+    bool _has_tail_scale{false};
+    saber::ScaleParam<Ttype> _param_tail_scale;
+    saber::Scale<Ttype, PrecisionWrapper<Ptype>::saber_type> _funcs_tail_scale;
+};
+
+} /* namespace ops */
+
+} /* namespace anakin */
+
+#endif
@@ -29,6 +29,7 @@ Status GruHelper<Ttype, Ptype>::InitParam() {
     auto gate_act = GET_PARAMETER(std::string, gate_activation);
     auto hidden_act = GET_PARAMETER(std::string, activation);
     auto formula = GET_PARAMETER(std::string, gru_formula);
+    auto dynamic_quant = GET_PARAMETER_WITH_DEFAULT(bool, dynamic_quant, false);
 
     using pblock_type = PBlock<Ttype>;
     auto weight_wu = GET_PARAMETER(pblock_type, weight_1);
@@ -55,6 +56,7 @@ Status GruHelper<Ttype, Ptype>::InitParam() {
     GruParam<Ttype> gru_param(&(weight_wu.d_tensor()), &(bias.d_tensor()),
                               formula_map[formula], act_map[gate_act],
                               act_map[hidden_act], is_reverse);
+    gru_param.dynamic_quant = dynamic_quant;
 
     _param_gru = gru_param;
 
@@ -129,7 +131,8 @@ ANAKIN_REGISTER_OP(Gru)
 .num_out(1)
 .Args<bool>("is_reverse", " is_reverse for gru.")
 .Args<std::string>("gate_activation",  "gate_activation for gru.")
-.Args<std::string>("activation", "hidden_activation for gru.");
+.Args<std::string>("activation", "hidden_activation for gru.")
+.Args<bool>("dynamic_quant", " input gemm in int8 with inputs quantized at runtime");
 
 } /* namespace ops */
 
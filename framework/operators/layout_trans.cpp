@@ -0,0 +1,72 @@
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+#include "framework/operators/layout_trans.h"
+
+namespace anakin {
+
+namespace ops {
+
+#define INSTANCE_LAYOUT_TRANS(Ttype, Ptype) \
+template<> \
+void LayoutTrans<Ttype, Ptype>::operator()(OpContext<Ttype>& ctx, \
+        const std::vector<Tensor4dPtr<Ttype> >& ins, \
+        std::vector<Tensor4dPtr<Ttype> >& outs) { \
+    auto* impl = static_cast<LayoutTransHelper<Ttype, Ptype>*>(this->_helper); \
+    auto& param = static_cast<LayoutTransHelper<Ttype, Ptype>*>\
+                  (this->_helper)->_param_layout_trans; \
+    impl->_funcs_layout_trans(ins, outs, param, ctx); \
+}
+
+template<typename Ttype, Precision Ptype>
+Status LayoutTransHelper<Ttype, Ptype>::InitParam() {
+    DLOG(WARNING) << "Parsing LayoutTrans op parameter.";
+    saber::LayoutTransParam<Ttype> param;
+    _param_layout_trans = param;
+    return Status::OK();
+}
+
+template<typename Ttype, Precision Ptype>
+Status LayoutTransHelper<Ttype, Ptype>::Init(OpContext<Ttype>& ctx,
+        const std::vector<Tensor4dPtr<Ttype> >& ins,
+        std::vector<Tensor4dPtr<Ttype> >& outs) {
+    SABER_CHECK(_funcs_layout_trans.init(ins, outs, _param_layout_trans, SPECIFY, SABER_IMPL, ctx));
+    return Status::OK();
+}
+
+template<typename Ttype, Precision Ptype>
+Status LayoutTransHelper<Ttype, Ptype>::InferShape(const std::vector<Tensor4dPtr<Ttype> >& ins,
+        std::vector<Tensor4dPtr<Ttype> >& outs) {
+    SABER_CHECK(_funcs_layout_trans.compute_output_shape(ins, outs, _param_layout_trans));
+    return Status::OK();
+}
+
+#if defined(USE_X86_PLACE) || defined(BUILD_LITE)
+INSTANCE_LAYOUT_TRANS(X86, Precision::FP32);
+template class LayoutTransHelper<X86, Precision::FP32>;
+ANAKIN_REGISTER_OP_HELPER(LayoutTrans, LayoutTransHelper, X86, Precision::FP32);
+#endif
+
+//! register op
+ANAKIN_REGISTER_OP(LayoutTrans)
+.Doc("LayoutTrans operator")
+#if defined(USE_X86_PLACE) || defined(BUILD_LITE)
+.__alias__<X86, Precision::FP32>("layout_trans")
+#endif
+.num_in(1)
+.num_out(1);
+
+} /* namespace ops */
+
+} /* namespace anakin */
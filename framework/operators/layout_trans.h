@@ -0,0 +1,100 @@
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef ANAKIN_OPERATOR_LAYOUT_TRANS_H
+#define ANAKIN_OPERATOR_LAYOUT_TRANS_H
+
+#include "framework/core/base.h"
+#include "framework/core/data_types.h"
+#include "framework/core/operator/operator.h"
+#include "utils/logger/logger.h"
+#include "saber/funcs/layout_trans.h"
+
+namespace anakin {
+
+namespace ops {
+
+template<typename Ttype, Precision Ptype>
+class LayoutTransHelper;
+
+/// layout trans op
+/**
+ * \brief LayoutTrans implementation class, reorders its input into the layout of its output.
+ * it is not parsed from models, Net inserts it on the edges where the auto layout pass
+ * changes layout between two ops.
+ * public inherit Operator
+ */
+template<typename Ttype, Precision Ptype>
+class LayoutTrans : public Operator<Ttype, Ptype> {
+public:
+    LayoutTrans() {}
+
+    /// forward impl
+    virtual void operator() (OpContext<Ttype> &ctx,
+                             const std::vector<Tensor4dPtr<Ttype> >& ins,
+                             std::vector<Tensor4dPtr<Ttype> >& outs) {
+        LOG(ERROR) << "Not Impl Yet Operator LayoutTrans< Ttype("
+                   << target_name<Ttype>::value << "), Precision(" << Ptype << ") >";
+    }
+
+    friend class LayoutTransHelper<Ttype, Ptype>;
+};
+
+/**
+ * \brief LayoutTrans helper class
+ * public inherit OperatorHelper
+ * including init resource and shape size in LayoutTrans context
+ */
+template<typename Ttype, Precision Ptype>
+class LayoutTransHelper : public OperatorHelper<Ttype, Ptype> {
+public:
+    LayoutTransHelper() = default;
+
+    ~LayoutTransHelper() {}
+
+    Status InitParam() override;
+
+    /**
+    * \brief initial all the resource needed by layout trans
+    * \param ctx stand for LayoutTrans operation context
+    * \param ins stand for input tensor vector
+    * \param outs stand for output tensor vector
+    * \return status
+    */
+    Status Init(OpContext<Ttype> &ctx,
+                const std::vector<Tensor4dPtr<Ttype> >& ins,
+                std::vector<Tensor4dPtr<Ttype> >& outs) override;
+
+    /**
+    * \brief infer the shape of output and input.
+    * \param ins stand for input tensor vector
+    * \param outs stand for output tensor vector
+    * \return status
+    */
+    Status InferShape(const std::vector<Tensor4dPtr<Ttype> >& ins,
+                      std::vector<Tensor4dPtr<Ttype> >& outs) override;
+
+public:
+    ///< _param_layout_trans stand for LayoutTrans parameter
+    saber::LayoutTransParam<Ttype> _param_layout_trans;
+    ///< _funcs_layout_trans stand for LayoutTrans function
+    saber::LayoutTrans<Ttype, PrecisionWrapper<Ptype>::saber_type> _funcs_layout_trans;
+};
+
+} /* namespace ops */
+
+} /* namespace anakin */
+
+#endif //ANAKIN_OPERATOR_LAYOUT_TRANS_H
@@ -34,6 +34,7 @@ Status LstmHelper<Ttype, Ptype>::InitParam() {
     auto candidate_activation = GET_PARAMETER(std::string, candidate_activation);
     auto is_reverse = GET_PARAMETER(bool, is_reverse);
     auto use_peepholes = GET_PARAMETER(bool, use_peepholes);
+    auto dynamic_quant = GET_PARAMETER_WITH_DEFAULT(bool, dynamic_quant, false);
 
     //auto weight_wu = GET_PARAMETER(PBlock<typename DataTypeWarpper<pe>::type>, weight_1);
     //auto bias = GET_PARAMETER(PBlock<typename DataTypeWarpper<Dtype>::type>, weight_2);
@@ -59,6 +60,7 @@ Status LstmHelper<Ttype, Ptype>::InitParam() {
             enum_map[cell_activation], enum_map[candidate_activation],
             use_peepholes, false, is_reverse, dropout_param,
             num_direction, num_layers);
+    lstm_param.dynamic_quant = dynamic_quant;
     _param_lstm = lstm_param;
 
     return Status::OK();
@@ -139,7 +141,8 @@ ANAKIN_REGISTER_OP(Lstm)
     .Args<std::string>("cell_activation", "some descp")
     .Args<std::string>("candidate_activation", "some descp")
     .Args<bool>("is_reverse", "some descp")
-    .Args<bool>("use_peephole", "some descp");
+    .Args<bool>("use_peephole", "some descp")
+    .Args<bool>("dynamic_quant", "input gemm in int8 with inputs quantized at runtime");
 
 } /* namespace ops */
 
@@ -27,8 +27,20 @@ Status MatMulHelper<Ttype, Ptype>::InitParam() {
     auto transpose_x = GET_PARAMETER(bool, transpose_x);
     auto transpose_y = GET_PARAMETER(bool, transpose_y);
     auto scale = GET_PARAMETER(float, coeff);
+    auto dynamic_quant = GET_PARAMETER_WITH_DEFAULT(bool, dynamic_quant, false);
+    auto const_y = GET_PARAMETER_WITH_DEFAULT(bool, const_y, false);
     LOG(INFO) <<"mat mul coeff" << scale;
     MatMulParam<Ttype> param_mat_mul(transpose_x, transpose_y, scale);
+    param_mat_mul._dynamic_quant = dynamic_quant;
+    param_mat_mul._const_y = const_y;
+    // permutes of the inputs folded into the matmul
+    if (FIND_PARAMETER(x_axes)) {
+        param_mat_mul._x_axes = GET_PARAMETER(PTuple<int>, x_axes).vector();
+    }
+    if (FIND_PARAMETER(y_axes)) {
+        param_mat_mul._y_axes = GET_PARAMETER(PTuple<int>, y_axes).vector();
+    }
+    CHECK(param_mat_mul.valid_axes()) << "mat mul x_axes and y_axes must be a permutation of 0, 1, 2, 3";
     _param_mat_mul = param_mat_mul;
 
     return Status::OK();
@@ -101,7 +113,12 @@ ANAKIN_REGISTER_OP(MatMul)
 .num_in(1)
 .num_out(1)
 .Args<std::string>("type", " type of MatMul ")
-.Args<bool>("channel_shared", "prelu channel is shared or not ");
+.Args<bool>("channel_shared", "prelu channel is shared or not ")
+.Args<bool>("dynamic_quant", " run in int8 with inputs quantized at runtime")
+.Args<bool>("const_y", " Y keeps its values between runs, dynamic quant packs it once")
+.Args<PTuple<int>>("x_axes", " permute of X dims before the matmul, read in place, "
+                   "written by the model converter in place of a Permute op")
+.Args<PTuple<int>>("y_axes", " permute of Y dims before the matmul, read in place");
 
 } /* namespace ops */
 
@@ -41,6 +41,7 @@
 #include "framework/operators/gru.h"
 #include "framework/operators/im2sequence.h"
 #include "framework/operators/input.h"
+#include "framework/operators/layout_trans.h"
 #include "framework/operators/log.h"
 #include "framework/operators/lrn.h"
 #include "framework/operators/lstm.h"
@@ -67,8 +68,12 @@
 #include "framework/operators/fusion_ops/conv_relu.h"
 #include "framework/operators/fusion_ops/conv_relu_pool.h"
 #include "framework/operators/fusion_ops/deconv_relu.h"
+#include "framework/operators/fusion_ops/dense_act.h"
+#include "framework/operators/fusion_ops/dense_affine.h"
 #include "framework/operators/fusion_ops/eltwise_relu.h"
+#include "framework/operators/fusion_ops/mat_mul_affine.h"
 #include "framework/operators/fusion_ops/permute_power.h"
+#include "framework/operators/fusion_ops/scale_chain.h"
 
 #endif //0
 
@@ -35,8 +35,14 @@ template<typename Ttype, Precision Ptype>
 Status SoftmaxHelper<Ttype, Ptype>::InitParam() {
     DLOG(WARNING) << "Parsing Softmax op parameter.";
     auto axis = GET_PARAMETER(int, axis);
-
-    SoftmaxParam<Ttype> param_softmax(axis);
+    // the input is scaled before the softmax, the optional second input is added as a mask
+    auto scale = GET_PARAMETER_WITH_DEFAULT(float, scale, 1.f);
+    _has_mask = GET_PARAMETER_WITH_DEFAULT(bool, mask, false);
+    // only the x86 softmax applies them, other targets would run a plain softmax
+    CHECK((std::is_same<Ttype, X86>::value) || (scale == 1.f && !_has_mask))
+            << "softmax scale and mask are only supported on x86";
+
+    SoftmaxParam<Ttype> param_softmax(axis, scale);
     _param_softmax = param_softmax;
     return Status::OK();
 }
@@ -74,6 +80,7 @@ Status SoftmaxHelper<Ttype, Ptype>::Init(OpContext<Ttype> &ctx, const std::vecto
 template<typename Ttype, Precision Ptype>
 Status SoftmaxHelper<Ttype, Ptype>::InferShape(const std::vector<Tensor4dPtr<Ttype>> &ins,
                                  std::vector<Tensor4dPtr<Ttype>> &outs) {
+    CHECK_EQ(ins.size(), _has_mask ? 2u : 1u) << "softmax takes the mask as its second input";
     SABER_CHECK(_funcs_softmax.compute_output_shape(ins, outs, _param_softmax));
     return Status::OK();
 }
@@ -131,9 +138,12 @@ ANAKIN_REGISTER_OP(Softmax)
 #ifdef AMD_GPU
 .__alias__<AMD, Precision::FP32>("softmax")
 #endif
-.num_in(1)
+.num_in(1, 2)
 .num_out(1)
-.Args<int>("axis", " axis ");
+.Args<int>("axis", " axis ")
+.Args<float>("scale", " the input is multiplied by scale before the softmax, 1 by default, x86 only ")
+.Args<bool>("mask", " a second input is added to the scaled input, "
+            "broadcast over the axes before axis, x86 only ");
 
 } /* namespace ops */
 
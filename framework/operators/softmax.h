@@ -89,6 +89,8 @@ public:
 public:
     ///< _param_softmax stand for softmax parameter
     saber::SoftmaxParam<Ttype> _param_softmax;
+    ///< _has_mask stand for the second input added to the scaled input
+    bool _has_mask{false};
     ///< _funcs_softmax stand for softmax function 
     saber::Softmax<Ttype, PrecisionWrapper<Ptype>::saber_type> _funcs_softmax;
 };
@@ -1,4 +1,7 @@
 #include "framework/utils/parameter_fusion.h"
+#ifdef USE_X86_PLACE
+#include "saber/funcs/impl/x86/half_convert_helper.h"
+#endif
 namespace anakin {
 /**
  * \brief  update fp32 conv weights with batchnorm and scale parameters.
@@ -257,6 +260,59 @@ void WeightsFusion<float, T>::update_deconv_weights_without_scale(
     bias.d_tensor().copy_from(bias.h_tensor());
 }
 
+/**
+ * \brief  update fp32 fc weights with a per output channel affine,
+ *  fp16 and bf16 weights on x86 are updated through fp32.
+ */
+template<typename T>
+void WeightsFusion<float, T>::update_fc_weights(PBlock<T> weights, PBlock<T> bias,
+                                                int k, int n, bool fc_bias_term,
+                                                std::vector<float> alpha,
+                                                std::vector<float> beta) {
+    alpha.resize(n, alpha.size() == 1 ? alpha[0] : 1.f);
+    beta.resize(n, beta.size() == 1 ? beta[0] : 0.f);
+    if (!fc_bias_term) {
+        bias.re_alloc(Shape4d({1, n, 1, 1}));
+        void* new_bias_data = bias.h_tensor().mutable_data();
+        memset(new_bias_data, 0, sizeof(float) * bias.h_tensor().size());
+    }
+    float* bias_p = (float*)(bias.h_tensor().mutable_data());
+    std::vector<float> w_scale = weights.h_tensor().get_scale();
+    auto weights_dtype = weights.h_tensor().get_dtype();
+
+    if (weights_dtype == AK_FLOAT) {
+        float* weights_p = (float*)(weights.h_tensor().mutable_data());
+        for (int j = 0; j < n; j++) {
+            for (int i = 0; i < k; i++) {
+                weights_p[(size_t)j * k + i] *= alpha[j];
+            }
+        }
+    } else {
+#ifdef USE_X86_PLACE
+        CHECK(saber::is_half_dtype(weights_dtype)) << "unsupport fc weights dtype " << weights_dtype;
+        uint16_t* weights_p = (uint16_t*)(weights.h_tensor().mutable_data());
+        std::vector<float> row(k);
+        for (int j = 0; j < n; j++) {
+            uint16_t* row_p = weights_p + (size_t)j * k;
+            saber::half_to_fp32(row_p, row.data(), k, weights_dtype);
+            for (int i = 0; i < k; i++) {
+                row[i] *= alpha[j];
+            }
+            saber::fp32_to_half(row.data(), row_p, k, weights_dtype);
+        }
+#else
+        LOG(FATAL) << "unsupport fc weights dtype " << weights_dtype;
+#endif
+    }
+    for (int j = 0; j < n; j++) {
+        bias_p[j] *= alpha[j];
+        bias_p[j] += beta[j];
+    }
+    weights.d_tensor().copy_from(weights.h_tensor());
+    weights.d_tensor().set_scale(w_scale);
+    bias.d_tensor().copy_from(bias.h_tensor());
+}
+
 /**
  * \brief  update int8 conv weights with batchnorm and scale parameters.
  */
@@ -18,10 +18,52 @@
 
 #include <string>
 #include <unordered_map>
+#include <algorithm>
+#include <cmath>
 #include "framework/core/parameter.h"
 
 namespace anakin {
 
+/**
+ * \brief  per channel y = alpha * x + beta of an inference batchnorm.
+ */
+inline void batchnorm_to_affine(float batchnorm_scale, float batchnorm_eps,
+                                const std::vector<float>& batchnorm_mean,
+                                const std::vector<float>& batchnorm_variance,
+                                std::vector<float>& alpha,
+                                std::vector<float>& beta) {
+    batchnorm_scale = (batchnorm_scale == 0) ? 1.f : 1.f / batchnorm_scale;
+    alpha.resize(batchnorm_mean.size());
+    beta.resize(batchnorm_mean.size());
+    for (size_t i = 0; i < batchnorm_mean.size(); i++) {
+        alpha[i] = 1.f / sqrtf(batchnorm_variance[i] * batchnorm_scale + batchnorm_eps);
+        beta[i] = -1.f * batchnorm_mean[i] * batchnorm_scale * alpha[i];
+    }
+}
+
+/**
+ * \brief  follow the per channel affine (alpha, beta) by y = scale * x + shift.
+ *  every vector holds one value for all channels or one value per channel,
+ *  an empty scale or shift stands for 1 or 0.
+ */
+inline void append_affine(std::vector<float>& alpha, std::vector<float>& beta,
+                          const std::vector<float>& scale,
+                          const std::vector<float>& shift) {
+    auto at = [](const std::vector<float>& v, size_t i, float empty_value) {
+        return v.empty() ? empty_value : v[v.size() == 1 ? 0 : i];
+    };
+    size_t size = std::max(std::max(alpha.size(), beta.size()),
+                           std::max(scale.size(), shift.size()));
+    std::vector<float> new_alpha(size);
+    std::vector<float> new_beta(size);
+    for (size_t i = 0; i < size; i++) {
+        new_alpha[i] = at(alpha, i, 1.f) * at(scale, i, 1.f);
+        new_beta[i] = at(beta, i, 0.f) * at(scale, i, 1.f) + at(shift, i, 0.f);
+    }
+    alpha.swap(new_alpha);
+    beta.swap(new_beta);
+}
+
 template<typename D, typename T>
 class WeightsFusion{
 public:
@@ -97,6 +139,16 @@ public:
                                              std::vector<float> batchnorm_variance){
         LOG(ERROR) << "unsupport weights dtype";
     };
+
+    /**
+     * \brief  update fc weights (n x k, output major) with a per output channel affine.
+     */
+    static void update_fc_weights(PBlock<T> weights, PBlock<T> bias,
+                                  int k, int n, bool fc_bias_term,
+                                  std::vector<float> alpha,
+                                  std::vector<float> beta){
+        LOG(ERROR) << "unsupport weights dtype";
+    }
 };
 
 template<typename T>
@@ -161,6 +213,14 @@ public:
                                              float batchnorm_scale, float batchnorm_eps,
                                              std::vector<float> batchnorm_mean,
                                              std::vector<float> batchnorm_variance);
+
+    /**
+     * \brief  update fc weights (n x k, output major) with a per output channel affine.
+     */
+    static void update_fc_weights(PBlock<T> weights, PBlock<T> bias,
+                                  int k, int n, bool fc_bias_term,
+                                  std::vector<float> alpha,
+                                  std::vector<float> beta);
 };
 
 template<typename T>
@@ -70,6 +70,8 @@ static size_t type_length(DataType type) {
         return 8;
     case AK_HALF:
         return 2;
+    case AK_BFLOAT16:
+        return 2;
     case AK_FLOAT:
         return 4;
     case AK_DOUBLE:
@@ -91,6 +93,12 @@ struct DataTrait<Ttype, AK_HALF> {
     typedef short* PtrDtype;
 };
 
+template <typename Ttype>
+struct DataTrait<Ttype, AK_BFLOAT16> {
+    typedef unsigned short Dtype;
+    typedef unsigned short* PtrDtype;
+};
+
 template <typename Ttype>
 struct DataTrait<Ttype, AK_FLOAT> {
     typedef float Dtype;
@@ -0,0 +1,419 @@
+#include "saber/core/host_allocator.h"
+#include "saber/core/common.h"
+#include <cstring>
+#include <unordered_set>
+#if defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+namespace anakin{
+
+namespace saber{
+
+/**
+ * \brief header in front of every host block, it sits in the MALLOC_ALIGN bytes before the data
+ */
+struct HostBlockHeader {
+    void* raw;                  ///< pointer of the system allocation
+    HostAllocator* owner;
+    size_t size;                ///< usable bytes
+    int size_class;             ///< size class of a caching allocator, -1 for none
+};
+
+static_assert(sizeof(HostBlockHeader) <= MALLOC_ALIGN, "host block header exceeds MALLOC_ALIGN");
+
+static inline HostBlockHeader* block_header(void* ptr) {
+    return reinterpret_cast<HostBlockHeader*>(static_cast<char*>(ptr) - sizeof(HostBlockHeader));
+}
+
+HostAllocatorStats HostAllocator::stats() const {
+    HostAllocatorStats stats;
+    stats.alloc_count = _alloc_count.load();
+    stats.free_count = _free_count.load();
+    stats.cache_hit_count = _cache_hit_count.load();
+    stats.system_alloc_count = _system_alloc_count.load();
+    stats.bytes_in_use = _bytes_in_use.load();
+    stats.peak_bytes_in_use = _peak_bytes_in_use.load();
+    stats.bytes_cached = _bytes_cached.load();
+    return stats;
+}
+
+static std::atomic<HostAllocator*> g_host_allocator{nullptr};
+
+static HostAllocator* create_default_host_allocator() {
+    const char* env = std::getenv("ANAKIN_HOST_ALLOCATOR");
+    std::string type = env == nullptr ? "system" : env;
+
+    if (type == "caching" || type == "caching_hugepage") {
+        CachingHostAllocatorParam param;
+        param.huge_page = type == "caching_hugepage";
+        return new CachingHostAllocator(param);
+    }
+
+    if (type != "system") {
+        LOG(WARNING) << "unknown ANAKIN_HOST_ALLOCATOR " << type << ", use system";
+    }
+
+    return new SystemHostAllocator();
+}
+
+HostAllocator* HostAllocator::global() {
+    HostAllocator* allocator = g_host_allocator.load(std::memory_order_acquire);
+
+    if (allocator == nullptr) {
+        // never deleted, blocks of static objects may be freed at exit
+        static HostAllocator* default_allocator = create_default_host_allocator();
+        HostAllocator* expected = nullptr;
+        g_host_allocator.compare_exchange_strong(expected, default_allocator);
+        allocator = g_host_allocator.load(std::memory_order_acquire);
+    }
+
+    return allocator;
+}
+
+void HostAllocator::set_global(HostAllocator* allocator) {
+    CHECK(allocator != nullptr) << "host allocator is null";
+    g_host_allocator.store(allocator, std::memory_order_release);
+}
+
+void HostAllocator::free_block(void* ptr) {
+    if (ptr != nullptr) {
+        block_header(ptr)->owner->free(ptr);
+    }
+}
+
+size_t HostAllocator::block_size(void* ptr) {
+    return ptr == nullptr ? 0 : block_header(ptr)->size;
+}
+
+void* HostAllocator::system_alloc(size_t size, int size_class, size_t huge_page_size) {
+    size_t align = huge_page_size > 0 ? huge_page_size : MALLOC_ALIGN;
+    void* raw = nullptr;
+
+    if (posix_memalign(&raw, align, size + MALLOC_ALIGN) != 0) {
+        LOG(ERROR) << "host allocation of " << size << " bytes failed";
+        return nullptr;
+    }
+
+#if defined(__linux__) && defined(MADV_HUGEPAGE)
+
+    if (huge_page_size > 0) {
+        madvise(raw, size + MALLOC_ALIGN, MADV_HUGEPAGE);
+    }
+
+#endif
+    void* ptr = static_cast<char*>(raw) + MALLOC_ALIGN;
+    HostBlockHeader* header = block_header(ptr);
+    header->raw = raw;
+    header->owner = this;
+    header->size = size;
+    header->size_class = size_class;
+    _system_alloc_count++;
+    return ptr;
+}
+
+void HostAllocator::system_free(void* ptr) {
+    ::free(block_header(ptr)->raw);
+}
+
+void HostAllocator::count_alloc(size_t size, bool cache_hit) {
+    _alloc_count++;
+
+    if (cache_hit) {
+        _cache_hit_count++;
+    }
+
+    size_t in_use = _bytes_in_use.fetch_add(size) + size;
+    size_t peak = _peak_bytes_in_use.load();
+
+    while (in_use > peak && !_peak_bytes_in_use.compare_exchange_weak(peak, in_use)) {}
+}
+
+void HostAllocator::count_free(size_t size) {
+    _free_count++;
+    _bytes_in_use.fetch_sub(size);
+}
+
+void* SystemHostAllocator::alloc(size_t size) {
+    void* ptr = system_alloc(size, -1);
+
+    if (ptr == nullptr) {
+        return nullptr;
+    }
+
+    if (_zero_fill) {
+        memset(ptr, 0, size);
+    }
+
+    count_alloc(size, false);
+    return ptr;
+}
+
+void SystemHostAllocator::free(void* ptr) {
+    if (ptr != nullptr) {
+        count_free(block_header(ptr)->size);
+        system_free(ptr);
+    }
+}
+
+/**
+ * \brief free blocks of the calling thread, linked through their first bytes,
+ * it serves one caching allocator at a time
+ */
+struct ThreadBlockCache {
+    std::mutex mut;             ///< uncontended but when an allocator drains the cache
+    CachingHostAllocator* owner{nullptr};
+    void* free_list[CachingHostAllocator::NUM_SIZE_CLASSES] = {nullptr};
+    size_t bytes{0};
+
+    void* pop(int size_class, size_t size) {
+        void* ptr = free_list[size_class];
+
+        if (ptr != nullptr) {
+            free_list[size_class] = *static_cast<void**>(ptr);
+            bytes -= size;
+        }
+
+        return ptr;
+    }
+
+    void push(void* ptr, int size_class, size_t size) {
+        *static_cast<void**>(ptr) = free_list[size_class];
+        free_list[size_class] = ptr;
+        bytes += size;
+    }
+
+    void flush() {
+        if (owner == nullptr) {
+            return;
+        }
+
+        for (int i = 0; i < CachingHostAllocator::NUM_SIZE_CLASSES; ++i) {
+            while (free_list[i] != nullptr) {
+                void* ptr = free_list[i];
+                free_list[i] = *static_cast<void**>(ptr);
+                size_t size = block_header(ptr)->size;
+                owner->_bytes_cached.fetch_sub(size);
+
+                if (!owner->push_shared(ptr, i, size)) {
+                    owner->system_free(ptr);
+                }
+            }
+        }
+
+        bytes = 0;
+        owner = nullptr;
+    }
+
+    ThreadBlockCache();
+    ~ThreadBlockCache();
+};
+
+/**
+ * \brief the live thread caches, a caching allocator being destroyed drains the ones it owns,
+ * the registry lock is taken before the lock of a cache
+ */
+struct ThreadBlockCacheRegistry {
+    std::mutex mut;
+    std::unordered_set<ThreadBlockCache*> caches;
+};
+
+static ThreadBlockCacheRegistry& thread_block_cache_registry() {
+    // never deleted, threads may exit after the static objects are destroyed
+    static ThreadBlockCacheRegistry* registry = new ThreadBlockCacheRegistry;
+    return *registry;
+}
+
+//! set once the cache of the thread is destroyed, blocks freed later go to the shared pool
+static thread_local bool tls_block_cache_dead = false;
+
+ThreadBlockCache::ThreadBlockCache() {
+    ThreadBlockCacheRegistry& registry = thread_block_cache_registry();
+    std::lock_guard<std::mutex> lock(registry.mut);
+    registry.caches.insert(this);
+}
+
+ThreadBlockCache::~ThreadBlockCache() {
+    {
+        ThreadBlockCacheRegistry& registry = thread_block_cache_registry();
+        std::lock_guard<std::mutex> lock(registry.mut);
+        registry.caches.erase(this);
+    }
+    // out of the registry, no allocator reaches the cache any more
+    flush();
+    tls_block_cache_dead = true;
+}
+
+static ThreadBlockCache* thread_block_cache() {
+    if (tls_block_cache_dead) {
+        return nullptr;
+    }
+
+    static thread_local ThreadBlockCache cache;
+    return &cache;
+}
+
+CachingHostAllocator::CachingHostAllocator(const CachingHostAllocatorParam& param) : _param(param) {
+    for (int i = 0; i < NUM_SIZE_CLASSES; ++i) {
+        _free_list[i] = nullptr;
+    }
+}
+
+CachingHostAllocator::~CachingHostAllocator() {
+    {
+        // the blocks cached by every thread go back before the pool is released
+        ThreadBlockCacheRegistry& registry = thread_block_cache_registry();
+        std::lock_guard<std::mutex> lock(registry.mut);
+
+        for (ThreadBlockCache* cache : registry.caches) {
+            std::lock_guard<std::mutex> cache_lock(cache->mut);
+
+            if (cache->owner == this) {
+                cache->flush();
+            }
+        }
+    }
+    release_cache();
+}
+
+int CachingHostAllocator::size_class(size_t size, size_t* class_size) {
+    if (size <= MALLOC_ALIGN) {
+        *class_size = MALLOC_ALIGN;
+        return 0;
+    }
+
+    // 2^p < size <= 2^(p + 1), the range is split into four classes
+    int p = 63 - __builtin_clzll(static_cast<unsigned long long>(size - 1));
+    size_t step = size_t(1) << (p - 2);
+    size_t n = (size + step - 1) / step;
+    *class_size = n * step;
+    return (p - 6) * 4 + static_cast<int>(n - 4);
+}
+
+void* CachingHostAllocator::pop_shared(int size_class) {
+    std::lock_guard<std::mutex> lock(_mut);
+    void* ptr = _free_list[size_class];
+
+    if (ptr != nullptr) {
+        _free_list[size_class] = *static_cast<void**>(ptr);
+        _shared_bytes -= block_header(ptr)->size;
+    }
+
+    return ptr;
+}
+
+bool CachingHostAllocator::push_shared(void* ptr, int size_class, size_t size) {
+    std::lock_guard<std::mutex> lock(_mut);
+
+    if (_shared_bytes + size > _param.max_cached_bytes) {
+        return false;
+    }
+
+    *static_cast<void**>(ptr) = _free_list[size_class];
+    _free_list[size_class] = ptr;
+    _shared_bytes += size;
+    _bytes_cached.fetch_add(size);
+    return true;
+}
+
+void* CachingHostAllocator::alloc(size_t size) {
+    size_t class_size = 0;
+    int id = size_class(size, &class_size);
+    void* ptr = nullptr;
+    ThreadBlockCache* cache = class_size <= _param.thread_cache_max_block ? thread_block_cache() : nullptr;
+
+    if (cache != nullptr) {
+        std::lock_guard<std::mutex> lock(cache->mut);
+
+        if (cache->owner == this) {
+            ptr = cache->pop(id, class_size);
+        }
+    }
+
+    if (ptr == nullptr) {
+        ptr = pop_shared(id);
+    }
+
+    bool cache_hit = ptr != nullptr;
+
+    if (cache_hit) {
+        _bytes_cached.fetch_sub(class_size);
+    } else {
+        size_t huge_page_size = _param.huge_page && class_size >= _param.huge_page_size ?
+                                _param.huge_page_size : 0;
+        ptr = system_alloc(class_size, id, huge_page_size);
+
+        if (ptr == nullptr) {
+            return nullptr;
+        }
+    }
+
+    if (_param.zero_fill) {
+        memset(ptr, 0, size);
+    }
+
+    count_alloc(class_size, cache_hit);
+    return ptr;
+}
+
+void CachingHostAllocator::free(void* ptr) {
+    if (ptr == nullptr) {
+        return;
+    }
+
+    HostBlockHeader* header = block_header(ptr);
+    size_t size = header->size;
+    count_free(size);
+    ThreadBlockCache* cache = size <= _param.thread_cache_max_block ? thread_block_cache() : nullptr;
+
+    if (cache != nullptr) {
+        std::lock_guard<std::mutex> lock(cache->mut);
+
+        if (cache->owner != this && cache->bytes == 0) {
+            cache->owner = this;
+        }
+
+        if (cache->owner == this && cache->bytes + size <= _param.thread_cache_bytes) {
+            cache->push(ptr, header->size_class, size);
+            _bytes_cached.fetch_add(size);
+            return;
+        }
+    }
+
+    if (!push_shared(ptr, header->size_class, size)) {
+        system_free(ptr);
+    }
+}
+
+void CachingHostAllocator::flush_thread_cache() {
+    ThreadBlockCache* cache = thread_block_cache();
+
+    if (cache == nullptr) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(cache->mut);
+
+    if (cache->owner == this) {
+        cache->flush();
+    }
+}
+
+void CachingHostAllocator::release_cache() {
+    std::lock_guard<std::mutex> lock(_mut);
+
+    for (int i = 0; i < NUM_SIZE_CLASSES; ++i) {
+        while (_free_list[i] != nullptr) {
+            void* ptr = _free_list[i];
+            _free_list[i] = *static_cast<void**>(ptr);
+            _bytes_cached.fetch_sub(block_header(ptr)->size);
+            system_free(ptr);
+        }
+    }
+
+    _shared_bytes = 0;
+}
+
+} //namespace saber
+
+} //namespace anakin
@@ -0,0 +1,173 @@
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef ANAKIN_SABER_CORE_HOST_ALLOCATOR_H
+#define ANAKIN_SABER_CORE_HOST_ALLOCATOR_H
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+
+namespace anakin{
+
+namespace saber{
+
+const int MALLOC_ALIGN = 64;
+
+/**
+ * \brief counters of a host allocator, sizes are in bytes
+ */
+struct HostAllocatorStats {
+    size_t alloc_count{0};          ///< calls of alloc
+    size_t free_count{0};           ///< calls of free
+    size_t cache_hit_count{0};      ///< allocations served from a cache
+    size_t system_alloc_count{0};   ///< allocations which reached the system allocator
+    size_t bytes_in_use{0};         ///< bytes of the blocks handed out
+    size_t peak_bytes_in_use{0};    ///< max of bytes_in_use
+    size_t bytes_cached{0};         ///< bytes of the free blocks kept for reuse
+};
+
+/**
+ * \brief allocator of the host targets, TargetWrapper<X86>::mem_alloc and mem_free go through it
+ * every block is MALLOC_ALIGN aligned and remembers the allocator it comes from,
+ * so the global allocator can be switched while blocks of the previous one are alive.
+ * an allocator must outlive the blocks it hands out, installed allocators are never deleted.
+ */
+class HostAllocator {
+public:
+    virtual ~HostAllocator() {}
+
+    /**
+     * \brief allocate a block of at least size bytes
+     */
+    virtual void* alloc(size_t size) = 0;
+
+    /**
+     * \brief give back a block allocated by this allocator
+     */
+    virtual void free(void* ptr) = 0;
+
+    /**
+     * \brief return the cached blocks to the system
+     */
+    virtual void release_cache() {}
+
+    HostAllocatorStats stats() const;
+
+    /**
+     * \brief allocator used by the host targets, chosen by the environment variable
+     * ANAKIN_HOST_ALLOCATOR ("system", "caching" or "caching_hugepage"), system by default
+     */
+    static HostAllocator* global();
+
+    static void set_global(HostAllocator* allocator);
+
+    /**
+     * \brief free a block through the allocator which created it
+     */
+    static void free_block(void* ptr);
+
+    /**
+     * \brief usable bytes of a block
+     */
+    static size_t block_size(void* ptr);
+
+protected:
+    /**
+     * \brief get size + MALLOC_ALIGN bytes from the system and put the block header in front,
+     * a non zero huge_page_size aligns the block to it and advises huge pages
+     */
+    void* system_alloc(size_t size, int size_class, size_t huge_page_size = 0);
+    void system_free(void* ptr);
+
+    void count_alloc(size_t size, bool cache_hit);
+    void count_free(size_t size);
+
+    std::atomic<size_t> _alloc_count{0};
+    std::atomic<size_t> _free_count{0};
+    std::atomic<size_t> _cache_hit_count{0};
+    std::atomic<size_t> _system_alloc_count{0};
+    std::atomic<size_t> _bytes_in_use{0};
+    std::atomic<size_t> _peak_bytes_in_use{0};
+    std::atomic<size_t> _bytes_cached{0};
+};
+
+/**
+ * \brief malloc for every request and free for every release, the blocks are filled with zero
+ * as fast_malloc does, this is the default
+ */
+class SystemHostAllocator : public HostAllocator {
+public:
+    explicit SystemHostAllocator(bool zero_fill = true) : _zero_fill(zero_fill) {}
+
+    void* alloc(size_t size) override;
+    void free(void* ptr) override;
+
+private:
+    bool _zero_fill;
+};
+
+struct CachingHostAllocatorParam {
+    bool zero_fill{false};                  ///< memset every block handed out
+    bool huge_page{false};                  ///< madvise large blocks as transparent huge pages
+    size_t huge_page_size{2 << 20};         ///< blocks this large are huge page backed
+    size_t max_cached_bytes{size_t(1) << 30};   ///< beyond this freed blocks go to the system
+    size_t thread_cache_bytes{16 << 20};    ///< bytes cached by each thread
+    size_t thread_cache_max_block{1 << 20}; ///< larger blocks skip the thread caches
+};
+
+/**
+ * \brief keeps freed blocks in size classes, four classes for each power of two,
+ * small blocks are first cached per thread and the rest in a shared pool
+ */
+class CachingHostAllocator : public HostAllocator {
+public:
+    enum { NUM_SIZE_CLASSES = 4 * (64 - 6) + 1 };
+
+    explicit CachingHostAllocator(const CachingHostAllocatorParam& param = CachingHostAllocatorParam());
+    /// the blocks cached for it by any thread go back to the system
+    ~CachingHostAllocator();
+
+    void* alloc(size_t size) override;
+    void free(void* ptr) override;
+    void release_cache() override;
+
+    /**
+     * \brief index of the class serving size bytes, class_size gets the bytes of its blocks
+     */
+    static int size_class(size_t size, size_t* class_size);
+
+    /**
+     * \brief give the blocks cached by the calling thread back to the shared pool
+     */
+    void flush_thread_cache();
+
+private:
+    friend struct ThreadBlockCache;
+
+    void* pop_shared(int size_class);
+    bool push_shared(void* ptr, int size_class, size_t size);
+
+    CachingHostAllocatorParam _param;
+    std::mutex _mut;
+    void* _free_list[NUM_SIZE_CLASSES];
+    size_t _shared_bytes{0};
+};
+
+} //namespace saber
+
+} //namespace anakin
+
+#endif //ANAKIN_SABER_CORE_HOST_ALLOCATOR_H
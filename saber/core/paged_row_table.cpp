@@ -0,0 +1,175 @@
+#include "saber/core/paged_row_table.h"
+#include "saber/core/common.h"
+#include "saber/core/data_traits.h"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace anakin{
+
+namespace saber{
+
+PagedRowTable::~PagedRowTable() {
+    if (_fd >= 0) {
+        close(_fd);
+    }
+}
+
+SaberStatus PagedRowTable::open(const std::string& path, size_t offset, int64_t rows, int row_size,
+                                DataType dtype, const PagedRowTableParam& param) {
+    CHECK_LT(_fd, 0) << "paged row table is already open";
+    CHECK_GT(rows, 0);
+    CHECK_GT(row_size, 0);
+    CHECK_GT(param.num_shards, 0);
+    _fd = ::open(path.c_str(), O_RDONLY);
+
+    if (_fd < 0) {
+        LOG(ERROR) << "can not open paged row table " << path;
+        return SaberInvalidValue;
+    }
+
+    _row_bytes = row_size * type_length(dtype);
+    off_t file_size = lseek(_fd, 0, SEEK_END);
+
+    if (file_size < 0 || offset + rows * _row_bytes > static_cast<size_t>(file_size)) {
+        LOG(ERROR) << "paged row table " << path << " is smaller than " << rows << " rows of "
+                   << _row_bytes << " bytes at offset " << offset;
+        close(_fd);
+        _fd = -1;
+        return SaberInvalidValue;
+    }
+
+    _offset = offset;
+    _rows = rows;
+    _row_size = row_size;
+    _dtype = dtype;
+    _param = param;
+    // a shard never holds more rows than the table maps to it
+    size_t shard_rows = std::min<size_t>(param.cache_bytes / _row_bytes / param.num_shards,
+                                         (rows + param.num_shards - 1) / param.num_shards);
+    shard_rows = std::max<size_t>(1, shard_rows);
+
+    for (int i = 0; i < param.num_shards; ++i) {
+        _shards.emplace_back(new Shard);
+        _shards.back()->max_slots = shard_rows;
+    }
+
+    return SaberSuccess;
+}
+
+std::shared_ptr<PagedRowTable> PagedRowTable::get(const std::string& path, size_t offset,
+        int64_t rows, int row_size, DataType dtype, const PagedRowTableParam& param) {
+    static std::mutex mut;
+    static std::unordered_map<std::string, std::weak_ptr<PagedRowTable>> tables;
+    std::string key = path + "@" + std::to_string(offset);
+    std::lock_guard<std::mutex> lock(mut);
+    std::shared_ptr<PagedRowTable> table = tables[key].lock();
+
+    if (table) {
+        CHECK(table->rows() == rows && table->row_size() == row_size && table->dtype() == dtype)
+                << "paged row table " << key << " is opened with another layout";
+        // the cache of the first user is shared, it is not resized for a later one
+        if (table->param().cache_bytes != param.cache_bytes
+                || table->param().num_shards != param.num_shards) {
+            LOG(WARNING) << "paged row table " << key << " is shared with a cache of "
+                         << table->param().cache_bytes << " bytes in " << table->param().num_shards
+                         << " shards, the cache of " << param.cache_bytes << " bytes in "
+                         << param.num_shards << " shards asked for is ignored";
+        }
+        return table;
+    }
+
+    table = std::make_shared<PagedRowTable>();
+
+    if (table->open(path, offset, rows, row_size, dtype, param) != SaberSuccess) {
+        return nullptr;
+    }
+
+    tables[key] = table;
+    return table;
+}
+
+bool PagedRowTable::read_row(int64_t row, void* dst) {
+    char* ptr = static_cast<char*>(dst);
+    size_t done = 0;
+    off_t pos = _offset + row * _row_bytes;
+
+    while (done < _row_bytes) {
+        ssize_t ret = pread(_fd, ptr + done, _row_bytes - done, pos + done);
+
+        if (ret <= 0) {
+            return false;
+        }
+
+        done += ret;
+    }
+
+    return true;
+}
+
+void PagedRowTable::copy_row(int64_t row, void* dst) {
+    CHECK_GE(row, 0);
+    CHECK_LT(row, _rows);
+    Shard& shard = *_shards[row % _shards.size()];
+    {
+        std::lock_guard<std::mutex> lock(shard.mut);
+        auto it = shard.index.find(row);
+
+        if (it != shard.index.end()) {
+            shard.lru.splice(shard.lru.begin(), shard.lru, it->second.first);
+            memcpy(dst, shard.data.data() + it->second.second * _row_bytes, _row_bytes);
+            _hit_count++;
+            return;
+        }
+    }
+
+    // read outside the lock, other rows of the shard are served meanwhile
+    CHECK(read_row(row, dst)) << "read row " << row << " of paged row table failed";
+    _miss_count++;
+    std::lock_guard<std::mutex> lock(shard.mut);
+
+    if (shard.index.count(row) > 0) {
+        return;
+    }
+
+    size_t slot = 0;
+
+    if (shard.used_slots < shard.max_slots) {
+        slot = shard.used_slots++;
+
+        // the slots are allocated as the rows come, doubling up to max_slots
+        if (shard.data.size() < shard.used_slots * _row_bytes) {
+            size_t slots = std::min(shard.max_slots, std::max<size_t>(4, 2 * shard.used_slots));
+            shard.data.reserve(slots * _row_bytes);
+            shard.data.resize(slots * _row_bytes);
+        }
+    } else {
+        auto victim = shard.index.find(shard.lru.back());
+        slot = victim->second.second;
+        shard.index.erase(victim);
+        shard.lru.pop_back();
+    }
+
+    memcpy(shard.data.data() + slot * _row_bytes, dst, _row_bytes);
+    shard.lru.push_front(row);
+    shard.index[row] = std::make_pair(shard.lru.begin(), slot);
+}
+
+PagedRowTableStats PagedRowTable::stats() const {
+    PagedRowTableStats stats;
+    stats.hit_count = _hit_count.load();
+    stats.miss_count = _miss_count.load();
+
+    for (auto& shard : _shards) {
+        std::lock_guard<std::mutex> lock(shard->mut);
+        stats.cached_rows += shard->index.size();
+        stats.cache_bytes += shard->data.size();
+    }
+
+    return stats;
+}
+
+} //namespace saber
+
+} //namespace anakin
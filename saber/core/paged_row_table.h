@@ -0,0 +1,111 @@
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef ANAKIN_SABER_CORE_PAGED_ROW_TABLE_H
+#define ANAKIN_SABER_CORE_PAGED_ROW_TABLE_H
+
+#include "saber/saber_types.h"
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace anakin{
+
+namespace saber{
+
+struct PagedRowTableParam {
+    size_t cache_bytes{size_t(256) << 20};  ///< most bytes of rows kept in memory, allocated as rows are read
+    int num_shards{16};                     ///< rows are spread over the shards by index
+};
+
+struct PagedRowTableStats {
+    size_t hit_count{0};        ///< rows served from the cache
+    size_t miss_count{0};       ///< rows read from the file
+    size_t cached_rows{0};
+    size_t cache_bytes{0};      ///< bytes allocated for the cached rows
+};
+
+/**
+ * \brief a table of fixed size rows kept in a file, rows are read on demand
+ * and the hot ones stay in a bounded LRU cache, one LRU and lock for each shard.
+ * used for embedding tables larger than the host memory.
+ */
+class PagedRowTable {
+public:
+    PagedRowTable() = default;
+    ~PagedRowTable();
+
+    /**
+     * \brief open rows * row_size elements of dtype stored row major
+     * at offset bytes of the file at path
+     */
+    SaberStatus open(const std::string& path, size_t offset, int64_t rows, int row_size,
+                     DataType dtype, const PagedRowTableParam& param = PagedRowTableParam());
+
+    /**
+     * \brief table of the file region, shared with the other users of the same region,
+     * the layout must match the shared table, its cache param is kept
+     */
+    static std::shared_ptr<PagedRowTable> get(const std::string& path, size_t offset,
+            int64_t rows, int row_size, DataType dtype,
+            const PagedRowTableParam& param = PagedRowTableParam());
+
+    /**
+     * \brief copy row_bytes() bytes of the row to dst
+     */
+    void copy_row(int64_t row, void* dst);
+
+    int64_t rows() const { return _rows; }
+    int row_size() const { return _row_size; }
+    size_t row_bytes() const { return _row_bytes; }
+    DataType dtype() const { return _dtype; }
+    const PagedRowTableParam& param() const { return _param; }
+
+    PagedRowTableStats stats() const;
+
+private:
+    struct Shard {
+        std::mutex mut;
+        std::list<int64_t> lru;     ///< most recently used first
+        /// row to its lru position and cache slot
+        std::unordered_map<int64_t, std::pair<std::list<int64_t>::iterator, size_t>> index;
+        std::vector<char> data;     ///< grows with the used slots
+        size_t used_slots{0};
+        size_t max_slots{0};
+    };
+
+    bool read_row(int64_t row, void* dst);
+
+    int _fd{-1};
+    size_t _offset{0};
+    int64_t _rows{0};
+    int _row_size{0};
+    size_t _row_bytes{0};
+    DataType _dtype{AK_FLOAT};
+    PagedRowTableParam _param;
+    std::vector<std::unique_ptr<Shard>> _shards;
+    std::atomic<size_t> _hit_count{0};
+    std::atomic<size_t> _miss_count{0};
+};
+
+} //namespace saber
+
+} //namespace anakin
+
+#endif //ANAKIN_SABER_CORE_PAGED_ROW_TABLE_H
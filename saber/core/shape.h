@@ -17,63 +17,179 @@
 #define ANAKIN_SABER_CORE_SHAPE_H
 
 #include <vector>
+#include <initializer_list>
 #include "saber/core/common.h"
 
 namespace anakin {
 
 namespace saber {
 
-class Shape : public std::vector<int> {
+/**
+ * \brief dims and indexes of every LayoutType, the value type counterpart of
+ *  the Layout structs in saber_types.h
+ */
+struct LayoutDesc {
+    int dims;
+    int num_index;
+    int channel_index;
+    int height_index;
+    int width_index;
+    int depth_index;
+    int inner_c;
+    int aligned_length;
+
+    static const LayoutDesc& get(LayoutType layout_type) {
+        static const LayoutDesc descs[] = {
+            {-1, -1, -1, -1, -1, -1, -1, -1},   // Layout_invalid
+            { 1, -1, -1, -1,  0, -1, -1, -1},   // Layout_W
+            { 2, -1, -1,  0,  1, -1, -1, -1},   // Layout_HW
+            { 2, -1, -1,  1,  0, -1, -1, -1},   // Layout_WH
+            { 2,  0,  1, -1, -1, -1, -1, -1},   // Layout_NC
+            { 2,  0, -1,  1, -1, -1, -1, -1},   // Layout_NH
+            { 2,  0, -1, -1,  1, -1, -1, -1},   // Layout_NW
+            { 3,  0, -1,  1,  2, -1, -1, -1},   // Layout_NHW
+            { 4,  0,  1,  2,  3, -1, -1, -1},   // Layout_NCHW
+            { 4,  0,  3,  1,  2, -1, -1, -1},   // Layout_NHWC
+            { 4,  0,  1,  2,  3, -1, -1, -1},   // Layout_NCHW_C4
+            { 5,  0,  1,  2,  3, -1,  8, -1},   // Layout_NCHW_C8
+            { 5,  0,  1,  2,  3, -1, 16, -1},   // Layout_NCHW_C16
+            {-1, -1, -1, -1, -1, -1, -1, -1},   // Layout_OIHW16I16O
+            {-1, -1, -1, -1, -1, -1, -1, -1},   // Layout_GOIHW16I16O
+            { 4,  0,  1,  2,  3, -1, -1,  8},   // Layout_NCHW_C8R
+            { 4,  0,  1,  2,  3, -1, -1, 16},   // Layout_NCHW_C16R
+        };
+        return descs[layout_type];
+    }
+};
+
+/**
+ * \brief tensor shape, the dims are stored inline and the layout is a plain
+ *  LayoutType, so constructing and copying a shape never touches the heap.
+ *  it keeps the std::vector<int> interface the shape used to inherit.
+ */
+class Shape {
 public:
     using vector = std::vector<int>;
+    typedef int value_type;
+    typedef size_t size_type;
+    typedef int& reference;
+    typedef const int& const_reference;
+    typedef int* iterator;
+    typedef const int* const_iterator;
 
-    Shape() : vector(), _layout(nullptr) {
+    enum { MAX_DIMS = 8 };
+
+    Shape() {
         create_layout(Layout_NCHW);
     }
 
-    Shape(vector data, LayoutType layout_type = Layout_NCHW) {
-        create_layout(layout_type);
-        CHECK_EQ(_layout->dims(), data.size()) \
-                << "The shape from the vector must have the correct layout.";
-
-        for (int i = 0; i < _layout->dims(); ++i) {
-            this->push_back(data[i]);
-        }
-
-        if (_layout->inner_c() != -1) {
-            CHECK_EQ(data[4], _layout->inner_c()) \
-                    << " Layout must be an integer multiple of "
-                    << _layout->inner_c();
-        }
-    }
-    ~Shape() {
-        delete _layout;
-        _layout = nullptr;
+    Shape(std::initializer_list<int> data, LayoutType layout_type = Layout_NCHW) {
+        init(data.begin(), data.size(), layout_type);
     }
 
-    Shape(const Shape& right)
-        : std::vector<int>(right) {
-        this->clear();
+    Shape(const vector& data, LayoutType layout_type = Layout_NCHW) {
+        init(data.data(), data.size(), layout_type);
+    }
 
-        for (int i = 0; i < right.size(); ++i) {
-            this->push_back(right[i]);
-        }
+    Shape(const Shape& right) = default;
+    Shape& operator=(const Shape& right) = default;
 
-        create_layout(right.get_layout());
+    operator vector() const {
+        return vector(begin(), end());
     }
 
-    Shape& operator=(const Shape& right) {
-        this->clear();
-
-        for (int i = 0; i < right.size(); ++i) {
-            this->push_back(right[i]);
+    size_t size() const {
+        return _size;
+    }
+    bool empty() const {
+        return _size == 0;
+    }
+    size_t capacity() const {
+        return MAX_DIMS;
+    }
+    void reserve(size_t size) {
+        CHECK_LE(size, MAX_DIMS) << "shape supports at most " << MAX_DIMS << " dims";
+    }
+    int* data() {
+        return _dims;
+    }
+    const int* data() const {
+        return _dims;
+    }
+    iterator begin() {
+        return _dims;
+    }
+    iterator end() {
+        return _dims + _size;
+    }
+    const_iterator begin() const {
+        return _dims;
+    }
+    const_iterator end() const {
+        return _dims + _size;
+    }
+    int& operator[](size_t i) {
+        return _dims[i];
+    }
+    const int& operator[](size_t i) const {
+        return _dims[i];
+    }
+    int& at(size_t i) {
+        CHECK_LT(i, _size);
+        return _dims[i];
+    }
+    const int& at(size_t i) const {
+        CHECK_LT(i, _size);
+        return _dims[i];
+    }
+    int& front() {
+        return _dims[0];
+    }
+    const int& front() const {
+        return _dims[0];
+    }
+    int& back() {
+        return _dims[_size - 1];
+    }
+    const int& back() const {
+        return _dims[_size - 1];
+    }
+    void push_back(int value) {
+        CHECK_LT(_size, MAX_DIMS) << "shape supports at most " << MAX_DIMS << " dims";
+        _dims[_size++] = value;
+    }
+    void pop_back() {
+        --_size;
+    }
+    void clear() {
+        _size = 0;
+    }
+    void resize(size_t size, int value = 0) {
+        CHECK_LE(size, MAX_DIMS) << "shape supports at most " << MAX_DIMS << " dims";
+        for (size_t i = _size; i < size; ++i) {
+            _dims[i] = value;
         }
-
-        delete _layout;
-        _layout = nullptr;
-        create_layout(right.get_layout());
-        return *this;
+        _size = size;
+    }
+    iterator insert(const_iterator pos, int value) {
+        CHECK_LT(_size, MAX_DIMS) << "shape supports at most " << MAX_DIMS << " dims";
+        int index = pos - _dims;
+        for (int i = _size; i > index; --i) {
+            _dims[i] = _dims[i - 1];
+        }
+        _dims[index] = value;
+        ++_size;
+        return _dims + index;
+    }
+    iterator erase(const_iterator pos) {
+        int index = pos - _dims;
+        for (int i = index; i + 1 < _size; ++i) {
+            _dims[i] = _dims[i + 1];
+        }
+        --_size;
+        return _dims + index;
     }
+
     Shape operator+(const Shape& shape) {
 
         Shape tmp_shape(*this);
@@ -183,40 +299,36 @@ public:
 
         return flag;
     }
+    bool operator!=(const Shape& shape) const {
+        return !(*this == shape);
+    }
+    //! compare the dims only, as the std::vector<int> base class did
+    bool operator==(const vector& dims) const {
+        return vector(begin(), end()) == dims;
+    }
+    bool operator!=(const vector& dims) const {
+        return !(*this == dims);
+    }
+    friend bool operator==(const vector& dims, const Shape& shape) {
+        return shape == dims;
+    }
+    friend bool operator!=(const vector& dims, const Shape& shape) {
+        return !(shape == dims);
+    }
     int num_index() const {
-        if (_layout) {
-            return _layout->num_index();
-        } else {
-            return -1;
-        }
+        return _layout->num_index;
     }
     int channel_index() const {
-        if (_layout) {
-            return _layout->channel_index();
-        } else {
-            return -1;
-        }
+        return _layout->channel_index;
     }
     int height_index() const {
-        if (_layout) {
-            return _layout->height_index();
-        } else {
-            return -1;
-        }
+        return _layout->height_index;
     }
     int width_index() const {
-        if (_layout) {
-            return _layout->width_index();
-        } else {
-            return -1;
-        }
+        return _layout->width_index;
     }
     int depth_index() const {
-        if (_layout) {
-            return _layout->depth_index();
-        } else {
-            return -1;
-        }
+        return _layout->depth_index;
     }
     int num() const {
         int shape_num = this->num_index() == -1 ? 1 : this->data()[this->num_index()];
@@ -225,8 +337,8 @@ public:
     int channel() const {
         int shape_channel = this->channel_index() == -1 ? 1 : this->data()[this->channel_index()];
 
-        if (_layout->inner_c() != -1) {
-            shape_channel *= _layout->inner_c();
+        if (_layout->inner_c != -1) {
+            shape_channel *= _layout->inner_c;
         }
 
         return shape_channel;
@@ -253,13 +365,14 @@ public:
         }
 
         long long sum = 1;
-        for_each(this->begin() + start, this->end(), [&](int n) {
-            sum *= n;
-        });
 
-        if (_layout->aligned_length() != -1 && start <= 1) {
+        for (int i = start; i < dims(); ++i) {
+            sum *= _dims[i];
+        }
+
+        if (_layout->aligned_length != -1 && start <= 1) {
             int channel_size = channel();
-            int aligned_length = _layout->aligned_length();
+            int aligned_length = _layout->aligned_length;
             sum = sum / channel_size * ((channel_size + aligned_length - 1) / aligned_length * aligned_length);
         }
 
@@ -284,9 +397,9 @@ public:
             sum *= data()[i];
         }
 
-        if (_layout->aligned_length() != -1 && start <= 1 && end > 1) {
+        if (_layout->aligned_length != -1 && start <= 1 && end > 1) {
             int channel_size = channel();
-            int aligned_length = _layout->aligned_length();
+            int aligned_length = _layout->aligned_length;
             sum = sum / channel_size * ((channel_size + aligned_length - 1) / aligned_length * aligned_length);
         }
 
@@ -324,7 +437,7 @@ public:
 
         return axis;
     }
-    bool is_continue(const Shape real_shape) const {
+    bool is_continue(const Shape& real_shape) const {
         if (real_shape.size() != this->size()) {
             return false;
         }
@@ -341,52 +454,48 @@ public:
         return true;
     }
     LayoutType get_layout() const {
-        if (_layout) {
-            return _layout->type();
-        } else {
-            return Layout_invalid;
-        }
+        return _layout_type;
     }
     void set_num(const int num) {
         CHECK_GT(num, 0);
 
-        if (_layout->num_index() != -1) {
-            this->data()[_layout->num_index()] = num;
+        if (_layout->num_index != -1) {
+            this->data()[_layout->num_index] = num;
         }
     }
     void set_channel(const int channel) {
         CHECK_GT(channel, 0);
 
-        if (_layout->channel_index() != -1) {
+        if (_layout->channel_index != -1) {
             int shape_channel = channel;
 
-            if (_layout->inner_c() != -1) {
-                CHECK_EQ(channel % _layout->inner_c(), 0);
-                shape_channel /= _layout->inner_c();
+            if (_layout->inner_c != -1) {
+                CHECK_EQ(channel % _layout->inner_c, 0);
+                shape_channel /= _layout->inner_c;
             }
 
-            this->data()[_layout->channel_index()] = shape_channel;
+            this->data()[_layout->channel_index] = shape_channel;
         }
     }
     void set_height(const int height) {
         CHECK_GT(height, 0);
 
-        if (_layout->height_index() != -1) {
-            this->data()[_layout->height_index()] = height;
+        if (_layout->height_index != -1) {
+            this->data()[_layout->height_index] = height;
         }
     }
     void set_width(const int width) {
         CHECK_GT(width, 0);
 
-        if (_layout->width_index() != -1) {
-            this->data()[_layout->width_index()] = width;
+        if (_layout->width_index != -1) {
+            this->data()[_layout->width_index] = width;
         }
     }
     void set_depth(const int depth) {
         CHECK_GT(depth, 0);
 
-        if (_layout->depth_index() != -1) {
-            this->data()[_layout->depth_index()] = depth;
+        if (_layout->depth_index != -1) {
+            this->data()[_layout->depth_index] = depth;
         }
     }
 
@@ -402,31 +511,19 @@ public:
         this->set_width(right.width());
 
     }
-//    void set_layout_without_shape(LayoutType layout_type) {
-//        Shape sh = *this;
-//        Layout* layout = this->_layout;
-//        create_layout(layout_type);
-//        delete layout;
-//
-//        if (sh._layout == nullptr) {
-//            return;
-//        }
-//    }
 
-
-    void set_layout(LayoutType layout_type, std::vector<int> new_shape = {}) {
+    void set_layout(LayoutType layout_type, const std::vector<int>& new_shape = {}) {
         Shape sh = *this;
-        Layout* layout = this->_layout;
         create_layout(layout_type);
 
-        if (sh._layout == nullptr || sh.empty()) {
+        if (sh.empty()) {
             return;
         }
 
         this->clear();
 
         if (new_shape.size() != 0) {
-            CHECK_EQ(_layout->dims(), new_shape.size()) << "new_shape dims miss match with layout dims";
+            CHECK_EQ(_layout->dims, new_shape.size()) << "new_shape dims miss match with layout dims";
 
             for (auto i : new_shape) {
                 this->push_back(i);
@@ -435,36 +532,34 @@ public:
             return;
         }
 
-        this->resize(_layout->dims());
+        this->resize(_layout->dims);
 
 
-        if (_layout->num_index() != -1) {
-            this->data()[_layout->num_index()] = sh.num();
+        if (_layout->num_index != -1) {
+            this->data()[_layout->num_index] = sh.num();
         }
 
-        if (_layout->channel_index() != -1) {
-            this->data()[_layout->channel_index()] = sh.channel();
+        if (_layout->channel_index != -1) {
+            this->data()[_layout->channel_index] = sh.channel();
 
-            if (_layout->inner_c() != -1) {
-                CHECK_EQ(sh.channel() % _layout->inner_c(), 0);
-                this->data()[_layout->channel_index()] /= _layout->inner_c();
-                this->data()[4] = _layout->inner_c();
+            if (_layout->inner_c != -1) {
+                CHECK_EQ(sh.channel() % _layout->inner_c, 0);
+                this->data()[_layout->channel_index] /= _layout->inner_c;
+                this->data()[4] = _layout->inner_c;
             }
         }
 
-        if (_layout->height_index() != -1) {
-            this->data()[_layout->height_index()] = sh.height();
+        if (_layout->height_index != -1) {
+            this->data()[_layout->height_index] = sh.height();
         }
 
-        if (_layout->width_index() != -1) {
-            this->data()[_layout->width_index()] = sh.width();
+        if (_layout->width_index != -1) {
+            this->data()[_layout->width_index] = sh.width();
         }
 
-        if (_layout->depth_index() != -1) {
-            this->data()[_layout->depth_index()] = sh.depth();
+        if (_layout->depth_index != -1) {
+            this->data()[_layout->depth_index] = sh.depth();
         }
-
-        delete layout;
     }
 
     static Shape zero(const Shape& right) {
@@ -488,9 +583,9 @@ public:
     }
 
     static Shape cvt_shape(const Shape& right,LayoutType layoutType) {
-        CHECK_EQ(right._layout->dims(),4)<<"only support 4 dim shape";
+        CHECK_EQ(right._layout->dims,4)<<"only support 4 dim shape";
         Shape sh({1,1,1,1},layoutType);
-        CHECK_EQ(sh._layout->dims(),4)<<"only support 4 dim shape";
+        CHECK_EQ(sh._layout->dims,4)<<"only support 4 dim shape";
         sh.set_num(right.num());
         sh.set_channel(right.channel());
         sh.set_height(right.height());
@@ -499,7 +594,7 @@ public:
     }
 
     int get_layout_aligned_length() {
-        return _layout->aligned_length();
+        return _layout->aligned_length;
     }
 #ifndef USE_SGX
     friend std::ostream& operator<<(std::ostream& out, const Shape& s) {
@@ -514,78 +609,35 @@ public:
 #endif
 
 protected:
-    Layout* _layout{nullptr};
+    int _dims[MAX_DIMS]{};
+    int _size{0};
+    LayoutType _layout_type{Layout_NCHW};
+    const LayoutDesc* _layout{nullptr};
 private:
-    void create_layout(LayoutType layout_type) {
-//        if(this->_layout != nullptr){
-//            delete this->_layout;
-//            this->_layout = nullptr;
-//        }
-
-        switch (layout_type) {
-        case Layout_invalid:
-            this->_layout = nullptr;
-            \
-            LOG(FATAL) << "The layout_type is invalid.";
-            break;
-
-        case Layout_W:
-            this->_layout = new W();
-            break;
-
-        case Layout_HW:
-            this->_layout = new HW();
-            break;
-
-        case Layout_WH:
-            this->_layout = new WH();
-            break;
-
-        case Layout_NC:
-            this->_layout = new NC();
-            break;
-
-        case Layout_NH:
-            this->_layout = new NH();
-            break;
-
-        case Layout_NW:
-            this->_layout = new NW();
-            break;
-
-        case Layout_NHW:
-            this->_layout = new NHW();
-            break;
-
-        case Layout_NCHW:
-            this->_layout = new NCHW();
-            break;
-
-        case Layout_NHWC:
-            this->_layout = new NHWC();
-            break;
-
-        case Layout_NCHW_C4:
-            this->_layout = new NCHW_C4();
-            break;
-
-        case Layout_NCHW_C8:
-            this->_layout = new NCHW_C8();
-            break;
-
-        case Layout_NCHW_C16:
-            this->_layout = new NCHW_C16();
-            break;
+    void init(const int* data, size_t size, LayoutType layout_type) {
+        create_layout(layout_type);
+        CHECK_EQ(_layout->dims, size) \
+                << "The shape from the vector must have the correct layout.";
 
-        case Layout_NCHW_C8R:
-            this->_layout = new NCHW_C8R();
-            break;
+        for (int i = 0; i < _layout->dims; ++i) {
+            this->push_back(data[i]);
+        }
 
-        case Layout_NCHW_C16R:
-            this->_layout = new NCHW_C16R();
-            break;
+        if (_layout->inner_c != -1) {
+            CHECK_EQ(data[4], _layout->inner_c) \
+                    << " Layout must be an integer multiple of "
+                    << _layout->inner_c;
         }
     }
+    void create_layout(LayoutType layout_type) {
+        if (layout_type < Layout_invalid || layout_type > Layout_NCHW_C16R
+                || LayoutDesc::get(layout_type).dims == -1) {
+            LOG(FATAL) << "The layout_type is invalid.";
+        }
+
+        _layout_type = layout_type;
+        _layout = &LayoutDesc::get(layout_type);
+    }
 };
 
 } //namespace saber
@@ -17,14 +17,13 @@
 #define ANAKIN_SABER_CORE_TARGET_WRAPPER_H
 #include "saber/core/target_traits.h"
 #include "saber/core/data_traits.h"
+#include "saber/core/host_allocator.h"
 #include <memory>
 
 namespace anakin{
 
 namespace saber {
 
-const int MALLOC_ALIGN = 64;
-
 
 static inline void* fast_malloc(size_t size) {
     size_t offset = sizeof(void*) + MALLOC_ALIGN - 1;
@@ -77,21 +76,21 @@ struct TargetWrapper<TargetType, __host_target> {
     }
 
     /**
-     * \brief wrapper of memory allocate function, with alignment of 16 bytes
+     * \brief wrapper of memory allocate function, with alignment of MALLOC_ALIGN bytes,
+     * the memory comes from HostAllocator::global()
      *
     */
     static void mem_alloc(void** ptr, size_t n) {
-        *ptr = (void*)fast_malloc(n);
-
+        *ptr = HostAllocator::global()->alloc(n);
     }
 
     /**
-     * \brief wrapper of memory free function
+     * \brief wrapper of memory free function, the block goes back to the allocator which created it
      *
     */
     static void mem_free(void* ptr) {
         if (ptr != nullptr) {
-            fast_free(ptr);
+            HostAllocator::free_block(ptr);
         }
     }
 
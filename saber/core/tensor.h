@@ -181,6 +181,9 @@ public:
             case AK_HALF: {
                 return sizeof(unsigned short);
             }
+            case AK_BFLOAT16: {
+                return sizeof(unsigned short);
+            }
             case AK_FLOAT: {
                 return sizeof(float);
             }
@@ -377,6 +380,13 @@ public:
         return _valid_shape.is_continue(_shape);
     }
 
+    /**
+     *  \brief Whether other tensors hold the same buffer.
+     */
+    bool is_buffer_shared() const {
+        return _buf.use_count() > 1;
+    }
+
     size_t capacity() const {
         return _buf->get_capacity();
     }
@@ -426,14 +436,14 @@ public:
     /**
      *  \brief Return tensor shape, entire memory buffer shape.
      */
-    Shape shape() const{
+    const Shape& shape() const{
         return _shape;
     }
 
     /**
      *  \brief Return valid shape of tensor
      */
-    Shape valid_shape() const {
+    const Shape& valid_shape() const {
         return _valid_shape;
     }
 
@@ -450,7 +460,7 @@ public:
     /**
      *  \brief Return tensor offset, which holds the offset in each dim.
      */
-    Shape offset() const {
+    const Shape& offset() const {
         return _offset;
     }
 
@@ -466,7 +476,7 @@ public:
      * \brief get sequence offset, lot tensor
      * @return
      */
-    std::vector<std::vector<int>> get_seq_offset() const {
+    const std::vector<std::vector<int>>& get_seq_offset() const {
         return _seq_offset;
     }
 
@@ -475,7 +485,8 @@ public:
      * @param seq_offset
      * @return
      */
-    SaberStatus set_seq_offset(std::vector<std::vector<int>> seq_offset) {
+    SaberStatus set_seq_offset(const std::vector<std::vector<int>>& seq_offset) {
+        //! copy assign reuses the capacity of the levels already held
         _seq_offset = seq_offset;
         return SaberSuccess;
     }
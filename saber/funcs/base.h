@@ -84,9 +84,9 @@ public:
         this->_param = param;
 
         //this->_last_input_shape = input[0]->valid_shape();
-        this->_last_input_shape.clear();
+        this->_last_input_shape.resize(input.size());
         for (int i = 0; i < input.size(); ++i) {
-            this->_last_input_shape.push_back(input[i]->valid_shape());
+            this->_last_input_shape[i] = input[i]->valid_shape();
         }
         this->_strategy = strategy; 
         std::for_each(this->_impl.begin(), this->_impl.end(), 
@@ -147,9 +147,9 @@ public:
         } else {
             _param = param;
 //            this->_last_input_shape = input[0]->valid_shape();
-            this->_last_input_shape.clear();
+            this->_last_input_shape.resize(input.size());
             for (int i = 0; i < input.size(); ++i) {
-                this->_last_input_shape.push_back(input[i]->valid_shape());
+                this->_last_input_shape[i] = input[i]->valid_shape();
             }
             reset_output_shape(input, output, param, ctx);
             pick_best(input, output, param, _strategy, _implenum, ctx);
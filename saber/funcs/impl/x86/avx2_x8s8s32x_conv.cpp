@@ -0,0 +1,457 @@
+#include "saber/funcs/impl/x86/avx2_x8s8s32x_conv.h"
+#include "saber/funcs/impl/x86/x86_utils.h"
+#include "anakin_thread.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <immintrin.h>
+
+namespace anakin {
+namespace saber {
+
+namespace {
+
+//! channels one depthwise kernel call computes
+const int DW_BLOCK = 8;
+//! weights quantized here stay in 7 bits, see PackedU8S8S32Gemm
+const float GEMM_WEIGHTS_MAX = 63.f;
+const float DW_WEIGHTS_MAX = 127.f;
+
+/**
+ * quantize goihw fp32 weights per output channel to [-max_int, max_int],
+ * keeping the scale of each channel.
+ */
+void quantize_weights(const Tensor<X86>& weights, Tensor<X86>& out, const float max_int) {
+    const int oc = weights.num();
+    const int inner = weights.valid_size() / oc;
+    const float* in_data = static_cast<const float*>(weights.data());
+    int8_t* out_data = static_cast<int8_t*>(out.mutable_data());
+    std::vector<float> scale(oc);
+
+    for (int o = 0; o < oc; ++o) {
+        const float* w = in_data + o * inner;
+        float max_val = 0.f;
+
+        for (int i = 0; i < inner; ++i) {
+            max_val = std::max(max_val, fabsf(w[i]));
+        }
+
+        scale[o] = max_val > 0.f ? max_val / max_int : 1.f;
+
+        for (int i = 0; i < inner; ++i) {
+            out_data[o * inner + i] = (int8_t)nearbyintf(w[i] / scale[o]);
+        }
+    }
+
+    out.set_scale(scale);
+}
+
+template <typename OutputDtype>
+inline OutputDtype cvt_output(float val);
+
+template <>
+inline float cvt_output<float>(float val) {
+    return val;
+}
+
+template <>
+inline int8_t cvt_output<int8_t>(float val) {
+    return (int8_t)std::min(std::max(nearbyintf(val), -128.f), 127.f);
+}
+
+template <>
+inline uint8_t cvt_output<uint8_t>(float val) {
+    return (uint8_t)std::min(std::max(nearbyintf(val), 0.f), 255.f);
+}
+
+//! dst = (acc + bias) * scale, then relu, num channels
+template <typename OutputDtype>
+inline void store_channels(const int32_t* acc, OutputDtype* dst, const int num,
+                           const float* bias, const float* scale, const bool with_relu) {
+    for (int i = 0; i < num; ++i) {
+        float val = (float)acc[i];
+
+        if (bias != nullptr) {
+            val += bias[i];
+        }
+
+        val *= scale[i];
+
+        if (with_relu && val < 0.f) {
+            val = 0.f;
+        }
+
+        dst[i] = cvt_output<OutputDtype>(val);
+    }
+}
+
+inline int32_t to_int32(int8_t val) {
+    return val;
+}
+
+inline int32_t to_int32(uint8_t val) {
+    return val;
+}
+
+} //namespace
+
+void Avx2X8S8S32XConv::init_conf(const std::vector<Tensor<X86>*>& inputs,
+                                 std::vector<Tensor<X86>*>& outputs,
+                                 ConvParam<X86>* conv_param) {
+    const Tensor<X86>* weights = conv_param->weight();
+    const Tensor<X86>* bias = conv_param->bias();
+    ConvConf& cf = _conf;
+    cf.mb = inputs[0]->num();
+    cf.ngroups = conv_param->group;
+    cf.ih = inputs[0]->height();
+    cf.iw = inputs[0]->width();
+    cf.ic = inputs[0]->channel() / cf.ngroups;
+    cf.oh = outputs[0]->height();
+    cf.ow = outputs[0]->width();
+    cf.oc = outputs[0]->channel() / cf.ngroups;
+    cf.kh = weights->height();
+    cf.kw = weights->width();
+    cf.stride_h = conv_param->stride_h;
+    cf.stride_w = conv_param->stride_w;
+    cf.pad_h = conv_param->pad_h;
+    cf.pad_w = conv_param->pad_w;
+    cf.dilation_h = conv_param->dilation_h;
+    cf.dilation_w = conv_param->dilation_w;
+    cf.signed_input = inputs[0]->get_dtype() == AK_INT8;
+    cf.is_dw = cf.ngroups > 1 && cf.ic == 1 && cf.oc == 1;
+    cf.read_input_rows = cf.kh == 1 && cf.kw == 1 && cf.pad_h == 0 && cf.pad_w == 0
+                         && !cf.signed_input;
+    cf.with_bias = bias != nullptr && bias->valid_size() > 0;
+    cf.with_relu = conv_param->activation_param.has_active;
+}
+
+SaberStatus Avx2X8S8S32XConv::init(const std::vector<Tensor<X86>*>& inputs,
+                                   std::vector<Tensor<X86>*>& outputs,
+                                   ConvEltwiseParam<X86>& param,
+                                   Context<X86>& ctx) {
+    this->_ctx = &ctx;
+    ConvParam<X86>* conv_param = &(param.conv_param);
+    CHECK_EQ(inputs[0]->get_layout(), Layout_NHWC) << "only support nhwc input";
+    CHECK_EQ(outputs[0]->get_layout(), Layout_NHWC) << "only support nhwc output";
+    CHECK(inputs[0]->get_dtype() == AK_UINT8 || inputs[0]->get_dtype() == AK_INT8)
+            << "not support input dtype " << inputs[0]->get_dtype();
+    CHECK_GT(inputs[0]->get_scale().size(), 0) << "only support input scale size > 0";
+
+    if (inputs[0]->channel() % conv_param->group != 0
+            || outputs[0]->channel() % conv_param->group != 0) {
+        LOG(ERROR) << "invalid input_channel or output_channel";
+        return SaberInvalidValue;
+    }
+
+    return create(inputs, outputs, param, ctx);
+}
+
+SaberStatus Avx2X8S8S32XConv::create(const std::vector<Tensor<X86>*>& inputs,
+                                     std::vector<Tensor<X86>*>& outputs,
+                                     ConvEltwiseParam<X86>& param,
+                                     Context<X86>& ctx) {
+    this->_ctx = &ctx;
+    ConvParam<X86>* conv_param = &(param.conv_param);
+    init_conf(inputs, outputs, conv_param);
+    const ConvConf& cf = _conf;
+    const int ks = cf.kh * cf.kw;
+
+    Tensor<X86>* weights_orig = conv_param->mutable_weight();
+
+    if (weights_orig->get_dtype() == AK_FLOAT) {
+        _weights_scale.re_alloc(weights_orig->valid_shape(), AK_INT8);
+        quantize_weights(*weights_orig, _weights_scale,
+                         cf.is_dw ? DW_WEIGHTS_MAX : GEMM_WEIGHTS_MAX);
+        weights_orig = &_weights_scale;
+    }
+
+    CHECK_EQ(weights_orig->get_dtype(), AK_INT8);
+    const int8_t* weights = static_cast<const int8_t*>(weights_orig->data());
+    std::vector<float> scale_w = weights_orig->get_scale();
+
+    if (scale_w.size() == 1) {
+        scale_w.resize(cf.oc * cf.ngroups, scale_w[0]);
+    }
+
+    CHECK_EQ(scale_w.size(), cf.oc * cf.ngroups) << "weights scale must be per tensor or per channel";
+
+    if (cf.is_dw) {
+        // channel blocks of 8, taps in pairs, the odd tap of a pair is zero
+        const int c_blocks = (cf.ngroups + DW_BLOCK - 1) / DW_BLOCK;
+        const int pairs = (ks + 1) / 2;
+        _dw_weights.re_alloc(Shape({1, c_blocks, pairs, DW_BLOCK * 2}), AK_INT16);
+        int16_t* dw = static_cast<int16_t*>(_dw_weights.mutable_data());
+        memset(dw, 0, sizeof(int16_t) * c_blocks * pairs * DW_BLOCK * 2);
+
+        for (int c = 0; c < cf.ngroups; ++c) {
+            for (int tap = 0; tap < ks; ++tap) {
+                int index = ((c / DW_BLOCK * pairs + tap / 2) * DW_BLOCK + c % DW_BLOCK) * 2 + tap % 2;
+                dw[index] = weights[c * ks + tap];
+            }
+        }
+
+        std::vector<PackedU8S8S32Gemm>().swap(_gemm);
+    } else {
+        // gemm k runs over (kh, kw, ic) as the im2col row does
+        const int k = ks * cf.ic;
+        std::vector<int8_t> weights_g(cf.oc * k);
+        _gemm.resize(cf.ngroups);
+
+        for (int g = 0; g < cf.ngroups; ++g) {
+            for (int o = 0; o < cf.oc; ++o) {
+                const int8_t* w = weights + (g * cf.oc + o) * cf.ic * ks;
+
+                for (int i = 0; i < cf.ic; ++i) {
+                    for (int tap = 0; tap < ks; ++tap) {
+                        weights_g[o * k + tap * cf.ic + i] = w[i * ks + tap];
+                    }
+                }
+            }
+
+            _gemm[g].init(true, cf.oc, k, weights_g.data(), k);
+        }
+    }
+
+    // scales, u8 tensors are quantized to 255 instead of 127
+    const float u8_ratio = 127.f / 255.f;
+    float scale_in = inputs[0]->get_scale()[0];
+
+    if (inputs[0]->get_dtype() == AK_UINT8) {
+        scale_in *= u8_ratio;
+    }
+
+    float scale_out = 1.f;
+
+    if (outputs[0]->get_scale().size() > 0 && outputs[0]->get_dtype() != AK_FLOAT) {
+        scale_out = outputs[0]->get_scale()[0];
+
+        if (outputs[0]->get_dtype() == AK_UINT8) {
+            scale_out *= u8_ratio;
+        }
+    }
+
+    const int oc_total = cf.oc * cf.ngroups;
+    _scale.resize(oc_total);
+
+    for (int i = 0; i < oc_total; ++i) {
+        _scale[i] = scale_w[i] * scale_in / scale_out;
+    }
+
+    std::vector<float>().swap(_bias);
+
+    if (cf.with_bias) {
+        const Tensor<X86>* bias = conv_param->bias();
+        CHECK_EQ(bias->get_dtype(), AK_FLOAT);
+        CHECK_EQ(bias->valid_size(), oc_total);
+        const float* bias_data = static_cast<const float*>(bias->data());
+        _bias.resize(oc_total);
+
+        for (int i = 0; i < oc_total; ++i) {
+            _bias[i] = bias_data[i] / (scale_w[i] * scale_in);
+        }
+    }
+
+    _thread_num = anakin_get_max_threads();
+
+    if (!cf.is_dw) {
+        const int col_size = cf.read_input_rows ? 1 : cf.ow * ks * cf.ic;
+        _col_tensor.re_alloc(Shape({1, 1, _thread_num, col_size}, Layout_NCHW), AK_UINT8);
+        _acc_tensor.re_alloc(Shape({1, 1, _thread_num, cf.ow * cf.oc}, Layout_NCHW), AK_INT32);
+    }
+
+    return SaberSuccess;
+}
+
+template <typename InputDtype, typename OutputDtype>
+void Avx2X8S8S32XConv::gemm_conv_row(const InputDtype* src, OutputDtype* dst,
+                                     int n, int oh, int ithr) {
+    const ConvConf& cf = _conf;
+    const int ks = cf.kh * cf.kw;
+    const int k = ks * cf.ic;
+    const int in_c = cf.ic * cf.ngroups;
+    const int out_c = cf.oc * cf.ngroups;
+    const uint8_t pad_value = cf.signed_input ? 128 : 0;
+    uint8_t* col = static_cast<uint8_t*>(_col_tensor.mutable_data())
+                   + (size_t)ithr * (_col_tensor.valid_size() / _thread_num);
+    int32_t* acc = static_cast<int32_t*>(_acc_tensor.mutable_data()) + (size_t)ithr * cf.ow * cf.oc;
+    const InputDtype* src_n = src + (size_t)n * cf.ih * cf.iw * in_c;
+    OutputDtype* dst_row = dst + ((size_t)n * cf.oh + oh) * cf.ow * out_c;
+
+    for (int g = 0; g < cf.ngroups; ++g) {
+        const uint8_t* a = nullptr;
+        int lda = k;
+
+        if (cf.read_input_rows) {
+            a = reinterpret_cast<const uint8_t*>(src_n + (size_t)oh * cf.stride_h * cf.iw * in_c
+                                                 + g * cf.ic);
+            lda = cf.stride_w * in_c;
+        } else {
+            for (int ow = 0; ow < cf.ow; ++ow) {
+                for (int kh = 0; kh < cf.kh; ++kh) {
+                    const int ih = oh * cf.stride_h - cf.pad_h + kh * cf.dilation_h;
+
+                    for (int kw = 0; kw < cf.kw; ++kw) {
+                        const int iw = ow * cf.stride_w - cf.pad_w + kw * cf.dilation_w;
+                        uint8_t* col_tap = col + (size_t)ow * k + (kh * cf.kw + kw) * cf.ic;
+
+                        if (ih < 0 || ih >= cf.ih || iw < 0 || iw >= cf.iw) {
+                            memset(col_tap, pad_value, cf.ic);
+                        } else {
+                            const InputDtype* in = src_n + ((size_t)ih * cf.iw + iw) * in_c + g * cf.ic;
+
+                            if (cf.signed_input) {
+                                PackedU8S8S32Gemm::shift_s8_to_u8(
+                                    reinterpret_cast<const int8_t*>(in), col_tap, cf.ic);
+                            } else {
+                                memcpy(col_tap, in, cf.ic);
+                            }
+                        }
+                    }
+                }
+            }
+
+            a = col;
+        }
+
+        _gemm[g].compute(cf.ow, a, lda, acc, cf.oc, cf.signed_input);
+
+        const float* bias = cf.with_bias ? _bias.data() + g * cf.oc : nullptr;
+        const float* scale = _scale.data() + g * cf.oc;
+
+        for (int ow = 0; ow < cf.ow; ++ow) {
+            store_channels(acc + ow * cf.oc, dst_row + (size_t)ow * out_c + g * cf.oc, cf.oc,
+                           bias, scale, cf.with_relu);
+        }
+    }
+}
+
+template <typename InputDtype, typename OutputDtype>
+void Avx2X8S8S32XConv::dw_conv_row(const InputDtype* src, OutputDtype* dst, int n, int oh) {
+    const ConvConf& cf = _conf;
+    const int channels = cf.ngroups;
+    const int ks = cf.kh * cf.kw;
+    const int pairs = (ks + 1) / 2;
+    const int16_t* weights = static_cast<const int16_t*>(_dw_weights.data());
+    const InputDtype* src_n = src + (size_t)n * cf.ih * cf.iw * channels;
+    OutputDtype* dst_row = dst + ((size_t)n * cf.oh + oh) * cf.ow * channels;
+    const float* bias = cf.with_bias ? _bias.data() : nullptr;
+    // input offset of every tap, -1 for padding
+    std::vector<int64_t> tap_offset(pairs * 2);
+    int32_t acc[DW_BLOCK];
+
+    for (int ow = 0; ow < cf.ow; ++ow) {
+        for (int tap = 0; tap < pairs * 2; ++tap) {
+            const int ih = oh * cf.stride_h - cf.pad_h + tap / cf.kw * cf.dilation_h;
+            const int iw = ow * cf.stride_w - cf.pad_w + tap % cf.kw * cf.dilation_w;
+            const bool valid = tap < ks && ih >= 0 && ih < cf.ih && iw >= 0 && iw < cf.iw;
+            tap_offset[tap] = valid ? ((int64_t)ih * cf.iw + iw) * channels : -1;
+        }
+
+        OutputDtype* out = dst_row + (size_t)ow * channels;
+        int c = 0;
+#if defined(__AVX2__)
+
+        for (; c + DW_BLOCK <= channels; c += DW_BLOCK) {
+            const int16_t* w = weights + c / DW_BLOCK * pairs * DW_BLOCK * 2;
+            __m256i vacc = _mm256_setzero_si256();
+
+            for (int p = 0; p < pairs; ++p) {
+                const int64_t off0 = tap_offset[2 * p];
+                const int64_t off1 = tap_offset[2 * p + 1];
+                const __m128i x0 = off0 >= 0 ? _mm_loadl_epi64((const __m128i*)(src_n + off0 + c)) :
+                                   _mm_setzero_si128();
+                const __m128i x1 = off1 >= 0 ? _mm_loadl_epi64((const __m128i*)(src_n + off1 + c)) :
+                                   _mm_setzero_si128();
+                // (tap0, tap1) byte pairs per channel, widened to int16
+                const __m128i x01 = _mm_unpacklo_epi8(x0, x1);
+                const __m256i x16 = cf.signed_input ? _mm256_cvtepi8_epi16(x01) :
+                                    _mm256_cvtepu8_epi16(x01);
+                const __m256i w16 = _mm256_loadu_si256((const __m256i*)(w + p * DW_BLOCK * 2));
+                vacc = _mm256_add_epi32(vacc, _mm256_madd_epi16(x16, w16));
+            }
+
+            _mm256_storeu_si256((__m256i*)acc, vacc);
+            store_channels(acc, out + c, DW_BLOCK, bias != nullptr ? bias + c : nullptr,
+                           _scale.data() + c, cf.with_relu);
+        }
+
+#endif
+
+        for (; c < channels; c += DW_BLOCK) {
+            const int num = std::min(DW_BLOCK, channels - c);
+            const int16_t* w = weights + c / DW_BLOCK * pairs * DW_BLOCK * 2;
+
+            for (int i = 0; i < num; ++i) {
+                int32_t sum = 0;
+
+                for (int tap = 0; tap < pairs * 2; ++tap) {
+                    if (tap_offset[tap] >= 0) {
+                        sum += to_int32(src_n[tap_offset[tap] + c + i])
+                               * w[(tap / 2 * DW_BLOCK + i) * 2 + tap % 2];
+                    }
+                }
+
+                acc[i] = sum;
+            }
+
+            store_channels(acc, out + c, num, bias != nullptr ? bias + c : nullptr,
+                           _scale.data() + c, cf.with_relu);
+        }
+    }
+}
+
+template <typename InputDtype, typename OutputDtype>
+SaberStatus Avx2X8S8S32XConv::sub_dispatch(const std::vector<Tensor<X86>*>& inputs,
+        std::vector<Tensor<X86>*>& outputs) {
+    const ConvConf& cf = _conf;
+    const InputDtype* src = static_cast<const InputDtype*>(inputs[0]->data());
+    OutputDtype* dst = static_cast<OutputDtype*>(outputs[0]->mutable_data());
+
+    if (cf.is_dw) {
+        #pragma omp parallel for collapse(2) schedule(static)
+
+        for (int n = 0; n < cf.mb; ++n) {
+            for (int oh = 0; oh < cf.oh; ++oh) {
+                dw_conv_row(src, dst, n, oh);
+            }
+        }
+    } else {
+        #pragma omp parallel for collapse(2) schedule(static) num_threads(_thread_num)
+
+        for (int n = 0; n < cf.mb; ++n) {
+            for (int oh = 0; oh < cf.oh; ++oh) {
+                gemm_conv_row(src, dst, n, oh, anakin_get_thread_num());
+            }
+        }
+    }
+
+    return SaberSuccess;
+}
+
+SaberStatus Avx2X8S8S32XConv::dispatch(const std::vector<Tensor<X86>*>& inputs,
+                                       std::vector<Tensor<X86>*>& outputs,
+                                       ConvEltwiseParam<X86>& param) {
+    DLOG(INFO) << "dispatch Avx2X8S8S32XConv";
+    const DataType in_dtype = inputs[0]->get_dtype();
+    const DataType out_dtype = outputs[0]->get_dtype();
+
+    if (in_dtype == AK_UINT8 && out_dtype == AK_FLOAT) {
+        return sub_dispatch<uint8_t, float>(inputs, outputs);
+    } else if (in_dtype == AK_UINT8 && out_dtype == AK_UINT8) {
+        return sub_dispatch<uint8_t, uint8_t>(inputs, outputs);
+    } else if (in_dtype == AK_UINT8 && out_dtype == AK_INT8) {
+        return sub_dispatch<uint8_t, int8_t>(inputs, outputs);
+    } else if (in_dtype == AK_INT8 && out_dtype == AK_FLOAT) {
+        return sub_dispatch<int8_t, float>(inputs, outputs);
+    } else if (in_dtype == AK_INT8 && out_dtype == AK_UINT8) {
+        return sub_dispatch<int8_t, uint8_t>(inputs, outputs);
+    } else if (in_dtype == AK_INT8 && out_dtype == AK_INT8) {
+        return sub_dispatch<int8_t, int8_t>(inputs, outputs);
+    }
+
+    LOG(FATAL) << "not support dtype " << in_dtype << "," << out_dtype;
+    return SaberUnImplError;
+}
+
+} // namespace saber
+} // namespace anakin
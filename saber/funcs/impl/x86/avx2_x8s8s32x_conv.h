@@ -0,0 +1,107 @@
+/* Copyright (c) 2018 Anakin Authors All Rights Reserve.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License. */
+
+#ifndef ANAKIN_SABER_FUNCS_IMPL_X86_AVX2_X8S8S32X_CONV_H
+#define ANAKIN_SABER_FUNCS_IMPL_X86_AVX2_X8S8S32X_CONV_H
+
+#include <vector>
+#include "saber/funcs/impl/impl_base.h"
+#include "saber/funcs/impl/impl_macro.h"
+#include "saber/funcs/impl/x86/packed_u8s8s32_gemm.h"
+
+namespace anakin {
+namespace saber {
+
+/**
+ * \brief int8 convolution for cpus without avx512, nhwc u8 or s8 input, nhwc output.
+ * depthwise conv runs a direct kernel accumulating tap pairs with vpmaddwd,
+ * the others run PackedU8S8S32Gemm per group on one output row at a time,
+ * the row is read in place for unsigned 1x1 conv without padding and im2col'ed otherwise.
+ */
+class Avx2X8S8S32XConv :
+    public ImplBase <
+    X86,
+    AK_INT8,
+    ConvEltwiseParam<X86> > {
+public:
+    typedef typename DataTrait<X86, AK_INT8>::Dtype OpDataType;
+
+    Avx2X8S8S32XConv() {}
+    ~Avx2X8S8S32XConv() {}
+
+    virtual SaberStatus init(const std::vector<Tensor<X86>*>& inputs,
+                             std::vector<Tensor<X86>*>& outputs,
+                             ConvEltwiseParam<X86>& param,
+                             Context<X86>& ctx);
+
+    virtual SaberStatus create(const std::vector<Tensor<X86>*>& inputs,
+                               std::vector<Tensor<X86>*>& outputs,
+                               ConvEltwiseParam<X86>& param,
+                               Context<X86>& ctx);
+
+    virtual SaberStatus dispatch(const std::vector<Tensor<X86>*>& inputs,
+                                 std::vector<Tensor<X86>*>& outputs,
+                                 ConvEltwiseParam<X86>& param);
+
+private:
+    struct ConvConf {
+        int mb;
+        int ngroups;
+        int ih, iw, ic;
+        int oh, ow, oc;
+        int kh, kw;
+        int stride_h, stride_w;
+        int pad_h, pad_w;
+        int dilation_h, dilation_w;
+        bool signed_input;
+        bool is_dw;
+        //! 1x1 conv without padding on unsigned input, a row of the input is a gemm operand
+        bool read_input_rows;
+        bool with_bias;
+        bool with_relu;
+    };
+
+    template <typename InputDtype, typename OutputDtype>
+    SaberStatus sub_dispatch(const std::vector<Tensor<X86>*>& inputs,
+                             std::vector<Tensor<X86>*>& outputs);
+
+    template <typename InputDtype, typename OutputDtype>
+    void gemm_conv_row(const InputDtype* src, OutputDtype* dst, int n, int oh, int ithr);
+
+    template <typename InputDtype, typename OutputDtype>
+    void dw_conv_row(const InputDtype* src, OutputDtype* dst, int n, int oh);
+
+    void init_conf(const std::vector<Tensor<X86>*>& inputs,
+                   std::vector<Tensor<X86>*>& outputs,
+                   ConvParam<X86>* conv_param);
+
+    ConvConf _conf;
+    int _thread_num{1};
+    //! one packed gemm per group
+    std::vector<PackedU8S8S32Gemm> _gemm;
+    //! depthwise weights, [c / 8][tap pairs][8][2] int16
+    Tensor<X86> _dw_weights;
+    Tensor<X86> _weights_scale;
+    Tensor<X86> _col_tensor;
+    Tensor<X86> _acc_tensor;
+    //! bias divided by the input and weights scales, added to the int32 result
+    std::vector<float> _bias;
+    //! int32 result to output scale per output channel
+    std::vector<float> _scale;
+};
+
+} // namespace saber
+} // namespace anakin
+
+#endif // ANAKIN_SABER_FUNCS_IMPL_X86_AVX2_X8S8S32X_CONV_H
@@ -0,0 +1,202 @@
+#include "saber/funcs/impl/x86/dynamic_quant_helper.h"
+#include <algorithm>
+#include <cmath>
+#include <immintrin.h>
+
+namespace anakin {
+
+namespace saber {
+
+namespace {
+
+//! element count below this is quantized by the calling thread only
+const int64_t QUANT_PARALLEL_MIN = 1 << 15;
+//! elements one thread takes in one piece of work of dynamic_quantize_s8
+const int64_t QUANT_CHUNK = 1 << 14;
+const float QUANT_MAX = 127.f;
+
+inline float abs_max(const float* src, const int64_t size) {
+    int64_t i = 0;
+    float max_val = 0.f;
+#if defined(__AVX512F__)
+    __m512 vmax = _mm512_setzero_ps();
+
+    for (; i + 16 <= size; i += 16) {
+        vmax = _mm512_max_ps(vmax, _mm512_abs_ps(_mm512_loadu_ps(src + i)));
+    }
+
+    max_val = _mm512_reduce_max_ps(vmax);
+#elif defined(__AVX2__)
+    const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+    __m256 vmax = _mm256_setzero_ps();
+
+    for (; i + 8 <= size; i += 8) {
+        vmax = _mm256_max_ps(vmax, _mm256_and_ps(_mm256_loadu_ps(src + i), abs_mask));
+    }
+
+    __m128 max4 = _mm_max_ps(_mm256_castps256_ps128(vmax), _mm256_extractf128_ps(vmax, 1));
+    max4 = _mm_max_ps(max4, _mm_movehl_ps(max4, max4));
+    max4 = _mm_max_ss(max4, _mm_shuffle_ps(max4, max4, 1));
+    max_val = _mm_cvtss_f32(max4);
+#endif
+
+    for (; i < size; ++i) {
+        max_val = std::max(max_val, fabsf(src[i]));
+    }
+
+    return max_val;
+}
+
+//! dst = round(src * scale), plus 128 when shift, the caller keeps |src * scale| <= QUANT_MAX
+template <bool shift>
+inline void quantize(const float* src, uint8_t* dst, const int64_t size, const float scale) {
+    int64_t i = 0;
+#if defined(__AVX512F__)
+    const __m512 vscale = _mm512_set1_ps(scale);
+    const __m128i sign = _mm_set1_epi8(shift ? (char)0x80 : 0);
+
+    for (; i + 16 <= size; i += 16) {
+        __m512i v = _mm512_cvtps_epi32(_mm512_mul_ps(_mm512_loadu_ps(src + i), vscale));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_xor_si128(_mm512_cvtsepi32_epi8(v), sign));
+    }
+
+#elif defined(__AVX2__)
+    const __m256 vscale = _mm256_set1_ps(scale);
+    const __m256i sign = _mm256_set1_epi8(shift ? (char)0x80 : 0);
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    for (; i + 32 <= size; i += 32) {
+        __m256i v0 = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(src + i), vscale));
+        __m256i v1 = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(src + i + 8), vscale));
+        __m256i v2 = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(src + i + 16), vscale));
+        __m256i v3 = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(src + i + 24), vscale));
+        __m256i s01 = _mm256_packs_epi32(v0, v1);
+        __m256i s23 = _mm256_packs_epi32(v2, v3);
+        __m256i s8 = _mm256_permutevar8x32_epi32(_mm256_packs_epi16(s01, s23), order);
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_xor_si256(s8, sign));
+    }
+
+#endif
+
+    for (; i < size; ++i) {
+        float val = nearbyintf(src[i] * scale);
+        val = std::min(std::max(val, -QUANT_MAX), QUANT_MAX);
+        dst[i] = (uint8_t)((int)val + (shift ? 128 : 0));
+    }
+}
+
+template <bool shift>
+void quantize_rows(const float* src, uint8_t* dst, const int m, const int k, float* row_scale,
+                   const float quant_max) {
+    #pragma omp parallel for schedule(static) if ((int64_t)m * k >= QUANT_PARALLEL_MIN)
+
+    for (int i = 0; i < m; ++i) {
+        const float* src_row = src + (int64_t)i * k;
+        float max_val = abs_max(src_row, k);
+        row_scale[i] = max_val / quant_max;
+        quantize<shift>(src_row, dst + (int64_t)i * k, k, max_val > 0.f ? quant_max / max_val : 0.f);
+    }
+}
+
+} //namespace
+
+void dynamic_quantize_rows_s8(const float* src, int8_t* dst, const int m, const int k,
+                              float* row_scale, const float quant_max) {
+    quantize_rows<false>(src, reinterpret_cast<uint8_t*>(dst), m, k, row_scale, quant_max);
+}
+
+void dynamic_quantize_rows_shifted_u8(const float* src, uint8_t* dst, const int m, const int k,
+                                      float* row_scale) {
+    quantize_rows<true>(src, dst, m, k, row_scale, QUANT_MAX);
+}
+
+void dynamic_quantize_cols_s8(const float* src, int8_t* dst, const int k, const int n,
+                              float* col_scale, const float quant_max) {
+    std::fill(col_scale, col_scale + n, 0.f);
+
+    for (int i = 0; i < k; ++i) {
+        const float* src_row = src + (int64_t)i * n;
+
+        for (int j = 0; j < n; ++j) {
+            col_scale[j] = std::max(col_scale[j], fabsf(src_row[j]));
+        }
+    }
+
+    for (int j = 0; j < n; ++j) {
+        col_scale[j] /= quant_max;
+    }
+
+    #pragma omp parallel for schedule(static) if ((int64_t)k * n >= QUANT_PARALLEL_MIN)
+
+    for (int i = 0; i < k; ++i) {
+        const float* src_row = src + (int64_t)i * n;
+        int8_t* dst_row = dst + (int64_t)i * n;
+
+        for (int j = 0; j < n; ++j) {
+            float val = col_scale[j] > 0.f ? nearbyintf(src_row[j] / col_scale[j]) : 0.f;
+            dst_row[j] = (int8_t)std::min(std::max(val, -quant_max), quant_max);
+        }
+    }
+}
+
+float dynamic_quantize_s8(const float* src, int8_t* dst, const size_t size) {
+    const int64_t chunk_num = ((int64_t)size + QUANT_CHUNK - 1) / QUANT_CHUNK;
+    float max_val = 0.f;
+
+    #pragma omp parallel for reduction(max : max_val) schedule(static) if ((int64_t)size >= QUANT_PARALLEL_MIN)
+
+    for (int64_t c = 0; c < chunk_num; ++c) {
+        int64_t begin = c * QUANT_CHUNK;
+        int64_t len = std::min(QUANT_CHUNK, (int64_t)size - begin);
+        max_val = std::max(max_val, abs_max(src + begin, len));
+    }
+
+    const float scale = max_val > 0.f ? QUANT_MAX / max_val : 0.f;
+
+    #pragma omp parallel for schedule(static) if ((int64_t)size >= QUANT_PARALLEL_MIN)
+
+    for (int64_t c = 0; c < chunk_num; ++c) {
+        int64_t begin = c * QUANT_CHUNK;
+        int64_t len = std::min(QUANT_CHUNK, (int64_t)size - begin);
+        quantize<false>(src + begin, reinterpret_cast<uint8_t*>(dst) + begin, len, scale);
+    }
+
+    return max_val / QUANT_MAX;
+}
+
+void dynamic_dequantize_rows(const int32_t* src, float* dst, const int m, const int n,
+                             const float* row_scale, const float* col_scale,
+                             const float* bias, const float alpha) {
+    #pragma omp parallel for schedule(static) if ((int64_t)m * n >= QUANT_PARALLEL_MIN)
+
+    for (int i = 0; i < m; ++i) {
+        const int32_t* src_row = src + (int64_t)i * n;
+        float* dst_row = dst + (int64_t)i * n;
+        const float scale = alpha * row_scale[i];
+        int j = 0;
+#if defined(__AVX2__)
+        const __m256 vscale = _mm256_set1_ps(scale);
+
+        for (; j + 8 <= n; j += 8) {
+            __m256 val = _mm256_cvtepi32_ps(_mm256_loadu_si256((const __m256i*)(src_row + j)));
+            val = _mm256_mul_ps(_mm256_mul_ps(val, vscale), _mm256_loadu_ps(col_scale + j));
+
+            if (bias != nullptr) {
+                val = _mm256_add_ps(val, _mm256_loadu_ps(bias + j));
+            }
+
+            _mm256_storeu_ps(dst_row + j, val);
+        }
+
+#endif
+
+        for (; j < n; ++j) {
+            float val = (float)src_row[j] * scale * col_scale[j];
+            dst_row[j] = bias != nullptr ? val + bias[j] : val;
+        }
+    }
+}
+
+} //namespace saber
+
+} //namespace anakin
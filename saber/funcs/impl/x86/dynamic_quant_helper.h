@@ -0,0 +1,61 @@
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef ANAKIN_SABER_FUNCS_IMPL_X86_DYNAMIC_QUANT_HELPER_H
+#define ANAKIN_SABER_FUNCS_IMPL_X86_DYNAMIC_QUANT_HELPER_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace anakin {
+
+namespace saber {
+
+//! weights quantized to this keep the vpmaddubsw kernel of PackedU8S8S32Gemm, which takes |b| <= 64
+const float DYNAMIC_QUANT_MADD_WEIGHTS_MAX = 63.f;
+
+/**
+ * \brief runtime quantization of fp32 activations for the int8 gemms, no calibrated scale needed.
+ * a row is scanned for its absolute max and quantized to [-quant_max, quant_max] right after,
+ * while it is still in cache, rows run in parallel.
+ * scale[i] is the fp32 value of one int8 step of row i, 0 for a row of zeros.
+ */
+void dynamic_quantize_rows_s8(const float* src, int8_t* dst, const int m, const int k,
+                              float* row_scale, const float quant_max = 127.f);
+
+//! as dynamic_quantize_rows_s8 with 128 added, the shifted a of PackedU8S8S32Gemm
+void dynamic_quantize_rows_shifted_u8(const float* src, uint8_t* dst, const int m, const int k,
+                                      float* row_scale);
+
+//! src is k x n row major, one scale per column, the per output channel weights scale
+void dynamic_quantize_cols_s8(const float* src, int8_t* dst, const int k, const int n,
+                              float* col_scale, const float quant_max = 127.f);
+
+//! one scale for the whole batch, which is returned
+float dynamic_quantize_s8(const float* src, int8_t* dst, const size_t size);
+
+/**
+ * \brief dst = alpha * src * row_scale[i] * col_scale[j] + bias[j], the int32 gemm result back to fp32.
+ * bias may be nullptr, dst may alias src.
+ */
+void dynamic_dequantize_rows(const int32_t* src, float* dst, const int m, const int n,
+                             const float* row_scale, const float* col_scale,
+                             const float* bias, const float alpha = 1.f);
+
+} //namespace saber
+
+} //namespace anakin
+
+#endif //ANAKIN_SABER_FUNCS_IMPL_X86_DYNAMIC_QUANT_HELPER_H
@@ -0,0 +1,239 @@
+#include "saber/funcs/impl/x86/half_convert_helper.h"
+#include "saber/core/common.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <immintrin.h>
+
+namespace anakin {
+
+namespace saber {
+
+namespace {
+
+//! element count below this is converted by the calling thread only
+const int64_t CONVERT_PARALLEL_MIN = 1 << 16;
+//! elements one thread takes in one piece of work
+const int64_t CONVERT_CHUNK = 1 << 14;
+
+inline uint32_t fp32_bits(const float val) {
+    uint32_t bits;
+    memcpy(&bits, &val, sizeof(bits));
+    return bits;
+}
+
+inline float bits_fp32(const uint32_t bits) {
+    float val;
+    memcpy(&val, &bits, sizeof(val));
+    return val;
+}
+
+inline uint16_t fp32_to_fp16_scalar(const float src) {
+    // scale by 2^112 then 2^-110 to let the fpu round the mantissa for both
+    // normal and subnormal results, then rebias the exponent
+    const float scale_to_inf = bits_fp32(0x77800000u);
+    const float scale_to_zero = bits_fp32(0x08800000u);
+    float base = (std::abs(src) * scale_to_inf) * scale_to_zero;
+    const uint32_t w = fp32_bits(src);
+    const uint32_t shl1_w = w + w;
+    const uint32_t sign = w & 0x80000000u;
+    uint32_t bias = shl1_w & 0xff000000u;
+
+    if (bias < 0x71000000u) {
+        bias = 0x71000000u;
+    }
+
+    base = bits_fp32((bias >> 1) + 0x07800000u) + base;
+    const uint32_t bits = fp32_bits(base);
+    const uint32_t exp_bits = (bits >> 13) & 0x00007c00u;
+    const uint32_t mantissa_bits = bits & 0x00000fffu;
+    const uint32_t nonsign = exp_bits + mantissa_bits;
+    return (uint16_t)((sign >> 16) | (shl1_w > 0xff000000u ? 0x7e00u : nonsign));
+}
+
+inline float fp16_to_fp32_scalar(const uint16_t src) {
+    const uint32_t w = (uint32_t)src << 16;
+    const uint32_t sign = w & 0x80000000u;
+    const uint32_t two_w = w + w;
+    // normal values, and inf / nan, with the exponent rebiased by 2^-112
+    const float normalized = bits_fp32((two_w >> 4) + (0xe0u << 23)) * bits_fp32(0x07800000u);
+    // subnormal values through the magic 0.5 bias
+    const float denormalized = bits_fp32((two_w >> 17) | (126u << 23)) - 0.5f;
+    const uint32_t result = sign | (two_w < (1u << 27) ? fp32_bits(denormalized) :
+                                    fp32_bits(normalized));
+    return bits_fp32(result);
+}
+
+inline uint16_t fp32_to_bf16_scalar(const float src) {
+    const uint32_t bits = fp32_bits(src);
+
+    if ((bits & 0x7fffffffu) > 0x7f800000u) {
+        return (uint16_t)((bits >> 16) | 0x40u);
+    }
+
+    return (uint16_t)((bits + 0x7fffu + ((bits >> 16) & 1u)) >> 16);
+}
+
+inline float bf16_to_fp32_scalar(const uint16_t src) {
+    return bits_fp32((uint32_t)src << 16);
+}
+
+void fp32_to_half_serial(const float* src, uint16_t* dst, const int64_t size,
+                         const DataType dtype) {
+    int64_t i = 0;
+
+    if (dtype == AK_HALF) {
+#if defined(__AVX512F__)
+
+        for (; i + 16 <= size; i += 16) {
+            __m256i h = _mm512_cvtps_ph(_mm512_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+            _mm256_storeu_si256((__m256i*)(dst + i), h);
+        }
+
+#elif defined(__AVX2__) && defined(__F16C__)
+
+        for (; i + 8 <= size; i += 8) {
+            __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT);
+            _mm_storeu_si128((__m128i*)(dst + i), h);
+        }
+
+#endif
+
+        for (; i < size; ++i) {
+            dst[i] = fp32_to_fp16_scalar(src[i]);
+        }
+
+        return;
+    }
+
+#if defined(__AVX512F__)
+    const __m512i round = _mm512_set1_epi32(0x7fff);
+    const __m512i one = _mm512_set1_epi32(1);
+    const __m512i quiet = _mm512_set1_epi32(0x40);
+
+    for (; i + 16 <= size; i += 16) {
+        __m512 v = _mm512_loadu_ps(src + i);
+        __m512i x = _mm512_castps_si512(v);
+        __m512i hi = _mm512_srli_epi32(x, 16);
+        __m512i r = _mm512_srli_epi32(_mm512_add_epi32(_mm512_add_epi32(x, round),
+                                      _mm512_and_si512(hi, one)), 16);
+        __mmask16 nan = _mm512_cmp_ps_mask(v, v, _CMP_UNORD_Q);
+        r = _mm512_mask_mov_epi32(r, nan, _mm512_or_si512(hi, quiet));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm512_cvtepi32_epi16(r));
+    }
+
+#elif defined(__AVX2__)
+    const __m256i round = _mm256_set1_epi32(0x7fff);
+    const __m256i one = _mm256_set1_epi32(1);
+    const __m256i quiet = _mm256_set1_epi32(0x40);
+
+    for (; i + 16 <= size; i += 16) {
+        __m256i r[2];
+
+        for (int t = 0; t < 2; ++t) {
+            __m256 v = _mm256_loadu_ps(src + i + t * 8);
+            __m256i x = _mm256_castps_si256(v);
+            __m256i hi = _mm256_srli_epi32(x, 16);
+            __m256i rounded = _mm256_srli_epi32(_mm256_add_epi32(_mm256_add_epi32(x, round),
+                                                _mm256_and_si256(hi, one)), 16);
+            __m256i nan = _mm256_castps_si256(_mm256_cmp_ps(v, v, _CMP_UNORD_Q));
+            r[t] = _mm256_blendv_epi8(rounded, _mm256_or_si256(hi, quiet), nan);
+        }
+
+        __m256i packed = _mm256_permute4x64_epi64(_mm256_packus_epi32(r[0], r[1]), 0xd8);
+        _mm256_storeu_si256((__m256i*)(dst + i), packed);
+    }
+
+#endif
+
+    for (; i < size; ++i) {
+        dst[i] = fp32_to_bf16_scalar(src[i]);
+    }
+}
+
+void half_to_fp32_serial(const uint16_t* src, float* dst, const int64_t size,
+                         const DataType dtype) {
+    int64_t i = 0;
+
+    if (dtype == AK_HALF) {
+#if defined(__AVX512F__)
+
+        for (; i + 16 <= size; i += 16) {
+            _mm512_storeu_ps(dst + i, _mm512_cvtph_ps(_mm256_loadu_si256((const __m256i*)(src + i))));
+        }
+
+#elif defined(__AVX2__) && defined(__F16C__)
+
+        for (; i + 8 <= size; i += 8) {
+            _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(_mm_loadu_si128((const __m128i*)(src + i))));
+        }
+
+#endif
+
+        for (; i < size; ++i) {
+            dst[i] = fp16_to_fp32_scalar(src[i]);
+        }
+
+        return;
+    }
+
+#if defined(__AVX512F__)
+
+    for (; i + 16 <= size; i += 16) {
+        __m512i x = _mm512_cvtepu16_epi32(_mm256_loadu_si256((const __m256i*)(src + i)));
+        _mm512_storeu_ps(dst + i, _mm512_castsi512_ps(_mm512_slli_epi32(x, 16)));
+    }
+
+#elif defined(__AVX2__)
+
+    for (; i + 8 <= size; i += 8) {
+        __m256i x = _mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i*)(src + i)));
+        _mm256_storeu_ps(dst + i, _mm256_castsi256_ps(_mm256_slli_epi32(x, 16)));
+    }
+
+#endif
+
+    for (; i < size; ++i) {
+        dst[i] = bf16_to_fp32_scalar(src[i]);
+    }
+}
+
+} //namespace
+
+uint16_t fp32_to_half(const float src, const DataType dtype) {
+    return dtype == AK_HALF ? fp32_to_fp16_scalar(src) : fp32_to_bf16_scalar(src);
+}
+
+float half_to_fp32(const uint16_t src, const DataType dtype) {
+    return dtype == AK_HALF ? fp16_to_fp32_scalar(src) : bf16_to_fp32_scalar(src);
+}
+
+void fp32_to_half(const float* src, uint16_t* dst, const size_t size, const DataType dtype) {
+    CHECK(is_half_dtype(dtype)) << "not a half type " << dtype;
+    const int64_t chunk_num = ((int64_t)size + CONVERT_CHUNK - 1) / CONVERT_CHUNK;
+
+    #pragma omp parallel for schedule(static) if ((int64_t)size >= CONVERT_PARALLEL_MIN)
+
+    for (int64_t c = 0; c < chunk_num; ++c) {
+        int64_t begin = c * CONVERT_CHUNK;
+        int64_t len = std::min(CONVERT_CHUNK, (int64_t)size - begin);
+        fp32_to_half_serial(src + begin, dst + begin, len, dtype);
+    }
+}
+
+void half_to_fp32(const uint16_t* src, float* dst, const size_t size, const DataType dtype) {
+    CHECK(is_half_dtype(dtype)) << "not a half type " << dtype;
+    const int64_t chunk_num = ((int64_t)size + CONVERT_CHUNK - 1) / CONVERT_CHUNK;
+
+    #pragma omp parallel for schedule(static) if ((int64_t)size >= CONVERT_PARALLEL_MIN)
+
+    for (int64_t c = 0; c < chunk_num; ++c) {
+        int64_t begin = c * CONVERT_CHUNK;
+        int64_t len = std::min(CONVERT_CHUNK, (int64_t)size - begin);
+        half_to_fp32_serial(src + begin, dst + begin, len, dtype);
+    }
+}
+
+} //namespace saber
+
+} //namespace anakin
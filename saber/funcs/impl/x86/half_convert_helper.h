@@ -0,0 +1,52 @@
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef ANAKIN_SABER_FUNCS_IMPL_X86_HALF_CONVERT_HELPER_H
+#define ANAKIN_SABER_FUNCS_IMPL_X86_HALF_CONVERT_HELPER_H
+
+#include <cstddef>
+#include <cstdint>
+#include "saber/saber_types.h"
+
+namespace anakin {
+
+namespace saber {
+
+//! true for the 16 bit float storage types, AK_HALF (ieee fp16) and AK_BFLOAT16
+inline bool is_half_dtype(const DataType dtype) {
+    return dtype == AK_HALF || dtype == AK_BFLOAT16;
+}
+
+//! one fp32 to fp16 or bf16 bits, round to nearest even
+uint16_t fp32_to_half(const float src, const DataType dtype);
+
+//! one fp16 or bf16 value to fp32, exact
+float half_to_fp32(const uint16_t src, const DataType dtype);
+
+/**
+ * \brief fp32 to AK_HALF or AK_BFLOAT16, round to nearest even,
+ * fp16 overflow goes to inf, nan stays nan.
+ * F16C / AVX-512 conversions when compiled in, a bit exact scalar fallback otherwise.
+ */
+void fp32_to_half(const float* src, uint16_t* dst, const size_t size, const DataType dtype);
+
+//! AK_HALF or AK_BFLOAT16 to fp32
+void half_to_fp32(const uint16_t* src, float* dst, const size_t size, const DataType dtype);
+
+} //namespace saber
+
+} //namespace anakin
+
+#endif //ANAKIN_SABER_FUNCS_IMPL_X86_HALF_CONVERT_HELPER_H
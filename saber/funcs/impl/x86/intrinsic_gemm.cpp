@@ -1,4 +1,5 @@
 #include "intrinsic_gemm.h"
+#include "saber/funcs/impl/x86/saber_isa_avx2_begin.h"
 
 #include <emmintrin.h>
 #include <mmintrin.h>
@@ -5721,4 +5722,4 @@ SaberStatus IntrinsicGemm< char,  char, int>::dispatch(
 #endif
 }
 }
-
+#include "saber/funcs/impl/x86/saber_isa_end.h"
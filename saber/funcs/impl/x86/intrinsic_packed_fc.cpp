@@ -3488,6 +3488,9 @@ SaberStatus PackedFC<A_Dtype, B_Dtype, C_Dtype>::init(int n, int k, Tensor<X86>&
         }
 
         _inner_weights.set_scale(temp_tensor.get_scale());
+#if !defined(__AVX512F__)
+        _u8s8s32_gemm.init(true, n, k, out_ptr, k);
+#endif
         auto weights_scales = _inner_weights.get_scale();
         _scale.clear();
 
@@ -3728,6 +3731,19 @@ SaberStatus PackedFC<AK_FLOAT, AK_FLOAT, AK_FLOAT>::dispatch(const int m, const
     float* c = static_cast<float*>(tensor_c.mutable_data());
 #if defined(__AVX512F__)
     avx512_s8s8s32_gemm_4x4_packed(m, n, k, a, k, scale_a, b, k, c, n, sclae);
+#elif defined(__AVX2__)
+    utils::try_expand_tensor(_scale_inputs, m * k);
+    uint8_t* a_shifted = static_cast<uint8_t*>(_scale_inputs.mutable_data());
+    PackedU8S8S32Gemm::quantize_fp32_to_shifted_u8(a, a_shifted, (size_t)m * k, scale_a);
+    // int32 result in place of c, then scaled to fp32
+    int32_t* c_int32 = reinterpret_cast<int32_t*>(c);
+    _u8s8s32_gemm.dispatch(m, a_shifted, k, c_int32, n, true);
+
+    for (int i = 0; i < m; ++i) {
+        for (int j = 0; j < n; ++j) {
+            c[i * n + j] = (float)c_int32[i * n + j] * sclae[j];
+        }
+    }
 #else
     LOG(FATAL) << "not impl";
 #endif
@@ -4,6 +4,7 @@
 #include "saber/funcs/gemm.h"
 #include "jit_generator.h"
 #include "saber/funcs/impl/x86/kernel/jit_call_conf.h"
+#include "saber/funcs/impl/x86/packed_u8s8s32_gemm.h"
 
 namespace anakin {
 namespace saber {
@@ -177,6 +178,8 @@ private:
     jit::jit_s8s8s32_packed_gemm* _packed_gemm{nullptr};
     std::vector<float> _scale;
     PackedFCAlg _alg;
+    //! fp32 fc without avx512, runs on shifted unsigned inputs
+    PackedU8S8S32Gemm _u8s8s32_gemm;
 };
 
 }
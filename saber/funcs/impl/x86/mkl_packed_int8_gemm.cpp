@@ -15,13 +15,62 @@
 
 #include "saber/funcs/impl/x86/mkl_packed_int8_gemm.h"
 #include "saber/funcs/impl/x86/x86_utils.h"
+#include "saber/funcs/impl/x86/dynamic_quant_helper.h"
+#include "saber/funcs/impl/x86/kernel/jit_generator.h"
 
 namespace anakin {
 namespace saber {
 
 SaberStatus PackedMKLInt8Gemm::init(const bool trans_a, const bool trans_b,
-                                    const int m, const int n, const int k, Tensor<X86>& b, float scale_a) {
+                                    const int m, const int n, const int k, Tensor<X86>& b, float scale_a,
+                                    const bool dynamic_quant) {
     _scale.clear();
+    _dynamic_quant = dynamic_quant;
+    _m = m;
+    _n = n;
+    _k = k;
+
+    if (_dynamic_quant) {
+        CHECK(!trans_a) << "dynamic quant only support a not transposed";
+        const int8_t* weights = nullptr;
+        _use_u8s8s32_gemm = !jit::mayiuse(jit::avx512_core) && jit::mayiuse(jit::avx2);
+        const float weights_max = _use_u8s8s32_gemm ? DYNAMIC_QUANT_MADD_WEIGHTS_MAX : 127.f;
+
+        if (b.get_dtype() == AK_FLOAT) {
+            _int8_weights_wx.re_alloc(Shape({1, 1, k, n}), AK_INT8);
+            _weights_scale.resize(n);
+            int8_t* weights_int8 = static_cast<int8_t*>(_int8_weights_wx.mutable_data());
+            const float* weights_fp32 = static_cast<const float*>(b.data());
+
+            if (trans_b) {
+                dynamic_quantize_rows_s8(weights_fp32, weights_int8, n, k, _weights_scale.data(),
+                                         weights_max);
+            } else {
+                dynamic_quantize_cols_s8(weights_fp32, weights_int8, k, n, _weights_scale.data(),
+                                         weights_max);
+            }
+
+            weights = weights_int8;
+        } else if (b.get_dtype() == AK_INT8) {
+            CHECK(b.get_scale().size() == n || b.get_scale().size() == 1) << "weights scale size error";
+            _weights_scale = b.get_scale();
+            _weights_scale.resize(n, _weights_scale[0]);
+            weights = static_cast<const int8_t*>(b.data());
+        } else {
+            LOG(FATAL) << "not support";
+        }
+
+        if (_use_u8s8s32_gemm) {
+            _u8s8s32_gemm.init(trans_b, n, k, weights, trans_b ? k : n);
+            _scale_in.re_alloc(Shape({1, 1, m, k}, Layout_NCHW), AK_UINT8);
+        } else {
+            _wx_gemm.init(false, trans_b, m, n, k, 0, weights, PACKED_MKLGEMM);
+            _scale_in.re_alloc(Shape({1, 1, m, k}, Layout_NCHW), AK_INT8);
+        }
+
+        return SaberSuccess;
+    }
+
     if (b.get_dtype() == AK_FLOAT) {
         _int8_weights_wx.re_alloc(Shape({1, 1, k, n}), AK_INT8);
         utils::ScaleUtils::scale_gemm_xw_weights_to_nchw_host(_int8_weights_wx, b, !trans_b);
@@ -38,13 +87,41 @@ SaberStatus PackedMKLInt8Gemm::init(const bool trans_a, const bool trans_b,
 
 
     _scale_in.re_alloc(Shape({1, 1, m, k}, Layout_NCHW), AK_INT8);
-    _m = m;
-    _n = n;
-    _k = k;
     return SaberSuccess;
 }
+
+SaberStatus PackedMKLInt8Gemm::dispatch(const int m, const float* a, float* c, const float* bias) {
+    CHECK(_dynamic_quant) << "init with dynamic_quant first";
+    utils::try_expand_tensor(_scale_in, m * _k);
+    _row_scale.resize(m);
+    // the int32 result is written in place of c and scaled back to fp32
+    int32_t* c_int32 = reinterpret_cast<int32_t*>(c);
+
+    if (_use_u8s8s32_gemm) {
+        uint8_t* a_u8 = static_cast<uint8_t*>(_scale_in.mutable_data());
+        dynamic_quantize_rows_shifted_u8(a, a_u8, m, _k, _row_scale.data());
+        _u8s8s32_gemm.dispatch(m, a_u8, _k, c_int32, _n, true);
+    } else {
+        int8_t* a_s8 = static_cast<int8_t*>(_scale_in.mutable_data());
+        dynamic_quantize_rows_s8(a, a_s8, m, _k, _row_scale.data());
+        _wx_gemm.dispatch(1.f, 0.f, m, a_s8, nullptr, c_int32);
+    }
+
+    dynamic_dequantize_rows(c_int32, c, m, _n, _row_scale.data(), _weights_scale.data(), bias);
+    return SaberSuccess;
+}
+
 SaberStatus PackedMKLInt8Gemm::dispatch(const float alpha, const float beta, int m,
                                         const Tensor<X86>& a, Tensor<X86>& c, Tensor<X86>* bias) {
+    if (_dynamic_quant) {
+        CHECK(a.get_dtype() == AK_FLOAT && c.get_dtype() == AK_FLOAT) << "dynamic quant only support fp32";
+        CHECK_EQ(a.get_layout(), Layout_NCHW);
+        const float* bias_ptr = bias != nullptr && bias->valid_size() > 0 ?
+                                static_cast<const float*>(bias->data()) : nullptr;
+        return dispatch(m, static_cast<const float*>(a.data()), static_cast<float*>(c.mutable_data()),
+                        bias_ptr);
+    }
+
     if (a.get_dtype() == AK_FLOAT && c.get_dtype() == AK_INT32) {
         CHECK(bias == nullptr || bias->valid_size() == 0);
         CHECK_EQ(a.get_layout(), Layout_NCHW);
@@ -17,22 +17,38 @@
 #define ANAKIN_SABER_FUNCS_IMPL_X86_MKL_PACKED_INT8_GEMM_H
 
 #include "saber/funcs/impl/x86/mkl_gemm.h"
+#include "saber/funcs/impl/x86/packed_u8s8s32_gemm.h"
 #include "saber/core/tensor.h"
 namespace anakin {
 namespace saber {
 class PackedMKLInt8Gemm {
 public:
+    /**
+     * \brief with dynamic_quant, fp32 a is quantized per row at dispatch instead of by scale_a,
+     * fp32 b is quantized per output channel here, and trans_a must be false.
+     */
     SaberStatus init(const bool trans_a, const bool trans_b,
-                     const int m, const int n, const int k, Tensor<X86>& b, float scale_a = 1.f);
+                     const int m, const int n, const int k, Tensor<X86>& b, float scale_a = 1.f,
+                     const bool dynamic_quant = false);
     SaberStatus dispatch(const float alpha, const float beta, int m,
                          const Tensor<X86>& a, Tensor<X86>& c, Tensor<X86>* bias = nullptr);
 
+    //! c[m x n] = a * b + bias in fp32, a quantized per row, needs init with dynamic_quant
+    SaberStatus dispatch(const int m, const float* a, float* c, const float* bias = nullptr);
+
 private:
     MklDnnGemm<int8_t, int8_t, int> _wx_gemm;
     Tensor<X86> _int8_weights_wx;
     Tensor<X86> _scale_in;
     Tensor<X86> _scale_out;
     std::vector<float> _scale;
+    bool _dynamic_quant{false};
+    //! the dynamic int8 gemm for cpus without avx512
+    bool _use_u8s8s32_gemm{false};
+    PackedU8S8S32Gemm _u8s8s32_gemm;
+    //! one scale per column of b
+    std::vector<float> _weights_scale;
+    std::vector<float> _row_scale;
     int _m;
     int _n;
     int _k;
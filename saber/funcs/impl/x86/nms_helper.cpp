@@ -0,0 +1,454 @@
+#include "saber/funcs/impl/x86/nms_helper.h"
+#include "saber/funcs/impl/x86/anakin_thread.h"
+#include <algorithm>
+#include <numeric>
+#include <stdint.h>
+#include <immintrin.h>
+
+namespace anakin {
+
+namespace saber {
+
+namespace {
+
+#if defined(__AVX512F__)
+const int NMS_VEC_SIZE = 16;
+#elif defined(__AVX2__)
+const int NMS_VEC_SIZE = 8;
+#else
+const int NMS_VEC_SIZE = 1;
+#endif
+
+struct NmsQuery {
+    float x1, y1, x2, y2, area;
+};
+
+inline NmsQuery get_query(const NmsBoxes& boxes, int i) {
+    NmsQuery q = {boxes.x1[i], boxes.y1[i], boxes.x2[i], boxes.y2[i], boxes.area[i]};
+    return q;
+}
+
+inline bool overlap_exceed(const NmsQuery& q, const NmsBoxes& boxes, int j,
+                           float threshold, float offset, NmsOverlapType type) {
+    float dx = std::min(q.x2, boxes.x2[j]) - std::max(q.x1, boxes.x1[j]);
+    float dy = std::min(q.y2, boxes.y2[j]) - std::max(q.y1, boxes.y1[j]);
+    float w = dx + offset;
+    float h = dy + offset;
+    if (type == NMS_LM) {
+        if (!(w > 0 && h > 0)) {
+            return false;
+        }
+        float inter = w * h;
+        return inter / (q.area + boxes.area[j] - inter) > threshold;
+    }
+    if (boxes.x1[j] > q.x2 || boxes.x2[j] < q.x1 || boxes.y1[j] > q.y2 || boxes.y2[j] < q.y1) {
+        return false;
+    }
+    float inter = w * h;
+    // jaccard keeps a box only if overlap <= threshold, so NaN suppresses
+    return !(inter / (q.area + boxes.area[j] - inter) <= threshold);
+}
+
+//! bitmask of boxes in [j, j + NMS_VEC_SIZE) whose overlap with q exceeds threshold
+inline uint64_t overlap_exceed_mask(const NmsQuery& q, const NmsBoxes& boxes, int j,
+                                    float threshold, float offset, NmsOverlapType type) {
+#if defined(__AVX512F__)
+    __m512 x1 = _mm512_loadu_ps(&boxes.x1[j]);
+    __m512 y1 = _mm512_loadu_ps(&boxes.y1[j]);
+    __m512 x2 = _mm512_loadu_ps(&boxes.x2[j]);
+    __m512 y2 = _mm512_loadu_ps(&boxes.y2[j]);
+    __m512 qx1 = _mm512_set1_ps(q.x1);
+    __m512 qy1 = _mm512_set1_ps(q.y1);
+    __m512 qx2 = _mm512_set1_ps(q.x2);
+    __m512 qy2 = _mm512_set1_ps(q.y2);
+    __m512 off = _mm512_set1_ps(offset);
+    __m512 dx = _mm512_sub_ps(_mm512_min_ps(qx2, x2), _mm512_max_ps(qx1, x1));
+    __m512 dy = _mm512_sub_ps(_mm512_min_ps(qy2, y2), _mm512_max_ps(qy1, y1));
+    __m512 w = _mm512_add_ps(dx, off);
+    __m512 h = _mm512_add_ps(dy, off);
+    __m512 inter = _mm512_mul_ps(w, h);
+    __m512 uni = _mm512_sub_ps(_mm512_add_ps(_mm512_set1_ps(q.area),
+                                             _mm512_loadu_ps(&boxes.area[j])), inter);
+    __m512 iou = _mm512_div_ps(inter, uni);
+    __m512 thr = _mm512_set1_ps(threshold);
+    __mmask16 valid;
+    __mmask16 over;
+    if (type == NMS_LM) {
+        valid = _mm512_cmp_ps_mask(w, _mm512_setzero_ps(), _CMP_GT_OQ)
+                & _mm512_cmp_ps_mask(h, _mm512_setzero_ps(), _CMP_GT_OQ);
+        over = _mm512_cmp_ps_mask(iou, thr, _CMP_GT_OQ);
+    } else {
+        __mmask16 disjoint = _mm512_cmp_ps_mask(x1, qx2, _CMP_GT_OQ)
+                             | _mm512_cmp_ps_mask(x2, qx1, _CMP_LT_OQ)
+                             | _mm512_cmp_ps_mask(y1, qy2, _CMP_GT_OQ)
+                             | _mm512_cmp_ps_mask(y2, qy1, _CMP_LT_OQ);
+        valid = ~disjoint;
+        over = _mm512_cmp_ps_mask(iou, thr, _CMP_NLE_UQ);
+    }
+    return (uint64_t)(uint16_t)(valid & over);
+#elif defined(__AVX2__)
+    __m256 x1 = _mm256_loadu_ps(&boxes.x1[j]);
+    __m256 y1 = _mm256_loadu_ps(&boxes.y1[j]);
+    __m256 x2 = _mm256_loadu_ps(&boxes.x2[j]);
+    __m256 y2 = _mm256_loadu_ps(&boxes.y2[j]);
+    __m256 qx1 = _mm256_set1_ps(q.x1);
+    __m256 qy1 = _mm256_set1_ps(q.y1);
+    __m256 qx2 = _mm256_set1_ps(q.x2);
+    __m256 qy2 = _mm256_set1_ps(q.y2);
+    __m256 off = _mm256_set1_ps(offset);
+    __m256 dx = _mm256_sub_ps(_mm256_min_ps(qx2, x2), _mm256_max_ps(qx1, x1));
+    __m256 dy = _mm256_sub_ps(_mm256_min_ps(qy2, y2), _mm256_max_ps(qy1, y1));
+    __m256 w = _mm256_add_ps(dx, off);
+    __m256 h = _mm256_add_ps(dy, off);
+    __m256 inter = _mm256_mul_ps(w, h);
+    __m256 uni = _mm256_sub_ps(_mm256_add_ps(_mm256_set1_ps(q.area),
+                                             _mm256_loadu_ps(&boxes.area[j])), inter);
+    __m256 iou = _mm256_div_ps(inter, uni);
+    __m256 thr = _mm256_set1_ps(threshold);
+    __m256 res;
+    if (type == NMS_LM) {
+        __m256 valid = _mm256_and_ps(_mm256_cmp_ps(w, _mm256_setzero_ps(), _CMP_GT_OQ),
+                                     _mm256_cmp_ps(h, _mm256_setzero_ps(), _CMP_GT_OQ));
+        res = _mm256_and_ps(valid, _mm256_cmp_ps(iou, thr, _CMP_GT_OQ));
+    } else {
+        __m256 disjoint = _mm256_or_ps(
+                _mm256_or_ps(_mm256_cmp_ps(x1, qx2, _CMP_GT_OQ), _mm256_cmp_ps(x2, qx1, _CMP_LT_OQ)),
+                _mm256_or_ps(_mm256_cmp_ps(y1, qy2, _CMP_GT_OQ), _mm256_cmp_ps(y2, qy1, _CMP_LT_OQ)));
+        res = _mm256_andnot_ps(disjoint, _mm256_cmp_ps(iou, thr, _CMP_NLE_UQ));
+    }
+    return (uint64_t)_mm256_movemask_ps(res);
+#else
+    return overlap_exceed(q, boxes, j, threshold, offset, type) ? 1 : 0;
+#endif
+}
+
+inline bool is_suppressed(const std::vector<uint64_t>& suppressed, int i) {
+    return (suppressed[i >> 6] >> (i & 63)) & 1;
+}
+
+void nms_suppress_forward(const NmsBoxes& boxes, float threshold, float offset,
+                          NmsOverlapType type, int max_keep, std::vector<int>* keep) {
+    const int num = boxes.size();
+    std::vector<uint64_t> suppressed((num + 63) / 64, 0);
+    for (int i = 0; i < num; ++i) {
+        if (max_keep >= 0 && keep->size() >= max_keep) {
+            break;
+        }
+        if (is_suppressed(suppressed, i)) {
+            continue;
+        }
+        keep->push_back(i);
+        NmsQuery q = get_query(boxes, i);
+        int j = i + 1;
+        for (; j + NMS_VEC_SIZE <= num; j += NMS_VEC_SIZE) {
+            uint64_t mask = overlap_exceed_mask(q, boxes, j, threshold, offset, type);
+            if (mask) {
+                int word = j >> 6;
+                int shift = j & 63;
+                suppressed[word] |= mask << shift;
+                if (shift + NMS_VEC_SIZE > 64) {
+                    suppressed[word + 1] |= mask >> (64 - shift);
+                }
+            }
+        }
+        for (; j < num; ++j) {
+            if (overlap_exceed(q, boxes, j, threshold, offset, type)) {
+                suppressed[j >> 6] |= uint64_t(1) << (j & 63);
+            }
+        }
+    }
+}
+
+void nms_suppress_adaptive(const NmsBoxes& boxes, float threshold, float eta, float offset,
+                           NmsOverlapType type, int max_keep, std::vector<int>* keep) {
+    const int num = boxes.size();
+    NmsBoxes kept;
+    kept.resize(num);
+    int kept_num = 0;
+    float adaptive_threshold = threshold;
+    for (int i = 0; i < num; ++i) {
+        if (max_keep >= 0 && kept_num >= max_keep) {
+            break;
+        }
+        NmsQuery q = get_query(boxes, i);
+        bool is_kept = true;
+        int j = 0;
+        for (; is_kept && j + NMS_VEC_SIZE <= kept_num; j += NMS_VEC_SIZE) {
+            is_kept = overlap_exceed_mask(q, kept, j, adaptive_threshold, offset, type) == 0;
+        }
+        for (; is_kept && j < kept_num; ++j) {
+            is_kept = !overlap_exceed(q, kept, j, adaptive_threshold, offset, type);
+        }
+        if (!is_kept) {
+            continue;
+        }
+        keep->push_back(i);
+        kept.x1[kept_num] = q.x1;
+        kept.y1[kept_num] = q.y1;
+        kept.x2[kept_num] = q.x2;
+        kept.y2[kept_num] = q.y2;
+        kept.area[kept_num] = q.area;
+        ++kept_num;
+        if (eta < 1 && adaptive_threshold > 0.5) {
+            adaptive_threshold *= eta;
+        }
+    }
+}
+
+template <typename dtype>
+struct ScoreIndexGreater {
+    bool operator()(const std::pair<dtype, int>& a, const std::pair<dtype, int>& b) const {
+        return a.first > b.first || (a.first == b.first && a.second < b.second);
+    }
+};
+
+} // namespace
+
+void NmsBoxes::set(int i, float bx1, float by1, float bx2, float by2,
+                   float offset, NmsOverlapType type) {
+    x1[i] = bx1;
+    y1[i] = by1;
+    x2[i] = bx2;
+    y2[i] = by2;
+    if (type == NMS_JACCARD && (bx2 < bx1 || by2 < by1)) {
+        area[i] = 0.f;
+    } else {
+        area[i] = (bx2 - bx1 + offset) * (by2 - by1 + offset);
+    }
+}
+
+template <typename dtype>
+void get_topk_score_index(const dtype* scores, int num, float threshold,
+                          int top_k, std::vector<std::pair<dtype, int> >* score_index_vec) {
+    score_index_vec->clear();
+    for (int i = 0; i < num; ++i) {
+        if (scores[i] > threshold) {
+            score_index_vec->push_back(std::make_pair(scores[i], i));
+        }
+    }
+    ScoreIndexGreater<dtype> greater;
+    if (top_k > -1 && top_k < score_index_vec->size()) {
+        std::nth_element(score_index_vec->begin(), score_index_vec->begin() + top_k,
+                         score_index_vec->end(), greater);
+        score_index_vec->resize(top_k);
+    }
+    std::sort(score_index_vec->begin(), score_index_vec->end(), greater);
+}
+
+void nms_sorted_boxes(const NmsBoxes& boxes, float nms_threshold, float eta,
+                      float offset, NmsOverlapType type, int max_keep,
+                      std::vector<int>* keep) {
+    keep->clear();
+    if (eta < 1 && nms_threshold > 0.5) {
+        nms_suppress_adaptive(boxes, nms_threshold, eta, offset, type, max_keep, keep);
+    } else {
+        nms_suppress_forward(boxes, nms_threshold, offset, type, max_keep, keep);
+    }
+}
+
+template <typename dtype>
+void apply_nms_fast_x86(const dtype* bboxes, const dtype* scores, int num,
+                        float score_threshold, float nms_threshold,
+                        float eta, int top_k, std::vector<int>* indices) {
+    std::vector<std::pair<dtype, int> > score_index_vec;
+    get_topk_score_index(scores, num, score_threshold, top_k, &score_index_vec);
+
+    NmsBoxes boxes;
+    boxes.resize(score_index_vec.size());
+    for (int i = 0; i < score_index_vec.size(); ++i) {
+        const dtype* box = bboxes + score_index_vec[i].second * 4;
+        boxes.set(i, box[0], box[1], box[2], box[3], 0.f, NMS_JACCARD);
+    }
+    std::vector<int> keep;
+    nms_sorted_boxes(boxes, nms_threshold, eta, 0.f, NMS_JACCARD, -1, &keep);
+
+    indices->resize(keep.size());
+    for (int i = 0; i < keep.size(); ++i) {
+        (*indices)[i] = score_index_vec[keep[i]].second;
+    }
+}
+
+template <typename dtype>
+void nms_detect_x86(const dtype* bbox_cpu_data, const dtype* conf_cpu_data, std::vector<dtype>& result, \
+                    const std::vector<int>& priors, int class_num, int background_id, \
+                    int keep_topk, int nms_topk, float conf_thresh, float nms_thresh, \
+                    float nms_eta, bool share_location) {
+    const int num_img = priors.size();
+    std::vector<long long> prior_offset(num_img + 1, 0);
+    for (int i = 0; i < num_img; ++i) {
+        prior_offset[i + 1] = prior_offset[i] + priors[i];
+    }
+
+    //! nms of every (image, class) pair is independent
+    std::vector<std::vector<int> > indices(num_img * class_num);
+#pragma omp parallel for schedule(dynamic)
+    for (int task = 0; task < num_img * class_num; ++task) {
+        int i = task / class_num;
+        int c = task % class_num;
+        if (c == background_id) {
+            continue;
+        }
+        int num_priors = priors[i];
+        long long conf_idx = class_num * prior_offset[i];
+        long long bbox_idx = share_location ? prior_offset[i] * 4 : prior_offset[i] * 4 * class_num;
+        const dtype* cur_conf_data = conf_cpu_data + conf_idx + c * num_priors;
+        const dtype* cur_bbox_data = bbox_cpu_data + bbox_idx;
+        if (!share_location) {
+            cur_bbox_data += c * num_priors * 4;
+        }
+        apply_nms_fast_x86(cur_bbox_data, cur_conf_data, num_priors, \
+                           conf_thresh, nms_thresh, nms_eta, nms_topk, &indices[task]);
+    }
+
+    //! keep top k results per image
+    std::vector<int> img_kept(num_img + 1, 0);
+#pragma omp parallel for schedule(dynamic)
+    for (int i = 0; i < num_img; ++i) {
+        std::vector<int>* img_indices = &indices[i * class_num];
+        int num_det = 0;
+        for (int c = 0; c < class_num; ++c) {
+            num_det += img_indices[c].size();
+        }
+        if (keep_topk > -1 && num_det > keep_topk) {
+            long long conf_idx = class_num * prior_offset[i];
+            std::vector<std::pair<dtype, int> > score_index_pairs;
+            std::vector<std::pair<int, int> > label_index_pairs;
+            score_index_pairs.reserve(num_det);
+            label_index_pairs.reserve(num_det);
+            for (int c = 0; c < class_num; ++c) {
+                for (int j = 0; j < img_indices[c].size(); ++j) {
+                    int idx = img_indices[c][j];
+                    score_index_pairs.push_back(std::make_pair(
+                            conf_cpu_data[conf_idx + c * priors[i] + idx],
+                            (int)label_index_pairs.size()));
+                    label_index_pairs.push_back(std::make_pair(c, idx));
+                }
+            }
+            ScoreIndexGreater<dtype> greater;
+            std::nth_element(score_index_pairs.begin(), score_index_pairs.begin() + keep_topk,
+                             score_index_pairs.end(), greater);
+            score_index_pairs.resize(keep_topk);
+            std::sort(score_index_pairs.begin(), score_index_pairs.end(), greater);
+            for (int c = 0; c < class_num; ++c) {
+                img_indices[c].clear();
+            }
+            for (int j = 0; j < keep_topk; ++j) {
+                const std::pair<int, int>& label_idx = label_index_pairs[score_index_pairs[j].second];
+                img_indices[label_idx.first].push_back(label_idx.second);
+            }
+            num_det = keep_topk;
+        }
+        img_kept[i + 1] = num_det;
+    }
+    for (int i = 0; i < num_img; ++i) {
+        img_kept[i + 1] += img_kept[i];
+    }
+
+    int num_kept = img_kept[num_img];
+    if (num_kept == 0) {
+        result.clear();
+        return;
+    } else {
+        result.resize(num_kept * 7);
+    }
+
+#pragma omp parallel for schedule(static)
+    for (int i = 0; i < num_img; ++i) {
+        int num_priors = priors[i];
+        long long conf_idx = class_num * prior_offset[i];
+        long long bbox_idx = share_location ? prior_offset[i] * 4 : prior_offset[i] * 4 * class_num;
+        dtype* out = result.data() + img_kept[i] * 7;
+        for (int label = 0; label < class_num; ++label) {
+            const std::vector<int>& label_indices = indices[i * class_num + label];
+            const dtype* cur_conf_data = conf_cpu_data + conf_idx + label * num_priors;
+            const dtype* cur_bbox_data = bbox_cpu_data + bbox_idx;
+            if (!share_location) {
+                cur_bbox_data += label * num_priors * 4;
+            }
+            for (int j = 0; j < label_indices.size(); ++j) {
+                int idx = label_indices[j];
+                out[0] = i;
+                out[1] = label;
+                out[2] = cur_conf_data[idx];
+                for (int k = 0; k < 4; ++k) {
+                    out[3 + k] = cur_bbox_data[idx * 4 + k];
+                }
+                out += 7;
+            }
+        }
+    }
+}
+
+template <typename Dtype>
+const std::vector<bool> nms_lm_x86(std::vector< BBox<Dtype> >& candidates,
+                                   const Dtype overlap, const int top_N, const bool addScore,
+                                   const int max_candidate_N, bool bbox_size_add_one, bool voting,
+                                   Dtype vote_iou) {
+    if (voting || addScore) {
+        return nms_lm(candidates, overlap, top_N, addScore, max_candidate_N,
+                      bbox_size_add_one, voting, vote_iou);
+    }
+    std::vector<bool> mask(candidates.size(), false);
+    if (mask.size() == 0) {
+        return mask;
+    }
+    int num = candidates.size();
+    int consider_size = num;
+    if (max_candidate_N > 0) {
+        consider_size = std::min<int>(consider_size, max_candidate_N);
+    }
+
+    //! only the considered candidates need an order, the same as stable_sort gives
+    std::vector<int> order(num);
+    std::iota(order.begin(), order.end(), 0);
+    auto greater = [&candidates](int a, int b) {
+        return candidates[a].score > candidates[b].score
+               || (candidates[a].score == candidates[b].score && a < b);
+    };
+    if (consider_size < num) {
+        std::nth_element(order.begin(), order.begin() + consider_size, order.end(), greater);
+    }
+    std::sort(order.begin(), order.begin() + consider_size, greater);
+    std::vector< BBox<Dtype> > sorted;
+    sorted.reserve(num);
+    for (int i = 0; i < num; ++i) {
+        sorted.push_back(std::move(candidates[order[i]]));
+    }
+    candidates.swap(sorted);
+
+    Dtype bsz01 = bbox_size_add_one ? Dtype(1.0) : Dtype(0.0);
+    NmsBoxes boxes;
+    boxes.resize(consider_size);
+    for (int i = 0; i < consider_size; ++i) {
+        boxes.set(i, candidates[i].x1, candidates[i].y1, candidates[i].x2, candidates[i].y2,
+                  bsz01, NMS_LM);
+    }
+    std::vector<int> keep;
+    nms_sorted_boxes(boxes, overlap, 1.f, bsz01, NMS_LM, std::max(top_N, 0), &keep);
+    for (int i = 0; i < keep.size(); ++i) {
+        mask[keep[i]] = true;
+    }
+    return mask;
+}
+
+template void get_topk_score_index(const float* scores, int num, float threshold,
+                                   int top_k, std::vector<std::pair<float, int> >* score_index_vec);
+
+template void apply_nms_fast_x86(const float* bboxes, const float* scores, int num,
+                                 float score_threshold, float nms_threshold,
+                                 float eta, int top_k, std::vector<int>* indices);
+
+template void nms_detect_x86(const float* bbox_cpu_data, const float* conf_cpu_data,
+                             std::vector<float>& result, \
+                             const std::vector<int>& priors, int class_num, int background_id, \
+                             int keep_topk, int nms_topk, float conf_thresh, float nms_thresh, float nms_eta,
+                             bool share_location);
+
+template const std::vector<bool> nms_lm_x86(std::vector< BBox<float> >& candidates,
+                                            const float overlap, const int top_N, const bool addScore,
+                                            const int max_candidate_N, bool bbox_size_add_one, bool voting,
+                                            float vote_iou);
+
+} //namespace saber
+
+} //namespace anakin
@@ -0,0 +1,103 @@
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef ANAKIN_SABER_FUNCS_IMPL_X86_NMS_HELPER_H
+#define ANAKIN_SABER_FUNCS_IMPL_X86_NMS_HELPER_H
+
+#include "saber/core/common.h"
+#include "saber/utils.h"
+#include <vector>
+
+namespace anakin {
+
+namespace saber {
+
+//! overlap definitions shared by the x86 detection ops
+enum NmsOverlapType {
+    //! jaccard overlap of detection_helper, zero for disjoint boxes,
+    //! area of an invalid box is zero
+    NMS_JACCARD = 0,
+    //! overlap of nms_lm, zero unless intersection width and height are positive
+    NMS_LM = 1
+};
+
+//! boxes stored as structure of arrays, ordered by descending score
+struct NmsBoxes {
+    void resize(int num) {
+        x1.resize(num);
+        y1.resize(num);
+        x2.resize(num);
+        y2.resize(num);
+        area.resize(num);
+    }
+    int size() const {
+        return x1.size();
+    }
+    void set(int i, float bx1, float by1, float bx2, float by2,
+             float offset, NmsOverlapType type);
+
+    std::vector<float> x1;
+    std::vector<float> y1;
+    std::vector<float> x2;
+    std::vector<float> y2;
+    std::vector<float> area;
+};
+
+/**
+ * \brief keep (score, index) pairs whose score is above threshold, select the top_k
+ * with nth_element and order them by descending score, ties by ascending index,
+ * which is the order std::stable_sort gives.
+ */
+template <typename dtype>
+void get_topk_score_index(const dtype* scores, int num, float threshold,
+                          int top_k, std::vector<std::pair<dtype, int> >* score_index_vec);
+
+/**
+ * \brief greedy nms over boxes already sorted by descending score.
+ * keep receives positions into boxes, at most max_keep of them (-1 for no limit).
+ * overlaps are computed with SIMD against blocks of boxes; with a fixed threshold,
+ * suppression is recorded in a bitmask, with an adaptive (eta < 1) threshold
+ * every candidate is checked against the kept boxes instead.
+ */
+void nms_sorted_boxes(const NmsBoxes& boxes, float nms_threshold, float eta,
+                      float offset, NmsOverlapType type, int max_keep,
+                      std::vector<int>* keep);
+
+//! same contract as apply_nms_fast in detection_helper.h
+template <typename dtype>
+void apply_nms_fast_x86(const dtype* bboxes, const dtype* scores, int num,
+                        float score_threshold, float nms_threshold,
+                        float eta, int top_k, std::vector<int>* indices);
+
+//! same contract as nms_detect in detection_helper.h, images and classes run in parallel
+template <typename dtype>
+void nms_detect_x86(const dtype* bbox_cpu_data,
+                    const dtype* conf_cpu_data, std::vector<dtype>& result, \
+                    const std::vector<int>& priors, int class_num, int background_id, \
+                    int keep_topk, int nms_topk, float conf_thresh, float nms_thresh,
+                    float nms_eta, bool share_location);
+
+//! same contract as nms_lm in saber/utils.h, falls back to it for voting and addScore
+template <typename Dtype>
+const std::vector<bool> nms_lm_x86(std::vector< BBox<Dtype> >& candidates,
+                                   const Dtype overlap, const int top_N, const bool addScore,
+                                   const int max_candidate_N, bool bbox_size_add_one, bool voting,
+                                   Dtype vote_iou);
+
+} //namespace saber
+
+} //namespace anakin
+
+#endif //ANAKIN_SABER_FUNCS_IMPL_X86_NMS_HELPER_H
@@ -0,0 +1,287 @@
+#include "saber/funcs/impl/x86/packed_half_gemm.h"
+#include "saber/funcs/impl/x86/half_convert_helper.h"
+#include <algorithm>
+#include <cstring>
+#include <immintrin.h>
+
+namespace anakin {
+namespace saber {
+
+namespace {
+
+const int PANEL_N = 16;
+//! rows of a one call of the micro kernel computes
+const int BLOCK_M = 4;
+//! rows of a a thread takes in one piece of work
+const int PARALLEL_BLOCK_M = 64;
+//! m * n * k below this runs on the calling thread
+const int64_t PARALLEL_MIN_WORK = 1 << 18;
+
+//! c = acc (+ bias) (+ c), nc of the 16 columns are valid
+inline void store_c(const float* acc, float* c, const int nc, const float* bias,
+                    const bool accumulate) {
+    for (int j = 0; j < nc; ++j) {
+        float val = acc[j] + (bias != nullptr ? bias[j] : 0.f);
+        c[j] = accumulate ? c[j] + val : val;
+    }
+}
+
+#if defined(__AVX512F__)
+
+template <DataType dtype>
+inline __m512 load_b(const uint16_t* b) {
+    __m256i h = _mm256_loadu_si256((const __m256i*)b);
+
+    if (dtype == AK_HALF) {
+        return _mm512_cvtph_ps(h);
+    }
+
+    return _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_cvtepu16_epi32(h), 16));
+}
+
+//! MR rows of a times one panel of b, the panel row is expanded to fp32 once for all MR rows
+template <DataType dtype, int MR>
+inline void kernel_mrx16(const int k, const float* a, const int lda, const uint16_t* b,
+                         float* c, const int ldc, const int nc,
+                         const float* bias, const bool accumulate) {
+    __m512 acc[MR];
+
+    for (int r = 0; r < MR; ++r) {
+        acc[r] = _mm512_setzero_ps();
+    }
+
+    for (int kk = 0; kk < k; ++kk) {
+        const __m512 vb = load_b<dtype>(b + kk * PANEL_N);
+
+        for (int r = 0; r < MR; ++r) {
+            acc[r] = _mm512_fmadd_ps(_mm512_set1_ps(a[r * lda + kk]), vb, acc[r]);
+        }
+    }
+
+    const __mmask16 mask = (__mmask16)((1u << nc) - 1);
+    const __m512 vbias = bias != nullptr ? _mm512_maskz_loadu_ps(mask, bias) : _mm512_setzero_ps();
+
+    for (int r = 0; r < MR; ++r) {
+        __m512 val = _mm512_add_ps(acc[r], vbias);
+
+        if (accumulate) {
+            val = _mm512_add_ps(val, _mm512_maskz_loadu_ps(mask, c + r * ldc));
+        }
+
+        _mm512_mask_storeu_ps(c + r * ldc, mask, val);
+    }
+}
+
+#elif defined(__AVX2__) && defined(__FMA__) && defined(__F16C__)
+
+template <DataType dtype>
+inline __m256 load_b(const uint16_t* b) {
+    __m128i h = _mm_loadu_si128((const __m128i*)b);
+
+    if (dtype == AK_HALF) {
+        return _mm256_cvtph_ps(h);
+    }
+
+    return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(h), 16));
+}
+
+template <DataType dtype, int MR>
+inline void kernel_mrx16(const int k, const float* a, const int lda, const uint16_t* b,
+                         float* c, const int ldc, const int nc,
+                         const float* bias, const bool accumulate) {
+    __m256 acc[MR][2];
+
+    for (int r = 0; r < MR; ++r) {
+        acc[r][0] = _mm256_setzero_ps();
+        acc[r][1] = _mm256_setzero_ps();
+    }
+
+    for (int kk = 0; kk < k; ++kk) {
+        const __m256 vb0 = load_b<dtype>(b + kk * PANEL_N);
+        const __m256 vb1 = load_b<dtype>(b + kk * PANEL_N + 8);
+
+        for (int r = 0; r < MR; ++r) {
+            const __m256 va = _mm256_set1_ps(a[r * lda + kk]);
+            acc[r][0] = _mm256_fmadd_ps(va, vb0, acc[r][0]);
+            acc[r][1] = _mm256_fmadd_ps(va, vb1, acc[r][1]);
+        }
+    }
+
+    for (int r = 0; r < MR; ++r) {
+        float* c_row = c + r * ldc;
+
+        if (nc == PANEL_N) {
+            __m256 val0 = acc[r][0];
+            __m256 val1 = acc[r][1];
+
+            if (bias != nullptr) {
+                val0 = _mm256_add_ps(val0, _mm256_loadu_ps(bias));
+                val1 = _mm256_add_ps(val1, _mm256_loadu_ps(bias + 8));
+            }
+
+            if (accumulate) {
+                val0 = _mm256_add_ps(val0, _mm256_loadu_ps(c_row));
+                val1 = _mm256_add_ps(val1, _mm256_loadu_ps(c_row + 8));
+            }
+
+            _mm256_storeu_ps(c_row, val0);
+            _mm256_storeu_ps(c_row + 8, val1);
+        } else {
+            float buf[PANEL_N];
+            _mm256_storeu_ps(buf, acc[r][0]);
+            _mm256_storeu_ps(buf + 8, acc[r][1]);
+            store_c(buf, c_row, nc, bias, accumulate);
+        }
+    }
+}
+
+#else
+
+template <DataType dtype, int MR>
+inline void kernel_mrx16(const int k, const float* a, const int lda, const uint16_t* b,
+                         float* c, const int ldc, const int nc,
+                         const float* bias, const bool accumulate) {
+    float acc[MR][PANEL_N];
+    memset(acc, 0, sizeof(acc));
+
+    for (int kk = 0; kk < k; ++kk) {
+        float vb[PANEL_N];
+
+        for (int j = 0; j < PANEL_N; ++j) {
+            vb[j] = half_to_fp32(b[kk * PANEL_N + j], dtype);
+        }
+
+        for (int r = 0; r < MR; ++r) {
+            const float va = a[r * lda + kk];
+
+            for (int j = 0; j < PANEL_N; ++j) {
+                acc[r][j] += va * vb[j];
+            }
+        }
+    }
+
+    for (int r = 0; r < MR; ++r) {
+        store_c(acc[r], c + r * ldc, nc, bias, accumulate);
+    }
+}
+
+#endif
+
+template <DataType dtype>
+void compute_panel(const int m, const int k, const float* a, const int lda, const uint16_t* panel,
+                   float* c, const int ldc, const int nc, const float* bias, const bool accumulate) {
+    int r = 0;
+
+    for (; r + BLOCK_M <= m; r += BLOCK_M) {
+        kernel_mrx16<dtype, BLOCK_M>(k, a + (size_t)r * lda, lda, panel,
+                                     c + (size_t)r * ldc, ldc, nc, bias, accumulate);
+    }
+
+    switch (m - r) {
+    case 3:
+        kernel_mrx16<dtype, 3>(k, a + (size_t)r * lda, lda, panel,
+                               c + (size_t)r * ldc, ldc, nc, bias, accumulate);
+        break;
+
+    case 2:
+        kernel_mrx16<dtype, 2>(k, a + (size_t)r * lda, lda, panel,
+                               c + (size_t)r * ldc, ldc, nc, bias, accumulate);
+        break;
+
+    case 1:
+        kernel_mrx16<dtype, 1>(k, a + (size_t)r * lda, lda, panel,
+                               c + (size_t)r * ldc, ldc, nc, bias, accumulate);
+        break;
+
+    default:
+        break;
+    }
+}
+
+} //namespace
+
+SaberStatus PackedHalfGemm::init(const bool trans_b, const int n, const int k,
+                                 const void* b, const int ldb,
+                                 const DataType b_dtype, const DataType pack_dtype) {
+    CHECK(b != nullptr);
+    CHECK_GT(n, 0);
+    CHECK_GT(k, 0);
+    CHECK(is_half_dtype(pack_dtype)) << "half gemm only packs fp16 or bf16, not " << pack_dtype;
+    CHECK(b_dtype == AK_FLOAT || is_half_dtype(b_dtype)) << "not support b type " << b_dtype;
+    _n = n;
+    _k = k;
+    _pack_dtype = pack_dtype;
+    _panel_num = (n + PANEL_N - 1) / PANEL_N;
+    const size_t panel_size = (size_t)k * PANEL_N;
+
+    _packed_b.re_alloc(Shape({1, 1, _panel_num, (int)panel_size}), pack_dtype);
+    uint16_t* packed = static_cast<uint16_t*>(_packed_b.mutable_data());
+    memset(packed, 0, sizeof(uint16_t) * _panel_num * panel_size);
+
+    const float* b_fp32 = static_cast<const float*>(b);
+    const uint16_t* b_half = static_cast<const uint16_t*>(b);
+
+    #pragma omp parallel for schedule(static)
+
+    for (int p = 0; p < _panel_num; ++p) {
+        uint16_t* panel = packed + p * panel_size;
+        const int nc = std::min(PANEL_N, n - p * PANEL_N);
+
+        for (int kk = 0; kk < k; ++kk) {
+            for (int j = 0; j < nc; ++j) {
+                const int nn = p * PANEL_N + j;
+                const size_t idx = trans_b ? (size_t)nn * ldb + kk : (size_t)kk * ldb + nn;
+                uint16_t val = 0;
+
+                if (b_dtype == AK_FLOAT) {
+                    val = fp32_to_half(b_fp32[idx], pack_dtype);
+                } else if (b_dtype == pack_dtype) {
+                    val = b_half[idx];
+                } else {
+                    val = fp32_to_half(half_to_fp32(b_half[idx], b_dtype), pack_dtype);
+                }
+
+                panel[kk * PANEL_N + j] = val;
+            }
+        }
+    }
+
+    return SaberSuccess;
+}
+
+SaberStatus PackedHalfGemm::dispatch(const int m, const float* a, const int lda,
+                                     float* c, const int ldc,
+                                     const float* bias, const bool accumulate) const {
+    CHECK(a != nullptr);
+    CHECK(c != nullptr);
+    CHECK_GT(_panel_num, 0) << "PackedHalfGemm is not initialized";
+    const uint16_t* packed = static_cast<const uint16_t*>(_packed_b.data());
+    const size_t panel_size = (size_t)_k * PANEL_N;
+    const int row_blocks = (m + PARALLEL_BLOCK_M - 1) / PARALLEL_BLOCK_M;
+    const int64_t work = (int64_t)m * _n * _k;
+
+#pragma omp parallel for collapse(2) schedule(static) if (work >= PARALLEL_MIN_WORK)
+    for (int rb = 0; rb < row_blocks; ++rb) {
+        for (int p = 0; p < _panel_num; ++p) {
+            const int r0 = rb * PARALLEL_BLOCK_M;
+            const int rows = std::min(PARALLEL_BLOCK_M, m - r0);
+            const int nc = std::min(PANEL_N, _n - p * PANEL_N);
+            const float* panel_bias = bias != nullptr ? bias + p * PANEL_N : nullptr;
+            float* c_block = c + (size_t)r0 * ldc + p * PANEL_N;
+
+            if (_pack_dtype == AK_HALF) {
+                compute_panel<AK_HALF>(rows, _k, a + (size_t)r0 * lda, lda, packed + p * panel_size,
+                                       c_block, ldc, nc, panel_bias, accumulate);
+            } else {
+                compute_panel<AK_BFLOAT16>(rows, _k, a + (size_t)r0 * lda, lda,
+                                           packed + p * panel_size, c_block, ldc, nc,
+                                           panel_bias, accumulate);
+            }
+        }
+    }
+
+    return SaberSuccess;
+}
+
+} // namespace saber
+} // namespace anakin
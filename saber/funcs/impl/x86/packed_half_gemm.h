@@ -0,0 +1,75 @@
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef ANAKIN_SABER_FUNCS_IMPL_X86_PACKED_HALF_GEMM_H
+#define ANAKIN_SABER_FUNCS_IMPL_X86_PACKED_HALF_GEMM_H
+
+#include "saber/core/tensor.h"
+
+namespace anakin {
+namespace saber {
+
+/**
+ * \brief c = a * b + bias with fp32 a and c, and b prepacked at init as fp16 or bf16.
+ * b is packed in panels of 16 columns and stays 16 bit in memory, a panel row is
+ * expanded to fp32 in registers (F16C / AVX-512 for fp16, a shift for bf16) right
+ * before the fma, so the weights stream at half the bytes of a fp32 gemm.
+ * this pays off for the small m, bandwidth bound fc and rnn gemms.
+ */
+class PackedHalfGemm {
+public:
+    PackedHalfGemm() = default;
+    ~PackedHalfGemm() {}
+
+    /**
+     * \brief pack b, which is k x n row major, or n x k row major when trans_b.
+     * ldb is the row stride of b as stored, b_dtype is AK_FLOAT, AK_HALF or AK_BFLOAT16,
+     * pack_dtype is AK_HALF or AK_BFLOAT16, fp32 b is rounded to it.
+     */
+    SaberStatus init(const bool trans_b, const int n, const int k,
+                     const void* b, const int ldb,
+                     const DataType b_dtype, const DataType pack_dtype);
+
+    /**
+     * \brief c[m x n] = a[m x k] * b + bias, or c += a * b + bias with accumulate.
+     * bias may be nullptr, parallel over row blocks and column panels.
+     */
+    SaberStatus dispatch(const int m, const float* a, const int lda,
+                         float* c, const int ldc,
+                         const float* bias = nullptr, const bool accumulate = false) const;
+
+    int n() const {
+        return _n;
+    }
+    int k() const {
+        return _k;
+    }
+    DataType pack_dtype() const {
+        return _pack_dtype;
+    }
+
+private:
+    int _n{0};
+    int _k{0};
+    int _panel_num{0};
+    DataType _pack_dtype{AK_HALF};
+    //! [panel][k][16] 16 bit values, zero past n
+    Tensor<X86> _packed_b;
+};
+
+} // namespace saber
+} // namespace anakin
+
+#endif // ANAKIN_SABER_FUNCS_IMPL_X86_PACKED_HALF_GEMM_H
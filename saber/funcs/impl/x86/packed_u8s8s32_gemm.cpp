@@ -0,0 +1,378 @@
+#include "saber/funcs/impl/x86/packed_u8s8s32_gemm.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <immintrin.h>
+
+namespace anakin {
+namespace saber {
+
+namespace {
+
+const int PANEL_N = 16;
+//! rows of a one call of the micro kernel computes
+const int BLOCK_M = 4;
+//! rows of a a thread takes in one piece of work
+const int PARALLEL_BLOCK_M = 64;
+//! m * n * k below this runs on the calling thread
+const int64_t PARALLEL_MIN_WORK = 1 << 18;
+
+//! bytes of one k group of a panel, 16 columns by 4 int8 or by 2 int16
+const int GROUP_BYTES = 64;
+
+//! the k_group unsigned values of a row starting at k0, zero past k
+inline int32_t load_a_group(const uint8_t* a, const int k0, const int k, const int k_group) {
+    uint8_t val[4] = {0, 0, 0, 0};
+    int len = std::min(k_group, k - k0);
+
+    for (int t = 0; t < len; ++t) {
+        val[t] = a[k0 + t];
+    }
+
+    if (k_group == 4) {
+        return (int32_t)val[0] | ((int32_t)val[1] << 8) | ((int32_t)val[2] << 16)
+               | ((int32_t)val[3] << 24);
+    }
+
+    return (int32_t)val[0] | ((int32_t)val[1] << 16);
+}
+
+inline void store_c(const int32_t* acc, int32_t* c, const int nc, const int32_t* comp) {
+    for (int j = 0; j < nc; ++j) {
+        c[j] = acc[j] + (comp != nullptr ? comp[j] : 0);
+    }
+}
+
+#if defined(__AVX2__)
+
+inline void store_c_avx2(__m256i acc0, __m256i acc1, int32_t* c, const int nc,
+                         const int32_t* comp) {
+    if (comp != nullptr) {
+        acc0 = _mm256_add_epi32(acc0, _mm256_loadu_si256((const __m256i*)comp));
+        acc1 = _mm256_add_epi32(acc1, _mm256_loadu_si256((const __m256i*)(comp + 8)));
+    }
+
+    if (nc == PANEL_N) {
+        _mm256_storeu_si256((__m256i*)c, acc0);
+        _mm256_storeu_si256((__m256i*)(c + 8), acc1);
+    } else {
+        int32_t buf[PANEL_N];
+        _mm256_storeu_si256((__m256i*)buf, acc0);
+        _mm256_storeu_si256((__m256i*)(buf + 8), acc1);
+        store_c(buf, c, nc, nullptr);
+    }
+}
+
+/**
+ * MR rows of a times one panel of b with vpmaddubsw, the 4 bytes of a row are broadcast,
+ * pairs of u8 * s8 are summed to int16, then vpmaddwd against ones sums them to int32.
+ */
+template <int MR>
+inline void kernel_u8s8_mrx16(const int k, const uint8_t* a, const int lda,
+                              const int8_t* b, int32_t* c, const int ldc,
+                              const int nc, const int32_t* comp) {
+    __m256i acc[MR][2];
+    const __m256i ones = _mm256_set1_epi16(1);
+
+    for (int r = 0; r < MR; ++r) {
+        acc[r][0] = _mm256_setzero_si256();
+        acc[r][1] = _mm256_setzero_si256();
+    }
+
+    const int k_full = k / 4 * 4;
+    int k0 = 0;
+
+    for (; k0 < k_full; k0 += 4) {
+        const __m256i b0 = _mm256_loadu_si256((const __m256i*)b);
+        const __m256i b1 = _mm256_loadu_si256((const __m256i*)(b + 32));
+
+        for (int r = 0; r < MR; ++r) {
+            int32_t a_val;
+            memcpy(&a_val, a + r * lda + k0, sizeof(a_val));
+            const __m256i va = _mm256_set1_epi32(a_val);
+            acc[r][0] = _mm256_add_epi32(acc[r][0],
+                                         _mm256_madd_epi16(_mm256_maddubs_epi16(va, b0), ones));
+            acc[r][1] = _mm256_add_epi32(acc[r][1],
+                                         _mm256_madd_epi16(_mm256_maddubs_epi16(va, b1), ones));
+        }
+
+        b += GROUP_BYTES;
+    }
+
+    if (k0 < k) {
+        const __m256i b0 = _mm256_loadu_si256((const __m256i*)b);
+        const __m256i b1 = _mm256_loadu_si256((const __m256i*)(b + 32));
+
+        for (int r = 0; r < MR; ++r) {
+            const __m256i va = _mm256_set1_epi32(load_a_group(a + r * lda, k0, k, 4));
+            acc[r][0] = _mm256_add_epi32(acc[r][0],
+                                         _mm256_madd_epi16(_mm256_maddubs_epi16(va, b0), ones));
+            acc[r][1] = _mm256_add_epi32(acc[r][1],
+                                         _mm256_madd_epi16(_mm256_maddubs_epi16(va, b1), ones));
+        }
+    }
+
+    for (int r = 0; r < MR; ++r) {
+        store_c_avx2(acc[r][0], acc[r][1], c + r * ldc, nc, comp);
+    }
+}
+
+//! MR rows of a times one panel of b with vpmaddwd, a pair of a is widened to int16 and broadcast
+template <int MR>
+inline void kernel_s16_mrx16(const int k, const uint8_t* a, const int lda,
+                             const int8_t* b, int32_t* c, const int ldc,
+                             const int nc, const int32_t* comp) {
+    __m256i acc[MR][2];
+
+    for (int r = 0; r < MR; ++r) {
+        acc[r][0] = _mm256_setzero_si256();
+        acc[r][1] = _mm256_setzero_si256();
+    }
+
+    const int k_full = k / 2 * 2;
+    int k0 = 0;
+
+    for (; k0 < k_full; k0 += 2) {
+        const __m256i b0 = _mm256_loadu_si256((const __m256i*)b);
+        const __m256i b1 = _mm256_loadu_si256((const __m256i*)(b + 32));
+
+        for (int r = 0; r < MR; ++r) {
+            const uint8_t* a_row = a + r * lda + k0;
+            const __m256i va = _mm256_set1_epi32((int32_t)a_row[0] | ((int32_t)a_row[1] << 16));
+            acc[r][0] = _mm256_add_epi32(acc[r][0], _mm256_madd_epi16(va, b0));
+            acc[r][1] = _mm256_add_epi32(acc[r][1], _mm256_madd_epi16(va, b1));
+        }
+
+        b += GROUP_BYTES;
+    }
+
+    if (k0 < k) {
+        const __m256i b0 = _mm256_loadu_si256((const __m256i*)b);
+        const __m256i b1 = _mm256_loadu_si256((const __m256i*)(b + 32));
+
+        for (int r = 0; r < MR; ++r) {
+            const __m256i va = _mm256_set1_epi32(load_a_group(a + r * lda, k0, k, 2));
+            acc[r][0] = _mm256_add_epi32(acc[r][0], _mm256_madd_epi16(va, b0));
+            acc[r][1] = _mm256_add_epi32(acc[r][1], _mm256_madd_epi16(va, b1));
+        }
+    }
+
+    for (int r = 0; r < MR; ++r) {
+        store_c_avx2(acc[r][0], acc[r][1], c + r * ldc, nc, comp);
+    }
+}
+
+template <int MR>
+inline void kernel_mrx16(const int k_group, const int k, const uint8_t* a, const int lda,
+                         const int8_t* b, int32_t* c, const int ldc,
+                         const int nc, const int32_t* comp) {
+    if (k_group == 4) {
+        kernel_u8s8_mrx16<MR>(k, a, lda, b, c, ldc, nc, comp);
+    } else {
+        kernel_s16_mrx16<MR>(k, a, lda, b, c, ldc, nc, comp);
+    }
+}
+
+#else
+
+template <int MR>
+inline void kernel_mrx16(const int k_group, const int k, const uint8_t* a, const int lda,
+                         const int8_t* b, int32_t* c, const int ldc,
+                         const int nc, const int32_t* comp) {
+    const int16_t* b_s16 = reinterpret_cast<const int16_t*>(b);
+
+    for (int r = 0; r < MR; ++r) {
+        int32_t acc[PANEL_N] = {0};
+        const uint8_t* a_row = a + r * lda;
+
+        for (int k0 = 0; k0 < k; ++k0) {
+            const int g = k0 / k_group;
+            const int t = k0 % k_group;
+            const int32_t a_val = a_row[k0];
+
+            for (int j = 0; j < PANEL_N; ++j) {
+                const int32_t b_val = (k_group == 4) ? b[g * GROUP_BYTES + j * 4 + t] :
+                                      b_s16[g * GROUP_BYTES / 2 + j * 2 + t];
+                acc[j] += a_val * b_val;
+            }
+        }
+
+        store_c(acc, c + r * ldc, nc, comp);
+    }
+}
+
+#endif
+
+} //namespace
+
+SaberStatus PackedU8S8S32Gemm::init(const bool trans_b, const int n, const int k,
+                                    const int8_t* b, const int ldb) {
+    CHECK(b != nullptr);
+    CHECK_GT(n, 0);
+    CHECK_GT(k, 0);
+    _n = n;
+    _k = k;
+
+    auto b_at = [&](int kk, int nn) -> int8_t {
+        return trans_b ? b[nn * ldb + kk] : b[kk * ldb + nn];
+    };
+
+    int max_abs = 0;
+
+    for (int kk = 0; kk < k; ++kk) {
+        for (int nn = 0; nn < n; ++nn) {
+            max_abs = std::max(max_abs, std::abs((int)b_at(kk, nn)));
+        }
+    }
+
+    _k_group = max_abs <= 64 ? 4 : 2;
+    _k_padded = (k + _k_group - 1) / _k_group * _k_group;
+    _panel_num = (n + PANEL_N - 1) / PANEL_N;
+    const int group_num = _k_padded / _k_group;
+    const int panel_bytes = group_num * GROUP_BYTES;
+
+    _packed_b.re_alloc(Shape({1, 1, _panel_num, panel_bytes}), AK_INT8);
+    _compensation.re_alloc(Shape({1, 1, 1, _panel_num * PANEL_N}), AK_INT32);
+    int8_t* packed = static_cast<int8_t*>(_packed_b.mutable_data());
+    int32_t* comp = static_cast<int32_t*>(_compensation.mutable_data());
+    memset(packed, 0, (size_t)_panel_num * panel_bytes);
+    memset(comp, 0, sizeof(int32_t) * _panel_num * PANEL_N);
+
+    for (int p = 0; p < _panel_num; ++p) {
+        int8_t* panel = packed + (size_t)p * panel_bytes;
+        int16_t* panel_s16 = reinterpret_cast<int16_t*>(panel);
+        const int nc = std::min(PANEL_N, n - p * PANEL_N);
+
+        for (int kk = 0; kk < k; ++kk) {
+            const int g = kk / _k_group;
+            const int t = kk % _k_group;
+
+            for (int j = 0; j < nc; ++j) {
+                const int8_t val = b_at(kk, p * PANEL_N + j);
+                comp[p * PANEL_N + j] -= 128 * (int32_t)val;
+
+                if (_k_group == 4) {
+                    panel[g * GROUP_BYTES + j * 4 + t] = val;
+                } else {
+                    panel_s16[g * GROUP_BYTES / 2 + j * 2 + t] = val;
+                }
+            }
+        }
+    }
+
+    return SaberSuccess;
+}
+
+void PackedU8S8S32Gemm::compute_panels(const int m, const uint8_t* a, const int lda,
+                                       int32_t* c, const int ldc, const bool shifted_a,
+                                       const int panel_begin, const int panel_end) const {
+    const int8_t* packed = static_cast<const int8_t*>(_packed_b.data());
+    const int32_t* comp = static_cast<const int32_t*>(_compensation.data());
+    const size_t panel_bytes = (size_t)_k_padded / _k_group * GROUP_BYTES;
+
+    for (int p = panel_begin; p < panel_end; ++p) {
+        const int8_t* panel = packed + p * panel_bytes;
+        const int nc = std::min(PANEL_N, _n - p * PANEL_N);
+        const int32_t* panel_comp = shifted_a ? comp + p * PANEL_N : nullptr;
+        int32_t* c_panel = c + p * PANEL_N;
+        int r = 0;
+
+        for (; r + BLOCK_M <= m; r += BLOCK_M) {
+            kernel_mrx16<BLOCK_M>(_k_group, _k, a + (size_t)r * lda, lda, panel,
+                                  c_panel + (size_t)r * ldc, ldc, nc, panel_comp);
+        }
+
+        switch (m - r) {
+        case 3:
+            kernel_mrx16<3>(_k_group, _k, a + (size_t)r * lda, lda, panel,
+                            c_panel + (size_t)r * ldc, ldc, nc, panel_comp);
+            break;
+
+        case 2:
+            kernel_mrx16<2>(_k_group, _k, a + (size_t)r * lda, lda, panel,
+                            c_panel + (size_t)r * ldc, ldc, nc, panel_comp);
+            break;
+
+        case 1:
+            kernel_mrx16<1>(_k_group, _k, a + (size_t)r * lda, lda, panel,
+                            c_panel + (size_t)r * ldc, ldc, nc, panel_comp);
+            break;
+
+        default:
+            break;
+        }
+    }
+}
+
+void PackedU8S8S32Gemm::compute(const int m, const uint8_t* a, const int lda,
+                                int32_t* c, const int ldc, const bool shifted_a) const {
+    compute_panels(m, a, lda, c, ldc, shifted_a, 0, _panel_num);
+}
+
+SaberStatus PackedU8S8S32Gemm::dispatch(const int m, const uint8_t* a, const int lda,
+                                        int32_t* c, const int ldc, const bool shifted_a) const {
+    CHECK(a != nullptr);
+    CHECK(c != nullptr);
+    const int row_blocks = (m + PARALLEL_BLOCK_M - 1) / PARALLEL_BLOCK_M;
+    const int64_t work = (int64_t)m * _n * _k;
+
+#pragma omp parallel for collapse(2) schedule(static) if (work >= PARALLEL_MIN_WORK)
+    for (int rb = 0; rb < row_blocks; ++rb) {
+        for (int p = 0; p < _panel_num; ++p) {
+            const int r0 = rb * PARALLEL_BLOCK_M;
+            const int rows = std::min(PARALLEL_BLOCK_M, m - r0);
+            compute_panels(rows, a + (size_t)r0 * lda, lda, c + (size_t)r0 * ldc, ldc,
+                           shifted_a, p, p + 1);
+        }
+    }
+
+    return SaberSuccess;
+}
+
+void PackedU8S8S32Gemm::shift_s8_to_u8(const int8_t* src, uint8_t* dst, const size_t size) {
+    size_t i = 0;
+#if defined(__AVX2__)
+    const __m256i sign = _mm256_set1_epi8((char)0x80);
+
+    for (; i + 32 <= size; i += 32) {
+        __m256i v = _mm256_loadu_si256((const __m256i*)(src + i));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_xor_si256(v, sign));
+    }
+
+#endif
+
+    for (; i < size; ++i) {
+        dst[i] = (uint8_t)(src[i] ^ 0x80);
+    }
+}
+
+void PackedU8S8S32Gemm::quantize_fp32_to_shifted_u8(const float* src, uint8_t* dst,
+        const size_t size, const float scale) {
+    size_t i = 0;
+#if defined(__AVX2__)
+    const __m256 vscale = _mm256_set1_ps(scale);
+    const __m256i sign = _mm256_set1_epi8((char)0x80);
+    const __m256i order = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+    for (; i + 32 <= size; i += 32) {
+        __m256i v0 = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(src + i), vscale));
+        __m256i v1 = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(src + i + 8), vscale));
+        __m256i v2 = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(src + i + 16), vscale));
+        __m256i v3 = _mm256_cvtps_epi32(_mm256_mul_ps(_mm256_loadu_ps(src + i + 24), vscale));
+        __m256i s01 = _mm256_packs_epi32(v0, v1);
+        __m256i s23 = _mm256_packs_epi32(v2, v3);
+        __m256i s8 = _mm256_permutevar8x32_epi32(_mm256_packs_epi16(s01, s23), order);
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_xor_si256(s8, sign));
+    }
+
+#endif
+
+    for (; i < size; ++i) {
+        float val = nearbyintf(src[i] * scale);
+        val = std::min(std::max(val, -128.f), 127.f);
+        dst[i] = (uint8_t)((int)val + 128);
+    }
+}
+
+} // namespace saber
+} // namespace anakin
@@ -0,0 +1,94 @@
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef ANAKIN_SABER_FUNCS_IMPL_X86_PACKED_U8S8S32_GEMM_H
+#define ANAKIN_SABER_FUNCS_IMPL_X86_PACKED_U8S8S32_GEMM_H
+
+#include "saber/core/tensor.h"
+
+namespace anakin {
+namespace saber {
+
+/**
+ * \brief c = a * b with unsigned 8 bit a, signed 8 bit b prepacked at init and int32 c,
+ * the AVX2 int8 gemm used when avx512 kernels are not available.
+ * b is packed in panels of 16 columns. when all weights fit in 7 bits (|b| <= 64),
+ * k is grouped by 4 and accumulated with vpmaddubsw + vpmaddwd, which can not saturate then,
+ * otherwise k is grouped by 2 in int16 and accumulated with vpmaddwd only.
+ * signed a is handled by the caller shifting it to unsigned (+128),
+ * the shift is removed with the column sums of b.
+ */
+class PackedU8S8S32Gemm {
+public:
+    PackedU8S8S32Gemm() = default;
+    ~PackedU8S8S32Gemm() {}
+
+    /**
+     * \brief pack b, which is k x n row major, or n x k row major when trans_b.
+     * ldb is the row stride of b as stored.
+     */
+    SaberStatus init(const bool trans_b, const int n, const int k,
+                     const int8_t* b, const int ldb);
+
+    /**
+     * \brief c[m x n] = a[m x k] * b, parallel over row blocks and column panels.
+     * with shifted_a, a holds signed values plus 128.
+     */
+    SaberStatus dispatch(const int m, const uint8_t* a, const int lda,
+                         int32_t* c, const int ldc, const bool shifted_a) const;
+
+    //! same as dispatch but run by the calling thread only
+    void compute(const int m, const uint8_t* a, const int lda,
+                 int32_t* c, const int ldc, const bool shifted_a) const;
+
+    //! true when the vpmaddubsw kernel is used
+    bool use_u8s8_madd() const {
+        return _k_group == 4;
+    }
+
+    int n() const {
+        return _n;
+    }
+    int k() const {
+        return _k;
+    }
+
+    //! dst = src + 128, signed to unsigned for the shifted a of dispatch
+    static void shift_s8_to_u8(const int8_t* src, uint8_t* dst, const size_t size);
+
+    //! dst = saturate(round(src * scale)) + 128, fp32 to shifted unsigned a
+    static void quantize_fp32_to_shifted_u8(const float* src, uint8_t* dst,
+                                            const size_t size, const float scale);
+
+private:
+    void compute_panels(const int m, const uint8_t* a, const int lda,
+                        int32_t* c, const int ldc, const bool shifted_a,
+                        const int panel_begin, const int panel_end) const;
+
+    int _n{0};
+    int _k{0};
+    //! k elements one lane holds, 4 for u8s8 madd, 2 for int16 madd
+    int _k_group{4};
+    int _k_padded{0};
+    int _panel_num{0};
+    Tensor<X86> _packed_b;
+    //! -128 * column sum of b, padded to the panels
+    Tensor<X86> _compensation;
+};
+
+} // namespace saber
+} // namespace anakin
+
+#endif // ANAKIN_SABER_FUNCS_IMPL_X86_PACKED_U8S8S32_GEMM_H
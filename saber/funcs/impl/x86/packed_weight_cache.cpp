@@ -0,0 +1,173 @@
+#include "saber/funcs/impl/x86/packed_weight_cache.h"
+#include "saber/funcs/impl/x86/kernel/jit_generator.h"
+#include "saber/core/common.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+
+namespace anakin {
+namespace saber {
+
+namespace {
+
+const char packed_weight_magic[8] = {'A', 'K', 'P', 'W', 'C', 'v', '1', '\0'};
+
+uint64_t hash_bytes(const void* data, size_t bytes, uint64_t seed) {
+    const uint64_t prime = 0x100000001b3ULL;
+    const char* ptr = static_cast<const char*>(data);
+    uint64_t h = seed ^ bytes;
+    size_t i = 0;
+
+    // a word at a time, hashing is done on every init so it must stay cheaper than packing
+    for (; i + sizeof(uint64_t) <= bytes; i += sizeof(uint64_t)) {
+        uint64_t word;
+        memcpy(&word, ptr + i, sizeof(uint64_t));
+        h = (h ^ word) * prime;
+        h ^= h >> 29;
+    }
+
+    for (; i < bytes; ++i) {
+        h = (h ^ static_cast<unsigned char>(ptr[i])) * prime;
+    }
+
+    return h;
+}
+
+std::string cpu_isa_name() {
+    if (jit::mayiuse(jit::avx512_core_vnni)) {
+        return "avx512_core_vnni";
+    } else if (jit::mayiuse(jit::avx512_core)) {
+        return "avx512_core";
+    } else if (jit::mayiuse(jit::avx512_common)) {
+        return "avx512_common";
+    } else if (jit::mayiuse(jit::avx2)) {
+        return "avx2";
+    } else if (jit::mayiuse(jit::avx)) {
+        return "avx";
+    }
+
+    return "sse42";
+}
+
+} // namespace
+
+PackedWeightCache& PackedWeightCache::global() {
+    static PackedWeightCache cache;
+    return cache;
+}
+
+PackedWeightCache::PackedWeightCache() {
+    const char* env = std::getenv("ANAKIN_PACKED_WEIGHTS_CACHE");
+
+    if (env != nullptr) {
+        set_dir(env);
+    }
+}
+
+void PackedWeightCache::set_dir(const std::string& dir) {
+    std::lock_guard<std::mutex> lock(_mut);
+    _dir = dir;
+    _enabled = !_dir.empty();
+}
+
+std::string PackedWeightCache::dir() const {
+    std::lock_guard<std::mutex> lock(_mut);
+    return _dir;
+}
+
+std::string PackedWeightCache::key(const std::string& kernel, int version, const void* src,
+                                   size_t bytes, const std::vector<int64_t>& args) const {
+    static const std::string isa = cpu_isa_name();
+    std::ostringstream key;
+    key << kernel << ".v" << version << "." << isa;
+
+    for (auto arg : args) {
+        key << "." << arg;
+    }
+
+    key << "." << bytes << "." << std::hex << hash_bytes(src, bytes, 0xcbf29ce484222325ULL);
+    return key.str();
+}
+
+std::string PackedWeightCache::path(const std::string& key) const {
+    std::ostringstream name;
+    name << dir() << "/" << std::hex << hash_bytes(key.data(), key.size(), 0) << ".packed";
+    return name.str();
+}
+
+bool PackedWeightCache::load(const std::string& key, void* dst, size_t bytes) {
+    FILE* fp = fopen(path(key).c_str(), "rb");
+    bool match = fp != nullptr;
+    char magic[sizeof(packed_weight_magic)];
+    uint64_t key_size = 0;
+    uint64_t data_size = 0;
+    std::string entry_key;
+
+    match = match && fread(magic, sizeof(magic), 1, fp) == 1
+            && memcmp(magic, packed_weight_magic, sizeof(magic)) == 0;
+    match = match && fread(&key_size, sizeof(key_size), 1, fp) == 1 && key_size == key.size();
+
+    if (match) {
+        entry_key.resize(key_size);
+        match = fread(&entry_key[0], 1, key_size, fp) == key_size && entry_key == key;
+    }
+
+    match = match && fread(&data_size, sizeof(data_size), 1, fp) == 1 && data_size == bytes;
+    match = match && fread(dst, 1, bytes, fp) == bytes;
+
+    if (fp != nullptr) {
+        fclose(fp);
+    }
+
+    if (match) {
+        _hit_count++;
+    } else {
+        _miss_count++;
+    }
+
+    return match;
+}
+
+void PackedWeightCache::store(const std::string& key, const void* src, size_t bytes) {
+    std::string entry_path = path(key);
+    // written aside and renamed, so readers never see a partial entry
+    std::ostringstream tmp_path;
+    tmp_path << entry_path << ".tmp." << getpid() << "." << std::this_thread::get_id();
+    FILE* fp = fopen(tmp_path.str().c_str(), "wb");
+
+    if (fp == nullptr) {
+        LOG(WARNING) << "can not write packed weights cache " << tmp_path.str();
+        return;
+    }
+
+    uint64_t key_size = key.size();
+    uint64_t data_size = bytes;
+    bool done = fwrite(packed_weight_magic, sizeof(packed_weight_magic), 1, fp) == 1
+                && fwrite(&key_size, sizeof(key_size), 1, fp) == 1
+                && fwrite(key.data(), 1, key_size, fp) == key_size
+                && fwrite(&data_size, sizeof(data_size), 1, fp) == 1
+                && fwrite(src, 1, bytes, fp) == bytes;
+    done = fclose(fp) == 0 && done;
+
+    if (!done || rename(tmp_path.str().c_str(), entry_path.c_str()) != 0) {
+        LOG(WARNING) << "can not write packed weights cache " << entry_path;
+        remove(tmp_path.str().c_str());
+        return;
+    }
+
+    _store_count++;
+}
+
+PackedWeightCacheStats PackedWeightCache::stats() const {
+    PackedWeightCacheStats stats;
+    stats.hit_count = _hit_count.load();
+    stats.miss_count = _miss_count.load();
+    stats.store_count = _store_count.load();
+    return stats;
+}
+
+} // namespace saber
+} // namespace anakin
@@ -0,0 +1,101 @@
+/* Copyright (c) 2018 Anakin Authors All Rights Reserve.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+   http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef ANAKIN_SABER_FUNCS_IMPL_X86_PACKED_WEIGHT_CACHE_H
+#define ANAKIN_SABER_FUNCS_IMPL_X86_PACKED_WEIGHT_CACHE_H
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "saber/saber_types.h"
+
+namespace anakin {
+namespace saber {
+
+struct PackedWeightCacheStats {
+    size_t hit_count{0};    ///< packed weights loaded from the cache
+    size_t miss_count{0};   ///< packed weights built by the kernel
+    size_t store_count{0};  ///< packed weights written to the cache
+};
+
+/**
+ * \brief on-disk cache of weights in the packed or transformed form a kernel
+ * builds at init, so later inits of the same model load it instead of repacking.
+ * entries are keyed by kernel name and version, the cpu isa, the pack arguments
+ * and a hash of the source weights, and each entry is one file of the cache dir.
+ * the cache is off until a dir is set, by set_dir or ANAKIN_PACKED_WEIGHTS_CACHE.
+ * a load costs a hash and a read of the source size, so it only pays for transforms
+ * doing more work than that, like the winograd weights transform, not for plain reorders.
+ */
+class PackedWeightCache {
+public:
+    static PackedWeightCache& global();
+
+    /// empty dir turns the cache off
+    void set_dir(const std::string& dir);
+    std::string dir() const;
+    bool enabled() const {
+        return _enabled;
+    }
+
+    /**
+     * \brief key of the packed form of src, args are the pack arguments
+     * the packed layout depends on
+     */
+    std::string key(const std::string& kernel, int version, const void* src, size_t bytes,
+                    const std::vector<int64_t>& args) const;
+
+    /// fill bytes of dst from the entry of key, false if it is missing or does not match
+    bool load(const std::string& key, void* dst, size_t bytes);
+    void store(const std::string& key, const void* src, size_t bytes);
+
+    /**
+     * \brief load dst from the entry of key, otherwise run pack to fill dst and store it
+     */
+    template <typename Pack>
+    void load_or_pack(const std::string& kernel, int version, const void* src, size_t src_bytes,
+                      const std::vector<int64_t>& args, void* dst, size_t bytes, Pack pack) {
+        if (!enabled()) {
+            pack();
+            return;
+        }
+
+        std::string entry = key(kernel, version, src, src_bytes, args);
+
+        if (!load(entry, dst, bytes)) {
+            pack();
+            store(entry, dst, bytes);
+        }
+    }
+
+    PackedWeightCacheStats stats() const;
+
+private:
+    PackedWeightCache();
+    std::string path(const std::string& key) const;
+
+    mutable std::mutex _mut;
+    std::string _dir;
+    std::atomic<bool> _enabled{false};
+    std::atomic<size_t> _hit_count{0};
+    std::atomic<size_t> _miss_count{0};
+    std::atomic<size_t> _store_count{0};
+};
+
+} // namespace saber
+} // namespace anakin
+
+#endif // ANAKIN_SABER_FUNCS_IMPL_X86_PACKED_WEIGHT_CACHE_H
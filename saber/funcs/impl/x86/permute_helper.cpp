@@ -0,0 +1,244 @@
+#include "saber/funcs/impl/x86/permute_helper.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <immintrin.h>
+
+namespace anakin {
+
+namespace saber {
+
+namespace {
+
+//! tensors smaller than this are permuted by the calling thread only
+const int64_t PERMUTE_PARALLEL_MIN = 1 << 14;
+const int PERMUTE_TILE = 8;
+
+struct PermuteAxes {
+    std::vector<int> dims;
+    std::vector<int64_t> in_strides;
+    std::vector<int64_t> out_strides;
+
+    int size() const {
+        return dims.size();
+    }
+    void push_back(int dim, int64_t in_stride, int64_t out_stride) {
+        dims.push_back(dim);
+        in_strides.push_back(in_stride);
+        out_strides.push_back(out_stride);
+    }
+};
+
+//! offsets of the idx-th element of the given axes, the last axis being the innermost
+inline void axes_offset(int64_t idx, const PermuteAxes& axes,
+                        int64_t* in_offset, int64_t* out_offset) {
+    int64_t in_off = 0;
+    int64_t out_off = 0;
+    for (int i = axes.size() - 1; i >= 0; --i) {
+        int64_t id = idx % axes.dims[i];
+        idx /= axes.dims[i];
+        in_off += id * axes.in_strides[i];
+        out_off += id * axes.out_strides[i];
+    }
+    *in_offset = in_off;
+    *out_offset = out_off;
+}
+
+//! dst[c * ld_dst + r] = src[r * ld_src + c] for an 8x8 tile
+inline void transpose_tile_8x8(const float* src, int64_t ld_src, float* dst, int64_t ld_dst) {
+#if defined(__AVX2__)
+    __m256 r0 = _mm256_loadu_ps(src);
+    __m256 r1 = _mm256_loadu_ps(src + ld_src);
+    __m256 r2 = _mm256_loadu_ps(src + 2 * ld_src);
+    __m256 r3 = _mm256_loadu_ps(src + 3 * ld_src);
+    __m256 r4 = _mm256_loadu_ps(src + 4 * ld_src);
+    __m256 r5 = _mm256_loadu_ps(src + 5 * ld_src);
+    __m256 r6 = _mm256_loadu_ps(src + 6 * ld_src);
+    __m256 r7 = _mm256_loadu_ps(src + 7 * ld_src);
+    __m256 t0 = _mm256_unpacklo_ps(r0, r1);
+    __m256 t1 = _mm256_unpackhi_ps(r0, r1);
+    __m256 t2 = _mm256_unpacklo_ps(r2, r3);
+    __m256 t3 = _mm256_unpackhi_ps(r2, r3);
+    __m256 t4 = _mm256_unpacklo_ps(r4, r5);
+    __m256 t5 = _mm256_unpackhi_ps(r4, r5);
+    __m256 t6 = _mm256_unpacklo_ps(r6, r7);
+    __m256 t7 = _mm256_unpackhi_ps(r6, r7);
+    __m256 s0 = _mm256_shuffle_ps(t0, t2, 0x44);
+    __m256 s1 = _mm256_shuffle_ps(t0, t2, 0xEE);
+    __m256 s2 = _mm256_shuffle_ps(t1, t3, 0x44);
+    __m256 s3 = _mm256_shuffle_ps(t1, t3, 0xEE);
+    __m256 s4 = _mm256_shuffle_ps(t4, t6, 0x44);
+    __m256 s5 = _mm256_shuffle_ps(t4, t6, 0xEE);
+    __m256 s6 = _mm256_shuffle_ps(t5, t7, 0x44);
+    __m256 s7 = _mm256_shuffle_ps(t5, t7, 0xEE);
+    _mm256_storeu_ps(dst, _mm256_permute2f128_ps(s0, s4, 0x20));
+    _mm256_storeu_ps(dst + ld_dst, _mm256_permute2f128_ps(s1, s5, 0x20));
+    _mm256_storeu_ps(dst + 2 * ld_dst, _mm256_permute2f128_ps(s2, s6, 0x20));
+    _mm256_storeu_ps(dst + 3 * ld_dst, _mm256_permute2f128_ps(s3, s7, 0x20));
+    _mm256_storeu_ps(dst + 4 * ld_dst, _mm256_permute2f128_ps(s0, s4, 0x31));
+    _mm256_storeu_ps(dst + 5 * ld_dst, _mm256_permute2f128_ps(s1, s5, 0x31));
+    _mm256_storeu_ps(dst + 6 * ld_dst, _mm256_permute2f128_ps(s2, s6, 0x31));
+    _mm256_storeu_ps(dst + 7 * ld_dst, _mm256_permute2f128_ps(s3, s7, 0x31));
+#else
+    for (int c = 0; c < PERMUTE_TILE; ++c) {
+        for (int r = 0; r < PERMUTE_TILE; ++r) {
+            dst[c * ld_dst + r] = src[r * ld_src + c];
+        }
+    }
+#endif
+}
+
+//! both tensors are contiguous along the innermost output axis, copy whole rows
+void permute_rows(const float* src, float* dst, const PermuteAxes& axes, int64_t count) {
+    int last = axes.size() - 1;
+    int64_t row = axes.dims[last];
+    PermuteAxes outer;
+    for (int i = 0; i < last; ++i) {
+        outer.push_back(axes.dims[i], axes.in_strides[i], axes.out_strides[i]);
+    }
+    int64_t outer_count = count / row;
+    if (outer_count == 1) {
+        // one contiguous block, split it for the threads
+        const int64_t chunk = 1 << 14;
+        int64_t chunk_num = (row + chunk - 1) / chunk;
+#pragma omp parallel for schedule(static) if (count >= PERMUTE_PARALLEL_MIN)
+        for (int64_t i = 0; i < chunk_num; ++i) {
+            int64_t len = std::min(chunk, row - i * chunk);
+            memcpy(dst + i * chunk, src + i * chunk, sizeof(float) * len);
+        }
+        return;
+    }
+#pragma omp parallel for schedule(static) if (count >= PERMUTE_PARALLEL_MIN)
+    for (int64_t i = 0; i < outer_count; ++i) {
+        int64_t in_off = 0;
+        int64_t out_off = 0;
+        axes_offset(i, outer, &in_off, &out_off);
+        memcpy(dst + out_off, src + in_off, sizeof(float) * row);
+    }
+}
+
+/**
+ * the innermost output axis (cols) and the innermost input axis (rows) differ,
+ * every outer index holds a rows x cols transpose, done in 8x8 tiles.
+ */
+void permute_transpose(const float* src, float* dst, const PermuteAxes& axes,
+                       int row_axis, int64_t count) {
+    int last = axes.size() - 1;
+    int rows = axes.dims[row_axis];
+    int cols = axes.dims[last];
+    int64_t ld_src = axes.in_strides[last];
+    int64_t ld_dst = axes.out_strides[row_axis];
+    PermuteAxes outer;
+    for (int i = 0; i < last; ++i) {
+        if (i != row_axis) {
+            outer.push_back(axes.dims[i], axes.in_strides[i], axes.out_strides[i]);
+        }
+    }
+    int64_t outer_count = count / ((int64_t)rows * cols);
+    int row_blocks = (rows + PERMUTE_TILE - 1) / PERMUTE_TILE;
+
+#pragma omp parallel for collapse(2) schedule(static) if (count >= PERMUTE_PARALLEL_MIN)
+    for (int64_t i = 0; i < outer_count; ++i) {
+        for (int rb = 0; rb < row_blocks; ++rb) {
+            int64_t in_off = 0;
+            int64_t out_off = 0;
+            axes_offset(i, outer, &in_off, &out_off);
+            int r0 = rb * PERMUTE_TILE;
+            int nr = std::min(PERMUTE_TILE, rows - r0);
+            const float* src_row = src + in_off + r0;
+            float* dst_row = dst + out_off + r0 * ld_dst;
+            for (int c0 = 0; c0 < cols; c0 += PERMUTE_TILE) {
+                int nc = std::min(PERMUTE_TILE, cols - c0);
+                const float* src_tile = src_row + c0 * ld_src;
+                float* dst_tile = dst_row + c0;
+                if (nr == PERMUTE_TILE && nc == PERMUTE_TILE) {
+                    transpose_tile_8x8(src_tile, ld_src, dst_tile, ld_dst);
+                } else {
+                    for (int r = 0; r < nr; ++r) {
+                        for (int c = 0; c < nc; ++c) {
+                            dst_tile[r * ld_dst + c] = src_tile[c * ld_src + r];
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+//! generic case, the innermost output axis is copied with strides
+void permute_strided(const float* src, float* dst, const PermuteAxes& axes, int64_t count) {
+    int last = axes.size() - 1;
+    int row = axes.dims[last];
+    int64_t in_step = axes.in_strides[last];
+    int64_t out_step = axes.out_strides[last];
+    PermuteAxes outer;
+    for (int i = 0; i < last; ++i) {
+        outer.push_back(axes.dims[i], axes.in_strides[i], axes.out_strides[i]);
+    }
+    int64_t outer_count = count / row;
+#pragma omp parallel for schedule(static) if (count >= PERMUTE_PARALLEL_MIN)
+    for (int64_t i = 0; i < outer_count; ++i) {
+        int64_t in_off = 0;
+        int64_t out_off = 0;
+        axes_offset(i, outer, &in_off, &out_off);
+        const float* src_row = src + in_off;
+        float* dst_row = dst + out_off;
+        for (int j = 0; j < row; ++j) {
+            dst_row[j * out_step] = src_row[j * in_step];
+        }
+    }
+}
+
+} //namespace
+
+void permute_x86(const float* src, float* dst,
+                 const std::vector<int>& in_shape, const std::vector<int>& order,
+                 const std::vector<int>& in_strides, const std::vector<int>& out_strides) {
+    // axes in output order, size one axes dropped and adjacent axes merged
+    PermuteAxes axes;
+    int64_t count = 1;
+    for (int i = 0; i < order.size(); ++i) {
+        int dim = in_shape[order[i]];
+        count *= dim;
+        if (dim == 1) {
+            continue;
+        }
+        int64_t in_stride = in_strides[order[i]];
+        int64_t out_stride = out_strides[i];
+        int n = axes.size();
+        if (n > 0 && axes.in_strides[n - 1] == in_stride * dim
+                && axes.out_strides[n - 1] == out_stride * dim) {
+            axes.dims[n - 1] *= dim;
+            axes.in_strides[n - 1] = in_stride;
+            axes.out_strides[n - 1] = out_stride;
+        } else {
+            axes.push_back(dim, in_stride, out_stride);
+        }
+    }
+    if (count == 0) {
+        return;
+    }
+    if (axes.size() == 0) {
+        dst[0] = src[0];
+        return;
+    }
+
+    int last = axes.size() - 1;
+    if (axes.out_strides[last] == 1 && axes.in_strides[last] == 1) {
+        permute_rows(src, dst, axes, count);
+        return;
+    }
+    if (axes.out_strides[last] == 1) {
+        for (int i = 0; i < last; ++i) {
+            if (axes.in_strides[i] == 1) {
+                permute_transpose(src, dst, axes, i, count);
+                return;
+            }
+        }
+    }
+    permute_strided(src, dst, axes, count);
+}
+
+} //namespace saber
+
+} //namespace anakin
@@ -0,0 +1,40 @@
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef ANAKIN_SABER_FUNCS_IMPL_X86_PERMUTE_HELPER_H
+#define ANAKIN_SABER_FUNCS_IMPL_X86_PERMUTE_HELPER_H
+
+#include <vector>
+
+namespace anakin {
+
+namespace saber {
+
+/**
+ * \brief permute a strided float tensor, output axis i takes input axis order[i].
+ * in_shape is the valid shape of the input, strides are in elements.
+ * axes of size one are dropped and axes that stay adjacent are merged, then
+ * the permute runs as a row copy, a batch of 2D transposes in 8x8 tiles,
+ * or a strided copy of the innermost output axis, parallel over the outer axes.
+ */
+void permute_x86(const float* src, float* dst,
+                 const std::vector<int>& in_shape, const std::vector<int>& order,
+                 const std::vector<int>& in_strides, const std::vector<int>& out_strides);
+
+} //namespace saber
+
+} //namespace anakin
+
+#endif //ANAKIN_SABER_FUNCS_IMPL_X86_PERMUTE_HELPER_H
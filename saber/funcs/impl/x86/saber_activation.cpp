@@ -5,9 +5,6 @@
 #include "saber/funcs/impl/x86/saber_avx512_funcs.h"
 #include "saber/funcs/impl/x86/saber_avx2_funcs.h"
 #include <x86intrin.h>
-#if defined(__AVX2__) and defined(__FMA__)
-#include "saber/funcs/impl/x86/saber_avx2_funcs.h"
-#endif
 #include <cmath>
 
 namespace anakin{
@@ -134,14 +131,16 @@ SaberStatus SaberActivation<X86, OpDtype>::dispatch(
             OpDataType *input_data = (OpDataType*)inputs[vc]->mutable_data();
             OpDataType *output_data = (OpDataType*)outputs[vc]->mutable_data();
             outputs[vc]->set_posstive_flag(true);
-#if defined(__AVX2__) and defined(__FMA__)
-            avx2_vector_relu(input_data,len,output_data);
-#else
+#if defined(SABER_WITH_AVX2_FUNCS)
+            if (avx2_can_used()) {
+                avx2_vector_relu(input_data,len,output_data);
+                continue;
+            }
+#endif
 #pragma omp parallel for schedule(static)
             for (size_t i = 0; i < len; i++) {
                 output_data[i] = input_data[i] > (OpDataType)0 ? input_data[i] : (OpDataType)0;
             }
-#endif
         }
     }
 
@@ -165,15 +164,21 @@ SaberStatus SaberActivation<X86, OpDtype>::dispatch(
             const OpDataType *input_data = (OpDataType*)inputs[i]->data();
             outputs[i]->set_posstive_flag(true);
             OpDataType *output_data = (OpDataType*)outputs[i]->mutable_data();
-#if defined(__AVX512F__)
-            avx512_vector_sigmoid(input_data, len, output_data);
-#elif defined(__AVX2__) and defined(__FMA__)
-            avx2_vector_sigmoid(input_data, len, output_data);
-#else
+#if defined(SABER_WITH_AVX512_FUNCS)
+            if (avx512_can_used()) {
+                avx512_vector_sigmoid(input_data, len, output_data);
+                continue;
+            }
+#endif
+#if defined(SABER_WITH_AVX2_FUNCS)
+            if (avx2_can_used()) {
+                avx2_vector_sigmoid(input_data, len, output_data);
+                continue;
+            }
+#endif
             for (size_t j = 0; j < len; j++) {
                 output_data[j] = 1.0f / (1.0f + exp(-input_data[j]));
             }
-#endif
         }
     }
 
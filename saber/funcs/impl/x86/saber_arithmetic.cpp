@@ -1,9 +1,7 @@
 
 #include "saber/funcs/impl/x86/saber_arithmetic.h"
 #include "mkl.h"
-#if defined(__AVX2__) and defined(__FMA__)
 #include "saber/funcs/impl/x86/saber_avx2_funcs.h"
-#endif
 #include <cmath>
 
 namespace anakin{
@@ -54,14 +52,17 @@ SaberStatus SaberArithmetic<X86, OpDtype>::dispatch(
             auto input_1 = input_data_1 + seq_offset_1[i] * inner_size;
             auto out = output_data + seq_offset_0[i] * inner_size;
             int len = std::min(len_0, len_1);
-#if defined(__AVX2__) and defined(__FMA__)
-            avx2_vector_sum(input_0, input_1, len, out);
-#else
+#if defined(SABER_WITH_AVX2_FUNCS)
+            if (avx2_can_used()) {
+                avx2_vector_sum(input_0, input_1, len, out);
+            } else
+#endif
+            {
 #pragma omp parallel for schedule(static)
-            for (int j = 0; j < len; j++) {
-                out[j] = input_0[j] + input_1[j];
+                for (int j = 0; j < len; j++) {
+                    out[j] = input_0[j] + input_1[j];
+                }
             }
-#endif
             if (len_0 > len) {
                 memcpy(out + len, input_0 + len, sizeof(OpDataType) * (len_0 -len));
             }
@@ -80,14 +81,17 @@ SaberStatus SaberArithmetic<X86, OpDtype>::dispatch(
             auto input_1 = input_data_1 + seq_offset_1[i] * inner_size;
             auto out = output_data + seq_offset_0[i] * inner_size;
             int len = std::min(len_0, len_1);
-#if defined(__AVX2__) and defined(__FMA__)
-            avx2_vector_sub(input_0, input_1, len, out);
-#else
+#if defined(SABER_WITH_AVX2_FUNCS)
+            if (avx2_can_used()) {
+                avx2_vector_sub(input_0, input_1, len, out);
+            } else
+#endif
+            {
 #pragma omp parallel for schedule(static)
-            for (int j = 0; j < len; j++) {
-                out[j] = input_0[j] - input_1[j];
+                for (int j = 0; j < len; j++) {
+                    out[j] = input_0[j] - input_1[j];
+                }
             }
-#endif
             if (len_0 > len) {
                 memcpy(out + len, input_0 + len, sizeof(OpDataType) * (len_0 -len));
             }
@@ -104,14 +108,17 @@ SaberStatus SaberArithmetic<X86, OpDtype>::dispatch(
             auto input_1 = input_data_1 + seq_offset_1[i] * inner_size;
             auto out = output_data + seq_offset_0[i] * inner_size;
             int len = std::min(len_0, len_1);
-#if defined(__AVX2__) and defined(__FMA__)
-            avx2_vector_mul(input_0, input_1, len, out);
-#else
+#if defined(SABER_WITH_AVX2_FUNCS)
+            if (avx2_can_used()) {
+                avx2_vector_mul(input_0, input_1, len, out);
+            } else
+#endif
+            {
 #pragma omp parallel for schedule(static)
-            for (int j = 0; j < len; j++) {
-                out[j] = input_0[j] * input_1[j];
+                for (int j = 0; j < len; j++) {
+                    out[j] = input_0[j] * input_1[j];
+                }
             }
-#endif
             if (len_0 > len) {
                 memcpy(out + len, input_0 + len, sizeof(OpDataType) * (len_0 -len));
             }
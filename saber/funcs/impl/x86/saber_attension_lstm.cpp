@@ -240,15 +240,18 @@ cpu_dispatch(const std::vector<OpTensor*>& inputs,
         }
 
         int fc_num = attn_param.fc_vec.size();
-#if defined(__AVX2__) and defined(__FMA__)
-        avx2_sequence_softmax(static_cast<OpDataType*>(_attn_outs[fc_num - 1]->mutable_data()), seq_offset, static_cast<OpDataType*>(_softmax_out.mutable_data()));
-        avx2_sequence_pool(static_cast<const OpDataType*>(inputs[0]->data()), static_cast<const OpDataType*>(_softmax_out.data()), seq_offset,
-                           inputs[0]->valid_size() / word_num, static_cast<OpDataType*>(_pool_out.mutable_data()));
-#else
-        sequence_softmax(static_cast<OpDataType*>(_attn_outs[fc_num - 1]->mutable_data()), seq_offset, static_cast<OpDataType*>(_softmax_out.mutable_data()));
-        sequence_pool(static_cast<const OpDataType*>(inputs[0]->data()), static_cast<const OpDataType*>(_softmax_out.data()), seq_offset,
-                      inputs[0]->valid_size() / word_num, static_cast<OpDataType*>(_pool_out.mutable_data()));
+#if defined(SABER_WITH_AVX2_FUNCS)
+        if (avx2_can_used()) {
+            avx2_sequence_softmax(static_cast<OpDataType*>(_attn_outs[fc_num - 1]->mutable_data()), seq_offset, static_cast<OpDataType*>(_softmax_out.mutable_data()));
+            avx2_sequence_pool(static_cast<const OpDataType*>(inputs[0]->data()), static_cast<const OpDataType*>(_softmax_out.data()), seq_offset,
+                               inputs[0]->valid_size() / word_num, static_cast<OpDataType*>(_pool_out.mutable_data()));
+        } else
 #endif
+        {
+            sequence_softmax(static_cast<OpDataType*>(_attn_outs[fc_num - 1]->mutable_data()), seq_offset, static_cast<OpDataType*>(_softmax_out.mutable_data()));
+            sequence_pool(static_cast<const OpDataType*>(inputs[0]->data()), static_cast<const OpDataType*>(_softmax_out.data()), seq_offset,
+                          inputs[0]->valid_size() / word_num, static_cast<OpDataType*>(_pool_out.mutable_data()));
+        }
 
 
         utils::try_expand_tensor(_hidden_out,seq_num* 4 * _hidden_size);
@@ -262,15 +265,18 @@ cpu_dispatch(const std::vector<OpTensor*>& inputs,
                  static_cast<OpDataType*>(_hidden_out.mutable_data()));
         }
 
-#if defined(__AVX2__) and defined(__FMA__)
-        avx2_lstm_bias_and_act(static_cast<const OpDataType*>(_hidden_out.data()), _weights_bias,
-                          static_cast<OpDataType*>(_lstm_out.mutable_data()) + word_id * seq_num * _hidden_size,
-                          static_cast<OpDataType*>(_cell_out.mutable_data()), seq_num, _hidden_size, false);
-#else
-        lstm_bias_and_act(static_cast<const OpDataType*>(_hidden_out.data()), _weights_bias,
+#if defined(SABER_WITH_AVX2_FUNCS)
+        if (avx2_can_used()) {
+            avx2_lstm_bias_and_act(static_cast<const OpDataType*>(_hidden_out.data()), _weights_bias,
                               static_cast<OpDataType*>(_lstm_out.mutable_data()) + word_id * seq_num * _hidden_size,
                               static_cast<OpDataType*>(_cell_out.mutable_data()), seq_num, _hidden_size, false);
+        } else
 #endif
+        {
+            lstm_bias_and_act(static_cast<const OpDataType*>(_hidden_out.data()), _weights_bias,
+                                  static_cast<OpDataType*>(_lstm_out.mutable_data()) + word_id * seq_num * _hidden_size,
+                                  static_cast<OpDataType*>(_cell_out.mutable_data()), seq_num, _hidden_size, false);
+        }
 
     }
 
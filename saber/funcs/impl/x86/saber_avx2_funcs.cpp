@@ -1,11 +1,25 @@
+#include <cmath>
+#include <vector>
+#include "anakin_config.h"
+#include "saber/saber_types.h"
+#include "saber/funcs/impl/x86/kernel/jit_generator.h"
+#include "saber/funcs/impl/x86/saber_isa_avx2_begin.h"
 #include "saber_avx2_funcs.h"
 #include "saber/funcs/impl/x86/saber_normal_activation.h"
-#include "saber/funcs/debug.h"
 #if defined(__AVX2__) and defined(__FMA__)
 namespace anakin {
 
 namespace saber {
 
+//! the scalar tails, Sigmoid<float> instantiated here would be an avx2 copy of the base one
+static inline float scalar_sigmoid(const float a) {
+    return 1.f / (1.f + expf(-a));
+}
+
+static inline float scalar_tanh(const float a) {
+    return 2.f / (1.f + expf(-2.f * a)) - 1.f;
+}
+
 inline __m256 avx2_load_mask(const float* in, int length) {
     __m256i vec_mask = _m256_continue_mask_m256i(length);
     return _mm256_maskload_ps(in, vec_mask);
@@ -22,7 +36,7 @@ void avx2_vector_relu(const float* in, int length, float* out) {
     __m256 zero = _mm256_setzero_ps();
     #pragma omp parallel for schedule(static)
 
-    for (int i = 0; i < length; i += 8) {
+    for (int i = 0; i < round_length; i += 8) {
         __m256 temp = _mm256_loadu_ps(&in[i]);
         _mm256_storeu_ps(&out[i], _mm256_max_ps(zero, temp));
     }
@@ -40,7 +54,7 @@ void avx2_vector_sigmoid(const float* in, int length, float* out) {
     int round_length = length / 8 * 8;
     #pragma omp parallel for schedule(static)
 
-    for (int i = 0; i < length; i += 8) {
+    for (int i = 0; i < round_length; i += 8) {
         __m256 temp = _mm256_loadu_ps(&in[i]);
         _mm256_storeu_ps(&out[i], Sigmoid(temp));
     }
@@ -61,7 +75,7 @@ void avx2_vector_soft_sign(const float* in, int length, float* out) {
     __m256 zero = _mm256_setzero_ps();
     #pragma omp parallel for schedule(static)
 
-    for (int i = 0; i < length; i += 8) {
+    for (int i = 0; i < round_length; i += 8) {
         __m256 src = _mm256_loadu_ps(&in[i]);
         __m256 src_abs = _mm256_max_ps(src, -src);
         __m256 denominator = _mm256_add_ps(src_abs, one);
@@ -223,12 +237,12 @@ void avx2_lstm_bias_and_act(const float* hidden_in, const float* bias_data, floa
             float*  tmp_out = (float*)(out + i * hidden_size);
 
             for (int j = 0; j < hidden_size / 8; j++) {
-                float ig = Sigmoid(tmp_hidden_i[j] + bias_i[j] + tmp_cell_data[j] * w_ci[j]);
-                float fg = Sigmoid(tmp_hidden_f[j] + bias_f[j] + tmp_cell_data[j] * w_cf[j]);
-                float c_t_0 = Tanh(tmp_hidden_c[j] + bias_c[j]);
+                float ig = scalar_sigmoid(tmp_hidden_i[j] + bias_i[j] + tmp_cell_data[j] * w_ci[j]);
+                float fg = scalar_sigmoid(tmp_hidden_f[j] + bias_f[j] + tmp_cell_data[j] * w_cf[j]);
+                float c_t_0 = scalar_tanh(tmp_hidden_c[j] + bias_c[j]);
                 tmp_cell_data[j] = ig * c_t_0 + fg * tmp_cell_data[j];
-                float og = Sigmoid(tmp_hidden_o[j] + bias_o[j] + tmp_cell_data[j] * w_co[j]);
-                tmp_out[j] = og * Tanh(tmp_cell_data[j]);
+                float og = scalar_sigmoid(tmp_hidden_o[j] + bias_o[j] + tmp_cell_data[j] * w_co[j]);
+                tmp_out[j] = og * scalar_tanh(tmp_cell_data[j]);
             }
         }
     } else {
@@ -470,6 +484,88 @@ void avx2_vector_mul(const float* in_0,
     }
 }
 
+
+template <ActiveType Act>
+inline __m256 avx2_act(const __m256 a) {
+    return a;
+}
+
+template <>
+inline __m256 avx2_act<Active_relu>(const __m256 a) {
+    return Relu(a);
+}
+
+template <>
+inline __m256 avx2_act<Active_sigmoid>(const __m256 a) {
+    return Sigmoid(a);
+}
+
+template <>
+inline __m256 avx2_act<Active_tanh>(const __m256 a) {
+    return Tanh(a);
+}
+
+template <ActiveType Act>
+void avx2_bias_residual_act_impl(float* out, const float* bias, const float* residual,
+                                 const int len) {
+    int round_dim = len / 8 * 8;
+    int remainder = len % 8;
+    __m256i mask_m256i = _m256_continue_mask_m256i(remainder);
+
+    for (int k = 0; k < round_dim; k += 8) {
+        __m256 a = _mm256_loadu_ps(&out[k]);
+
+        if (bias != nullptr) {
+            a = _mm256_add_ps(a, _mm256_loadu_ps(&bias[k]));
+        }
+
+        if (residual != nullptr) {
+            a = _mm256_add_ps(a, _mm256_loadu_ps(&residual[k]));
+        }
+
+        _mm256_storeu_ps(&out[k], avx2_act<Act>(a));
+    }
+
+    if (remainder > 0) {
+        __m256 a = _mm256_maskload_ps(&out[round_dim], mask_m256i);
+
+        if (bias != nullptr) {
+            a = _mm256_add_ps(a, _mm256_maskload_ps(&bias[round_dim], mask_m256i));
+        }
+
+        if (residual != nullptr) {
+            a = _mm256_add_ps(a, _mm256_maskload_ps(&residual[round_dim], mask_m256i));
+        }
+
+        _mm256_maskstore_ps(&out[round_dim], mask_m256i, avx2_act<Act>(a));
+    }
+}
+
+void avx2_bias_residual_act(float* out, const float* bias, const float* residual,
+                            const int len, ActiveType act) {
+    switch (act) {
+    case Active_relu:
+        avx2_bias_residual_act_impl<Active_relu>(out, bias, residual, len);
+        break;
+
+    case Active_sigmoid:
+        avx2_bias_residual_act_impl<Active_sigmoid>(out, bias, residual, len);
+        break;
+
+    case Active_tanh:
+        avx2_bias_residual_act_impl<Active_tanh>(out, bias, residual, len);
+        break;
+
+    case Active_identity:
+        avx2_bias_residual_act_impl<Active_identity>(out, bias, residual, len);
+        break;
+
+    default:
+        LOG(FATAL) << "avx2 epilogue does not support act " << act;
+    }
+}
+
 }
 }
 #endif
+#include "saber/funcs/impl/x86/saber_isa_end.h"
@@ -3,13 +3,21 @@
 
 
 #include <vector>
+#include "anakin_config.h"
+#include "saber/saber_types.h"
 #include "saber/funcs/impl/x86/kernel/jit_generator.h"
+
+//! the avx2 functions are built into this library, a fat library builds them on every host
+#if (defined(__AVX2__) and defined(__FMA__)) or defined(BUILD_X86_FAT_BIN)
+#define SABER_WITH_AVX2_FUNCS
+#endif
+
 namespace anakin {
 
 namespace saber {
 
 inline bool avx2_is_compiled(){
-#if defined(__AVX2__) and defined(__FMA__)
+#if defined(SABER_WITH_AVX2_FUNCS)
     return true;
 #else
     return false;
@@ -19,7 +27,7 @@ inline bool avx2_is_compiled(){
 inline bool avx2_can_used(){
     return avx2_is_compiled()&&jit::mayiuse(jit::avx2);
 };
-#if defined(__AVX2__) and defined(__FMA__)
+#if defined(SABER_WITH_AVX2_FUNCS)
 void avx2_vector_softmax_stride(const float* in, int col, int row, float* out);
 void avx2_vector_softmax(const float* in, int length, float* out);
 void avx2_vector_relu(const float* in, int length, float* out);
@@ -79,6 +87,16 @@ void avx2_vector_mul(const float* in_0,
                      const float* in_1,
                      const int len,
                      float* out);
+
+/* Epilogue of a gemm row, in one pass over the row
+ * y[i] = act(y[i] + bias[i] + residual[i])
+ * bias and residual may be null, act is relu, sigmoid, tanh or identity
+ * */
+void avx2_bias_residual_act(float* out,
+                            const float* bias,
+                            const float* residual,
+                            const int len,
+                            ActiveType act);
 #endif
 }
 }
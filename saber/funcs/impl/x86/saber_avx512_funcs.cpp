@@ -0,0 +1,44 @@
+#include "anakin_config.h"
+#include "saber/funcs/impl/x86/kernel/jit_generator.h"
+#include "saber/funcs/impl/x86/saber_isa_avx512_begin.h"
+#include "saber/funcs/impl/x86/saber_avx512_funcs.h"
+#if defined(__AVX512F__)
+#include "saber/funcs/impl/x86/saber_avx512_math.h"
+namespace anakin {
+
+namespace saber {
+
+//! not the Sigmoid<__m512> of saber_normal_activation.h, which would bring avx512 copies
+//! of the avx2 and sse activations the avx2 files define
+static inline __m512 avx512_sigmoid(const __m512 a) {
+    __m512 tmp = _mm512_sub_ps(_mm512_set1_ps(0.0f), a);
+    tmp = exp512_ps_fma(tmp);
+    tmp = _mm512_add_ps(_mm512_set1_ps(1.0f), tmp);
+    return _mm512_div_ps(_mm512_set1_ps(1.0f), tmp);
+}
+
+void avx512_vector_sigmoid(const float* in, int length, float* out) {
+    const int simd_length = 16;
+    int remainder = length % simd_length;
+    int round_length = length / simd_length * simd_length;
+
+#pragma omp parallel for schedule(static)
+
+    for (int i = 0; i < round_length; i += simd_length) {
+        __m512 temp = avx512_sigmoid(_mm512_loadu_ps(&in[i]));
+        _mm512_storeu_ps(&out[i], temp);
+    }
+
+    if (remainder > 0) {
+        __mmask16 vec_mask = 0xffff;
+        vec_mask = vec_mask >> (simd_length - remainder);
+        __m512 temp;
+        temp = _mm512_mask_loadu_ps(temp, vec_mask, &in[round_length]);
+        _mm512_mask_storeu_ps(&out[round_length], vec_mask, avx512_sigmoid(temp));
+    }
+};
+
+}
+}
+#endif
+#include "saber/funcs/impl/x86/saber_isa_end.h"
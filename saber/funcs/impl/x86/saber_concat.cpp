@@ -7,7 +7,7 @@ namespace saber {
 template <typename dtype>
 void concat_kernel(const int len, const dtype* src, dtype* dst) {
     if (dst != src) {
-        memcpy(dst, src, sizeof(dtype) * len);
+        memmove(dst, src, sizeof(dtype) * len);
     }
 }
 template <>
@@ -9,6 +9,7 @@
 #include "saber/funcs/impl/x86/kernel/jit_avx512_core_x8s8s32x_conv.h"
 #include "saber/funcs/impl/x86/kernel/jit_avx512_core_x8s8s32x_1x1_conv.h"
 #include "saber/funcs/impl/x86/gemm_x8s8s32x_conv.h"
+#include "saber/funcs/impl/x86/avx2_x8s8s32x_conv.h"
 #include "saber/funcs/impl/x86/saber_conv_1x1.h"
 #include "saber/funcs/impl/x86/kernel/jit_uni_dwconv.h"
 #include "saber/funcs/impl/x86/winograd.h"
@@ -244,8 +245,11 @@ init(const std::vector<Tensor<X86> *>& inputs,
     this->impl = new GemmX8S8S32XConv();
 #else
     bool is_dw = (group > 1 && group == oc && group == ic);
+    bool use_avx512 = mayiuse(avx512_core);
 
-    if (conv_1x1_flag && in_dtyp == AK_UINT8) {
+    if (!use_avx512 && mayiuse(avx2)) {
+        this->impl = new Avx2X8S8S32XConv();
+    } else if (conv_1x1_flag && in_dtyp == AK_UINT8) {
         this->impl = new JitAvx512x8s8s32xConv1x1();
     } else if ((is_dw || group == 1) && pad_w <= 14) {
         this->impl = new JitAvx512X8S8S32XConv();
@@ -1,9 +1,7 @@
 
 #include "saber/funcs/impl/x86/saber_cos_sim.h"
 #include "mkl.h"
-#if defined(__AVX2__) and defined(__FMA__)
 #include "saber/funcs/impl/x86/saber_avx2_funcs.h"
-#endif
 #include <cmath>
 
 namespace anakin{
@@ -45,29 +43,32 @@ SaberStatus SaberCosSim<X86, OpDtype>::dispatch(
     const OpDataType *input0_data = (const OpDataType*)inputs[0]->data();
     const OpDataType *input1_data = (const OpDataType*)inputs[1]->data();
     OpDataType *output_data = (OpDataType*)outputs[0]->mutable_data();
-#if defined(__AVX2__) and defined(__FMA__)
-   avx2_cos_sim(input0_data, input1_data, num, inner_size, param.epsilon, output_data);
-#else
-    for (size_t n = 0; n < num; n++) {
-        auto input0_square_sum = (OpDataType)0;
-        auto input1_square_sum = (OpDataType)0;
-        auto input01_prod_sum = (OpDataType)0;
+#if defined(SABER_WITH_AVX2_FUNCS)
+    if (avx2_can_used()) {
+        avx2_cos_sim(input0_data, input1_data, num, inner_size, param.epsilon, output_data);
+    } else
+#endif
+    {
+        for (size_t n = 0; n < num; n++) {
+            auto input0_square_sum = (OpDataType)0;
+            auto input1_square_sum = (OpDataType)0;
+            auto input01_prod_sum = (OpDataType)0;
 #pragma omp parallel for schedule(static) reduction(+:input0_square_sum, input1_square_sum, input01_prod_sum)
-        for (size_t i = 0; i < inner_size; i++) {
-            input0_square_sum += input0_data[i] * input0_data[i];
-            input1_square_sum += input1_data[i] * input1_data[i];
-            input01_prod_sum += input0_data[i] * input1_data[i];
+            for (size_t i = 0; i < inner_size; i++) {
+                input0_square_sum += input0_data[i] * input0_data[i];
+                input1_square_sum += input1_data[i] * input1_data[i];
+                input01_prod_sum += input0_data[i] * input1_data[i];
+            }
+            float bc = input0_square_sum * input1_square_sum;
+            if (bc < param.epsilon) {
+                output_data[n] = 0;
+            } else {
+                output_data[n] = input01_prod_sum / sqrt(bc);
+            }
+            input0_data += inner_size; 
+            input1_data += inner_size; 
         }
-        float bc = input0_square_sum * input1_square_sum;
-        if (bc < param.epsilon) {
-            output_data[n] = 0;
-        } else {
-            output_data[n] = input01_prod_sum / sqrt(bc);
-        }
-        input0_data += inner_size; 
-        input1_data += inner_size; 
     }
-#endif
 
     for (size_t i = 0; i < outputs.size(); i++) {
         outputs[i]->set_seq_offset(inputs[i]->get_seq_offset());
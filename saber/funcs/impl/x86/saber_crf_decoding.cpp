@@ -2,6 +2,7 @@
 #include "saber/saber_funcs_param.h"
 #include "saber/funcs/impl/x86/x86_utils.h"
 #include "saber/funcs/impl/x86/anakin_thread.h"
+#include <algorithm>
 #include <cstring>
 #include <limits>
 #include <cmath>
@@ -10,173 +11,184 @@
 namespace anakin {
 namespace saber {
 
-template <DataType OpDtype>
-SaberStatus SaberCrfDecoding<X86, OpDtype>::init(
-        const std::vector<Tensor<X86> *>& inputs,
-        std::vector<Tensor<X86> *>& outputs,
-        CrfDecodingParam<X86> &param, Context<X86> &ctx) {
-            
-    this->_ctx = &ctx;
-    return create(inputs, outputs, param, ctx);
-}
-
-template <DataType OpDtype>
-SaberStatus SaberCrfDecoding<X86, OpDtype>::create(
-        const std::vector<Tensor<X86> *>& inputs,
-        std::vector<Tensor<X86> *>& outputs,
-        CrfDecodingParam<X86> &param,
-        Context<X86> &ctx) {
-
-    CHECK_EQ(inputs[0]->get_dtype(), OpDtype) << "inputs data type should be same with OpDtype";
-    CHECK_EQ(outputs[0]->get_dtype(), OpDtype) << "outputs data type should be same with OpDtype";
-    
-    this->_ctx = &ctx;
-    _track.reshape(inputs[0]->valid_shape());
-
-#if defined(__AVX2__) and defined(__FMA__)
-    int tag_num = inputs[0]->channel();
-    _aligned_tag_num = (tag_num % 8) ? (tag_num / 8 + 1) * 8 : tag_num;
-    // get transposed transition weight
-    const OpDataType *transition_ptr = (const OpDataType*)param.transition_weight()->data();
-    Shape trans_shape({tag_num + 2, _aligned_tag_num, 1, 1}, Layout_NCHW);
-    _trans.reshape(trans_shape);
-    OpDataType *transition = (OpDataType*)_trans.mutable_data();
-    memcpy(transition, transition_ptr, sizeof(OpDataType) * tag_num);
-    memcpy(transition + _aligned_tag_num, transition_ptr + tag_num, sizeof(OpDataType) * tag_num);
-    for (int i = 0; i < tag_num; i++) {
-        for (int j = 0; j < tag_num; j++) {
-            transition[(i + 2) * _aligned_tag_num + j] = transition_ptr[(j + 2) * tag_num + i];
-        }
-        for (int j = tag_num; j < _aligned_tag_num; j++) {
-            transition[(i + 2) * _aligned_tag_num + j] = 0;
-        }
-    }
+namespace {
 
-    Shape emis_shape({inputs[0]->num(), _aligned_tag_num, 1, 1}, Layout_NCHW);
-    _emis.reshape(emis_shape);
-    _alpha.reshape(emis_shape);
+#if defined(__AVX512F__)
+const int CRF_VEC_SIZE = 16;
+#elif defined(__AVX2__)
+const int CRF_VEC_SIZE = 8;
 #else
-    _alpha.reshape(inputs[0]->valid_shape());
+const int CRF_VEC_SIZE = 1;
 #endif
-    return SaberSuccess;
-}
 
-template<typename Dtype>
-void decoding(Dtype* path, const Dtype* emission, const Dtype* transition,
-                        Dtype* alpha_value, int* track_value, int aligned_tag_num, int seq_len, int tag_num) {
-#if defined(__AVX2__) and defined(__FMA__)
-    const Dtype* x = emission;
-    const Dtype* w = transition;
-    const int state_trans_base_idx = 2;
-
-    {
-        __m256 *ww = (__m256*)w;
-        __m256 *xx = (__m256*)x;
-        __m256 *aa = (__m256*)alpha_value;
-        for (int i = 0; i < aligned_tag_num / 8; ++i) {
-            aa[i] = ww[i] + xx[i];
+const int CRF_STATE_TRANS_BASE_IDX = 2;
+
+/**
+ * one viterbi step for all destination tags:
+ *   alpha_cur[i] = max_j(alpha_pre[j] + w[j][i]) + x[i]
+ *   track[i]     = argmax_j(alpha_pre[j] + w[j][i])
+ * w rows are indexed by the source tag, so each step streams rows of w and
+ * keeps the running max and argmax of CRF_VEC_SIZE destination tags in registers.
+ */
+template <typename Dtype>
+inline void viterbi_step(const Dtype* alpha_pre, const Dtype* w, const Dtype* x,
+                         Dtype* alpha_cur, int16_t* track, int aligned_tag_num, int tag_num) {
+#if defined(__AVX512F__)
+    for (int i = 0; i < aligned_tag_num; i += 16) {
+        __m512 max_v = _mm512_set1_ps(-std::numeric_limits<Dtype>::max());
+        __m512 idx_v = _mm512_setzero_ps();
+        const Dtype* w_col = w + i;
+        for (int j = 0; j < tag_num; ++j) {
+            __m512 score = _mm512_add_ps(_mm512_set1_ps(alpha_pre[j]),
+                                         _mm512_loadu_ps(w_col + j * aligned_tag_num));
+            __mmask16 gt = _mm512_cmp_ps_mask(score, max_v, _CMP_GT_OQ);
+            max_v = _mm512_mask_mov_ps(max_v, gt, score);
+            idx_v = _mm512_mask_mov_ps(idx_v, gt, _mm512_set1_ps((float)j));
         }
+        int remain = tag_num - i;
+        __mmask16 ld_mask = remain >= 16 ? (__mmask16)0xffff : (__mmask16)((1 << remain) - 1);
+        __m512 emis = _mm512_maskz_loadu_ps(ld_mask, x + i);
+        _mm512_storeu_ps(alpha_cur + i, _mm512_add_ps(max_v, emis));
+        _mm256_storeu_si256((__m256i*)(track + i), _mm512_cvtepi32_epi16(_mm512_cvtps_epi32(idx_v)));
     }
-
-    int tail = ((aligned_tag_num == tag_num) ? 8 : tag_num % 8); 
-
-    for (int k = 1; k < seq_len; ++k) {
-        for (int i = 0; i < tag_num; ++i) {
-            Dtype max_score = -std::numeric_limits<Dtype>::max();
-            int max_j = 0;
-
-            __m256 *aa = (__m256*)(alpha_value + (k - 1) * aligned_tag_num);
-            __m256 *ww = (__m256*)(w + (i + state_trans_base_idx) * aligned_tag_num);
-            __m256 score_v;
-            Dtype *score = (Dtype*)(&score_v);
-            for (size_t j = 0; j < aligned_tag_num / 8 - 1; ++j) {
-                score_v = aa[j] + ww[j];
-                for (int m = 0; m < 8; m++) {
-                    if (score[m] > max_score) {
-                        max_score = score[m];
-                        max_j = j * 8 + m;
-                    }
-                }
-            }
-            int tail_idx = aligned_tag_num / 8 - 1;
-            score_v = aa[tail_idx] + ww[tail_idx];
-            for (int m = 0; m < tail; m++) {
-                if (score[m] > max_score) {
-                    max_score = score[m];
-                    max_j = tail_idx * 8 + m;
-                }
-            }
-
-            alpha_value[k * aligned_tag_num + i] = max_score + x[k * aligned_tag_num + i];
-            track_value[k * tag_num + i] = max_j;
+#elif defined(__AVX2__)
+    for (int i = 0; i < aligned_tag_num; i += 8) {
+        __m256 max_v = _mm256_set1_ps(-std::numeric_limits<Dtype>::max());
+        __m256 idx_v = _mm256_setzero_ps();
+        const Dtype* w_col = w + i;
+        for (int j = 0; j < tag_num; ++j) {
+            __m256 score = _mm256_add_ps(_mm256_set1_ps(alpha_pre[j]),
+                                         _mm256_loadu_ps(w_col + j * aligned_tag_num));
+            __m256 gt = _mm256_cmp_ps(score, max_v, _CMP_GT_OQ);
+            max_v = _mm256_blendv_ps(max_v, score, gt);
+            idx_v = _mm256_blendv_ps(idx_v, _mm256_set1_ps((float)j), gt);
         }
+        int remain = tag_num - i;
+        __m256i ld_mask = _mm256_cmpgt_epi32(_mm256_set1_epi32(remain),
+                                             _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7));
+        __m256 emis = _mm256_maskload_ps(x + i, ld_mask);
+        _mm256_storeu_ps(alpha_cur + i, _mm256_add_ps(max_v, emis));
+        __m256i idx_i32 = _mm256_cvtps_epi32(idx_v);
+        __m128i idx_i16 = _mm_packs_epi32(_mm256_castsi256_si128(idx_i32),
+                                          _mm256_extracti128_si256(idx_i32, 1));
+        _mm_storeu_si128((__m128i*)(track + i), idx_i16);
     }
-
-    Dtype max_score = -std::numeric_limits<Dtype>::max();
-    int max_i = 0;
-    __m256* aa = (__m256*)(alpha_value + (seq_len - 1) * aligned_tag_num);
-    __m256* ww = (__m256*)(w + aligned_tag_num);
-    __m256 score_v;
-    Dtype *score = (Dtype*)(&score_v);
-    for (size_t i = 0; i < aligned_tag_num / 8 - 1; ++i) {
-        score_v = aa[i] + ww[i];
-        for (int m = 0; m < 8; m++) {
-            if (score[m] > max_score) {
-                max_score = score[m];
-                max_i = i * 8 + m;
+#else
+    for (int i = 0; i < tag_num; ++i) {
+        alpha_cur[i] = -std::numeric_limits<Dtype>::max();
+        track[i] = 0;
+    }
+    for (int j = 0; j < tag_num; ++j) {
+        const Dtype* w_row = w + j * aligned_tag_num;
+        for (int i = 0; i < tag_num; ++i) {
+            Dtype score = alpha_pre[j] + w_row[i];
+            if (score > alpha_cur[i]) {
+                alpha_cur[i] = score;
+                track[i] = j;
             }
         }
     }
-    int tail_idx = aligned_tag_num / 8 - 1;
-    score_v = aa[tail_idx] + ww[tail_idx];
-    for (int m = 0; m < tail; m++) {
-        if (score[m] > max_score) {
-            max_score = score[m];
-            max_i = tail_idx * 8 + m;
-        }
+    for (int i = 0; i < tag_num; ++i) {
+        alpha_cur[i] += x[i];
     }
+#endif
+}
 
-    path[seq_len - 1] = max_i;
-    for (int k = seq_len - 1; k >= 1; --k) {
-        path[k - 1] = max_i = track_value[k * tag_num + max_i];
-    }
-#else
+template <typename Dtype>
+void decoding(Dtype* path, const Dtype* emission, const Dtype* transition,
+              Dtype* alpha_value, int16_t* track_value, int aligned_tag_num, int seq_len, int tag_num) {
     const Dtype* x = emission;
     const Dtype* w = transition;
-    const int state_trans_base_idx = 2;
+    Dtype* alpha_pre = alpha_value;
+    Dtype* alpha_cur = alpha_value + aligned_tag_num;
 
-    for (int i = 0; i < tag_num; ++i) alpha_value[i] = w[i] + x[i];
+    for (int i = 0; i < tag_num; ++i) {
+        alpha_pre[i] = w[i] + x[i];
+    }
+    for (int i = tag_num; i < aligned_tag_num; ++i) {
+        alpha_pre[i] = 0;
+    }
 
+    const Dtype* w_trans = w + CRF_STATE_TRANS_BASE_IDX * aligned_tag_num;
     for (int k = 1; k < seq_len; ++k) {
-        for (int i = 0; i < tag_num; ++i) {
-            Dtype max_score = -std::numeric_limits<Dtype>::max();
-            int max_j = 0;
-            for (size_t j = 0; j < tag_num; ++j) {
-                Dtype score = alpha_value[(k - 1) * tag_num + j] +
-                          w[(j + state_trans_base_idx) * tag_num + i];
-                if (score > max_score) {
-                    max_score = score;
-                    max_j = j;
-                }
-            }
-            alpha_value[k * tag_num + i] = max_score + x[k * tag_num + i];
-            track_value[k * tag_num + i] = max_j;
-        }
+        viterbi_step(alpha_pre, w_trans, x + k * tag_num, alpha_cur,
+                     track_value + k * aligned_tag_num, aligned_tag_num, tag_num);
+        std::swap(alpha_pre, alpha_cur);
     }
+
     Dtype max_score = -std::numeric_limits<Dtype>::max();
     int max_i = 0;
-    for (size_t i = 0; i < tag_num; ++i) {
-        Dtype score = alpha_value[(seq_len - 1) * tag_num + i] + w[tag_num + i];
+    for (int i = 0; i < tag_num; ++i) {
+        Dtype score = alpha_pre[i] + w[aligned_tag_num + i];
         if (score > max_score) {
             max_score = score;
             max_i = i;
         }
     }
+
     path[seq_len - 1] = max_i;
     for (int k = seq_len - 1; k >= 1; --k) {
-        path[k - 1] = max_i = track_value[k * tag_num + max_i];
+        path[k - 1] = max_i = track_value[k * aligned_tag_num + max_i];
     }
+}
+
+} // namespace
+
+template <DataType OpDtype>
+SaberStatus SaberCrfDecoding<X86, OpDtype>::init(
+        const std::vector<Tensor<X86> *>& inputs,
+        std::vector<Tensor<X86> *>& outputs,
+        CrfDecodingParam<X86> &param, Context<X86> &ctx) {
+
+    this->_ctx = &ctx;
+    return create(inputs, outputs, param, ctx);
+}
+
+template <DataType OpDtype>
+SaberStatus SaberCrfDecoding<X86, OpDtype>::create(
+        const std::vector<Tensor<X86> *>& inputs,
+        std::vector<Tensor<X86> *>& outputs,
+        CrfDecodingParam<X86> &param,
+        Context<X86> &ctx) {
+
+    CHECK_EQ(inputs[0]->get_dtype(), OpDtype) << "inputs data type should be same with OpDtype";
+    CHECK_EQ(outputs[0]->get_dtype(), OpDtype) << "outputs data type should be same with OpDtype";
+
+    this->_ctx = &ctx;
+    int tag_num = inputs[0]->channel();
+    CHECK_LE(tag_num, std::numeric_limits<int16_t>::max()) << "tag num exceeds int16 backpointer range";
+    _aligned_tag_num = (tag_num + CRF_VEC_SIZE - 1) / CRF_VEC_SIZE * CRF_VEC_SIZE;
+    _thread_num = anakin_get_max_threads();
+
+    // repack transition weight to [from_tag][to_tag] rows padded to the vector width
+    const OpDataType *transition_ptr = (const OpDataType*)param.transition_weight()->data();
+    Shape trans_shape({tag_num + CRF_STATE_TRANS_BASE_IDX, _aligned_tag_num, 1, 1}, Layout_NCHW);
+    _trans.reshape(trans_shape);
+    OpDataType *transition = (OpDataType*)_trans.mutable_data();
+    memset(transition, 0, sizeof(OpDataType) * trans_shape.count());
+    memcpy(transition, transition_ptr, sizeof(OpDataType) * tag_num);
+    memcpy(transition + _aligned_tag_num, transition_ptr + tag_num, sizeof(OpDataType) * tag_num);
+#if defined(__AVX2__)
+    // the former AVX2 kernel consumed 8-aligned transition weights as [to_tag][from_tag],
+    // keep that layout contract for models exported against it
+    bool weight_transposed = (tag_num % 8 == 0);
+#else
+    bool weight_transposed = false;
 #endif
+    for (int j = 0; j < tag_num; j++) {
+        OpDataType* to = transition + (j + CRF_STATE_TRANS_BASE_IDX) * _aligned_tag_num;
+        for (int i = 0; i < tag_num; i++) {
+            to[i] = weight_transposed ?
+                    transition_ptr[(i + CRF_STATE_TRANS_BASE_IDX) * tag_num + j] :
+                    transition_ptr[(j + CRF_STATE_TRANS_BASE_IDX) * tag_num + i];
+        }
+    }
+
+    Shape alpha_shape({_thread_num * 2, _aligned_tag_num, 1, 1}, Layout_NCHW);
+    _alpha.reshape(alpha_shape);
+    Shape track_shape({inputs[0]->num(), _aligned_tag_num, 1, 1}, Layout_NCHW);
+    _track.re_alloc(track_shape, AK_INT16);
+    return SaberSuccess;
 }
 
 template <DataType OpDtype>
@@ -185,50 +197,38 @@ SaberStatus SaberCrfDecoding<X86, OpDtype>::dispatch(
         std::vector<Tensor<X86> *>& outputs,
         CrfDecodingParam<X86> &param) {
 
-    std::vector<std::vector<int>> seq_offset = inputs[0]->get_seq_offset();
+    std::vector<int> seq_offset = inputs[0]->get_seq_offset()[0];
+    int tag_num = inputs[0]->channel();
+    if (_track.valid_shape()[0] < inputs[0]->num()) {
+        _track.re_alloc(Shape({inputs[0]->num(), _aligned_tag_num, 1, 1}, Layout_NCHW), AK_INT16);
+    }
 
     const OpDataType *emission_ptr = (const OpDataType*)inputs[0]->data();
-    int tag_num = inputs[0]->channel();
-    const OpDataType *transition_ptr = (const OpDataType*)param.transition_weight()->data();
+    const OpDataType *transition_ptr = (const OpDataType*)_trans.data();
+    OpDataType *decoded_path = (OpDataType*) outputs[0]->mutable_data();
+    OpDataType *alpha_ptr = (OpDataType*)_alpha.mutable_data();
+    int16_t *track_ptr = (int16_t*)_track.mutable_data();
     int slice_size = inputs[0]->channel() * inputs[0]->height() * inputs[0]->width();
-   
-#if defined(__AVX2__) and defined(__FMA__)
-    if (tag_num % 8) {
-        transition_ptr = (OpDataType*)_trans.data();
-
-        // align emission to AVX2 register width
-        OpDataType *emission = (OpDataType*)_emis.mutable_data();
-        for (int i = 0; i < inputs[0]->num(); i++) {
-          OpDataType* to = emission + i * _aligned_tag_num;
-          const OpDataType* from = emission_ptr + i * tag_num;
-          memcpy(to, from, tag_num * sizeof(OpDataType));
-          for (int j = tag_num; j < _aligned_tag_num; j++) {
-              to[j] = 0;
-          }
-        }
-        emission_ptr = emission;
-        slice_size = _aligned_tag_num;
+    int seq_num = seq_offset.size() - 1;
+    if (seq_num <= 0) {
+        return SaberSuccess;
     }
-#endif
-    OpDataType *decoded_path = (OpDataType*) outputs[0]->mutable_data();
-    int seq_num = seq_offset[0].size() - 1;
-    int nthreads = anakin_get_max_threads();
+    int nthreads = std::min(_thread_num, seq_num);
 
-    if (nthreads > seq_num) {
-        nthreads = seq_num;
-    }
-//#pragma omp parallel for num_threads(nthreads) if(seq_num > 1)
+    // sequences are independent, each thread decodes into its own alpha rows
+    // and into the backpointer rows of the sequence it owns
+#pragma omp parallel for schedule(dynamic) num_threads(nthreads) if (nthreads > 1)
     for (int i = 0; i < seq_num; ++i) {
-        int seq_len = seq_offset[0][i+1] - seq_offset[0][i];
-       // LOG(INFO) << "slice_size: " << slice_size << ", seq_num: " << seq_num << ", seq_len: " << seq_len;
-        decoding<OpDataType>(decoded_path, emission_ptr, transition_ptr,
-                 (OpDataType*)_alpha.mutable_data(), (int*)_track.mutable_data(),
-                 _aligned_tag_num, seq_len, tag_num);
-
-        decoded_path += seq_len;
-        emission_ptr += slice_size * seq_len;
+        int seq_start = seq_offset[i];
+        int seq_len = seq_offset[i + 1] - seq_start;
+        if (seq_len <= 0) {
+            continue;
+        }
+        decoding<OpDataType>(decoded_path + seq_start, emission_ptr + seq_start * slice_size,
+                             transition_ptr, alpha_ptr + anakin_get_thread_num() * 2 * _aligned_tag_num,
+                             track_ptr + seq_start * _aligned_tag_num,
+                             _aligned_tag_num, seq_len, tag_num);
     }
-    //LOG(INFO) << "dispatch success ";
     return SaberSuccess;
 }
 
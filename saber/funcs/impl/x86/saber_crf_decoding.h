@@ -47,11 +47,14 @@ public:
                                  std::vector<Tensor<X86> *>& outputs,
                                  CrfDecodingParam<X86> &param) override;
 private:
+    // per-thread rolling alpha rows, two rows of _aligned_tag_num each
     Tensor<X86> _alpha;
+    // int16 backpointers, one row of _aligned_tag_num per time step
     Tensor<X86> _track;
+    // transition weight repacked as [from_tag][to_tag] rows padded to the vector width
     Tensor<X86> _trans;
-    Tensor<X86> _emis;
-    int _aligned_tag_num;
+    int _aligned_tag_num{0};
+    int _thread_num{1};
 };
 }
 }
@@ -1,5 +1,6 @@
 #include "saber/funcs/impl/x86/saber_detection_output.h"
 #include "saber/funcs/impl/detection_helper.h"
+#include "saber/funcs/impl/x86/nms_helper.h"
 namespace anakin{
 
 namespace saber{
@@ -102,7 +103,7 @@ SaberStatus SaberDetectionOutput<X86, OpDtype>::dispatch(const std::vector<Tenso
     }
 
     std::vector<float> result;
-    nms_detect(bbox_data_cpu, conf_data_cpu, result, priors, this->_num_classes, param.background_id, \
+    nms_detect_x86(bbox_data_cpu, conf_data_cpu, result, priors, this->_num_classes, param.background_id, \
         param.keep_top_k, param.nms_top_k, param.conf_thresh, param.nms_thresh, param.nms_eta, _shared_loc);
 
     if (result.size() == 0) {
@@ -1,6 +1,7 @@
 
 #include "saber/funcs/impl/x86/saber_embedding.h"
 #include "saber/funcs/impl/x86/x86_utils.h"
+#include "saber/funcs/impl/x86/half_convert_helper.h"
 
 
 namespace anakin{
@@ -49,8 +50,37 @@ SaberStatus SaberEmbedding<X86, OpDtype>::dispatch(
     //outputs = weights[inputs[j]].
     const float *in_data =  (const float*)inputs[0]->data();
     DataType_out *out_data =  (DataType_out*)outputs[0]->mutable_data();
-    DataType_out *weight_data = (DataType_out*)param.weight()->data();
     int emb_dim = param.emb_dim;
+    // paged tables read the rows from file through the row cache
+    PagedRowTable* paged_table = param.paged_table.get();
+    if (paged_table != nullptr) {
+        CHECK_GE(paged_table->rows(), param.word_num);
+        CHECK_EQ(paged_table->row_size(), emb_dim);
+        CHECK(is_half_dtype(paged_table->dtype()) || paged_table->dtype() == OpDtype)
+                << "paged embedding table dtype does not match the op";
+    }
+    const Tensor<X86>* weight = paged_table == nullptr ? param.weight() : nullptr;
+    const DataType_out* weight_data = weight == nullptr ? nullptr
+            : static_cast<const DataType_out*>(weight->data());
+    // fp16 / bf16 tables are expanded row by row on lookup
+    const DataType weight_dtype = paged_table != nullptr ? paged_table->dtype() : weight->get_dtype();
+    const bool half_weights = is_half_dtype(weight_dtype);
+    const uint16_t* half_weight_data = reinterpret_cast<const uint16_t*>(weight_data);
+    std::vector<uint16_t> half_row(half_weights && paged_table != nullptr ? emb_dim : 0);
+    auto copy_row = [&](DataType_out* dst, int index) {
+        if (paged_table != nullptr) {
+            if (half_weights) {
+                paged_table->copy_row(index, half_row.data());
+                half_to_fp32(half_row.data(), (float*)dst, emb_dim, weight_dtype);
+            } else {
+                paged_table->copy_row(index, dst);
+            }
+        } else if (half_weights) {
+            half_to_fp32(half_weight_data + (size_t)index * emb_dim, (float*)dst, emb_dim, weight_dtype);
+        } else {
+            memcpy(dst, weight_data + (size_t)index * emb_dim, sizeof(DataType_out) * emb_dim);
+        }
+    };
    
     /*positive direct*/
     for (int i = 0; i < num_word; i++) {
@@ -59,7 +89,7 @@ SaberStatus SaberEmbedding<X86, OpDtype>::dispatch(
         } else {
             CHECK_GE(in_data[i], 0);
             CHECK_LT(in_data[i], param.word_num);
-            memcpy(out_data + i * emb_dim, weight_data + int(in_data[i]) * emb_dim, sizeof(DataType_out) * emb_dim);
+            copy_row(out_data + i * emb_dim, int(in_data[i]));
         }
     }
 
@@ -79,7 +109,7 @@ SaberStatus SaberEmbedding<X86, OpDtype>::dispatch(
                 } else {
                     CHECK_GE(index, 0);
                     CHECK_LT(index, param.word_num);
-                    memcpy(out_data + dst_index * emb_dim, weight_data + int(index) * emb_dim, sizeof(DataType_out) * emb_dim);
+                    copy_row(out_data + dst_index * emb_dim, index);
                 }
             }
         }
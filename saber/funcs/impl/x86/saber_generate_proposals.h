@@ -49,9 +49,6 @@ public:
 private:
     Tensor<X86> _bbox_deltas_swap;
     Tensor<X86> _scores_swap;
-    Tensor<X86> _proposals;
-    Tensor<X86> _proposals_sel;
-    Tensor<X86> _scores_sel;
 
 };
 
@@ -211,8 +211,14 @@ batch_s_aligned(const std::vector<OpTensor*>& inputs,
     /////////////////////////////////////////////////
     //wx
 
-    gemm(false, false, seqsum, 3 * _aligned_hidden_size, _word_size, 1.f, inner_x, weight_w, 0.f,
-         temp_wx);
+    if (param.dynamic_quant) {
+        _wx_gemm_int8.dispatch(seqsum, inner_x, temp_wx);
+    } else if (_half_weights) {
+        _wx_gemm_half.dispatch(seqsum, inner_x, _word_size, temp_wx, 3 * _aligned_hidden_size);
+    } else {
+        gemm(false, false, seqsum, 3 * _aligned_hidden_size, _word_size, 1.f, inner_x, weight_w, 0.f,
+             temp_wx);
+    }
 
 
     int o_offset = 0;
@@ -252,9 +258,14 @@ batch_s_aligned(const std::vector<OpTensor*>& inputs,
 
         if(param.formula==GRU_ORIGIN) {
             //wh
-            gemm(false, false, emit_word_length, 2 * _aligned_hidden_size, _aligned_hidden_size, 1.0, hin,
-                 weight_h ,
-                 0.f, temp_wh);
+            if (_half_weights) {
+                _wh_gemm_half.dispatch(emit_word_length, hin, _aligned_hidden_size, temp_wh,
+                                       2 * _aligned_hidden_size);
+            } else {
+                gemm(false, false, emit_word_length, 2 * _aligned_hidden_size, _aligned_hidden_size, 1.0, hin,
+                     weight_h ,
+                     0.f, temp_wh);
+            }
 
 
             //#pragma omp parallel for
@@ -262,17 +273,27 @@ batch_s_aligned(const std::vector<OpTensor*>& inputs,
                                     _aligned_hidden_size, r_offset, gate_act);
 
 
-            gemm(false, false, emit_word_length, _aligned_hidden_size, _aligned_hidden_size, 1.0, hout,
-                 static_cast<const OpDataType*>(_aligned_weights_h2h_o.data()), 0.f, temp_whr);
+            if (_half_weights) {
+                _wh_o_gemm_half.dispatch(emit_word_length, hout, _aligned_hidden_size, temp_whr,
+                                         _aligned_hidden_size);
+            } else {
+                gemm(false, false, emit_word_length, _aligned_hidden_size, _aligned_hidden_size, 1.0, hout,
+                     static_cast<const OpDataType*>(_aligned_weights_h2h_o.data()), 0.f, temp_whr);
+            }
 
             cal_gru_forgate_output_gate<BIT>(hout, hin, b_z, b_o, temp_wx, temp_whr, temp_wh, emit_word_id_start,
                                              emit_word_id_end,
                                              _aligned_hidden_size, z_offset, o_offset, gate_act, hid_act);
         }else if(param.formula==GRU_CUDNN){
 
-            gemm(false, false, emit_word_length, 3 * _aligned_hidden_size, _aligned_hidden_size, 1.0, hin,
-                 weight_h,
-                 0.f, temp_wh);
+            if (_half_weights) {
+                _wh_gemm_half.dispatch(emit_word_length, hin, _aligned_hidden_size, temp_wh,
+                                       3 * _aligned_hidden_size);
+            } else {
+                gemm(false, false, emit_word_length, 3 * _aligned_hidden_size, _aligned_hidden_size, 1.0, hin,
+                     weight_h,
+                     0.f, temp_wh);
+            }
 
             cal_gru_cudnn<BIT>(hout,hin,b_o,b_r,b_z,temp_wx,temp_wh,emit_word_id_start,emit_word_id_end,
                                _aligned_hidden_size,o_offset,r_offset,z_offset);
@@ -4,6 +4,9 @@
 #define ANAKIN_SABER_FUNCS_IMPL_X86_SABER_GRU_H
 #include "saber/funcs/impl/impl_gru.h"
 #include "saber/funcs/impl/x86/x86_utils.h"
+#include "saber/funcs/impl/x86/mkl_packed_int8_gemm.h"
+#include "saber/funcs/impl/x86/packed_half_gemm.h"
+#include "saber/funcs/impl/x86/half_convert_helper.h"
 
 #if defined(__AVX512F__)
 #include <immintrin.h>
@@ -42,110 +45,67 @@ public:
 //        CHECK_EQ(param.formula, GRU_ORIGIN) << "only support gru_origin now";
         CHECK_NOTNULL(param.weight())<<"weights can not be null";
         CHECK_NOTNULL(param.bias())<<"bias can not be null";
-        if (param.formula == GRU_ORIGIN ) {
-            //FIXME:aligned should be determine by framework
-            int aligned_byte = sizeof(SABER_X86_TYPE);
-            int c_size = aligned_byte / sizeof(OpDataType);
-
-            _hidden_size = param.bias()->valid_size() / 3;
-            int weights_bias_size = _hidden_size * 3;
-            int weights_h2h_size = _hidden_size * _hidden_size * 3;
-            int weights_i2h_size = param.weight()->valid_size() - weights_h2h_size;
-            _word_size = weights_i2h_size / _hidden_size / 3;
-
-            _aligned_size = c_size;
-            _aligned_word_size = utils::round_up(_word_size, c_size);
-            _aligned_hidden_size = utils::round_up(_hidden_size, c_size);
-
-            Shape weights_i2h_shape({1, _word_size, 3, _aligned_hidden_size},Layout_NCHW);
-            Shape weights_h2h_shape({1, _aligned_hidden_size, 2, _aligned_hidden_size},Layout_NCHW);
-            Shape weights_h2h_o_shape({1, _aligned_hidden_size, 1, _aligned_hidden_size},Layout_NCHW);
-            Shape weights_bias_shape({1, 1, 3, _aligned_hidden_size},Layout_NCHW);
-            utils::try_expand_clean_tensor(_aligned_weights_i2h,weights_i2h_shape);
-            utils::try_expand_clean_tensor(_aligned_weights_h2h,weights_h2h_shape);
-            utils::try_expand_clean_tensor(_aligned_weights_h2h_o,weights_h2h_o_shape);
-            utils::try_expand_clean_tensor(_aligned_weights_bias,weights_bias_shape);
-
-            utils::AlignedUtils aligned_tool;
-            aligned_tool.aligned_last_dim(static_cast<const OpDataType*>(param.weight()->data()), ( OpDataType*)_aligned_weights_i2h.mutable_data(),
-                                          weights_i2h_size, _hidden_size, _aligned_hidden_size);
-
-            aligned_tool.aligned_last_dim(static_cast<const OpDataType*>(param.weight()->data()) + weights_i2h_size+_hidden_size*_hidden_size,
-                                          (OpDataType*) _aligned_weights_h2h.mutable_data(),
-                                          weights_h2h_size-_hidden_size*_hidden_size, _hidden_size, _aligned_hidden_size);
-
-            aligned_tool.aligned_last_dim(static_cast<const OpDataType*>(param.weight()->data()) + weights_i2h_size,
-                                          (OpDataType*) _aligned_weights_h2h_o.mutable_data(),
-                                          _hidden_size*_hidden_size, _hidden_size, _aligned_hidden_size);
-
-            aligned_tool.aligned_last_dim(static_cast<const OpDataType*>(param.bias()->data()), (OpDataType*)_aligned_weights_bias.mutable_data(),
-                                          weights_bias_size, _hidden_size, _aligned_hidden_size);
-
-
-        } else if (param.formula == GRU_CUDNN) {
-            int aligned_byte = sizeof(SABER_X86_TYPE);
-            int c_size = aligned_byte / sizeof(OpDataType);
-
-            _hidden_size = param.bias()->valid_size() / 3;
-            int weights_bias_size = _hidden_size * 3;
-            int weights_h2h_size = _hidden_size * _hidden_size * 3;
-            int weights_i2h_size = param.weight()->valid_size() - weights_h2h_size;
-            _word_size = weights_i2h_size / _hidden_size / 3;
-
-            _aligned_size = c_size;
-            _aligned_word_size = utils::round_up(_word_size, c_size);
-            _aligned_hidden_size = utils::round_up(_hidden_size, c_size);
-
-            Shape weights_i2h_shape({1, _word_size, 3, _aligned_hidden_size},Layout_NCHW);
-            Shape weights_h2h_shape({1, _aligned_hidden_size, 3, _aligned_hidden_size},Layout_NCHW);
-            Shape weights_bias_shape({1, 1, 3, _aligned_hidden_size},Layout_NCHW);
-            utils::try_expand_clean_tensor(_aligned_weights_i2h,weights_i2h_shape);
-            utils::try_expand_clean_tensor(_aligned_weights_h2h,weights_h2h_shape);
-            utils::try_expand_clean_tensor(_aligned_weights_bias,weights_bias_shape);
-
-            OpTensor temp_tensor;
-            utils::try_expand_tensor(temp_tensor,weights_h2h_size);
-            OpTensor temp_tensor_origin;
-            utils::try_expand_tensor(temp_tensor_origin,weights_h2h_size);
-
-            float* temp_tensor_ptr= static_cast<float*>(temp_tensor_origin.mutable_data());
-            memcpy(temp_tensor_ptr, static_cast<const OpDataType*>(param.weight()->data()) + weights_i2h_size,
-                   sizeof(OpDataType) * _hidden_size*_hidden_size);
-
-            float* rz_temp_tensor_ptr=temp_tensor_ptr+_hidden_size*_hidden_size;
-            const float* rz_weights_tensor_ptr=static_cast<const float*>(param.weight()->data()) + weights_i2h_size+_hidden_size*_hidden_size;
-            for(int row=0;row<_hidden_size;row++){
-                for(int block=0;block<2;block++) {
-                    int block_offset=block*_hidden_size;
-                    for (int cow = 0; cow < _hidden_size; cow++) {
-                        rz_temp_tensor_ptr[block*_hidden_size*_hidden_size+row*_hidden_size+cow]=rz_weights_tensor_ptr[row*(2*_hidden_size)+cow+block_offset];
-                    }
-                }
-            }
-
-            float* orz_temp_tensor_ptr=temp_tensor_ptr;
-            float* orz_weights_tensor_ptr=static_cast<float*>(temp_tensor.mutable_data());
-            for(int row=0;row<_hidden_size;row++){
-                for(int block=0;block<3;block++) {
-                    int block_offset=block*_hidden_size;
-                    for (int cow = 0; cow < _hidden_size; cow++) {
-                        orz_weights_tensor_ptr[row*(3*_hidden_size)+cow+block_offset]=orz_temp_tensor_ptr[block*_hidden_size*_hidden_size+row*_hidden_size+cow];
-                    }
-                }
+        const DataType weight_dtype = param.weight()->get_dtype();
+        _half_weights = is_half_dtype(weight_dtype);
+
+        //FIXME:aligned should be determine by framework
+        int aligned_byte = sizeof(SABER_X86_TYPE);
+        int c_size = aligned_byte / sizeof(OpDataType);
+
+        _hidden_size = param.bias()->valid_size() / 3;
+        int weights_bias_size = _hidden_size * 3;
+        int weights_h2h_size = _hidden_size * _hidden_size * 3;
+        int weights_i2h_size = param.weight()->valid_size() - weights_h2h_size;
+        _word_size = weights_i2h_size / _hidden_size / 3;
+
+        _aligned_size = c_size;
+        _aligned_word_size = utils::round_up(_word_size, c_size);
+        _aligned_hidden_size = utils::round_up(_hidden_size, c_size);
+
+        Shape weights_bias_shape({1, 1, 3, _aligned_hidden_size},Layout_NCHW);
+        utils::try_expand_clean_tensor(_aligned_weights_bias,weights_bias_shape);
+        utils::AlignedUtils aligned_tool;
+        aligned_tool.aligned_last_dim(static_cast<const OpDataType*>(param.bias()->data()), (OpDataType*)_aligned_weights_bias.mutable_data(),
+                                      weights_bias_size, _hidden_size, _aligned_hidden_size);
+
+        if (!_half_weights) {
+            align_weights(static_cast<const OpDataType*>(param.weight()->data()), param,
+                          _aligned_weights_i2h, _aligned_weights_h2h, _aligned_weights_h2h_o);
+
+            if (param.dynamic_quant) {
+                _wx_gemm_int8.init(false, false, inputs[0]->num(), 3 * _aligned_hidden_size, _word_size,
+                                   _aligned_weights_i2h, 1.f, true);
             }
 
-            utils::AlignedUtils aligned_tool;
-            aligned_tool.aligned_last_dim((const OpDataType*)param.weight()->data(), ( OpDataType*)_aligned_weights_i2h.mutable_data(),
-                                          weights_i2h_size, _hidden_size, _aligned_hidden_size);
-
-            aligned_tool.aligned_last_dim((const OpDataType*)temp_tensor.data(),
-                                          (OpDataType*) _aligned_weights_h2h.mutable_data(),
-                                          weights_h2h_size, _hidden_size, _aligned_hidden_size);
+            return create(inputs, outputs, param, ctx);
+        }
 
-            aligned_tool.aligned_last_dim((const OpDataType*)param.bias()->data(), (OpDataType*)_aligned_weights_bias.mutable_data(),
-                                          weights_bias_size, _hidden_size, _aligned_hidden_size);
+        // fp16 / bf16 weights are aligned as 16 bit values and packed as they are,
+        // the aligned copies are dropped once packed
+        OpTensor half_i2h(weight_dtype);
+        OpTensor half_h2h(weight_dtype);
+        OpTensor half_h2h_o(weight_dtype);
+        align_weights(static_cast<const uint16_t*>(param.weight()->data()), param,
+                      half_i2h, half_h2h, half_h2h_o);
+
+        if (param.dynamic_quant) {
+            OpTensor i2h_fp32(half_i2h.valid_shape(), AK_FLOAT);
+            half_to_fp32(static_cast<const uint16_t*>(half_i2h.data()),
+                         static_cast<float*>(i2h_fp32.mutable_data()), half_i2h.valid_size(), weight_dtype);
+            _wx_gemm_int8.init(false, false, inputs[0]->num(), 3 * _aligned_hidden_size, _word_size,
+                               i2h_fp32, 1.f, true);
+        } else {
+            _wx_gemm_half.init(false, 3 * _aligned_hidden_size, _word_size, half_i2h.data(),
+                               3 * _aligned_hidden_size, weight_dtype, weight_dtype);
+        }
 
+        // only the first _hidden_size rows of the aligned h2h weights are real
+        int wh_n = param.formula == GRU_ORIGIN ? 2 * _aligned_hidden_size : 3 * _aligned_hidden_size;
+        _wh_gemm_half.init(false, wh_n, _hidden_size, half_h2h.data(), wh_n, weight_dtype, weight_dtype);
 
+        if (param.formula == GRU_ORIGIN) {
+            _wh_o_gemm_half.init(false, _aligned_hidden_size, _hidden_size, half_h2h_o.data(),
+                                 _aligned_hidden_size, weight_dtype, weight_dtype);
         }
 
         return create(inputs, outputs, param, ctx);
@@ -188,6 +148,84 @@ private:
     OpTensor _temp_out;
     OpTensor _temp_h_init;
 
+    //! int8 input to hidden gemm of dynamic quant
+    PackedMKLInt8Gemm _wx_gemm_int8;
+    //! gemms on fp16 / bf16 weights
+    bool _half_weights{false};
+    PackedHalfGemm _wx_gemm_half;
+    PackedHalfGemm _wh_gemm_half;
+    PackedHalfGemm _wh_o_gemm_half;
+
+    /**
+     * \brief align the last dim of the weights to _aligned_hidden_size, the cudnn h2h gates
+     * are reordered first. Dtype is float, or uint16_t for fp16 / bf16 weights copied as bits,
+     * the tensors keep the dtype they are created with.
+     */
+    template <typename Dtype>
+    void align_weights(const Dtype* weight_data, GruParam<X86>& param,
+                       OpTensor& i2h, OpTensor& h2h, OpTensor& h2h_o) {
+        int weights_h2h_size = _hidden_size * _hidden_size * 3;
+        int weights_i2h_size = param.weight()->valid_size() - weights_h2h_size;
+        utils::AlignedUtils aligned_tool;
+        Shape weights_i2h_shape({1, _word_size, 3, _aligned_hidden_size},Layout_NCHW);
+        utils::try_expand_clean_tensor(i2h,weights_i2h_shape);
+        aligned_tool.aligned_last_dim(weight_data, (Dtype*)i2h.mutable_data(),
+                                      weights_i2h_size, _hidden_size, _aligned_hidden_size);
+
+        if (param.formula == GRU_ORIGIN) {
+            Shape weights_h2h_shape({1, _aligned_hidden_size, 2, _aligned_hidden_size},Layout_NCHW);
+            Shape weights_h2h_o_shape({1, _aligned_hidden_size, 1, _aligned_hidden_size},Layout_NCHW);
+            utils::try_expand_clean_tensor(h2h,weights_h2h_shape);
+            utils::try_expand_clean_tensor(h2h_o,weights_h2h_o_shape);
+
+            aligned_tool.aligned_last_dim(weight_data + weights_i2h_size+_hidden_size*_hidden_size,
+                                          (Dtype*) h2h.mutable_data(),
+                                          weights_h2h_size-_hidden_size*_hidden_size, _hidden_size, _aligned_hidden_size);
+
+            aligned_tool.aligned_last_dim(weight_data + weights_i2h_size,
+                                          (Dtype*) h2h_o.mutable_data(),
+                                          _hidden_size*_hidden_size, _hidden_size, _aligned_hidden_size);
+        } else if (param.formula == GRU_CUDNN) {
+            Shape weights_h2h_shape({1, _aligned_hidden_size, 3, _aligned_hidden_size},Layout_NCHW);
+            utils::try_expand_clean_tensor(h2h,weights_h2h_shape);
+
+            OpTensor temp_tensor(h2h.get_dtype());
+            utils::try_expand_tensor(temp_tensor,weights_h2h_size);
+            OpTensor temp_tensor_origin(h2h.get_dtype());
+            utils::try_expand_tensor(temp_tensor_origin,weights_h2h_size);
+
+            Dtype* temp_tensor_ptr= static_cast<Dtype*>(temp_tensor_origin.mutable_data());
+            memcpy(temp_tensor_ptr, weight_data + weights_i2h_size,
+                   sizeof(Dtype) * _hidden_size*_hidden_size);
+
+            Dtype* rz_temp_tensor_ptr=temp_tensor_ptr+_hidden_size*_hidden_size;
+            const Dtype* rz_weights_tensor_ptr=weight_data + weights_i2h_size+_hidden_size*_hidden_size;
+            for(int row=0;row<_hidden_size;row++){
+                for(int block=0;block<2;block++) {
+                    int block_offset=block*_hidden_size;
+                    for (int cow = 0; cow < _hidden_size; cow++) {
+                        rz_temp_tensor_ptr[block*_hidden_size*_hidden_size+row*_hidden_size+cow]=rz_weights_tensor_ptr[row*(2*_hidden_size)+cow+block_offset];
+                    }
+                }
+            }
+
+            Dtype* orz_temp_tensor_ptr=temp_tensor_ptr;
+            Dtype* orz_weights_tensor_ptr=static_cast<Dtype*>(temp_tensor.mutable_data());
+            for(int row=0;row<_hidden_size;row++){
+                for(int block=0;block<3;block++) {
+                    int block_offset=block*_hidden_size;
+                    for (int cow = 0; cow < _hidden_size; cow++) {
+                        orz_weights_tensor_ptr[row*(3*_hidden_size)+cow+block_offset]=orz_temp_tensor_ptr[block*_hidden_size*_hidden_size+row*_hidden_size+cow];
+                    }
+                }
+            }
+
+            aligned_tool.aligned_last_dim((const Dtype*)temp_tensor.data(),
+                                          (Dtype*) h2h.mutable_data(),
+                                          weights_h2h_size, _hidden_size, _aligned_hidden_size);
+        }
+    }
+
     template <typename BIT>
     SaberStatus batch_s_aligned(\
                                 const std::vector<OpTensor*>& inputs,
@@ -0,0 +1,22 @@
+//! opens the avx2 part of an isa file, closed by saber_isa_end.h.
+//! a fat library builds every file for the base isa, the headers an isa file shares with the
+//! base files are included before this one, so their inline functions and the special members
+//! gcc defines at the end of the file keep the base isa wherever the linker picks them from.
+//! only the functions declared and defined after this header are built for avx2.
+//! there is no include guard, each isa file includes it once.
+#include "anakin_config.h"
+
+#if defined(BUILD_X86_FAT_BIN)
+#include <immintrin.h>
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+//! gcc does not define the isa macros for a target pragma, the isa headers test them
+#if !defined(__AVX2__)
+#define __AVX2__ 1
+#define SABER_ISA_DEFINED_AVX2
+#endif
+#if !defined(__FMA__)
+#define __FMA__ 1
+#define SABER_ISA_DEFINED_FMA
+#endif
+#endif
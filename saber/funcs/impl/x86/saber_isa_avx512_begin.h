@@ -0,0 +1,21 @@
+//! opens the avx512 part of an isa file, closed by saber_isa_end.h,
+//! see saber_isa_avx2_begin.h. there is no include guard, each isa file includes it once.
+#include "anakin_config.h"
+
+#if defined(BUILD_X86_FAT_BIN)
+#include <immintrin.h>
+#pragma GCC push_options
+#pragma GCC target("avx512f,avx2,fma")
+#if !defined(__AVX512F__)
+#define __AVX512F__ 1
+#define SABER_ISA_DEFINED_AVX512F
+#endif
+#if !defined(__AVX2__)
+#define __AVX2__ 1
+#define SABER_ISA_DEFINED_AVX2
+#endif
+#if !defined(__FMA__)
+#define __FMA__ 1
+#define SABER_ISA_DEFINED_FMA
+#endif
+#endif
@@ -0,0 +1,16 @@
+//! closes the isa part opened by saber_isa_avx2_begin.h or saber_isa_avx512_begin.h
+#if defined(BUILD_X86_FAT_BIN)
+#pragma GCC pop_options
+#if defined(SABER_ISA_DEFINED_AVX512F)
+#undef __AVX512F__
+#undef SABER_ISA_DEFINED_AVX512F
+#endif
+#if defined(SABER_ISA_DEFINED_AVX2)
+#undef __AVX2__
+#undef SABER_ISA_DEFINED_AVX2
+#endif
+#if defined(SABER_ISA_DEFINED_FMA)
+#undef __FMA__
+#undef SABER_ISA_DEFINED_FMA
+#endif
+#endif
@@ -0,0 +1,176 @@
+#include "saber/funcs/impl/x86/saber_layout_trans.h"
+#include <algorithm>
+#include <cstring>
+
+namespace anakin {
+
+namespace saber {
+
+namespace {
+
+//! element count below this is reordered by the calling thread only
+const int64_t LAYOUT_TRANS_PARALLEL_MIN = 1 << 16;
+
+/**
+ * \brief where element (n, c, hw) of a 4d tensor lives:
+ * n * n_stride + (c / block) * c_stride + c % block + hw * hw_stride,
+ * block is 1 for the plain layouts.
+ */
+struct LayoutStride {
+    int block{1};
+    int64_t n_stride{0};
+    int64_t c_stride{0};
+    int64_t hw_stride{0};
+};
+
+int layout_block(const LayoutType layout) {
+    switch (layout) {
+    case Layout_NCHW_C8R:
+        return 8;
+
+    case Layout_NCHW_C16R:
+        return 16;
+
+    default:
+        return 1;
+    }
+}
+
+bool is_support_layout(const LayoutType layout) {
+    return layout == Layout_NCHW || layout == Layout_NHWC
+           || layout == Layout_NCHW_C8R || layout == Layout_NCHW_C16R;
+}
+
+LayoutStride get_layout_stride(const LayoutType layout, const int channel, const int64_t hw) {
+    LayoutStride stride;
+    stride.block = layout_block(layout);
+
+    if (layout == Layout_NHWC) {
+        stride.c_stride = 1;
+        stride.hw_stride = channel;
+        stride.n_stride = channel * hw;
+    } else {
+        const int64_t block_num = (channel + stride.block - 1) / stride.block;
+        stride.c_stride = hw * stride.block;
+        stride.hw_stride = stride.block;
+        stride.n_stride = block_num * hw * stride.block;
+    }
+
+    return stride;
+}
+
+//! dst in NCHW or a blocked layout, written in order, padded channels are zeroed
+template <typename Dtype>
+void trans_to_planar(const Dtype* src, Dtype* dst, const int64_t* src_c_off,
+                     const LayoutStride& src_stride, const LayoutStride& dst_stride,
+                     const int num, const int channel, const int64_t hw) {
+    const int block = dst_stride.block;
+    const int block_num = (channel + block - 1) / block;
+
+    #pragma omp parallel for collapse(2) schedule(static) if (num * dst_stride.n_stride >= LAYOUT_TRANS_PARALLEL_MIN)
+
+    for (int n = 0; n < num; ++n) {
+        for (int cb = 0; cb < block_num; ++cb) {
+            const Dtype* src_n = src + n * src_stride.n_stride;
+            Dtype* dst_block = dst + n * dst_stride.n_stride + cb * dst_stride.c_stride;
+            const int valid = std::min(block, channel - cb * block);
+
+            for (int64_t i = 0; i < hw; ++i) {
+                const Dtype* src_hw = src_n + i * src_stride.hw_stride;
+                Dtype* dst_hw = dst_block + i * block;
+
+                for (int lane = 0; lane < valid; ++lane) {
+                    dst_hw[lane] = src_hw[src_c_off[cb * block + lane]];
+                }
+
+                for (int lane = valid; lane < block; ++lane) {
+                    dst_hw[lane] = 0;
+                }
+            }
+        }
+    }
+}
+
+//! dst in NHWC, written in order
+template <typename Dtype>
+void trans_to_nhwc(const Dtype* src, Dtype* dst, const int64_t* src_c_off,
+                   const LayoutStride& src_stride, const LayoutStride& dst_stride,
+                   const int num, const int channel, const int64_t hw) {
+    #pragma omp parallel for collapse(2) schedule(static) if (num * dst_stride.n_stride >= LAYOUT_TRANS_PARALLEL_MIN)
+
+    for (int n = 0; n < num; ++n) {
+        for (int64_t i = 0; i < hw; ++i) {
+            const Dtype* src_hw = src + n * src_stride.n_stride + i * src_stride.hw_stride;
+            Dtype* dst_hw = dst + n * dst_stride.n_stride + i * dst_stride.hw_stride;
+
+            for (int c = 0; c < channel; ++c) {
+                dst_hw[c] = src_hw[src_c_off[c]];
+            }
+        }
+    }
+}
+
+} //namespace
+
+template <DataType OpDtype>
+SaberStatus SaberLayoutTrans<X86, OpDtype>::create(const std::vector<Tensor<X86> *>& inputs,
+        std::vector<Tensor<X86> *>& outputs,
+        LayoutTransParam<X86>& param, Context<X86>& ctx) {
+    LayoutType in_layout = inputs[0]->get_layout();
+    LayoutType out_layout = outputs[0]->get_layout();
+    CHECK(is_support_layout(in_layout)) << "layout trans not support input layout " << in_layout;
+    CHECK(is_support_layout(out_layout)) << "layout trans not support output layout " << out_layout;
+
+    const int channel = inputs[0]->channel();
+    const int64_t hw = (int64_t)inputs[0]->height() * inputs[0]->width();
+    const LayoutStride src_stride = get_layout_stride(in_layout, channel, hw);
+    _src_channel_offset.resize(channel);
+
+    for (int c = 0; c < channel; ++c) {
+        _src_channel_offset[c] = (c / src_stride.block) * src_stride.c_stride + c % src_stride.block;
+    }
+
+    return SaberSuccess;
+}
+
+template <DataType OpDtype>
+SaberStatus SaberLayoutTrans<X86, OpDtype>::dispatch(const std::vector<Tensor<X86> *>& inputs,
+        std::vector<Tensor<X86> *>& outputs,
+        LayoutTransParam<X86>& param) {
+    LayoutType in_layout = inputs[0]->get_layout();
+    LayoutType out_layout = outputs[0]->get_layout();
+    outputs[0]->set_seq_offset(inputs[0]->get_seq_offset());
+
+    if (in_layout == out_layout) {
+        return outputs[0]->copy_from(*inputs[0]);
+    }
+
+    const int num = inputs[0]->num();
+    const int channel = inputs[0]->channel();
+    const int64_t hw = (int64_t)inputs[0]->height() * inputs[0]->width();
+
+    if (_src_channel_offset.size() != (size_t)channel) {
+        create(inputs, outputs, param, *this->_ctx);
+    }
+
+    const LayoutStride src_stride = get_layout_stride(in_layout, channel, hw);
+    const LayoutStride dst_stride = get_layout_stride(out_layout, channel, hw);
+    const OpDataType* src = static_cast<const OpDataType*>(inputs[0]->data());
+    OpDataType* dst = static_cast<OpDataType*>(outputs[0]->mutable_data());
+
+    if (out_layout == Layout_NHWC) {
+        trans_to_nhwc(src, dst, _src_channel_offset.data(), src_stride, dst_stride, num, channel, hw);
+    } else {
+        trans_to_planar(src, dst, _src_channel_offset.data(), src_stride, dst_stride, num, channel, hw);
+    }
+
+    return SaberSuccess;
+}
+
+template class SaberLayoutTrans<X86, AK_FLOAT>;
+DEFINE_OP_TEMPLATE(SaberLayoutTrans, LayoutTransParam, X86, AK_HALF);
+DEFINE_OP_TEMPLATE(SaberLayoutTrans, LayoutTransParam, X86, AK_INT8);
+
+} // namespace saber
+
+} // namespace anakin
@@ -0,0 +1,59 @@
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef ANAKIN_SABER_FUNCS_IMPL_X86_SABER_LAYOUT_TRANS_H
+#define ANAKIN_SABER_FUNCS_IMPL_X86_SABER_LAYOUT_TRANS_H
+
+#include "saber/funcs/impl/impl_layout_trans.h"
+
+namespace anakin {
+
+namespace saber {
+
+template <DataType OpDtype>
+class SaberLayoutTrans<X86, OpDtype> :
+    public ImplBase<X86, OpDtype, LayoutTransParam<X86> > {
+public:
+    typedef typename DataTrait<X86, OpDtype>::Dtype OpDataType;
+
+    SaberLayoutTrans() {}
+
+    ~SaberLayoutTrans() {}
+
+    virtual SaberStatus init(const std::vector<Tensor<X86> *>& inputs,
+                             std::vector<Tensor<X86> *>& outputs,
+                             LayoutTransParam<X86>& param, Context<X86>& ctx) {
+        this->_ctx = &ctx;
+        return create(inputs, outputs, param, ctx);
+    }
+
+    virtual SaberStatus create(const std::vector<Tensor<X86> *>& inputs,
+                               std::vector<Tensor<X86> *>& outputs,
+                               LayoutTransParam<X86>& param, Context<X86>& ctx);
+
+    virtual SaberStatus dispatch(const std::vector<Tensor<X86> *>& inputs,
+                                 std::vector<Tensor<X86> *>& outputs,
+                                 LayoutTransParam<X86>& param);
+
+private:
+    //! offset of every channel inside one image of the input
+    std::vector<int64_t> _src_channel_offset;
+};
+
+} // namespace saber
+
+} // namespace anakin
+
+#endif //ANAKIN_SABER_FUNCS_IMPL_X86_SABER_LAYOUT_TRANS_H
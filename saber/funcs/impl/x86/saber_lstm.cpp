@@ -222,7 +222,14 @@ avx_dispatch(const std::vector<Tensor<X86>*>& inputs,
     OpDataType* temp_wh = (OpDataType*)_temp_wh.mutable_data();
     OpDataType* temp_wx = (OpDataType*)_temp_wx.mutable_data();
 
-    _wx_gemm_fp32.dispatch(1.f,0.f,seqsum, inner_x, weight_w,temp_wx);
+    if (param.dynamic_quant) {
+        _wx_gemm_int8.dispatch(seqsum, inner_x, temp_wx);
+    } else if (_half_weights) {
+        _wx_gemm_half.dispatch(seqsum, inner_x, _word_size, temp_wx, 4 * _aligned_hidden_size);
+    } else {
+        _wx_gemm_fp32.dispatch(1.f, 0.f, seqsum, inner_x, weight_w, temp_wx);
+    }
+
 //    gemm(false, false, seqsum, 4 * _aligned_hidden_size, _word_size, 1.f, inner_x, weight_w, 0.f,
 //         temp_wx);
 
@@ -277,7 +284,13 @@ avx_dispatch(const std::vector<Tensor<X86>*>& inputs,
 //             weight_h,
 //             1.f, temp_wx + emit_word_id_start * 4 * _aligned_hidden_size);
 
-        _wh_gemm_fp32.dispatch(1.f,1.f,emit_word_length,hin, weight_h,temp_wx + emit_word_id_start * 4 * _aligned_hidden_size);
+        if (_half_weights) {
+            _wh_gemm_half.dispatch(emit_word_length, hin, _aligned_hidden_size,
+                                   temp_wx + emit_word_id_start * 4 * _aligned_hidden_size,
+                                   4 * _aligned_hidden_size, nullptr, true);
+        } else {
+            _wh_gemm_fp32.dispatch(1.f,1.f,emit_word_length,hin, weight_h,temp_wx + emit_word_id_start * 4 * _aligned_hidden_size);
+        }
 
         cal_lstm_batch<BIT, OpDataType, with_peephole>(emit_word_id_start, emit_word_id_end, temp_wx,
                 weight_peephole,
@@ -4,6 +4,9 @@
 #include "saber_funcs_param.h"
 #include "saber/funcs/impl/x86/x86_utils.h"
 #include "saber/funcs/impl/x86/mkl_gemm.h"
+#include "saber/funcs/impl/x86/mkl_packed_int8_gemm.h"
+#include "saber/funcs/impl/x86/packed_half_gemm.h"
+#include "saber/funcs/impl/x86/half_convert_helper.h"
 
 #if defined(__AVX512F__)
 #include <immintrin.h>
@@ -50,6 +53,9 @@ public:
         int weights_bias_size=4*_hidden_size;
         int weights_peephole_size=3*_hidden_size;
 
+        const DataType weight_dtype = param.weight()->get_dtype();
+        _half_weights = is_half_dtype(weight_dtype);
+
         int aligned_byte= sizeof(SABER_X86_TYPE);
         int c_size=aligned_byte/sizeof(OpDataType);
 
@@ -60,17 +66,9 @@ public:
         Shape aligned_weights_i2h_shape({1,_word_size,4,_aligned_hidden_size});
         Shape aligned_weights_h2h_shape({1,_aligned_hidden_size,4,_aligned_hidden_size});
         Shape aligned_weights_bias_shape({1,1,4,_aligned_hidden_size});
-        utils::try_expand_tensor(_aligned_weights_i2h,aligned_weights_i2h_shape);
-        utils::try_expand_tensor(_aligned_weights_h2h,aligned_weights_h2h_shape);
         utils::try_expand_tensor(_aligned_weights_bias,aligned_weights_bias_shape);
 
         utils::AlignedUtils aligned_tool;
-        aligned_tool.aligned_last_dim((OpDataType*)(param.weight()->data()),(OpDataType*)_aligned_weights_i2h.mutable_data(),
-                weights_i2h_size,_hidden_size,_aligned_hidden_size);
-
-        aligned_tool.aligned_last_dim((OpDataType*)(param.weight()->data()) + weights_i2h_size,(OpDataType*)_aligned_weights_h2h.mutable_data(),
-                weights_h2h_size,_hidden_size,_aligned_hidden_size);
-
         aligned_tool.aligned_last_dim((OpDataType*)param.bias()->data(),(OpDataType*)_aligned_weights_bias.mutable_data(),
                 weights_bias_size,_hidden_size,_aligned_hidden_size);
         //FIXME:init weights tensor
@@ -82,11 +80,54 @@ public:
         }
 
         int seqsum = inputs[0]->num();
+        if (_half_weights) {
+            // fp16 / bf16 weights are aligned as 16 bit values and packed as they are,
+            // the aligned copies are dropped once packed
+            const uint16_t* weight_data = static_cast<const uint16_t*>(param.weight()->data());
+            Tensor<X86> half_i2h(aligned_weights_i2h_shape, weight_dtype);
+            Tensor<X86> half_h2h(aligned_weights_h2h_shape, weight_dtype);
+            aligned_tool.aligned_last_dim(weight_data, static_cast<uint16_t*>(half_i2h.mutable_data()),
+                    weights_i2h_size, _hidden_size, _aligned_hidden_size);
+            aligned_tool.aligned_last_dim(weight_data + weights_i2h_size,
+                    static_cast<uint16_t*>(half_h2h.mutable_data()),
+                    weights_h2h_size, _hidden_size, _aligned_hidden_size);
+
+            if (param.dynamic_quant) {
+                Tensor<X86> i2h_fp32(aligned_weights_i2h_shape, AK_FLOAT);
+                half_to_fp32(static_cast<const uint16_t*>(half_i2h.data()),
+                             static_cast<float*>(i2h_fp32.mutable_data()), half_i2h.valid_size(), weight_dtype);
+                _wx_gemm_int8.init(false, false, seqsum, 4 * _aligned_hidden_size, _word_size,
+                                   i2h_fp32, 1.f, true);
+            } else {
+                _wx_gemm_half.init(false, 4 * _aligned_hidden_size, _word_size, half_i2h.data(),
+                                   4 * _aligned_hidden_size, weight_dtype, weight_dtype);
+            }
+
+            // only the first _hidden_size rows of the aligned h2h weights are real
+            _wh_gemm_half.init(false, 4 * _aligned_hidden_size, _hidden_size, half_h2h.data(),
+                               4 * _aligned_hidden_size, weight_dtype, weight_dtype);
+            return create(inputs,outputs,param,ctx);
+        }
+
+        const OpDataType* weight_data = (const OpDataType*)(param.weight()->data());
+        utils::try_expand_tensor(_aligned_weights_i2h,aligned_weights_i2h_shape);
+        utils::try_expand_tensor(_aligned_weights_h2h,aligned_weights_h2h_shape);
+        aligned_tool.aligned_last_dim(weight_data,(OpDataType*)_aligned_weights_i2h.mutable_data(),
+                weights_i2h_size,_hidden_size,_aligned_hidden_size);
+
+        aligned_tool.aligned_last_dim(weight_data + weights_i2h_size,(OpDataType*)_aligned_weights_h2h.mutable_data(),
+                weights_h2h_size,_hidden_size,_aligned_hidden_size);
+
         const float* weight_h = (const float*)_aligned_weights_h2h.data();
         const float* weight_w = (const float*)_aligned_weights_i2h.data();
         _wx_gemm_fp32.init(false, false,seqsum, 4 * _aligned_hidden_size, _word_size,ctx,weight_w,PACKED_MKLGEMM);
         _wh_gemm_fp32.init(false, false,seqsum, 4 * _aligned_hidden_size, _aligned_hidden_size,ctx,weight_h,PACKED_MKLGEMM);
 
+        if (param.dynamic_quant) {
+            _wx_gemm_int8.init(false, false, seqsum, 4 * _aligned_hidden_size, _word_size,
+                               _aligned_weights_i2h, 1.f, true);
+        }
+
         return create(inputs,outputs,param,ctx);
     } ;
 
@@ -132,6 +173,12 @@ private:
 
     MklDnnGemm<float, float, float> _wx_gemm_fp32;
     MklDnnGemm<float, float, float> _wh_gemm_fp32;
+    //! int8 input to hidden gemm of dynamic quant
+    PackedMKLInt8Gemm _wx_gemm_int8;
+    //! gemms on fp16 / bf16 weights
+    bool _half_weights{false};
+    PackedHalfGemm _wx_gemm_half;
+    PackedHalfGemm _wh_gemm_half;
 
     template <typename BIT,bool with_peephole >
     SaberStatus avx_dispatch(const std::vector<Tensor<X86>*>& inputs,
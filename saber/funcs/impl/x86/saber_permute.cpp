@@ -1,4 +1,5 @@
 #include "saber/funcs/impl/x86/saber_permute.h"
+#include "saber/funcs/impl/x86/permute_helper.h"
 
 namespace anakin{
 namespace saber{
@@ -65,43 +66,8 @@ SaberStatus SaberPermute<X86, AK_FLOAT>::\
         }
         const float* src_ptr = static_cast<const float*>(inputs[0] -> data());
         float* dst_ptr = static_cast<float*>(outputs[0] -> mutable_data());
-        std::vector<int> orders = param.order;
-        int out_size = outputs[0] -> valid_size();
-        int num_axes = inputs[0] -> valid_shape().size();
-        std::vector<int> new_steps = outputs[0] -> get_stride();
-        std::vector<int> old_steps = inputs[0] -> get_stride();
-        std::vector<int> new_valid_shape = outputs[0] -> valid_shape();
-        if (inputs[0]->is_continue_mem() && outputs[0]->is_continue_mem()){
-            for (int j=0; j<out_size; ++j){
-                int in_idx = 0;
-                int id = j;
-                for (int i = 0; i < num_axes; ++i) {
-                    int order = orders[i];
-                    int new_step = new_steps[i];
-                    int old_step = old_steps[order];
-                    int offset = (id / new_step) *old_step;
-                    in_idx += offset;
-                    id %= new_step;
-                }
-                dst_ptr[j] = src_ptr[in_idx];
-            }
-        } else {
-            for (int j=0; j<out_size; ++j){
-                int in_idx = 0;
-                int out_idx  = 0;
-                int new_valid_stride = 1;
-                for (int i = num_axes - 1; i >= 0; --i) {
-                    int order = orders[i];
-                    int new_step = new_steps[i];
-                    int old_step = old_steps[order];
-                    int id = (j / new_valid_stride) % new_valid_shape[i];
-                    in_idx += id * old_step;
-                    out_idx += id * new_step;
-                    new_valid_stride *= new_valid_shape[i];
-                }
-                dst_ptr[out_idx] = src_ptr[in_idx];
-            }
-        }
+        permute_x86(src_ptr, dst_ptr, inputs[0] -> valid_shape(), param.order,
+                    inputs[0] -> get_stride(), outputs[0] -> get_stride());
         return SaberSuccess;
         
 }
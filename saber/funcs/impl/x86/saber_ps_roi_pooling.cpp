@@ -1,6 +1,7 @@
 #include "saber/funcs/impl/x86/saber_ps_roi_pooling.h"
 #include <cfloat>
 #include <cmath>
+#include <vector>
 
 namespace anakin {
 
@@ -11,6 +12,8 @@ namespace saber {
  * in_data shape: [pooled_h * pooled_w * c, im_h, im_w]
  * rois shape: [num_rois, 4]
  * out_data: [pooled_h * pooled_w * c, num_rois, crop_height, crop_width]
+ * the sampling rows and columns of a roi are shared by every channel,
+ * so they are resolved once per roi before the channels are resized in parallel.
  */
 template <typename Dtype>
 void crop_and_resize_kernel(
@@ -24,17 +27,20 @@ void crop_and_resize_kernel(
     int method,
     float extra_value){
 
-    for (int index = 0;index < count; ++index){
-        int temp_ind = index;
-        int cur_w = temp_ind % crop_width;
-        temp_ind /= crop_width;
-        int cur_h = temp_ind % crop_height;
-        temp_ind /= crop_height;
-        int cur_n = temp_ind % num_rois;
-        int cur_c = temp_ind / num_rois;
-
+    int crop_size = crop_height * crop_width;
+    int channel = count / (num_rois * crop_size);
+    // per roi and crop row: first/second source row offset and lerp, -1 when out of map
+    std::vector<int> row_lo(num_rois * crop_height);
+    std::vector<int> row_hi(num_rois * crop_height);
+    std::vector<float> row_lerp(num_rois * crop_height);
+    // per roi and crop column: first/second source column and lerp, -1 when out of map
+    std::vector<int> col_lo(num_rois * crop_width);
+    std::vector<int> col_hi(num_rois * crop_width);
+    std::vector<float> col_lerp(num_rois * crop_width);
+
+    for (int cur_n = 0; cur_n < num_rois; ++cur_n) {
         const Dtype* rois_data = rois + cur_n * 4;
-        
+
         float y1 = rois_data[0] * (im_h - 1);
         float x1 = rois_data[1] * (im_w - 1);
         float y2 = rois_data[2] * (im_h - 1);
@@ -43,43 +49,82 @@ void crop_and_resize_kernel(
         float height_scale = crop_height > 1 ? (y2 - y1)/(crop_height - 1) : 0;
         float width_scale = crop_width > 1 ? (x2 - x1)/(crop_width - 1) : 0;
 
-        float in_y = crop_height > 1 ? y1 + cur_h * height_scale : (y1 + y2)/2;
-
-        if (in_y < 0 || in_y > im_h - 1){
-            out_data[index] = extra_value;
-            continue;
+        for (int cur_h = 0; cur_h < crop_height; ++cur_h) {
+            int idx = cur_n * crop_height + cur_h;
+            float in_y = crop_height > 1 ? y1 + cur_h * height_scale : (y1 + y2)/2;
+            if (in_y < 0 || in_y > im_h - 1){
+                row_lo[idx] = -1;
+                continue;
+            }
+            if (method == 0) {
+                int top_y = floor(in_y);
+                row_lo[idx] = top_y * im_w;
+                row_hi[idx] = (int)ceil(in_y) * im_w;
+                row_lerp[idx] = in_y - top_y;
+            } else {
+                row_lo[idx] = (int)round(in_y) * im_w;
+            }
         }
-
-        float in_x = crop_width > 1 ? x1 + cur_w * width_scale : (x1 + x2)/2;
-        if (in_x < 0 || in_x > im_w - 1){
-            out_data[index] = extra_value;
-            continue;
+        for (int cur_w = 0; cur_w < crop_width; ++cur_w) {
+            int idx = cur_n * crop_width + cur_w;
+            float in_x = crop_width > 1 ? x1 + cur_w * width_scale : (x1 + x2)/2;
+            if (in_x < 0 || in_x > im_w - 1){
+                col_lo[idx] = -1;
+                continue;
+            }
+            if (method == 0) {
+                int left_x = floor(in_x);
+                col_lo[idx] = left_x;
+                col_hi[idx] = ceil(in_x);
+                col_lerp[idx] = in_x - left_x;
+            } else {
+                col_lo[idx] = round(in_x);
+            }
         }
+    }
 
-        const Dtype* im_data = in_data + cur_c * im_h * im_w;
-
-        //resize method 0 means bilinear
-        if (method == 0){
-            int top_y = floor(in_y);
-            int bot_y = ceil(in_y);
-            float y_lerp = in_y - top_y;
-
-            int left_x = floor(in_x);
-            int right_x = ceil(in_x);
-            float x_lerp = in_x - left_x;
-
-            Dtype top_left = im_data[top_y*im_w + left_x];
-            Dtype top_right = im_data[top_y*im_w + right_x];
-            Dtype bot_left = im_data[bot_y*im_w + left_x];
-            Dtype bot_right = im_data[bot_y*im_w + right_x];
-            float top = top_left + (top_right - top_left) * y_lerp;
-            float bot = bot_left + (bot_right - bot_left) * y_lerp;
-            out_data[index] = top + (bot - top) * x_lerp; 
-        } else {
-          //else method means nearest 
-          int closest_x = round(in_x);
-          int closest_y = round(in_y);
-          out_data[index] = im_data[closest_y*im_w + closest_x];
+#pragma omp parallel for collapse(2) schedule(static)
+    for (int cur_c = 0; cur_c < channel; ++cur_c) {
+        for (int cur_n = 0; cur_n < num_rois; ++cur_n) {
+            const Dtype* im_data = in_data + cur_c * im_h * im_w;
+            Dtype* crop_data = out_data + (cur_c * num_rois + cur_n) * crop_size;
+            const int* c_lo = col_lo.data() + cur_n * crop_width;
+            const int* c_hi = col_hi.data() + cur_n * crop_width;
+            const float* c_lerp = col_lerp.data() + cur_n * crop_width;
+            for (int cur_h = 0; cur_h < crop_height; ++cur_h) {
+                int ridx = cur_n * crop_height + cur_h;
+                Dtype* dst = crop_data + cur_h * crop_width;
+                if (row_lo[ridx] < 0) {
+                    for (int cur_w = 0; cur_w < crop_width; ++cur_w) {
+                        dst[cur_w] = extra_value;
+                    }
+                    continue;
+                }
+                const Dtype* top_data = im_data + row_lo[ridx];
+                //resize method 0 means bilinear
+                if (method == 0){
+                    const Dtype* bot_data = im_data + row_hi[ridx];
+                    float y_lerp = row_lerp[ridx];
+                    for (int cur_w = 0; cur_w < crop_width; ++cur_w) {
+                        if (c_lo[cur_w] < 0) {
+                            dst[cur_w] = extra_value;
+                            continue;
+                        }
+                        Dtype top_left = top_data[c_lo[cur_w]];
+                        Dtype top_right = top_data[c_hi[cur_w]];
+                        Dtype bot_left = bot_data[c_lo[cur_w]];
+                        Dtype bot_right = bot_data[c_hi[cur_w]];
+                        float top = top_left + (top_right - top_left) * y_lerp;
+                        float bot = bot_left + (bot_right - bot_left) * y_lerp;
+                        dst[cur_w] = top + (bot - top) * c_lerp[cur_w];
+                    }
+                } else {
+                    //else method means nearest 
+                    for (int cur_w = 0; cur_w < crop_width; ++cur_w) {
+                        dst[cur_w] = c_lo[cur_w] < 0 ? extra_value : top_data[c_lo[cur_w]];
+                    }
+                }
+            }
         }
     }
 
@@ -89,10 +134,11 @@ template <typename Dtype>
 void crop_global_pooling_kernel(const Dtype* in_data, Dtype* out_data, 
     int pooled_size, int channel, int num_rois, int crop_height, int crop_width, 
     int count){
-    for (int index = 0; index < count; ++index){
-        int cur_n = index / channel;
-        int cur_c = index % channel;
-        int crop_size = crop_height * crop_width;
+    int crop_size = crop_height * crop_width;
+    // the pooled value only depends on the roi, it is reduced once and
+    // broadcast to the channels of that roi.
+#pragma omp parallel for schedule(static)
+    for (int cur_n = 0; cur_n < count / channel; ++cur_n){
         Dtype sum = 0;
         for (int i = 0; i < crop_size; ++i){
             Dtype tmp_sum = 0;
@@ -101,7 +147,10 @@ void crop_global_pooling_kernel(const Dtype* in_data, Dtype* out_data,
             }
             sum += tmp_sum / pooled_size;
         }
-        out_data[index] = sum /crop_size;
+        sum /= crop_size;
+        for (int cur_c = 0; cur_c < channel; ++cur_c) {
+            out_data[cur_n * channel + cur_c] = sum;
+        }
     }
 }
 
@@ -109,17 +158,19 @@ template <typename Dtype>
 void crop_no_global_pooling_kernel(const Dtype* in_data, Dtype* out_data, 
     int pooled_height, int pooled_width, int channel, int num_rois, int crop_height, int crop_width, 
     int count){
+#pragma omp parallel for schedule(static)
     for (int index = 0; index < count; ++index){
-        int cur_pw = index % pooled_width;
-        index /= pooled_width;
-        int cur_cw = index % crop_width;
-        index /= crop_width;
-        int cur_ph = index % pooled_height;
-        index /= pooled_height;
-        int cur_ch = index % crop_height;
-        index /= crop_height;
-        int cur_c = index % channel;
-        int cur_n = index / channel;
+        int temp_ind = index;
+        int cur_pw = temp_ind % pooled_width;
+        temp_ind /= pooled_width;
+        int cur_cw = temp_ind % crop_width;
+        temp_ind /= crop_width;
+        int cur_ph = temp_ind % pooled_height;
+        temp_ind /= pooled_height;
+        int cur_ch = temp_ind % crop_height;
+        temp_ind /= crop_height;
+        int cur_c = temp_ind % channel;
+        int cur_n = temp_ind / channel;
 
         int in_index = ((((cur_ph * pooled_width + cur_pw) * channel + 
             cur_c) * num_rois + cur_n) * crop_height + cur_ch) * crop_width + cur_cw;
@@ -1,5 +1,6 @@
 #include "saber_rcnn_proposal.h"
 #include "saber/core/tensor_op.h"
+#include "saber/funcs/impl/x86/nms_helper.h"
 #include <cfloat>
 
 namespace anakin {
@@ -299,8 +300,13 @@ SaberStatus SaberRCNNProposal<X86, AK_FLOAT>::dispatch(
 
     if (outputs.size() != 0) {
         std::vector<std::vector<BBox<float> > > proposal_batch_vec(outputs.size());
+        const int img_num = proposal_per_img_vec.size();
+        std::vector<std::vector<std::vector<BBox<float> > > > proposal_img_batch_vec(img_num,
+                std::vector<std::vector<BBox<float> > >(outputs.size()));
 
-        for (int i = 0; i < proposal_per_img_vec.size(); ++i) {
+        //! nms of each image runs in parallel, results are appended in image order
+#pragma omp parallel for schedule(dynamic)
+        for (int i = 0; i < img_num; ++i) {
             std::vector<BBox<float> >& proposal_cur = proposal_per_img_vec[i];
             //do nms
             std::vector<bool> sel;
@@ -311,7 +317,7 @@ SaberStatus SaberRCNNProposal<X86, AK_FLOAT>::dispatch(
                                   this->bbox_size_add_one_, this->nms_voting_[0],
                                   this->nms_vote_iou_[0]);
             } else {
-                sel = nms_lm(proposal_cur, this->nms_overlap_ratio_[0],
+                sel = nms_lm_x86(proposal_cur, this->nms_overlap_ratio_[0],
                              this->nms_top_n_[0], false, this->nms_max_candidate_n_[0],
                              this->bbox_size_add_one_, this->nms_voting_[0],
                              this->nms_vote_iou_[0]);
@@ -331,13 +337,21 @@ SaberStatus SaberRCNNProposal<X86, AK_FLOAT>::dispatch(
                     for (int t = 0; t < outputs.size(); t++) {
                         if (bwxh > this->proposal_min_area_vec_[t]
                             && bwxh < this->proposal_max_area_vec_[t]) {
-                            proposal_batch_vec[t].push_back(proposal_cur[k]);
+                            proposal_img_batch_vec[i][t].push_back(proposal_cur[k]);
                         }
                     }
                 }
             }
         }
 
+        for (int i = 0; i < img_num; ++i) {
+            for (int t = 0; t < outputs.size(); t++) {
+                proposal_batch_vec[t].insert(proposal_batch_vec[t].end(),
+                                             proposal_img_batch_vec[i][t].begin(),
+                                             proposal_img_batch_vec[i][t].end());
+            }
+        }
+
         for (int t = 0; t < outputs.size(); t++) {
             if (proposal_batch_vec[t].empty()) {
                 // for special case when there is no box
@@ -383,12 +397,14 @@ SaberStatus SaberRCNNProposal<X86, AK_FLOAT>::dispatch(
         //        if (!is_input_paramid || this->pyramid_image_data_param_.forward_iter_id_ ==
         //                                 (this->pyramid_image_data_param_.forward_times_for_cur_sample_ - 1))
         {
+#pragma omp parallel for schedule(dynamic)
             for (int class_id = 0; class_id < this->num_class_; ++class_id) {
                 std::vector<BBox<float> >& cur_box_list = this->all_candidate_bboxes_[class_id];
                 std::vector<BBox<float> >& cur_outbox_list = this->output_bboxes_[class_id];
+                std::vector<bool> is_candidate_bbox_selected;
 
                 if (this->nms_use_soft_nms_[class_id]) {
-                    this->is_candidate_bbox_selected_ = soft_nms_lm(cur_box_list,
+                    is_candidate_bbox_selected = soft_nms_lm(cur_box_list,
                                                                     this->nms_overlap_ratio_[class_id],
                                                                     this->nms_top_n_[class_id],
                                                                     this->nms_max_candidate_n_[class_id],
@@ -396,7 +412,7 @@ SaberStatus SaberRCNNProposal<X86, AK_FLOAT>::dispatch(
                                                                     this->nms_voting_[class_id],
                                                                     this->nms_vote_iou_[class_id]);
                 } else {
-                    this->is_candidate_bbox_selected_ = nms_lm(cur_box_list,
+                    is_candidate_bbox_selected = nms_lm_x86(cur_box_list,
                                                                this->nms_overlap_ratio_[class_id],
                                                                this->nms_top_n_[class_id],
                                                                false, this->nms_max_candidate_n_[class_id],
@@ -407,8 +423,8 @@ SaberStatus SaberRCNNProposal<X86, AK_FLOAT>::dispatch(
 
                 cur_outbox_list.clear();
 
-                for (int i = 0; i < this->is_candidate_bbox_selected_.size(); ++i) {
-                    if (this->is_candidate_bbox_selected_[i]) {
+                for (int i = 0; i < is_candidate_bbox_selected.size(); ++i) {
+                    if (is_candidate_bbox_selected[i]) {
                         int id = im_width_scale.size() > 1 ? cur_box_list[i].id : 0;
                                 CHECK_LT(id, im_width_scale.size());
                         cur_box_list[i].x1 = cur_box_list[i].x1
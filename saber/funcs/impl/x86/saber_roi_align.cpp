@@ -1,21 +1,22 @@
 #include "saber/funcs/impl/x86/saber_roi_align.h"
 #include <limits>
 #include <cmath>
+#include <immintrin.h>
 namespace anakin {
 
 namespace saber {
 
 // we calculate the src coordinary and weights previsiously.
-template <typename dtype, typename TargetType>
+// positions are element offsets inside one channel (block), h_stride and w_stride
+// being the strides of a row and a pixel in that layout.
+template <typename dtype>
 void bilinear_interpolate(
-    const int height, const int width,
+    const int height, const int width, const int h_stride, const int w_stride,
     const int pooled_height, const int pooled_width, const int iy_upper,
     const int ix_upper, dtype roi_ymin, dtype roi_xmin, dtype bin_size_h, dtype bin_size_w,
-    int roi_bin_grid_h, int roi_bin_grid_w, const int kROISize, 
-    const int prePosROISize, Tensor<TargetType>* pre_pos, Tensor<TargetType>* pre_w) {
+    int roi_bin_grid_h, int roi_bin_grid_w,
+    const int prePosROISize, int* pre_pos_data, dtype* pre_w_data) {
   int pre_calc_index = 0;
-  int* pre_pos_data = (int*)pre_pos->mutable_data();
-  dtype* pre_w_data = (dtype*)pre_w->mutable_data();
   for (int ph = 0; ph < pooled_height; ph++) {
     for (int pw = 0; pw < pooled_width; pw++) {
       for (int iy = 0; iy < iy_upper; iy++) {
@@ -57,10 +58,10 @@ void bilinear_interpolate(
           }
           dtype ly = y - y_low, lx = x - x_low;
           dtype hy = 1. - ly, hx = 1. - lx;
-          pre_pos_data[pre_calc_index * prePosROISize] = y_low * width + x_low;
-          pre_pos_data[pre_calc_index * prePosROISize + 1] = y_low * width + x_high;
-          pre_pos_data[pre_calc_index * prePosROISize + 2] = y_high * width + x_low;
-          pre_pos_data[pre_calc_index * prePosROISize + 3] = y_high * width + x_high;
+          pre_pos_data[pre_calc_index * prePosROISize] = y_low * h_stride + x_low * w_stride;
+          pre_pos_data[pre_calc_index * prePosROISize + 1] = y_low * h_stride + x_high * w_stride;
+          pre_pos_data[pre_calc_index * prePosROISize + 2] = y_high * h_stride + x_low * w_stride;
+          pre_pos_data[pre_calc_index * prePosROISize + 3] = y_high * h_stride + x_high * w_stride;
           pre_w_data[pre_calc_index * prePosROISize] = hy * hx;
           pre_w_data[pre_calc_index * prePosROISize + 1] = hy * lx;
           pre_w_data[pre_calc_index * prePosROISize + 2] = ly * hx;
@@ -72,6 +73,87 @@ void bilinear_interpolate(
   }
 }
 
+// weighted sum of the bilinear taps of one bin for CB consecutive channels,
+// the channels of one pixel being contiguous in NCHW_C8/NCHW_C16.
+template <int CB>
+inline void roi_align_bin_blocked(const float* src, const int* pos, const float* w,
+                                  int taps, int count, float* dst) {
+#if defined(__AVX512F__)
+    if (CB == 16) {
+        __m512 acc = _mm512_setzero_ps();
+        for (int i = 0; i < taps; ++i) {
+            acc = _mm512_fmadd_ps(_mm512_set1_ps(w[i]), _mm512_loadu_ps(src + pos[i]), acc);
+        }
+        _mm512_storeu_ps(dst, _mm512_div_ps(acc, _mm512_set1_ps((float)count)));
+        return;
+    }
+#endif
+#if defined(__AVX2__)
+    if (CB == 8) {
+        __m256 acc = _mm256_setzero_ps();
+        for (int i = 0; i < taps; ++i) {
+            acc = _mm256_fmadd_ps(_mm256_set1_ps(w[i]), _mm256_loadu_ps(src + pos[i]), acc);
+        }
+        _mm256_storeu_ps(dst, _mm256_div_ps(acc, _mm256_set1_ps((float)count)));
+        return;
+    }
+#endif
+    float acc[CB] = {0.f};
+    for (int i = 0; i < taps; ++i) {
+        const float* pix = src + pos[i];
+        for (int k = 0; k < CB; ++k) {
+            acc[k] += w[i] * pix[k];
+        }
+    }
+    for (int k = 0; k < CB; ++k) {
+        dst[k] = acc[k] / count;
+    }
+}
+
+template <DataType OpDtype>
+SaberStatus SaberRoiAlign<X86, OpDtype>::create(\
+    const std::vector<Tensor<X86> *>& inputs, \
+    std::vector<Tensor<X86> *>& outputs, \
+    RoiAlignParam<X86>& param, Context<X86>& ctx) {
+
+    LayoutType in_layout = inputs[0]->get_layout();
+    LayoutType out_layout = outputs[0]->get_layout();
+    if (in_layout == Layout_NCHW_C8 || in_layout == Layout_NCHW_C8R) {
+        _c_block = 8;
+    } else if (in_layout == Layout_NCHW_C16 || in_layout == Layout_NCHW_C16R) {
+        _c_block = 16;
+    } else {
+        _c_block = 1;
+    }
+
+    if (_c_block == 1) {
+        Shape out_stride = outputs[0]->get_stride();
+        Shape in_stride = inputs[0]->get_stride();
+        _in_n_stride = in_stride[inputs[0]->num_index()];
+        _in_c_stride = in_stride[inputs[0]->channel_index()];
+        _in_h_stride = in_stride[inputs[0]->height_index()];
+        _in_w_stride = in_stride[inputs[0]->width_index()];
+        _out_n_stride = out_stride[outputs[0]->num_index()];
+        _out_c_stride = out_stride[outputs[0]->channel_index()];
+        _out_h_stride = out_stride[outputs[0]->height_index()];
+        _out_w_stride = out_stride[outputs[0]->width_index()];
+        return SaberSuccess;
+    }
+
+    CHECK(in_layout == out_layout) << "roi align on blocked layout needs the same output layout";
+    // c stride is the stride of one channel block, channels of a pixel are contiguous
+    int c_blocks = (inputs[0]->channel() + _c_block - 1) / _c_block;
+    _in_w_stride = _c_block;
+    _in_h_stride = inputs[0]->width() * _in_w_stride;
+    _in_c_stride = inputs[0]->height() * _in_h_stride;
+    _in_n_stride = c_blocks * _in_c_stride;
+    _out_w_stride = _c_block;
+    _out_h_stride = outputs[0]->width() * _out_w_stride;
+    _out_c_stride = outputs[0]->height() * _out_h_stride;
+    _out_n_stride = c_blocks * _out_c_stride;
+    return SaberSuccess;
+}
+
 template <DataType OpDtype>
 SaberStatus SaberRoiAlign<X86, OpDtype>::dispatch(\
     const std::vector<Tensor<X86> *>& inputs, \
@@ -81,68 +163,93 @@ SaberStatus SaberRoiAlign<X86, OpDtype>::dispatch(\
     const OpDataType* input_data = (const OpDataType*)inputs[0]->data();
     const OpDataType* rois = (const OpDataType*)inputs[1]->data();
     OpDataType* output_data = (OpDataType*)outputs[0]->mutable_data();
-    
-    int batch_size = inputs[0]->num();
+
     int channels = inputs[0]->channel();
     int height = inputs[0]->height();
     int width = inputs[0]->width();
     int rois_num = inputs[1]->num();
-    // int count = input[0]->valid_size();
+    int pooled_size = param.pooled_height * param.pooled_width;
+    int c_blocks = (channels + _c_block - 1) / _c_block;
 
-    if (inputs[0]->is_continue_mem() && outputs[0]->is_continue_mem()) {
-    // For each ROIs, do fix-sized align.
-        for (int n = 0; n < rois_num; ++n) {
-            const OpDataType* cur_rois = rois + n * _kROISize;
-            int rois_id = cur_rois[0];
-            OpDataType roi_xmin = cur_rois[1] * param.spatial_scale;
-            OpDataType roi_ymin = cur_rois[2] * param.spatial_scale;
-            OpDataType roi_xmax = cur_rois[3] * param.spatial_scale;
-            OpDataType roi_ymax = cur_rois[4] * param.spatial_scale;
-            
-            OpDataType roi_width = std::max(roi_xmax - roi_xmin, static_cast<OpDataType>(1.));
-            OpDataType roi_height = std::max(roi_ymax - roi_ymin, static_cast<OpDataType>(1.));
-            OpDataType bin_size_h = static_cast<OpDataType>(roi_height) / static_cast<OpDataType>(param.pooled_height);
-            OpDataType bin_size_w = static_cast<OpDataType>(roi_width) / static_cast<OpDataType>(param.pooled_width);
-            const OpDataType* batch_data = input_data + rois_id * _in_n_stride;
-            int roi_bin_grid_h = (param.sampling_ratio > 0)? param.sampling_ratio : ceil(roi_height / param.pooled_height);
-            int roi_bin_grid_w = (param.sampling_ratio > 0)? param.sampling_ratio : ceil(roi_width / param.pooled_width);
-            int count = roi_bin_grid_h * roi_bin_grid_w;
-            int pre_size = count * _out_c_stride;
-            _pre_pos.reshape(Shape({pre_size, _prePosROISize, 1, 1})); //pre ROI
-            _pre_w.reshape(Shape({pre_size, _prePosROISize, 1, 1})); // pre ROI weights.
+    if (rois_num <= 0) {
+        return SaberSuccess;
+    }
+    if (_c_block == 1 && !(inputs[0]->is_continue_mem() && outputs[0]->is_continue_mem())) {
+        return SaberSuccess;
+    }
+
+    // sampling grid of every roi, the bilinear taps are computed once per roi
+    // and shared by all channels.
+    std::vector<int> grid_h(rois_num);
+    std::vector<int> grid_w(rois_num);
+    std::vector<int> pre_offset(rois_num + 1, 0);
+    for (int n = 0; n < rois_num; ++n) {
+        const OpDataType* cur_rois = rois + n * _kROISize;
+        OpDataType roi_width = std::max((cur_rois[3] - cur_rois[1]) * param.spatial_scale,
+                                        static_cast<OpDataType>(1.));
+        OpDataType roi_height = std::max((cur_rois[4] - cur_rois[2]) * param.spatial_scale,
+                                         static_cast<OpDataType>(1.));
+        grid_h[n] = (param.sampling_ratio > 0)? param.sampling_ratio : ceil(roi_height / param.pooled_height);
+        grid_w[n] = (param.sampling_ratio > 0)? param.sampling_ratio : ceil(roi_width / param.pooled_width);
+        pre_offset[n + 1] = pre_offset[n] + grid_h[n] * grid_w[n] * pooled_size;
+    }
+    _pre_pos.re_alloc(Shape({pre_offset[rois_num], _prePosROISize, 1, 1}), AK_INT32); //pre ROI
+    _pre_w.reshape(Shape({pre_offset[rois_num], _prePosROISize, 1, 1})); // pre ROI weights.
+    int* pre_pos_data = (int*)_pre_pos.mutable_data();
+    OpDataType* pre_w_data = (OpDataType*)_pre_w.mutable_data();
+
+#pragma omp parallel for schedule(dynamic)
+    for (int n = 0; n < rois_num; ++n) {
+        const OpDataType* cur_rois = rois + n * _kROISize;
+        OpDataType roi_xmin = cur_rois[1] * param.spatial_scale;
+        OpDataType roi_ymin = cur_rois[2] * param.spatial_scale;
+        OpDataType roi_xmax = cur_rois[3] * param.spatial_scale;
+        OpDataType roi_ymax = cur_rois[4] * param.spatial_scale;
+
+        OpDataType roi_width = std::max(roi_xmax - roi_xmin, static_cast<OpDataType>(1.));
+        OpDataType roi_height = std::max(roi_ymax - roi_ymin, static_cast<OpDataType>(1.));
+        OpDataType bin_size_h = static_cast<OpDataType>(roi_height) / static_cast<OpDataType>(param.pooled_height);
+        OpDataType bin_size_w = static_cast<OpDataType>(roi_width) / static_cast<OpDataType>(param.pooled_width);
+        bilinear_interpolate<OpDataType>(height, width, _in_h_stride, _in_w_stride,
+                                         param.pooled_height, param.pooled_width,
+                                         grid_h[n], grid_w[n],
+                                         roi_ymin, roi_xmin,
+                                         bin_size_h, bin_size_w,
+                                         grid_h[n], grid_w[n],
+                                         _prePosROISize,
+                                         pre_pos_data + pre_offset[n] * _prePosROISize,
+                                         pre_w_data + pre_offset[n] * _prePosROISize);
+    }
 
-            bilinear_interpolate<OpDataType, X86>(height, width, 
-                                        param.pooled_height, param.pooled_width, 
-                                        roi_bin_grid_h,roi_bin_grid_w, 
-                                        roi_ymin, roi_xmin, 
-                                        bin_size_h, bin_size_w,
-                                        roi_bin_grid_h, roi_bin_grid_w,
-                                        _kROISize, _prePosROISize,
-                                        &_pre_pos, &_pre_w);
-            const int* pre_pos_data = (const int*)_pre_pos.data();
-            const OpDataType* pre_w_data = (const OpDataType*)_pre_w.data();
-            for (int c = 0; c < channels; c++) {
-                int pre_calc_index = 0;
-                for (int ph = 0; ph < param.pooled_height; ph++) {
-                    for (int pw = 0; pw < param.pooled_width; pw++) {
-                        const int pool_index = ph * param.pooled_width + pw;
+    // every (roi, channel block) is independent
+#pragma omp parallel for collapse(2) schedule(static)
+    for (int n = 0; n < rois_num; ++n) {
+        for (int cb = 0; cb < c_blocks; ++cb) {
+            int rois_id = rois[n * _kROISize];
+            int count = grid_h[n] * grid_w[n];
+            int taps = count * _prePosROISize;
+            const OpDataType* batch_data = input_data + rois_id * _in_n_stride + cb * _in_c_stride;
+            OpDataType* out_data = output_data + n * _out_n_stride + cb * _out_c_stride;
+            const int* pos = pre_pos_data + pre_offset[n] * _prePosROISize;
+            const OpDataType* w = pre_w_data + pre_offset[n] * _prePosROISize;
+            for (int ph = 0; ph < param.pooled_height; ph++) {
+                for (int pw = 0; pw < param.pooled_width; pw++) {
+                    OpDataType* dst = out_data + ph * _out_h_stride + pw * _out_w_stride;
+                    if (_c_block == 8) {
+                        roi_align_bin_blocked<8>(batch_data, pos, w, taps, count, dst);
+                    } else if (_c_block == 16) {
+                        roi_align_bin_blocked<16>(batch_data, pos, w, taps, count, dst);
+                    } else {
                         OpDataType output_val = 0;
-                        for (int iy = 0; iy < roi_bin_grid_h; iy++) {
-                            for (int ix = 0; ix < roi_bin_grid_w; ix++) {
-                                for (int i = 0; i < _prePosROISize; i++) {
-                                    int pos = pre_pos_data[pre_calc_index * _prePosROISize + i];
-                                    OpDataType w = pre_w_data[pre_calc_index * _prePosROISize + i];
-                                    output_val += w * batch_data[pos];
-                                }
-                                pre_calc_index += 1;
-                            }
+                        for (int i = 0; i < taps; i++) {
+                            output_val += w[i] * batch_data[pos[i]];
                         }
                         output_val /= count;
-                        output_data[pool_index] = output_val;
+                        *dst = output_val;
                     }
+                    pos += taps;
+                    w += taps;
                 }
-                batch_data += _in_c_stride;
-                output_data += _out_c_stride;
             }
         }
     }
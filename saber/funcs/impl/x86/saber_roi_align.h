@@ -40,34 +40,13 @@ public:
                              RoiAlignParam<X86> &param,
                              Context<X86> &ctx) {
         this->_ctx = &ctx;
-        Shape out_stride = outputs[0]->get_stride();
-        Shape in_stride = inputs[0]->get_stride();
-        int in_n_index = inputs[0]->num_index();
-        int in_c_index = inputs[0]->channel_index();
-        int in_h_index = inputs[0]->height_index();
-        int in_w_index = inputs[0]->width_index();
-        int out_n_index = outputs[0]->num_index();
-        int out_c_index = outputs[0]->channel_index();
-        int out_h_index = outputs[0]->height_index();
-        int out_w_index = outputs[0]->width_index();
-        _in_n_stride = in_stride[in_n_index];
-        _in_c_stride = in_stride[in_c_index];
-        _in_h_stride = in_stride[in_h_index];
-        _in_w_stride = in_stride[in_w_index];
-        _out_n_stride = out_stride[out_n_index];
-        _out_c_stride = out_stride[out_c_index];
-        _out_h_stride = out_stride[out_h_index];
-        _out_w_stride = out_stride[out_w_index];
-        
-        return SaberSuccess;
+        return create(inputs, outputs, param, ctx);
     }
 
     virtual SaberStatus create(const std::vector<Tensor<X86>*>& inputs,
                                std::vector<Tensor<X86>*>& outputs,
                                RoiAlignParam<X86> &param,
-                               Context<X86> &ctx) {
-        return SaberSuccess;
-    }
+                               Context<X86> &ctx);
 
     virtual SaberStatus dispatch(const std::vector<Tensor<X86>*>& inputs,
                                  std::vector<Tensor<X86>*>& outputs,
@@ -82,6 +61,8 @@ private:
     int _out_c_stride;
     int _out_h_stride;
     int _out_w_stride;
+    //! channel block of NCHW_C8(R)/NCHW_C16(R) inputs, 1 for plain NCHW
+    int _c_block{1};
     const int _prePosROISize = 4;
     const int _kROISize = 5;
     Tensor<X86> _pre_pos;
@@ -3,6 +3,7 @@
 #include "saber/core/common.h"
 #include "saber/core/tensor.h"
 #include "saber/saber_funcs_param.h"
+#include "saber/funcs/impl/x86/nms_helper.h"
 
 namespace anakin {
 namespace saber {
@@ -40,8 +41,6 @@ SaberStatus SaberRPNProposalSSD<X86, AK_FLOAT>::init(
 
     // ADD CPU TENSORS
     _img_info_data_host_tensor = new Tensor<X86>();
-    _prob_data_host_tensor = new Tensor<X86>();
-    _tgt_data_host_tensor = new Tensor<X86>();
     _outputs_boxes_scores_host_tensor = new Tensor<X86>();
 
     return create(inputs, outputs, param, ctx);
@@ -119,21 +118,31 @@ SaberStatus SaberRPNProposalSSD<X86, AK_FLOAT>::dispatch(
     float bsz01 = this->bbox_size_add_one_ ? float(1.0) : float(0.0);
     const int num = inputs[0]->num();
     std::vector<std::vector<BBox<float> > > proposal_batch_vec(outputs.size());
+    std::vector<std::vector<BBox<float> > > proposal_per_img_vec(num);
+    std::vector<std::vector<std::vector<BBox<float> > > > proposal_img_batch_vec(num,
+            std::vector<std::vector<BBox<float> > >(outputs.size()));
+
+    for (int r = 0; r < num_rpns_; ++r) {
+        int prob_idx = 2 * r;
+        int tgt_idx = prob_idx + 1;
+
+        CHECK_EQ(inputs[prob_idx]->num(), num);
+        CHECK_EQ(inputs[tgt_idx]->num(), num);
+        CHECK_EQ(inputs[prob_idx]->channel(), num_anchors_ * 2);
+        CHECK_EQ(inputs[tgt_idx]->channel(), num_anchors_ * 4);
+        CHECK_EQ(inputs[prob_idx]->height(), inputs[tgt_idx]->height());
+        CHECK_EQ(inputs[prob_idx]->width(), inputs[tgt_idx]->width());
+    }
 
+    //! images are independent: decode and nms of each one run in parallel
+#pragma omp parallel for schedule(dynamic)
     for (int i = 0; i < num; ++i) {
-        std::vector<BBox<float> > proposal_cur;
+        std::vector<BBox<float> >& proposal_cur = proposal_per_img_vec[i];
 
         for (int r = 0; r < num_rpns_; ++r) {
             int prob_idx = 2 * r;
             int tgt_idx = prob_idx + 1;
 
-            CHECK_EQ(inputs[prob_idx]->num(), num);
-            CHECK_EQ(inputs[tgt_idx]->num(), num);
-            CHECK_EQ(inputs[prob_idx]->channel(), num_anchors_ * 2);
-            CHECK_EQ(inputs[tgt_idx]->channel(), num_anchors_ * 4);
-            CHECK_EQ(inputs[prob_idx]->height(), inputs[tgt_idx]->height());
-            CHECK_EQ(inputs[prob_idx]->width(), inputs[tgt_idx]->width());
-
             const int map_height = inputs[prob_idx]->height();
             const int map_width  = inputs[prob_idx]->width();
             const int map_size   = map_height * map_width;
@@ -143,15 +152,8 @@ SaberStatus SaberRPNProposalSSD<X86, AK_FLOAT>::dispatch(
             float pad_w_map = 0;
             float cur_map_start_x = 0, cur_map_start_y = 0;
 
-            // These are needed in this situation.
-            _prob_data_host_tensor->reshape(inputs[prob_idx]->valid_shape());
-            _tgt_data_host_tensor->reshape(inputs[tgt_idx]->valid_shape());
-
-            _prob_data_host_tensor->copy_from(*inputs[prob_idx]);
-            _tgt_data_host_tensor->copy_from(*inputs[tgt_idx]);
-
-            const float* prob_data = (const float*)_prob_data_host_tensor->data();
-            const float* tgt_data = (const float*)_tgt_data_host_tensor->data();
+            const float* prob_data = (const float*)inputs[prob_idx]->data();
+            const float* tgt_data = (const float*)inputs[tgt_idx]->data();
 
             for (int a = 0; a < num_anchors_; ++a) {
                 int score_channel  = num_anchors_ + a;
@@ -296,22 +298,13 @@ SaberStatus SaberRPNProposalSSD<X86, AK_FLOAT>::dispatch(
                         CHECK(false);
                     }
 
-                    if (outputs.size() != 0) {
-                        proposal_cur.push_back(bbox);
-                    } else {
-                        bbox.id = 0;
-
-                        for (int c = 0; c < this->num_class_; ++c) {
-                            this->all_candidate_bboxes_[c].push_back(bbox);
-                        }
-                    }
+                    proposal_cur.push_back(bbox);
                 }
             }
         }
 
         if (outputs.size() != 0) {
             // caffe: rpn_proposal_ssd_gpu.cu 317
-            std::vector<NmsBox> simplebox(proposal_cur.size());
             //do nms
             std::vector<bool> sel;
             if (this->nms_use_soft_nms_[0]) {
@@ -323,7 +316,7 @@ SaberStatus SaberRPNProposalSSD<X86, AK_FLOAT>::dispatch(
                                   this->nms_vote_iou_[0]);
                 //LOG(INFO)<<"soft-nms time: "<<tm.MilliSeconds();
             } else {
-                sel = nms_lm(proposal_cur, this->nms_overlap_ratio_[0],
+                sel = nms_lm_x86(proposal_cur, this->nms_overlap_ratio_[0],
                              this->nms_top_n_[0], false, this->nms_max_candidate_n_[0],
                              this->bbox_size_add_one_, this->nms_voting_[0],
                              this->nms_vote_iou_[0]);
@@ -344,7 +337,7 @@ SaberStatus SaberRPNProposalSSD<X86, AK_FLOAT>::dispatch(
                     for (int t = 0; t < outputs.size(); t++) {
                         if (bwxh > this->proposal_min_area_vec_[t]
                             && bwxh < this->proposal_max_area_vec_[t]) {
-                            proposal_batch_vec[t].push_back(proposal_cur[k]);
+                            proposal_img_batch_vec[i][t].push_back(proposal_cur[k]);
                         }
                     }
                 }
@@ -352,6 +345,25 @@ SaberStatus SaberRPNProposalSSD<X86, AK_FLOAT>::dispatch(
         }
     }
 
+    for (int i = 0; i < num; ++i) {
+        if (outputs.size() != 0) {
+            for (int t = 0; t < outputs.size(); t++) {
+                proposal_batch_vec[t].insert(proposal_batch_vec[t].end(),
+                                             proposal_img_batch_vec[i][t].begin(),
+                                             proposal_img_batch_vec[i][t].end());
+            }
+        } else {
+            for (int k = 0; k < proposal_per_img_vec[i].size(); ++k) {
+                BBox<float>& bbox = proposal_per_img_vec[i][k];
+                bbox.id = 0;
+
+                for (int c = 0; c < this->num_class_; ++c) {
+                    this->all_candidate_bboxes_[c].push_back(bbox);
+                }
+            }
+        }
+    }
+
     for (int t = 0; t < outputs.size(); t++) {
         if (proposal_batch_vec[t].empty()) {
             // for special case when there is no box
@@ -391,17 +403,19 @@ SaberStatus SaberRPNProposalSSD<X86, AK_FLOAT>::dispatch(
         /* If this is the last forward for this image, do nms */
         //        if (!is_input_paramid || this->pyramid_image_data_param_.forward_iter_id_ ==
         //                (this->pyramid_image_data_param_.forward_times_for_cur_sample_ - 1))
+#pragma omp parallel for schedule(dynamic)
         for (int class_id = 0; class_id < this->num_class_; ++class_id) {
             std::vector<BBox<float> >& cur_box_list = this->all_candidate_bboxes_[class_id];
             std::vector<BBox<float> >& cur_outbox_list = this->output_bboxes_[class_id];
+            std::vector<bool> is_candidate_bbox_selected;
 
             if (this->nms_use_soft_nms_[class_id]) {
-                this->is_candidate_bbox_selected_ = soft_nms_lm(cur_box_list,
+                is_candidate_bbox_selected = soft_nms_lm(cur_box_list,
                         this->nms_overlap_ratio_[class_id], this->nms_top_n_[class_id],
                         this->nms_max_candidate_n_[class_id], this->bbox_size_add_one_,
                         this->nms_voting_[class_id], this->nms_vote_iou_[class_id]);
             } else {
-                this->is_candidate_bbox_selected_ = nms_lm(cur_box_list,
+                is_candidate_bbox_selected = nms_lm_x86(cur_box_list,
                         this->nms_overlap_ratio_[class_id], this->nms_top_n_[class_id],
                         false, this->nms_max_candidate_n_[class_id], this->bbox_size_add_one_,
                         this->nms_voting_[class_id], this->nms_vote_iou_[class_id]);
@@ -409,8 +423,8 @@ SaberStatus SaberRPNProposalSSD<X86, AK_FLOAT>::dispatch(
 
             cur_outbox_list.clear();
 
-            for (int i = 0; i < this->is_candidate_bbox_selected_.size(); ++i) {
-                if (this->is_candidate_bbox_selected_[i]) {
+            for (int i = 0; i < is_candidate_bbox_selected.size(); ++i) {
+                if (is_candidate_bbox_selected[i]) {
                     int id = im_width_scale.size() > 1 ? cur_box_list[i].id : 0;
                             CHECK_LT(id, im_width_scale.size());
                     cur_box_list[i].x1 = cur_box_list[i].x1
@@ -39,12 +39,6 @@ public:
         if (_img_info_data_host_tensor != NULL) {
             delete _img_info_data_host_tensor;
         }
-        if (_prob_data_host_tensor != NULL) {
-            delete _prob_data_host_tensor;
-        }
-        if (_tgt_data_host_tensor != NULL) {
-            delete _tgt_data_host_tensor;
-        }
         if (_outputs_boxes_scores_host_tensor != NULL) {
             delete _outputs_boxes_scores_host_tensor;
         }
@@ -70,8 +64,6 @@ private:
 
     // ADD CPU TENSORS
     Tensor<X86> *_img_info_data_host_tensor{nullptr};
-    Tensor<X86> *_prob_data_host_tensor{nullptr};
-    Tensor<X86> *_tgt_data_host_tensor{nullptr};
     Tensor<X86> *_outputs_boxes_scores_host_tensor{nullptr};
 
     //caffe pyramid_layers.hpp:615
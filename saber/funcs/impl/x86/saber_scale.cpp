@@ -1,6 +1,7 @@
 
 #include "saber/funcs/impl/x86/saber_scale.h"
 #include <immintrin.h>
+#include <algorithm>
 #include "saber/funcs/impl/x86/saber_avx2_expand.h"
 #include "saber/funcs/timer.h"
 namespace anakin{
@@ -141,6 +142,52 @@ SaberStatus SaberScale<X86, OpDtype>::dispatch(
     const DataType_op* scale_data = (inputs.size() > 1) ? (const DataType_op*)inputs[1]->data() : &(param.scale_w[0]);
     const DataType_op* bias_data = param.bias_term ? &(param.scale_b[0]) : NULL;
 
+    LayoutType layout = inputs[0]->get_layout();
+
+    if (layout == Layout_NCHW_C8R || layout == Layout_NCHW_C16R) {
+        // per channel scale on blocked data, data is [n][c / block][h * w][block]
+        CHECK(param.axis == 1 && param.num_axes == 1) << "blocked layout only support per channel scale";
+        const int block = layout == Layout_NCHW_C8R ? 8 : 16;
+        const int num = inputs[0]->num();
+        const int channel = inputs[0]->channel();
+        const int block_num = (channel + block - 1) / block;
+        const int64_t hw = (int64_t)inputs[0]->height() * inputs[0]->width();
+
+        if (inputs.size() > 1) {
+            CHECK_EQ(channel, inputs[1]->valid_size()) << "scale dim not valid";
+        } else {
+            CHECK_EQ(channel, param.scale_w.size()) << "scale dim not valid";
+        }
+
+        outputs[0]->set_seq_offset(inputs[0]->get_seq_offset());
+
+        #pragma omp parallel for collapse(2) schedule(static)
+
+        for (int n = 0; n < num; n++) {
+            for (int cb = 0; cb < block_num; cb++) {
+                const int64_t offset = ((int64_t)n * block_num + cb) * hw * block;
+                const DataType_op* in_block = in_data + offset;
+                DataType_op* out_block = out_data + offset;
+                DataType_op scale[16] = {0};
+                DataType_op bias[16] = {0};
+                const int valid = std::min(block, channel - cb * block);
+
+                for (int lane = 0; lane < valid; lane++) {
+                    scale[lane] = scale_data[cb * block + lane];
+                    bias[lane] = bias_data != NULL ? bias_data[cb * block + lane] : 0;
+                }
+
+                for (int64_t i = 0; i < hw; i++) {
+                    for (int lane = 0; lane < block; lane++) {
+                        out_block[i * block + lane] = in_block[i * block + lane] * scale[lane] + bias[lane];
+                    }
+                }
+            }
+        }
+
+        return SaberSuccess;
+    }
+
     const int count = inputs[0]->valid_size();
     int axis = (param.num_axes == 0) ? 0 : param.axis;
     int num_axes = param.num_axes >=0 ? param.num_axes : inputs[0]->shape().dims() - axis;
@@ -29,6 +29,11 @@ SaberStatus SaberSlice<X86, OpDtype>::dispatch(\
         const int out_slice_axis_size = outputs[i]->valid_shape()[param.axis];
         const int out_slice_size = out_slice_axis_size * _slice_size;
         const int slice_count = out_slice_size * _slice_num;
+        if (_slice_num == 1 && out_data == in_data + offset_slice_axis * _slice_size) {
+            //! the output is a view of the input, see Net::set_inplace_concat
+            offset_slice_axis += out_slice_axis_size;
+            continue;
+        }
 #pragma omp parallel for schedule(static)
         for(int j = 0; j < slice_count; ++j){
             const int _num_slice = j / out_slice_size;
@@ -1,6 +1,9 @@
 #include "saber/funcs/impl/x86/saber_softmax.h"
 #include <cmath>
+#include <limits>
 #include "saber/funcs/impl/x86/saber_avx2_funcs.h"
+#include "saber/funcs/impl/x86/saber_avx2_math.h"
+#include "saber/funcs/impl/x86/saber_avx512_math.h"
 #include "mkl_cblas.h"
 #include "mkl_vml_functions.h"
 #include "saber/funcs/impl/x86/kernel/jit_generator.h"
@@ -41,6 +44,25 @@ SaberStatus SaberSoftmax<X86, OpDtype>::create(
     if (inputs[0]->get_dtype() != AK_FLOAT) {
         utils::try_expand_tensor(_input_scale, inputs[0]->valid_shape());
     }
+
+    _mask_outer_stride.clear();
+    if (inputs.size() > 1) {
+        Shape shape_mask = inputs[1]->valid_shape();
+        CHECK_EQ(inputs[1]->get_dtype(), AK_FLOAT) << "softmax mask must be float";
+        CHECK_EQ(shape_mask.size(), shape_in.size()) << "softmax mask must have the input dims";
+        CHECK(inputs[1]->is_continue_mem()) << "softmax mask must be continuous";
+        for (int i = param.axis; i < shape_in.size(); ++i) {
+            CHECK_EQ(shape_mask[i], shape_in[i]) << "softmax mask only broadcasts before axis";
+        }
+        _mask_outer_stride.resize(param.axis);
+        int stride = _axis_size * _inner_num;
+        for (int i = param.axis - 1; i >= 0; --i) {
+            CHECK(shape_mask[i] == 1 || shape_mask[i] == shape_in[i])
+                    << "softmax mask dim " << i << " can not broadcast";
+            _mask_outer_stride[i] = shape_mask[i] == 1 ? 0 : stride;
+            stride *= shape_mask[i];
+        }
+    }
     return SaberSuccess;
 }
 
@@ -98,6 +120,216 @@ void _scal(int n, dtype alpha, dtype* x) {
 
 
 
+
+//! softmax along a strided axis for a single inner position
+inline void softmax_strided_lane(const float* in, const float* mask, float scale,
+                                 int axis_size, int stride, float* out) {
+    float max_val = std::numeric_limits<float>::lowest();
+    for (int i = 0; i < axis_size; ++i) {
+        float x = in[i * stride] * scale + (mask != nullptr ? mask[i * stride] : 0.f);
+        out[i * stride] = x;
+        max_val = std::max(max_val, x);
+    }
+    float sum = 0.f;
+    for (int i = 0; i < axis_size; ++i) {
+        out[i * stride] = expf(out[i * stride] - max_val);
+        sum += out[i * stride];
+    }
+    float rsum = 1.f / sum;
+    for (int i = 0; i < axis_size; ++i) {
+        out[i * stride] *= rsum;
+    }
+}
+
+#if defined(__AVX512F__)
+#define SOFTMAX_VEC_SIZE 16
+#elif defined(__AVX2__) and defined(__FMA__)
+#define SOFTMAX_VEC_SIZE 8
+#else
+#define SOFTMAX_VEC_SIZE 1
+#endif
+
+//! elements of a row that are scaled, reduced and exponentiated while in L1
+const int SOFTMAX_BLOCK = 512;
+
+/**
+ * out = in * scale + mask for a block of a row, returns its max.
+ */
+inline float softmax_block_prepare(const float* in, const float* mask, float scale,
+                                   int len, float* out) {
+    int i = 0;
+    float max_val = std::numeric_limits<float>::lowest();
+#if defined(__AVX512F__)
+    __m512 scale_v = _mm512_set1_ps(scale);
+    __m512 max_v = _mm512_set1_ps(max_val);
+    for (; i + 16 <= len; i += 16) {
+        __m512 x = _mm512_mul_ps(_mm512_loadu_ps(in + i), scale_v);
+        if (mask != nullptr) {
+            x = _mm512_add_ps(x, _mm512_loadu_ps(mask + i));
+        }
+        _mm512_storeu_ps(out + i, x);
+        max_v = _mm512_max_ps(max_v, x);
+    }
+    max_val = _mm512_reduce_max_ps(max_v);
+#elif defined(__AVX2__) and defined(__FMA__)
+    __m256 scale_v = _mm256_set1_ps(scale);
+    __m256 max_v = _mm256_set1_ps(max_val);
+    for (; i + 8 <= len; i += 8) {
+        __m256 x = _mm256_mul_ps(_mm256_loadu_ps(in + i), scale_v);
+        if (mask != nullptr) {
+            x = _mm256_add_ps(x, _mm256_loadu_ps(mask + i));
+        }
+        _mm256_storeu_ps(out + i, x);
+        max_v = _mm256_max_ps(max_v, x);
+    }
+    __m128 max_4 = _mm_max_ps(_mm256_castps256_ps128(max_v), _mm256_extractf128_ps(max_v, 1));
+    max_4 = _mm_max_ps(max_4, _mm_movehl_ps(max_4, max_4));
+    max_4 = _mm_max_ss(max_4, _mm_shuffle_ps(max_4, max_4, 1));
+    max_val = _mm_cvtss_f32(max_4);
+#endif
+    for (; i < len; ++i) {
+        float x = in[i] * scale + (mask != nullptr ? mask[i] : 0.f);
+        out[i] = x;
+        max_val = std::max(max_val, x);
+    }
+    return max_val;
+}
+
+//! x = exp(x - max) in place, returns the sum
+inline float softmax_block_exp(float* x, int len, float max_val) {
+    int i = 0;
+    float sum = 0.f;
+#if defined(__AVX512F__)
+    __m512 max_v = _mm512_set1_ps(max_val);
+    __m512 sum_v = _mm512_setzero_ps();
+    for (; i + 16 <= len; i += 16) {
+        __m512 e = exp512_ps_fma(_mm512_sub_ps(_mm512_loadu_ps(x + i), max_v));
+        _mm512_storeu_ps(x + i, e);
+        sum_v = _mm512_add_ps(sum_v, e);
+    }
+    sum = _mm512_reduce_add_ps(sum_v);
+#elif defined(__AVX2__) and defined(__FMA__)
+    __m256 max_v = _mm256_set1_ps(max_val);
+    __m256 sum_v = _mm256_setzero_ps();
+    for (; i + 8 <= len; i += 8) {
+        __m256 e = exp256_ps_fma(_mm256_sub_ps(_mm256_loadu_ps(x + i), max_v));
+        _mm256_storeu_ps(x + i, e);
+        sum_v = _mm256_add_ps(sum_v, e);
+    }
+    __m128 sum_4 = _mm_add_ps(_mm256_castps256_ps128(sum_v), _mm256_extractf128_ps(sum_v, 1));
+    sum_4 = _mm_hadd_ps(sum_4, sum_4);
+    sum_4 = _mm_hadd_ps(sum_4, sum_4);
+    sum = _mm_cvtss_f32(sum_4);
+#endif
+    for (; i < len; ++i) {
+        x[i] = expf(x[i] - max_val);
+        sum += x[i];
+    }
+    return sum;
+}
+
+inline void softmax_block_scal(float* x, int len, float alpha) {
+    int i = 0;
+#if defined(__AVX512F__)
+    __m512 alpha_v = _mm512_set1_ps(alpha);
+    for (; i + 16 <= len; i += 16) {
+        _mm512_storeu_ps(x + i, _mm512_mul_ps(_mm512_loadu_ps(x + i), alpha_v));
+    }
+#elif defined(__AVX2__) and defined(__FMA__)
+    __m256 alpha_v = _mm256_set1_ps(alpha);
+    for (; i + 8 <= len; i += 8) {
+        _mm256_storeu_ps(x + i, _mm256_mul_ps(_mm256_loadu_ps(x + i), alpha_v));
+    }
+#endif
+    for (; i < len; ++i) {
+        x[i] *= alpha;
+    }
+}
+
+/**
+ * softmax of one contiguous row in two passes. the first pass keeps a running
+ * max and sum, each block is exponentiated against the max seen so far and the
+ * sum is rescaled when the max grows; the second pass corrects every block by
+ * exp(block max - row max) / sum. block_max holds one float per block.
+ */
+void softmax_row(const float* in, const float* mask, float scale, int len,
+                 float* out, float* block_max) {
+    float max_val = std::numeric_limits<float>::lowest();
+    float sum = 0.f;
+    int block_num = (len + SOFTMAX_BLOCK - 1) / SOFTMAX_BLOCK;
+    for (int b = 0; b < block_num; ++b) {
+        int offset = b * SOFTMAX_BLOCK;
+        int block_len = std::min(SOFTMAX_BLOCK, len - offset);
+        float cur_max = softmax_block_prepare(in + offset,
+                                              mask == nullptr ? nullptr : mask + offset,
+                                              scale, block_len, out + offset);
+        if (cur_max > max_val) {
+            sum *= expf(max_val - cur_max);
+            max_val = cur_max;
+        }
+        sum += softmax_block_exp(out + offset, block_len, max_val);
+        block_max[b] = max_val;
+    }
+    for (int b = 0; b < block_num; ++b) {
+        int offset = b * SOFTMAX_BLOCK;
+        int block_len = std::min(SOFTMAX_BLOCK, len - offset);
+        softmax_block_scal(out + offset, block_len, expf(block_max[b] - max_val) / sum);
+    }
+}
+
+/**
+ * softmax along a strided axis for SOFTMAX_VEC_SIZE adjacent inner positions,
+ * the lanes of a vector are independent softmax rows.
+ */
+void softmax_lanes(const float* in, const float* mask, float scale, int axis_size,
+                   int stride, float* out) {
+#if defined(__AVX512F__)
+    __m512 scale_v = _mm512_set1_ps(scale);
+    __m512 max_v = _mm512_set1_ps(std::numeric_limits<float>::lowest());
+    for (int i = 0; i < axis_size; ++i) {
+        __m512 x = _mm512_mul_ps(_mm512_loadu_ps(in + i * stride), scale_v);
+        if (mask != nullptr) {
+            x = _mm512_add_ps(x, _mm512_loadu_ps(mask + i * stride));
+        }
+        _mm512_storeu_ps(out + i * stride, x);
+        max_v = _mm512_max_ps(max_v, x);
+    }
+    __m512 sum_v = _mm512_setzero_ps();
+    for (int i = 0; i < axis_size; ++i) {
+        __m512 e = exp512_ps_fma(_mm512_sub_ps(_mm512_loadu_ps(out + i * stride), max_v));
+        _mm512_storeu_ps(out + i * stride, e);
+        sum_v = _mm512_add_ps(sum_v, e);
+    }
+    __m512 rsum_v = _mm512_div_ps(_mm512_set1_ps(1.f), sum_v);
+    for (int i = 0; i < axis_size; ++i) {
+        _mm512_storeu_ps(out + i * stride, _mm512_mul_ps(_mm512_loadu_ps(out + i * stride), rsum_v));
+    }
+#elif defined(__AVX2__) and defined(__FMA__)
+    __m256 scale_v = _mm256_set1_ps(scale);
+    __m256 max_v = _mm256_set1_ps(std::numeric_limits<float>::lowest());
+    for (int i = 0; i < axis_size; ++i) {
+        __m256 x = _mm256_mul_ps(_mm256_loadu_ps(in + i * stride), scale_v);
+        if (mask != nullptr) {
+            x = _mm256_add_ps(x, _mm256_loadu_ps(mask + i * stride));
+        }
+        _mm256_storeu_ps(out + i * stride, x);
+        max_v = _mm256_max_ps(max_v, x);
+    }
+    __m256 sum_v = _mm256_setzero_ps();
+    for (int i = 0; i < axis_size; ++i) {
+        __m256 e = exp256_ps_fma(_mm256_sub_ps(_mm256_loadu_ps(out + i * stride), max_v));
+        _mm256_storeu_ps(out + i * stride, e);
+        sum_v = _mm256_add_ps(sum_v, e);
+    }
+    __m256 rsum_v = _mm256_div_ps(_mm256_set1_ps(1.f), sum_v);
+    for (int i = 0; i < axis_size; ++i) {
+        _mm256_storeu_ps(out + i * stride, _mm256_mul_ps(_mm256_loadu_ps(out + i * stride), rsum_v));
+    }
+#else
+    softmax_strided_lane(in, mask, scale, axis_size, stride, out);
+#endif
+}
+
 template <DataType OpDtype>
 SaberStatus SaberSoftmax<X86, OpDtype>::dispatch(
     const std::vector<DataTensor_in*>& inputs,
@@ -130,21 +362,62 @@ SaberStatus SaberSoftmax<X86, OpDtype>::dispatch(
     }else{
         LOG(INFO)<<"not support input "<<inputs[0]->get_dtype();
     }
-    if (avx2_can_used()){
+    const float* mask_ptr = inputs.size() > 1 ? static_cast<const float*>(inputs[1]->data()) : nullptr;
+    float scale = param.scale;
+    // offset of the mask row used by an outer index, the mask broadcasts before axis
+    auto mask_offset = [&](int outer_id) {
+        int offset = 0;
+        for (int i = axis - 1; i >= 0; --i) {
+            offset += (outer_id % sh_in[i]) * _mask_outer_stride[i];
+            outer_id /= sh_in[i];
+        }
+        return offset;
+    };
+
+    bool vec_used = true;
 #if defined(__AVX2__) and defined(__FMA__)
-#pragma omp parallel for schedule(static) if(outer_dim>1)
-        for(int outer_id=0; outer_id<outer_dim; outer_id++){
-            const float* src_data_outer = src_ptr + outer_id * axis_size*inner_dim;
-            float* dst_data_outer = dst_ptr + outer_id * axis_size*inner_dim;
-            if (inner_dim == 1){
-                avx2_vector_softmax(src_data_outer, axis_size, dst_data_outer);
-            }else{
-                avx2_vector_softmax_stride(src_data_outer, inner_dim, axis_size, dst_data_outer);
+    vec_used = avx2_can_used();
+#endif
+    bool continue_mem = outputs[0]->is_continue_mem()
+                        && (inputs[0]->is_continue_mem() || inputs[0]->get_dtype() != AK_FLOAT);
+
+    if (vec_used && continue_mem) {
+        if (inner_dim == 1) {
+            int block_num = (axis_size + SOFTMAX_BLOCK - 1) / SOFTMAX_BLOCK;
+#pragma omp parallel if (outer_dim > 1)
+            {
+                std::vector<float> block_max(block_num);
+#pragma omp for schedule(static)
+                for (int outer_id = 0; outer_id < outer_dim; ++outer_id) {
+                    const float* mask_row = mask_ptr == nullptr ? nullptr : mask_ptr + mask_offset(outer_id);
+                    softmax_row(src_ptr + outer_id * axis_size, mask_row, scale, axis_size,
+                                dst_ptr + outer_id * axis_size, block_max.data());
+                }
+            }
+        } else {
+            // full vectors of inner positions first, then the remaining positions one by one
+            int vec_chunks = inner_dim / SOFTMAX_VEC_SIZE;
+            int chunks = vec_chunks + inner_dim % SOFTMAX_VEC_SIZE;
+#pragma omp parallel for collapse(2) schedule(static) if (outer_dim * chunks > 1)
+            for (int outer_id = 0; outer_id < outer_dim; ++outer_id) {
+                for (int chunk = 0; chunk < chunks; ++chunk) {
+                    int inner_id = chunk < vec_chunks ? chunk * SOFTMAX_VEC_SIZE
+                                   : vec_chunks * SOFTMAX_VEC_SIZE + chunk - vec_chunks;
+                    int offset = outer_id * axis_size * inner_dim + inner_id;
+                    const float* mask_data = mask_ptr == nullptr ? nullptr
+                                             : mask_ptr + mask_offset(outer_id) + inner_id;
+                    if (chunk < vec_chunks) {
+                        softmax_lanes(src_ptr + offset, mask_data, scale, axis_size, inner_dim,
+                                      dst_ptr + offset);
+                    } else {
+                        softmax_strided_lane(src_ptr + offset, mask_data, scale, axis_size, inner_dim,
+                                             dst_ptr + offset);
+                    }
+                }
             }
         }
-#endif
     } else {
-        const OpDataType *data_in = (const OpDataType *) inputs[0]->data();
+        const OpDataType *data_in = (const OpDataType *) src_ptr;
         OpDataType *data_out = (OpDataType *) outputs[0]->mutable_data();
         OpDataType *max_data = (OpDataType *) this->_max_data.mutable_data();
         const int *input_stride = (const int *) _input_stride.data();
@@ -154,6 +427,8 @@ SaberStatus SaberSoftmax<X86, OpDtype>::dispatch(
         for (int num = 0; num < total_num; ++num) {
             int num_tmp = num;
             int in_index = 0, out_index = 0;
+            const float* mask_data = mask_ptr == nullptr ? nullptr
+                                     : mask_ptr + mask_offset(num / _inner_num) + num % _inner_num;
 
             for (int i = _dims - 1; i >= 0; --i) {
                 if (i == axis) {
@@ -169,16 +444,17 @@ SaberStatus SaberSoftmax<X86, OpDtype>::dispatch(
             OpDataType max = std::numeric_limits<OpDataType>::lowest();
 
             for (int i = 0; i < _axis_size; ++i) {
-                max = data_in[in_index] > max ? data_in[in_index] : max;
+                max_data[i] = data_in[in_index] * scale
+                              + (mask_data != nullptr ? mask_data[i * _inner_num] : 0.f);
+                max = max_data[i] > max ? max_data[i] : max;
                 in_index += input_stride[axis];
             }
 
             OpDataType sum = (OpDataType) 0;
 
             for (int i = 0; i < _axis_size; ++i) {
-                in_index -= input_stride[axis];
-                max_data[_axis_size - i - 1] = expf(data_in[in_index] - max);
-                sum += max_data[_axis_size - i - 1];
+                max_data[i] = expf(max_data[i] - max);
+                sum += max_data[i];
             }
 
             for (int i = 0; i < _axis_size; ++i) {
@@ -188,7 +464,6 @@ SaberStatus SaberSoftmax<X86, OpDtype>::dispatch(
         }
     }
 
-
     return SaberSuccess;
 }
 template class SaberSoftmax<X86, AK_FLOAT>;
@@ -58,6 +58,8 @@ private:
     Tensor<X86> _output_stride;
     Tensor<X86> _max_data;
     Tensor<X86> _input_scale;
+    //! strides of the mask input over the axes before axis, 0 where it broadcasts
+    std::vector<int> _mask_outer_stride;
 };
 
 }
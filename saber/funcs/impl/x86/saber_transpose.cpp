@@ -1,4 +1,5 @@
 #include "saber/funcs/impl/x86/saber_transpose.h"
+#include "saber/funcs/impl/x86/permute_helper.h"
 #include <math.h>
 
 namespace anakin {
@@ -34,15 +35,9 @@ SaberStatus SaberTranspose<X86, OpDtype>::dispatch(\
     const InDataType* in_data = (const InDataType*)inputs[0]->data();
     OutDataType* out_data = (OutDataType*)outputs[0]->mutable_data();
 
-    for(int k = 0; k < n_in * c_in; ++k){  
-        for(int j = 0; j < h_in; ++j){
-            for(int i = 0; i < w_in; ++i){
-                out_data[i * w_out + j] = in_data[j * w_in + i];
-            }
-        }
-        in_data += h_in * w_in;
-        out_data += h_out * w_out;
-    }
+    // every (n, c) plane is transposed, the planes are contiguous
+    permute_x86(in_data, out_data, {n_in * c_in, h_in, w_in}, {0, 2, 1},
+                {h_in * w_in, w_in, 1}, {h_out * w_out, w_out, 1});
 
     return SaberSuccess;
 }
@@ -1,5 +1,8 @@
 #include "saber/funcs/impl/x86/vender_fc.h"
 #include "saber/funcs/impl/x86/x86_utils.h"
+#include "saber/funcs/impl/x86/half_convert_helper.h"
+#include "saber/funcs/impl/x86/kernel/jit_generator.h"
+#include "saber/funcs/impl/x86/saber_avx2_funcs.h"
 #include "mkl_cblas.h"
 #include "mkl_vml_functions.h"
 #include "tensor_op.h"
@@ -9,6 +12,182 @@ namespace saber {
 
 typedef MKL_INT cblas_int;
 
+namespace {
+
+//! fc weights reordered to match a c8r input, T is float or the 16 bit half types
+template <typename T>
+void trans_weights_nchw_to_c8r(const T* in_weights, T* out_weights, const int oc_value,
+                               const int oc_stride, const int c_value_div_8, const int hw_value) {
+    for (int oc = 0; oc < oc_value; oc++) {
+        for (int ic_div_8 = 0; ic_div_8 < c_value_div_8; ic_div_8++) {
+            for (int hw = 0; hw < hw_value; hw++) {
+                for (int inner_c = 0; inner_c < 8; inner_c++) {
+                    int out_index = oc * oc_stride + ic_div_8 * hw_value * 8 + hw * 8 + inner_c;
+                    int in_index = oc * oc_stride + (ic_div_8 * 8 + inner_c) * hw_value + hw;
+                    out_weights[out_index] = in_weights[in_index];
+                }
+            }
+        }
+    }
+}
+
+//! fc weights reordered to match a nhwc input
+template <typename T>
+void trans_weights_nchw_to_nhwc(const T* in_weights, T* out_weights, const int oc_value,
+                                const int oc_stride, const int ic_value, const int hw_value) {
+    for (int oc = 0; oc < oc_value; oc++) {
+        for (int hw = 0; hw < hw_value; hw++) {
+            for (int ic = 0; ic < ic_value; ic++) {
+                int out_index = oc * oc_stride + hw * ic_value + ic;
+                int in_index = oc * oc_stride + ic * hw_value + hw;
+                out_weights[out_index] = in_weights[in_index];
+            }
+        }
+    }
+}
+
+//! output bytes a thread keeps for the epilogue of its gemm tile, about half of a l2
+const int fc_tile_bytes = 256 * 1024;
+//! fewer rows make the gemm of a tile too small to run at full speed
+const int fc_min_tile_rows = 16;
+
+bool fc_epilogue_supported(const ActivationParam<X86>& act) {
+    if (!act.has_active) {
+        return true;
+    }
+
+    switch (act.active) {
+    case Active_relu:
+    case Active_sigmoid:
+    case Active_tanh:
+    case Active_clipped_relu:
+    case Active_elu:
+    case Active_gelu:
+    case Active_stanh:
+    case Active_swish:
+    case Active_identity:
+        return true;
+
+    case Active_prelu:
+        return act.prelu_param.slope != nullptr;
+
+    default:
+        return false;
+    }
+}
+
+//! dst = act(dst + bias + residual) on rows x oc of the fc output, one row at a time
+//! so each row is read once and stays in l1, bias and residual may be null
+void fc_epilogue(float* dst, const float* bias, const float* residual, int rows, int oc,
+                 const ActivationParam<X86>& act) {
+    ActiveType type = act.has_active ? act.active : Active_identity;
+    const bool leaky = type == Active_relu && act.negative_slope != 0.f;
+#if defined(SABER_WITH_AVX2_FUNCS)
+    static const bool use_avx2 = avx2_can_used();
+
+    if (use_avx2 && !leaky && (type == Active_relu || type == Active_sigmoid
+                               || type == Active_tanh || type == Active_identity)) {
+        for (int i = 0; i < rows; ++i) {
+            avx2_bias_residual_act(dst + (size_t)i * oc, bias,
+                                   residual != nullptr ? residual + (size_t)i * oc : nullptr, oc, type);
+        }
+
+        return;
+    }
+
+#endif
+    const float* slope = type == Active_prelu ?
+                         static_cast<const float*>(act.prelu_param.slope->data()) : nullptr;
+    const bool slope_shared = type == Active_prelu && act.prelu_param.channel_shared;
+
+    for (int i = 0; i < rows; ++i) {
+        float* out = dst + (size_t)i * oc;
+        const float* res = residual != nullptr ? residual + (size_t)i * oc : nullptr;
+
+        if (bias != nullptr) {
+            for (int j = 0; j < oc; ++j) {
+                out[j] += bias[j];
+            }
+        }
+
+        if (res != nullptr) {
+            for (int j = 0; j < oc; ++j) {
+                out[j] += res[j];
+            }
+        }
+
+        switch (type) {
+        case Active_relu:
+            for (int j = 0; j < oc; ++j) {
+                out[j] = out[j] > 0.f ? out[j] : out[j] * act.negative_slope;
+            }
+
+            break;
+
+        case Active_sigmoid:
+            for (int j = 0; j < oc; ++j) {
+                out[j] = 1.f / (1.f + expf(-out[j]));
+            }
+
+            break;
+
+        case Active_tanh:
+            for (int j = 0; j < oc; ++j) {
+                out[j] = tanhf(out[j]);
+            }
+
+            break;
+
+        case Active_clipped_relu:
+            for (int j = 0; j < oc; ++j) {
+                out[j] = std::min(std::max(out[j], 0.f), act.coef);
+            }
+
+            break;
+
+        case Active_elu:
+            for (int j = 0; j < oc; ++j) {
+                out[j] = out[j] > 0.f ? out[j] : act.coef * (expf(out[j]) - 1.f);
+            }
+
+            break;
+
+        case Active_gelu:
+            for (int j = 0; j < oc; ++j) {
+                out[j] = out[j] * 0.5f * (erff(out[j] * (float)M_SQRT1_2) + 1.f);
+            }
+
+            break;
+
+        case Active_stanh:
+            for (int j = 0; j < oc; ++j) {
+                out[j] = act.coef * tanhf(act.negative_slope * out[j]);
+            }
+
+            break;
+
+        case Active_swish:
+            for (int j = 0; j < oc; ++j) {
+                out[j] = out[j] / (1.f + expf(-act.coef * out[j]));
+            }
+
+            break;
+
+        case Active_prelu:
+            for (int j = 0; j < oc; ++j) {
+                out[j] = out[j] > 0.f ? out[j] : out[j] * slope[slope_shared ? 0 : j];
+            }
+
+            break;
+
+        default:
+            break;
+        }
+    }
+}
+
+} // namespace
+
 template <>
 void VenderFc<X86, AK_FLOAT>::clean() {
     if (bias_sum) {
@@ -40,6 +219,27 @@ SaberStatus VenderFc<X86, AK_FLOAT>
     MB = inputs[0]->count_valid(0, param.axis);
     OC = outputs[0]->channel();
 
+    if (param.residual) {
+        CHECK_EQ(inputs.back()->valid_size(), outputs[0]->valid_size())
+                << "fc residual input must have the output shape";
+    }
+
+    // with enough rows every thread runs a sequential gemm on its own row tiles and the
+    // epilogue of a tile right after it, otherwise one threaded gemm runs on all rows
+    int threads = anakin_get_max_threads();
+    int cache_rows = std::max(1, fc_tile_bytes / (OC * (int)sizeof(float)));
+    _tile_rows = std::max(fc_min_tile_rows, std::min(cache_rows, utils::div_up(MB, threads)));
+    _num_tiles = utils::div_up(MB, _tile_rows);
+
+    if (_num_tiles < threads) {
+        _tile_rows = MB;
+        _num_tiles = 1;
+    }
+
+    if (_dynamic_quant || _half_weights) {
+        return SaberSuccess;
+    }
+
     // weights
     for (int i = packed_weights.size() - 1; i >= 0; i--) {
         cblas_sgemm_free(packed_weights[i]);
@@ -55,7 +255,7 @@ SaberStatus VenderFc<X86, AK_FLOAT>
 
     int total_IC = 0;
 
-    for (int i = 0; i < inputs.size(); i++) {
+    for (int i = 0; i < _gemm_inputs; i++) {
         cblas_int IC = inputs[i]->count_valid(param.axis, inputs[i]->dims());
         packed_weights.push_back(cblas_sgemm_alloc(CblasAMatrix, OC, MB, IC));
         // LOG(INFO) << "anakin input[" << i << "] alloc passed";
@@ -70,7 +270,7 @@ SaberStatus VenderFc<X86, AK_FLOAT>
         // LOG(INFO) << "anakin input[" << i << "] pack passed";
     }
 
-    CHECK_EQ(inputs.size(), 1);
+    CHECK_EQ(_gemm_inputs, 1);
 
     if (inputs[0]->get_dtype() != AK_FLOAT) {
         utils::try_expand_tensor(_input_scale, inputs[0]->valid_shape());
@@ -91,46 +291,40 @@ SaberStatus VenderFc<X86, AK_FLOAT>
     if (in_layout == Layout_NCHW_C8R && out_layout == Layout_NCHW) {
         CHECK(inputs[0]->channel() % 8 == 0) << "only support channel div 8 == 0";
         _need_weights_trans = true;
-        _weights_trans.re_alloc(param.weights->valid_shape());
+        _weights_trans.re_alloc(param.weights->valid_shape(), param.weights->get_dtype());
         int oc_value = param.weights->height();
         int oc_stride = param.weights->width();
         int ic_value = inputs[0]->channel();
         int c_value_div_8 = ic_value / 8;
         int hw_value = inputs[0]->height() * inputs[0]->width();
-        float* out_weights = static_cast<float*>(_weights_trans.mutable_data());
-        const float* in_weights = static_cast<const float*>(param.weights->data());
-
-        for (int oc = 0; oc < oc_value; oc++) {
-            for (int ic_div_8 = 0; ic_div_8 < c_value_div_8; ic_div_8++) {
-                for (int hw = 0; hw < hw_value; hw++) {
-                    for (int inner_c = 0; inner_c < 8; inner_c++) {
-                        int out_index = oc * oc_stride + ic_div_8 * hw_value * 8 + hw * 8 + inner_c;
-                        int in_index = oc * oc_stride + (ic_div_8 * 8 + inner_c) * hw_value + hw;
-                        out_weights[out_index] = in_weights[in_index];
-                    }
-                }
-            }
+
+        if (is_half_dtype(param.weights->get_dtype())) {
+            trans_weights_nchw_to_c8r(static_cast<const uint16_t*>(param.weights->data()),
+                                      static_cast<uint16_t*>(_weights_trans.mutable_data()),
+                                      oc_value, oc_stride, c_value_div_8, hw_value);
+        } else {
+            trans_weights_nchw_to_c8r(static_cast<const float*>(param.weights->data()),
+                                      static_cast<float*>(_weights_trans.mutable_data()),
+                                      oc_value, oc_stride, c_value_div_8, hw_value);
         }
 
         DLOG(INFO) << "ak trans weights nchw  to c8r";
     } else if (in_layout == Layout_NHWC && out_layout == Layout_NCHW) {
         _need_weights_trans = true;
-        _weights_trans.re_alloc(param.weights->valid_shape());
+        _weights_trans.re_alloc(param.weights->valid_shape(), param.weights->get_dtype());
         int oc_value = param.weights->height();
         int oc_stride = param.weights->width();
         int ic_value = inputs[0]->channel();
         int hw_value = inputs[0]->height() * inputs[0]->width();
-        float* out_weights = static_cast<float*>(_weights_trans.mutable_data());
-        const float* in_weights = static_cast<const float*>(param.weights->data());
 
-        for (int oc = 0; oc < oc_value; oc++) {
-            for (int hw = 0; hw < hw_value; hw++) {
-                for (int ic = 0; ic < ic_value; ic++) {
-                    int out_index = oc * oc_stride + hw * ic_value + ic;
-                    int in_index = oc * oc_stride + ic * hw_value + hw;
-                    out_weights[out_index] = in_weights[in_index];
-                }
-            }
+        if (is_half_dtype(param.weights->get_dtype())) {
+            trans_weights_nchw_to_nhwc(static_cast<const uint16_t*>(param.weights->data()),
+                                       static_cast<uint16_t*>(_weights_trans.mutable_data()),
+                                       oc_value, oc_stride, ic_value, hw_value);
+        } else {
+            trans_weights_nchw_to_nhwc(static_cast<const float*>(param.weights->data()),
+                                       static_cast<float*>(_weights_trans.mutable_data()),
+                                       oc_value, oc_stride, ic_value, hw_value);
         }
 
         DLOG(INFO) << "ak trans weights nchw to nchwc";
@@ -143,12 +337,43 @@ SaberStatus VenderFc<X86, AK_FLOAT>
                    outputs[0]->get_layout();
     }
 
-    CHECK_EQ(inputs.size(), 1);
+    _gemm_inputs = inputs.size() - (param.residual ? 1 : 0);
+    CHECK_EQ(_gemm_inputs, 1);
+
+    if (!fc_epilogue_supported(param.activation_param)) {
+        LOG(ERROR) << "fc does not fuse activation " << param.activation_param.active;
+        return SaberUnImplError;
+    }
+
+    _has_epilogue = param.residual || param.activation_param.has_active;
 
     if (inputs[0]->get_dtype() != AK_FLOAT) {
         _input_scale.re_alloc(inputs[0]->valid_shape(), AK_FLOAT);
     }
 
+    _dynamic_quant = param.dynamic_quant && inputs[0]->get_dtype() == AK_FLOAT;
+    _half_weights = is_half_dtype(param.weights->get_dtype());
+
+    if (_half_weights) {
+        CHECK(!_dynamic_quant) << "dynamic quant fc needs fp32 weights";
+        // weights are oc x ic, or ic x oc when transposed
+        int n = outputs[0]->channel();
+        int k = inputs[0]->count_valid(param.axis, inputs[0]->dims());
+        Tensor<X86>& weights = _need_weights_trans ? _weights_trans : *param.weights;
+        _half_gemm.init(!param.is_transpose_weights, n, k, weights.data(),
+                        param.is_transpose_weights ? n : k,
+                        weights.get_dtype(), weights.get_dtype());
+    }
+
+    if (_dynamic_quant) {
+        // weights are oc x ic, or ic x oc when transposed
+        int m = inputs[0]->count_valid(0, param.axis);
+        int n = outputs[0]->channel();
+        int k = inputs[0]->count_valid(param.axis, inputs[0]->dims());
+        Tensor<X86>& weights = _need_weights_trans ? _weights_trans : *param.weights;
+        _packed_int8_gemm.init(false, !param.is_transpose_weights, m, n, k, weights, 1.f, true);
+    }
+
     return create(inputs, outputs, param, ctx);
 }
 
@@ -161,61 +386,79 @@ SaberStatus VenderFc<X86, AK_FLOAT>
 
     float* dst = (float*)outputs[0]->mutable_data();
     const float* bias = NULL;
+    const float* residual = param.residual ? static_cast<const float*>(inputs.back()->data()) : nullptr;
 
     if (param.bias) {
         bias = (const float*)param.bias->data();
     }
 
-    for (int i = 0; i < inputs.size(); i++) {
+    const float* src = nullptr;
 
-        const float* src = nullptr;
+    if (inputs[0]->get_dtype() == AK_FLOAT) {
+        src = static_cast<const float*>(inputs[0]->data());
+    } else if (inputs[0]->get_dtype() == AK_UINT8) {
+        DLOG(INFO) << "dispatch convert uint8 fp32";
+        utils::ScaleUtils::scale_uint8_fp32(_input_scale, *inputs[0]);
+        src = static_cast<const float*>(_input_scale.data());
+    }
 
-        if (inputs[i]->get_dtype() == AK_FLOAT) {
-            src = static_cast<const float*>(inputs[i]->data());
-        } else if (inputs[i]->get_dtype() == AK_UINT8) {
-            DLOG(INFO) << "dispatch convert uint8 fp32";
-            utils::ScaleUtils::scale_uint8_fp32(_input_scale, *inputs[i]);
-            src = static_cast<const float*>(_input_scale.data());
-        }
+    cblas_int IC = inputs[0]->count_valid(param.axis, inputs[0]->dims());
 
+    if (_dynamic_quant || _half_weights) {
+        // bias is added by the gemm, the rest of the epilogue runs after it
+        SaberStatus status = _dynamic_quant ? _packed_int8_gemm.dispatch(MB, src, dst, bias)
+                             : _half_gemm.dispatch(MB, src, IC, dst, OC, bias);
 
-        cblas_int IC = inputs[i]->count_valid(param.axis, inputs[i]->dims());
+        if (status != SaberSuccess || !_has_epilogue) {
+            return status;
+        }
 
-        if (i == 0) {
-            // C := alpha * op(A) * op(B) + beta * C
-            cblas_sgemm_compute(CblasColMajor,                                     // Layout
-                                CblasPacked,                                       // a
-                                CblasNoTrans,                                      // b是否转置
-                                OC, MB, IC,                                        // m, n, k
-                                packed_weights[i], IC,                             // a, lda
-                                src, IC,                                           // b, ldb
-                                0.0,                                               // beta
-                                dst, OC);                                          // c, ldc
-        } else {
-            cblas_sgemm_compute(CblasColMajor,                                     // Layout
-                                CblasPacked,                                       // a
-                                CblasNoTrans,                                      // b是否转置
-                                OC, MB, IC,                                        // m, n, k
-                                packed_weights[i], IC,                             // a, lda
-                                src, IC,                                           // b, ldb
-                                1.0,                                               // beta
-                                dst, OC);                                          // c, ldc
+        #pragma omp parallel for schedule(static)
+
+        for (cblas_int mb = 0; mb < MB; mb++) {
+            fc_epilogue(dst + mb * OC, nullptr, residual != nullptr ? residual + mb * OC : nullptr,
+                        1, OC, param.activation_param);
         }
 
-        //LOG(INFO) << "anakin compute[" << i << "] passed";
+        return SaberSuccess;
+    }
 
-        // LOG(INFO) << "inputs[]:dims: " << inputs[0]->dims();
-        // LOG(INFO) << "inputs:size: " << inputs.size();
-        // LOG(INFO) << "inputs:capacity: " << inputs.capacity();
-        // LOG(INFO) << "output:size: " << outputs.size();
-        // LOG(INFO) << "OC, MB, IC: " << OC << " "<< MB << " " << IC;
+    auto gemm = [&](int row, int rows) {
+        // C := alpha * op(A) * op(B) + beta * C
+        cblas_sgemm_compute(CblasColMajor,                                     // Layout
+                            CblasPacked,                                       // a
+                            CblasNoTrans,                                      // b是否转置
+                            OC, rows, IC,                                      // m, n, k
+                            packed_weights[0], IC,                             // a, lda
+                            src + (size_t)row * IC, IC,                        // b, ldb
+                            0.0,                                               // beta
+                            dst + (size_t)row * OC, OC);                       // c, ldc
+    };
+
+    if (_num_tiles > 1) {
+        // the gemm of a tile runs sequential inside the parallel region
+        #pragma omp parallel for schedule(static)
+
+        for (int tile = 0; tile < _num_tiles; tile++) {
+            int row = tile * _tile_rows;
+            int rows = std::min(_tile_rows, MB - row);
+            gemm(row, rows);
+            fc_epilogue(dst + (size_t)row * OC, bias,
+                        residual != nullptr ? residual + (size_t)row * OC : nullptr,
+                        rows, OC, param.activation_param);
+        }
+
+        return SaberSuccess;
     }
 
-    if (bias) {
+    gemm(0, MB);
+
+    if (bias != nullptr || _has_epilogue) {
         #pragma omp parallel for schedule(static)
 
         for (cblas_int mb = 0; mb < MB; mb++) {
-            cblas_saxpy(OC, 1.0, bias, 1.0, dst + mb * OC, 1);
+            fc_epilogue(dst + mb * OC, bias, residual != nullptr ? residual + mb * OC : nullptr,
+                        1, OC, param.activation_param);
         }
     }
 
@@ -266,13 +509,50 @@ SaberStatus VenderFc<X86, AK_INT8>::init(const std::vector<Tensor<X86> *>& input
         std::vector<Tensor<X86> *>& outputs,
         FcParam<X86>& param,
         Context<X86>& ctx) {
+    CHECK(!is_half_dtype(param.weights->get_dtype())) << "int8 fc does not take half weights";
+    CHECK(!param.residual && !param.activation_param.has_active) << "int8 fc does not fuse the epilogue";
+    _use_u8s8s32_gemm = !jit::mayiuse(jit::avx512_core) && jit::mayiuse(jit::avx2)
+                        && inputs.size() == 1;
+
     if (inputs[0]->get_dtype() == AK_INT8 || inputs[0]->get_dtype() == AK_FLOAT) {
         int m = inputs[0]->count_valid(0, param.axis);
         int n = outputs[0]->channel();
         int k = inputs[0]->count_valid(param.axis, inputs[0]->dims());
+        _dynamic_quant = param.dynamic_quant && inputs[0]->get_dtype() == AK_FLOAT;
+
+        if (_dynamic_quant) {
+            // no input scale needed, fp32 input is quantized per row at dispatch
+            CHECK_EQ(outputs[0]->get_dtype(), AK_FLOAT) << "dynamic quant only support fp32 output";
+            _packed_int8_gemm.init(false, !param.is_transpose_weights, m, n, k, *param.weights, 1.f, true);
+            return SaberSuccess;
+        }
+
         CHECK(inputs[0]->get_scale().size() > 0);
 
-        _packed_int8_gemm.init(false, true, m, n, k, *param.weights, inputs[0]->get_scale()[0]);
+        if (!_use_u8s8s32_gemm) {
+            _packed_int8_gemm.init(false, true, m, n, k, *param.weights, inputs[0]->get_scale()[0]);
+            return SaberSuccess;
+        }
+
+        // weights are n x k, as PackedMKLInt8Gemm takes them
+        const int8_t* weights = static_cast<const int8_t*>(param.weights->data());
+        std::vector<float> weights_scale = param.weights->get_scale();
+
+        if (param.weights->get_dtype() == AK_FLOAT) {
+            _weights_trans.re_alloc(Shape({1, 1, n, k}), AK_INT8);
+            utils::ScaleUtils::scale_gemm_xw_weights_to_nchw_host(_weights_trans, *param.weights, false);
+            weights = static_cast<const int8_t*>(_weights_trans.data());
+            weights_scale = _weights_trans.get_scale();
+        }
+
+        _u8s8s32_gemm.init(true, n, k, weights, k);
+        _scale.clear();
+
+        for (auto scale : weights_scale) {
+            _scale.push_back(scale * inputs[0]->get_scale()[0]);
+        }
+
+        _shifted_input.re_alloc(Shape({1, 1, m, k}), AK_UINT8);
         return SaberSuccess;
     }
 
@@ -316,6 +596,18 @@ SaberStatus VenderFc<X86, AK_INT8>::init(const std::vector<Tensor<X86> *>& input
                             CblasNoTrans :
                             CblasTrans;
 
+    if (_use_u8s8s32_gemm) {
+        int ic = inputs[0]->count_valid(param.axis, inputs[0]->dims());
+        auto weight = _need_weights_trans ? static_cast<const int8_t*>(_weights_trans.data()) :
+                      static_cast<const int8_t*>(param.weights->data());
+
+        if (_is_transpose_weights == CblasTrans) {
+            _u8s8s32_gemm.init(true, _output_channel, ic, weight, ic);
+        } else {
+            _u8s8s32_gemm.init(false, _output_channel, ic, weight, _output_channel);
+        }
+    }
+
     if (inputs[0]->get_dtype() == AK_FLOAT) {
         _input_scale.re_alloc(inputs[0]->valid_shape(), AK_UINT8);
     }
@@ -328,12 +620,60 @@ SaberStatus VenderFc<X86, AK_INT8>::dispatch(const std::vector<Tensor<X86> *>& i
         std::vector<Tensor<X86> *>& outputs,
         FcParam<X86>& param) {
 
-    if (inputs[0]->get_dtype() == AK_INT8 || inputs[0]->get_dtype() == AK_FLOAT) {
+    if (_dynamic_quant || ((inputs[0]->get_dtype() == AK_INT8 || inputs[0]->get_dtype() == AK_FLOAT)
+                           && !_use_u8s8s32_gemm)) {
         int m = inputs[0]->count_valid(0, param.axis);
         _packed_int8_gemm.dispatch(1.f, 0.f, m, *inputs[0], *outputs[0], param.bias);
         return SaberSuccess;
     }
 
+    if (inputs[0]->get_dtype() == AK_INT8 || inputs[0]->get_dtype() == AK_FLOAT) {
+        // signed input is shifted to unsigned, the gemm removes the shift
+        int m = inputs[0]->count_valid(0, param.axis);
+        int n = _u8s8s32_gemm.n();
+        int k = _u8s8s32_gemm.k();
+        utils::try_expand_tensor(_shifted_input, m * k);
+        uint8_t* shifted = static_cast<uint8_t*>(_shifted_input.mutable_data());
+
+        if (inputs[0]->get_dtype() == AK_FLOAT) {
+            CHECK_EQ(inputs[0]->get_scale().size(), 1) << "scale must = 1";
+            PackedU8S8S32Gemm::quantize_fp32_to_shifted_u8(
+                static_cast<const float*>(inputs[0]->data()), shifted, (size_t)m * k,
+                1.f / inputs[0]->get_scale()[0]);
+        } else {
+            PackedU8S8S32Gemm::shift_s8_to_u8(static_cast<const int8_t*>(inputs[0]->data()),
+                                              shifted, (size_t)m * k);
+        }
+
+        int32_t* c = static_cast<int32_t*>(outputs[0]->mutable_data());
+        _u8s8s32_gemm.dispatch(m, shifted, k, c, n, true);
+
+        if (outputs[0]->get_dtype() == AK_INT32) {
+            CHECK(param.bias == nullptr || param.bias->valid_size() == 0);
+        } else if (outputs[0]->get_dtype() == AK_FLOAT) {
+            CHECK(_scale.size() == n || _scale.size() == 1);
+            float* out = static_cast<float*>(outputs[0]->mutable_data());
+            const float* bias = param.bias != nullptr && param.bias->valid_size() > 0 ?
+                                static_cast<const float*>(param.bias->data()) : nullptr;
+            const float* scale = _scale.data();
+            const bool per_channel = _scale.size() == n;
+
+            #pragma omp parallel for schedule(static)
+
+            for (int i = 0; i < m; ++i) {
+                for (int j = 0; j < n; ++j) {
+                    float val = (float)c[i * n + j] * scale[per_channel ? j : 0];
+                    out[i * n + j] = bias != nullptr ? val + bias[j] : val;
+                }
+            }
+        } else {
+            LOG(FATAL) << "not support this type " << outputs[0]->get_dtype();
+            return SaberUnImplError;
+        }
+
+        return SaberSuccess;
+    }
+
 #define __FC_PARALLEL_FUNC [&](int mb, int oc) { \
     int dst_index = mb * _output_channel + oc; \
     if (bias) { \
@@ -381,7 +721,10 @@ SaberStatus VenderFc<X86, AK_INT8>::dispatch(const std::vector<Tensor<X86> *>& i
         //        print_tensor(_bias_scale);
         /* c = scale * { op(A) + a_offset_scale * a_offset } *
                { op(B) + b_offset_scale * b_offset } + beta * C + c_offset */
-        if (i == 0) {
+        if (_use_u8s8s32_gemm) {
+            _u8s8s32_gemm.dispatch(_batch_size, src, IC, static_cast<int*>(ws_),
+                                   _output_channel, false);
+        } else if (i == 0) {
             cblas_gemm_s8u8s32(CblasColMajor,                       // Layout
                                _is_transpose_weights,                // a need to transpose or not
                                CblasNoTrans,                        // b need to transpose or not
@@ -21,6 +21,8 @@
 #include "mkl_cblas.h"
 #include "saber/funcs/impl/impl_fc.h"
 #include "saber/funcs/impl/x86/mkl_packed_int8_gemm.h"
+#include "saber/funcs/impl/x86/packed_u8s8s32_gemm.h"
+#include "saber/funcs/impl/x86/packed_half_gemm.h"
 
 namespace anakin {
 namespace saber {
@@ -69,6 +71,25 @@ private:
     Tensor<X86> _bias_scale;
 
     PackedMKLInt8Gemm _packed_int8_gemm;
+    //! fp32 fc on the int8 gemm, inputs quantized per row at dispatch
+    bool _dynamic_quant{false};
+
+    //! int8 gemm for cpus without avx512
+    bool _use_u8s8s32_gemm{false};
+    PackedU8S8S32Gemm _u8s8s32_gemm;
+    Tensor<X86> _shifted_input;
+
+    //! fp16 or bf16 weights, expanded to fp32 inside the gemm
+    bool _half_weights{false};
+    PackedHalfGemm _half_gemm;
+
+    //! inputs of the gemm, a residual input comes after them
+    int _gemm_inputs{1};
+    //! bias, residual add or activation applied after the gemm
+    bool _has_epilogue{false};
+    //! rows of the output a thread runs the gemm and the epilogue on
+    int _tile_rows{1};
+    int _num_tiles{1};
 };
 
 
@@ -1,10 +1,150 @@
 #include "saber/funcs/impl/x86/vender_mat_mul.h"
+#include "saber/funcs/impl/x86/dynamic_quant_helper.h"
 
 
 namespace anakin{
 
 namespace saber{
 
+namespace {
+
+bool is_contiguous(const int dims[4], const int strides[4]) {
+    int count = 1;
+
+    for (int i = 3; i >= 0; --i) {
+        if (dims[i] != 1 && strides[i] != count) {
+            return false;
+        }
+
+        count *= dims[i];
+    }
+
+    return true;
+}
+
+} // namespace
+
+template <DataType OpDtype>
+SaberStatus SaberMatMul<X86, OpDtype>::create(
+        const std::vector<Tensor<X86> *>& inputs,
+        std::vector<Tensor<X86> *>& outputs,
+        MatMulParam<X86> &param,
+        Context<X86> &ctx) {
+    M = param._m;
+    N = param._n;
+    K = param._k;
+    batch = param._b;
+
+    //row major.
+    layout = CblasRowMajor;
+
+    //matrix A has size M by K, matrix B has size K by N, both may be transposed,
+    //permuted or strided views of the inputs
+    param.operand_view(*inputs[0], param._x_axes, _x.dims, _x.strides);
+    param.operand_view(*inputs[1], param._y_axes, _y.dims, _y.strides);
+    int out_dims[4];
+    param.operand_view(*outputs[0], std::vector<int>(), out_dims, _out_strides);
+    CHECK_EQ(out_dims[0] * out_dims[1], batch);
+    CHECK(_out_strides[3] == 1 || N == 1) << "mat mul output rows must be contiguous";
+    _batch_c = out_dims[1];
+    ldc = M == 1 ? N : _out_strides[2];
+
+    for (Operand* op : {&_x, &_y}) {
+        op->gather = false;
+
+        if (!blas_view(*op, op == &_x ? param._is_transpose_X : param._is_transpose_Y,
+                       op == &_x ? transa : transb, op == &_x ? lda : ldb)) {
+            // gathered to contiguous h x w matrices
+            op->gather = true;
+            op->pack.re_alloc(Shape({op->dims[0], op->dims[1], op->dims[2], op->dims[3]}), AK_FLOAT);
+            Operand packed;
+            param.operand_view(op->pack, std::vector<int>(), packed.dims, packed.strides);
+            CHECK(blas_view(packed, op == &_x ? param._is_transpose_X : param._is_transpose_Y,
+                            op == &_x ? transa : transb, op == &_x ? lda : ldb));
+            memcpy(op->batch_strides, packed.strides, sizeof(op->batch_strides));
+        } else {
+            memcpy(op->batch_strides, op->strides, sizeof(op->batch_strides));
+        }
+
+        for (int i = 0; i < 2; ++i) {
+            if (op->dims[i] == 1) {
+                op->batch_strides[i] = 0;
+            }
+        }
+    }
+
+    _plain = is_contiguous(_x.dims, _x.strides) && is_contiguous(_y.dims, _y.strides)
+             && is_contiguous(out_dims, _out_strides)
+             && _x.dims[0] * _x.dims[1] == batch && _y.dims[0] * _y.dims[1] == batch;
+
+    _a_array.resize(batch);
+    _b_array.resize(batch);
+    _c_array.resize(batch);
+
+    _use_dynamic_quant = param._dynamic_quant && param._const_y && !param._is_transpose_X && _plain;
+    _packed_y = nullptr;
+
+    if (_use_dynamic_quant) {
+        _x_quant.re_alloc(Shape({1, 1, M, K}), AK_UINT8);
+        _y_quant.re_alloc(Shape({1, 1, K, N}), AK_INT8);
+        _y_gemms.resize(batch);
+        _row_scale.resize(M);
+        _col_scale.resize((size_t)batch * N);
+    } else if (param._dynamic_quant) {
+        LOG(WARNING) << "mat mul dynamic quant needs a constant y, contiguous inputs without"
+                     << " broadcast and x not transposed, runs in fp32";
+    }
+
+    return SaberSuccess;
+}
+
+template <DataType OpDtype>
+bool SaberMatMul<X86, OpDtype>::blas_view(Operand& op, bool trans, CBLAS_TRANSPOSE& blas_trans,
+        int& ld) {
+    int h = op.dims[2];
+    int w = op.dims[3];
+
+    // rows of unit stride are row major, columns of unit stride are row major of the transpose
+    if (op.strides[3] == 1 || w == 1) {
+        blas_trans = trans ? CblasTrans : CblasNoTrans;
+        ld = h == 1 ? w : op.strides[2];
+        return ld >= w;
+    }
+
+    if (op.strides[2] == 1 || h == 1) {
+        blas_trans = trans ? CblasNoTrans : CblasTrans;
+        ld = op.strides[3];
+        return ld >= h;
+    }
+
+    return false;
+}
+
+template <DataType OpDtype>
+const float* SaberMatMul<X86, OpDtype>::gather(Operand& op, const float* src) {
+    const int* dims = op.dims;
+    const int* strides = op.strides;
+    float* dst = static_cast<float*>(op.pack.mutable_data());
+    int rows = dims[0] * dims[1] * dims[2];
+
+    #pragma omp parallel for schedule(static)
+
+    for (int r = 0; r < rows; ++r) {
+        int h = r % dims[2];
+        int c = r / dims[2] % dims[1];
+        int n = r / dims[2] / dims[1];
+        const float* in = src + (size_t)n * strides[0] + (size_t)c * strides[1]
+                          + (size_t)h * strides[2];
+        float* out = dst + (size_t)r * dims[3];
+
+        for (int w = 0; w < dims[3]; ++w) {
+            out[w] = in[(size_t)w * strides[3]];
+        }
+    }
+
+    return dst;
+}
+
 template <DataType OpDtype>
 SaberStatus SaberMatMul<X86, OpDtype>::dispatch(
         const std::vector<Tensor<X86> *>& inputs,
@@ -15,12 +155,79 @@ SaberStatus SaberMatMul<X86, OpDtype>::dispatch(
     const OpDataType* src0 = (OpDataType*)inputs[0]->data();
     const OpDataType* src1 = (OpDataType*)inputs[1]->data();
     OpDataType* dst = (OpDataType*)outputs[0]->mutable_data();
- 
+
+    if (_use_dynamic_quant) {
+        return dynamic_quant_dispatch(src0, src1, dst, param);
+    }
+
+    if (_x.gather) {
+        src0 = gather(_x, src0);
+    }
+
+    if (_y.gather) {
+        src1 = gather(_y, src1);
+    }
+
+    // a single group of batch gemms, mkl runs the small ones in parallel over the batch
     for (int i = 0; i < batch; i++) {
-        
-        cblas_sgemm(layout, transa, transb, M, N, K, alpha, src0 + i * M * K, lda, src1 + i * K * N, ldb, beta, dst + i * M * N, ldc);
+        int n = i / _batch_c;
+        int c = i % _batch_c;
+        _a_array[i] = src0 + (size_t)n * _x.batch_strides[0] + (size_t)c * _x.batch_strides[1];
+        _b_array[i] = src1 + (size_t)n * _y.batch_strides[0] + (size_t)c * _y.batch_strides[1];
+        _c_array[i] = dst + (size_t)n * _out_strides[0] + (size_t)c * _out_strides[1];
     }
-    
+
+    if (batch > 0) {
+        cblas_sgemm_batch(layout, &transa, &transb, &M, &N, &K, &alpha, _a_array.data(), &lda,
+                          _b_array.data(), &ldb, &beta, _c_array.data(), &ldc, 1, &batch);
+    }
+
+    return SaberSuccess;
+}
+
+template <DataType OpDtype>
+void SaberMatMul<X86, OpDtype>::pack_const_y(const float* y, MatMulParam<X86>& param) {
+    int8_t* y_quant = static_cast<int8_t*>(_y_quant.mutable_data());
+
+    for (int i = 0; i < batch; i++) {
+        const float* y_i = y + (size_t)i * K * N;
+        float* col_scale = _col_scale.data() + (size_t)i * N;
+
+        if (param._is_transpose_Y) {
+            dynamic_quantize_rows_s8(y_i, y_quant, N, K, col_scale,
+                                     DYNAMIC_QUANT_MADD_WEIGHTS_MAX);
+        } else {
+            dynamic_quantize_cols_s8(y_i, y_quant, K, N, col_scale,
+                                     DYNAMIC_QUANT_MADD_WEIGHTS_MAX);
+        }
+
+        _y_gemms[i].init(param._is_transpose_Y, N, K, y_quant, ldb);
+    }
+
+    _packed_y = y;
+}
+
+template <DataType OpDtype>
+SaberStatus SaberMatMul<X86, OpDtype>::dynamic_quant_dispatch(const float* x, const float* y,
+        float* out, MatMulParam<X86>& param) {
+    if (y != _packed_y) {
+        pack_const_y(y, param);
+    }
+
+    uint8_t* x_quant = static_cast<uint8_t*>(_x_quant.mutable_data());
+
+    for (int i = 0; i < batch; i++) {
+        const float* x_i = x + (size_t)i * M * K;
+        // the int32 result is written in place of out and scaled back to fp32
+        float* out_i = out + (size_t)i * M * N;
+        int32_t* acc_i = reinterpret_cast<int32_t*>(out_i);
+
+        dynamic_quantize_rows_shifted_u8(x_i, x_quant, M, K, _row_scale.data());
+        _y_gemms[i].dispatch(M, x_quant, K, acc_i, N, true);
+        dynamic_dequantize_rows(acc_i, out_i, M, N, _row_scale.data(),
+                                _col_scale.data() + (size_t)i * N, nullptr, alpha);
+    }
+
     return SaberSuccess;
 }
 
@@ -17,6 +17,7 @@
 #define ANAKIN_SABER_FUNCS_IMPL_X86_MAT_MUL_H
 
 #include "saber/funcs/impl/impl_mat_mul.h"
+#include "saber/funcs/impl/x86/packed_u8s8s32_gemm.h"
 #include "mkl.h"
 
 namespace anakin{
@@ -46,66 +47,39 @@ public:
     virtual SaberStatus create(const std::vector<Tensor<X86> *>& inputs,
                                std::vector<Tensor<X86> *>& outputs,
                                MatMulParam<X86> &param,
-                               Context<X86> &ctx) {
-        M = param._m;
-        N = param._n;
-        K = param._k;
-        batch = param._b;
-
-        //row major.
-        layout = CblasRowMajor;
-
-        //matrix A whether to tranpose.
-        //matrix A has size M by K.
-        if (param._is_transpose_X) {
-            transa = CblasTrans;
-            if (layout == CblasRowMajor) {
-                //A has changed its shape at mat_mul.h
-                lda = M;
-            }else {
-                lda = K;
-            }
-        }else {
-            transa = CblasNoTrans;
-            if (layout == CblasRowMajor) {
-                lda = K; 
-            }else {
-                lda = M;
-            }
-        }
-
-        //matrix B whether to transpose.
-        //matrix B has size K by N.
-        if (param._is_transpose_Y) {
-            transb = CblasTrans;
-            if (layout == CblasRowMajor) {
-                ldb = K;
-            }else {
-                ldb = N;
-            }
-        }else {
-            transb = CblasNoTrans;
-            if (layout == CblasRowMajor) {
-                ldb = N;
-            }else {
-                ldb = K;
-            }
-        }
-
-        if (layout == CblasRowMajor) {
-            ldc = N;
-        }else {
-            ldc = M;
-        }
-
-        return SaberSuccess;
-    }
+                               Context<X86> &ctx);
 
     virtual SaberStatus dispatch(const std::vector<Tensor<X86> *>& inputs,
                                  std::vector<Tensor<X86> *>& outputs,
                                  MatMulParam<X86>  &param);
 
 private:
+    //! n x c matrices of h x w, strided in the input
+    struct Operand {
+        int dims[4];
+        int strides[4];
+        //! strides of the n and c batch dims seen by the gemm, 0 when broadcast
+        int batch_strides[2];
+        //! neither h nor w has unit stride, the matrices are gathered to pack first
+        bool gather{false};
+        Tensor<X86> pack;
+    };
+
+    //! set the blas transpose and leading dim of op, false if it needs a gather
+    bool blas_view(Operand& op, bool trans, CBLAS_TRANSPOSE& blas_trans, int& ld);
+    //! copy the matrices of op from src to op.pack, h x w each
+    const float* gather(Operand& op, const float* src);
+
+    Operand _x;
+    Operand _y;
+    int _out_strides[4];
+    int _batch_c{1};
+    //! x and y are contiguous with one matrix per batch
+    bool _plain{true};
+    std::vector<const float*> _a_array;
+    std::vector<const float*> _b_array;
+    std::vector<float*> _c_array;
+
     CBLAS_LAYOUT layout; //CblasRowMajor or CblasColMajor
     CBLAS_TRANSPOSE transa; //matrix A whether to tranpose.
     CBLAS_TRANSPOSE transb; //matrix B whether to tranpose.
@@ -118,6 +92,23 @@ private:
     int ldc; //matrix C leading dimention.
     float alpha{1.0f};
     float beta{0.0f};
+
+    //! x quantized per row on each call, the constant y per column once into _y_gemms
+    SaberStatus dynamic_quant_dispatch(const float* x, const float* y, float* out,
+                                       MatMulParam<X86>& param);
+    //! quantize and pack each batch matrix of y
+    void pack_const_y(const float* y, MatMulParam<X86>& param);
+    //! dynamic quant runs, x is contiguous and not transposed and y is constant
+    bool _use_dynamic_quant{false};
+    //! one gemm with y packed per batch
+    std::vector<PackedU8S8S32Gemm> _y_gemms;
+    //! y the gemms were packed from, packed again when the input moves
+    const float* _packed_y{nullptr};
+    Tensor<X86> _x_quant;
+    Tensor<X86> _y_quant;
+    std::vector<float> _row_scale;
+    //! batch x N scales of y
+    std::vector<float> _col_scale;
 };
 
 } //namespace saber
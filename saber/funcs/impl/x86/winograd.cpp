@@ -1,6 +1,7 @@
 #include "saber/funcs/impl/x86/winograd.h"
 #include "saber/funcs/impl/x86/winograd_float.h"
 #include "saber/funcs/impl/x86/winograd_avx2.h"
+#include "saber/funcs/impl/x86/saber_avx2_funcs.h"
 //#include "saber/funcs/impl/x86/winograd_avx.h"
 //#include "saber/funcs/impl/x86/winograd_avx2_nchwc8.h"
 namespace anakin {
@@ -25,11 +26,14 @@ SaberStatus SaberConvWinograd<AK_FLOAT>::init(const std::vector<Tensor<X86> *>&
     //        this->_impl = new SaberConvWinogradAvx2Nchwc8<AK_FLOAT>;
     //    }else
     if (input_layout == Layout_NCHW && out_layout == Layout_NCHW) {
-#if defined(__AVX2__) and defined(__FMA__)
-        this->_impl = new SaberConvWinogradAvx2<AK_FLOAT>;
-#else
-        this->_impl = new SaberConvWinogradFloat<AK_FLOAT>;
+#if defined(SABER_WITH_AVX2_FUNCS)
+        if (avx2_can_used()) {
+            this->_impl = new SaberConvWinogradAvx2<AK_FLOAT>;
+        } else
 #endif
+        {
+            this->_impl = new SaberConvWinogradFloat<AK_FLOAT>;
+        }
     } else {
         LOG(FATAL) << "winograd conv not support this layout";
     }
@@ -1,7 +1,9 @@
 #include "saber/funcs/impl/x86/winograd_avx2.h"
+#include "saber/funcs/impl/x86/packed_weight_cache.h"
 #include "mkl_cblas.h"
 #include "mkl_trans.h"
 #include "tensor_op.h"
+#include "saber/funcs/impl/x86/saber_isa_avx2_begin.h"
 #include "saber/funcs/impl/x86/saber_avx2_expand.h"
 namespace anakin {
 namespace saber {
@@ -692,12 +694,15 @@ SaberStatus SaberConvWinogradAvx2<AK_FLOAT>::create(const std::vector<Tensor<X86
     int group = conv_param->group;
     const float* weights_d = (const float*)conv_param->weight()->data();
     _winor_weights.re_alloc(Shape({8, 8, out_c, in_c}));
-    Tensor<X86> trans_temp(Shape({8, 8, out_c, in_c}));
-    float* trans_tmp_ptr = static_cast<float*>(trans_temp.mutable_data());
 
-    winograd_transform_weights(static_cast<float*>(_winor_weights.mutable_data()),
-    static_cast<float*>(conv_param->weight()->data()), out_c, in_c,
-                               trans_tmp_ptr);
+    PackedWeightCache::global().load_or_pack("winograd_avx2_f63", 1, weights_d,
+            sizeof(float) * out_c * in_c * kernel_h * kernel_w, {out_c, in_c},
+            _winor_weights.mutable_data(), sizeof(float) * _winor_weights.valid_size(), [&]() {
+        Tensor<X86> trans_temp(Shape({8, 8, out_c, in_c}));
+        float* trans_tmp_ptr = static_cast<float*>(trans_temp.mutable_data());
+        winograd_transform_weights(static_cast<float*>(_winor_weights.mutable_data()),
+                                   weights_d, out_c, in_c, trans_tmp_ptr);
+    });
 
 
     int tile_w = (out_w + 5) / 6;
@@ -793,3 +798,4 @@ SaberStatus SaberConvWinogradAvx2<AK_FLOAT>::dispatch(const std::vector<Tensor<X
 
 }
 }
+#include "saber/funcs/impl/x86/saber_isa_end.h"
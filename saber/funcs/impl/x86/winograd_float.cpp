@@ -1,4 +1,5 @@
 #include "saber/funcs/impl/x86/winograd_float.h"
+#include "saber/funcs/impl/x86/packed_weight_cache.h"
 #include "mkl_cblas.h"
 #include "mkl_trans.h"
 
@@ -147,11 +148,15 @@ SaberStatus SaberConvWinogradFloat<AK_FLOAT>::create(const std::vector<Tensor<X8
     int group = conv_param->group;
     const float* weights_d = (const float*)conv_param->weight()->data();
     _winor_weights.re_alloc(Shape({8, 8, out_c, in_c}));
-    Tensor<X86> trans_temp(Shape({8, 8, out_c, in_c}));
-    float* trans_tmp_ptr = static_cast<float*>(trans_temp.mutable_data());
 
-    winograd_transform_weights(static_cast<float*>(_winor_weights.mutable_data()), static_cast<const float*>(conv_param->weight()->data()), out_c, in_c,
-                               trans_tmp_ptr);
+    PackedWeightCache::global().load_or_pack("winograd_float_f63", 1, weights_d,
+            sizeof(float) * out_c * in_c * kernel_h * kernel_w, {out_c, in_c},
+            _winor_weights.mutable_data(), sizeof(float) * _winor_weights.valid_size(), [&]() {
+        Tensor<X86> trans_temp(Shape({8, 8, out_c, in_c}));
+        float* trans_tmp_ptr = static_cast<float*>(trans_temp.mutable_data());
+        winograd_transform_weights(static_cast<float*>(_winor_weights.mutable_data()),
+                                   weights_d, out_c, in_c, trans_tmp_ptr);
+    });
 
 
     int tile_w = (out_w + 5) / 6;
@@ -24,6 +24,7 @@
 
 #include <type_traits>
 #include "saber/funcs/impl/x86/anakin_thread.h"
+#include "saber/funcs/impl/x86/dynamic_quant_helper.h"
 #include "saber/core/common.h"
 #include "saber/core/tensor.h"
 #include "saber/funcs/saber_util.h"
@@ -348,13 +349,8 @@ public:
 
     static void scale_fp32_int8(Tensor<X86>& out_tensor , const float* input, size_t size){
         CHECK_EQ(out_tensor.get_dtype(), AK_INT8) << "output must be int8";
-        float t_max=get_fp32_max(input,size);
-        float scale_value=127.f/t_max;
-        char* out_ptr = static_cast<char*>(out_tensor.mutable_data());
-        for (int i = 0; i < size; i++) {
-            out_ptr[i] = secur_cast2char(input[i] * scale_value);
-        }
-        out_tensor.set_scale({1.f/scale_value});
+        int8_t* out_ptr = static_cast<int8_t*>(out_tensor.mutable_data());
+        out_tensor.set_scale({dynamic_quantize_s8(input, out_ptr, size)});
     }
 
     static void scale_fp32_uint8(Tensor<X86>& out_tensor, Tensor<X86>& in_tensor) {
@@ -0,0 +1,96 @@
+/* Copyright (c) 2018 Anakin Authors, Inc. All Rights Reserved.
+
+   Licensed under the Apache License, Version 2.0 (the "License");
+   you may not use this file except in compliance with the License.
+   You may obtain a copy of the License at
+
+       http://www.apache.org/licenses/LICENSE-2.0
+
+   Unless required by applicable law or agreed to in writing, software
+   distributed under the License is distributed on an "AS IS" BASIS,
+   WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+   See the License for the specific language governing permissions and
+   limitations under the License.
+*/
+
+#ifndef ANAKIN_SABER_FUNCS_LAYOUT_TRANS_H
+#define ANAKIN_SABER_FUNCS_LAYOUT_TRANS_H
+
+#include "saber/funcs/base.h"
+#include "saber/funcs/impl/impl_base.h"
+#include "saber/funcs/impl/impl_layout_trans.h"
+
+#ifdef USE_X86_PLACE
+#include "saber/funcs/impl/x86/saber_layout_trans.h"
+#endif
+
+namespace anakin {
+namespace saber {
+
+/**
+ * \brief reorder a 4d fp32 tensor from the layout of the input to the layout of the output,
+ * between NCHW, NHWC, NCHW_C8R and NCHW_C16R.
+ * the output layout has to be set before compute_output_shape, only the dims are inferred.
+ */
+template<typename TargetType,
+        DataType OpDtype>
+class LayoutTrans : public BaseFunc<
+        TargetType,
+        OpDtype,
+        ImplBase,
+        LayoutTransParam> {
+public:
+    using BaseFunc<
+            TargetType,
+            OpDtype,
+            ImplBase,
+            LayoutTransParam>::BaseFunc;
+
+    LayoutTrans() = default;
+
+    typedef Tensor<TargetType> InDataTensor;
+    typedef Tensor<TargetType> OutDataTensor;
+    typedef Tensor<TargetType> OpTensor;
+    typedef LayoutTransParam<TargetType> Param_t;
+    typedef std::vector<InDataTensor *> Input_v;
+    typedef std::vector<OutDataTensor *> Output_v;
+    typedef std::vector<Shape> Shape_v;
+
+    virtual SaberStatus compute_output_shape(const Input_v& input,
+            Output_v& output, Param_t& param) override {
+        CHECK_EQ(input[0]->dims(), 4) << "layout trans only support 4d tensor";
+        output[0]->set_seq_offset(input[0]->get_seq_offset());
+        return output[0]->set_shape_without_layout(input[0]->valid_shape());
+    }
+
+    virtual SaberStatus init_impl(ImplEnum implenum) override {
+        switch (implenum) {
+            case VENDER_IMPL:
+                this->_impl.push_back(new VenderLayoutTrans <TargetType, OpDtype>);
+                return SaberSuccess;
+
+            case SABER_IMPL:
+                this->_impl.push_back(new SaberLayoutTrans <TargetType, OpDtype>);
+                return SaberSuccess;
+
+            default:
+                return SaberUnImplError;
+        }
+    }
+
+private:
+
+    virtual void pick_best_static() override {
+        this->_best_impl = this->_impl[0];
+    }
+
+    virtual void pick_best_specify(ImplEnum implenum) override {
+        this->_best_impl = this->_impl[0];
+    }
+
+};
+
+} // namespace saber
+} // namespace anakin
+
+#endif //ANAKIN_SABER_FUNCS_LAYOUT_TRANS_H
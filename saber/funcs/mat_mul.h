@@ -62,38 +62,52 @@ public:
         Param_t& param) override 
     {
         CHECK_EQ(input.size(), 2);
-        CHECK_EQ(input[0]->num(), input[1]->num());
-        CHECK_EQ(input[0]->channel(), input[1]->channel());
-        Shape shape_output = input[0]->valid_shape();
-        int M,N,K0,K1,B;
-//        LOG(INFO)<<"input0 shape:";
-//        LOG(INFO)<<"n:"<<input[0]->num()<<"c:"<<input[0]->channel()<<"h:"<<input[0]->height()<<"w:"<<input[0]->width();
-//        LOG(INFO)<<"input1 shape:";
-//        LOG(INFO)<<"n:"<<input[1]->num()<<"c:"<<input[1]->channel()<<"h:"<<input[1]->height()<<"w:"<<input[1]->width();
+        // the n, c of X and Y are batch dims, one of them may be 1 and broadcast
+        int x_dims[4];
+        int y_dims[4];
+        int strides[4];
+        param.operand_view(*input[0], param._x_axes, x_dims, strides);
+        param.operand_view(*input[1], param._y_axes, y_dims, strides);
+        int M,N,K0,K1;
+
+        for (int i = 0; i < 2; ++i) {
+            CHECK(x_dims[i] == y_dims[i] || x_dims[i] == 1 || y_dims[i] == 1)
+                    << "mat mul batch dim " << i << " of " << x_dims[i] << " and " << y_dims[i]
+                    << " can not broadcast";
+        }
+
+        if (!std::is_same<TargetType, X86>::value) {
+            CHECK(param._x_axes.empty() && param._y_axes.empty()
+                  && x_dims[0] == y_dims[0] && x_dims[1] == y_dims[1])
+                    << "only x86 mat mul supports broadcast and permuted inputs";
+        }
+
         if (param._is_transpose_X)
         {
-            K0 = input[0]->height();
-            M = input[0]->width();
+            K0 = x_dims[2];
+            M = x_dims[3];
         }else{
-            M = input[0]->height();
-            K0 = input[0]->width();
+            M = x_dims[2];
+            K0 = x_dims[3];
         }
 
         if (param._is_transpose_Y)
         {
-            N = input[1]->height();
-            K1 = input[1]->width();
+            N = y_dims[2];
+            K1 = y_dims[3];
         }else{
-            K1 = input[1]->height();
-            N = input[1]->width();
+            K1 = y_dims[2];
+            N = y_dims[3];
         }
         CHECK_EQ(K0, K1);
 
-        param._b = input[0]->num() * input[0]->channel();
+        int batch_n = std::max(x_dims[0], y_dims[0]);
+        int batch_c = std::max(x_dims[1], y_dims[1]);
+        param._b = batch_n * batch_c;
         param._m = M;
         param._n = N;
         param._k = K0;
-        return output[0]->set_shape(Shape({input[0]->num(), input[0]->channel(), M, N}));
+        return output[0]->set_shape(Shape({batch_n, batch_c, M, N}));
     }
 
     virtual SaberStatus init_impl(ImplEnum implenum) override {
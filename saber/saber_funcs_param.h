@@ -15,8 +15,10 @@
 #include "anakin_config.h"
 #include <vector>
 #include <string>
+#include <algorithm>
 #include "saber/core/shape.h"
 #include "saber/core/tensor.h"
+#include "saber/core/paged_row_table.h"
 #include "saber/saber_types.h"
 #include "saber/saber_sp_param.h"
 #include <cmath>
@@ -1140,6 +1142,7 @@ struct EmbeddingParam {
             , emb_dim(right.emb_dim)
             , padding_idx(right.padding_idx)
             , num_direct(right.num_direct)
+            , paged_table(right.paged_table)
             , weight_tensor(right.weight_tensor)
     {}
     EmbeddingParam& operator=(const EmbeddingParam& right) {
@@ -1147,6 +1150,7 @@ struct EmbeddingParam {
         emb_dim = right.emb_dim;
         padding_idx = right.padding_idx;
         num_direct = right.num_direct;
+        paged_table = right.paged_table;
         weight_tensor = right.weight_tensor;
         return *this;
     }
@@ -1156,6 +1160,7 @@ struct EmbeddingParam {
         comp_eq = comp_eq && (emb_dim == right.emb_dim);
         comp_eq = comp_eq && (padding_idx == right.padding_idx);
         comp_eq = comp_eq && (num_direct == right.num_direct);
+        comp_eq = comp_eq && (paged_table == right.paged_table);
         comp_eq = comp_eq && (weight_tensor == right.weight_tensor);
         return comp_eq;
     }
@@ -1169,6 +1174,8 @@ struct EmbeddingParam {
     int word_num;
     int padding_idx;
     int num_direct{1};
+    /// rows are paged in from a file instead of the weight tensor when set (x86 only)
+    std::shared_ptr<PagedRowTable> paged_table;
 private:
     Tensor<TargetType>* weight_tensor;
 };
@@ -1234,6 +1241,9 @@ struct FcParam {
         num_output = right.num_output;
         axis = right.axis;
         is_transpose_weights = right.is_transpose_weights;
+        dynamic_quant = right.dynamic_quant;
+        activation_param = right.activation_param;
+        residual = right.residual;
     }
     FcParam& operator=(const FcParam& right) {
         this->weights = right.weights;
@@ -1241,16 +1251,28 @@ struct FcParam {
         this->num_output = right.num_output;
         this->axis = right.axis;
         this->is_transpose_weights = right.is_transpose_weights;
+        this->dynamic_quant = right.dynamic_quant;
+        this->activation_param = right.activation_param;
+        this->residual = right.residual;
         return *this;
     }
     bool operator==(const FcParam& right) {
         bool flag = this->is_transpose_weights == right.is_transpose_weights;
         flag = flag && (this->num_output == right.num_output) && (this->axis == right.axis);
+        flag = flag && (this->dynamic_quant == right.dynamic_quant);
+        flag = flag && (this->activation_param == right.activation_param);
+        flag = flag && (this->residual == right.residual);
         return flag && (this->weights == right.weights) && (this->bias == right.bias);
     }
     bool is_transpose_weights{false};
     int num_output;
     int axis{1};
+    //! fp32 fc runs an int8 gemm, weights quantized per output channel, inputs per row at runtime
+    bool dynamic_quant{false};
+    //! epilogue of the gemm (x86): out = act(x * w + bias + residual)
+    ActivationParam<TargetType> activation_param;
+    //! the last input is added to the output before the activation, it has the output shape
+    bool residual{false};
     Tensor<TargetType>* weights{nullptr};
     Tensor<TargetType>* bias{nullptr};
 };
@@ -1282,6 +1304,17 @@ struct FlattenParam {
     int end_axis{-1};
 };
 
+/**
+ * \brief convert a 4d tensor between layouts, the target layout is the layout of the output tensor.
+ */
+template <typename TargetType>
+struct LayoutTransParam {
+    LayoutTransParam() = default;
+    LayoutTransParam(const LayoutTransParam& right) {}
+    LayoutTransParam& operator=(const LayoutTransParam& right) { return *this; }
+    bool operator==(const LayoutTransParam& right) { return true; }
+};
+
 template <typename >
 struct GenerateProposalsParam {
     GenerateProposalsParam() = default;
@@ -1393,6 +1426,7 @@ struct GruParam {
         is_reverse = right.is_reverse;
         formula = right.formula;
         init_hidden_tensor = right.init_hidden_tensor;
+        dynamic_quant = right.dynamic_quant;
         return *this;
     }
 
@@ -1408,6 +1442,7 @@ struct GruParam {
         comp_eq = comp_eq && (is_reverse = right.is_reverse);
         comp_eq = comp_eq && (formula = right.formula);
         comp_eq = comp_eq && (init_hidden_tensor == right.init_hidden_tensor);
+        comp_eq = comp_eq && (dynamic_quant == right.dynamic_quant);
         return comp_eq;
     }
 
@@ -1430,6 +1465,8 @@ struct GruParam {
     ActiveType h_activity;
     GruFormula formula;
     bool is_reverse;
+    //! the input to hidden gemm runs in int8, inputs quantized per row at runtime
+    bool dynamic_quant{false};
 private:
     opTensor* weight_tensor;
     opTensor* bias_tensor;
@@ -1678,6 +1715,7 @@ struct LstmParam {
         skip_num = right.skip_num;
         project_dim=right.project_dim;
         cell_dim=right.cell_dim;
+        dynamic_quant = right.dynamic_quant;
         return *this;
     }
 
@@ -1699,6 +1737,7 @@ struct LstmParam {
         comp_eq = comp_eq && (skip_num == right.skip_num);
         comp_eq = comp_eq && (project_dim == right.project_dim);
         comp_eq = comp_eq && (cell_dim == right.cell_dim);
+        comp_eq = comp_eq && (dynamic_quant == right.dynamic_quant);
         return comp_eq;
     }
 
@@ -1736,6 +1775,8 @@ struct LstmParam {
     int skip_num;
     int project_dim;
     int cell_dim;
+    //! the input to hidden gemm runs in int8, inputs quantized per row at runtime
+    bool dynamic_quant{false};
 private:
     opTensor* weight_tensor;
     opTensor* bias_tensor;
@@ -1752,6 +1793,10 @@ struct MatMulParam {
         _is_transpose_X = right._is_transpose_X;
         _is_transpose_Y = right._is_transpose_Y;
         _scale = right._scale;
+        _dynamic_quant = right._dynamic_quant;
+        _const_y = right._const_y;
+        _x_axes = right._x_axes;
+        _y_axes = right._y_axes;
         return *this;
     }
     bool operator==(const MatMulParam& right) {
@@ -1759,11 +1804,67 @@ struct MatMulParam {
         comp_eq = comp_eq && (_is_transpose_X == right._is_transpose_X);
         comp_eq = comp_eq && (_is_transpose_Y == right._is_transpose_Y);
         comp_eq = comp_eq && (_scale == right._scale);
+        comp_eq = comp_eq && (_dynamic_quant == right._dynamic_quant);
+        comp_eq = comp_eq && (_const_y == right._const_y);
+        comp_eq = comp_eq && (_x_axes == right._x_axes);
+        comp_eq = comp_eq && (_y_axes == right._y_axes);
         return comp_eq;
     }
+    /**
+     * \brief true when _x_axes and _y_axes are empty or a permutation of 0, 1, 2, 3
+     */
+    bool valid_axes() const {
+        for (auto* axes : {&_x_axes, &_y_axes}) {
+            if (axes->empty()) {
+                continue;
+            }
+
+            std::vector<int> sorted_axes(*axes);
+            std::sort(sorted_axes.begin(), sorted_axes.end());
+
+            if (sorted_axes != std::vector<int>({0, 1, 2, 3})) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+    /**
+     * \brief n, c, h, w of an input as the matmul sees it and their strides in elements,
+     * the input dims are reordered by axes like a permute does, without moving data
+     */
+    void operand_view(const Tensor<TargetType>& input, const std::vector<int>& axes,
+                      int dims[4], int strides[4]) const {
+        int index[4] = {input.num_index(), input.channel_index(),
+                        input.height_index(), input.width_index()
+                       };
+        Shape stride = input.get_stride();
+        int in_dims[4];
+        int in_strides[4];
+
+        for (int i = 0; i < 4; ++i) {
+            in_dims[i] = index[i] < 0 ? 1 : input.valid_shape()[index[i]];
+            in_strides[i] = index[i] < 0 ? 0 : stride[index[i]];
+        }
+
+        CHECK(axes.empty() || axes.size() == 4) << "mat mul axes must permute the 4 input dims";
+
+        for (int i = 0; i < 4; ++i) {
+            dims[i] = axes.empty() ? in_dims[i] : in_dims[axes[i]];
+            strides[i] = axes.empty() ? in_strides[i] : in_strides[axes[i]];
+        }
+    }
     bool _is_transpose_X{false};
     bool _is_transpose_Y{false};
     float _scale{1.0f};
+    //! X per row and Y per column are quantized to int8 at runtime, needs _const_y on x86
+    bool _dynamic_quant{false};
+    //! Y is a weight that keeps its values between calls, its int8 pack is made once
+    bool _const_y{false};
+    //! permutation of the X and Y dims applied before the matmul, empty keeps them.
+    //! no graph pass folds a Permute into them, the model converter writes x_axes and y_axes
+    std::vector<int> _x_axes;
+    std::vector<int> _y_axes;
     int _m = 0;
     int _n = 0;
     int _k = 0;
@@ -2802,21 +2903,27 @@ struct SliceV2Param {
 template <typename TargetType>
 struct SoftmaxParam {
     SoftmaxParam() = default;
-    explicit SoftmaxParam(int axis_in) {
+    explicit SoftmaxParam(int axis_in, float scale_in = 1.f) {
         CHECK_GE(axis_in, 0) << "input axis index should >= 0, current is " << axis_in;
         axis = axis_in;
+        scale = scale_in;
     }
     SoftmaxParam(const SoftmaxParam<TargetType>& right) {
         axis = right.axis;
+        scale = right.scale;
     }
     SoftmaxParam<TargetType>& operator=(const SoftmaxParam<TargetType>& right) {
         this->axis = right.axis;
+        this->scale = right.scale;
         return *this;
     }
     bool operator==(const SoftmaxParam<TargetType>& right) {
-        return axis == right.axis;
+        return axis == right.axis && scale == right.scale;
     }
     int axis;
+    //! input is multiplied by scale before softmax, an optional second input
+    //! is added after scaling as mask, it may broadcast over the axes before axis
+    float scale{1.f};
 };
 
 template <typename TargetType>
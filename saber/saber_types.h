@@ -198,7 +198,8 @@ enum DataType {
     AK_STRING       =       11,
     AK_BOOL         =       12,
     AK_SHAPE        =       13,
-    AK_TENSOR       =       14
+    AK_TENSOR       =       14,
+    AK_BFLOAT16     =       15
 };
 typedef enum {
     SaberSuccess         = -1,                             /*!< No errors */
@@ -336,7 +337,10 @@ typedef enum{
 
 typedef enum{
     ENTROPY= 0,
-    MAXABS = 1
+    MAXABS = 1,
+    PERCENTILE = 2,
+    MSE = 3,
+    AUTO = 4
 } CalibrationAlgoType;
 
 typedef enum{
@@ -0,0 +1,165 @@
+#include <string>
+#include "graph_test.h"
+#include "graph_global_mem.h"
+#include "graph.h"
+#include "framework/core/operator/operator.h"
+
+using namespace anakin;
+using namespace anakin::graph;
+
+#ifdef USE_X86_PLACE
+template<typename Ttype>
+PBlock<Ttype>* new_weights(const void* owner, float val) {
+    saber::Shape shape({1, 1, 16, 16}, Layout_NCHW);
+    auto* block = GraphGlobalMem<Ttype>::Global().template new_block<AK_FLOAT>(shape, owner);
+    float* data = static_cast<float*>(block->h_tensor().mutable_data());
+    for (int i = 0; i < shape.count(); i++) {
+        data[i] = val + i;
+    }
+    return block;
+}
+
+void scale_weights(PBlock<X86> block, float scale) {
+    float* data = static_cast<float*>(block.h_tensor().mutable_data());
+    for (int i = 0; i < block.count(); i++) {
+        data[i] *= scale;
+    }
+}
+
+TEST(GraphTest, graph_global_mem_dedup_test) {
+    auto& global_mem = GraphGlobalMem<X86>::Global();
+    int graph_a = 0;
+    int graph_b = 0;
+    size_t pool_size = global_mem.get_pool_size<AK_FLOAT>();
+
+    PBlock<X86>* weights_a = new_weights<X86>(&graph_a, 1.f);
+    PBlock<X86>* weights_b = new_weights<X86>(&graph_b, 1.f);
+    PBlock<X86>* other_b = new_weights<X86>(&graph_b, 2.f);
+    // node attr of graph b
+    PBlock<X86> attr_b = *weights_b;
+    CHECK(!global_mem.dedup_block(weights_a, &graph_a)) << "the first block has nothing to share";
+    CHECK(global_mem.dedup_block(weights_b, &graph_b)) << "equal blocks should share the buffer";
+    CHECK(!global_mem.dedup_block(other_b, &graph_b)) << "different blocks should not share the buffer";
+    CHECK_EQ(attr_b.h_tensor().data(), weights_a->h_tensor().data());
+    CHECK_NE(other_b->h_tensor().data(), weights_a->h_tensor().data());
+
+    // changing the weights of graph b keeps graph a intact
+    global_mem.apply<Level_0>(scale_weights, attr_b, 2.f);
+    CHECK_NE(attr_b.h_tensor().data(), weights_a->h_tensor().data());
+    const float* data_a = static_cast<const float*>(weights_a->h_tensor().data());
+    const float* data_b = static_cast<const float*>(attr_b.h_tensor().data());
+    for (int i = 0; i < weights_a->count(); i++) {
+        CHECK_EQ(data_a[i], 1.f + i);
+        CHECK_EQ(data_b[i], 2.f * (1.f + i));
+    }
+    // the buffer of graph a is still shared with blocks loaded later
+    PBlock<X86>* weights_c = new_weights<X86>(&graph_b, 1.f);
+    CHECK(global_mem.dedup_block(weights_c, &graph_b));
+    CHECK_EQ(weights_c->h_tensor().data(), weights_a->h_tensor().data());
+
+    global_mem.release(&graph_a);
+    CHECK_EQ(global_mem.get_pool_size<AK_FLOAT>(), pool_size + 3);
+    // graph b still holds the buffer loaded by graph a
+    const float* data_c = static_cast<const float*>(weights_c->h_tensor().data());
+    CHECK_EQ(data_c[1], 2.f);
+    global_mem.release(&graph_b);
+    CHECK_EQ(global_mem.get_pool_size<AK_FLOAT>(), pool_size);
+    LOG(INFO) << "graph global mem dedup check pass";
+}
+
+TEST(GraphTest, graph_global_mem_dedup_first_loader_test) {
+    auto& global_mem = GraphGlobalMem<X86>::Global();
+    int graph_a = 0;
+    int graph_b = 0;
+    int graph_c = 0;
+    size_t pool_size = global_mem.get_pool_size<AK_FLOAT>();
+
+    PBlock<X86>* weights_a = new_weights<X86>(&graph_a, 1.f);
+    PBlock<X86>* weights_b = new_weights<X86>(&graph_b, 1.f);
+    // node attr of graph a, the block which is indexed
+    PBlock<X86> attr_a = *weights_a;
+    CHECK(!global_mem.dedup_block(weights_a, &graph_a));
+    CHECK(global_mem.dedup_block(weights_b, &graph_b));
+    const void* loaded = weights_b->h_tensor().data();
+
+    // changing the weights of graph a keeps the loaded buffer for graph b and the index
+    global_mem.apply<Level_0>(scale_weights, attr_a, 2.f);
+    CHECK_NE(weights_a->h_tensor().data(), loaded);
+    CHECK_EQ(weights_b->h_tensor().data(), loaded);
+    const float* data_a = static_cast<const float*>(weights_a->h_tensor().data());
+    const float* data_b = static_cast<const float*>(weights_b->h_tensor().data());
+    for (int i = 0; i < weights_a->count(); i++) {
+        CHECK_EQ(data_a[i], 2.f * (1.f + i));
+        CHECK_EQ(data_b[i], 1.f + i);
+    }
+    // blocks loaded later share the loaded data, not the changed one
+    PBlock<X86>* weights_c = new_weights<X86>(&graph_c, 1.f);
+    CHECK(global_mem.dedup_block(weights_c, &graph_c));
+    CHECK_EQ(weights_c->h_tensor().data(), loaded);
+    PBlock<X86>* scaled_c = new_weights<X86>(&graph_c, 1.f);
+    scale_weights(*scaled_c, 2.f);
+    CHECK(!global_mem.dedup_block(scaled_c, &graph_c)) << "a changed buffer must not be shared";
+
+    global_mem.release(&graph_a);
+    global_mem.release(&graph_b);
+    CHECK_EQ(weights_c->h_tensor().data(), loaded);
+    global_mem.release(&graph_c);
+    CHECK_EQ(global_mem.get_pool_size<AK_FLOAT>(), pool_size);
+
+    // the loaded buffer left the index with its last owner
+    int graph_d = 0;
+    PBlock<X86>* weights_d = new_weights<X86>(&graph_d, 1.f);
+    CHECK(!global_mem.dedup_block(weights_d, &graph_d)) << "a released buffer must not be shared";
+    global_mem.release(&graph_d);
+    CHECK_EQ(global_mem.get_pool_size<AK_FLOAT>(), pool_size);
+    LOG(INFO) << "graph global mem dedup first loader check pass";
+}
+
+/**
+ * \brief the conv has no bias, InitParam of the fused affine channel creates one, it is owned
+ *  by the graph bound to the op and released with the loaded weights.
+ */
+TEST(GraphTest, graph_global_mem_clean_test) {
+    using GraphFP32 = Graph<X86, Precision::FP32>;
+    auto& global_mem = GraphGlobalMem<X86>::Global();
+    size_t pool_size = global_mem.get_pool_size<AK_FLOAT>();
+
+    GraphFP32* graph = new GraphFP32();
+    graph->AddOp("conv", "ConvAffineChannel", {"x"}, {"y"});
+    graph->AddOpAttr("conv", "group", 1);
+    graph->AddOpAttr("conv", "bias_term", false);
+    graph->AddOpAttr("conv", "padding", PTuple<int>(0, 0));
+    graph->AddOpAttr("conv", "strides", PTuple<int>(1, 1));
+    graph->AddOpAttr("conv", "dilation_rate", PTuple<int>(1, 1));
+    graph->AddOpAttr("conv", "filter_num", 1);
+    graph->AddOpAttr("conv", "kernel_size", PTuple<int>(16, 16));
+    graph->AddOpAttr("conv", "axis", 1);
+    // one 16x16 filter, the affine channel blocks hold more values than the fusion reads
+    graph->AddOpAttr("conv", "weight_1", *new_weights<X86>(graph, 0.5f));
+    graph->AddOpAttr("conv", "affine_channel_0_weight_1", *new_weights<X86>(graph, 1.f));
+    graph->AddOpAttr("conv", "affine_channel_0_weight_2", *new_weights<X86>(graph, 0.f));
+    CHECK_EQ(global_mem.get_pool_size<AK_FLOAT>(), pool_size + 3);
+
+    auto* op = OpFactory<X86, Precision::FP32>::Global()["ConvAffineChannel"];
+    CHECK(op != nullptr) << "ConvAffineChannel is not registered";
+    auto node_ptr = (*graph)["conv"];
+    op->_helper->BindParam(node_ptr, graph);
+    CHECK(op->_helper->InitParam()) << "InitParam error";
+    CHECK(node_ptr->get_attr<bool>("bias_term"));
+    CHECK_EQ(global_mem.get_pool_size<AK_FLOAT>(), pool_size + 4);
+
+    delete op;
+    // the graph cleans its weights when it is deleted or loads another model
+    delete graph;
+    CHECK_EQ(global_mem.get_pool_size<AK_FLOAT>(), pool_size) << "the pool keeps the blocks of a cleaned graph";
+    LOG(INFO) << "graph global mem clean check pass";
+}
+#endif
+
+int main(int argc, const char** argv) {
+    // initial logger
+    logger::init(argv[0]);
+    InitTest();
+    RUN_ALL_TESTS(argv[0]);
+    return 0;
+}
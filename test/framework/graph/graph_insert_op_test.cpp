@@ -0,0 +1,84 @@
+#include <string>
+#include <algorithm>
+#include "graph_test.h"
+#include "graph.h"
+
+using namespace anakin;
+using namespace anakin::graph;
+
+#ifdef USE_X86_PLACE
+using GraphFP32 = Graph<X86, Precision::FP32>;
+
+/**
+ * \brief x feeds two relus, the concat reads them in the order relu_a, relu_b.
+ */
+GraphFP32* build_graph() {
+    GraphFP32* graph = new GraphFP32();
+    graph->AddOp("relu_a", "ReLU", {"x"}, {"a"});
+    graph->AddOpAttr("relu_a", "alpha", 0.f);
+    graph->AddOp("relu_b", "ReLU", {"x"}, {"b"});
+    graph->AddOpAttr("relu_b", "alpha", 0.f);
+    graph->AddOp("concat", "Concat", {"a", "b"}, {"y"});
+    graph->AddOpAttr("concat", "axis", 1);
+    CHECK(graph->Freeze()) << "Freeze error";
+    graph->Optimize(false);
+    return graph;
+}
+
+int exec_index(GraphFP32* graph, const std::string& name) {
+    auto& exec_order = graph->get_nodes_in_order();
+    auto it = std::find(exec_order.begin(), exec_order.end(), name);
+    return it == exec_order.end() ? -1 : it - exec_order.begin();
+}
+
+TEST(GraphTest, graph_insert_op_test) {
+    GraphFP32* graph = build_graph();
+    int size = graph->size();
+    int exec_size = graph->get_nodes_in_order().size();
+
+    CHECK(graph->InsertOp("trans", "LayoutTrans", "relu_a", "concat")) << "InsertOp error";
+    CHECK(graph->has_vertex("trans"));
+    CHECK_EQ(graph->size(), size + 1);
+    CHECK_EQ((*graph)["trans"]->get_op_name(), "LayoutTrans");
+    CHECK_EQ((*graph)["trans"]->lane().val, (*graph)["concat"]->lane().val);
+
+    // relu_a --> trans --> concat, the concat keeps the order of its inputs
+    auto& trans_ins = graph->get_in_arc_its("trans");
+    CHECK_EQ(trans_ins.size(), 1);
+    CHECK_EQ(trans_ins[0]->bottom(), "relu_a");
+    auto& relu_outs = graph->get_out_arc_its("relu_a");
+    CHECK_EQ(relu_outs.size(), 1);
+    CHECK_EQ(relu_outs[0]->top(), "trans");
+    auto& trans_outs = graph->get_out_arc_its("trans");
+    CHECK_EQ(trans_outs.size(), 1);
+    CHECK_EQ(trans_outs[0]->top(), "concat");
+    auto& concat_ins = graph->get_in_arc_its("concat");
+    CHECK_EQ(concat_ins.size(), 2);
+    CHECK_EQ(concat_ins[0]->bottom(), "trans");
+    CHECK_EQ(concat_ins[1]->bottom(), "relu_b");
+
+    // the new node runs right before the concat
+    CHECK_EQ(graph->get_nodes_in_order().size(), exec_size + 1);
+    CHECK_GT(exec_index(graph, "trans"), exec_index(graph, "relu_a"));
+    CHECK_EQ(exec_index(graph, "trans") + 1, exec_index(graph, "concat"));
+
+    // the graph is unchanged when the insert is refused
+    CHECK(!graph->InsertOp("trans", "LayoutTrans", "relu_b", "concat")) << "the op name exists";
+    CHECK(!graph->InsertOp("trans_b", "LayoutTrans", "relu_a", "concat")) << "no arc relu_a --> concat";
+    CHECK(!graph->InsertOp("trans_b", "LayoutTrans", "relu_b", "unknown")) << "unknown node";
+    CHECK_EQ(graph->size(), size + 1);
+    CHECK_EQ(graph->get_nodes_in_order().size(), exec_size + 1);
+    CHECK(!graph->has_vertex("trans_b"));
+    CHECK_EQ(graph->get_in_arc_its("concat")[1]->bottom(), "relu_b");
+    delete graph;
+    LOG(INFO) << "graph insert op check pass";
+}
+#endif
+
+int main(int argc, const char** argv) {
+    // initial logger
+    logger::init(argv[0]);
+    InitTest();
+    RUN_ALL_TESTS(argv[0]);
+    return 0;
+}
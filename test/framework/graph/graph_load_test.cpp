@@ -0,0 +1,173 @@
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <cstdlib>
+#include <cstdio>
+#include "graph_test.h"
+#include "graph_base.h"
+#include "graph.h"
+#include "framework/model_parser/parser/model_io.h"
+#include "saber/funcs/impl/x86/half_convert_helper.h"
+
+using namespace anakin;
+using namespace anakin::graph;
+
+#if defined(USE_X86_PLACE) && !defined(USE_NANOPB)
+using GraphFP32 = Graph<X86, Precision::FP32>;
+
+std::string load_model_path = "graph_load_test.anakin.bin";
+
+PBlock<X86> new_block(const std::vector<int>& shape, float start, float step) {
+    saber::Shape tmp_shape{shape};
+    auto* block = GraphGlobalMem<X86>::Global().template new_block<AK_FLOAT>(tmp_shape);
+    float* data = static_cast<float*>(block->h_tensor().mutable_data());
+    for (int i = 0; i < tmp_shape.count(); i++) {
+        // a deterministic, not monotonic sequence
+        data[i] = start + step * ((i * 7) % 13 - 6);
+    }
+    return *block;
+}
+
+void add_dense_op(GraphFP32* graph, const std::string& name, const std::string& in,
+                  const std::string& out, int in_dim, int out_dim) {
+    graph->AddOp(name, "Dense", {in}, {out});
+    graph->AddOpAttr(name, "out_dim", out_dim);
+    graph->AddOpAttr(name, "bias_term", true);
+    graph->AddOpAttr(name, "axis", 1);
+    graph->AddOpAttr(name, "weight_1", new_block({1, 1, out_dim, in_dim}, 0.05f, 0.03f));
+    graph->AddOpAttr(name, "weight_2", new_block({1, 1, 1, out_dim}, 0.1f, 0.2f));
+}
+
+/**
+ * \brief fc_big holds weights above ParallelWeightsBytes, they are converted on the
+ *  loader threads, the weights of fc_small are always converted inline.
+ */
+void save_model() {
+    GraphFP32* graph = new GraphFP32();
+    add_dense_op(graph, "fc_big", "x", "fc_big_out", 512, 640);
+    add_dense_op(graph, "fc_small", "fc_big_out", "y", 640, 16);
+    CHECK(graph->Freeze()) << "Freeze error";
+    // the saved nodes are the ones in exec order
+    graph->Optimize(false);
+    CHECK_GE(640 * 512 * sizeof(float), ParallelWeightsBytes);
+    CHECK(graph->save(load_model_path)) << "save error";
+    delete graph;
+}
+
+std::string read_model() {
+    std::ifstream input(load_model_path, std::ios::in | std::ios::binary);
+    std::stringstream buffer;
+    buffer << input.rdbuf();
+    return buffer.str();
+}
+
+/*the old path: parse the whole GraphProto, then convert the weights node by node*/
+void load_full_parse(GraphFP32* graph, const std::string& model) {
+    GraphProto graph_proto;
+    CHECK(graph_proto.ParseFromString(model)) << "Parsing GraphProto error";
+    parser::NodeIO<X86, Precision::FP32> node_io;
+    node_io.set_weights_dtype(graph->weights_dtype());
+    node_io.set_weights_threads(1);
+    for (int i = 0; i < graph_proto.nodes().size(); i++) {
+        node_io >> graph_proto.nodes()[i];
+    }
+    node_io << *graph;
+}
+
+void check_weights(GraphFP32* graph, GraphFP32* ref, const std::string& node_name,
+                   const std::string& weights_name) {
+    auto block = (*graph)[node_name]->template get_attr<PBlock<X86> >(weights_name);
+    auto ref_block = (*ref)[node_name]->template get_attr<PBlock<X86> >(weights_name);
+    auto& tensor = block.h_tensor();
+    auto& ref_tensor = ref_block.h_tensor();
+    CHECK_EQ(tensor.get_dtype(), ref_tensor.get_dtype()) << node_name << " " << weights_name;
+    CHECK(tensor.valid_shape() == ref_tensor.valid_shape()) << node_name << " " << weights_name;
+    CHECK_EQ(tensor.valid_size(), ref_tensor.valid_size()) << node_name << " " << weights_name;
+    size_t bytes = tensor.valid_size() * type_length(tensor.get_dtype());
+    const char* data = static_cast<const char*>(tensor.data());
+    const char* ref_data = static_cast<const char*>(ref_tensor.data());
+    for (size_t i = 0; i < bytes; i++) {
+        CHECK_EQ(data[i], ref_data[i]) << node_name << " " << weights_name << " mismatch at byte " << i;
+    }
+}
+
+void check_graph(GraphFP32* graph, GraphFP32* ref) {
+    CHECK_EQ(graph->size(), ref->size());
+    for (std::string name : {"fc_big", "fc_small"}) {
+        CHECK(graph->has_vertex(name)) << name << " not loaded";
+        CHECK_EQ((*graph)[name]->get_op_name(), (*ref)[name]->get_op_name());
+        CHECK_EQ((*graph)[name]->template get_attr<int>("out_dim"),
+                 (*ref)[name]->template get_attr<int>("out_dim"));
+        check_weights(graph, ref, name, "weight_1");
+        check_weights(graph, ref, name, "weight_2");
+    }
+}
+
+/*fp16 / bf16 weight_1 holds the fp32 weights rounded, the bias stays fp32*/
+void check_half_weights(GraphFP32* graph, GraphFP32* fp32_graph, DataType dtype) {
+    for (std::string name : {"fc_big", "fc_small"}) {
+        auto block = (*graph)[name]->template get_attr<PBlock<X86> >("weight_1");
+        auto fp32_block = (*fp32_graph)[name]->template get_attr<PBlock<X86> >("weight_1");
+        auto& tensor = block.h_tensor();
+        auto& fp32_tensor = fp32_block.h_tensor();
+        CHECK_EQ(tensor.get_dtype(), dtype) << name;
+        CHECK_EQ(fp32_tensor.get_dtype(), AK_FLOAT) << name;
+        CHECK_EQ(tensor.valid_size(), fp32_tensor.valid_size()) << name;
+        const uint16_t* data = static_cast<const uint16_t*>(tensor.data());
+        const float* fp32_data = static_cast<const float*>(fp32_tensor.data());
+        for (int i = 0; i < tensor.valid_size(); i++) {
+            CHECK_EQ(data[i], saber::fp32_to_half(fp32_data[i], dtype)) << name << " mismatch at " << i;
+        }
+        auto bias = (*graph)[name]->template get_attr<PBlock<X86> >("weight_2");
+        CHECK_EQ(bias.h_tensor().get_dtype(), AK_FLOAT) << name;
+    }
+}
+
+TEST(GraphTest, graph_load_streamed_test) {
+    save_model();
+    std::string model = read_model();
+    // run the weights conversion on a pool whatever the cores of the host
+    setenv("ANAKIN_WEIGHTS_LOAD_THREADS", "4", 1);
+
+    GraphFP32* fp32_graph = new GraphFP32();
+    CHECK(fp32_graph->load(load_model_path)) << "load fp32 error";
+
+    for (DataType dtype : {AK_FLOAT, AK_HALF, AK_BFLOAT16}) {
+        GraphFP32* ref = new GraphFP32();
+        ref->SetWeightsDtype(dtype);
+        load_full_parse(ref, model);
+
+        GraphFP32* from_file = new GraphFP32();
+        from_file->SetWeightsDtype(dtype);
+        CHECK(from_file->load(load_model_path)) << "load from file error";
+        check_graph(from_file, ref);
+
+        GraphFP32* from_buffer = new GraphFP32();
+        from_buffer->SetWeightsDtype(dtype);
+        CHECK(from_buffer->load(model.data(), model.size())) << "load from buffer error";
+        check_graph(from_buffer, ref);
+        CHECK_EQ(from_buffer->get_ins().size(), from_file->get_ins().size());
+        CHECK_EQ(from_buffer->get_outs().size(), from_file->get_outs().size());
+        if (dtype != AK_FLOAT) {
+            check_half_weights(from_file, fp32_graph, dtype);
+        }
+
+        delete from_buffer;
+        delete from_file;
+        delete ref;
+    }
+    delete fp32_graph;
+
+    unsetenv("ANAKIN_WEIGHTS_LOAD_THREADS");
+    std::remove(load_model_path.c_str());
+    LOG(INFO) << "streamed load check pass";
+}
+#endif
+
+int main(int argc, const char** argv) {
+    // initial logger
+    logger::init(argv[0]);
+    InitTest();
+    RUN_ALL_TESTS(argv[0]);
+    return 0;
+}
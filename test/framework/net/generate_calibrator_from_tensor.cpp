@@ -26,6 +26,7 @@ std::string g_data_file = "./data_list.txt";
 std::string g_calibrator_file = "./calibrator.txt";
 int g_batch_size = 1;
 int g_bin_num = 2048;
+CalibrationAlgoType g_algo = ENTROPY;
 
 Tensor<X86> g_tensor;
 Shape g_shape;
@@ -65,9 +66,10 @@ TEST(NetTest, calibrator) {
     Net<Target, Precision::FP32, OpRunType::SYNC> net_executer(*graph);
     g_shape = net_executer.get_in(input_names[0])->valid_shape();
     BatchStream<Target> batch_stream(data_producer);
-    EntropyCalibrator<Target> entropy_calibrator(&batch_stream, g_batch_size, g_calibrator_file,
-            &net_executer, g_bin_num);
-    entropy_calibrator.generate_calibrator_table();
+    Calibrator<Target>* calibrator = create_calibrator<Target>(g_algo, &batch_stream, g_batch_size,
+            g_calibrator_file, &net_executer, g_bin_num);
+    calibrator->generate_calibrator_table();
+    delete calibrator;
 
     delete graph;
 
@@ -85,6 +87,7 @@ int main(int argc, const char** argv) {
     LOG(INFO) << "   lite_model:     path to anakin lite model";
     LOG(INFO) << "   data_file:      path to image data list";
     LOG(INFO) << "   calibrate file: path to calibrate data path";
+    LOG(INFO) << "   algorithm:      optional, 0 entropy, 1 maxabs, 2 percentile, 3 mse, 4 auto";
 
     if (argc < 5) {
         LOG(ERROR) << "useage: " << argv[0] << " <lite model> <data_file> <calibrate_file>";
@@ -95,6 +98,9 @@ int main(int argc, const char** argv) {
     g_data_file = argv[2];
     g_calibrator_file = argv[3];
     g_batch_size = atoi(argv[4]);
+    if (argc > 5) {
+        g_algo = CalibrationAlgoType(atoi(argv[5]));
+    }
 
     InitTest();
     RUN_ALL_TESTS(argv[0]);
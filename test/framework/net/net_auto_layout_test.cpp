@@ -0,0 +1,133 @@
+#include <string>
+#include <algorithm>
+#include "net_test.h"
+#include "framework/core/net/auto_layout_config.h"
+
+#if defined(USE_X86_PLACE)
+using Target = X86;
+
+using GraphFP32 = Graph<Target, Precision::FP32>;
+
+void add_conv_op(GraphFP32* graph, const std::string& name, const std::string& in,
+                 const std::string& out, int in_channel, int out_channel, int group) {
+    graph->AddOp(name, "Convolution", {in}, {out});
+    Shape weights_shape({out_channel, in_channel / group, 3, 3}, Layout_NCHW);
+    auto* weights = GraphGlobalMem<Target>::Global().template new_block<AK_FLOAT>(weights_shape, graph);
+    graph->AddOpAttr(name, "weight_1", *weights);
+    graph->AddOpAttr(name, "group", group);
+    graph->AddOpAttr(name, "bias_term", false);
+    graph->AddOpAttr(name, "padding", PTuple<int>(1, 1));
+    graph->AddOpAttr(name, "strides", PTuple<int>(1, 1));
+    graph->AddOpAttr(name, "dilation_rate", PTuple<int>(1, 1));
+    graph->AddOpAttr(name, "filter_num", out_channel);
+    graph->AddOpAttr(name, "kernel_size", PTuple<int>(3, 3));
+    graph->AddOpAttr(name, "axis", 1);
+}
+
+void add_softmax_op(GraphFP32* graph, const std::string& name, const std::string& in,
+                    const std::string& out) {
+    graph->AddOp(name, "Softmax", {in}, {out});
+    graph->AddOpAttr(name, "axis", 1);
+}
+
+/**
+ * \brief conv, relu and the depthwise conv run blocked, both softmax read nchw,
+ *  so the blocked region ends with a LayoutTrans on each softmax input.
+ */
+GraphFP32* build_graph() {
+    GraphFP32* graph = new GraphFP32();
+    add_conv_op(graph, "conv", "x", "conv_out", 3, 16, 1);
+    graph->AddOp("relu", "ReLU", {"conv_out"}, {"relu_out"});
+    graph->AddOpAttr("relu", "alpha", 0.f);
+    add_softmax_op(graph, "relu_softmax", "relu_out", "y0");
+    add_conv_op(graph, "dw_conv", "relu_out", "dw_out", 16, 16, 16);
+    add_softmax_op(graph, "dw_softmax", "dw_out", "y1");
+    CHECK(graph->Freeze()) << "Freeze error";
+    graph->Optimize(false);
+    graph->AddOpAttr("x", "input_shape", PTuple<int>(1, 3, 8, 8));
+    return graph;
+}
+
+int exec_index(GraphFP32* graph, const std::string& name) {
+    auto& exec_order = graph->get_nodes_in_order();
+    auto it = std::find(exec_order.begin(), exec_order.end(), name);
+    return it == exec_order.end() ? -1 : it - exec_order.begin();
+}
+
+void check_region(bool support_c16) {
+    const std::string block = support_c16 ? "nchw_c16r" : "nchw_c8r";
+    GraphFP32* graph = build_graph();
+    int size = graph->size();
+    AutoLayoutConfigHelper<Target, Precision::FP32> helper;
+    helper.scane_region_layout(*graph, support_c16);
+    auto layout = helper.get_config_layout();
+    CHECK_EQ(layout["x_conv"], "nchw");
+    CHECK_EQ(layout["conv_relu"], block);
+    // Freeze splits the output of relu
+    CHECK_EQ(layout["relu_relu_outsplit"], block);
+    CHECK_EQ(layout["relu_outsplit_relu_softmax"], block);
+    CHECK_EQ(layout["relu_outsplit_dw_conv"], block);
+    // the depthwise kernel only writes blocked data
+    CHECK_EQ(layout["dw_conv_dw_softmax"], block);
+    CHECK_EQ(graph->size(), size) << "the scan must not change the graph";
+
+    CHECK(helper.insert_layout_trans(*graph)) << "insert layout trans error";
+    CHECK_EQ(graph->size(), size + 2);
+
+    for (std::string softmax : {"relu_softmax", "dw_softmax"}) {
+        auto& in_arcs = graph->get_in_arc_its(softmax);
+        CHECK_EQ(in_arcs.size(), 1);
+        std::string trans = in_arcs[0]->bottom();
+        CHECK_EQ((*graph)[trans]->get_op_name(), "LayoutTrans");
+        CHECK_EQ(exec_index(graph, trans) + 1, exec_index(graph, softmax));
+        std::string producer = graph->get_in_arc_its(trans)[0]->bottom();
+        CHECK_EQ(trans, producer + "_" + softmax + "_layout_trans");
+    }
+
+    layout = helper.get_config_layout();
+    CHECK_EQ(layout.count("relu_outsplit_relu_softmax"), 0) << "the split edge is replaced";
+    CHECK_EQ(layout["relu_outsplit_relu_outsplit_relu_softmax_layout_trans"], block);
+    CHECK_EQ(layout["relu_outsplit_relu_softmax_layout_trans_relu_softmax"], "nchw");
+    CHECK_EQ(layout["dw_conv_dw_conv_dw_softmax_layout_trans"], block);
+    CHECK_EQ(layout["dw_conv_dw_softmax_layout_trans_dw_softmax"], "nchw");
+    CHECK(helper.check_merge(*graph));
+    delete graph;
+}
+
+TEST(NetTest, net_auto_layout_region) {
+    check_region(false);
+    check_region(true);
+    LOG(INFO) << "auto layout region check pass";
+}
+
+TEST(NetTest, net_auto_layout_insert_fail) {
+    GraphFP32* graph = build_graph();
+    AutoLayoutConfigHelper<Target, Precision::FP32> helper;
+    helper.scane_region_layout(*graph, false);
+    // the name of the second layout trans is taken, the first one must not be inserted either
+    std::string taken = exec_index(graph, "relu_softmax") < exec_index(graph, "dw_softmax") ?
+                        "dw_conv_dw_softmax_layout_trans" : "relu_outsplit_relu_softmax_layout_trans";
+    CHECK(graph->InsertOp(taken, "ReLU", "conv", "relu"));
+    int size = graph->size();
+    std::vector<std::string> exec_order = graph->get_nodes_in_order();
+
+    CHECK(!helper.insert_layout_trans(*graph)) << "the name of a layout trans is taken";
+    CHECK_EQ(graph->size(), size);
+    CHECK(graph->get_nodes_in_order() == exec_order);
+    CHECK_EQ(graph->get_in_arc_its("relu_softmax")[0]->bottom(), "relu_outsplit");
+    CHECK_EQ(graph->get_in_arc_its("dw_softmax")[0]->bottom(), "dw_conv");
+    delete graph;
+    LOG(INFO) << "auto layout insert fail check pass";
+}
+#endif
+
+int main(int argc, const char** argv) {
+#ifdef USE_X86_PLACE
+    Env<Target>::env_init();
+#endif
+    // initial logger
+    logger::init(argv[0]);
+    InitTest();
+    RUN_ALL_TESTS(argv[0]);
+    return 0;
+}
@@ -0,0 +1,156 @@
+#include <string>
+#include <thread>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include "net_test.h"
+#include "framework/c_api/anakin_runner.h"
+
+#if defined(USE_X86_PLACE) && !defined(USE_NANOPB)
+using Target = X86;
+
+using GraphFP32 = Graph<Target, Precision::FP32>;
+
+std::string c_api_model_path = "net_c_api_test.anakin.bin";
+const int in_dim = 16;
+const int out_dim = 8;
+const int max_batch = 4;
+
+PBlock<Target> new_block(const std::vector<int>& shape, float start, float step) {
+    saber::Shape tmp_shape{shape};
+    auto* block = GraphGlobalMem<Target>::Global().template new_block<AK_FLOAT>(tmp_shape);
+    float* data = static_cast<float*>(block->h_tensor().mutable_data());
+    for (int i = 0; i < tmp_shape.count(); i++) {
+        data[i] = start + step * ((i * 7) % 13 - 6);
+    }
+    return *block;
+}
+
+void add_dense_op(GraphFP32* graph, const std::string& name, const std::string& in,
+                  const std::string& out, int in_size, int out_size) {
+    graph->AddOp(name, "Dense", {in}, {out});
+    graph->AddOpAttr(name, "out_dim", out_size);
+    graph->AddOpAttr(name, "bias_term", true);
+    graph->AddOpAttr(name, "axis", 1);
+    graph->AddOpAttr(name, "weight_1", new_block({1, 1, out_size, in_size}, 0.05f, 0.03f));
+    graph->AddOpAttr(name, "weight_2", new_block({1, 1, 1, out_size}, 0.1f, 0.2f));
+}
+
+/**
+ * \brief x --> fc_0 --> relu --> fc_1 --> y
+ */
+void save_model() {
+    GraphFP32* graph = new GraphFP32();
+    add_dense_op(graph, "fc_0", "x", "fc_0_out", in_dim, 32);
+    graph->AddOp("relu", "ReLU", {"fc_0_out"}, {"relu_out"});
+    graph->AddOpAttr("relu", "alpha", 0.f);
+    add_dense_op(graph, "fc_1", "relu_out", "y", 32, out_dim);
+    CHECK(graph->Freeze()) << "Freeze error";
+    // the saved nodes are the ones in exec order
+    graph->Optimize(false);
+    graph->AddOpAttr("x", "input_shape", PTuple<int>(1, in_dim, 1, 1));
+    CHECK(graph->save(c_api_model_path)) << "save error";
+    delete graph;
+}
+
+std::vector<float> make_input(int batch, float phase) {
+    std::vector<float> data(batch * in_dim);
+    for (int i = 0; i < data.size(); i++) {
+        data[i] = std::sin(0.37f * i + phase) * 2.f;
+    }
+    return data;
+}
+
+/*output of the input copied into the net of a context, without bound memory*/
+std::vector<float> predict_copied(AnakinRunerContextInterface* context, std::vector<float>& input) {
+    std::vector<int> shape{int(input.size()) / in_dim, in_dim, 1, 1};
+    auto* in_tensor = context->get_input_tensor(0);
+    in_tensor->set_host_shape(shape);
+    memcpy(in_tensor->get_host_data(), input.data(), input.size() * sizeof(float));
+    context->prediction();
+    auto* out_tensor = context->get_output_tensor(0);
+    const float* out_data = static_cast<const float*>(out_tensor->get_host_data());
+    return std::vector<float>(out_data, out_data + out_tensor->get_host_size());
+}
+
+void check_output(const std::vector<float>& out, const std::vector<float>& ref, const std::string& name) {
+    for (int i = 0; i < ref.size(); i++) {
+        CHECK_EQ(out[i], ref[i]) << name << " output mismatch at " << i;
+    }
+}
+
+/**
+ * \brief two contexts of one model predict at the same time from bound memory,
+ *  each matches the output of a context predicting alone.
+ */
+TEST(NetTest, net_c_api_shared_model) {
+    save_model();
+    AnakinRunerModelInterface* model = get_anakinrun_model("X86", 0);
+    CHECK(model->load_model(c_api_model_path, max_batch)) << "load model error";
+
+    std::vector<std::vector<float>> inputs{make_input(2, 0.f), make_input(3, 1.f)};
+    std::vector<std::vector<float>> refs;
+    AnakinRunerContextInterface* ref_context = model->create_context(1);
+    CHECK(ref_context != nullptr);
+    CHECK_EQ(ref_context->get_input_number(), 1);
+    CHECK_EQ(ref_context->get_output_number(), 1);
+    for (auto& input : inputs) {
+        refs.push_back(predict_copied(ref_context, input));
+        CHECK_EQ(refs.back().size(), input.size() / in_dim * out_dim);
+    }
+    CHECK(refs[0] != std::vector<float>(refs[1].begin(), refs[1].begin() + refs[0].size()));
+    delete ref_context;
+
+    AnakinRunerContextInterface* contexts[2] = {model->create_context(1), model->create_context(1)};
+    // the first context is written in place, the output of the second one is copied out
+    std::vector<float> outs[2] = {std::vector<float>(max_batch * out_dim),
+                                  std::vector<float>(max_batch * out_dim)};
+
+    for (int swap = 0; swap < 2; swap++) {
+        for (int c = 0; c < 2; c++) {
+            auto& input = inputs[c ^ swap];
+            std::vector<int> shape{int(input.size()) / in_dim, in_dim, 1, 1};
+            CHECK(contexts[c]->bind_input(0, input.data(), shape));
+            size_t capacity = (c == 0 ? outs[c].size() : refs[c ^ swap].size()) * sizeof(float);
+            CHECK(contexts[c]->bind_output(0, outs[c].data(), capacity));
+        }
+
+        std::vector<std::thread> workers;
+        for (int c = 0; c < 2; c++) {
+            workers.emplace_back([&, c]() {
+                for (int iter = 0; iter < 8; iter++) {
+                    std::fill(outs[c].begin(), outs[c].end(), -7.f);
+                    contexts[c]->prediction();
+                    check_output(outs[c], refs[c ^ swap], "context " + std::to_string(c));
+                }
+            });
+        }
+        for (auto& worker : workers) {
+            worker.join();
+        }
+    }
+
+    // unbound, the contexts predict from their own tensors again
+    for (int c = 0; c < 2; c++) {
+        std::vector<int> shape;
+        CHECK(contexts[c]->bind_input(0, nullptr, shape));
+        CHECK(contexts[c]->bind_output(0, nullptr, 0));
+        check_output(predict_copied(contexts[c], inputs[c]), refs[c], "unbound context");
+        delete contexts[c];
+    }
+    delete model;
+    std::remove(c_api_model_path.c_str());
+    LOG(INFO) << "c api shared model check pass";
+}
+#endif
+
+int main(int argc, const char** argv) {
+#ifdef USE_X86_PLACE
+    Env<X86>::env_init();
+#endif
+    // initial logger
+    logger::init(argv[0]);
+    InitTest();
+    RUN_ALL_TESTS(argv[0]);
+    return 0;
+}
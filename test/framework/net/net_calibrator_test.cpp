@@ -0,0 +1,395 @@
+#include <string>
+#include <cmath>
+#include "net_test.h"
+#include "framework/core/net/calibrator_factory.h"
+#include "framework/core/net/entropy_calibrator.h"
+#include "framework/core/net/percentile_calibrator.h"
+#include "framework/core/net/mse_calibrator.h"
+#include "framework/core/net/auto_calibrator.h"
+
+#if defined(USE_X86_PLACE)
+using Target = X86;
+
+/**
+ * \brief a calibrator of one tensor whose histogram is set by the test or
+ *  gathered from tensors handed to it, no net and no batch stream.
+ */
+template<typename Base>
+class CalibratorProbe: public Base {
+public:
+    template<typename... Args>
+    CalibratorProbe(int bin_num, Args... args):
+        Base(nullptr, 1, "", nullptr, bin_num, args...) {
+        this->init_statistics(1);
+    }
+
+    void set_histogram(const std::vector<int64_t>& hist, float range, float max_value) {
+        CHECK_EQ(hist.size(), this->get_bin_num());
+        this->_hist_vecs[0] = hist;
+        this->_hist_range_vec[0] = range;
+        this->_max_vec[0] = max_value;
+    }
+
+    void add(Tensor4d<Target>& tensor, bool parallel) {
+        this->statistic(&tensor, 0, parallel);
+    }
+
+    float clip() {
+        return this->get_clip_value(0);
+    }
+
+    int kl_threshold() {
+        return this->get_kl_threshold(0);
+    }
+
+    double quant_error(float clip) {
+        return this->get_quant_error(0, clip);
+    }
+
+    float edge(int bin_id) {
+        return this->bin_edge(0, bin_id);
+    }
+
+    CalibrationAlgoType auto_algo() {
+        this->_algo_vec.assign(1, ENTROPY);
+        this->get_clip_value(0);
+        return this->_algo_vec[0];
+    }
+
+    std::vector<int64_t>& hist() {
+        return this->hist_vecs()[0];
+    }
+
+    float max_value() {
+        return this->max_vec()[0];
+    }
+
+    float range() {
+        return this->_hist_range_vec[0];
+    }
+};
+
+/**
+ * \brief kl divergence of every threshold of the entropy calibrator written out:
+ *  bins 1 to i with the outliers added to the last one are merged into 128 bins,
+ *  spread back over the non empty bins and compared with the whole histogram.
+ */
+int naive_kl_threshold(const std::vector<int64_t>& hist) {
+    const int bin_num = hist.size();
+    auto overlap = [](double a0, double a1, double b0, double b1) {
+        return std::max(0.0, std::min(a1, b1) - std::max(a0, b0));
+    };
+    double sum_hist = 0;
+    int64_t total = 0;
+    for (int j = 0; j < bin_num; j++) {
+        sum_hist += hist[j];
+        total += j > 0 ? hist[j] : 0;
+    }
+    int thresh = 0;
+    double min_kl = 1e30;
+    for (int i = 129; i < bin_num - 1; i++) {
+        std::vector<double> p(i);
+        int64_t in_range = 0;
+        for (int j = 0; j < i; j++) {
+            p[j] = hist[j + 1];
+            in_range += j < i - 1 ? hist[j + 1] : 0;
+        }
+        p[i - 1] += total - in_range;
+        double step = i / 128.0;
+        std::vector<double> q(i, 0.0);
+        for (int k = 0; k < 128; k++) {
+            double merged = 0;
+            double covered = 0;
+            for (int j = 0; j < i; j++) {
+                double w = overlap(j, j + 1, k * step, (k + 1) * step);
+                merged += w * p[j];
+                covered += p[j] != 0 ? w : 0;
+            }
+            for (int j = 0; j < i; j++) {
+                double w = overlap(j, j + 1, k * step, (k + 1) * step);
+                if (p[j] != 0 && w > 0) {
+                    q[j] += merged * w / covered;
+                }
+            }
+        }
+        double sum_q = 0;
+        for (int j = 0; j < i; j++) {
+            sum_q += q[j];
+        }
+        double kl = 0;
+        for (int j = 0; j < i - 1; j++) {
+            if (hist[j] != 0 && q[j] != 0) {
+                double p_prob = hist[j] / sum_hist;
+                kl += p_prob * std::log2(p_prob / (q[j] / sum_q));
+            }
+        }
+        double tail_q = q[i - 1] / sum_q / (bin_num - i + 1);
+        for (int j = i - 1; j < bin_num; j++) {
+            if (hist[j] > 0) {
+                double p_prob = hist[j] / sum_hist;
+                kl += p_prob * std::log2(p_prob / tail_q);
+            }
+        }
+        if (kl < min_kl) {
+            min_kl = kl;
+            thresh = i;
+        }
+    }
+    return thresh;
+}
+
+/*the documented int8 error of a clip value, from the bin centers*/
+double naive_quant_error(const std::vector<int64_t>& hist, float range, float clip) {
+    double width = double(range) / hist.size();
+    double step = clip / 127.0;
+    double error = 0;
+    for (int i = 0; i < hist.size(); i++) {
+        double center = width * (i + 0.5);
+        double e = step * step / 12;
+        if (center > clip) {
+            e = (center - clip) * (center - clip);
+        } else if (center < step / 2) {
+            e = center * center;
+        }
+        error += e * hist[i];
+    }
+    return error;
+}
+
+/*cosine of the bin centers and their int8 round trip, the measure auto ranks the clips with*/
+double naive_cosine(const std::vector<int64_t>& hist, float range, float clip) {
+    double width = double(range) / hist.size();
+    double step = clip / 127.0;
+    double dot = 0;
+    double norm_x = 0;
+    double norm_q = 0;
+    for (int i = 0; i < hist.size(); i++) {
+        double x = width * (i + 0.5);
+        double level = std::floor(x / step + 0.5);
+        double q = std::min(level, 127.0) * step;
+        dot += x * q * hist[i];
+        norm_x += x * x * hist[i];
+        norm_q += q * q * hist[i];
+    }
+    return dot / std::sqrt(norm_x * norm_q);
+}
+
+/*a dense |x| distribution that decays over the first bins and a few far outliers*/
+std::vector<int64_t> outlier_histogram(int bin_num, int dense_bins) {
+    std::vector<int64_t> hist(bin_num, 0);
+    for (int i = 0; i < dense_bins; i++) {
+        double x = double(i) / dense_bins;
+        hist[i] = int64_t(1e6 * std::exp(-4 * x * x));
+    }
+    for (int i = bin_num * 3 / 4; i < bin_num; i += bin_num / 16) {
+        hist[i] = 1;
+    }
+    return hist;
+}
+
+/**
+ * \brief values already on the int8 levels of their max, e.g. the output of a quantized op,
+ *  dense on the first levels with a few on the last ones.
+ */
+std::vector<int64_t> level_histogram(int bin_num, float range, float max_value) {
+    std::vector<int64_t> hist(bin_num, 0);
+    for (int k = 0; k <= 127; k++) {
+        int id = std::min(int(max_value * k / 127 / range * bin_num), bin_num - 1);
+        if (k < 16) {
+            hist[id] += int64_t(1e5 * std::exp(-k * k / 32.0));
+        } else if (k % 16 == 15) {
+            hist[id] += 1;
+        }
+    }
+    return hist;
+}
+
+Tensor4d<Target>* new_tensor(const std::vector<float>& values) {
+    auto* tensor = new Tensor4d<Target>(Shape({1, 1, 1, int(values.size())}, Layout_NCHW));
+    memcpy(tensor->mutable_data(), values.data(), values.size() * sizeof(float));
+    return tensor;
+}
+
+TEST(NetTest, net_calibrator_histogram_rebin) {
+    const int bin_num = 2048;
+    /*values on the bin centers of the final range 3, batches widen the range from 0 to 1 to 3*/
+    auto center = [](int j) {
+        return (j + 0.5f) * 3.f / 2048;
+    };
+    std::vector<std::vector<float>> batches(4);
+    batches[0].assign(100, 0.f);
+    for (int j = 0; center(j) < 1.f; j += 5) {
+        batches[1].push_back(j % 2 ? -center(j) : center(j));
+    }
+    batches[1].push_back(1.f);
+    for (int k = 0; k < 70000; k++) {
+        int j = (k * 7) % bin_num;
+        if (center(j) < 2.5f) {
+            batches[2].push_back(k % 3 ? center(j) : -center(j));
+        }
+    }
+    batches[2].push_back(-2.5f);
+    for (int j = 0; center(j) < 2.f; j += 3) {
+        batches[3].push_back(center(j));
+    }
+    batches[3].push_back(2.f);
+
+    std::vector<int64_t> ref(bin_num, 0);
+    for (auto& batch : batches) {
+        for (float x : batch) {
+            int id = int(std::floor(std::fabs(double(x)) * bin_num / 3));
+            ref[std::min(id, bin_num - 1)]++;
+        }
+    }
+    for (bool parallel : {false, true}) {
+        CalibratorProbe<EntropyCalibrator<Target>> probe(bin_num);
+        for (auto& batch : batches) {
+            Tensor4d<Target>* tensor = new_tensor(batch);
+            probe.add(*tensor, parallel);
+            delete tensor;
+        }
+        CHECK_EQ(probe.max_value(), 2.5f);
+        CHECK_EQ(probe.range(), 3.f) << "the range grows by an integer factor";
+        for (int i = 0; i < bin_num; i++) {
+            CHECK_EQ(probe.hist()[i], ref[i]) << "bin " << i << " parallel " << parallel;
+        }
+    }
+    LOG(INFO) << "calibrator histogram rebin check pass";
+}
+
+TEST(NetTest, net_calibrator_percentile) {
+    /*90 values in bin 2, 9 in bin 5 and one in bin 15 of [0, 16)*/
+    std::vector<int64_t> hist(16, 0);
+    hist[2] = 90;
+    hist[5] = 9;
+    hist[15] = 1;
+    std::vector<std::pair<float, float>> cases = {
+        {50.f, 3.f}, {90.f, 3.f}, {90.5f, 6.f}, {99.f, 6.f}, {99.5f, 15.5f}, {100.f, 15.5f}};
+    for (auto& c : cases) {
+        CalibratorProbe<PercentileCalibrator<Target>> probe(16, c.first);
+        probe.set_histogram(hist, 16.f, 15.5f);
+        CHECK_EQ(probe.clip(), c.second) << "percentile " << c.first;
+        CHECK_EQ(probe.get_algorithm(), c.first >= 100.f ? MAXABS : PERCENTILE);
+    }
+    LOG(INFO) << "calibrator percentile check pass";
+}
+
+TEST(NetTest, net_calibrator_mse) {
+    const int bin_num = 2048;
+    const float range = 2048.f;
+    std::vector<int64_t> hist = outlier_histogram(bin_num, 200);
+    CalibratorProbe<MseCalibrator<Target>> probe(bin_num);
+    probe.set_histogram(hist, range, 2047.75f);
+    for (float clip : {1.f, 100.f, 1000.f, 2047.75f}) {
+        double ref = naive_quant_error(hist, range, clip);
+        CHECK_LE(std::fabs(probe.quant_error(clip) - ref), 1e-9 * ref) << "clip " << clip;
+    }
+    /*the least error over the bin edges under the max and the max itself*/
+    auto naive_mse_clip = [&](const std::vector<int64_t>& h, float max_value) {
+        float best = max_value;
+        double min_error = naive_quant_error(h, range, max_value);
+        for (int i = 1; i < bin_num && probe.edge(i) < max_value; i++) {
+            double error = naive_quant_error(h, range, probe.edge(i));
+            if (error < min_error) {
+                min_error = error;
+                best = probe.edge(i);
+            }
+        }
+        return best;
+    };
+    CHECK_EQ(probe.clip(), naive_mse_clip(hist, 2047.75f));
+    CHECK_LT(probe.clip(), 1024.f) << "the outliers should be clipped";
+
+    /*a flat histogram has no outliers, only its last bins are clipped*/
+    std::vector<int64_t> flat(bin_num, 100);
+    probe.set_histogram(flat, range, 2047.75f);
+    CHECK_EQ(probe.clip(), naive_mse_clip(flat, 2047.75f));
+    CHECK_GT(probe.clip(), 0.99f * 2047.75f);
+    LOG(INFO) << "calibrator mse check pass";
+}
+
+TEST(NetTest, net_calibrator_entropy) {
+    const int bin_num = 2048;
+    std::vector<int64_t> hist = outlier_histogram(bin_num, 600);
+    CalibratorProbe<EntropyCalibrator<Target>> probe(bin_num);
+    probe.set_histogram(hist, 4.f, 3.99f);
+    int thresh = probe.kl_threshold();
+    CHECK_EQ(thresh, naive_kl_threshold(hist)) << "not the kl argmin";
+    CHECK_GT(thresh, 128);
+    CHECK_LT(thresh, bin_num * 3 / 4) << "the outliers should be clipped";
+    CHECK_EQ(probe.clip(), probe.edge(thresh + 1));
+
+    /*a histogram too short to search keeps the max*/
+    CalibratorProbe<EntropyCalibrator<Target>> short_probe(128);
+    short_probe.set_histogram(std::vector<int64_t>(128, 10), 4.f, 3.99f);
+    CHECK_EQ(short_probe.kl_threshold(), 0);
+    CHECK_EQ(short_probe.clip(), 3.99f);
+    LOG(INFO) << "calibrator entropy check pass";
+}
+
+TEST(NetTest, net_calibrator_auto) {
+    const int bin_num = 2048;
+    const float max_value = 3.99f;
+    std::vector<std::vector<int64_t>> hists;
+    for (int dense_bins : {200, 600, 2048}) {
+        hists.push_back(outlier_histogram(bin_num, dense_bins));
+    }
+    hists.push_back(level_histogram(bin_num, 4.f, max_value));
+    /*the mse clip has the least error, auto does not always keep it*/
+    int others_kept = 0;
+    for (auto& hist : hists) {
+        CalibratorProbe<AutoCalibrator<Target>> probe(bin_num, 99.f);
+        probe.set_histogram(hist, 4.f, max_value);
+        CalibratorProbe<EntropyCalibrator<Target>> entropy(bin_num);
+        CalibratorProbe<PercentileCalibrator<Target>> percentile(bin_num, 99.f);
+        CalibratorProbe<MseCalibrator<Target>> mse(bin_num);
+        CalibratorProbe<PercentileCalibrator<Target>> maxabs(bin_num, 100.f);
+        const CalibrationAlgoType algos[] = {ENTROPY, PERCENTILE, MSE, MAXABS};
+        float clips[4];
+        int best = 0;
+        entropy.set_histogram(hist, 4.f, max_value);
+        percentile.set_histogram(hist, 4.f, max_value);
+        mse.set_histogram(hist, 4.f, max_value);
+        maxabs.set_histogram(hist, 4.f, max_value);
+        clips[0] = entropy.clip();
+        clips[1] = percentile.clip();
+        clips[2] = mse.clip();
+        clips[3] = maxabs.clip();
+        for (int i = 1; i < 4; i++) {
+            if (naive_cosine(hist, 4.f, clips[i]) > naive_cosine(hist, 4.f, clips[best])) {
+                best = i;
+            }
+        }
+        CHECK_EQ(probe.auto_algo(), algos[best]);
+        CHECK_EQ(probe.clip(), clips[best]);
+        CHECK_EQ(probe.get_algorithm(), AUTO);
+        others_kept += clips[best] != clips[2];
+    }
+    /*the values on the levels of the max lose nothing but the mse clip cuts the last levels*/
+    CHECK_GT(others_kept, 0) << "auto only repeats the mse clip";
+    LOG(INFO) << "calibrator auto check pass";
+}
+
+TEST(NetTest, net_calibrator_factory) {
+    const std::vector<CalibrationAlgoType> algos = {ENTROPY, MAXABS, PERCENTILE, MSE, AUTO};
+    for (auto algo : algos) {
+        Calibrator<Target>* calibrator = create_calibrator<Target>(algo, nullptr, 1, "", nullptr,
+                2048, 99.9f);
+        CHECK_EQ(calibrator->get_algorithm(), algo);
+        CHECK(dynamic_cast<HistogramCalibrator<Target>*>(calibrator) != nullptr);
+        delete calibrator;
+    }
+    LOG(INFO) << "calibrator factory check pass";
+}
+#endif
+
+int main(int argc, const char** argv) {
+#ifdef USE_X86_PLACE
+    Env<Target>::env_init();
+#endif
+    // initial logger
+    logger::init(argv[0]);
+    InitTest();
+    RUN_ALL_TESTS(argv[0]);
+    return 0;
+}
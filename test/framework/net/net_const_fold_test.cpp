@@ -0,0 +1,225 @@
+#include <string>
+#include <cmath>
+#include "net_test.h"
+
+#if defined(USE_X86_PLACE)
+using Target = X86;
+
+using GraphFP32 = Graph<Target, Precision::FP32>;
+
+void add_priorbox_op(GraphFP32* graph, const std::string& name, const std::vector<std::string>& ins,
+                     const std::string& out, float min_size, float max_size, int img_size) {
+    graph->AddOp(name, "PriorBox", ins, {out});
+    graph->AddOpAttr(name, "min_size", PTuple<float>(min_size));
+    graph->AddOpAttr(name, "max_size", PTuple<float>(max_size));
+    graph->AddOpAttr(name, "aspect_ratio", PTuple<float>(2.f));
+    graph->AddOpAttr(name, "is_flip", true);
+    graph->AddOpAttr(name, "is_clip", false);
+    graph->AddOpAttr(name, "variance", PTuple<float>(0.1f, 0.1f, 0.2f, 0.2f));
+    // 0 reads the size of the image input
+    graph->AddOpAttr(name, "img_h", img_size);
+    graph->AddOpAttr(name, "img_w", img_size);
+    graph->AddOpAttr(name, "step_h", 0.f);
+    graph->AddOpAttr(name, "step_w", 0.f);
+    graph->AddOpAttr(name, "offset", 0.5f);
+    graph->AddOpAttr(name, "order",
+                     PTuple<std::string>(std::vector<std::string>{"MIN", "COM", "MAX"}));
+}
+
+/**
+ * \brief x feeds a relu and two prior boxes, the concat of the prior boxes only has
+ *  constant inputs, so the prior boxes and the concat are folded.
+ */
+GraphFP32* build_graph(const std::vector<int>& x_shape) {
+    GraphFP32* graph = new GraphFP32();
+    add_priorbox_op(graph, "prior_a", {"x"}, "prior_a_out", 30.f, 60.f, 300);
+    add_priorbox_op(graph, "prior_b", {"x"}, "prior_b_out", 60.f, 111.f, 300);
+    graph->AddOp("concat", "Concat", {"prior_a_out", "prior_b_out"}, {"priors"});
+    graph->AddOpAttr("concat", "axis", 2);
+    graph->AddOp("relu", "ReLU", {"x"}, {"y"});
+    graph->AddOpAttr("relu", "alpha", 0.f);
+    CHECK(graph->Freeze()) << "Freeze error";
+    graph->Optimize();
+    graph->AddOpAttr("x", "input_shape", PTuple<int>(std::vector<int>(x_shape)));
+    return graph;
+}
+
+/**
+ * \brief the prior boxes read the size of img, a new image size changes the priors
+ *  but not the shape of the concat inputs.
+ */
+GraphFP32* build_image_graph(const std::vector<int>& x_shape, const std::vector<int>& img_shape) {
+    GraphFP32* graph = new GraphFP32();
+    add_priorbox_op(graph, "prior_a", {"x", "img"}, "prior_a_out", 30.f, 60.f, 0);
+    add_priorbox_op(graph, "prior_b", {"x", "img"}, "prior_b_out", 60.f, 111.f, 0);
+    graph->AddOp("concat", "Concat", {"prior_a_out", "prior_b_out"}, {"priors"});
+    graph->AddOpAttr("concat", "axis", 2);
+    graph->AddOp("relu", "ReLU", {"x"}, {"y"});
+    graph->AddOpAttr("relu", "alpha", 0.f);
+    CHECK(graph->Freeze()) << "Freeze error";
+    graph->Optimize();
+    graph->AddOpAttr("x", "input_shape", PTuple<int>(std::vector<int>(x_shape)));
+    graph->AddOpAttr("img", "input_shape", PTuple<int>(std::vector<int>(img_shape)));
+    return graph;
+}
+
+void fill_input(Net<Target, Precision::FP32>& net) {
+    auto* d_in = net.get_in("x");
+    float* data = static_cast<float*>(d_in->mutable_data());
+    for (int i = 0; i < d_in->valid_size(); i++) {
+        data[i] = std::sin(0.37f * i) * 2.f;
+    }
+}
+
+/*outputs of a net built for x_shape, the reference of the folded outputs after a reshape*/
+std::vector<float> fresh_priors(const std::vector<int>& x_shape) {
+    GraphFP32* graph = build_graph(x_shape);
+    Net<Target, Precision::FP32> net(*graph, true);
+    fill_input(net);
+    net.prediction();
+    auto* d_out = net.get_out("priors");
+    const float* out_data = static_cast<const float*>(d_out->data());
+    std::vector<float> priors(out_data, out_data + d_out->valid_size());
+    delete graph;
+    return priors;
+}
+
+std::vector<float> fresh_image_priors(const std::vector<int>& x_shape,
+                                      const std::vector<int>& img_shape) {
+    GraphFP32* graph = build_image_graph(x_shape, img_shape);
+    Net<Target, Precision::FP32> net(*graph, true);
+    fill_input(net);
+    net.prediction();
+    auto* d_out = net.get_out("priors");
+    const float* out_data = static_cast<const float*>(d_out->data());
+    std::vector<float> priors(out_data, out_data + d_out->valid_size());
+    delete graph;
+    return priors;
+}
+
+void check_relu(Net<Target, Precision::FP32>& net) {
+    auto* d_in = net.get_in("x");
+    auto* d_out = net.get_out("y");
+    CHECK_EQ(d_out->valid_size(), d_in->valid_size());
+    const float* in_data = static_cast<const float*>(d_in->data());
+    const float* out_data = static_cast<const float*>(d_out->data());
+    for (int i = 0; i < d_in->valid_size(); i++) {
+        CHECK_EQ(out_data[i], std::max(in_data[i], 0.f)) << "relu output mismatch at " << i;
+    }
+}
+
+/*overwrite the folded output, only a launch of the concat writes it again*/
+void poison(Tensor4dPtr<Target> tensor) {
+    float* data = static_cast<float*>(tensor->mutable_data());
+    for (int i = 0; i < tensor->valid_size(); i++) {
+        data[i] = -7.f;
+    }
+}
+
+void check_priors(Tensor4dPtr<Target> tensor, const std::vector<float>& ref) {
+    CHECK_EQ(tensor->valid_size(), ref.size());
+    const float* data = static_cast<const float*>(tensor->data());
+    for (int i = 0; i < ref.size(); i++) {
+        CHECK_EQ(data[i], ref[i]) << "prior box mismatch at " << i;
+    }
+}
+
+void check_poisoned(Tensor4dPtr<Target> tensor) {
+    const float* data = static_cast<const float*>(tensor->data());
+    for (int i = 0; i < tensor->valid_size(); i++) {
+        CHECK_EQ(data[i], -7.f) << "a folded op ran again at " << i;
+    }
+}
+
+TEST(NetTest, net_const_fold_scheduler) {
+    GraphFP32* graph = build_graph({1, 4, 6, 8});
+    for (std::string name : {"prior_a", "prior_b", "concat"}) {
+        CHECK((*graph)[name]->is_const()) << name << " should be folded";
+    }
+    for (std::string name : {"x", "relu"}) {
+        CHECK(!(*graph)[name]->is_const()) << name << " should run in every prediction";
+    }
+    delete graph;
+    LOG(INFO) << "const fold scheduler check pass";
+}
+
+TEST(NetTest, net_const_fold_prediction) {
+    std::vector<float> ref_small = fresh_priors({1, 4, 3, 5});
+    std::vector<float> ref = fresh_priors({1, 4, 6, 8});
+    CHECK_NE(ref.size(), ref_small.size());
+
+    GraphFP32* graph = build_graph({1, 4, 6, 8});
+    Net<Target, Precision::FP32> net(*graph, true);
+    auto* priors = net.get_out("priors");
+    // computed at init, before any prediction
+    check_priors(priors, ref);
+
+    poison(priors);
+    for (int i = 0; i < 2; i++) {
+        fill_input(net);
+        net.prediction();
+        check_poisoned(priors);
+        check_relu(net);
+    }
+
+    // a new input shape runs the folded ops once more
+    net.get_in("x")->reshape(Shape({1, 4, 3, 5}, Layout_NCHW));
+    fill_input(net);
+    net.prediction();
+    check_priors(priors, ref_small);
+    check_relu(net);
+
+    poison(priors);
+    net.prediction();
+    check_poisoned(priors);
+
+    net.get_in("x")->reshape(Shape({1, 4, 6, 8}, Layout_NCHW));
+    fill_input(net);
+    net.prediction();
+    check_priors(priors, ref);
+    check_relu(net);
+    delete graph;
+    LOG(INFO) << "const fold prediction check pass";
+}
+
+TEST(NetTest, net_const_fold_image_size) {
+    std::vector<int> x_shape{1, 4, 6, 8};
+    std::vector<float> ref = fresh_image_priors(x_shape, {1, 3, 300, 300});
+    std::vector<float> ref_wide = fresh_image_priors(x_shape, {1, 3, 200, 480});
+    CHECK_EQ(ref.size(), ref_wide.size());
+    CHECK(ref != ref_wide);
+
+    GraphFP32* graph = build_image_graph(x_shape, {1, 3, 300, 300});
+    Net<Target, Precision::FP32> net(*graph, true);
+    auto* priors = net.get_out("priors");
+    check_priors(priors, ref);
+
+    // the prior boxes run again, the concat keeps its input shapes but runs after them
+    net.get_in("img")->reshape(Shape({1, 3, 200, 480}, Layout_NCHW));
+    fill_input(net);
+    net.prediction();
+    check_priors(priors, ref_wide);
+    check_relu(net);
+
+    poison(priors);
+    net.prediction();
+    check_poisoned(priors);
+
+    net.get_in("img")->reshape(Shape({1, 3, 300, 300}, Layout_NCHW));
+    net.prediction();
+    check_priors(priors, ref);
+    delete graph;
+    LOG(INFO) << "const fold image size check pass";
+}
+#endif
+
+int main(int argc, const char** argv) {
+#ifdef USE_X86_PLACE
+    Env<Target>::env_init();
+#endif
+    // initial logger
+    logger::init(argv[0]);
+    InitTest();
+    RUN_ALL_TESTS(argv[0]);
+    return 0;
+}
@@ -0,0 +1,219 @@
+#include <string>
+#include <functional>
+#include <cmath>
+#include "net_test.h"
+#include "graph_global_mem.h"
+
+#if defined(USE_X86_PLACE)
+using Target = X86;
+
+using GraphFP32 = Graph<Target, Precision::FP32>;
+
+PBlock<Target> new_block(const std::vector<int>& shape, float start, float step) {
+    anakin::saber::Shape tmp_shape{shape};
+    auto* block = GraphGlobalMem<Target>::Global().template new_block<AK_FLOAT>(tmp_shape);
+    float* data = static_cast<float*>(block->h_tensor().mutable_data());
+    for (int i = 0; i < tmp_shape.count(); i++) {
+        // a deterministic, not monotonic sequence
+        data[i] = start + step * ((i * 7) % 11 - 5);
+    }
+    block->d_tensor().copy_from(block->h_tensor());
+    return *block;
+}
+
+void add_dense_op(GraphFP32* graph, const std::string& name, const std::string& in,
+                  const std::string& out, int in_dim, int out_dim, bool bias_term) {
+    graph->AddOp(name, "Dense", {in}, {out});
+    graph->AddOpAttr(name, "out_dim", out_dim);
+    graph->AddOpAttr(name, "bias_term", bias_term);
+    graph->AddOpAttr(name, "axis", 1);
+    graph->AddOpAttr(name, "weight_1", new_block({1, 1, out_dim, in_dim}, 0.05f, 0.03f));
+    if (bias_term) {
+        graph->AddOpAttr(name, "weight_2", new_block({1, 1, 1, out_dim}, 0.1f, 0.2f));
+    }
+}
+
+void add_batchnorm_op(GraphFP32* graph, const std::string& name, const std::string& in,
+                      const std::string& out, int channel) {
+    graph->AddOp(name, "BatchNorm", {in}, {out});
+    graph->AddOpAttr(name, "epsilon", 1e-5f);
+    graph->AddOpAttr(name, "weight_1", new_block({1, 1, 1, channel}, 0.3f, 0.1f));
+    graph->AddOpAttr(name, "weight_2", new_block({1, 1, 1, channel}, 1.f, 0.15f));
+    graph->AddOpAttr(name, "weight_3", new_block({1, 1, 1, 1}, 1.f, 0.f));
+}
+
+void add_scale_op(GraphFP32* graph, const std::string& name, const std::string& in,
+                  const std::string& out, int channel, int axis, int num_axes) {
+    graph->AddOp(name, "Scale", {in}, {out});
+    graph->AddOpAttr(name, "axis", axis);
+    graph->AddOpAttr(name, "num_axes", num_axes);
+    graph->AddOpAttr(name, "bias_term", true);
+    graph->AddOpAttr(name, "weight_1", new_block({1, 1, 1, channel}, 0.8f, -0.12f));
+    graph->AddOpAttr(name, "weight_2", new_block({1, 1, 1, channel}, -0.2f, 0.07f));
+}
+
+void add_power_op(GraphFP32* graph, const std::string& name, const std::string& in,
+                  const std::string& out, float power, float scale, float shift) {
+    graph->AddOp(name, "Power", {in}, {out});
+    graph->AddOpAttr(name, "power", power);
+    graph->AddOpAttr(name, "scale", scale);
+    graph->AddOpAttr(name, "shift", shift);
+}
+
+/**
+ * \brief run the graph made by build with and without the fusion and
+ *  check the outputs match and the fused graph runs fewer ops.
+ */
+void check_fusion(const std::function<void(GraphFP32*)>& build,
+                  const std::vector<std::pair<std::string, std::vector<int> > >& ins,
+                  const std::string& out_name) {
+    std::vector<std::vector<float> > outputs;
+    std::vector<size_t> node_num;
+    for (bool with_fusion : {false, true}) {
+        GraphFP32* graph = new GraphFP32();
+        build(graph);
+        CHECK(graph->Freeze()) << "Freeze error";
+        graph->Optimize(with_fusion);
+        node_num.push_back(graph->get_nodes_in_order().size());
+        for (auto& in : ins) {
+            std::vector<int> shape = in.second;
+            graph->AddOpAttr(in.first, "input_shape", PTuple<int>(shape));
+        }
+        Net<Target, Precision::FP32> net(*graph, true);
+        for (int i = 0; i < ins.size(); i++) {
+            auto* d_in = net.get_in(ins[i].first);
+            float* data = static_cast<float*>(d_in->mutable_data());
+            for (int j = 0; j < d_in->valid_size(); j++) {
+                data[j] = std::sin(0.37f * j + i) * 2.f;
+            }
+        }
+        net.prediction();
+        auto* d_out = net.get_out(out_name);
+        const float* out_data = static_cast<const float*>(d_out->data());
+        outputs.emplace_back(out_data, out_data + d_out->valid_size());
+        delete graph;
+    }
+    CHECK_LT(node_num[1], node_num[0]) << "the pattern is not fused";
+    CHECK_EQ(outputs[0].size(), outputs[1].size());
+    for (int i = 0; i < outputs[0].size(); i++) {
+        CHECK_LE(fabsf(outputs[0][i] - outputs[1][i]), 1e-4f * (1.f + fabsf(outputs[0][i])))
+                << "fused output mismatch at " << i << ": " << outputs[1][i]
+                << " vs " << outputs[0][i];
+    }
+}
+
+TEST(NetTest, net_fusion_dense_batchnorm_scale) {
+    const int in_dim = 24;
+    const int out_dim = 10;
+    for (bool bias_term : {true, false}) {
+        check_fusion([&](GraphFP32* graph) {
+            add_dense_op(graph, "fc", "x", "fc_out", in_dim, out_dim, bias_term);
+            add_batchnorm_op(graph, "bn", "fc_out", "bn_out", out_dim);
+            add_scale_op(graph, "scale", "bn_out", "y", out_dim, 1, 1);
+        }, {{"x", {3, in_dim, 1, 1}}}, "y");
+        check_fusion([&](GraphFP32* graph) {
+            add_dense_op(graph, "fc", "x", "fc_out", in_dim, out_dim, bias_term);
+            add_batchnorm_op(graph, "bn", "fc_out", "y", out_dim);
+        }, {{"x", {3, 4, 2, 3}}}, "y");
+        check_fusion([&](GraphFP32* graph) {
+            add_dense_op(graph, "fc", "x", "fc_out", in_dim, out_dim, bias_term);
+            add_scale_op(graph, "scale", "fc_out", "y", out_dim, 1, 1);
+        }, {{"x", {5, in_dim, 1, 1}}}, "y");
+    }
+    LOG(INFO) << "dense batchnorm scale fusion check pass";
+}
+
+TEST(NetTest, net_fusion_dense_affine_channel) {
+    const int in_dim = 16;
+    const int out_dim = 7;
+    check_fusion([&](GraphFP32* graph) {
+        add_dense_op(graph, "fc", "x", "fc_out", in_dim, out_dim, true);
+        graph->AddOp("affine", "AffineChannel", {"fc_out"}, {"y"});
+        graph->AddOpAttr("affine", "weight_1", new_block({1, 1, 1, out_dim}, 1.2f, 0.1f));
+        graph->AddOpAttr("affine", "weight_2", new_block({1, 1, 1, out_dim}, 0.5f, -0.3f));
+    }, {{"x", {2, in_dim, 1, 1}}}, "y");
+    LOG(INFO) << "dense affine channel fusion check pass";
+}
+
+TEST(NetTest, net_fusion_dense_activation) {
+    const int in_dim = 20;
+    const int out_dim = 12;
+    check_fusion([&](GraphFP32* graph) {
+        add_dense_op(graph, "fc", "x", "fc_out", in_dim, out_dim, true);
+        graph->AddOp("relu", "ReLU", {"fc_out"}, {"y"});
+        graph->AddOpAttr("relu", "alpha", 0.1f);
+    }, {{"x", {3, in_dim, 1, 1}}}, "y");
+    for (std::string type : {"Swish", "Stanh", "Sigmoid", "TanH", "Gelu", "ClippedRelu"}) {
+        check_fusion([&](GraphFP32* graph) {
+            add_dense_op(graph, "fc", "x", "fc_out", in_dim, out_dim, true);
+            graph->AddOp("act", "Activation", {"fc_out"}, {"y"});
+            graph->AddOpAttr("act", "type", type);
+            // the beta of swish and the threshold of clipped relu
+            graph->AddOpAttr("act", "clip_relu_num", 0.8f);
+        }, {{"x", {3, in_dim, 1, 1}}}, "y");
+    }
+    LOG(INFO) << "dense activation fusion check pass";
+}
+
+TEST(NetTest, net_fusion_mat_mul_scale_power) {
+    auto add_mat_mul = [](GraphFP32* graph) {
+        graph->AddOp("mat_mul", "MatMul", {"x", "w"}, {"mm_out"});
+        graph->AddOpAttr("mat_mul", "transpose_x", false);
+        graph->AddOpAttr("mat_mul", "transpose_y", true);
+        graph->AddOpAttr("mat_mul", "coeff", 0.5f);
+    };
+    std::vector<std::pair<std::string, std::vector<int> > > ins = {
+        {"x", {1, 3, 4, 6}}, {"w", {1, 3, 5, 6}}};
+    // a per channel scale runs after the matmul
+    check_fusion([&](GraphFP32* graph) {
+        add_mat_mul(graph);
+        add_scale_op(graph, "scale", "mm_out", "y", 3, 1, 1);
+    }, ins, "y");
+    // a scalar scale folds into coeff
+    check_fusion([&](GraphFP32* graph) {
+        add_mat_mul(graph);
+        add_scale_op(graph, "scale", "mm_out", "y", 1, 1, 0);
+    }, ins, "y");
+    check_fusion([&](GraphFP32* graph) {
+        add_mat_mul(graph);
+        add_power_op(graph, "power", "mm_out", "y", 2.f, 0.7f, 0.3f);
+    }, ins, "y");
+    LOG(INFO) << "matmul scale and power fusion check pass";
+}
+
+TEST(NetTest, net_fusion_scale_chain) {
+    std::vector<std::pair<std::string, std::vector<int> > > ins = {{"x", {2, 4, 3, 5}}};
+    // same axes, scalar head and different axes
+    check_fusion([&](GraphFP32* graph) {
+        add_scale_op(graph, "scale_a", "x", "a_out", 4, 1, 1);
+        add_scale_op(graph, "scale_b", "a_out", "y", 4, 1, 1);
+    }, ins, "y");
+    check_fusion([&](GraphFP32* graph) {
+        add_scale_op(graph, "scale_a", "x", "a_out", 1, 1, 0);
+        add_scale_op(graph, "scale_b", "a_out", "y", 4, 1, 1);
+    }, ins, "y");
+    check_fusion([&](GraphFP32* graph) {
+        add_scale_op(graph, "scale_a", "x", "a_out", 4, 1, 1);
+        add_scale_op(graph, "scale_b", "a_out", "y", 3, 2, 1);
+    }, ins, "y");
+    // an affine power composes, any other power runs before the scale
+    for (float power : {1.f, 2.f}) {
+        check_fusion([&](GraphFP32* graph) {
+            add_power_op(graph, "power", "x", "p_out", power, 1.5f, 0.25f);
+            add_scale_op(graph, "scale", "p_out", "y", 4, 1, 1);
+        }, ins, "y");
+    }
+    LOG(INFO) << "scale chain fusion check pass";
+}
+#endif
+
+int main(int argc, const char** argv) {
+#ifdef USE_X86_PLACE
+    Env<Target>::env_init();
+#endif
+    // initial logger
+    logger::init(argv[0]);
+    InitTest();
+    RUN_ALL_TESTS(argv[0]);
+    return 0;
+}
@@ -0,0 +1,100 @@
+#include <string>
+#include <cmath>
+#include "net_test.h"
+
+#if defined(USE_X86_PLACE)
+using Target = X86;
+
+using GraphFP32 = Graph<Target, Precision::FP32>;
+
+void add_power_op(GraphFP32* graph, const std::string& name, const std::string& in,
+                  const std::string& out, float scale, float shift) {
+    graph->AddOp(name, "Power", {in}, {out});
+    graph->AddOpAttr(name, "power", 1.f);
+    graph->AddOpAttr(name, "scale", scale);
+    graph->AddOpAttr(name, "shift", shift);
+}
+
+/**
+ * \brief the inputs of the concat and the outputs of the slice are views in the inplace net,
+ *  a nested concat cuts its inputs out of the outer concat output.
+ */
+GraphFP32* build_graph(const std::vector<int>& x_shape) {
+    GraphFP32* graph = new GraphFP32();
+    add_power_op(graph, "pa", "x", "a", 2.f, 1.f);
+    add_power_op(graph, "pb", "x", "b", -1.f, 0.5f);
+    add_power_op(graph, "pc", "x", "c", 0.5f, -2.f);
+    graph->AddOp("inner", "Concat", {"a", "b"}, {"ab"});
+    graph->AddOpAttr("inner", "axis", 1);
+    graph->AddOp("outer", "Concat", {"ab", "c"}, {"abc"});
+    graph->AddOpAttr("outer", "axis", 1);
+    add_power_op(graph, "pt", "abc", "t", 1.5f, 0.25f);
+    graph->AddOp("slice", "Slice", {"t"}, {"s0", "s1"});
+    graph->AddOpAttr("slice", "axis", 1);
+    graph->AddOpAttr("slice", "slice_dim", 1);
+    graph->AddOpAttr("slice", "slice_point", PTuple<int>(5));
+    add_power_op(graph, "p0", "s0", "y0", 2.f, 0.f);
+    add_power_op(graph, "p1", "s1", "y1", -3.f, 1.f);
+    CHECK(graph->Freeze()) << "Freeze error";
+    graph->Optimize();
+    graph->AddOpAttr("x", "input_shape", PTuple<int>(std::vector<int>(x_shape)));
+    return graph;
+}
+
+void fill_input(Net<Target, Precision::FP32>& net, const std::vector<int>& x_shape) {
+    auto* d_in = net.get_in("x");
+    d_in->reshape(Shape(x_shape, Layout_NCHW));
+    float* data = static_cast<float*>(d_in->mutable_data());
+    for (int i = 0; i < d_in->valid_size(); i++) {
+        data[i] = std::sin(0.37f * i) * 2.f;
+    }
+}
+
+void check_outputs(Net<Target, Precision::FP32>& net, Net<Target, Precision::FP32>& ref) {
+    for (std::string name : {"y0", "y1"}) {
+        auto* d_out = net.get_out(name);
+        auto* d_ref = ref.get_out(name);
+        CHECK(d_out->valid_shape() == d_ref->valid_shape()) << name << " shape mismatch";
+        const float* out_data = static_cast<const float*>(d_out->data());
+        const float* ref_data = static_cast<const float*>(d_ref->data());
+        for (int i = 0; i < d_ref->valid_size(); i++) {
+            CHECK_EQ(out_data[i], ref_data[i]) << name << " mismatch at " << i;
+        }
+    }
+}
+
+TEST(NetTest, net_inplace_concat_reshape) {
+    std::vector<int> init_shape{1, 4, 6, 8};
+    GraphFP32* graph = build_graph(init_shape);
+    GraphFP32* ref_graph = build_graph(init_shape);
+    Net<Target, Precision::FP32> net;
+    net.set_inplace_concat(true);
+    net.init(*graph);
+    Net<Target, Precision::FP32> ref(*ref_graph, true);
+
+    // the views are cut again for every new shape, the num > 1 shapes copy instead
+    std::vector<std::vector<int>> shapes{init_shape, {1, 4, 3, 5}, {2, 4, 3, 5},
+        {1, 4, 6, 8}, {2, 4, 2, 2}, {1, 4, 6, 8}};
+    for (auto& shape : shapes) {
+        fill_input(net, shape);
+        fill_input(ref, shape);
+        net.prediction();
+        ref.prediction();
+        check_outputs(net, ref);
+    }
+    delete graph;
+    delete ref_graph;
+    LOG(INFO) << "inplace concat reshape check pass";
+}
+#endif
+
+int main(int argc, const char** argv) {
+#ifdef USE_X86_PLACE
+    Env<Target>::env_init();
+#endif
+    // initial logger
+    logger::init(argv[0]);
+    InitTest();
+    RUN_ALL_TESTS(argv[0]);
+    return 0;
+}
@@ -0,0 +1,77 @@
+#include <string>
+#include "net_test.h"
+#include "framework/core/net/mixed_precision_planner.h"
+#if defined(NVIDIA_GPU)|| defined(USE_X86_PLACE)
+
+#if defined(NVIDIA_GPU)
+using Target = NV;
+#elif defined(USE_X86_PLACE)
+using Target = X86;
+#endif
+
+std::string g_model_path;
+std::string g_data_file = "./data_list.txt";
+std::string g_calibrator_file = "./calibrator.txt";
+std::string g_config_file = "./net_pt_config";
+std::string g_layout_file = "./model_layout_config";
+int g_batch_size = 1;
+float g_error_budget = 0.01f;
+
+TEST(NetTest, plan_mixed_precision) {
+    BatchStream<Target> batch_stream(g_data_file, g_batch_size);
+    MixedPrecisionPlanner<Target> planner(g_model_path, g_calibrator_file, &batch_stream, g_batch_size);
+    auto status = planner.plan(g_error_budget, g_config_file, g_layout_file);
+
+    if (!status) {
+        LOG(FATAL) << " [ERROR] " << status.info();
+    }
+
+    for (auto& name : planner.int8_nodes()) {
+        LOG(INFO) << "int8 node " << name << " saves " << planner.speedup().at(name)
+                  << " ms, error " << planner.sensitivity().at(name);
+    }
+}
+
+int main(int argc, const char** argv) {
+
+    Env<Target>::env_init();
+    // initial logger
+    logger::init(argv[0]);
+
+    LOG(INFO) << "usage:";
+    LOG(INFO) << argv[0] << " <model> <data_file> <calibrate_file> <batch_size> <error_budget>"
+              << " [config_file] [layout_file]";
+    LOG(INFO) << "   model:          path to anakin model";
+    LOG(INFO) << "   data_file:      list of validation tensor files";
+    LOG(INFO) << "   calibrate file: tensor scales from a calibrator";
+    LOG(INFO) << "   error_budget:   relative l2 error of the outputs against fp32";
+
+    if (argc < 6) {
+        LOG(ERROR) << "useage: " << argv[0] << " <model> <data_file> <calibrate_file> <batch_size>"
+                   << " <error_budget>";
+        return 0;
+    }
+
+    g_model_path = argv[1];
+    g_data_file = argv[2];
+    g_calibrator_file = argv[3];
+    g_batch_size = atoi(argv[4]);
+    g_error_budget = atof(argv[5]);
+
+    if (argc > 6) {
+        g_config_file = argv[6];
+    }
+
+    if (argc > 7) {
+        g_layout_file = argv[7];
+    }
+
+    InitTest();
+    RUN_ALL_TESTS(argv[0]);
+    return 0;
+}
+#else
+int main(int argc, const char** argv) {
+    return 0;
+}
+#endif
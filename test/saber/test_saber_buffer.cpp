@@ -3,6 +3,10 @@
 #include "saber/core/env.h"
 #include "saber/core/data_traits.h"
 #include <cmath>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <type_traits>
 using namespace anakin::saber;
 
 
@@ -197,6 +201,88 @@ TEST(TestSaberFunc, test_buff_apis) {
     LOG(INFO) << "Buffer api: from_buffer check pass";
 }
 
+TEST(TestSaberFunc, test_host_allocator) {
+#ifdef USE_X86_PLACE
+    size_t class_size = 0;
+    CHECK_EQ(CachingHostAllocator::size_class(1, &class_size), 0);
+    CHECK_EQ(class_size, MALLOC_ALIGN);
+    CHECK_EQ(CachingHostAllocator::size_class(100, &class_size), 3);
+    CHECK_EQ(class_size, 112);
+    CHECK_EQ(CachingHostAllocator::size_class(4096, &class_size), 24);
+    CHECK_EQ(class_size, 4096);
+    CHECK_EQ(CachingHostAllocator::size_class(4097, &class_size), 25);
+    CHECK_EQ(class_size, 5120);
+
+    HostAllocator* origin = HostAllocator::global();
+    // blocks of the previous allocator stay valid after the switch
+    Buffer<X86> old_buf(1000);
+    static CachingHostAllocator caching;
+    HostAllocator::set_global(&caching);
+    {
+        Buffer<X86> buf;
+
+        for (int size : {1000, 3000, 100000, 4 << 20}) {
+            buf.re_alloc(size);
+            memset(buf.get_data_mutable(), 1, size);
+            CHECK_EQ((size_t)buf.get_data() % MALLOC_ALIGN, 0) << "host block is not aligned";
+            CHECK_GE(HostAllocator::block_size(buf.get_data_mutable()), size);
+        }
+
+        Buffer<X86> small(900);
+        // variable shapes reuse the cached blocks instead of reaching the system
+        size_t system_alloc_count = caching.stats().system_alloc_count;
+
+        for (int i = 0; i < 10; ++i) {
+            buf.alloc(3000 + i);
+            buf.alloc(100000 - i);
+            buf.alloc((4 << 20) - i);
+        }
+
+        HostAllocatorStats stats = caching.stats();
+        CHECK_EQ(stats.system_alloc_count, system_alloc_count);
+        CHECK_GE(stats.cache_hit_count, 30);
+        CHECK_GT(stats.bytes_cached, 0);
+        CHECK_GE(stats.peak_bytes_in_use, stats.bytes_in_use);
+    }
+    CHECK_EQ(caching.stats().bytes_in_use, 0);
+    caching.flush_thread_cache();
+    caching.release_cache();
+    CHECK_EQ(caching.stats().bytes_cached, 0);
+
+    HostAllocator::set_global(origin);
+
+    // a destroyed allocator drains the caches of every thread, an allocator built
+    // at its address must not get the blocks another thread cached for the old one
+    std::aligned_storage<sizeof(CachingHostAllocator), alignof(CachingHostAllocator)>::type storage;
+    CachingHostAllocator* local = new (&storage) CachingHostAllocator();
+    std::mutex mut;
+    std::condition_variable cond;
+    int step = 0;
+    std::thread worker([&]() {
+        local->free(local->alloc(3000));
+        std::unique_lock<std::mutex> lock(mut);
+        step = 1;
+        cond.notify_all();
+        cond.wait(lock, [&]() { return step == 2; });
+        void* ptr = local->alloc(3000);
+        CHECK_EQ(local->stats().cache_hit_count, 0) << "a block of a destroyed allocator is reused";
+        local->free(ptr);
+        local->flush_thread_cache();
+    });
+    {
+        std::unique_lock<std::mutex> lock(mut);
+        cond.wait(lock, [&]() { return step == 1; });
+        local->~CachingHostAllocator();
+        local = new (&storage) CachingHostAllocator();
+        step = 2;
+        cond.notify_all();
+    }
+    worker.join();
+    local->~CachingHostAllocator();
+    LOG(INFO) << "host allocator check pass";
+#endif
+}
+
 int main(int argc, const char** argv) {
     // initial logger
     logger::init(argv[0]);
@@ -107,6 +107,51 @@ TEST(TestSaberFunc, test_func_concat) {
 #endif
 }
 
+#ifdef USE_X86_PLACE
+TEST(TestSaberFunc, test_func_concat_inplace) {
+    //! input 0 and 2 are views of the output as Net::set_inplace_concat makes them, input 1 is not
+    Env<X86>::env_init();
+    Context<X86> ctx(0, 1, 1);
+    std::vector<int> channels{2, 3, 4};
+    Tensor<X86> output(Shape({1, 9, 5, 6}, Layout_NCHW));
+    Tensor<X86> input_views[3];
+    Tensor<X86> input_owned(Shape({1, channels[1], 5, 6}, Layout_NCHW));
+    Tensor<X86> check_inputs[3];
+    std::vector<Tensor<X86>*> inputs;
+    fill_tensor_rand(output, -1.f, 1.f);
+    fill_tensor_rand(input_owned, -1.f, 1.f);
+    int offset = 0;
+
+    for (int i = 0; i < 3; ++i) {
+        Shape shape({1, channels[i], 5, 6}, Layout_NCHW);
+        Tensor<X86> window((float*)output.mutable_data() + offset * 5 * 6, X86(), 0, shape);
+        input_views[i].set_shape(shape);
+        input_views[i].share_from(window);
+        inputs.push_back(i == 1 ? &input_owned : &input_views[i]);
+        check_inputs[i].re_alloc(shape, AK_FLOAT);
+        check_inputs[i].copy_from(*inputs[i]);
+        offset += channels[i];
+    }
+
+    ConcatParam<X86> param(1);
+    Concat<X86, AK_FLOAT> concat;
+    std::vector<Tensor<X86>*> outputs{&output};
+    concat.compute_output_shape(inputs, outputs, param);
+    concat.init(inputs, outputs, param, SPECIFY, SABER_IMPL, ctx);
+    concat(inputs, outputs, param, ctx);
+
+    Tensor<X86> check_output(Shape({1, 9, 5, 6}, Layout_NCHW));
+    std::vector<Tensor<X86>*> check_in_v{&check_inputs[0], &check_inputs[1], &check_inputs[2]};
+    std::vector<Tensor<X86>*> check_out_v{&check_output};
+    concat_nv_basic<float, X86, X86>(check_in_v, check_out_v, param);
+    double max_ratio = 0.0;
+    double max_diff = 0.0;
+    tensor_cmp_host((const float*)check_output.data(), (const float*)output.data(),
+                    output.valid_size(), max_ratio, max_diff);
+    CHECK_EQ(max_diff, 0.0) << "inplace concat failed";
+}
+#endif
+
 int main(int argc, const char** argv) {
     if (argc >= 2) {
         axis_in = atoi(argv[1]);
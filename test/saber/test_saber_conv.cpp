@@ -851,6 +851,10 @@ int test_conv_results_x86(int group,
 
 #if defined(USE_X86_PLACE)
 #include "saber/funcs/impl/x86/kernel/jit_generator.h"
+#include "saber/funcs/impl/x86/packed_weight_cache.h"
+#include <cstdlib>
+#include <dirent.h>
+#include <unistd.h>
 #define X86_CONV_ONE_TEST 1
 TEST(TestSaberFunc, test_saber_x86_conv_results) {
 
@@ -990,6 +994,56 @@ if(use_avx512) {
 
 }
 
+//! the winograd weights transform is stored by the first init and loaded by the second one
+TEST(TestSaberFunc, test_saber_x86_conv_winograd_weights_cache) {
+    Env<X86>::env_init();
+    auto& packed_cache = PackedWeightCache::global();
+    std::string cache_dir_before = packed_cache.dir();
+    char cache_dir[] = "/tmp/packed_weights_XXXXXX";
+    CHECK(mkdtemp(cache_dir) != nullptr);
+    packed_cache.set_dir(cache_dir);
+
+    Tensor<X86> input(Shape({1, 16, 24, 24}), AK_FLOAT);
+    Tensor<X86> weights(Shape({32, 16, 3, 3}), AK_FLOAT);
+    Tensor<X86> bias(Shape({1, 32, 1, 1}), AK_FLOAT);
+    fill_tensor_rand(input, -10.0f, 10.0f);
+    fill_tensor_rand(weights, -10.0f, 10.0f);
+    fill_tensor_rand(bias, -10.0f, 10.0f);
+    Tensor<X86> outputs[2];
+    auto stats_before = packed_cache.stats();
+
+    for (int i = 0; i < 2; i++) {
+        ConvParam<X86> param(1, 1, 1, 1, 1, 1, 1, &weights, &bias);
+        Conv<X86, AK_FLOAT> conv;
+        Context<X86> ctx(0, 1, 1);
+        std::vector<Tensor<X86>* > input_v{&input};
+        std::vector<Tensor<X86>* > output_v{&outputs[i]};
+        conv.compute_output_shape(input_v, output_v, param);
+        outputs[i].re_alloc(outputs[i].valid_shape(), AK_FLOAT);
+        conv.init(input_v, output_v, param, SPECIFY, SABER_IMPL, ctx);
+        conv(input_v, output_v, param, ctx);
+    }
+
+    auto stats_after = packed_cache.stats();
+    CHECK_GT(stats_after.store_count, stats_before.store_count);
+    CHECK_GT(stats_after.hit_count, stats_before.hit_count);
+    double max_ratio = 0.0;
+    double max_diff = 0.0;
+    tensor_cmp_host((const float*)outputs[0].data(), (const float*)outputs[1].data(),
+                    outputs[0].valid_size(), max_ratio, max_diff);
+    CHECK_EQ(max_diff, 0.0) << "the cached weights give a different result";
+
+    packed_cache.set_dir(cache_dir_before);
+    DIR* dir = opendir(cache_dir);
+    for (dirent* entry = readdir(dir); entry != nullptr; entry = readdir(dir)) {
+        if (entry->d_name[0] != '.') {
+            unlink((std::string(cache_dir) + "/" + entry->d_name).c_str());
+        }
+    }
+    closedir(dir);
+    rmdir(cache_dir);
+}
+
 #endif
 
 TEST(TestSaberFunc, test_saber_cuda_conv_results) {
@@ -595,6 +595,17 @@ TEST(TestSaberFunc, test_saber_conv_int8_x86_results) {
                                         pad_h, pad_w, bias_term,with_relu,
                                         SPECIFY, SABER_IMPL, false);
 
+    } else if (jit::mayiuse(jit::avx2)) {
+        // direct, 1x1 and depthwise conv, signed and unsigned input
+        for (auto is_unsigned : {false, true}) {
+            test_conv_results_nhwc<X86, X86, AK_FLOAT>(group, input_num, in_channels, 56, 56,
+                    out_channels, kernel_h, kernel_w, stride_h, stride_w, dilation_h, dilation_w,
+                    pad_h, pad_w, bias_term, with_relu, SPECIFY, SABER_IMPL, is_unsigned);
+            test_conv_results_nhwc<X86, X86, AK_FLOAT>(1, 2, 64, 28, 28, 48, 1, 1, 1, 1, 1, 1,
+                    0, 0, bias_term, true, SPECIFY, SABER_IMPL, is_unsigned);
+            test_conv_results_nhwc<X86, X86, AK_FLOAT>(32, 1, 32, 28, 28, 32, 3, 3, 2, 2, 1, 1,
+                    1, 1, bias_term, with_relu, SPECIFY, SABER_IMPL, is_unsigned);
+        }
     }
 #endif
 
@@ -141,16 +141,17 @@ void test_model(int flag){
     
     Shape input_shape({num, channel, height, width}, Layout_NCHW);
     Shape input_shape2({100, 100, 1, 1}, Layout_NCHW);
+    Shape input_shape3({64, 16, 1, 1}, Layout_NCHW);
 
     if (flag == 1) GLB_flag = 1;//X86
 
     TestSaberBase<TargetType_D, TargetType_H, Dtype, CrfDecoding, CrfDecodingParam> testbase(1,1);
-   for(auto shape: {input_shape, input_shape2}){
+   for(auto shape: {input_shape, input_shape2, input_shape3}){
         for(auto num_tag: {0}){
             TensorD weights;
             float min = -1.f;
             float max = 1.f;
-            std::vector<std::vector<int>> lod = {{0, 2, shape[1]}};
+            std::vector<std::vector<int>> lod = {{0, 2, shape[0] / 2, shape[0]}};
             Shape wei_shape({shape[1] + 2, shape[1], shape[2], shape[3]}, Layout_NCHW);
             weights.re_alloc(wei_shape, Dtype);
             fill_tensor_rand(weights,min, max);
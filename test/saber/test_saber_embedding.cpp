@@ -4,7 +4,13 @@
 #include "saber/saber_types.h"
 #include "test_saber_base.h"
 #include "test_saber_func.h"
+#ifdef USE_X86_PLACE
+#include "saber/funcs/impl/x86/half_convert_helper.h"
+#endif
 #include <vector>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
 
 using namespace anakin::saber;
 
@@ -105,10 +111,182 @@ void test_embedding(){
 }
 
 
+#ifdef USE_X86_PLACE
+void test_paged_embedding() {
+    int word_num = 1000;
+    int emb_dim = 16;
+    int padding_idx = 3;
+    size_t offset = 64;
+    Tensor<X86> weight(Shape({1, 1, word_num, emb_dim}));
+    fill_tensor_rand(weight, -0.5, 0.5);
+    char path[] = "/tmp/paged_embedding_XXXXXX";
+    int fd = mkstemp(path);
+    CHECK_GE(fd, 0);
+    std::vector<char> head(offset, 0);
+    CHECK_EQ(write(fd, head.data(), offset), offset);
+    CHECK_EQ(write(fd, weight.data(), weight.valid_size() * sizeof(float)),
+             weight.valid_size() * sizeof(float));
+    close(fd);
+
+    // a cache of 64 rows, most lookups go to the file
+    PagedRowTableParam table_param;
+    table_param.cache_bytes = 64 * emb_dim * sizeof(float);
+    table_param.num_shards = 4;
+    auto table = PagedRowTable::get(path, offset, word_num, emb_dim, AK_FLOAT, table_param);
+    CHECK(table != nullptr);
+    CHECK(table == PagedRowTable::get(path, offset, word_num, emb_dim, AK_FLOAT, table_param));
+    // a later user of the region shares the cache of the first one
+    PagedRowTableParam other_param;
+    CHECK(table == PagedRowTable::get(path, offset, word_num, emb_dim, AK_FLOAT, other_param));
+    CHECK_EQ(table->param().cache_bytes, table_param.cache_bytes);
+    CHECK_EQ(table->param().num_shards, table_param.num_shards);
+    EmbeddingParam<X86> param(word_num, emb_dim, padding_idx, 2, &weight);
+    EmbeddingParam<X86> paged_param(word_num, emb_dim, padding_idx, 2, nullptr);
+    paged_param.paged_table = table;
+
+    Env<X86>::env_init();
+    Context<X86> ctx(0, 1, 1);
+    Tensor<X86> input(Shape({512, 1, 1, 1}));
+    fill_tensor_rand(input, 0, word_num - 1);
+    float* in_data = static_cast<float*>(input.mutable_data());
+    for (int i = 0; i < input.valid_size(); i++) {
+        in_data[i] = int(in_data[i]);
+    }
+    input.set_seq_offset({{0, 100, 300, 512}});
+    Tensor<X86> out_0, out_1, paged_out_0, paged_out_1;
+    std::vector<Tensor<X86>*> inputs{&input};
+    std::vector<Tensor<X86>*> outputs{&out_0, &out_1};
+    std::vector<Tensor<X86>*> paged_outputs{&paged_out_0, &paged_out_1};
+    Embedding<X86, AK_FLOAT> embedding;
+    Embedding<X86, AK_FLOAT> paged_embedding;
+    SABER_CHECK(embedding.compute_output_shape(inputs, outputs, param));
+    SABER_CHECK(paged_embedding.compute_output_shape(inputs, paged_outputs, paged_param));
+    for (int i = 0; i < 2; i++) {
+        outputs[i]->re_alloc(outputs[i]->valid_shape(), AK_FLOAT);
+        paged_outputs[i]->re_alloc(paged_outputs[i]->valid_shape(), AK_FLOAT);
+    }
+    SABER_CHECK(embedding.init(inputs, outputs, param, SPECIFY, SABER_IMPL, ctx));
+    SABER_CHECK(paged_embedding.init(inputs, paged_outputs, paged_param, SPECIFY, SABER_IMPL, ctx));
+    SABER_CHECK(embedding(inputs, outputs, param, ctx));
+    for (int iter = 0; iter < 2; iter++) {
+        SABER_CHECK(paged_embedding(inputs, paged_outputs, paged_param, ctx));
+        for (int i = 0; i < 2; i++) {
+            double max_ratio = 0;
+            double max_diff = 0;
+            tensor_cmp_host((const float*)outputs[i]->data(), (const float*)paged_outputs[i]->data(),
+                            outputs[i]->valid_size(), max_ratio, max_diff);
+            CHECK_EQ(max_diff, 0) << "paged embedding output " << i << " mismatch";
+        }
+    }
+    auto stats = table->stats();
+    CHECK_GT(stats.hit_count, 0);
+    CHECK_GT(stats.miss_count, 0);
+    CHECK_LE(stats.cached_rows, 64);
+    LOG(INFO) << "paged embedding hit " << stats.hit_count << ", miss " << stats.miss_count;
+
+    // the default cache is far above the table, it allocates no more than the rows read
+    PagedRowTable whole_table;
+    SABER_CHECK(whole_table.open(path, offset, word_num, emb_dim, AK_FLOAT));
+    CHECK_EQ(whole_table.stats().cache_bytes, 0);
+    std::vector<float> row(emb_dim);
+    for (int iter = 0; iter < 2; iter++) {
+        for (int r = 0; r < word_num; r++) {
+            whole_table.copy_row(r, row.data());
+            CHECK_EQ(memcmp(row.data(), static_cast<const float*>(weight.data()) + r * emb_dim,
+                            whole_table.row_bytes()), 0) << "paged row " << r << " mismatch";
+        }
+    }
+    stats = whole_table.stats();
+    CHECK_EQ(stats.miss_count, word_num);
+    CHECK_EQ(stats.hit_count, word_num);
+    CHECK_EQ(stats.cached_rows, word_num);
+    int num_shards = whole_table.param().num_shards;
+    CHECK_LE(stats.cache_bytes, (word_num + num_shards - 1) / num_shards * num_shards
+             * whole_table.row_bytes());
+    unlink(path);
+}
+
+/**
+ * \brief fp16 / bf16 weights, in memory and paged from a file, against fp32 weights
+ *  holding the same rounded values. rows expand exactly, so the outputs are equal.
+ */
+void test_half_embedding(DataType weight_dtype) {
+    int word_num = 300;
+    int emb_dim = 24;
+    int padding_idx = 7;
+    size_t offset = 32;
+    Tensor<X86> weight(Shape({1, 1, word_num, emb_dim}));
+    Tensor<X86> half_weight(Shape({1, 1, word_num, emb_dim}), weight_dtype);
+    fill_tensor_rand(weight, -0.5, 0.5);
+    fp32_to_half(static_cast<const float*>(weight.data()), static_cast<uint16_t*>(half_weight.mutable_data()),
+                 weight.valid_size(), weight_dtype);
+    half_to_fp32(static_cast<const uint16_t*>(half_weight.data()), static_cast<float*>(weight.mutable_data()),
+                 weight.valid_size(), weight_dtype);
+    char path[] = "/tmp/half_embedding_XXXXXX";
+    int fd = mkstemp(path);
+    CHECK_GE(fd, 0);
+    std::vector<char> head(offset, 0);
+    CHECK_EQ(write(fd, head.data(), offset), offset);
+    CHECK_EQ(write(fd, half_weight.data(), half_weight.valid_size() * sizeof(uint16_t)),
+             half_weight.valid_size() * sizeof(uint16_t));
+    close(fd);
+
+    PagedRowTableParam table_param;
+    table_param.cache_bytes = 32 * emb_dim * sizeof(uint16_t);
+    table_param.num_shards = 2;
+    auto table = PagedRowTable::get(path, offset, word_num, emb_dim, weight_dtype, table_param);
+    CHECK(table != nullptr);
+    EmbeddingParam<X86> param(word_num, emb_dim, padding_idx, 2, &weight);
+    EmbeddingParam<X86> half_param(word_num, emb_dim, padding_idx, 2, &half_weight);
+    EmbeddingParam<X86> paged_param(word_num, emb_dim, padding_idx, 2, nullptr);
+    paged_param.paged_table = table;
+
+    Env<X86>::env_init();
+    Context<X86> ctx(0, 1, 1);
+    Tensor<X86> input(Shape({200, 1, 1, 1}));
+    fill_tensor_rand(input, 0, word_num - 1);
+    float* in_data = static_cast<float*>(input.mutable_data());
+    for (int i = 0; i < input.valid_size(); i++) {
+        in_data[i] = int(in_data[i]);
+    }
+    in_data[5] = padding_idx;
+    input.set_seq_offset({{0, 50, 120, 200}});
+    std::vector<EmbeddingParam<X86>*> params{&param, &half_param, &paged_param};
+    std::vector<Tensor<X86>> outs(6);
+    std::vector<Tensor<X86>*> inputs{&input};
+    for (int p = 0; p < 3; p++) {
+        std::vector<Tensor<X86>*> outputs{&outs[2 * p], &outs[2 * p + 1]};
+        Embedding<X86, AK_FLOAT> embedding;
+        SABER_CHECK(embedding.compute_output_shape(inputs, outputs, *params[p]));
+        for (auto out : outputs) {
+            out->re_alloc(out->valid_shape(), AK_FLOAT);
+        }
+        SABER_CHECK(embedding.init(inputs, outputs, *params[p], SPECIFY, SABER_IMPL, ctx));
+        SABER_CHECK(embedding(inputs, outputs, *params[p], ctx));
+    }
+    for (int p = 1; p < 3; p++) {
+        for (int i = 0; i < 2; i++) {
+            double max_ratio = 0;
+            double max_diff = 0;
+            tensor_cmp_host((const float*)outs[i].data(), (const float*)outs[2 * p + i].data(),
+                            outs[i].valid_size(), max_ratio, max_diff);
+            CHECK_EQ(max_diff, 0) << "half embedding " << weight_dtype << " case " << p
+                                  << " output " << i << " mismatch";
+        }
+    }
+    unlink(path);
+}
+#endif
+
 TEST(TestSaberFunc, test_op_embedding) {
 //#ifdef USE_X86_PLACE
 //    test_embedding<X86, X86, AK_FLOAT>();
 //#endif 
+#ifdef USE_X86_PLACE
+    test_paged_embedding();
+    test_half_embedding(AK_HALF);
+    test_half_embedding(AK_BFLOAT16);
+#endif
 
 #ifdef USE_CUDA
     test_embedding<NV, NVHX86, AK_FLOAT>();
@@ -4,6 +4,9 @@
 #include "saber/saber_types.h"
 #include "test_saber_func.h"
 #include "test_saber_base.h"
+#ifdef USE_X86_PLACE
+#include "saber/funcs/impl/x86/half_convert_helper.h"
+#endif
 #include <vector>
 #include <ctime>
 
@@ -43,6 +46,61 @@ void fc_cpu_base(const std::vector<Tensor<TargetType_H>* > &input, std::vector<T
     }
 }
 
+#ifdef USE_X86_PLACE
+//fc with fp16 / bf16 weights, the reference runs on the weights expanded to fp32
+void fc_half_weights_cpu_base(const std::vector<Tensor<X86>* > &input, std::vector<Tensor<X86>* > &output, \
+                    FcParam<X86> &param) {
+    Tensor<X86> weights_fp32(param.weights->valid_shape(), AK_FLOAT);
+    half_to_fp32(static_cast<const uint16_t*>(param.weights->data()),
+                 static_cast<float*>(weights_fp32.mutable_data()),
+                 param.weights->valid_size(), param.weights->get_dtype());
+    FcParam<X86> param_fp32 = param;
+    param_fp32.weights = &weights_fp32;
+    fc_cpu_base<float, X86, X86>(input, output, param_fp32);
+}
+
+//fc with the epilogue, out = act(x * w + bias + residual), the residual is the last input
+void fc_epilogue_cpu_base(const std::vector<Tensor<X86>* > &input, std::vector<Tensor<X86>* > &output, \
+                    FcParam<X86> &param) {
+    fc_cpu_base<float, X86, X86>(input, output, param);
+    float* data_out = static_cast<float*>(output[0]->mutable_data());
+    const float* residual = param.residual ? static_cast<const float*>(input.back()->data()) : nullptr;
+    const ActivationParam<X86>& act = param.activation_param;
+    int out_cols = output[0]->channel();
+    for (int i = 0; i < output[0]->valid_size(); i++) {
+        float x = data_out[i] + (residual ? residual[i] : 0.f);
+        switch (act.has_active ? act.active : Active_identity) {
+            case Active_relu:
+                x = x > 0 ? x : x * act.negative_slope;
+                break;
+            case Active_sigmoid:
+                x = 1.f / (1.f + exp(-x));
+                break;
+            case Active_tanh:
+                x = tanh(x);
+                break;
+            case Active_gelu:
+                x = x * 0.5 * (erf(x / sqrt(2)) + 1);
+                break;
+            case Active_stanh:
+                x = act.coef * tanh(act.negative_slope * x);
+                break;
+            case Active_swish:
+                x = x / (1.f + exp(-act.coef * x));
+                break;
+            case Active_prelu: {
+                const float* slope = static_cast<const float*>(act.prelu_param.slope->data());
+                x = x > 0 ? x : x * slope[act.prelu_param.channel_shared ? 0 : i % out_cols];
+                break;
+            }
+            default:
+                break;
+        }
+        data_out[i] = x;
+    }
+}
+#endif
+
 TEST(TestSaberFunc, test_op_fc) {
 
 #ifdef USE_CUDA
@@ -99,6 +157,85 @@ TEST(TestSaberFunc, test_op_fc) {
             }
         }
     }
+
+    //dynamic quant, int8 gemm with the inputs quantized per row at runtime
+    for (int ch_in : {3, 64}) {
+        for (int num_in : {1, 21, 32}) {
+            int out_num = 32;
+            Shape shape({num_in, ch_in, 8, 8});
+            Shape shape_w({ch_in, 8, 8, out_num});
+            weights_h0.re_alloc(shape_w, AK_FLOAT);
+            fill_tensor_rand(weights_h0, 0.1, 1.5);
+            FcParam<X86> param(&weights_h0, out_num);
+            param.dynamic_quant = true;
+            testbase0.set_param(param);
+            testbase0.set_rand_limit(1, 12);
+            testbase0.set_input_shape(shape);
+            testbase0.run_test(fc_cpu_base<float, X86, X86>, 1.0e-2f);
+        }
+    }
+
+    //fp16 and bf16 weights, expanded to fp32 inside the gemm
+    Tensor<X86> weights_half;
+
+    for (DataType weights_dtype : {AK_HALF, AK_BFLOAT16}) {
+        for (int ch_in : {3, 64}) {
+            for (int num_in : {1, 21}) {
+                int out_num = 40;
+                Shape shape({num_in, ch_in, 4, 4});
+                Shape shape_w({ch_in, 4, 4, out_num});
+                weights_h0.re_alloc(shape_w, AK_FLOAT);
+                fill_tensor_rand(weights_h0, 0.1, 1.5);
+                weights_half.re_alloc(shape_w, weights_dtype);
+                fp32_to_half(static_cast<const float*>(weights_h0.data()),
+                             static_cast<uint16_t*>(weights_half.mutable_data()),
+                             weights_h0.valid_size(), weights_dtype);
+                FcParam<X86> param(&weights_half, out_num);
+                testbase0.set_param(param);
+                testbase0.set_rand_limit(-12, 12);
+                testbase0.set_input_shape(shape);
+                testbase0.run_test(fc_half_weights_cpu_base, 1.0e-3f);
+            }
+        }
+    }
+
+    //bias, activation and residual add fused into the gemm epilogue
+    TestSaberBase<X86, X86, AK_FLOAT, Fc, FcParam> testbase_residual(2);
+    Tensor<X86> bias_h0;
+    Tensor<X86> slope_h0;
+
+    for (ActiveType act : {Active_relu, Active_sigmoid, Active_tanh, Active_gelu, Active_prelu,
+                           Active_stanh, Active_swish}) {
+        for (bool residual : {false, true}) {
+            for (int num_in : {1, 21, 256}) {
+                int out_num = 40;
+                Shape shape({num_in, 16, 2, 2});
+                Shape shape_w({16, 2, 2, out_num});
+                weights_h0.re_alloc(shape_w, AK_FLOAT);
+                fill_tensor_rand(weights_h0, -1.f, 1.f);
+                bias_h0.re_alloc(Shape({1, 1, 1, out_num}), AK_FLOAT);
+                fill_tensor_rand(bias_h0, -1.f, 1.f);
+                slope_h0.re_alloc(Shape({1, 1, 1, out_num}), AK_FLOAT);
+                fill_tensor_rand(slope_h0, 0.f, 1.f);
+                FcParam<X86> param(&weights_h0, &bias_h0, out_num);
+                param.activation_param = act == Active_prelu ?
+                        ActivationParam<X86>(act, 0.f, 0.f, PreluParam<X86>(false, &slope_h0)) :
+                        act == Active_stanh ? ActivationParam<X86>(act, 0.67f, 1.7159f) :
+                        act == Active_swish ? ActivationParam<X86>(act, 0.f, 1.5f) :
+                        ActivationParam<X86>(act, 0.f);
+                param.residual = residual;
+                auto& testbase = residual ? testbase_residual : testbase0;
+                testbase.set_param(param);
+                testbase.set_rand_limit(-2, 2);
+                if (residual) {
+                    testbase.set_input_shape(std::vector<Shape>{shape, Shape({num_in, out_num, 1, 1})});
+                } else {
+                    testbase.set_input_shape(shape);
+                }
+                testbase.run_test(fc_epilogue_cpu_base, 1.0e-3f);
+            }
+        }
+    }
 #endif
 
 #ifdef USE_ARM_PLACE
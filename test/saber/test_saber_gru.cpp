@@ -6,6 +6,7 @@
 #include "saber/core/context.h"
 #include "saber/funcs/gru.h"
 #include "saber/funcs/impl/x86/x86_utils.h"
+#include "saber/funcs/impl/x86/half_convert_helper.h"
 #include "saber/core/tensor_op.h"
 #include "saber/funcs/debug.h"
 
@@ -427,7 +428,66 @@ void gru_ut(int word_size = 222,
 }
 
 #ifdef USE_X86_PLACE
+/**
+ * \brief gru on fp16 / bf16 weights, the reference runs on the same weights rounded to
+ *  16 bit and expanded back to fp32, so only the 16 bit gemms are checked.
+ */
+void gru_half_weights_ut(int word_size, int hidden_size, std::vector<int> offsets,
+                         bool is_reverse, GruFormula formula, DataType weights_dtype) {
+    Context<X86> ctx_dev(0, 1, 1);
+    Shape shape_weight({1, 1, 1, hidden_size * word_size * 3 + hidden_size * hidden_size * 3}, Layout_NCHW);
+    Shape shape_bias({1, 1, 1, hidden_size * 3}, Layout_NCHW);
+    Shape shape_x({offsets[offsets.size() - 1], word_size, 1, 1}, Layout_NCHW);
+    Shape shape_h({offsets[offsets.size() - 1], hidden_size, 1, 1}, Layout_NCHW);
+    Tensor<X86> host_x(shape_x);
+    Tensor<X86> host_weight(shape_weight);
+    Tensor<X86> half_weight(shape_weight, weights_dtype);
+    Tensor<X86> host_bias(shape_bias);
+    Tensor<X86> host_hidden_out(shape_h);
+    Tensor<X86> compare_g(shape_h);
+    fill_tensor_rand(host_weight, -1.f, 1.f);
+    fill_tensor_rand(host_x, -1.f, 1.f);
+    fill_tensor_rand(host_bias, -1.f, 1.f);
+    fp32_to_half(static_cast<const float*>(host_weight.data()),
+                 static_cast<uint16_t*>(half_weight.mutable_data()), host_weight.valid_size(), weights_dtype);
+    half_to_fp32(static_cast<const uint16_t*>(half_weight.data()),
+                 static_cast<float*>(host_weight.mutable_data()), host_weight.valid_size(), weights_dtype);
+    host_x.set_seq_offset({offsets});
+
+    GruParam<X86> param(&half_weight, &host_bias, formula, Active_sigmoid, Active_tanh,
+                        is_reverse, nullptr, 1.f, 1, 1);
+    Gru<X86, AK_FLOAT> gru_op;
+    std::vector<Tensor<X86>*> inputs{&host_x};
+    std::vector<Tensor<X86>*> outputs{&host_hidden_out};
+    SABER_CHECK(gru_op.init(inputs, outputs, param, SPECIFY, SABER_IMPL, ctx_dev));
+    SABER_CHECK(gru_op.compute_output_shape(inputs, outputs, param));
+    outputs[0]->re_alloc(outputs[0]->valid_shape(), outputs[0]->get_dtype());
+    SABER_CHECK(gru_op(inputs, outputs, param, ctx_dev));
+
+    std::vector<Tensor<X86>*> outputs_ref{&compare_g};
+    GruParam<X86> param_ref(&host_weight, &host_bias, formula, Active_sigmoid, Active_tanh,
+                            is_reverse, nullptr, 1.f, 1, 1);
+    compute_ref_gru_fwd_me(inputs, outputs_ref, param_ref);
+    double maxdiff = 0;
+    double maxratio = 0;
+    tensor_cmp_host((const float*)host_hidden_out.data(), (const float*)compare_g.data(),
+                    host_hidden_out.valid_size(), maxratio, maxdiff);
+    CHECK_LT(maxdiff, 1e-4) << "half weights failed, dtype " << weights_dtype << ", formula " << formula
+                            << ", param = " << word_size << "," << hidden_size;
+}
 
+TEST(TestSaberFunc, test_func_gru_half_weights_x86) {
+    Env<X86>::env_init();
+    srand(12345678);
+    for (DataType weights_dtype : {AK_HALF, AK_BFLOAT16})
+        for (int word_size : {15, 222})
+            for (int hidden_size : {15, 333})
+                for (GruFormula formula : {GRU_ORIGIN, GRU_CUDNN}) {
+        gru_half_weights_ut(word_size, hidden_size, {0, 5}, false, formula, weights_dtype);
+        gru_half_weights_ut(word_size, hidden_size, {0, 3, 7, 12, 13}, true, formula, weights_dtype);
+    }
+    LOG(INFO) << "gru half weights check pass";
+}
 
 TEST(TestSaberFunc, test_func_gru_x86) {
     Env<X86>::env_init();
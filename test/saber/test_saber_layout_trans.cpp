@@ -0,0 +1,121 @@
+#include <vector>
+
+#include "saber/core/context.h"
+#include "test_saber_func.h"
+#include "saber/core/tensor_op.h"
+#include "saber/saber_types.h"
+#include "saber/funcs/layout_trans.h"
+
+using namespace anakin::saber;
+
+/**
+ * @brief offset of element (n, c, h, w) in a tensor of the given layout,
+ * blocked layouts are [n][c / block][h][w][block].
+ */
+int layout_offset(LayoutType layout, int channel, int height, int width,
+                  int n, int c, int h, int w) {
+    switch (layout) {
+    case Layout_NHWC:
+        return ((n * height + h) * width + w) * channel + c;
+
+    case Layout_NCHW_C8R:
+    case Layout_NCHW_C16R: {
+        int block = layout == Layout_NCHW_C8R ? 8 : 16;
+        int block_num = (channel + block - 1) / block;
+        return (((n * block_num + c / block) * height + h) * width + w) * block + c % block;
+    }
+
+    default:
+        return ((n * channel + c) * height + h) * width + w;
+    }
+}
+
+template<typename TargetType>
+void layout_trans_run(Tensor<TargetType>& input, Tensor<TargetType>& output, Context<TargetType>& ctx) {
+    LayoutTrans<TargetType, AK_FLOAT> layout_trans;
+    LayoutTransParam<TargetType> param;
+    std::vector<Tensor<TargetType>*> input_v{&input};
+    std::vector<Tensor<TargetType>*> output_v{&output};
+    layout_trans.compute_output_shape(input_v, output_v, param);
+    output.re_alloc(output.valid_shape(), AK_FLOAT);
+    layout_trans.init(input_v, output_v, param, SPECIFY, SABER_IMPL, ctx);
+    layout_trans(input_v, output_v, param, ctx);
+    typename Tensor<TargetType>::API::stream_t stream = ctx.get_compute_stream();
+    output.record_event(stream);
+    output.sync();
+}
+
+template<typename TargetType>
+void test_layout_trans(LayoutType in_layout, LayoutType out_layout,
+                       int in_n, int in_c, int in_h, int in_w) {
+    Context<TargetType> ctx(0, 1, 1);
+    Tensor<TargetType> input(Shape({in_n, in_c, in_h, in_w}, in_layout));
+    Tensor<TargetType> output(Shape({in_n, in_c, in_h, in_w}, out_layout));
+    Tensor<TargetType> round_trip(Shape({in_n, in_c, in_h, in_w}, in_layout));
+    fill_tensor_rand(input, -10.f, 10.f);
+    layout_trans_run(input, output, ctx);
+    layout_trans_run(output, round_trip, ctx);
+
+    const float* src = static_cast<const float*>(input.data());
+    const float* dst = static_cast<const float*>(output.data());
+    const float* back = static_cast<const float*>(round_trip.data());
+    int error_count = 0;
+
+    for (int n = 0; n < in_n; ++n) {
+        for (int c = 0; c < in_c; ++c) {
+            for (int h = 0; h < in_h; ++h) {
+                for (int w = 0; w < in_w; ++w) {
+                    int src_id = layout_offset(in_layout, in_c, in_h, in_w, n, c, h, w);
+                    int dst_id = layout_offset(out_layout, in_c, in_h, in_w, n, c, h, w);
+                    error_count += src[src_id] != dst[dst_id];
+                    error_count += src[src_id] != back[src_id];
+                }
+            }
+        }
+    }
+
+    if (out_layout == Layout_NCHW_C8R || out_layout == Layout_NCHW_C16R) {
+        int block = out_layout == Layout_NCHW_C8R ? 8 : 16;
+
+        for (int n = 0; n < in_n; ++n) {
+            for (int c = in_c; c < (in_c + block - 1) / block * block; ++c) {
+                for (int hw = 0; hw < in_h * in_w; ++hw) {
+                    error_count += dst[layout_offset(out_layout, in_c, in_h, in_w, n, c, 0, hw)] != 0.f;
+                }
+            }
+        }
+    }
+
+    CHECK_EQ(error_count, 0) << "layout trans " << in_layout << " -> " << out_layout
+                             << " failed, shape = " << in_n << ", " << in_c << ", " << in_h << ", " << in_w;
+}
+
+TEST(TestSaberFunc, test_func_layout_trans) {
+#ifdef USE_X86_PLACE
+    Env<X86>::env_init();
+
+    for (LayoutType out_layout : {Layout_NCHW_C8R, Layout_NCHW_C16R, Layout_NHWC}) {
+        for (int in_n : {1, 3}) {
+            for (int in_c : {1, 3, 8, 17, 32}) {
+                for (int in_h : {1, 7, 32}) {
+                    for (int in_w : {1, 13, 64}) {
+                        test_layout_trans<X86>(Layout_NCHW, out_layout, in_n, in_c, in_h, in_w);
+                    }
+                }
+            }
+        }
+    }
+
+    test_layout_trans<X86>(Layout_NCHW_C8R, Layout_NCHW_C16R, 2, 20, 5, 7);
+    test_layout_trans<X86>(Layout_NCHW_C16R, Layout_NHWC, 2, 20, 5, 7);
+    LOG(INFO) << "layout trans passed";
+#endif
+}
+
+int main(int argc, const char** argv) {
+    // initial logger
+    //logger::init(argv[0]);
+    InitTest();
+    RUN_ALL_TESTS(argv[0]);
+    return 0;
+}
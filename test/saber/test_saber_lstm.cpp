@@ -7,6 +7,7 @@
 #include "saber/funcs/lstm.h"
 #include "saber/funcs/lstmp.h"
 #include "saber/funcs/impl/x86/x86_utils.h"
+#include "saber/funcs/impl/x86/half_convert_helper.h"
 #include "saber/core/tensor_op.h"
 #include "debug.h"
 
@@ -688,8 +689,67 @@ void lstmp_ut(int word_size ,
 
 }
 
-
 #ifdef USE_X86_PLACE
+/**
+ * \brief lstm on fp16 / bf16 weights, the reference runs on the same weights rounded to
+ *  16 bit and expanded back to fp32, so only the 16 bit gemms are checked.
+ */
+void lstm_half_weights_ut(int word_size, int hidden_size, std::vector<int> offsets,
+                          bool is_reverse, bool with_peephole, DataType weights_dtype) {
+    Context<X86> ctx_dev(0, 1, 1);
+    Shape shape_weight({1, 1, 1, hidden_size * hidden_size * 4 + hidden_size * word_size * 4}, Layout_NCHW);
+    Shape shape_bias({1, 1, 1, hidden_size * (with_peephole ? 7 : 4)}, Layout_NCHW);
+    Shape shape_x({offsets[offsets.size() - 1], word_size, 1, 1}, Layout_NCHW);
+    Shape shape_h({offsets[offsets.size() - 1], hidden_size, 1, 1}, Layout_NCHW);
+    Tensor<X86> host_x(shape_x);
+    Tensor<X86> host_weight(shape_weight);
+    Tensor<X86> half_weight(shape_weight, weights_dtype);
+    Tensor<X86> host_bias(shape_bias);
+    Tensor<X86> host_hidden_out(shape_h);
+    Tensor<X86> compare_g(shape_h);
+    fill_tensor_rand(host_weight, -1, 1);
+    fill_tensor_rand(host_x, -1, 1);
+    fill_tensor_rand(host_bias, -1, 1);
+    fp32_to_half(static_cast<const float*>(host_weight.data()),
+                 static_cast<uint16_t*>(half_weight.mutable_data()), host_weight.valid_size(), weights_dtype);
+    half_to_fp32(static_cast<const uint16_t*>(half_weight.data()),
+                 static_cast<float*>(host_weight.mutable_data()), host_weight.valid_size(), weights_dtype);
+    host_x.set_seq_offset({offsets});
+
+    LstmParam<X86> param(&half_weight, &host_bias, nullptr, Active_unknow, Active_sigmoid, Active_tanh,
+                         Active_tanh, with_peephole, false, is_reverse);
+    Lstm<X86, AK_FLOAT> lstm_op;
+    std::vector<Tensor<X86>*> inputs{&host_x};
+    std::vector<Tensor<X86>*> outputs{&host_hidden_out};
+    SABER_CHECK(lstm_op.init(inputs, outputs, param, SPECIFY, SABER_IMPL, ctx_dev));
+    SABER_CHECK(lstm_op.compute_output_shape(inputs, outputs, param));
+    outputs[0]->re_alloc(outputs[0]->valid_shape(), outputs[0]->get_dtype());
+    SABER_CHECK(lstm_op(inputs, outputs, param, ctx_dev));
+
+    std::vector<Tensor<X86>*> outputs_ref{&compare_g};
+    LstmParam<X86> param_ref(&host_weight, &host_bias, nullptr, Active_unknow, Active_sigmoid, Active_tanh,
+                             Active_tanh, with_peephole, false, is_reverse);
+    compute_ref_lstm_fwd_me(inputs, outputs_ref, param_ref);
+    double maxdiff = 0;
+    double maxratio = 0;
+    tensor_cmp_host((const float*)host_hidden_out.data(), (const float*)compare_g.data(),
+                    host_hidden_out.valid_size(), maxratio, maxdiff);
+    CHECK_LT(maxdiff, 1e-4) << "half weights failed, dtype " << weights_dtype << ", param = "
+                            << word_size << "," << hidden_size << ", with_peephole = " << with_peephole;
+}
+
+TEST(TestSaberFunc, test_func_lstm_half_weights_x86) {
+    Env<X86>::env_init();
+    srand(12345);
+    for (DataType weights_dtype : {AK_HALF, AK_BFLOAT16})
+        for (int word_size : {15, 222})
+            for (int hidden_size : {15, 333})
+                for (bool with_peephole : {true, false}) {
+        lstm_half_weights_ut(word_size, hidden_size, {0, 3, 7, 12, 13}, false, with_peephole, weights_dtype);
+        lstm_half_weights_ut(word_size, hidden_size, {0, 5}, true, with_peephole, weights_dtype);
+    }
+    LOG(INFO) << "lstm half weights check pass";
+}
 
 TEST(TestSaberFunc, test_func_lstm_x86) {
     Env<X86>::env_init();
@@ -98,6 +98,54 @@ void mat_mul_cpu_base(const std::vector<Tensor<TargetType_H>* >& input,
     }
 
 }
+#ifdef USE_X86_PLACE
+/**
+ * @brief mat_mul on the permuted, broadcast and strided views of the inputs
+ */
+void mat_mul_view_cpu_base(const std::vector<Tensor<X86>* >& input,
+                           std::vector<Tensor<X86>* >& output, MatMulParam<X86>& param) {
+    int x_dims[4];
+    int x_strides[4];
+    int y_dims[4];
+    int y_strides[4];
+    param.operand_view(*input[0], param._x_axes, x_dims, x_strides);
+    param.operand_view(*input[1], param._y_axes, y_dims, y_strides);
+    int M = param._is_transpose_X ? x_dims[3] : x_dims[2];
+    int K = param._is_transpose_X ? x_dims[2] : x_dims[3];
+    int N = param._is_transpose_Y ? y_dims[2] : y_dims[3];
+    int batch_n = std::max(x_dims[0], y_dims[0]);
+    int batch_c = std::max(x_dims[1], y_dims[1]);
+    const float* x = (const float*)input[0]->data();
+    const float* y = (const float*)input[1]->data();
+    float* out = (float*)output[0]->mutable_data();
+
+    for (int n = 0; n < batch_n; n++) {
+        for (int c = 0; c < batch_c; c++) {
+            const float* x_b = x + (x_dims[0] == 1 ? 0 : n) * x_strides[0]
+                               + (x_dims[1] == 1 ? 0 : c) * x_strides[1];
+            const float* y_b = y + (y_dims[0] == 1 ? 0 : n) * y_strides[0]
+                               + (y_dims[1] == 1 ? 0 : c) * y_strides[1];
+
+            for (int i = 0; i < M; i++) {
+                for (int j = 0; j < N; j++) {
+                    float sum = 0.f;
+
+                    for (int l = 0; l < K; l++) {
+                        float x_il = param._is_transpose_X ? x_b[l * x_strides[2] + i * x_strides[3]]
+                                     : x_b[i * x_strides[2] + l * x_strides[3]];
+                        float y_lj = param._is_transpose_Y ? y_b[j * y_strides[2] + l * y_strides[3]]
+                                     : y_b[l * y_strides[2] + j * y_strides[3]];
+                        sum += x_il * y_lj;
+                    }
+
+                    out[((n * batch_c + c) * M + i) * N + j] = sum * param._scale;
+                }
+            }
+        }
+    }
+}
+#endif
+
 TEST(TestSaberFunc, test_op_mat_mul) {
 
     int input_num = 2;
@@ -167,6 +215,85 @@ TEST(TestSaberFunc, test_op_mat_mul) {
         }
     }
 
+    //one input broadcast over the n and c batch dims of the other
+    for (bool trans_x : {false, true}) {
+        for (bool trans_y : {false, true}) {
+            std::vector<std::vector<Shape>> shapes_v = {
+                {Shape({2, 3, 16, 16}), Shape({1, 1, 16, 16})},
+                {Shape({1, 3, 16, 16}), Shape({2, 1, 16, 16})},
+                {Shape({1, 1, 16, 16}), Shape({2, 3, 16, 16})},
+            };
+
+            for (auto& shapes : shapes_v) {
+                MatMulParam<X86> param(trans_x, trans_y, 0.5f);
+                testbase_x86.set_param(param);
+                testbase_x86.set_rand_limit(-1, 1);
+                testbase_x86.set_input_shape(shapes);
+                testbase_x86.run_test(mat_mul_view_cpu_base);
+            }
+        }
+    }
+
+    //attention scores q * k^t with q and k stored as batch, seq, head, dim,
+    //the head permute is read in place
+    {
+        MatMulParam<X86> param(false, true);
+        param._x_axes = {0, 2, 1, 3};
+        param._y_axes = {0, 2, 1, 3};
+        testbase_x86.set_param(param);
+        testbase_x86.set_rand_limit(-1, 1);
+        testbase_x86.set_input_shape(std::vector<Shape>{Shape({2, 10, 4, 8}), Shape({2, 12, 4, 8})});
+        testbase_x86.run_test(mat_mul_view_cpu_base);
+    }
+
+    //column major views are passed to the gemm transposed
+    {
+        MatMulParam<X86> param(false, false);
+        param._y_axes = {0, 1, 3, 2};
+        testbase_x86.set_param(param);
+        testbase_x86.set_rand_limit(-1, 1);
+        testbase_x86.set_input_shape(std::vector<Shape>{Shape({2, 3, 4, 5}), Shape({2, 3, 6, 5})});
+        testbase_x86.run_test(mat_mul_view_cpu_base);
+    }
+
+    //matrices with no unit stride are gathered first
+    {
+        MatMulParam<X86> param(false, false);
+        param._x_axes = {2, 3, 0, 1};
+        testbase_x86.set_param(param);
+        testbase_x86.set_rand_limit(-1, 1);
+        testbase_x86.set_input_shape(std::vector<Shape>{Shape({4, 5, 2, 3}), Shape({1, 1, 5, 6})});
+        testbase_x86.run_test(mat_mul_view_cpu_base);
+    }
+
+    //axes must permute all the 4 dims
+    {
+        MatMulParam<X86> param(false, false);
+        CHECK(param.valid_axes());
+        param._x_axes = {0, 2, 1, 3};
+        CHECK(param.valid_axes());
+        param._y_axes = {0, 1, 1, 3};
+        CHECK(!param.valid_axes()) << "a repeated axis";
+        param._y_axes = {0, 1, 2, 4};
+        CHECK(!param.valid_axes()) << "an axis out of range";
+        param._y_axes = {0, 2, 1};
+        CHECK(!param.valid_axes()) << "a missing axis";
+    }
+
+    //dynamic quant with a constant y, packed once in int8
+    for (bool trans_y : {false, true}) {
+        for (int num_in : {1, 3}) {
+            MatMulParam<X86> param(false, trans_y, 0.5f);
+            param._dynamic_quant = true;
+            param._const_y = true;
+            testbase_x86.set_param(param);
+            testbase_x86.set_rand_limit(1, 12);
+            testbase_x86.set_input_shape(std::vector<Shape>{Shape({num_in, 2, 16, 64}),
+                                         Shape({num_in, 2, trans_y ? 24 : 64, trans_y ? 64 : 24})});
+            testbase_x86.run_test(mat_mul_view_cpu_base, 1.0e-2f);
+        }
+    }
+
 #endif
 }
 
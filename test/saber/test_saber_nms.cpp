@@ -0,0 +1,299 @@
+#include "saber/core/context.h"
+#include "saber/funcs/impl/detection_helper.h"
+#include "test_saber_func.h"
+#include "saber/saber_types.h"
+#include <vector>
+#include <algorithm>
+
+#ifdef USE_X86_PLACE
+#include "saber/funcs/impl/x86/nms_helper.h"
+
+using namespace anakin::saber;
+
+/**
+ * \brief the jaccard overlap of detection_helper written out, an invalid box has no area
+ */
+static float naive_overlap(const float* a, const float* b) {
+    if (b[0] > a[2] || b[2] < a[0] || b[1] > a[3] || b[3] < a[1]) {
+        return 0.f;
+    }
+    float inter = (std::min(a[2], b[2]) - std::max(a[0], b[0]))
+                  * (std::min(a[3], b[3]) - std::max(a[1], b[1]));
+    float area_a = (a[2] < a[0] || a[3] < a[1]) ? 0.f : (a[2] - a[0]) * (a[3] - a[1]);
+    float area_b = (b[2] < b[0] || b[3] < b[1]) ? 0.f : (b[2] - b[0]) * (b[3] - b[1]);
+    return inter / (area_a + area_b - inter);
+}
+
+/**
+ * \brief greedy nms by repeated selection of the best score, ties go to the lower index
+ */
+static void naive_nms(const float* bboxes, const float* scores, int num,
+                      float score_threshold, float nms_threshold, float eta,
+                      int top_k, std::vector<int>* indices) {
+    std::vector<bool> used(num, false);
+    std::vector<int> order;
+    while (top_k < 0 || order.size() < top_k) {
+        int best = -1;
+        for (int i = 0; i < num; ++i) {
+            if (!used[i] && scores[i] > score_threshold && (best < 0 || scores[i] > scores[best])) {
+                best = i;
+            }
+        }
+        if (best < 0) {
+            break;
+        }
+        used[best] = true;
+        order.push_back(best);
+    }
+    float threshold = nms_threshold;
+    indices->clear();
+    for (int idx : order) {
+        bool keep = true;
+        for (int kept : *indices) {
+            //! the overlap of two boxes without area is nan, which suppresses
+            if (!(naive_overlap(bboxes + idx * 4, bboxes + kept * 4) <= threshold)) {
+                keep = false;
+                break;
+            }
+        }
+        if (keep) {
+            indices->push_back(idx);
+            if (eta < 1 && threshold > 0.5) {
+                threshold *= eta;
+            }
+        }
+    }
+}
+
+/**
+ * \brief nms of every class, then the keep_topk best detections of an image
+ *  grouped by ascending label, rows of (image, label, score, x1, y1, x2, y2)
+ */
+static void naive_detect(const float* bbox, const float* conf, std::vector<float>& result,
+                         const std::vector<int>& priors, int class_num, int background_id,
+                         int keep_topk, int nms_topk, float conf_thresh, float nms_thresh,
+                         float nms_eta, bool share_location) {
+    result.clear();
+    int offset = 0;
+    for (int i = 0; i < priors.size(); ++i) {
+        int num = priors[i];
+        const float* img_conf = conf + offset * class_num;
+        const float* img_bbox = bbox + offset * 4 * (share_location ? 1 : class_num);
+        std::vector<std::vector<int> > kept(class_num);
+        std::vector<std::pair<int, int> > dets;
+        for (int c = 0; c < class_num; ++c) {
+            if (c == background_id) {
+                continue;
+            }
+            const float* cls_bbox = img_bbox + (share_location ? 0 : c * num * 4);
+            naive_nms(cls_bbox, img_conf + c * num, num, conf_thresh, nms_thresh, nms_eta,
+                      nms_topk, &kept[c]);
+            for (int idx : kept[c]) {
+                dets.push_back(std::make_pair(c, idx));
+            }
+        }
+        if (keep_topk > -1 && dets.size() > keep_topk) {
+            std::vector<bool> used(dets.size(), false);
+            std::vector<std::vector<int> > top(class_num);
+            for (int k = 0; k < keep_topk; ++k) {
+                int best = -1;
+                for (int j = 0; j < dets.size(); ++j) {
+                    float score = img_conf[dets[j].first * num + dets[j].second];
+                    if (!used[j] && (best < 0
+                            || score > img_conf[dets[best].first * num + dets[best].second])) {
+                        best = j;
+                    }
+                }
+                used[best] = true;
+                top[dets[best].first].push_back(dets[best].second);
+            }
+            kept.swap(top);
+        }
+        for (int c = 0; c < class_num; ++c) {
+            const float* cls_bbox = img_bbox + (share_location ? 0 : c * num * 4);
+            for (int idx : kept[c]) {
+                result.push_back(i);
+                result.push_back(c);
+                result.push_back(img_conf[c * num + idx]);
+                for (int k = 0; k < 4; ++k) {
+                    result.push_back(cls_bbox[idx * 4 + k]);
+                }
+            }
+        }
+        offset += num;
+    }
+}
+
+/**
+ * \brief boxes on a quarter grid, so every overlap is computed exactly by all versions,
+ *  scores on an eighth grid, so many of them tie and some equal the threshold
+ */
+static void fill_boxes(std::vector<float>& bbox, std::vector<float>& conf, int box_num,
+                       int conf_num, unsigned int seed) {
+    auto rand_int = [&seed](int n) {
+        seed = seed * 1103515245u + 12345u;
+        return (int)((seed >> 16) % n);
+    };
+    bbox.resize(box_num * 4);
+    for (int i = 0; i < box_num; ++i) {
+        float x = rand_int(48) * 0.25f;
+        float y = rand_int(48) * 0.25f;
+        bbox[i * 4] = x;
+        bbox[i * 4 + 1] = y;
+        bbox[i * 4 + 2] = x + (rand_int(24) - 2) * 0.25f;
+        bbox[i * 4 + 3] = y + (rand_int(24) - 2) * 0.25f;
+    }
+    conf.resize(conf_num);
+    for (int i = 0; i < conf_num; ++i) {
+        conf[i] = rand_int(9) * 0.125f;
+    }
+}
+
+static void check_indices(const std::vector<int>& test, const std::vector<int>& ref,
+                          const char* name) {
+    CHECK_EQ(test.size(), ref.size()) << name << " keeps a different number of boxes";
+    for (int i = 0; i < ref.size(); ++i) {
+        CHECK_EQ(test[i], ref[i]) << name << " differs at " << i;
+    }
+}
+
+TEST(TestSaberFunc, test_nms_threshold_edges) {
+    //! box 1 overlaps box 0 by exactly 0.5, box 3 only touches its corner, box 4 is a copy of it
+    std::vector<float> bbox = {0.f, 0.f, 2.f, 1.f,
+                               0.f, 0.f, 1.f, 1.f,
+                               1.5f, 0.f, 3.5f, 1.f,
+                               2.f, 1.f, 3.f, 2.f,
+                               0.f, 0.f, 2.f, 1.f};
+    std::vector<float> conf = {0.5f, 0.5f, 0.75f, 0.25f, 0.5f};
+    std::vector<int> indices;
+    std::vector<int> ref;
+    for (float score_thresh : {0.f, 0.25f, 0.5f}) {
+        for (float nms_thresh : {0.f, 0.25f, 0.5f, 1.f}) {
+            for (int top_k : {-1, 0, 1, 2, 3, 5}) {
+                naive_nms(bbox.data(), conf.data(), 5, score_thresh, nms_thresh, 1.f, top_k, &ref);
+                apply_nms_fast_x86(bbox.data(), conf.data(), 5, score_thresh, nms_thresh, 1.f,
+                                   top_k, &indices);
+                check_indices(indices, ref, "apply_nms_fast_x86");
+            }
+        }
+    }
+    //! an overlap equal to the threshold is kept, a score equal to the threshold is not
+    apply_nms_fast_x86(bbox.data(), conf.data(), 5, 0.25f, 0.5f, 1.f, -1, &indices);
+    check_indices(indices, {2, 0, 1}, "apply_nms_fast_x86");
+    LOG(INFO) << "nms threshold edges check pass";
+}
+
+TEST(TestSaberFunc, test_nms_apply_fast) {
+    std::vector<float> bbox;
+    std::vector<float> conf;
+    std::vector<int> indices;
+    std::vector<int> ref;
+    std::vector<int> helper;
+    //! sizes around the simd width and the 64 bit suppression words
+    for (int num : {1, 7, 8, 9, 16, 17, 63, 64, 65, 130, 300}) {
+        fill_boxes(bbox, conf, num, num, num * 31 + 7);
+        for (float eta : {1.f, 0.9f}) {
+            for (float nms_thresh : {0.3f, 0.5f, 0.7f}) {
+                for (int top_k : {-1, 5, num}) {
+                    naive_nms(bbox.data(), conf.data(), num, 0.25f, nms_thresh, eta, top_k, &ref);
+                    apply_nms_fast(bbox.data(), conf.data(), num, 0.25f, nms_thresh, eta, top_k,
+                                   &helper);
+                    apply_nms_fast_x86(bbox.data(), conf.data(), num, 0.25f, nms_thresh, eta,
+                                       top_k, &indices);
+                    check_indices(helper, ref, "apply_nms_fast");
+                    check_indices(indices, ref, "apply_nms_fast_x86");
+                }
+            }
+        }
+    }
+    LOG(INFO) << "apply nms fast check pass";
+}
+
+TEST(TestSaberFunc, test_nms_detect_multi_class) {
+    std::vector<float> bbox;
+    std::vector<float> conf;
+    std::vector<float> result;
+    std::vector<float> ref;
+    std::vector<float> helper;
+    const int class_num = 5;
+    for (auto priors : std::vector<std::vector<int> >{{9}, {70, 1, 33}, {200, 150}}) {
+        int total = 0;
+        for (int p : priors) {
+            total += p;
+        }
+        for (bool share_location : {true, false}) {
+            int box_num = share_location ? total : total * class_num;
+            fill_boxes(bbox, conf, box_num, total * class_num, total + share_location);
+            for (int background_id : {0, -1}) {
+                for (int keep_topk : {-1, 0, 3, 20, 1000}) {
+                    for (int nms_topk : {-1, 4, 50}) {
+                        naive_detect(bbox.data(), conf.data(), ref, priors, class_num,
+                                     background_id, keep_topk, nms_topk, 0.25f, 0.45f, 1.f,
+                                     share_location);
+                        nms_detect(bbox.data(), conf.data(), helper, priors, class_num,
+                                   background_id, keep_topk, nms_topk, 0.25f, 0.45f, 1.f,
+                                   share_location);
+                        nms_detect_x86(bbox.data(), conf.data(), result, priors, class_num,
+                                       background_id, keep_topk, nms_topk, 0.25f, 0.45f, 1.f,
+                                       share_location);
+                        CHECK_EQ(helper.size(), ref.size());
+                        CHECK_EQ(result.size(), ref.size());
+                        for (int i = 0; i < ref.size(); ++i) {
+                            CHECK_EQ(helper[i], ref[i]) << "nms_detect differs at row " << i / 7;
+                            CHECK_EQ(result[i], ref[i]) << "nms_detect_x86 differs at row " << i / 7;
+                        }
+                    }
+                }
+            }
+        }
+    }
+    LOG(INFO) << "nms detect multi class check pass";
+}
+
+TEST(TestSaberFunc, test_nms_lm) {
+    std::vector<float> bbox;
+    std::vector<float> conf;
+    for (int num : {1, 8, 17, 65, 200}) {
+        fill_boxes(bbox, conf, num, num, num * 13 + 1);
+        for (bool size_add_one : {false, true}) {
+            for (int max_candidate : {-1, 10}) {
+                for (int top_n : {0, 3, 1000}) {
+                    std::vector<BBox<float> > ref_cand(num);
+                    for (int i = 0; i < num; ++i) {
+                        ref_cand[i].x1 = bbox[i * 4];
+                        ref_cand[i].y1 = bbox[i * 4 + 1];
+                        ref_cand[i].x2 = bbox[i * 4 + 2];
+                        ref_cand[i].y2 = bbox[i * 4 + 3];
+                        ref_cand[i].score = conf[i];
+                    }
+                    std::vector<BBox<float> > cand = ref_cand;
+                    std::vector<bool> ref = nms_lm(ref_cand, 0.5f, top_n, false, max_candidate,
+                                                   size_add_one, false, 0.f);
+                    std::vector<bool> mask = nms_lm_x86(cand, 0.5f, top_n, false, max_candidate,
+                                                        size_add_one, false, 0.f);
+                    CHECK_EQ(mask.size(), ref.size());
+                    int consider = max_candidate > 0 ? std::min(num, max_candidate) : num;
+                    for (int i = 0; i < num; ++i) {
+                        CHECK_EQ(mask[i], ref[i]) << "nms_lm_x86 mask differs at " << i;
+                    }
+                    //! the considered candidates are sorted the same, ties kept in input order
+                    for (int i = 0; i < consider; ++i) {
+                        CHECK_EQ(cand[i].score, ref_cand[i].score);
+                        CHECK_EQ(cand[i].x1, ref_cand[i].x1);
+                        CHECK_EQ(cand[i].y2, ref_cand[i].y2);
+                    }
+                }
+            }
+        }
+    }
+    LOG(INFO) << "nms lm check pass";
+}
+#endif
+
+int main(int argc, const char** argv) {
+    // initial logger
+    logger::init(argv[0]);
+    InitTest();
+    RUN_ALL_TESTS(argv[0]);
+    return 0;
+}
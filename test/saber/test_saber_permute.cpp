@@ -51,8 +51,8 @@ void test_permute(){
                         PermuteParam<TargetType_D> param({s0, s1, s2, s3});
                         for (int n : {1, 2}){
                             for (int c : {1, 3}){
-                                for (int h : {32, 64}){
-                                    for (int w: {32, 64}){
+                                for (int h : {7, 32, 64}){
+                                    for (int w: {13, 32, 64}){
                                         testbase.set_param(param);
                                         testbase.set_input_shape(Shape({n, c, h, w}));
                                         testbase.run_test(permute_cpu_func<dtype, TargetType_D, TargetType_H>);
@@ -232,6 +232,116 @@ void test_roi_align(){
     }
 }
 
+#ifdef USE_X86_PLACE
+/**
+ * @brief offset of element (n, c, h, w) in a blocked tensor, [n][c / block][h][w][block].
+ */
+static int blocked_offset(int block, int channel, int height, int width,
+                          int n, int c, int h, int w) {
+    int block_num = (channel + block - 1) / block;
+    return (((n * block_num + c / block) * height + h) * width + w) * block + c % block;
+}
+
+/**
+ * @brief run roi align on a blocked copy of a nchw input, the result is checked against
+ * roi_align_cpu_base on the nchw input.
+ */
+void test_roi_align_blocked(LayoutType layout, int num_in, int c_in, int h_in, int w_in,
+                            int roi_num, int pooled_height, int pooled_width) {
+    Context<X86> ctx(0, 1, 1);
+    const int block = (layout == Layout_NCHW_C8 || layout == Layout_NCHW_C8R) ? 8 : 16;
+    const int block_num = (c_in + block - 1) / block;
+    const bool real_channel = layout == Layout_NCHW_C8R || layout == Layout_NCHW_C16R;
+    RoiAlignParam<X86> param(pooled_height, pooled_width, 1.f, -1);
+
+    Tensor<X86> nchw_in(Shape({num_in, c_in, h_in, w_in}));
+    Tensor<X86> roi(Shape({roi_num, 5, 1, 1}));
+    Tensor<X86> nchw_out(Shape({roi_num, c_in, pooled_height, pooled_width}));
+    fill_tensor_rand(nchw_in, 0.f, 1.f);
+    float* roi_data = static_cast<float*>(roi.mutable_data());
+
+    for (int i = 0; i < roi_num; ++i) {
+        roi_data[i * 5] = i % num_in;
+        roi_data[i * 5 + 1] = i % (w_in / 2);
+        roi_data[i * 5 + 2] = (i * 3) % (h_in / 2);
+        roi_data[i * 5 + 3] = w_in / 2 + (i * 5) % (w_in / 2);
+        roi_data[i * 5 + 4] = h_in / 2 + (i * 7) % (h_in / 2);
+    }
+
+    std::vector<Tensor<X86>*> ref_in{&nchw_in, &roi};
+    std::vector<Tensor<X86>*> ref_out{&nchw_out};
+    roi_align_cpu_base<float, X86, X86>(ref_in, ref_out, param);
+
+    Shape in_shape = real_channel ? Shape({num_in, c_in, h_in, w_in}, layout)
+                     : Shape({num_in, block_num, h_in, w_in, block}, layout);
+    Tensor<X86> input(in_shape);
+    Tensor<X86> output;
+    const float* src = static_cast<const float*>(nchw_in.data());
+    float* blocked_src = static_cast<float*>(input.mutable_data());
+    memset(blocked_src, 0, sizeof(float) * input.size());
+
+    for (int n = 0; n < num_in; ++n) {
+        for (int c = 0; c < c_in; ++c) {
+            for (int h = 0; h < h_in; ++h) {
+                for (int w = 0; w < w_in; ++w) {
+                    blocked_src[blocked_offset(block, c_in, h_in, w_in, n, c, h, w)] =
+                        src[((n * c_in + c) * h_in + h) * w_in + w];
+                }
+            }
+        }
+    }
+
+    RoiAlign<X86, AK_FLOAT> roi_align;
+    std::vector<Tensor<X86>*> input_v{&input, &roi};
+    std::vector<Tensor<X86>*> output_v{&output};
+    roi_align.compute_output_shape(input_v, output_v, param);
+    CHECK_EQ(output.get_layout(), layout);
+    output.re_alloc(output.valid_shape(), AK_FLOAT);
+    roi_align.init(input_v, output_v, param, SPECIFY, SABER_IMPL, ctx);
+    roi_align(input_v, output_v, param, ctx);
+
+    const float* ref = static_cast<const float*>(nchw_out.data());
+    const float* dst = static_cast<const float*>(output.data());
+    int error_count = 0;
+
+    for (int n = 0; n < roi_num; ++n) {
+        for (int c = 0; c < c_in; ++c) {
+            for (int h = 0; h < pooled_height; ++h) {
+                for (int w = 0; w < pooled_width; ++w) {
+                    float diff = dst[blocked_offset(block, c_in, pooled_height, pooled_width, n, c, h, w)]
+                                 - ref[((n * c_in + c) * pooled_height + h) * pooled_width + w];
+                    error_count += fabsf(diff) > 1e-5f;
+                }
+            }
+        }
+    }
+
+    CHECK_EQ(error_count, 0) << "blocked roi align failed, layout = " << layout << ", shape = "
+                             << num_in << ", " << c_in << ", " << h_in << ", " << w_in
+                             << ", rois = " << roi_num << ", pooled = " << pooled_height
+                             << ", " << pooled_width;
+}
+#endif
+
+TEST(TestSaberFunc, test_op_RoiAlign_blocked) {
+#ifdef USE_X86_PLACE
+    Env<X86>::env_init();
+
+    for (LayoutType layout : {Layout_NCHW_C8, Layout_NCHW_C16, Layout_NCHW_C8R, Layout_NCHW_C16R}) {
+        for (int c_in : {8, 16, 32}) {
+            test_roi_align_blocked(layout, 2, c_in, 7, 21, 3, 2, 4);
+        }
+
+        test_roi_align_blocked(layout, 3, 32, 16, 16, 6, 1, 1);
+    }
+
+    // channels not a multiple of the block, only the real channel layouts hold them
+    test_roi_align_blocked(Layout_NCHW_C8R, 2, 13, 8, 8, 4, 2, 2);
+    test_roi_align_blocked(Layout_NCHW_C16R, 2, 20, 8, 8, 4, 2, 2);
+    LOG(INFO) << "blocked roi align passed";
+#endif
+}
+
 TEST(TestSaberFunc, test_op_RoiAlign) {
 
 #ifdef USE_CUDA
@@ -239,7 +349,7 @@ TEST(TestSaberFunc, test_op_RoiAlign) {
     test_roi_align<AK_FLOAT, NV, NVHX86>();
 #endif
 #ifdef USE_X86_PLACE
-//    test_roi_align<AK_FLOAT, X86, X86>();
+    test_roi_align<AK_FLOAT, X86, X86>();
 #endif
 #ifdef USE_ARM_PLACE
     //test_RoiAlign<AK_FLOAT, ARM, ARM>();
@@ -281,6 +281,105 @@ TEST(TestSaberFunc, test_func_scale) {
 #endif
 }
 
+#ifdef USE_X86_PLACE
+/**
+ * @brief offset of element (n, c, hw) in a blocked tensor, [n][c / block][h * w][block].
+ */
+static int blocked_offset(int block, int channel, int hw_size, int n, int c, int hw) {
+    int block_num = (channel + block - 1) / block;
+    return ((n * block_num + c / block) * hw_size + hw) * block + c % block;
+}
+
+/**
+ * @brief run the per channel scale on blocked input, the result is checked against
+ * scale_cpu on the same data in nchw.
+ */
+void test_scale_blocked(LayoutType layout, int num_in, int c_in, int h_in, int w_in,
+                        bool bias_term, bool scale_input) {
+    Context<X86> ctx(0, 1, 1);
+    const int block = layout == Layout_NCHW_C8R ? 8 : 16;
+    const int hw_size = h_in * w_in;
+    std::vector<float> scale_data(c_in);
+    std::vector<float> bias_data(c_in);
+    fill_vector_rand(scale_data);
+    fill_vector_rand(bias_data);
+    ScaleParam<X86> param(scale_data, bias_data, bias_term, 1, 1);
+
+    Tensor<X86> nchw_in(Shape({num_in, c_in, h_in, w_in}, Layout_NCHW));
+    Tensor<X86> nchw_ref(Shape({num_in, c_in, h_in, w_in}, Layout_NCHW));
+    fill_tensor_rand(nchw_in, -1.f, 1.f);
+    std::vector<Tensor<X86>*> ref_in{&nchw_in};
+    std::vector<Tensor<X86>*> ref_out{&nchw_ref};
+    scale_cpu<float, X86, X86>(ref_in, ref_out, param);
+
+    Tensor<X86> input(Shape({num_in, c_in, h_in, w_in}, layout));
+    Tensor<X86> output;
+    Tensor<X86> scale_tensor(Shape({1, c_in, 1, 1}, Layout_NCHW));
+    const float* src = static_cast<const float*>(nchw_in.data());
+    float* blocked_src = static_cast<float*>(input.mutable_data());
+    memset(blocked_src, 0, sizeof(float) * input.size());
+    memcpy(scale_tensor.mutable_data(), scale_data.data(), sizeof(float) * c_in);
+
+    for (int n = 0; n < num_in; ++n) {
+        for (int c = 0; c < c_in; ++c) {
+            for (int hw = 0; hw < hw_size; ++hw) {
+                blocked_src[blocked_offset(block, c_in, hw_size, n, c, hw)] =
+                    src[(n * c_in + c) * hw_size + hw];
+            }
+        }
+    }
+
+    Scale<X86, AK_FLOAT> scale;
+    std::vector<Tensor<X86>*> input_v{&input};
+    std::vector<Tensor<X86>*> output_v{&output};
+
+    if (scale_input) {
+        input_v.push_back(&scale_tensor);
+    }
+
+    scale.compute_output_shape(input_v, output_v, param);
+    CHECK_EQ(output.get_layout(), layout);
+    output.re_alloc(output.valid_shape(), AK_FLOAT);
+    scale.init(input_v, output_v, param, SPECIFY, SABER_IMPL, ctx);
+    scale(input_v, output_v, param, ctx);
+
+    const float* ref = static_cast<const float*>(nchw_ref.data());
+    const float* dst = static_cast<const float*>(output.data());
+    int error_count = 0;
+
+    for (int n = 0; n < num_in; ++n) {
+        for (int c = 0; c < c_in; ++c) {
+            for (int hw = 0; hw < hw_size; ++hw) {
+                float diff = dst[blocked_offset(block, c_in, hw_size, n, c, hw)]
+                             - ref[(n * c_in + c) * hw_size + hw];
+                error_count += fabsf(diff) > 1e-6f;
+            }
+        }
+    }
+
+    CHECK_EQ(error_count, 0) << "blocked scale failed, layout = " << layout << ", shape = "
+                             << num_in << ", " << c_in << ", " << h_in << ", " << w_in
+                             << ", bias_term = " << bias_term << ", scale_input = " << scale_input;
+}
+#endif
+
+TEST(TestSaberFunc, test_func_scale_blocked) {
+#ifdef USE_X86_PLACE
+    Env<X86>::env_init();
+
+    for (LayoutType layout : {Layout_NCHW_C8R, Layout_NCHW_C16R}) {
+        for (int c_in : {3, 8, 17, 32}) {
+            for (bool bias_term : {true, false}) {
+                test_scale_blocked(layout, 2, c_in, 5, 7, bias_term, false);
+            }
+        }
+
+        test_scale_blocked(layout, 1, 20, 3, 3, true, true);
+    }
+
+    LOG(INFO) << "blocked scale passed";
+#endif
+}
 
 int main(int argc, const char** argv) {
     // initial logger
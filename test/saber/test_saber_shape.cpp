@@ -2,6 +2,7 @@
 #include "test_saber_func.h"
 #include "saber/core/shape.h"
 #include "anakin_config.h"
+#include <numeric>
 
 #ifdef USE_OPENMP
 #include <omp.h>
@@ -283,6 +284,43 @@ TEST(TestSaberFunc, test_set_layout) {
     LOG(INFO) << "set layout PASS";
 }
 
+TEST(TestSaberFunc, test_vector_interface) {
+    Shape sh({2, 3, 4, 5});
+    Shape copy = sh;
+    copy[1] = 7;
+    CHECK_EQ(sh[1], 3);
+    CHECK_EQ(copy[1], 7);
+
+    std::vector<int> dims = sh;
+    CHECK_EQ(dims.size(), 4);
+    CHECK_EQ(sh == dims, true);
+    CHECK_EQ(dims == copy, false);
+    CHECK_EQ(std::accumulate(sh.begin(), sh.end(), 0), 14);
+
+    Shape nhw({2, 4, 5}, Layout_NHW);
+    nhw.insert(nhw.begin() + 1, 3);
+    CHECK_EQ(nhw.size(), 4);
+    CHECK_EQ(nhw[1], 3);
+    CHECK_EQ(nhw.back(), 5);
+    nhw.erase(nhw.begin() + 1);
+    CHECK_EQ(nhw.size(), 3);
+    CHECK_EQ(nhw[1], 4);
+
+    Shape grow;
+    for (int i = 0; i < Shape::MAX_DIMS; ++i) {
+        grow.push_back(i + 1);
+    }
+    CHECK_EQ(grow.size(), Shape::MAX_DIMS);
+    grow.resize(2);
+    CHECK_EQ(grow.size(), 2);
+    grow.resize(4, 9);
+    CHECK_EQ(grow[3], 9);
+    grow.clear();
+    CHECK_EQ(grow.empty(), true);
+    CHECK_EQ(grow.get_layout(), Layout_NCHW);
+    LOG(INFO) << "vector interface PASS";
+}
+
 int main(int argc, const char** argv) {
     // initial logger
     //logger::init(argv[0]);
@@ -37,10 +37,29 @@ void softmax_cpu(const std::vector<Tensor<TargetType_H>*>& input,
     int outer_num = Count(sh_in, axis + 1, dims);
     int total_num = inner_num * outer_num;
     dtype* data = (dtype*)malloc(axis_size * sizeof(dtype));
+    // optional additive mask, broadcast over the axes before axis
+    const dtype* mask_data = input.size() > 1 ? (const dtype*)input[1]->data() : nullptr;
+    std::vector<int> mask_stride(axis, 0);
+
+    if (mask_data != nullptr) {
+        Shape sh_mask = input[1]->valid_shape();
+        int stride = Count(sh_mask, axis, dims);
+
+        for (int i = axis - 1; i >= 0; --i) {
+            mask_stride[i] = sh_mask[i] == 1 ? 0 : stride;
+            stride *= sh_mask[i];
+        }
+    }
 
     for (int num = 0; num < total_num; ++num) {
         int num_tmp = num;
         int in_index = 0, out_index = 0;
+        int mask_index = num % outer_num;
+
+        for (int i = axis - 1, outer_tmp = num / outer_num; i >= 0; --i) {
+            mask_index += (outer_tmp % sh_in[i]) * mask_stride[i];
+            outer_tmp /= sh_in[i];
+        }
 
         for (int i = dims - 1; i >= 0; --i) {
             if (i == axis) {
@@ -56,16 +75,21 @@ void softmax_cpu(const std::vector<Tensor<TargetType_H>*>& input,
         dtype max = std::numeric_limits<dtype>::lowest();
 
         for (int i = 0; i < axis_size; ++i) {
-            max = in_data[in_index] > max ? in_data[in_index] : max;
+            data[i] = in_data[in_index] * param.scale;
+
+            if (mask_data != nullptr) {
+                data[i] += mask_data[mask_index + i * outer_num];
+            }
+
+            max = data[i] > max ? data[i] : max;
             in_index += in_stride[axis];
         }
 
         dtype sum = (dtype)0;
 
         for (int i = 0; i < axis_size; ++i) {
-            in_index -= in_stride[axis];
-            data[axis_size - i - 1] = exp(in_data[in_index] - max);
-            sum += data[axis_size - i - 1];
+            data[i] = exp(data[i] - max);
+            sum += data[i];
         }
 
         for (int i = 0; i < axis_size; ++i) {
@@ -166,6 +190,38 @@ TEST(TestSaberFunc, test_func_softmax) {
             }
         }
     }
+
+    // fused scale and additive mask, mask broadcast over the leading axes,
+    // long rows span several blocks of the vectorized kernel
+    TestSaberBase<X86, X86, AK_FLOAT, Softmax, SoftmaxParam> testbase3(2, 1);
+
+    for (auto shape : {
+                Shape({2, 4, 5, 1500}), Shape({3, 2, 7, 37}), Shape({2, 3, 19, 13})
+            }) {
+        for (auto axis : {
+                    2, 3
+                }) {
+            for (bool broadcast : {
+                        false, true
+                    }) {
+                Shape mask_shape = shape;
+
+                if (broadcast) {
+                    mask_shape[1] = 1;
+                }
+
+                Tensor<X86> in(shape);
+                Tensor<X86> mask(mask_shape);
+                fill_tensor_rand(in, -10.f, 10.f);
+                fill_tensor_rand(mask, -100.f, 0.f);
+                std::vector<Tensor<X86>*> input {&in, &mask};
+                testbase3.add_custom_input(input);
+                SoftmaxParam<X86> param(axis, 0.125f);
+                testbase3.set_param(param);
+                testbase3.run_test(softmax_cpu<float, X86, X86>);
+            }
+        }
+    }
     LOG(INFO) << "x86 test end.";
 #endif
 
@@ -0,0 +1,79 @@
+#!/bin/bash
+# This script checks the objects of a fat x86 saber library. The fat library runs on any host
+# from nehalem on, so only the avx2 and avx512 files may hold vex or evex instructions, and they
+# may not share a weak function with an object of another isa: the linker keeps one copy of a
+# weak function for every caller, a wide copy would crash the base callers on an older host.
+#
+# usage: check_x86_fat_isa.sh <object dir> <isa>:<source file name> ...
+# e.g.   check_x86_fat_isa.sh CMakeFiles/anakin_saber_common.dir avx2:winograd_avx2.cpp
+
+if [ $# -lt 1 ] || [ ! -d "$1" ]; then
+    echo "usage: $0 <object dir> <isa>:<source file name> ..."
+    exit 1
+fi
+OBJ_DIR=$1
+shift
+
+declare -A ISA_OF
+for arg in "$@"; do
+    ISA_OF["${arg#*:}.o"]=${arg%%:*}
+done
+
+TMP_DIR=$(mktemp -d)
+trap 'rm -rf "$TMP_DIR"' EXIT
+
+# prints the functions of an object which hold a vex or evex encoded instruction
+function vex_functions() {
+    objdump -d --no-show-raw-insn -w "$1" | awk '
+        /^[0-9a-f]+ <.*>:$/ {
+            func_name = substr($2, 2, length($2) - 3)
+            next
+        }
+        /^ *[0-9a-f]+:\t/ {
+            split($0, fields, "\t")
+            n = split(fields[2], words, " ")
+            i = 1
+            while (i < n && words[i] ~ /^\{/) {
+                i++
+            }
+            op = words[i]
+            if (op ~ /^(v[a-z0-9]+|k[a-z]+|andn|bextr|blsi|blsmsk|blsr|bzhi|mulx|pdep|pext|rorx|sarx|shlx|shrx)$/ \
+                && op != "verr" && op != "verw" && !(func_name in seen)) {
+                seen[func_name] = 1
+                print func_name
+            }
+        }'
+}
+
+STATUS=0
+while IFS= read -r obj; do
+    isa=${ISA_OF[$(basename "$obj")]:-base}
+    nm --defined-only -P "$obj" | awk -v isa="$isa" '$2 ~ /^[TtWw]$/ {print $1, isa, $2}' >> "$TMP_DIR/defs"
+    vex_functions "$obj" > "$TMP_DIR/vex"
+    if [ "$isa" == "base" ]; then
+        if [ -s "$TMP_DIR/vex" ]; then
+            echo "error: $obj is built for the base isa but holds vex or evex code in:"
+            c++filt < "$TMP_DIR/vex" | sed 's/^/    /'
+            STATUS=1
+        fi
+    else
+        nm --defined-only -P "$obj" | awk '$2 == "W" {print $1}' | sort > "$TMP_DIR/weak"
+        sort "$TMP_DIR/vex" | comm -12 - "$TMP_DIR/weak" | sed "s|^|$isa $obj |" >> "$TMP_DIR/wide_weak"
+    fi
+done < <(find "$OBJ_DIR" -name "*.o" | sort)
+
+if [ -s "$TMP_DIR/wide_weak" ]; then
+    while read -r isa obj sym; do
+        others=$(awk -v sym="$sym" -v isa="$isa" '$1 == sym && $2 != isa {print $2}' "$TMP_DIR/defs" \
+                 | sort -u | tr '\n' ' ')
+        if [ -n "$others" ]; then
+            echo "error: the $isa copy of $(echo "$sym" | c++filt) in $obj is also defined for: $others"
+            STATUS=1
+        fi
+    done < "$TMP_DIR/wide_weak"
+fi
+
+if [ $STATUS -eq 0 ]; then
+    echo "-- The fat x86 objects in $OBJ_DIR keep the wide isa code in their own files"
+fi
+exit $STATUS
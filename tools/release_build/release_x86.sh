@@ -6,7 +6,9 @@ echo "-- Anakin root dir is: $ANAKIN_ROOT"
 
 THIS_DIR=`dirname $0`
 echo $THIS_DIR
-for arch in ivybridge broadwell knl
+# archs to build can be given as arguments, "fat" builds one so for every x86 host
+ARCHS=${@:-ivybridge broadwell knl}
+for arch in $ARCHS
 do
 #echo $arch
 /bin/bash $THIS_DIR/release_x86_one_arch.sh $arch